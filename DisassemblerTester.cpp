@@ -0,0 +1,3869 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "disassm.h"
+
+/*
+ * Benchmark corpus
+ *
+ * A mix of common compiler-generated encodings, shuffled with a fixed seed
+ * so every run decodes the same byte stream.
+ */
+static const uint8_t g_corpus_mix[][X86_MAX_INSTRUCTION_LENGTH + 1] = {
+    // { length, bytes... }
+    { 1, 0x55 },                                        // push rbp
+    { 3, 0x48, 0x89, 0xE5 },                            // mov rbp, rsp
+    { 4, 0x48, 0x83, 0xEC, 0x20 },                      // sub rsp, 0x20
+    { 7, 0xC7, 0x45, 0xFC, 0x01, 0x00, 0x00, 0x00 },    // mov dword [rbp-4], 1
+    { 3, 0xF6, 0xC1, 0x01 },                            // test cl, 1
+    { 4, 0x48, 0x8B, 0x45, 0xF8 },                      // mov rax, [rbp-8]
+    { 5, 0x41, 0x8B, 0x44, 0x24, 0x08 },                // mov eax, [r12+8]
+    { 7, 0x48, 0x8B, 0x05, 0x10, 0x20, 0x00, 0x00 },    // mov rax, [rip+0x2010]
+    { 7, 0x48, 0x8D, 0x0D, 0x00, 0x01, 0x00, 0x00 },    // lea rcx, [rip+0x100]
+    { 5, 0xE8, 0x10, 0x00, 0x00, 0x00 },                // call rel32
+    { 2, 0x74, 0x05 },                                  // je rel8
+    { 6, 0x0F, 0x85, 0x20, 0x00, 0x00, 0x00 },          // jne rel32
+    { 3, 0x48, 0x85, 0xC0 },                            // test rax, rax
+    { 2, 0x31, 0xC0 },                                  // xor eax, eax
+    { 5, 0xB8, 0x01, 0x00, 0x00, 0x00 },                // mov eax, 1
+    { 10, 0x48, 0xB8, 1, 2, 3, 4, 5, 6, 7, 8 },         // mov rax, imm64
+    { 4, 0x0F, 0xB6, 0x04, 0x08 },                      // movzx eax, byte [rax+rcx]
+    { 5, 0x66, 0x0F, 0x1F, 0x44, 0x00 },                // nop word [rax+rax]
+    { 4, 0xF3, 0x0F, 0x10, 0x01 },                      // movss xmm0, [rcx]
+    { 1, 0xC3 },                                        // ret
+    { 1, 0xC9 },                                        // leave
+    { 1, 0x90 },                                        // nop
+};
+
+/*
+ * AVX-512 heavy corpus: a vectorized loop body with its scalar bookkeeping
+ */
+static const uint8_t g_corpus_avx512[][X86_MAX_INSTRUCTION_LENGTH + 1] = {
+    { 8, 0x62, 0xF1, 0x7C, 0x48, 0x10, 0x44, 0x24, 0x01 },          // vmovups zmm0, [rsp+0x40]
+    { 8, 0x62, 0xF1, 0x7C, 0x48, 0x11, 0x44, 0x24, 0x02 },          // vmovups [rsp+0x80], zmm0
+    { 6, 0x62, 0xF1, 0xFD, 0x48, 0x58, 0xC1 },                      // vaddpd zmm0, zmm0, zmm1
+    { 6, 0x62, 0xF2, 0xFD, 0x48, 0xA8, 0xC2 },                      // vfmadd213pd zmm0, zmm0, zmm2
+    { 7, 0x62, 0xF1, 0xFD, 0x58, 0x59, 0x40, 0x01 },                // vmulpd zmm0, zmm0, [rax+8]{1to8}
+    { 7, 0x62, 0xF3, 0x7D, 0x48, 0x1F, 0xC9, 0x01 },                // vpcmpd k1, zmm0, zmm1, 1
+    { 7, 0x62, 0xF1, 0x7D, 0x49, 0x6F, 0x0C, 0x24 },                // vmovdqa32 zmm1{k1}, [rsp]
+    { 4, 0xC5, 0xFC, 0x28, 0xC1 },                                  // vmovaps ymm0, ymm1
+    { 9, 0xC4, 0xE2, 0x7D, 0x18, 0x05, 0x10, 0x00, 0x00, 0x00 },    // vbroadcastss ymm0, [rip+0x10]
+    { 4, 0xC5, 0xFD, 0xEF, 0xC0 },                                  // vpxor ymm0, ymm0, ymm0
+    { 3, 0xC5, 0xF8, 0x77 },                                        // vzeroupper
+    { 4, 0x48, 0x83, 0xC0, 0x40 },                                  // add rax, 0x40
+    { 3, 0x48, 0x39, 0xD0 },                                        // cmp rax, rdx
+    { 2, 0x75, 0xE0 },                                              // jne rel8
+};
+
+/*
+ * Crypto heavy corpus: AES-NI/PCLMUL/SHA round code (0F 38 and 0F 3A maps)
+ */
+static const uint8_t g_corpus_crypto[][X86_MAX_INSTRUCTION_LENGTH + 1] = {
+    { 5, 0x66, 0x0F, 0x38, 0xDC, 0xC1 },                            // aesenc xmm0, xmm1
+    { 7, 0x66, 0x0F, 0x38, 0xDC, 0x47, 0x10 },                      // aesenc xmm0, [rdi+0x10]
+    { 5, 0x66, 0x0F, 0x38, 0xDD, 0xC2 },                            // aesenclast xmm0, xmm2
+    { 6, 0x66, 0x0F, 0x3A, 0x44, 0xC1, 0x00 },                      // pclmulqdq xmm0, xmm1, 0
+    { 7, 0x66, 0x0F, 0x3A, 0xDF, 0xC8, 0x01 },                      // aeskeygenassist xmm1, xmm0, 1
+    { 5, 0x0F, 0x3A, 0xCC, 0xC1, 0x00 },                            // sha1rnds4 xmm0, xmm1, 0
+    { 4, 0x0F, 0x38, 0xCB, 0xCA },                                  // sha256rnds2 xmm1, xmm2
+    { 5, 0x66, 0x0F, 0x38, 0x00, 0xC3 },                            // pshufb xmm0, xmm3
+    { 6, 0x66, 0x0F, 0x3A, 0x0F, 0xC1, 0x08 },                      // palignr xmm0, xmm1, 8
+    { 4, 0x66, 0x0F, 0xEF, 0xC1 },                                  // pxor xmm0, xmm1
+    { 4, 0xF3, 0x0F, 0x6F, 0x06 },                                  // movdqu xmm0, [rsi]
+    { 4, 0x48, 0x83, 0xC6, 0x10 },                                  // add rsi, 0x10
+    { 2, 0x75, 0xE0 },                                              // jne rel8
+};
+
+template <size_t N>
+static std::vector<uint8_t> build_corpus(size_t size, const uint8_t (&mix)[N][X86_MAX_INSTRUCTION_LENGTH + 1]) {
+    std::vector<uint8_t> corpus;
+    uint32_t seed = 0x12345678;
+
+    corpus.reserve(size + X86_MAX_INSTRUCTION_LENGTH);
+    while (corpus.size() < size) {
+        seed = seed * 1103515245 + 12345;
+        const uint8_t* entry = mix[(seed >> 16) % N];
+        corpus.insert(corpus.end(), entry + 1, entry + 1 + entry[0]);
+    }
+
+    return corpus;
+}
+
+// Benchmark input: the largest executable region of an image, or the whole file
+static std::vector<uint8_t> read_code(const char* path) {
+    std::vector<uint8_t> data;
+    LoadedImage image;
+
+    if (x86_image_load(path, DISASM_MAP_DEFAULT, &image) == DISASM_IMAGE_OK && image.region_count) {
+        const CodeRegion* largest = &image.regions[0];
+        for (size_t i = 1; i < image.region_count; i++) {
+            if (image.regions[i].size > largest->size) {
+                largest = &image.regions[i];
+            }
+        }
+        data.assign(largest->code, largest->code + largest->size);
+    }
+    else if (image.file.data) {
+        data.assign(image.file.data, image.file.data + image.file.size);
+    }
+
+    x86_image_free(&image);
+    return data;
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char* name, size_t bytes, size_t count, double seconds) {
+    printf("  %-24s %10zu insns %8.1f MB/s %8.2f ns/insn\n",
+        name, count, bytes / seconds / 1e6, seconds * 1e9 / (count ? count : 1));
+}
+
+/*
+ * Benchmark: full decode vs. length-only decode
+ */
+static int bench_length(const std::vector<uint8_t>& code, int rounds) {
+    // Pad so the single-instruction entry points never run off the end
+    std::vector<uint8_t> padded(code);
+    padded.resize(code.size() + X86_MAX_INSTRUCTION_LENGTH, 0);
+
+    size_t full_count = 0;
+    size_t length_count = 0;
+    InstructionInfo info;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t offset = 0; offset < code.size(); full_count++) {
+            offset += x86_disasm(&padded[offset], &info);
+        }
+    }
+    double full_time = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t offset = 0; offset < code.size(); length_count++) {
+            offset += x86_insn_length(&padded[offset]);
+        }
+    }
+    double length_time = seconds_since(start);
+
+    // Batch entry points: decoder cores inlined into the loop
+    std::vector<DecodedInstruction> records(code.size());
+    std::vector<uint8_t> lengths(code.size());
+    size_t batch_count = 0;
+    size_t length_batch_count = 0;
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        batch_count += x86_disasm_batch(code.data(), code.size(), 0, records.data(), records.size(), NULL);
+    }
+    double batch_time = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        length_batch_count += x86_insn_length_batch(code.data(), code.size(), lengths.data(), lengths.size(), NULL);
+    }
+    double length_batch_time = seconds_since(start);
+
+    size_t bytes = code.size() * rounds;
+    printf("length (%zu bytes x %d rounds)\n", code.size(), rounds);
+    report("x86_disasm", bytes, full_count, full_time);
+    report("x86_insn_length", bytes, length_count, length_time);
+    printf("  speedup vs full decode   %10.2fx\n", full_time / length_time);
+    report("x86_disasm_batch", bytes, batch_count, batch_time);
+    report("x86_insn_length_batch", bytes, length_batch_count, length_batch_time);
+    printf("  speedup vs full decode   %10.2fx\n", batch_time / length_batch_time);
+
+    if (full_count != length_count || batch_count != length_batch_count) {
+        printf("  warning: instruction counts differ\n");
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Benchmark: byte classifier per scan level
+ */
+static void bench_scan(const std::vector<uint8_t>& code, int rounds) {
+    static const char* const level_names[] = { "scalar", "avx2" };
+    DisasmScanLevel best = x86_scan_level();
+    std::vector<ByteClassBlock> blocks(code.size() / 64 + 1);
+    size_t bytes = code.size() * rounds;
+
+    printf("scan (%zu bytes x %d rounds)\n", code.size(), rounds);
+    for (int level = DISASM_SCAN_SCALAR; level <= best; level++) {
+        char name[64];
+        size_t count = 0;
+        x86_scan_set_level((DisasmScanLevel)level);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            count += x86_classify_bytes(code.data(), code.size(), blocks.data());
+        }
+        double classify_time = seconds_since(start);
+
+        snprintf(name, sizeof(name), "classify (%s)", level_names[level]);
+        printf("  %-24s %10zu blocks %7.1f MB/s\n", name, count, bytes / classify_time / 1e6);
+    }
+    x86_scan_set_level(best);
+}
+
+/*
+ * Benchmark: full records vs. packed records vs. columns
+ */
+static void bench_packed(const std::vector<uint8_t>& code, int rounds) {
+    std::vector<DecodedInstruction> records(code.size());
+    std::vector<PackedInstruction> packed(code.size());
+    InstructionColumns columns;
+    size_t bytes = code.size() * rounds;
+    size_t count = 0;
+
+    if (!x86_columns_init(&columns, code.size())) {
+        printf("error: out of memory\n");
+        return;
+    }
+
+    printf("records (%zu bytes x %d rounds)\n", code.size(), rounds);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        count = x86_disasm_batch(code.data(), code.size(), 0, records.data(), records.size(), NULL);
+    }
+    report("x86_disasm_batch", bytes, count * rounds, seconds_since(start));
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        count = x86_disasm_packed(code.data(), code.size(), packed.data(), packed.size(), NULL);
+    }
+    report("x86_disasm_packed", bytes, count * rounds, seconds_since(start));
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        count = x86_disasm_columns(code.data(), code.size(), &columns, NULL);
+    }
+    report("x86_disasm_columns", bytes, count * rounds, seconds_since(start));
+
+    printf("  bytes/insn               %10zu full %5zu packed %5zu columns\n",
+        sizeof(DecodedInstruction), sizeof(PackedInstruction),
+        sizeof(uint32_t) + 2 * sizeof(uint16_t) + 8 * sizeof(uint8_t));
+
+    // Field scan: count direct calls
+    size_t calls[3] = { 0 };
+    double scan_time[3];
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < count; i++) {
+            calls[0] += records[i].info.opcode == 0xE8;
+        }
+    }
+    scan_time[0] = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < count; i++) {
+            calls[1] += packed[i].map == OPCODE_MAP_1BYTE && packed[i].opcode == 0xE8;
+        }
+    }
+    scan_time[1] = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < count; i++) {
+            calls[2] += columns.map[i] == OPCODE_MAP_1BYTE && columns.opcode[i] == 0xE8;
+        }
+    }
+    scan_time[2] = seconds_since(start);
+
+    printf("  call scan                %10.2f ms full %5.2f ms packed %5.2f ms columns\n",
+        scan_time[0] * 1e3, scan_time[1] * 1e3, scan_time[2] * 1e3);
+    if (calls[0] != calls[1] || calls[1] != calls[2]) {
+        printf("  warning: call counts differ\n");
+    }
+
+    x86_columns_free(&columns);
+}
+
+/*
+ * Benchmark: per-mode decoders
+ *
+ * Every mode decodes the same (64-bit) corpus, so the numbers compare the
+ * decoder instantiations rather than the instruction mixes.
+ */
+static void bench_modes(const std::vector<uint8_t>& code, int rounds) {
+    static const DisasmMode modes[] = { DISASM_MODE_64, DISASM_MODE_32, DISASM_MODE_16 };
+    std::vector<DecodedInstruction> records(code.size());
+    std::vector<uint8_t> padded(code);
+    size_t bytes = code.size() * rounds;
+    InstructionInfo info;
+
+    padded.resize(code.size() + X86_MAX_INSTRUCTION_LENGTH, 0);
+
+    printf("modes (%zu bytes x %d rounds)\n", code.size(), rounds);
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        char name[64];
+        size_t count = 0;
+        size_t length_count = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            count += x86_disasm_batch_mode(modes[m], code.data(), code.size(), 0, records.data(), records.size(), NULL);
+        }
+        snprintf(name, sizeof(name), "disasm_batch (%d-bit)", (int)modes[m]);
+        report(name, bytes, count, seconds_since(start));
+
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            for (size_t offset = 0; offset < code.size(); length_count++) {
+                offset += x86_insn_length_mode(modes[m], &padded[offset]);
+            }
+        }
+        snprintf(name, sizeof(name), "insn_length (%d-bit)", (int)modes[m]);
+        report(name, bytes, length_count, seconds_since(start));
+    }
+
+    // Single-instruction entry points
+    unsigned int (*const decoders[])(const void*, InstructionInfo*) = { x86_disasm64, x86_disasm32, x86_disasm16 };
+    for (size_t m = 0; m < sizeof(decoders) / sizeof(decoders[0]); m++) {
+        char name[64];
+        size_t count = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            for (size_t offset = 0; offset < code.size(); count++) {
+                offset += decoders[m](&padded[offset], &info);
+            }
+        }
+        snprintf(name, sizeof(name), "x86_disasm%d", (int)modes[m]);
+        report(name, bytes, count, seconds_since(start));
+    }
+}
+
+/*
+ * Benchmark: legacy vs. AVX-512 and crypto heavy code
+ */
+static void bench_corpora(const std::vector<uint8_t>& legacy, int rounds) {
+    std::vector<uint8_t> vector = build_corpus(legacy.size(), g_corpus_avx512);
+    std::vector<uint8_t> crypto = build_corpus(legacy.size(), g_corpus_crypto);
+    const std::vector<uint8_t>* corpora[] = { &legacy, &vector, &crypto };
+    static const char* const corpus_names[] = { "legacy", "avx512", "crypto" };
+    std::vector<DecodedInstruction> records(legacy.size());
+    std::vector<uint8_t> lengths(legacy.size());
+
+    printf("corpora (%zu bytes x %d rounds)\n", legacy.size(), rounds);
+    for (int c = 0; c < 3; c++) {
+        const std::vector<uint8_t>& code = *corpora[c];
+        size_t bytes = code.size() * rounds;
+        size_t count = 0;
+        char name[64];
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            count += x86_disasm_batch(code.data(), code.size(), 0, records.data(), records.size(), NULL);
+        }
+        snprintf(name, sizeof(name), "disasm_batch (%s)", corpus_names[c]);
+        report(name, bytes, count, seconds_since(start));
+
+        count = 0;
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            count += x86_insn_length_batch(code.data(), code.size(), lengths.data(), lengths.size(), NULL);
+        }
+        snprintf(name, sizeof(name), "length_batch (%s)", corpus_names[c]);
+        report(name, bytes, count, seconds_since(start));
+    }
+}
+
+/*
+ * Benchmark: text formatting vs. decoding
+ *
+ * The records are decoded once; the timed loop only formats them, so the
+ * numbers compare directly with disasm_batch above.
+ */
+static void bench_format(const std::vector<uint8_t>& legacy, int rounds) {
+    std::vector<uint8_t> vector = build_corpus(legacy.size(), g_corpus_avx512);
+    std::vector<uint8_t> crypto = build_corpus(legacy.size(), g_corpus_crypto);
+    const std::vector<uint8_t>* corpora[] = { &legacy, &vector, &crypto };
+    static const char* const corpus_names[] = { "legacy", "avx512", "crypto" };
+    static const char* const syntax_names[] = { "intel", "att" };
+    std::vector<DecodedInstruction> records(legacy.size());
+    std::vector<char> text(1 << 20);
+
+    printf("format (%zu bytes x %d rounds)\n", legacy.size(), rounds);
+    for (int c = 0; c < 3; c++) {
+        const std::vector<uint8_t>& code = *corpora[c];
+        size_t decoded = x86_disasm_batch(code.data(), code.size(), 0, records.data(), records.size(), NULL);
+
+        for (unsigned int syntax = DISASM_FORMAT_INTEL; syntax <= DISASM_FORMAT_ATT; syntax++) {
+            unsigned int format = syntax | DISASM_FORMAT_ADDRESS | DISASM_FORMAT_BYTES;
+            size_t bytes = code.size() * rounds;
+            size_t count = 0;
+            size_t characters = 0;
+            char name[64];
+
+            auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < rounds; r++) {
+                for (size_t i = 0; i < decoded;) {
+                    size_t written;
+                    size_t done = x86_format_batch(&records[i], decoded - i, format, text.data(), text.size(), &written);
+                    characters += written;
+                    count += done;
+                    i += done;
+                }
+            }
+            snprintf(name, sizeof(name), "format (%s/%s)", corpus_names[c], syntax_names[syntax]);
+            report(name, bytes, count, seconds_since(start));
+            printf("  %-24s %10.1f chars/insn\n", "", (double)characters / (count ? count : 1));
+        }
+    }
+}
+
+/*
+ * Benchmark: on-demand operand decoding
+ *
+ * Decoding operands for every instruction vs. for one in twenty, the share
+ * an analysis typically asks about.
+ */
+static void bench_operands(const std::vector<uint8_t>& code, int rounds) {
+    std::vector<DecodedInstruction> records(code.size());
+    size_t decoded = x86_disasm_batch(code.data(), code.size(), 0, records.data(), records.size(), NULL);
+    static const size_t strides[] = { 1, 20 };
+
+    printf("operands (%zu bytes x %d rounds)\n", code.size(), rounds);
+    for (size_t k = 0; k < sizeof(strides) / sizeof(strides[0]); k++) {
+        size_t count = 0;
+        size_t operand_count = 0;
+        char name[64];
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            for (size_t i = 0; i < decoded; i += strides[k]) {
+                InstructionOperands operands;
+                x86_operands_init(&operands, DISASM_MODE_64, &records[i].info);
+                operand_count += x86_operand_count(&operands);
+                count++;
+            }
+        }
+        snprintf(name, sizeof(name), "operands (1 in %zu)", strides[k]);
+        report(name, code.size() * rounds / strides[k], count, seconds_since(start));
+        printf("  %-24s %10.2f operands/insn\n", "", (double)operand_count / (count ? count : 1));
+    }
+}
+
+static void bench_sweep(const std::vector<uint8_t>& code, int rounds) {
+    std::vector<DecodedInstruction> serial(code.size());
+    std::vector<DecodedInstruction> records(code.size());
+    DisasmBatchResult expected;
+    unsigned int max_threads = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+    size_t bytes = code.size() * rounds;
+
+    x86_disasm_batch(code.data(), code.size(), 0, serial.data(), serial.size(), &expected);
+
+    printf("parallel sweep (%zu bytes x %d rounds, %u hardware threads)\n", code.size(), rounds, max_threads);
+    // 1, 2, 4, ... threads, ending with one per hardware thread
+    for (unsigned int threads = 1; ; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+        DisasmBatchResult result;
+        size_t count = 0;
+        char name[64];
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            count += x86_sweep_parallel(DISASM_MODE_64, code.data(), code.size(), 0, records.data(), records.size(),
+                threads, &result);
+        }
+        snprintf(name, sizeof(name), "sweep (%u threads)", threads);
+        report(name, bytes, count, seconds_since(start));
+
+        if (memcmp(&result, &expected, sizeof(result)) != 0 ||
+            memcmp(records.data(), serial.data(), expected.count * sizeof(DecodedInstruction)) != 0) {
+            printf("  MISMATCH with the serial sweep\n");
+        }
+        if (threads == max_threads) {
+            break;
+        }
+    }
+}
+
+static void bench_cfg(const std::vector<uint8_t>& code, int rounds) {
+    std::vector<DecodedInstruction> records(code.size());
+    size_t decoded = x86_disasm_batch(code.data(), code.size(), 0, records.data(), records.size(), NULL);
+    DisasmArena arena;
+    ControlFlowGraph cfg;
+    size_t blocks = 0;
+
+    x86_arena_init(&arena, 0);
+
+    printf("cfg (%zu instructions x %d rounds)\n", decoded, rounds);
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        x86_arena_free(&arena);
+        if (!x86_cfg_build(records.data(), decoded, &arena, &cfg)) {
+            printf("  error: out of memory\n");
+            break;
+        }
+        blocks += cfg.block_count;
+    }
+    double seconds = seconds_since(start);
+
+    report("cfg_build", code.size() * rounds, decoded * rounds, seconds);
+    printf("  %-24s %10zu blocks %8.2f M blocks/s %6zu edges %8.1f MB arena\n", "", cfg.block_count,
+        blocks / seconds / 1e6, cfg.edge_count, arena.allocated / 1e6);
+    x86_arena_free(&arena);
+}
+
+/*
+ * Benchmark: stepping through a hot loop with and without the decode
+ * cache, then patching a byte of it
+ */
+static void bench_cache(const std::vector<uint8_t>& code, int rounds) {
+    const size_t loop = 1024;
+    const int steps = 1000;
+    std::vector<DecodedInstruction> records(loop);
+    std::vector<uint8_t> patched(code.begin(), code.begin() + (code.size() < 65536 ? code.size() : 65536));
+    size_t count = x86_disasm_batch(patched.data(), patched.size(), 0, records.data(), loop, NULL);
+    size_t bytes = count ? (size_t)records[count - 1].address + records[count - 1].info.length : 0;
+    unsigned int max_threads = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+    DecodeCache cache;
+    DecodeCacheStats stats;
+
+    if (!x86_cache_init(&cache, DISASM_MODE_64, 0)) {
+        printf("  error: out of memory\n");
+        return;
+    }
+
+    printf("decode cache (%zu instruction loop x %d steps, %u hardware threads)\n", count, steps * rounds, max_threads);
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < steps * rounds; r++) {
+        for (size_t i = 0; i < count; i++) {
+            DecodedInstruction insn;
+            x86_disasm_batch(patched.data() + records[i].address, patched.size() - (size_t)records[i].address,
+                records[i].address, &insn, 1, NULL);
+        }
+    }
+    report("decode", bytes * steps * rounds, count * steps * rounds, seconds_since(start));
+
+    for (unsigned int threads = 1; ; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+        std::vector<std::thread> workers;
+        std::atomic<size_t> mismatches(0);
+        char name[64];
+
+        start = std::chrono::steady_clock::now();
+        for (unsigned int t = 0; t < threads; t++) {
+            workers.push_back(std::thread([&]() {
+                for (int r = 0; r < steps * rounds / (int)threads; r++) {
+                    for (size_t i = 0; i < count; i++) {
+                        DecodedInstruction insn;
+                        size_t offset = (size_t)records[i].address;
+                        if (x86_cache_decode(&cache, patched.data() + offset, patched.size() - offset, offset, &insn) !=
+                            records[i].info.length || insn.target != records[i].target) {
+                            mismatches++;
+                        }
+                    }
+                }
+            }));
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        snprintf(name, sizeof(name), "cached (%u threads)", threads);
+        report(name, bytes * (steps * rounds / threads) * threads, count * (steps * rounds / threads) * threads,
+            seconds_since(start));
+        if (mismatches) {
+            printf("  MISMATCH with the direct decode (%zu)\n", mismatches.load());
+        }
+        if (threads == max_threads) {
+            break;
+        }
+    }
+
+    // Patch the first instruction into a one-byte nop and back
+    DecodedInstruction insn;
+    uint8_t saved = patched[0];
+    patched[0] = 0x90;
+    x86_cache_decode(&cache, patched.data(), patched.size(), 0, &insn);
+    int stale = insn.info.opcode != 0x90;
+    patched[0] = saved;
+    x86_cache_decode(&cache, patched.data(), patched.size(), 0, &insn);
+    stale |= memcmp(&insn, &records[0], sizeof(insn)) != 0;
+
+    x86_cache_stats(&cache, &stats);
+    printf("  %-24s %10llu hits %10llu misses %6llu stale %6zu entries%s\n", "", (unsigned long long)stats.hits,
+        (unsigned long long)stats.misses, (unsigned long long)stats.stale, stats.entries,
+        stale ? ", STALE DECODE after patching" : "");
+    x86_cache_free(&cache);
+}
+
+/*
+ * Benchmark: streaming decoder fed in chunks of several sizes, against the
+ * batch decoder over the whole buffer
+ */
+static void bench_stream(const std::vector<uint8_t>& code, int rounds) {
+    const size_t chunk_sizes[] = { 61, 4096, 65536, 1 << 20 };
+    std::vector<DecodedInstruction> records(4096);
+    std::vector<DecodedInstruction> expected(code.size() + 1);
+    size_t total = x86_disasm_batch(code.data(), code.size(), 0, expected.data(), expected.size(), NULL);
+    size_t count = 0;
+
+    printf("streaming decoder\n");
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        size_t offset = 0;
+
+        while (offset < code.size()) {
+            DisasmBatchResult result;
+            count += x86_disasm_batch(code.data() + offset, code.size() - offset, offset, records.data(),
+                records.size(), &result);
+            offset += result.offset;
+            if (result.reason != DISASM_STOP_FULL) {
+                break;
+            }
+        }
+    }
+    report("batch", code.size() * rounds, count, seconds_since(start));
+
+    for (size_t size : chunk_sizes) {
+        char name[64];
+        size_t mismatches = 0;
+
+        // One checked pass, then the timed ones
+        count = 0;
+        for (int r = -1; r < rounds; r++) {
+            DisasmStream stream;
+            size_t index = 0;
+
+            if (r == 0) {
+                start = std::chrono::steady_clock::now();
+            }
+            x86_stream_init(&stream, DISASM_MODE_64, 0);
+            for (size_t offset = 0; ; offset += size) {
+                size_t n;
+
+                if (offset >= code.size()) {
+                    x86_stream_feed(&stream, NULL, 0);
+                    x86_stream_finish(&stream);
+                }
+                else {
+                    x86_stream_feed(&stream, code.data() + offset, code.size() - offset < size ? code.size() - offset : size);
+                }
+                while ((n = x86_stream_decode(&stream, records.data(), records.size())) != 0) {
+                    for (size_t i = 0; i < n && r < 0; i++) {
+                        mismatches += index + i >= total ||
+                            memcmp(&records[i], &expected[index + i], sizeof(DecodedInstruction)) != 0;
+                    }
+                    index += n;
+                }
+                if (offset >= code.size()) {
+                    break;
+                }
+            }
+            if (r < 0) {
+                mismatches += index != total;
+            }
+            else {
+                count += index;
+            }
+        }
+
+        snprintf(name, sizeof(name), "stream, %zu B chunks", size);
+        report(name, code.size() * rounds, count, seconds_since(start));
+        if (mismatches) {
+            printf("  MISMATCH with the batch decoder (%zu)\n", mismatches);
+        }
+    }
+}
+
+/*
+ * Command: print the listing of every executable region of an image
+ */
+static int command_disasm(const char* path, unsigned int syntax) {
+    static const char* const status_names[] = { "ok", "cannot open or map", "unknown format", "corrupt headers",
+        "unsupported machine", "out of memory" };
+    std::vector<DecodedInstruction> records(65536);
+    std::vector<char> text(1 << 20);
+    LoadedImage image;
+
+    DisasmImageStatus status = x86_image_load(path, DISASM_MAP_SEQUENTIAL, &image);
+    if (status != DISASM_IMAGE_OK) {
+        printf("error: %s: %s\n", path, status_names[status]);
+        x86_image_free(&image);
+        return 1;
+    }
+
+    for (size_t r = 0; r < image.region_count; r++) {
+        const CodeRegion* region = &image.regions[r];
+        size_t offset = 0;
+
+        printf("\nDisassembly of %s at 0x%llx (%zu bytes):\n\n", region->name[0] ? region->name : "segment",
+            (unsigned long long)region->address, region->size);
+
+        while (offset < region->size) {
+            DisasmBatchResult result;
+            size_t count = x86_disasm_batch_mode(image.mode, region->code + offset, region->size - offset,
+                region->address + offset, records.data(), records.size(), &result);
+
+            for (size_t i = 0; i < count;) {
+                size_t written;
+                i += x86_format_batch_mode(image.mode, &records[i], count - i,
+                    syntax | DISASM_FORMAT_ADDRESS | DISASM_FORMAT_BYTES, text.data(), text.size(), &written);
+                fwrite(text.data(), 1, written, stdout);
+            }
+
+            offset += result.offset;
+            if (result.reason == DISASM_STOP_TRUNCATED) {
+                printf("%llx: (truncated)\n", (unsigned long long)(region->address + offset));
+                break;
+            }
+        }
+    }
+
+    x86_image_free(&image);
+    return 0;
+}
+
+/*
+ * Command: decode every executable region of an image in place
+ *
+ * Records go through a fixed window, so memory use does not grow with the
+ * image.
+ */
+static int command_sweep(const char* path) {
+    std::vector<DecodedInstruction> records(65536);
+    LoadedImage image;
+    size_t bytes = 0;
+    size_t count = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    DisasmImageStatus status = x86_image_load(path, DISASM_MAP_POPULATE | DISASM_MAP_SEQUENTIAL, &image);
+    if (status != DISASM_IMAGE_OK) {
+        printf("error: cannot load %s (status %d)\n", path, (int)status);
+        x86_image_free(&image);
+        return 1;
+    }
+    double load_seconds = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < image.region_count; r++) {
+        const CodeRegion* region = &image.regions[r];
+        size_t offset = 0;
+
+        while (offset < region->size) {
+            DisasmBatchResult result;
+            count += x86_disasm_batch_mode(image.mode, region->code + offset, region->size - offset,
+                region->address + offset, records.data(), records.size(), &result);
+            offset += result.offset;
+            if (result.reason == DISASM_STOP_TRUNCATED) {
+                break;
+            }
+        }
+        bytes += region->size;
+    }
+
+    printf("%s: %zu regions, %zu functions, %d-bit, load %.2f ms\n", path, image.region_count, image.function_count,
+        (int)image.mode, load_seconds * 1e3);
+    report("sweep", bytes, count, seconds_since(start));
+    x86_image_free(&image);
+    return 0;
+}
+
+/*
+ * Command: recursive descent over every executable region of an image,
+ * seeded from the entry point and the image's functions, on 1..N threads
+ */
+static int command_descent(const char* path) {
+    LoadedImage image;
+    std::vector<uint64_t> seeds;
+    unsigned int max_threads = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+
+    DisasmImageStatus status = x86_image_load(path, DISASM_MAP_POPULATE, &image);
+    if (status != DISASM_IMAGE_OK) {
+        printf("error: cannot load %s (status %d)\n", path, (int)status);
+        x86_image_free(&image);
+        return 1;
+    }
+
+    if (image.entry) {
+        seeds.push_back(image.entry);
+    }
+    for (size_t i = 0; i < image.function_count; i++) {
+        seeds.push_back(image.functions[i].start);
+    }
+
+    printf("%s: %zu regions, %zu seeds, %u hardware threads\n", path, image.region_count, seeds.size(), max_threads);
+    for (unsigned int threads = 1; ; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+        size_t bytes = 0;
+        size_t count = 0;
+        size_t targets = 0;
+        char name[64];
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < image.region_count; r++) {
+            const CodeRegion* region = &image.regions[r];
+            CodeMap map;
+
+            if (!x86_descent(image.mode, region->code, region->size, region->address,
+                seeds.data(), seeds.size(), threads, &map)) {
+                printf("error: out of memory\n");
+                x86_code_map_free(&map);
+                continue;
+            }
+            count += map.instruction_count;
+            for (size_t w = 0; w < (region->size + 63) / 64; w++) {
+                targets += std::bitset<64>(map.targets[w]).count();
+            }
+            bytes += region->size;
+            x86_code_map_free(&map);
+        }
+        snprintf(name, sizeof(name), "descent (%u threads)", threads);
+        report(name, bytes, count, seconds_since(start));
+        if (threads == 1) {
+            printf("  %-24s %10zu targets\n", "", targets);
+        }
+
+        if (threads == max_threads) {
+            break;
+        }
+    }
+
+    x86_image_free(&image);
+    return 0;
+}
+
+// Known starts inside a code region, how many of them were found, and how many with the same end
+struct FunctionScore {
+    size_t known;
+    size_t found;
+    size_t exact;
+};
+
+static FunctionScore score_functions(const LoadedImage* image, const FunctionRange* functions, size_t count) {
+    FunctionScore score = { 0, 0, 0 };
+    size_t k = 0;
+
+    for (size_t i = 0; i < image->function_count; i++) {
+        const FunctionRange* function = &image->functions[i];
+        int in_code = 0;
+
+        for (size_t r = 0; r < image->region_count; r++) {
+            in_code |= function->start - image->regions[r].address < image->regions[r].size;
+        }
+        if (!in_code) {
+            continue;
+        }
+        score.known++;
+
+        while (k < count && functions[k].start < function->start) {
+            k++;
+        }
+        if (k < count && functions[k].start == function->start) {
+            score.found++;
+            score.exact += function->end > function->start && functions[k].end == function->end;
+        }
+    }
+    return score;
+}
+
+/*
+ * Command: find the functions of an image, with and without its own
+ * function list; the run without it is scored against that list
+ */
+static int command_functions(const char* path) {
+    LoadedImage image;
+    FunctionRange* functions;
+    size_t count;
+
+    DisasmImageStatus status = x86_image_load(path, DISASM_MAP_POPULATE, &image);
+    if (status != DISASM_IMAGE_OK) {
+        printf("error: cannot load %s (status %d)\n", path, (int)status);
+        x86_image_free(&image);
+        return 1;
+    }
+
+    // Reference: decode time of a plain sweep
+    std::vector<DecodedInstruction> records(1 << 20);
+    size_t bytes = 0;
+    size_t decoded = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < image.region_count; r++) {
+        const CodeRegion* region = &image.regions[r];
+        size_t offset = 0;
+
+        while (offset < region->size) {
+            DisasmBatchResult result;
+            decoded += x86_sweep_parallel(image.mode, region->code + offset, region->size - offset,
+                region->address + offset, records.data(), records.size(), 0, &result);
+            if (result.offset == 0) {
+                break;
+            }
+            offset += result.offset;
+        }
+        bytes += region->size;
+    }
+    printf("%s: %zu regions, %zu known functions\n", path, image.region_count, image.function_count);
+    report("sweep", bytes, decoded, seconds_since(start));
+
+    start = std::chrono::steady_clock::now();
+    if (!x86_find_functions(&image, 0, &functions, &count)) {
+        printf("error: out of memory\n");
+        x86_image_free(&image);
+        return 1;
+    }
+    report("functions", bytes, decoded, seconds_since(start));
+    printf("  %-24s %10zu functions\n", "", count);
+    x86_functions_free(functions);
+
+    // Stripped: hide the image's function list
+    LoadedImage stripped = image;
+    stripped.functions = NULL;
+    stripped.function_count = 0;
+
+    start = std::chrono::steady_clock::now();
+    if (!x86_find_functions(&stripped, 0, &functions, &count)) {
+        printf("error: out of memory\n");
+        x86_image_free(&image);
+        return 1;
+    }
+    report("functions (stripped)", bytes, decoded, seconds_since(start));
+    printf("  %-24s %10zu functions\n", "", count);
+
+    if (image.function_count) {
+        FunctionScore score = score_functions(&image, functions, count);
+        printf("  %-24s %10zu / %zu known starts found, %zu with the same end, %zu extra\n", "",
+            score.found, score.known, score.exact, count - score.found);
+    }
+
+    x86_functions_free(functions);
+    x86_image_free(&image);
+    return 0;
+}
+
+/*
+ * Command: build the cross-reference index of an image, compare lookups
+ * with a rescan, and optionally save the index and load it back
+ */
+static int command_xrefs(const char* path, const char* index_path) {
+    LoadedImage image;
+    XrefIndex index;
+    size_t bytes = 0;
+    size_t types[4] = { 0, 0, 0, 0 };
+
+    DisasmImageStatus status = x86_image_load(path, DISASM_MAP_POPULATE, &image);
+    if (status != DISASM_IMAGE_OK) {
+        printf("error: cannot load %s (status %d)\n", path, (int)status);
+        x86_image_free(&image);
+        return 1;
+    }
+
+    x86_xref_init(&index);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < image.region_count; r++) {
+        const CodeRegion* region = &image.regions[r];
+
+        if (!x86_xref_add_code(&index, image.mode, region->code, region->size, region->address) ||
+            !x86_xref_commit(&index)) {
+            printf("error: out of memory\n");
+            x86_xref_free(&index);
+            x86_image_free(&image);
+            return 1;
+        }
+        bytes += region->size;
+    }
+    double seconds = seconds_since(start);
+
+    for (size_t i = 0; i < index.count; i++) {
+        types[index.types[i]]++;
+    }
+    printf("%s: %zu regions, %zu references in %.1f ms (%.1f MB/s)\n", path, image.region_count, index.count,
+        seconds * 1e3, bytes / seconds / 1e6);
+    printf("  %zu branches, %zu jumps, %zu calls, %zu data\n", types[DISASM_XREF_BRANCH], types[DISASM_XREF_JUMP],
+        types[DISASM_XREF_CALL], types[DISASM_XREF_DATA]);
+    if (index.count == 0) {
+        x86_xref_free(&index);
+        x86_image_free(&image);
+        return 0;
+    }
+
+    // One query by rescanning, against the same query through the index
+    std::vector<DecodedInstruction> records(4096);
+    uint64_t target = index.targets[index.count / 2];
+    size_t found = 0;
+    size_t first;
+
+    start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < image.region_count; r++) {
+        const CodeRegion* region = &image.regions[r];
+        size_t offset = 0;
+
+        while (offset < region->size) {
+            DisasmBatchResult result;
+            size_t count = x86_disasm_batch_mode(image.mode, region->code + offset, region->size - offset,
+                region->address + offset, records.data(), records.size(), &result);
+
+            for (size_t i = 0; i < count; i++) {
+                found += (records[i].info.flags & (FLAG_RELATIVE | FLAG_RIP_RELATIVE)) && records[i].target == target;
+            }
+            if (result.reason != DISASM_STOP_FULL) {
+                break;
+            }
+            offset += result.offset;
+        }
+    }
+    double rescan = seconds_since(start);
+
+    const int lookups = 1000000;
+    size_t total = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; i++) {
+        total += x86_xref_find(&index, index.targets[(size_t)i * 7919 % index.count], &first);
+    }
+    double lookup = seconds_since(start) / lookups;
+
+    printf("  references to 0x%llx: %zu by rescan in %.2f ms, %zu by lookup in %.0f ns\n",
+        (unsigned long long)target, found, rescan * 1e3, x86_xref_find(&index, target, &first), lookup * 1e9);
+
+    if (index_path) {
+        XrefIndex loaded;
+
+        if (!x86_xref_save(&index, index_path)) {
+            printf("error: cannot write %s\n", index_path);
+        }
+        else {
+            start = std::chrono::steady_clock::now();
+            if (!x86_xref_load(index_path, DISASM_MAP_DEFAULT, &loaded)) {
+                printf("error: cannot load %s\n", index_path);
+            }
+            else {
+                seconds = seconds_since(start);
+                int same = loaded.count == index.count &&
+                    memcmp(loaded.targets, index.targets, index.count * sizeof(uint64_t)) == 0 &&
+                    memcmp(loaded.sources, index.sources, index.count * sizeof(uint64_t)) == 0 &&
+                    memcmp(loaded.types, index.types, index.count) == 0;
+                printf("  saved to %s, mapped back in %.3f ms: %s\n", index_path, seconds * 1e3,
+                    same ? "identical" : "MISMATCH");
+            }
+            x86_xref_free(&loaded);
+        }
+    }
+
+    x86_xref_free(&index);
+    x86_image_free(&image);
+    return 0;
+}
+
+static int command_patch(const char* path) {
+    LoadedImage image;
+    const CodeRegion* region = NULL;
+
+    DisasmImageStatus status = x86_image_load(path, DISASM_MAP_POPULATE, &image);
+    if (status != DISASM_IMAGE_OK) {
+        printf("error: cannot load %s (status %d)\n", path, (int)status);
+        x86_image_free(&image);
+        return 1;
+    }
+    for (size_t r = 0; r < image.region_count; r++) {
+        if (!region || image.regions[r].size > region->size) {
+            region = &image.regions[r];
+        }
+    }
+    if (!region || region->size == 0) {
+        printf("error: no code in %s\n", path);
+        x86_image_free(&image);
+        return 1;
+    }
+
+    // Patched in a private copy of the largest region
+    std::vector<uint8_t> code(region->code, region->code + region->size);
+    DecodedListing listing;
+    XrefIndex index;
+
+    x86_xref_init(&index);
+    auto start = std::chrono::steady_clock::now();
+    int built = x86_listing_build(&listing, image.mode, code.data(), code.size(), region->address, 0);
+    double build = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    built = built && x86_xref_add_code(&index, image.mode, code.data(), code.size(), region->address) &&
+        x86_xref_commit(&index);
+    double rebuild_xrefs = seconds_since(start);
+    if (!built) {
+        printf("error: out of memory\n");
+        x86_listing_free(&listing);
+        x86_xref_free(&index);
+        x86_image_free(&image);
+        return 1;
+    }
+    printf("%s: %s, %zu instructions in %.1f ms, %zu references in %.1f ms\n", path, region->name,
+        listing.instruction_count, build * 1e3, index.count, rebuild_xrefs * 1e3);
+
+    // Small patches at spread out offsets: random bytes, a nop slide or a call
+    const int patches = 1000;
+    uint32_t seed = 1;
+    size_t redecoded = 0;
+    int failed = 0;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < patches && !failed; i++) {
+        AddressRange range;
+        AddressRange span;
+        size_t spans;
+        size_t offset, length;
+
+        seed = seed * 1103515245 + 12345;
+        offset = (size_t)(((uint64_t)seed << 16) % code.size());
+        length = 1 + (seed >> 8) % 8;
+        if (length > code.size() - offset) {
+            length = code.size() - offset;
+        }
+        for (size_t b = 0; b < length; b++) {
+            seed = seed * 1103515245 + 12345;
+            code[offset + b] = i % 3 == 0 ? (uint8_t)(seed >> 16) : i % 3 == 1 ? 0x90 : b == 0 ? 0xE8 : (uint8_t)(seed >> 16);
+        }
+
+        range.start = region->address + offset;
+        range.end = range.start + length;
+        failed = !x86_listing_patch(&listing, &range, 1, &index, &span, &spans);
+        if (spans) {
+            redecoded += span.end - span.start;
+        }
+    }
+    double patch = seconds_since(start) / patches;
+
+    // The patched listing against a fresh sweep of the patched bytes
+    std::vector<DecodedInstruction> fresh(code.size() + 1);
+    std::vector<DecodedInstruction> kept(listing.instruction_count + 1);
+    DisasmBatchResult result;
+    size_t count = x86_disasm_batch_mode(image.mode, code.data(), code.size(), region->address, fresh.data(),
+        fresh.size(), &result);
+    size_t copied = x86_listing_copy(&listing, region->address, region->address + code.size(), kept.data(), kept.size());
+    int same = !failed && count == copied && count == listing.instruction_count &&
+        memcmp(fresh.data(), kept.data(), count * sizeof(DecodedInstruction)) == 0;
+
+    printf("  %d patches in %.2f us each, %.1f bytes re-decoded on average: %s\n", patches, patch * 1e6,
+        (double)redecoded / patches, same ? "identical to a full sweep" : "MISMATCH with a full sweep");
+    printf("  full rebuild %.1f ms (%.0fx a patch)\n", (build + rebuild_xrefs) * 1e3, (build + rebuild_xrefs) / patch);
+
+    x86_listing_free(&listing);
+    x86_xref_free(&index);
+    x86_image_free(&image);
+    return same ? 0 : 1;
+}
+
+static int command_stream(const char* path) {
+    FILE* file = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+    std::vector<uint8_t> chunk(65536);
+    std::vector<DecodedInstruction> records(4096);
+    DisasmStream stream;
+    size_t bytes = 0;
+    size_t count = 0;
+    size_t errors = 0;
+
+    if (!file) {
+        printf("error: cannot open %s\n", path);
+        return 1;
+    }
+
+    // Decoded as it is read, with the reads split wherever they fall
+    x86_stream_init(&stream, DISASM_MODE_64, 0);
+    auto start = std::chrono::steady_clock::now();
+    for (;;) {
+        size_t length = fread(chunk.data(), 1, chunk.size(), file);
+        size_t n;
+
+        if (length == 0) {
+            x86_stream_finish(&stream);
+        }
+        x86_stream_feed(&stream, chunk.data(), length);
+        while ((n = x86_stream_decode(&stream, records.data(), records.size())) != 0) {
+            for (size_t i = 0; i < n; i++) {
+                errors += (records[i].info.flags & FLAG_MASK_ANY_ERROR) != 0;
+            }
+            count += n;
+        }
+        bytes += length;
+        if (length == 0) {
+            break;
+        }
+    }
+    double seconds = seconds_since(start);
+
+    if (file != stdin) {
+        fclose(file);
+    }
+    printf("%s: %zu bytes, %zu instructions (%zu invalid), %u bytes truncated at the end, %.1f MB/s\n", path, bytes,
+        count, errors, stream.carry_length, bytes / seconds / 1e6);
+    return 0;
+}
+
+static int command_store(const char* path, const char* store_path) {
+    LoadedImage image;
+    const CodeRegion* region = NULL;
+    DecodedStore store;
+
+    DisasmImageStatus status = x86_image_load(path, DISASM_MAP_POPULATE, &image);
+    if (status != DISASM_IMAGE_OK) {
+        printf("error: cannot load %s (status %d)\n", path, (int)status);
+        x86_image_free(&image);
+        return 1;
+    }
+    for (size_t r = 0; r < image.region_count; r++) {
+        if (!region || image.regions[r].size > region->size) {
+            region = &image.regions[r];
+        }
+    }
+    if (!region || region->size == 0) {
+        printf("error: no code in %s\n", path);
+        x86_image_free(&image);
+        return 1;
+    }
+
+    // The store is used when it was written for these bytes, else rewritten
+    auto start = std::chrono::steady_clock::now();
+    uint64_t hash = x86_content_hash(region->code, region->size);
+    double hashing = seconds_since(start);
+    int hit = x86_store_load(store_path, DISASM_MAP_DEFAULT, &store) && store.hash == hash &&
+        store.mode == image.mode && store.address == region->address && store.length == region->size;
+
+    printf("%s: %s, %zu bytes, content hash %016llx in %.2f ms\n", path, region->name, region->size,
+        (unsigned long long)hash, hashing * 1e3);
+    if (!hit) {
+        x86_store_free(&store);
+        start = std::chrono::steady_clock::now();
+        if (!x86_store_write(store_path, image.mode, region->code, region->size, region->address)) {
+            printf("error: cannot write %s\n", store_path);
+            x86_image_free(&image);
+            return 1;
+        }
+        printf("  decoded and written to %s in %.1f ms\n", store_path, seconds_since(start) * 1e3);
+    }
+
+    start = std::chrono::steady_clock::now();
+    if (!x86_store_load(store_path, DISASM_MAP_DEFAULT, &store)) {
+        printf("error: cannot load %s\n", store_path);
+        x86_image_free(&image);
+        return 1;
+    }
+    double load = seconds_since(start);
+    printf("  %s %s: %zu instructions in %zu blocks, mapped in %.1f us\n", hit ? "found" : "reloaded", store_path,
+        store.instruction_count, store.block_count, load * 1e6);
+
+    // Direct calls: from the opcode and target columns, against decoding
+    size_t calls = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < store.block_count; b++) {
+        InstructionColumns columns;
+        const uint64_t* targets;
+        size_t rows = x86_store_block(&store, b, &columns, &targets);
+
+        for (size_t i = 0; i < rows; i++) {
+            calls += columns.map[i] == 0 && columns.opcode[i] == 0xE8 && targets[i] != 0;
+        }
+    }
+    double scan = seconds_since(start);
+
+    std::vector<DecodedInstruction> records(4096);
+    size_t decoded_calls = 0;
+    size_t offset = 0;
+    start = std::chrono::steady_clock::now();
+    while (offset < region->size) {
+        DisasmBatchResult result;
+        size_t count = x86_disasm_batch_mode(image.mode, region->code + offset, region->size - offset,
+            region->address + offset, records.data(), records.size(), &result);
+
+        for (size_t i = 0; i < count; i++) {
+            decoded_calls += records[i].info.map == 0 && records[i].info.opcode == 0xE8 && records[i].target != 0;
+        }
+        offset += result.offset;
+        if (result.reason != DISASM_STOP_FULL) {
+            break;
+        }
+    }
+    double decode = seconds_since(start);
+
+    printf("  %zu direct calls from the store in %.2f ms (first touch), %zu by decoding in %.2f ms%s\n", calls,
+        scan * 1e3, decoded_calls, decode * 1e3, calls == decoded_calls ? "" : ", MISMATCH");
+
+    x86_store_free(&store);
+    x86_image_free(&image);
+    return calls == decoded_calls ? 0 : 1;
+}
+
+// Terms of an instruction, as x86_index_build collects them
+static size_t instruction_terms(DisasmMode mode, const uint8_t* code, const DecodedInstruction* insn, IndexTerm* terms) {
+    InstructionOperand operands[X86_MAX_OPERANDS];
+    PackedInstruction packed;
+    size_t count = 0;
+
+    x86_pack_instruction(&insn->info, 0, &packed);
+    terms[count++] = { DISASM_TERM_OPCODE, (uint64_t)packed.map << 8 | packed.opcode };
+    if (packed.flags & PACKED_MODRM) {
+        terms[count++] = { DISASM_TERM_MODRM_REG, (uint64_t)insn->info.modrm_reg };
+    }
+    if (PACKED_IMM_SIZE(&packed) && !(packed.flags & PACKED_RELATIVE)) {
+        terms[count++] = { DISASM_TERM_IMMEDIATE, x86_packed_immediate(&packed, code) };
+    }
+
+    unsigned int operand_count = x86_decode_operands(mode, &insn->info, operands);
+    for (unsigned int i = 0; i < operand_count; i++) {
+        const InstructionOperand* operand = &operands[i];
+        OperandRegister read[2] = { operand->reg, { REGCLASS_NONE, 0 } };
+
+        if (operand->type == OPERAND_MEMORY) {
+            read[0] = operand->base;
+            read[1] = operand->index;
+        }
+        else if (operand->type != OPERAND_REGISTER) {
+            continue;
+        }
+        for (int r = 0; r < 2; r++) {
+            if (read[r].reg_class != REGCLASS_NONE &&
+                (operand->type == OPERAND_MEMORY || (operand->access & OPERAND_ACCESS_READ))) {
+                terms[count++] = { DISASM_TERM_READ, (uint64_t)read[r].reg_class << 8 | read[r].index };
+            }
+        }
+        if (operand->type == OPERAND_REGISTER && operand->reg.reg_class != REGCLASS_NONE &&
+            (operand->access & OPERAND_ACCESS_WRITE)) {
+            terms[count++] = { DISASM_TERM_WRITE, (uint64_t)operand->reg.reg_class << 8 | operand->reg.index };
+        }
+    }
+
+    return count;
+}
+
+static int command_index(const char* path) {
+    LoadedImage image;
+    const CodeRegion* region = NULL;
+    InstructionIndex index;
+
+    DisasmImageStatus status = x86_image_load(path, DISASM_MAP_POPULATE, &image);
+    if (status != DISASM_IMAGE_OK) {
+        printf("error: cannot load %s (status %d)\n", path, (int)status);
+        x86_image_free(&image);
+        return 1;
+    }
+    for (size_t r = 0; r < image.region_count; r++) {
+        if (!region || image.regions[r].size > region->size) {
+            region = &image.regions[r];
+        }
+    }
+    if (!region || region->size == 0 || region->size > UINT32_MAX) {
+        printf("error: no indexable code in %s\n", path);
+        x86_image_free(&image);
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (!x86_index_build(&index, image.mode, region->code, region->size)) {
+        printf("error: cannot index %s\n", path);
+        x86_image_free(&image);
+        return 1;
+    }
+    printf("%s: %s, %zu bytes, %zu instructions, %zu terms, %zu postings in %zu bytes, built in %.1f ms\n", path,
+        region->name, region->size, index.instruction_count, index.term_count, index.posting_count, index.data_size,
+        seconds_since(start) * 1e3);
+
+    uint64_t gpr = image.mode == DISASM_MODE_64 ? (uint64_t)REGCLASS_GPR64 << 8 : (uint64_t)REGCLASS_GPR32 << 8;
+    struct Query {
+        const char* name;
+        int any;
+        size_t term_count;
+        IndexTerm terms[3];
+    } queries[] = {
+        { "syscall", 0, 1, { { DISASM_TERM_OPCODE, 0x105 } } },
+        { "writes cr3", 0, 1, { { DISASM_TERM_WRITE, (uint64_t)REGCLASS_CONTROL << 8 | 3 } } },
+        { "immediate 0xdeadbeef", 0, 1, { { DISASM_TERM_IMMEDIATE, 0xDEADBEEF } } },
+        { "int3", 0, 1, { { DISASM_TERM_OPCODE, 0xCC } } },
+        { "mov to memory through the stack pointer", 0, 2,
+            { { DISASM_TERM_OPCODE, 0x89 }, { DISASM_TERM_READ, gpr | 4 } } },
+        { "indirect call through rax/eax", 0, 3, { { DISASM_TERM_OPCODE, 0xFF }, { DISASM_TERM_MODRM_REG, 2 },
+            { DISASM_TERM_READ, gpr | 0 } } },
+        { "direct call or jmp", 1, 2, { { DISASM_TERM_OPCODE, 0xE8 }, { DISASM_TERM_OPCODE, 0xE9 } } },
+        { "ModR/M reg 16, 17 or 31 (EVEX.R')", 1, 3,
+            { { DISASM_TERM_MODRM_REG, 16 }, { DISASM_TERM_MODRM_REG, 17 }, { DISASM_TERM_MODRM_REG, 31 } } },
+    };
+    const size_t query_count = sizeof(queries) / sizeof(queries[0]);
+
+    std::vector<uint32_t> matches(index.instruction_count);
+    size_t counts[query_count];
+    for (size_t q = 0; q < query_count; q++) {
+        const Query* query = &queries[q];
+
+        start = std::chrono::steady_clock::now();
+        int ok = (query->any ? x86_index_or : x86_index_and)(&index, query->terms, query->term_count, matches.data(),
+            matches.size(), &counts[q]);
+        double seconds = seconds_since(start);
+
+        if (!ok) {
+            printf("error: out of memory\n");
+            x86_index_free(&index);
+            x86_image_free(&image);
+            return 1;
+        }
+        printf("  %-40s %9zu in %8.3f ms", query->name, counts[q], seconds * 1e3);
+        if (counts[q]) {
+            printf(", first at %llx", (unsigned long long)(region->address + matches[0]));
+        }
+        printf("\n");
+    }
+
+    // The same queries by decoding everything again
+    std::vector<DecodedInstruction> records(4096);
+    size_t rescanned[query_count] = {};
+    size_t offset = 0;
+    start = std::chrono::steady_clock::now();
+    while (offset < region->size) {
+        DisasmBatchResult result;
+        size_t count = x86_disasm_batch_mode(image.mode, region->code + offset, region->size - offset,
+            region->address + offset, records.data(), records.size(), &result);
+
+        for (size_t i = 0; i < count; i++) {
+            IndexTerm terms[3 + 3 * X86_MAX_OPERANDS];
+            size_t term_count;
+
+            if (records[i].info.flags & FLAG_MASK_ANY_ERROR) {
+                continue;
+            }
+            term_count = instruction_terms(image.mode, region->code + (records[i].address - region->address),
+                &records[i], terms);
+            for (size_t q = 0; q < query_count; q++) {
+                size_t found = 0;
+
+                for (size_t t = 0; t < queries[q].term_count; t++) {
+                    for (size_t k = 0; k < term_count; k++) {
+                        if (terms[k].kind == queries[q].terms[t].kind && terms[k].value == queries[q].terms[t].value) {
+                            found++;
+                            break;
+                        }
+                    }
+                }
+                rescanned[q] += queries[q].any ? found != 0 : found == queries[q].term_count;
+            }
+        }
+        offset += result.offset;
+        if (result.reason != DISASM_STOP_FULL) {
+            break;
+        }
+    }
+    double rescan = seconds_since(start);
+
+    int mismatches = 0;
+    for (size_t q = 0; q < query_count; q++) {
+        mismatches += rescanned[q] != counts[q];
+    }
+    printf("  rescan for all %zu queries: %.1f ms%s\n", query_count, rescan * 1e3, mismatches ? ", MISMATCH" : "");
+
+    x86_index_free(&index);
+    x86_image_free(&image);
+    return mismatches ? 1 : 0;
+}
+
+// A signature as runs of fixed bytes for memcmp, and nibble-masked bytes
+struct NaiveSignature {
+    std::vector<uint8_t> bytes;
+    std::vector<uint8_t> masks;
+    std::vector<std::pair<size_t, size_t>> runs;
+    std::vector<size_t> partial;
+};
+
+static bool parse_naive_signature(const char* text, NaiveSignature* signature) {
+    while (*text) {
+        const char* digits = "0123456789abcdef0123456789ABCDEF";
+        int nibbles[2];
+
+        if (*text == ' ') {
+            text++;
+            continue;
+        }
+        if (text[0] == '?' && text[1] != '?' && !(text[1] && strchr(digits, text[1]))) {
+            nibbles[0] = nibbles[1] = 16;
+            text++;
+        }
+        else {
+            for (int n = 0; n < 2; n++) {
+                const char* digit = text[n] ? strchr(digits, text[n]) : NULL;
+                nibbles[n] = text[n] == '?' ? 16 : digit ? (int)(digit - digits) % 16 : -1;
+                if (nibbles[n] < 0) {
+                    return false;
+                }
+            }
+            text += 2;
+        }
+        signature->bytes.push_back((uint8_t)((nibbles[0] & 15) << 4 | (nibbles[1] & 15)));
+        signature->masks.push_back((uint8_t)((nibbles[0] == 16 ? 0 : 0xF0) | (nibbles[1] == 16 ? 0 : 0x0F)));
+        signature->bytes.back() &= signature->masks.back();
+    }
+
+    for (size_t i = 0; i < signature->bytes.size(); i++) {
+        if (signature->masks[i] == 0xFF) {
+            if (i == 0 || signature->masks[i - 1] != 0xFF) {
+                signature->runs.push_back(std::make_pair(i, (size_t)0));
+            }
+            signature->runs.back().second++;
+        }
+        else if (signature->masks[i]) {
+            signature->partial.push_back(i);
+        }
+    }
+    return !signature->bytes.empty();
+}
+
+static int command_signatures(const char* path, int pattern_count, char** pattern_args) {
+    static const char* const default_patterns[] = {
+        "48 8B 05 ?? ?? ?? ?? 48 85 C0",    // mov rax, [rip+x]; test rax, rax
+        "48 8D 3D ?? ?? ?? ??",             // lea rdi, [rip+x]
+        "E8 ?? ?? ?? ?? 85 C0",             // call; test eax, eax
+        "48 83 EC ??",                      // sub rsp, imm8
+        "55 48 89 E5",                      // push rbp; mov rbp, rsp
+        "0F 05",                            // syscall
+        "FF 15 ?? ?? ?? ??",                // call [rip+x]
+        "48 89 5C 24 ??",                   // mov [rsp+x], rbx
+        "41 57 41 56",                      // push r15; push r14
+        "F3 0F 1E FA",                      // endbr64
+        "B8 ?? ?? ?? ?? 0F 05",             // mov eax, imm32; syscall
+        "4C 8D 05 ?? ?? ?? ??",             // lea r8, [rip+x]
+        "0F 84 ?? ?? ?? ?? 48 8B",          // je rel32; mov
+        "C7 44 24 ?? ?? ?? ?? ??",          // mov dword [rsp+x], imm32
+        "66 0F 1F 44 00 00",                // nop word [rax+rax]
+        "8B ?? 24 ??",                      // mov r32, [rsp+x]
+    };
+    const char* const* patterns = pattern_count ? (const char* const*)pattern_args : default_patterns;
+    size_t count = pattern_count ? (size_t)pattern_count : sizeof(default_patterns) / sizeof(default_patterns[0]);
+    std::vector<NaiveSignature> naive(count);
+    LoadedImage image;
+    const CodeRegion* region = NULL;
+    SignatureSet set;
+    size_t bad;
+
+    for (size_t p = 0; p < count; p++) {
+        if (!parse_naive_signature(patterns[p], &naive[p])) {
+            printf("error: invalid pattern '%s'\n", patterns[p]);
+            return 1;
+        }
+    }
+    if (!x86_signature_compile(&set, patterns, count, &bad)) {
+        printf("error: cannot compile '%s'\n", bad < count ? patterns[bad] : "(out of memory)");
+        return 1;
+    }
+
+    DisasmImageStatus status = x86_image_load(path, DISASM_MAP_POPULATE, &image);
+    if (status != DISASM_IMAGE_OK) {
+        printf("error: cannot load %s (status %d)\n", path, (int)status);
+        x86_signature_free(&set);
+        x86_image_free(&image);
+        return 1;
+    }
+    for (size_t r = 0; r < image.region_count; r++) {
+        if (!region || image.regions[r].size > region->size) {
+            region = &image.regions[r];
+        }
+    }
+    if (!region || region->size == 0) {
+        printf("error: no code in %s\n", path);
+        x86_signature_free(&set);
+        x86_image_free(&image);
+        return 1;
+    }
+    const uint8_t* code = region->code;
+    size_t size = region->size;
+    printf("%s: %s, %zu bytes, %zu patterns\n", path, region->name, size, count);
+
+    // Naive: memcmp of every pattern at every offset
+    std::vector<SignatureMatch> naive_matches;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t offset = 0; offset < size; offset++) {
+        for (size_t p = 0; p < count; p++) {
+            const NaiveSignature* signature = &naive[p];
+            bool match = offset + signature->bytes.size() <= size;
+
+            for (size_t r = 0; match && r < signature->runs.size(); r++) {
+                match = memcmp(code + offset + signature->runs[r].first, &signature->bytes[signature->runs[r].first],
+                    signature->runs[r].second) == 0;
+            }
+            for (size_t i = 0; match && i < signature->partial.size(); i++) {
+                size_t k = signature->partial[i];
+                match = (code[offset + k] & signature->masks[k]) == signature->bytes[k];
+            }
+            if (match) {
+                naive_matches.push_back({ region->address + offset, (uint32_t)p });
+            }
+        }
+    }
+    double naive_time = seconds_since(start);
+
+    // Then the hits off the instruction starts are thrown away
+    std::vector<uint8_t> lengths(4096);
+    std::vector<uint64_t> starts((size + 63) / 64);
+    std::vector<SignatureMatch> naive_aligned;
+    size_t offset = 0;
+    start = std::chrono::steady_clock::now();
+    while (offset < size) {
+        DisasmBatchResult result;
+        size_t length_count = x86_insn_length_batch_mode(image.mode, code + offset, size - offset, lengths.data(),
+            lengths.size(), &result);
+
+        for (size_t i = 0; i < length_count; i++) {
+            starts[offset / 64] |= (uint64_t)1 << (offset % 64);
+            offset += lengths[i];
+        }
+        if (result.reason != DISASM_STOP_FULL) {
+            break;
+        }
+    }
+    for (size_t i = 0; i < naive_matches.size(); i++) {
+        size_t at = (size_t)(naive_matches[i].address - region->address);
+        if ((starts[at / 64] >> (at % 64)) & 1) {
+            naive_aligned.push_back(naive_matches[i]);
+        }
+    }
+    double filter_time = seconds_since(start);
+
+    printf("  %-36s %9zu matches %8.1f MB/s\n", "naive memcmp, any offset", naive_matches.size(),
+        size / naive_time / 1e6);
+    printf("  %-36s %9zu matches %8.1f MB/s\n", "naive memcmp, then sweep filter", naive_aligned.size(),
+        size / (naive_time + filter_time) / 1e6);
+
+    struct {
+        const char* name;
+        DisasmSignatureAlign align;
+        const std::vector<SignatureMatch>* expected;
+    } runs[] = {
+        { "x86_signature_scan, any offset", DISASM_SIGNATURE_ANY, &naive_matches },
+        { "x86_signature_scan, sweep", DISASM_SIGNATURE_SWEEP, &naive_aligned },
+        { "x86_signature_scan, known starts", DISASM_SIGNATURE_STARTS, &naive_aligned },
+    };
+    std::vector<SignatureMatch> matches(naive_matches.size() + 1);
+    int mismatches = 0;
+    for (size_t r = 0; r < sizeof(runs) / sizeof(runs[0]); r++) {
+        size_t match_count = 0;
+        int rounds = 0;
+        double seconds;
+
+        start = std::chrono::steady_clock::now();
+        do {
+            if (!x86_signature_scan(&set, image.mode, code, size, region->address, runs[r].align, starts.data(),
+                matches.data(), matches.size(), &match_count)) {
+                printf("error: out of memory\n");
+                x86_signature_free(&set);
+                x86_image_free(&image);
+                return 1;
+            }
+            rounds++;
+        } while ((seconds = seconds_since(start)) < 0.2);
+
+        bool same = match_count == runs[r].expected->size();
+        for (size_t i = 0; same && i < match_count; i++) {
+            same = matches[i].address == (*runs[r].expected)[i].address &&
+                matches[i].pattern == (*runs[r].expected)[i].pattern;
+        }
+        mismatches += !same;
+        printf("  %-36s %9zu matches %8.1f MB/s%s\n", runs[r].name, match_count, size * rounds / seconds / 1e6,
+            same ? "" : ", MISMATCH");
+    }
+
+    for (size_t p = 0; p < count; p++) {
+        size_t hits = 0;
+        for (size_t i = 0; i < naive_aligned.size(); i++) {
+            hits += naive_aligned[i].pattern == p;
+        }
+        printf("    %-34s %9zu aligned\n", patterns[p], hits);
+    }
+
+    x86_signature_free(&set);
+    x86_image_free(&image);
+    return mismatches ? 1 : 0;
+}
+
+/*
+ * Self-check: the PE loader against the checked-in fixtures
+ *
+ * fixtures/pe32.exe is a PE32 image with two executable sections, the
+ * second with a virtual size past its raw data. fixtures/pe64.exe is a
+ * PE32+ image whose .pdata lists three functions, stored at file offsets
+ * that differ from their RVAs; fixtures/pe64_mapped.bin is the same image
+ * in the loaded layout.
+ */
+struct FixtureRegion {
+    const char* name;
+    uint64_t address;
+    uint64_t file_offset;
+    size_t size;
+    uint8_t first;          // First code byte
+};
+
+struct FixtureImage {
+    const char* file;
+    unsigned int map_flags;
+    DisasmMode mode;
+    uint64_t base;
+    uint64_t entry;
+    size_t region_count;
+    FixtureRegion regions[2];
+    size_t function_count;
+    FunctionRange functions[3];
+};
+
+static const FixtureImage g_pe_fixtures[] = {
+    { "pe32.exe", DISASM_MAP_DEFAULT, DISASM_MODE_32, 0x400000, 0x401000,
+        2, { { ".text", 0x401000, 0x200, 0x20, 0x55 }, { "INIT", 0x403000, 0x600, 0x200, 0xE8 } },
+        0, { } },
+    { "pe64.exe", DISASM_MAP_DEFAULT, DISASM_MODE_64, 0x140000000, 0x140001000,
+        1, { { ".text", 0x140001000, 0x200, 0x30, 0x55 } },
+        3, { { 0x140001000, 0x14000100B }, { 0x140001010, 0x140001018 }, { 0x140001020, 0x140001025 } } },
+    { "pe64_mapped.bin", DISASM_MAP_MEMORY_LAYOUT, DISASM_MODE_64, 0x140000000, 0x140001000,
+        1, { { ".text", 0x140001000, 0x1000, 0x30, 0x55 } },
+        3, { { 0x140001000, 0x14000100B }, { 0x140001010, 0x140001018 }, { 0x140001020, 0x140001025 } } },
+};
+
+static int check_pe_fixture(const char* directory, const FixtureImage* fixture) {
+    char path[1024];
+    LoadedImage image;
+    int failures = 0;
+
+    snprintf(path, sizeof(path), "%s/%s", directory, fixture->file);
+    DisasmImageStatus status = x86_image_load(path, fixture->map_flags, &image);
+    if (status != DISASM_IMAGE_OK) {
+        printf("  %s: cannot load (status %d), MISMATCH\n", fixture->file, (int)status);
+        x86_image_free(&image);
+        return 1;
+    }
+
+#define FIXTURE_EXPECT(condition, ...) do { \
+        if (!(condition)) { \
+            printf("  %s: ", fixture->file); \
+            printf(__VA_ARGS__); \
+            printf(", MISMATCH\n"); \
+            failures++; \
+        } \
+    } while (0)
+
+    FIXTURE_EXPECT(image.format == DISASM_IMAGE_PE, "format %d", (int)image.format);
+    FIXTURE_EXPECT(image.mode == fixture->mode, "mode %d", (int)image.mode);
+    FIXTURE_EXPECT(image.base == fixture->base, "base 0x%llx", (unsigned long long)image.base);
+    FIXTURE_EXPECT(image.entry == fixture->entry, "entry 0x%llx", (unsigned long long)image.entry);
+
+    // Regions: name, address and where the bytes come from
+    FIXTURE_EXPECT(image.region_count == fixture->region_count, "%zu regions", image.region_count);
+    for (size_t r = 0; r < image.region_count && r < fixture->region_count; r++) {
+        const CodeRegion* region = &image.regions[r];
+        const FixtureRegion* expected = &fixture->regions[r];
+        size_t available = 0;
+
+        FIXTURE_EXPECT(strcmp(region->name, expected->name) == 0, "region %zu name '%s'", r, region->name);
+        FIXTURE_EXPECT(region->address == expected->address, "region %s at 0x%llx", expected->name,
+            (unsigned long long)region->address);
+        FIXTURE_EXPECT(region->file_offset == expected->file_offset && region->code == image.file.data +
+            expected->file_offset, "region %s at file offset 0x%llx", expected->name,
+            (unsigned long long)region->file_offset);
+        FIXTURE_EXPECT(region->size == expected->size, "region %s size 0x%zx", expected->name, region->size);
+        FIXTURE_EXPECT(region->size && region->code[0] == expected->first, "region %s starts with %02x",
+            expected->name, region->size ? region->code[0] : 0);
+        FIXTURE_EXPECT(x86_image_code(&image, expected->address + 1, &available) == region->code + 1 &&
+            available == region->size - 1, "x86_image_code(0x%llx)", (unsigned long long)expected->address + 1);
+    }
+    FIXTURE_EXPECT(x86_image_code(&image, fixture->base, NULL) == NULL, "x86_image_code(base) is not NULL");
+
+    // Functions: the .pdata entries, each decoding to a ret at its end
+    FIXTURE_EXPECT(image.function_count == fixture->function_count, "%zu functions", image.function_count);
+    for (size_t f = 0; f < image.function_count && f < fixture->function_count; f++) {
+        const FunctionRange* function = &image.functions[f];
+        const FunctionRange* expected = &fixture->functions[f];
+        size_t available = 0;
+        const uint8_t* code = x86_image_code(&image, function->start, &available);
+        DecodedInstruction records[16];
+        DisasmBatchResult result;
+        size_t length = (size_t)(function->end - function->start);
+        size_t count = 0;
+
+        FIXTURE_EXPECT(function->start == expected->start && function->end == expected->end,
+            "function %zu is 0x%llx-0x%llx", f, (unsigned long long)function->start,
+            (unsigned long long)function->end);
+        if (code && length <= available) {
+            count = x86_disasm_batch_mode(image.mode, code, length, function->start, records, 16, &result);
+        }
+        FIXTURE_EXPECT(count && result.reason == DISASM_STOP_END && records[count - 1].info.opcode == 0xC3,
+            "function 0x%llx does not decode to a ret at its end", (unsigned long long)function->start);
+    }
+
+    // Function discovery keeps the .pdata extents and finds the entry point
+    FunctionRange* functions = NULL;
+    size_t function_count = 0;
+    if (!x86_find_functions(&image, 1, &functions, &function_count)) {
+        printf("error: out of memory\n");
+        x86_image_free(&image);
+        return 1;
+    }
+    for (size_t f = 0; f < fixture->function_count; f++) {
+        size_t i = 0;
+        while (i < function_count && functions[i].start != fixture->functions[f].start) {
+            i++;
+        }
+        FIXTURE_EXPECT(i < function_count && functions[i].end == fixture->functions[f].end,
+            "x86_find_functions lost 0x%llx-0x%llx", (unsigned long long)fixture->functions[f].start,
+            (unsigned long long)fixture->functions[f].end);
+    }
+    FIXTURE_EXPECT(function_count && functions[0].start == fixture->entry, "x86_find_functions misses the entry");
+
+#undef FIXTURE_EXPECT
+
+    printf("  %-20s %zu regions, %zu functions from metadata, %zu found%s\n", fixture->file, image.region_count,
+        image.function_count, function_count, failures ? ", MISMATCH" : "");
+    x86_functions_free(functions);
+    x86_image_free(&image);
+    return failures ? 1 : 0;
+}
+
+static int command_check_pe(const char* directory) {
+    int failures = 0;
+
+    printf("PE fixtures in %s\n", directory);
+    for (size_t i = 0; i < sizeof(g_pe_fixtures) / sizeof(g_pe_fixtures[0]); i++) {
+        failures += check_pe_fixture(directory, &g_pe_fixtures[i]);
+    }
+    return failures ? 1 : 0;
+}
+
+/*
+ * Self-check: x86_sweep_parallel against the serial batch decoder
+ *
+ * Each buffer is swept serially once, then in parallel on several thread
+ * counts; with the buffer length these set the chunk size. Record limits
+ * stop the sweep inside a chunk and cut lengths end it inside an
+ * instruction. Records and results must be identical every time.
+ */
+static std::vector<uint8_t> random_bytes(size_t size, uint32_t seed) {
+    std::vector<uint8_t> bytes(size);
+
+    for (size_t i = 0; i < size; i++) {
+        seed = seed * 1103515245 + 12345;
+        bytes[i] = (uint8_t)(seed >> 16);
+    }
+    return bytes;
+}
+
+// Chunk seams as x86_sweep_parallel places them (SWEEP_MIN_CHUNK and
+// SWEEP_CHUNKS_PER_THREAD in disassm_sweep.cpp), counted when they do not
+// fall on an instruction start
+static size_t seams_inside_instructions(const std::vector<bool>& starts, size_t length, unsigned int threads) {
+    size_t chunk_count = (size_t)threads * 8;
+    size_t inside = 0;
+
+    if (chunk_count > length / (64 * 1024)) {
+        chunk_count = length / (64 * 1024);
+    }
+    for (size_t c = 1; c < chunk_count; c++) {
+        size_t seam = (length / chunk_count * c) & ~(size_t)63;
+        inside += !starts[seam];
+    }
+    return inside;
+}
+
+static int command_check_sweep(const char* path) {
+    struct Buffer {
+        const char* name;
+        DisasmMode mode;
+        std::vector<uint8_t> code;
+    };
+    std::vector<Buffer> buffers;
+    static const unsigned int thread_counts[] = { 2, 3, 4, 7, 16 };
+    size_t seams_inside = 0;
+    int mismatches = 0;
+
+    buffers.push_back({ "common encodings", DISASM_MODE_64, build_corpus((1 << 20) + 7, g_corpus_mix) });
+    buffers.push_back({ "AVX-512 loop", DISASM_MODE_64, build_corpus(600 * 1024 + 3, g_corpus_avx512) });
+    buffers.push_back({ "random bytes", DISASM_MODE_64, random_bytes(1536 * 1024 + 5, 7) });
+    buffers.push_back({ "random bytes, 32-bit", DISASM_MODE_32, random_bytes(384 * 1024 + 1, 11) });
+
+    // mov rax, imm64 whose immediate is more of the same: a chunk decoded
+    // from a seam inside an instruction never meets the true stream
+    Buffer run = { "mov imm64 run", DISASM_MODE_64, std::vector<uint8_t>() };
+    while (run.code.size() < 512 * 1024) {
+        static const uint8_t mov[10] = { 0x48, 0xB8, 0x48, 0xB8, 0x48, 0xB8, 0x48, 0xB8, 0x48, 0xB8 };
+        run.code.insert(run.code.end(), mov, mov + sizeof(mov));
+    }
+    buffers.push_back(run);
+
+    if (path) {
+        std::vector<uint8_t> code = read_code(path);
+        if (code.empty()) {
+            printf("error: cannot read %s\n", path);
+            return 1;
+        }
+        buffers.push_back({ path, DISASM_MODE_64, code });
+    }
+
+    printf("parallel sweep against the serial sweep\n");
+    for (size_t b = 0; b < buffers.size(); b++) {
+        const Buffer* buffer = &buffers[b];
+        std::vector<DecodedInstruction> serial(buffer->code.size() + 1);
+        std::vector<DecodedInstruction> records(buffer->code.size() + 1);
+        DisasmBatchResult expected;
+        size_t sweeps = 0;
+        size_t inside = 0;
+        int failed = 0;
+
+        size_t total = x86_disasm_batch_mode(buffer->mode, buffer->code.data(), buffer->code.size(), 0x1000,
+            serial.data(), serial.size(), &expected);
+        std::vector<bool> starts(buffer->code.size() + 1);
+        for (size_t i = 0; i < total; i++) {
+            starts[(size_t)(serial[i].address - 0x1000)] = true;
+        }
+
+        // Whole buffer, cut one byte into its last instruction, and record
+        // limits that stop early
+        size_t lengths[2] = { buffer->code.size(), (size_t)(serial[total - 1].address - 0x1000) + 1 };
+        size_t limits[3] = { serial.size(), total / 2 + 1, total / 5 };
+        for (int l = 0; l < 2; l++) {
+            for (int m = 0; m < 3; m++) {
+                DisasmBatchResult reference;
+                size_t count = x86_disasm_batch_mode(buffer->mode, buffer->code.data(), lengths[l], 0x1000,
+                    serial.data(), limits[m], &reference);
+
+                for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+                    DisasmBatchResult result;
+                    memset(records.data(), 0, records.size() * sizeof(DecodedInstruction));
+                    size_t parallel = x86_sweep_parallel(buffer->mode, buffer->code.data(), lengths[l], 0x1000,
+                        records.data(), limits[m], thread_counts[t], &result);
+
+                    if (parallel != count || memcmp(&result, &reference, sizeof(result)) != 0 ||
+                        memcmp(records.data(), serial.data(), count * sizeof(DecodedInstruction)) != 0) {
+                        printf("  %s: %zu bytes, limit %zu, %u threads: %zu records (serial %zu), MISMATCH\n",
+                            buffer->name, lengths[l], limits[m], thread_counts[t], parallel, count);
+                        failed = 1;
+                    }
+                    inside += seams_inside_instructions(starts, lengths[l], thread_counts[t]);
+                    sweeps++;
+                }
+            }
+        }
+
+        printf("  %-24s %9zu bytes %9zu insns %3zu sweeps, %4zu seams inside an instruction%s\n", buffer->name,
+            buffer->code.size(), total, sweeps, inside, failed ? ", MISMATCH" : "");
+        seams_inside += inside;
+        mismatches += failed;
+    }
+
+    if (seams_inside == 0) {
+        printf("  no chunk seam fell inside an instruction, MISMATCH\n");
+        return 1;
+    }
+    return mismatches ? 1 : 0;
+}
+
+/*
+ * Self-check: the cross-reference index against a brute-force scan
+ *
+ * The references of every decoded record are listed in source order; each
+ * lookup is answered by scanning that list and must return the same
+ * references, in target then source order, from the index built section
+ * by section and from the same index saved and mapped back.
+ */
+struct Reference {
+    uint64_t target;
+    uint64_t source;
+    uint8_t type;
+};
+
+// Appends the references of a code buffer in source order, and adds the
+// decoded records to index if not NULL
+static int collect_references(const uint8_t* code, size_t size, uint64_t address, XrefIndex* index,
+    std::vector<Reference>* references) {
+    std::vector<DecodedInstruction> records(4096);
+    size_t offset = 0;
+
+    while (offset < size) {
+        DisasmBatchResult result;
+        size_t count = x86_disasm_batch_mode(DISASM_MODE_64, code + offset, size - offset, address + offset,
+            records.data(), records.size(), &result);
+
+        for (size_t i = 0; i < count; i++) {
+            const DecodedInstruction* insn = &records[i];
+            DisasmFlow flow = x86_control_flow(&insn->info);
+
+            if (insn->info.flags & FLAG_RIP_RELATIVE) {
+                references->push_back({ insn->target, insn->address, (uint8_t)DISASM_XREF_DATA });
+            }
+            else if (insn->info.flags & FLAG_RELATIVE) {
+                references->push_back({ insn->target, insn->address, (uint8_t)(flow == DISASM_FLOW_CALL ?
+                    DISASM_XREF_CALL : flow == DISASM_FLOW_JUMP ? DISASM_XREF_JUMP : DISASM_XREF_BRANCH) });
+            }
+        }
+        if (index && !x86_xref_add(index, records.data(), count)) {
+            return 0;
+        }
+        offset += result.offset;
+        if (result.reason != DISASM_STOP_FULL) {
+            break;
+        }
+    }
+    return 1;
+}
+
+static size_t check_xref_queries(const XrefIndex* index, const std::vector<Reference>& references,
+    const std::vector<std::pair<uint64_t, uint64_t>>& queries) {
+    size_t mismatches = 0;
+
+    for (size_t q = 0; q < queries.size(); q++) {
+        uint64_t start = queries[q].first;
+        uint64_t end = queries[q].second;
+        std::vector<Reference> expected;
+        size_t first = 0;
+        size_t count;
+
+        for (size_t i = 0; i < references.size(); i++) {
+            if (references[i].target >= start && references[i].target < end) {
+                expected.push_back(references[i]);
+            }
+        }
+        std::stable_sort(expected.begin(), expected.end(),
+            [](const Reference& a, const Reference& b) { return a.target < b.target; });
+
+        // A one-address range is also asked as a single target
+        count = end - start == 1 ? x86_xref_find(index, start, &first) : x86_xref_range(index, start, end, &first);
+        bool same = count == expected.size() && (count == 0 || first + count <= index->count);
+        for (size_t i = 0; same && i < count; i++) {
+            same = index->targets[first + i] == expected[i].target && index->sources[first + i] == expected[i].source &&
+                index->types[first + i] == expected[i].type;
+        }
+        if (!same) {
+            if (mismatches++ < 4) {
+                printf("    references to [0x%llx, 0x%llx): %zu, expected %zu, MISMATCH\n", (unsigned long long)start,
+                    (unsigned long long)end, count, expected.size());
+            }
+        }
+    }
+    return mismatches;
+}
+
+static int command_check_xrefs(const char* path, const char* index_path) {
+    std::vector<uint8_t> code = path ? read_code(path) : build_corpus(1 << 20, g_corpus_mix);
+    std::vector<uint8_t> noise = random_bytes(256 * 1024, 3);
+    std::vector<Reference> references;
+    XrefIndex index;
+    size_t mismatches = 0;
+
+    if (code.empty()) {
+        printf("error: cannot read %s\n", path);
+        return 1;
+    }
+
+    // Four sections, each committed before the next: code and random bytes,
+    // added from records and straight from the code in turn
+    struct {
+        const uint8_t* code;
+        size_t size;
+        uint64_t address;
+    } sections[4] = {
+        { code.data(), code.size() / 2, 0 },
+        { noise.data(), noise.size() / 2, 0 },
+        { code.data() + code.size() / 2, code.size() - code.size() / 2, 0 },
+        { noise.data() + noise.size() / 2, noise.size() - noise.size() / 2, 0 },
+    };
+    uint64_t address = 0x10000;
+
+    x86_xref_init(&index);
+    for (int s = 0; s < 4; s++) {
+        sections[s].address = address;
+        address += sections[s].size + 0x1000;
+
+        int ok = collect_references(sections[s].code, sections[s].size, sections[s].address, s % 2 ? &index : NULL,
+            &references);
+        if (s % 2 == 0) {
+            ok = ok && x86_xref_add_code(&index, DISASM_MODE_64, sections[s].code, sections[s].size,
+                sections[s].address);
+        }
+        if (!ok || !x86_xref_commit(&index)) {
+            printf("error: out of memory\n");
+            x86_xref_free(&index);
+            return 1;
+        }
+    }
+
+    // Every 97th referenced address, its neighbours and ranges around it,
+    // plus addresses and ranges at the ends of the address space
+    std::vector<std::pair<uint64_t, uint64_t>> queries;
+    for (size_t i = 0; i < references.size(); i += 97) {
+        uint64_t target = references[i].target;
+        queries.push_back(std::make_pair(target, target + 1));
+        queries.push_back(std::make_pair(target - 1, target));
+        queries.push_back(std::make_pair(target + 1, target + 2));
+        queries.push_back(std::make_pair(target, target + 64));
+        queries.push_back(std::make_pair(target - 4096, target + 4096));
+        queries.push_back(std::make_pair(target, target));
+    }
+    queries.push_back(std::make_pair((uint64_t)0, (uint64_t)1));
+    queries.push_back(std::make_pair((uint64_t)0, UINT64_MAX));
+    queries.push_back(std::make_pair(UINT64_MAX - 1, UINT64_MAX));
+
+    printf("xref index against a brute-force scan: %zu references, %zu in the index, %zu queries\n",
+        references.size(), index.count, queries.size());
+    if (index.count != references.size()) {
+        printf("  reference count MISMATCH\n");
+        mismatches++;
+    }
+    size_t built = check_xref_queries(&index, references, queries);
+    printf("  %-24s %zu mismatches\n", "built", built);
+    mismatches += built;
+
+    // Saved and mapped back: the same answers, also after committing more
+    const char* file = index_path ? index_path : "check_xrefs.idx";
+    XrefIndex loaded;
+    if (!x86_xref_save(&index, file) || !x86_xref_load(file, DISASM_MAP_DEFAULT, &loaded)) {
+        printf("error: cannot save and load %s\n", file);
+        x86_xref_free(&index);
+        return 1;
+    }
+    // Used in place: nothing is copied until the next commit
+    size_t mapped = (loaded.capacity != 0) + check_xref_queries(&loaded, references, queries);
+    printf("  %-24s %zu mismatches\n", "saved and mapped", mapped);
+    mismatches += mapped;
+
+    int ok = collect_references(code.data(), code.size() / 4, address, NULL, &references) &&
+        x86_xref_add_code(&loaded, DISASM_MODE_64, code.data(), code.size() / 4, address) &&
+        x86_xref_commit(&loaded) && x86_xref_add_code(&index, DISASM_MODE_64, code.data(), code.size() / 4, address) &&
+        x86_xref_commit(&index);
+    if (!ok) {
+        printf("error: out of memory\n");
+        x86_xref_free(&loaded);
+        x86_xref_free(&index);
+        return 1;
+    }
+    size_t extended = check_xref_queries(&loaded, references, queries) +
+        check_xref_queries(&index, references, queries);
+    extended += loaded.count != index.count || loaded.count != references.size() ||
+        memcmp(loaded.targets, index.targets, index.count * sizeof(uint64_t)) != 0 ||
+        memcmp(loaded.sources, index.sources, index.count * sizeof(uint64_t)) != 0 ||
+        memcmp(loaded.types, index.types, index.count) != 0;
+    printf("  %-24s %zu mismatches\n", "mapped, then committed", extended);
+    mismatches += extended;
+
+    x86_xref_free(&loaded);
+    x86_xref_free(&index);
+    if (!index_path) {
+        remove(file);
+    }
+    return mismatches ? 1 : 0;
+}
+
+/*
+ * Self-check: the decoded instruction cache under concurrent use
+ *
+ * Threads decode every instruction of a buffer through one cache, each in
+ * its own order, and every record must equal x86_disasm_batch_mode's.
+ * Then the bytes are patched (the stale path), and the cache is cleared
+ * while other threads decode. The counters are checked after each phase.
+ */
+struct CacheCheck {
+    DecodeCache cache;
+    const uint8_t* code;
+    size_t size;
+    std::vector<size_t> starts;
+    std::vector<DecodedInstruction> expected;
+    std::atomic<size_t> mismatches;
+};
+
+static const uint64_t g_cache_check_address = 0x400000;
+
+// Every instruction once, starting at 'first' and stepping by 'stride'
+// (coprime with the count) so each thread visits them in its own order
+static void cache_check_pass(CacheCheck* check, size_t first, size_t stride) {
+    size_t count = check->starts.size();
+
+    for (size_t n = 0, i = first % count; n < count; n++, i = (i + stride) % count) {
+        size_t offset = check->starts[i];
+        DecodedInstruction record;
+
+        memset(&record, 0, sizeof(record));
+        unsigned int length = x86_cache_decode(&check->cache, check->code + offset, check->size - offset,
+            g_cache_check_address + offset, &record);
+        if (length != check->expected[i].info.length ||
+            memcmp(&record, &check->expected[i], sizeof(record)) != 0) {
+            check->mismatches++;
+        }
+    }
+}
+
+static void cache_check_threads(CacheCheck* check, unsigned int threads) {
+    std::vector<std::thread> workers;
+
+    for (unsigned int t = 0; t < threads; t++) {
+        workers.push_back(std::thread(cache_check_pass, check, (size_t)t * 7919, (size_t)(2 * t + 1)));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+static void cache_check_expect(CacheCheck* check, const std::vector<uint8_t>& code) {
+    check->code = code.data();
+    check->size = code.size();
+    check->expected.resize(check->starts.size());
+    for (size_t i = 0; i < check->starts.size(); i++) {
+        size_t offset = check->starts[i];
+        x86_disasm_batch_mode(DISASM_MODE_64, check->code + offset, check->size - offset,
+            g_cache_check_address + offset, &check->expected[i], 1, NULL);
+    }
+}
+
+static int command_check_cache(const char* path) {
+    std::vector<uint8_t> code = path ? read_code(path) : build_corpus(64 * 1024, g_corpus_mix);
+    std::vector<uint8_t> noise = random_bytes(16 * 1024, 5);
+    const unsigned int threads = 8;
+    CacheCheck check;
+    DecodeCacheStats before, stats;
+    int failures = 0;
+
+    if (code.empty()) {
+        printf("error: cannot read %s\n", path);
+        return 1;
+    }
+    if (code.size() > 256 * 1024) {
+        code.resize(256 * 1024);
+    }
+    code.insert(code.end(), noise.begin(), noise.end());
+
+    // Instruction starts of the original bytes, ending with one cut short
+    std::vector<DecodedInstruction> records(code.size());
+    size_t count = x86_disasm_batch_mode(DISASM_MODE_64, code.data(), code.size() - 3, g_cache_check_address,
+        records.data(), records.size(), NULL);
+    for (size_t i = 0; i < count; i++) {
+        check.starts.push_back((size_t)(records[i].address - g_cache_check_address));
+    }
+    size_t n = check.starts.size();
+
+    // Sized well past the instruction count, so no set overflows
+    if (!x86_cache_init(&check.cache, DISASM_MODE_64, n * 16)) {
+        printf("error: out of memory\n");
+        return 1;
+    }
+    check.mismatches = 0;
+    printf("decode cache against x86_disasm_batch_mode: %zu instructions, %u threads\n", n, threads);
+
+#define CACHE_EXPECT(phase, condition) do { \
+        if (!(condition)) { \
+            printf("  %s: %s, MISMATCH\n", phase, #condition); \
+            failures++; \
+        } \
+    } while (0)
+
+    // Concurrent inserts: every address misses at least once, then a
+    // serial pass hits everything
+    cache_check_expect(&check, code);
+    cache_check_threads(&check, threads);
+    x86_cache_stats(&check.cache, &stats);
+    CACHE_EXPECT("inserts", stats.hits + stats.misses == (uint64_t)n * threads);
+    CACHE_EXPECT("inserts", stats.misses >= n && stats.stale == 0 && stats.entries == n);
+    before = stats;
+    cache_check_pass(&check, 0, 1);
+    x86_cache_stats(&check.cache, &stats);
+    CACHE_EXPECT("inserts", stats.hits - before.hits == n && stats.misses == before.misses);
+    printf("  %-28s %9llu hits %9llu misses %6llu stale %9zu entries\n", "concurrent inserts",
+        (unsigned long long)stats.hits, (unsigned long long)stats.misses, (unsigned long long)stats.stale,
+        stats.entries);
+
+    // Patched bytes: one byte in every 5th instruction. The records whose
+    // checked bytes changed are stale at least once and at most once per
+    // thread; the rest still hit
+    std::vector<uint8_t> patched(code);
+    size_t changed = 0;
+    uint32_t seed = 9;
+    for (size_t i = 0; i < n; i += 5) {
+        seed = seed * 1103515245 + 12345;
+        patched[check.starts[i] + (seed >> 16) % check.expected[i].info.length] ^= (uint8_t)(1 + (seed >> 24) % 255);
+    }
+    for (size_t i = 0; i < n; i++) {
+        size_t offset = check.starts[i];
+        size_t checked = check.expected[i].info.length;
+        if (check.expected[i].info.flags & FLAG_MASK_ANY_ERROR) {
+            checked = code.size() - offset < X86_MAX_INSTRUCTION_LENGTH ? code.size() - offset :
+                X86_MAX_INSTRUCTION_LENGTH;
+        }
+        changed += memcmp(&code[offset], &patched[offset], checked) != 0;
+    }
+    before = stats;
+    cache_check_expect(&check, patched);
+    cache_check_threads(&check, threads);
+    x86_cache_stats(&check.cache, &stats);
+    CACHE_EXPECT("patched", stats.stale - before.stale >= changed && stats.stale - before.stale <= changed * threads);
+    CACHE_EXPECT("patched", stats.misses - before.misses >= changed &&
+        stats.misses - before.misses <= changed * threads);
+    CACHE_EXPECT("patched", stats.hits + stats.misses - before.hits - before.misses == (uint64_t)n * threads);
+    CACHE_EXPECT("patched", stats.entries == n);
+    printf("  %-28s %9llu hits %9llu misses %6llu stale %9zu entries (%zu changed)\n", "patched bytes",
+        (unsigned long long)(stats.hits - before.hits), (unsigned long long)(stats.misses - before.misses),
+        (unsigned long long)(stats.stale - before.stale), stats.entries, changed);
+
+    // Cleared while other threads decode: the records stay right; once
+    // quiet, the cache is empty and every lookup misses
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads - 1; t++) {
+        workers.push_back(std::thread(cache_check_pass, &check, (size_t)t * 104729, (size_t)(2 * t + 3)));
+    }
+    for (int c = 0; c < 8; c++) {
+        x86_cache_clear(&check.cache);
+        std::this_thread::yield();
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    x86_cache_clear(&check.cache);
+    x86_cache_stats(&check.cache, &before);
+    CACHE_EXPECT("clear", before.entries == 0);
+    cache_check_pass(&check, 0, 1);
+    x86_cache_stats(&check.cache, &stats);
+    CACHE_EXPECT("clear", stats.misses - before.misses == n && stats.hits == before.hits &&
+        stats.stale == before.stale && stats.entries == n);
+    printf("  %-28s %9llu hits %9llu misses %6llu stale %9zu entries\n", "cleared while decoding",
+        (unsigned long long)(stats.hits - before.hits), (unsigned long long)(stats.misses - before.misses),
+        (unsigned long long)(stats.stale - before.stale), stats.entries);
+
+    // An instruction cut short by 'available' is not decoded
+    DecodedInstruction record;
+    size_t last = check.starts[n - 1];
+    CACHE_EXPECT("truncated", x86_cache_decode(&check.cache, &patched[last], check.expected[n - 1].info.length - 1,
+        g_cache_check_address + last, &record) == 0 || check.expected[n - 1].info.length == 1);
+
+#undef CACHE_EXPECT
+
+    if (check.mismatches) {
+        printf("  %zu records differ from x86_disasm_batch_mode, MISMATCH\n", check.mismatches.load());
+    }
+    x86_cache_free(&check.cache);
+    return failures || check.mismatches ? 1 : 0;
+}
+
+/*
+ * Self-check: an incrementally patched listing against a full rebuild
+ *
+ * Rounds of random patches, many of them across the 4 KB chunk edges of
+ * the listing, with bytes that make instructions longer or shorter. After
+ * every round the records, the chunk each one sits in and the xref index
+ * must be the ones a fresh build of the patched bytes gives.
+ */
+static int compare_listing(const DecodedListing* listing, const XrefIndex* xrefs, DisasmMode mode,
+    const std::vector<uint8_t>& code, uint64_t address, std::vector<DecodedInstruction>& expected,
+    std::vector<DecodedInstruction>& records) {
+    DecodedListing fresh;
+    XrefIndex fresh_xrefs;
+    int same;
+
+    x86_xref_init(&fresh_xrefs);
+    if (!x86_listing_build(&fresh, mode, code.data(), code.size(), address, 1) ||
+        !x86_xref_add_code(&fresh_xrefs, mode, code.data(), code.size(), address) || !x86_xref_commit(&fresh_xrefs)) {
+        x86_listing_free(&fresh);
+        x86_xref_free(&fresh_xrefs);
+        return -1;
+    }
+
+    size_t count = x86_listing_copy(&fresh, address, address + code.size(), expected.data(), expected.size());
+    size_t copied = x86_listing_copy(listing, address, address + code.size(), records.data(), records.size());
+    same = count == copied && count == listing->instruction_count && count == fresh.instruction_count &&
+        memcmp(records.data(), expected.data(), count * sizeof(DecodedInstruction)) == 0;
+    for (size_t c = 0; same && c < listing->chunk_count; c++) {
+        same = listing->chunks[c].count == fresh.chunks[c].count;
+    }
+    same = same && xrefs->count == fresh_xrefs.count &&
+        memcmp(xrefs->targets, fresh_xrefs.targets, xrefs->count * sizeof(uint64_t)) == 0 &&
+        memcmp(xrefs->sources, fresh_xrefs.sources, xrefs->count * sizeof(uint64_t)) == 0 &&
+        memcmp(xrefs->types, fresh_xrefs.types, xrefs->count) == 0;
+
+    x86_listing_free(&fresh);
+    x86_xref_free(&fresh_xrefs);
+    return same;
+}
+
+static int command_check_listing(const char* path) {
+    std::vector<uint8_t> code = path ? read_code(path) : build_corpus(192 * 1024, g_corpus_mix);
+    std::vector<uint8_t> noise = random_bytes(64 * 1024, 13);
+    const uint64_t address = 0x7000;
+    const size_t chunk = 4096;          // LISTING_CHUNK
+    const int rounds = 400;
+    DecodedListing listing;
+    XrefIndex xrefs;
+    size_t patch_total = 0;
+    size_t edges_moved = 0;
+    size_t uncovered = 0;
+    int mismatches = 0;
+
+    if (code.empty()) {
+        printf("error: cannot read %s\n", path);
+        return 1;
+    }
+    if (code.size() > 1024 * 1024) {
+        code.resize(1024 * 1024);
+    }
+    code.insert(code.end(), noise.begin(), noise.end());
+
+    x86_xref_init(&xrefs);
+    if (!x86_listing_build(&listing, DISASM_MODE_64, code.data(), code.size(), address, 0) ||
+        !x86_xref_add_code(&xrefs, DISASM_MODE_64, code.data(), code.size(), address) || !x86_xref_commit(&xrefs)) {
+        printf("error: out of memory\n");
+        x86_listing_free(&listing);
+        x86_xref_free(&xrefs);
+        return 1;
+    }
+    printf("patched listing against a full rebuild: %zu bytes, %zu chunks, %d rounds\n", code.size(),
+        listing.chunk_count, rounds);
+
+    std::vector<DecodedInstruction> expected(code.size() + 1);
+    std::vector<DecodedInstruction> records(code.size() + 1);
+    uint32_t seed = 21;
+    for (int round = 0; round < rounds; round++) {
+        AddressRange patches[4];
+        AddressRange spans[4];
+        size_t span_count = 0;
+        std::vector<uint64_t> first_starts(listing.chunk_count);
+
+        // Where each chunk's first instruction starts before the patches
+        for (size_t c = 0; c < listing.chunk_count; c++) {
+            first_starts[c] = listing.chunks[c].count ? listing.chunks[c].insns[0].address : 0;
+        }
+
+        seed = seed * 1103515245 + 12345;
+        size_t patch_count = 1 + (seed >> 16) % 4;
+        for (size_t p = 0; p < patch_count; p++) {
+            size_t offset, length;
+
+            // Half of the patches straddle or end near a chunk edge, some
+            // at the very end of the code
+            seed = seed * 1103515245 + 12345;
+            if ((seed >> 16) % 2) {
+                size_t edge = ((seed >> 8) % (code.size() / chunk) + 1) * chunk;
+                offset = edge - 1 - (seed >> 20) % 16;
+            }
+            else {
+                offset = (size_t)(((uint64_t)seed << 16 | seed >> 16) % code.size());
+            }
+            seed = seed * 1103515245 + 12345;
+            length = 1 + (seed >> 16) % 20;
+            if (length > code.size() - offset) {
+                length = code.size() - offset;
+            }
+
+            // Random bytes, a nop slide (shorter), mov r64, imm64 (longer)
+            // or a run of prefixes and escapes
+            unsigned int kind = (seed >> 24) % 4;
+            for (size_t b = 0; b < length; b++) {
+                seed = seed * 1103515245 + 12345;
+                uint8_t byte = (uint8_t)(seed >> 16);
+                code[offset + b] = kind == 0 ? byte : kind == 1 ? 0x90 : kind == 2 ? (b == 0 ? 0x48 : b == 1 ? 0xB8 : byte) :
+                    (b % 3 == 0 ? 0x66 : b % 3 == 1 ? 0x0F : byte);
+            }
+            patches[p].start = address + offset;
+            patches[p].end = patches[p].start + length;
+        }
+        patch_total += patch_count;
+
+        if (!x86_listing_patch(&listing, patches, patch_count, &xrefs, spans, &span_count)) {
+            printf("error: out of memory\n");
+            mismatches++;
+            break;
+        }
+
+        // Every patched byte up to the end of the sweep is in a span; bytes
+        // of a truncated last instruction are not decoded
+        uint64_t sweep_end = address;
+        for (size_t c = listing.chunk_count; c-- > 0; ) {
+            if (listing.chunks[c].count) {
+                const DecodedInstruction* last = &listing.chunks[c].insns[listing.chunks[c].count - 1];
+                sweep_end = last->address + last->info.length;
+                break;
+            }
+        }
+        for (size_t p = 0; p < patch_count; p++) {
+            uint64_t end = patches[p].end < sweep_end ? patches[p].end : sweep_end;
+            size_t s = 0;
+            while (patches[p].start < end && s < span_count &&
+                !(spans[s].start <= patches[p].start && end <= spans[s].end)) {
+                s++;
+            }
+            uncovered += patches[p].start < end && s == span_count;
+        }
+        for (size_t c = 1; c < listing.chunk_count; c++) {
+            uint64_t first = listing.chunks[c].count ? listing.chunks[c].insns[0].address : 0;
+            edges_moved += first != first_starts[c];
+        }
+
+        int same = compare_listing(&listing, &xrefs, DISASM_MODE_64, code, address, expected, records);
+        if (same < 0) {
+            printf("error: out of memory\n");
+            mismatches++;
+            break;
+        }
+        if (!same) {
+            if (mismatches++ < 4) {
+                printf("  round %d: %zu patches, MISMATCH with a full rebuild\n", round, patch_count);
+            }
+        }
+    }
+
+    // Empty and out of range copies
+    DecodedInstruction record;
+    if (x86_listing_copy(&listing, address + 100, address + 100, &record, 1) != 0 ||
+        x86_listing_copy(&listing, address + code.size(), address + code.size() + 100, &record, 1) != 0 ||
+        x86_listing_copy(&listing, address, address + code.size(), &record, 0) != 0) {
+        printf("  empty copies return records, MISMATCH\n");
+        mismatches++;
+    }
+
+    printf("  %zu patches, %zu moved the first instruction of a chunk, %zu not covered by a span, %d mismatches\n",
+        patch_total, edges_moved, uncovered, mismatches);
+    if (edges_moved == 0 || uncovered) {
+        printf("  MISMATCH\n");
+        mismatches++;
+    }
+
+    x86_listing_free(&listing);
+    x86_xref_free(&xrefs);
+    return mismatches ? 1 : 0;
+}
+
+/*
+ * Self-check: the streaming decoder against one batch decode
+ *
+ * The input is pushed in pieces of many sizes: one byte at a time, every
+ * size up to a window (so the carried bytes are completed at each split
+ * point), runs of small pushes behind large ones, random sizes with empty
+ * pushes, and random records per decode call. The records, the carried
+ * bytes and the next address must equal x86_disasm_batch_mode over the
+ * whole input.
+ */
+static int check_stream_split(DisasmMode mode, const std::vector<uint8_t>& code, int scheme, uint32_t seed) {
+    std::vector<DecodedInstruction> expected(code.size() + 1);
+    std::vector<DecodedInstruction> records;
+    DecodedInstruction out[37];
+    DisasmBatchResult result;
+    DisasmStream stream;
+    size_t offset = 0;
+    size_t pushes = 0;
+
+    size_t total = x86_disasm_batch_mode(mode, code.data(), code.size(), 0x1000, expected.data(), expected.size(),
+        &result);
+    seed = seed * 1103515245 + 12345;
+    size_t max_count = 1 + (seed >> 16) % 37;
+
+    x86_stream_init(&stream, mode, 0x1000);
+    while (offset < code.size()) {
+        size_t length;
+
+        seed = seed * 1103515245 + 12345;
+        switch (scheme) {
+        case 0:     // One byte at a time
+            length = 1;
+            break;
+        case 1:     // 1, 2, ... 15 bytes, over and over
+            length = 1 + pushes % X86_MAX_INSTRUCTION_LENGTH;
+            break;
+        case 2:     // A large push, then a run of pushes inside the carry
+            length = pushes % 8 == 0 ? 4096 + (seed >> 16) % 64 : 1 + (seed >> 16) % (X86_MAX_INSTRUCTION_LENGTH - 1);
+            break;
+        case 3:     // Random sizes, empty pushes included
+            length = (seed >> 16) % 40;
+            break;
+        default:    // Random large sizes
+            length = (seed >> 12) % 100000;
+            break;
+        }
+        if (length > code.size() - offset) {
+            length = code.size() - offset;
+        }
+
+        // An empty push is a NULL pointer, as a reader at end of file passes
+        x86_stream_feed(&stream, length ? code.data() + offset : NULL, length);
+        offset += length;
+        pushes++;
+        if (offset == code.size() && scheme % 2) {
+            x86_stream_finish(&stream);
+        }
+
+        size_t n;
+        while ((n = x86_stream_decode(&stream, out, max_count)) != 0) {
+            records.insert(records.end(), out, out + n);
+        }
+    }
+
+    // The other schemes finish with an empty last chunk
+    if (scheme % 2 == 0 || code.empty()) {
+        size_t n;
+
+        x86_stream_feed(&stream, NULL, 0);
+        x86_stream_finish(&stream);
+        while ((n = x86_stream_decode(&stream, out, max_count)) != 0) {
+            records.insert(records.end(), out, out + n);
+        }
+    }
+
+    return records.size() == total &&
+        (total == 0 || memcmp(records.data(), expected.data(), total * sizeof(DecodedInstruction)) == 0) &&
+        stream.carry_length == code.size() - result.offset && stream.address == result.address;
+}
+
+static int command_check_stream(const char* path) {
+    static const char* const scheme_names[] = { "1-byte", "1..15", "large + carry", "random small", "random large" };
+    struct Input {
+        const char* name;
+        DisasmMode mode;
+        std::vector<uint8_t> code;
+    };
+    std::vector<Input> inputs;
+    int mismatches = 0;
+
+    inputs.push_back({ "common encodings", DISASM_MODE_64, build_corpus(128 * 1024, g_corpus_mix) });
+    inputs.push_back({ "random bytes", DISASM_MODE_64, random_bytes(64 * 1024, 17) });
+    inputs.push_back({ "random bytes, 32-bit", DISASM_MODE_32, random_bytes(32 * 1024, 19) });
+    inputs.push_back({ "random bytes, 16-bit", DISASM_MODE_16, random_bytes(32 * 1024, 23) });
+    inputs.push_back({ "empty", DISASM_MODE_64, std::vector<uint8_t>() });
+
+    // Ends inside mov rax, imm64: the last bytes stay carried
+    Input cut = { "truncated end", DISASM_MODE_64, build_corpus(16 * 1024, g_corpus_mix) };
+    static const uint8_t mov[6] = { 0x48, 0xB8, 1, 2, 3, 4 };
+    cut.code.insert(cut.code.end(), mov, mov + sizeof(mov));
+    inputs.push_back(cut);
+
+    if (path) {
+        std::vector<uint8_t> code = read_code(path);
+        if (code.empty()) {
+            printf("error: cannot read %s\n", path);
+            return 1;
+        }
+        if (code.size() > 1024 * 1024) {
+            code.resize(1024 * 1024);
+        }
+        inputs.push_back({ path, DISASM_MODE_64, code });
+    }
+
+    printf("streaming decoder against one batch decode\n");
+    for (size_t i = 0; i < inputs.size(); i++) {
+        printf("  %-24s %8zu bytes", inputs[i].name, inputs[i].code.size());
+        for (int scheme = 0; scheme < 5; scheme++) {
+            // Several seeds for the random push and record counts
+            int same = 1;
+            for (uint32_t seed = 1; seed <= 4 && same; seed++) {
+                same = check_stream_split(inputs[i].mode, inputs[i].code, scheme, seed * 977 + (uint32_t)i);
+            }
+            printf(", %s %s", scheme_names[scheme], same ? "ok" : "MISMATCH");
+            mismatches += !same;
+        }
+        printf("\n");
+    }
+    return mismatches ? 1 : 0;
+}
+
+/*
+ * Self-check: the signature scanner against a naive masked compare
+ *
+ * Patterns are cut from the buffer at instruction starts, 1 to 256 bytes
+ * with wildcard bytes and nibbles, so most of them hit. Others are the
+ * first and last bytes of the buffer, and the last bytes with one more
+ * byte, which must never match there. The buffer is also cut at the end
+ * of long patterns. Every scan level, alignment and output limit must give
+ * the matches of the naive compare, few patterns (a bucket each) and many.
+ */
+static std::vector<uint64_t> sweep_starts(DisasmMode mode, const uint8_t* code, size_t size) {
+    std::vector<uint8_t> lengths(4096);
+    std::vector<uint64_t> starts((size + 63) / 64 + 1);
+    size_t offset = 0;
+
+    while (offset < size) {
+        DisasmBatchResult result;
+        size_t count = x86_insn_length_batch_mode(mode, code + offset, size - offset, lengths.data(), lengths.size(),
+            &result);
+
+        for (size_t i = 0; i < count; i++) {
+            starts[offset / 64] |= (uint64_t)1 << (offset % 64);
+            offset += lengths[i];
+        }
+        if (result.reason != DISASM_STOP_FULL) {
+            break;
+        }
+    }
+    return starts;
+}
+
+static std::string signature_text(const uint8_t* bytes, size_t length, uint32_t* seed) {
+    std::string text;
+    bool fixed = false;
+
+    for (size_t i = 0; i < length; i++) {
+        char byte[4];
+
+        *seed = *seed * 1103515245 + 12345;
+        switch ((*seed >> 16) % 8) {
+        case 0:
+        case 1:
+            snprintf(byte, sizeof(byte), "??");
+            break;
+        case 2:
+            snprintf(byte, sizeof(byte), "?%X", bytes[i] & 15);
+            fixed = true;
+            break;
+        case 3:
+            snprintf(byte, sizeof(byte), "%X?", bytes[i] >> 4);
+            fixed = true;
+            break;
+        default:
+            snprintf(byte, sizeof(byte), "%02X", bytes[i]);
+            fixed = true;
+            break;
+        }
+        // At least one fixed nibble
+        if (i == length - 1 && !fixed) {
+            snprintf(byte, sizeof(byte), "%02X", bytes[i]);
+        }
+        text += i ? " " : "";
+        text += byte;
+    }
+    return text;
+}
+
+static std::vector<SignatureMatch> naive_signature_scan(const std::vector<NaiveSignature>& naive, const uint8_t* code,
+    size_t size, uint64_t address, const uint64_t* starts) {
+    std::vector<SignatureMatch> matches;
+
+    for (size_t offset = 0; offset < size; offset++) {
+        if (starts && !((starts[offset / 64] >> (offset % 64)) & 1)) {
+            continue;
+        }
+        for (size_t p = 0; p < naive.size(); p++) {
+            bool match = offset + naive[p].bytes.size() <= size;
+
+            for (size_t k = 0; match && k < naive[p].bytes.size(); k++) {
+                match = (code[offset + k] & naive[p].masks[k]) == naive[p].bytes[k];
+            }
+            if (match) {
+                matches.push_back({ address + offset, (uint32_t)p });
+            }
+        }
+    }
+    return matches;
+}
+
+// Scans code[0, size) at every alignment and output limit; returns the number of mismatches
+static int check_signature_scan(const SignatureSet* set, const std::vector<NaiveSignature>& naive, DisasmMode mode,
+    const uint8_t* code, size_t size) {
+    const uint64_t address = 0x401000;
+    std::vector<uint64_t> starts = sweep_starts(mode, code, size);
+    std::vector<SignatureMatch> any = naive_signature_scan(naive, code, size, address, NULL);
+    std::vector<SignatureMatch> aligned = naive_signature_scan(naive, code, size, address, starts.data());
+    std::vector<SignatureMatch> out(any.size() + 1);
+    int mismatches = 0;
+
+    for (int align = DISASM_SIGNATURE_SWEEP; align <= DISASM_SIGNATURE_ANY; align++) {
+        const std::vector<SignatureMatch>& expected = align == DISASM_SIGNATURE_ANY ? any : aligned;
+        // All matches, the first half, and counted only, with and without room
+        struct {
+            SignatureMatch* out;
+            size_t max_count;
+        } limits[4] = { { out.data(), out.size() }, { out.data(), expected.size() / 2 }, { NULL, 0 },
+            { NULL, out.size() } };
+
+        for (int l = 0; l < 4; l++) {
+            size_t match_count = 0;
+            int ok = x86_signature_scan(set, mode, code, size, address, (DisasmSignatureAlign)align, starts.data(),
+                limits[l].out, limits[l].max_count, &match_count);
+            bool same = ok && match_count == expected.size();
+
+            for (size_t i = 0; same && limits[l].out && i < limits[l].max_count && i < match_count; i++) {
+                same = out[i].address == expected[i].address && out[i].pattern == expected[i].pattern;
+            }
+            mismatches += !same;
+        }
+    }
+    return mismatches;
+}
+
+static int command_check_signatures(const char* path) {
+    static const char* const level_names[] = { "scalar", "avx2" };
+    static const size_t lengths[] = { 1, 2, 3, 4, 7, 8, 9, 15, 16, 17, 24, 31, 32, 33, 48, 64, 100, 256 };
+    static const size_t end_lengths[] = { 1, 5, 16, 17, 40 };
+    struct Input {
+        const char* name;
+        DisasmMode mode;
+        std::vector<uint8_t> code;
+    };
+    std::vector<Input> inputs;
+    DisasmScanLevel best = x86_scan_level();
+    int mismatches = 0;
+
+    inputs.push_back({ "common encodings", DISASM_MODE_64, build_corpus(128 * 1024, g_corpus_mix) });
+    inputs.push_back({ "AVX-512 encodings", DISASM_MODE_64, build_corpus(64 * 1024, g_corpus_avx512) });
+    inputs.push_back({ "random bytes", DISASM_MODE_64, random_bytes(64 * 1024, 29) });
+    inputs.push_back({ "random bytes, 32-bit", DISASM_MODE_32, random_bytes(32 * 1024, 31) });
+    if (path) {
+        std::vector<uint8_t> code = read_code(path);
+        if (code.empty()) {
+            printf("error: cannot read %s\n", path);
+            return 1;
+        }
+        if (code.size() > 1024 * 1024) {
+            code.resize(1024 * 1024);
+        }
+        inputs.push_back({ path, DISASM_MODE_64, code });
+    }
+
+    printf("signature scanner against a naive masked compare\n");
+    for (size_t n = 0; n < inputs.size(); n++) {
+        const uint8_t* code = inputs[n].code.data();
+        size_t size = inputs[n].code.size();
+        std::vector<uint64_t> starts = sweep_starts(inputs[n].mode, code, size);
+        std::vector<size_t> start_offsets;
+        std::vector<std::string> texts;
+        std::vector<size_t> cuts;
+        uint32_t seed = 0x5EED + (uint32_t)n;
+
+        for (size_t offset = 0; offset < size; offset++) {
+            if ((starts[offset / 64] >> (offset % 64)) & 1) {
+                start_offsets.push_back(offset);
+            }
+        }
+        for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+            size_t at;
+
+            do {
+                seed = seed * 1103515245 + 12345;
+                at = start_offsets[(seed >> 8) % start_offsets.size()];
+            } while (at + lengths[i] > size);
+            texts.push_back(signature_text(code + at, lengths[i], &seed));
+            if (lengths[i] > 32) {
+                cuts.push_back(at + lengths[i]);
+                cuts.push_back(at + lengths[i] - 1);
+            }
+        }
+        texts.push_back(signature_text(code, 20, &seed));
+        for (size_t i = 0; i < sizeof(end_lengths) / sizeof(end_lengths[0]); i++) {
+            texts.push_back(signature_text(code + size - end_lengths[i], end_lengths[i], &seed));
+            texts.push_back(signature_text(code + size - end_lengths[i], end_lengths[i], &seed) + " ??");
+        }
+        cuts.push_back(size);
+        cuts.push_back(size - 1);
+
+        std::vector<const char*> patterns;
+        std::vector<NaiveSignature> naive(texts.size());
+        for (size_t p = 0; p < texts.size(); p++) {
+            patterns.push_back(texts[p].c_str());
+            parse_naive_signature(texts[p].c_str(), &naive[p]);
+        }
+
+        printf("  %-24s %8zu bytes, %zu patterns, %zu matches at starts", inputs[n].name, size, texts.size(),
+            naive_signature_scan(naive, code, size, 0, starts.data()).size());
+        for (int level = DISASM_SCAN_SCALAR; level <= best; level++) {
+            int failed = 0;
+
+            x86_scan_set_level((DisasmScanLevel)level);
+            // A bucket per pattern, then shared buckets
+            for (size_t count = 6; count <= texts.size(); count += texts.size() - 6) {
+                std::vector<NaiveSignature> subset(naive.begin(), naive.begin() + count);
+                SignatureSet set;
+                size_t bad;
+
+                if (!x86_signature_compile(&set, patterns.data(), count, &bad)) {
+                    printf("\nerror: cannot compile '%s'\n", bad < count ? patterns[bad] : "(out of memory)");
+                    x86_scan_set_level(best);
+                    return 1;
+                }
+                for (size_t c = 0; c < cuts.size(); c++) {
+                    failed += check_signature_scan(&set, subset, inputs[n].mode, code, cuts[c]);
+                }
+                x86_signature_free(&set);
+            }
+            printf(", %s %s", level_names[level], failed ? "MISMATCH" : "ok");
+            mismatches += failed;
+        }
+        printf("\n");
+    }
+    x86_scan_set_level(best);
+    return mismatches ? 1 : 0;
+}
+
+/*
+ * Self-check: golden decodes of single instructions
+ *
+ * Each vector is an encoding with the fields the decoder must find in it,
+ * written out by describe_decoded, and its Intel and AT&T text. The
+ * vectors were checked against objdump. The length-only decoder and the
+ * batch decoder must agree with the single instruction decoder, and a batch
+ * one byte short must stop on the truncated instruction. An argument keeps
+ * only the vectors whose bytes contain it, e.g. "62 f1".
+ */
+struct DecodeVector {
+    DisasmMode mode;
+    const char* bytes;          // Hex
+    const char* fields;         // describe_decoded() of the instruction at 0x401000
+    const char* intel;          // NULL: not checked
+    const char* att;
+};
+
+static const DecodeVector g_decode_vectors[] = {
+    // 64-bit: ModR/M, SIB, displacements and prefixes
+    { DISASM_MODE_64, "90", "len=1 map=0 op=90",
+        "nop", "nop" },
+    { DISASM_MODE_64, "c3", "len=1 map=0 op=C3",
+        "ret", "ret" },
+    { DISASM_MODE_64, "48 8b 05 10 00 00 00",
+        "len=7 rex=48 map=0 op=8B modrm=05 reg=0 rm=5 disp32=00000010 rip target=401017",
+        "mov rax, qword ptr [rip+0x10]", "mov 0x10(%rip),%rax" },
+    { DISASM_MODE_64, "8b 44 24 08", "len=4 map=0 op=8B modrm=44 reg=0 rm=4 sib=24 base=4 index=4 disp8=08",
+        "mov eax, dword ptr [rsp+0x8]", "mov 0x8(%rsp),%eax" },
+    { DISASM_MODE_64, "4c 8b 54 8d f0", "len=5 rex=4C map=0 op=8B modrm=54 reg=10 rm=4 sib=8D base=5 index=1 disp8=F0",
+        "mov r10, qword ptr [rbp+rcx*4-0x10]", "mov -0x10(%rbp,%rcx,4),%r10" },
+    { DISASM_MODE_64, "42 8b 04 a5 00 10 00 00",
+        "len=8 rex=42 map=0 op=8B modrm=04 reg=0 rm=4 sib=A5 base=5 index=12 disp32=00001000",
+        "mov eax, dword ptr [r12*4+0x1000]", "mov 0x1000(,%r12,4),%eax" },
+    { DISASM_MODE_64, "41 8b 04 24", "len=4 rex=41 map=0 op=8B modrm=04 reg=0 rm=12 sib=24 base=12 index=4",
+        "mov eax, dword ptr [r12]", "mov (%r12),%eax" },
+    { DISASM_MODE_64, "64 48 8b 04 25 28 00 00 00",
+        "len=9 seg=64 rex=48 map=0 op=8B modrm=04 reg=0 rm=4 sib=25 base=5 index=4 disp32=00000028",
+        "mov rax, qword ptr fs:[0x28]", "mov %fs:0x28,%rax" },
+    { DISASM_MODE_64, "f0 48 0f b1 0e", "len=5 lock rex=48 map=1 op=B1 modrm=0E reg=1 rm=6",
+        "lock cmpxchg qword ptr [rsi], rcx", "lock cmpxchg %rcx,(%rsi)" },
+    { DISASM_MODE_64, "f3 48 a5", "len=3 rep=F3 rex=48 map=0 op=A5",
+        "rep movs qword ptr es:[rdi], qword ptr ds:[rsi]", "rep movsq %ds:(%rsi),%es:(%rdi)" },
+    { DISASM_MODE_64, "f2 ae", "len=2 rep=F2 map=0 op=AE",
+        "repne scas al, byte ptr es:[rdi]", "repne scas %es:(%rdi),%al" },
+    { DISASM_MODE_64, "66 89 c8", "len=3 66 map=0 op=89 modrm=C8 reg=1 rm=0",
+        "mov ax, cx", "mov %cx,%ax" },
+    { DISASM_MODE_64, "67 8b 00", "len=3 67 map=0 op=8B modrm=00 reg=0 rm=0",
+        "mov eax, dword ptr [eax]", "mov (%eax),%eax" },
+
+    // Immediate sizes: REX.W over 66, moffs
+    { DISASM_MODE_64, "48 b8 88 77 66 55 44 33 22 11", "len=10 rex=48 map=0 op=B8 imm64=1122334455667788",
+        "mov rax, 0x1122334455667788", "mov $0x1122334455667788,%rax" },
+    { DISASM_MODE_64, "66 48 b8 88 77 66 55 44 33 22 11", "len=11 66 rex=48 map=0 op=B8 imm64=1122334455667788",
+        "mov rax, 0x1122334455667788", "mov $0x1122334455667788,%rax" },
+    { DISASM_MODE_64, "66 b8 34 12", "len=4 66 map=0 op=B8 imm16=1234",
+        "mov ax, 0x1234", "mov $0x1234,%ax" },
+    { DISASM_MODE_64, "48 c7 c0 ff ff ff ff", "len=7 rex=48 map=0 op=C7 modrm=C0 reg=0 rm=0 imm32=FFFFFFFF",
+        "mov rax, 0xffffffffffffffff", "mov $0xffffffffffffffff,%rax" },
+    { DISASM_MODE_64, "66 c7 00 34 12", "len=5 66 map=0 op=C7 modrm=00 reg=0 rm=0 imm16=1234",
+        "mov word ptr [rax], 0x1234", "movw $0x1234,(%rax)" },
+    { DISASM_MODE_64, "66 48 c7 c0 78 56 34 12", "len=8 66 rex=48 map=0 op=C7 modrm=C0 reg=0 rm=0 imm32=12345678",
+        "mov rax, 0x12345678", "mov $0x12345678,%rax" },
+    { DISASM_MODE_64, "66 48 05 78 56 34 12", "len=7 66 rex=48 map=0 op=05 imm32=12345678",
+        "add rax, 0x12345678", "add $0x12345678,%rax" },
+    { DISASM_MODE_64, "48 a1 88 77 66 55 44 33 22 11", "len=10 rex=48 map=0 op=A1 moffs imm64=1122334455667788",
+        "mov rax, qword ptr [0x1122334455667788]", "mov 0x1122334455667788,%rax" },
+    { DISASM_MODE_64, "67 a1 44 33 22 11", "len=6 67 map=0 op=A1 moffs imm32=11223344",
+        "mov eax, dword ptr [0x11223344]", "mov 0x11223344,%eax" },
+
+    // Branch and RIP-relative targets
+    { DISASM_MODE_64, "e8 00 01 00 00", "len=5 map=0 op=E8 imm32=00000100 rel target=401105",
+        "call 0x401105", "call 0x401105" },
+    { DISASM_MODE_64, "eb fe", "len=2 map=0 op=EB imm8=FE rel target=401000",
+        "jmp 0x401000", "jmp 0x401000" },
+    { DISASM_MODE_64, "0f 84 fa ff ff ff", "len=6 map=1 op=84 imm32=FFFFFFFA rel target=401000",
+        "je 0x401000", "je 0x401000" },
+    { DISASM_MODE_64, "e3 fe", "len=2 map=0 op=E3 imm8=FE rel target=401000",
+        "jrcxz 0x401000", "jrcxz 0x401000" },
+    { DISASM_MODE_64, "ff 15 02 00 00 00", "len=6 map=0 op=FF modrm=15 reg=2 rm=5 disp32=00000002 rip target=401008",
+        "call qword ptr [rip+0x2]", "call *0x2(%rip)" },
+    { DISASM_MODE_64, "ff d0", "len=2 map=0 op=FF modrm=D0 reg=2 rm=0",
+        "call rax", "call *%rax" },
+    { DISASM_MODE_64, "ff 24 c5 00 20 40 00",
+        "len=7 map=0 op=FF modrm=24 reg=4 rm=4 sib=C5 base=5 index=0 disp32=00402000",
+        "jmp qword ptr [rax*8+0x402000]", "jmp *0x402000(,%rax,8)" },
+
+    // Groups and immediates selected by ModR/M.reg
+    { DISASM_MODE_64, "c2 08 00", "len=3 map=0 op=C2 imm16=0008",
+        "ret 0x8", "ret $0x8" },
+    { DISASM_MODE_64, "c8 10 00 01", "len=4 map=0 op=C8 imm16=0010 imm8",
+        "enter 0x10, 0x1", "enter $0x1,$0x10" },
+    { DISASM_MODE_64, "f6 c0 05", "len=3 map=0 op=F6 modrm=C0 reg=0 rm=0 imm8=05",
+        "test al, 0x5", "test $0x5,%al" },
+    { DISASM_MODE_64, "f6 c8 05", "len=3 map=0 op=F6 modrm=C8 reg=1 rm=0 imm8=05",
+        "test al, 0x5", "test $0x5,%al" },
+    { DISASM_MODE_64, "f7 c1 78 56 34 12", "len=6 map=0 op=F7 modrm=C1 reg=0 rm=1 imm32=12345678",
+        "test ecx, 0x12345678", "test $0x12345678,%ecx" },
+    { DISASM_MODE_64, "66 f7 c1 34 12", "len=5 66 map=0 op=F7 modrm=C1 reg=0 rm=1 imm16=1234",
+        "test cx, 0x1234", "test $0x1234,%cx" },
+    { DISASM_MODE_64, "fe c0", "len=2 map=0 op=FE modrm=C0 reg=0 rm=0",
+        "inc al", "inc %al" },
+    { DISASM_MODE_64, "fe d0", "len=2 map=0 op=FE modrm=D0 reg=2 rm=0 error=3",
+        "(bad)", "(bad)" },
+    { DISASM_MODE_64, "0f 01 d0", "len=3 map=1 op=01 modrm=D0 reg=2 rm=0",
+        "xgetbv", "xgetbv" },
+    { DISASM_MODE_64, "0f 05", "len=2 map=1 op=05",
+        "syscall", "syscall" },
+    { DISASM_MODE_64, "0f af c1", "len=3 map=1 op=AF modrm=C1 reg=0 rm=1",
+        "imul eax, ecx", "imul %ecx,%eax" },
+    { DISASM_MODE_64, "6b c0 10", "len=3 map=0 op=6B modrm=C0 reg=0 rm=0 imm8=10",
+        "imul eax, eax, 0x10", "imul $0x10,%eax,%eax" },
+    { DISASM_MODE_64, "69 c0 00 01 00 00", "len=6 map=0 op=69 modrm=C0 reg=0 rm=0 imm32=00000100",
+        "imul eax, eax, 0x100", "imul $0x100,%eax,%eax" },
+    { DISASM_MODE_64, "0f ba e0 05", "len=4 map=1 op=BA modrm=E0 reg=4 rm=0 imm8=05",
+        "bt eax, 0x5", "bt $0x5,%eax" },
+    { DISASM_MODE_64, "c1 f0 05", "len=3 map=0 op=C1 modrm=F0 reg=6 rm=0 imm8=05",
+        "sal eax, 0x5", "sal $0x5,%eax" },
+    { DISASM_MODE_64, "c0 30 05", "len=3 map=0 op=C0 modrm=30 reg=6 rm=0 imm8=05",
+        "sal byte ptr [rax], 0x5", "salb $0x5,(%rax)" },
+    { DISASM_MODE_64, "d1 f0", "len=2 map=0 op=D1 modrm=F0 reg=6 rm=0",
+        "sal eax, 1", "sal %eax" },
+    { DISASM_MODE_64, "d3 f0", "len=2 map=0 op=D3 modrm=F0 reg=6 rm=0",
+        "sal eax, cl", "sal %cl,%eax" },
+    { DISASM_MODE_64, "c1 e0 05", "len=3 map=0 op=C1 modrm=E0 reg=4 rm=0 imm8=05",
+        "shl eax, 0x5", "shl $0x5,%eax" },
+    { DISASM_MODE_64, "f3 0f b8 c1", "len=4 rep=F3 map=1 op=B8 modrm=C1 reg=0 rm=1",
+        "popcnt eax, ecx", "popcnt %ecx,%eax" },
+    { DISASM_MODE_64, "f3 48 0f b8 44 24 08",
+        "len=7 rep=F3 rex=48 map=1 op=B8 modrm=44 reg=0 rm=4 sib=24 base=4 index=4 disp8=08",
+        "popcnt rax, qword ptr [rsp+0x8]", "popcnt 0x8(%rsp),%rax" },
+
+    // 0F 38, 0F 3A and the 3DNow! suffix byte
+    { DISASM_MODE_64, "66 0f 3a 0f c1 08", "len=6 66 map=3 op=0F modrm=C1 reg=0 rm=1 imm8=08",
+        "palignr xmm0, xmm1, 0x8", "palignr $0x8,%xmm1,%xmm0" },
+    { DISASM_MODE_64, "66 0f 38 00 c1", "len=5 66 map=2 op=00 modrm=C1 reg=0 rm=1",
+        "pshufb xmm0, xmm1", "pshufb %xmm1,%xmm0" },
+    { DISASM_MODE_64, "66 0f 3a 63 c1 0a", "len=6 66 map=3 op=63 modrm=C1 reg=0 rm=1 imm8=0A",
+        "pcmpistri xmm0, xmm1, 0xa", "pcmpistri $0xa,%xmm1,%xmm0" },
+    { DISASM_MODE_64, "0f 0f c1 b4", "len=4 map=1 op=0F modrm=C1 reg=0 rm=1 imm8=B4",
+        NULL, NULL },
+    { DISASM_MODE_64, "0f 0f 40 10 9e", "len=5 map=1 op=0F modrm=40 reg=0 rm=0 disp8=10 imm8=9E",
+        NULL, NULL },
+    { DISASM_MODE_64, "f3 0f 1e fa", "len=4 rep=F3 map=1 op=1E modrm=FA reg=7 rm=2",
+        "endbr64", "endbr64" },
+
+    // VEX, EVEX and XOP
+    { DISASM_MODE_64, "c5 f9 6f c1", "len=4 vex pp=1 l=0 v=0 w=0 map=1 op=6F modrm=C1 reg=0 rm=1",
+        "vmovdqa xmm0, xmm1", "vmovdqa %xmm1,%xmm0" },
+    { DISASM_MODE_64, "c5 fd 6f 05 00 01 00 00",
+        "len=8 vex pp=1 l=1 v=0 w=0 map=1 op=6F modrm=05 reg=0 rm=5 disp32=00000100 rip target=401108",
+        "vmovdqa ymm0, ymmword ptr [rip+0x100]", "vmovdqa 0x100(%rip),%ymm0" },
+    { DISASM_MODE_64, "c4 e3 7d 18 c1 01", "len=6 vex pp=1 l=1 v=0 w=0 map=3 op=18 modrm=C1 reg=0 rm=1 imm8=01",
+        "vinsertf128 ymm0, ymm0, xmm1, 0x1", "vinsertf128 $0x1,%xmm1,%ymm0,%ymm0" },
+    { DISASM_MODE_64, "c4 e2 7d 18 44 24 08",
+        "len=7 vex pp=1 l=1 v=0 w=0 map=2 op=18 modrm=44 reg=0 rm=4 sib=24 base=4 index=4 disp8=08",
+        "vbroadcastss ymm0, dword ptr [rsp+0x8]", "vbroadcastss 0x8(%rsp),%ymm0" },
+    { DISASM_MODE_64, "c4 c1 78 28 c8", "len=5 vex pp=0 l=0 v=0 w=0 map=1 op=28 modrm=C8 reg=1 rm=8",
+        "vmovaps xmm1, xmm8", "vmovaps %xmm8,%xmm1" },
+    { DISASM_MODE_64, "62 f1 7c 48 58 40 01",
+        "len=7 evex pp=0 l=2 v=0 w=0 k=0 z=0 b=0 map=1 op=58 modrm=40 reg=0 rm=0 disp8=01 N=64",
+        "vaddps zmm0, zmm0, zmmword ptr [rax+0x40]", "vaddps 0x40(%rax),%zmm0,%zmm0" },
+    { DISASM_MODE_64, "62 f1 7c 58 58 40 01",
+        "len=7 evex pp=0 l=2 v=0 w=0 k=0 z=0 b=1 map=1 op=58 modrm=40 reg=0 rm=0 disp8=01 N=4",
+        "vaddps zmm0, zmm0, dword ptr [rax+0x4]{1to16}", "vaddps 0x4(%rax){1to16},%zmm0,%zmm0" },
+    { DISASM_MODE_64, "62 f1 fd 48 6f 48 02",
+        "len=7 evex pp=1 l=2 v=0 w=1 k=0 z=0 b=0 map=1 op=6F modrm=48 reg=1 rm=0 disp8=02 N=64",
+        "vmovdqa64 zmm1, zmmword ptr [rax+0x80]", "vmovdqa64 0x80(%rax),%zmm1" },
+    { DISASM_MODE_64, "62 e1 7c 48 58 c9", "len=6 evex pp=0 l=2 v=0 w=0 k=0 z=0 b=0 map=1 op=58 modrm=C9 reg=17 rm=1",
+        "vaddps zmm17, zmm0, zmm1", "vaddps %zmm1,%zmm0,%zmm17" },
+    { DISASM_MODE_64, "62 f1 7c 4a 58 c1", "len=6 evex pp=0 l=2 v=0 w=0 k=2 z=0 b=0 map=1 op=58 modrm=C1 reg=0 rm=1",
+        "vaddps zmm0{k2}, zmm0, zmm1", "vaddps %zmm1,%zmm0,%zmm0{%k2}" },
+    { DISASM_MODE_64, "62 f1 7c ca 58 c1", "len=6 evex pp=0 l=2 v=0 w=0 k=2 z=1 b=0 map=1 op=58 modrm=C1 reg=0 rm=1",
+        "vaddps zmm0{k2}{z}, zmm0, zmm1", "vaddps %zmm1,%zmm0,%zmm0{%k2}{z}" },
+    { DISASM_MODE_64, "62 f2 7d 48 18 40 01",
+        "len=7 evex pp=1 l=2 v=0 w=0 k=0 z=0 b=0 map=2 op=18 modrm=40 reg=0 rm=0 disp8=01 N=4",
+        "vbroadcastss zmm0, dword ptr [rax+0x4]", "vbroadcastss 0x4(%rax),%zmm0" },
+    { DISASM_MODE_64, "8f e8 78 c0 c1 05", "len=6 xop pp=0 l=0 v=0 w=0 map=8 op=C0 modrm=C1 reg=0 rm=1 imm8=05",
+        NULL, NULL },
+    { DISASM_MODE_64, "8f e9 78 81 c1", "len=5 xop pp=0 l=0 v=0 w=0 map=9 op=81 modrm=C1 reg=0 rm=1",
+        NULL, NULL },
+
+    // AVX512-FP16 disp8*N, per tuple and pp (each encodes disp = N)
+    { DISASM_MODE_64, "62 f5 7e 08 5a 40 01",
+        "len=7 evex pp=2 l=0 v=0 w=0 k=0 z=0 b=0 map=5 op=5A modrm=40 reg=0 rm=0 disp8=01 N=2",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f5 f7 08 5a 40 01",
+        "len=7 evex pp=3 l=0 v=1 w=1 k=0 z=0 b=0 map=5 op=5A modrm=40 reg=0 rm=0 disp8=01 N=8",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f5 7c 48 5a 40 01",
+        "len=7 evex pp=0 l=2 v=0 w=0 k=0 z=0 b=0 map=5 op=5A modrm=40 reg=0 rm=0 disp8=01 N=16",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f5 7c 58 5a 40 01",
+        "len=7 evex pp=0 l=2 v=0 w=0 k=0 z=0 b=1 map=5 op=5A modrm=40 reg=0 rm=0 disp8=01 N=2",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f5 fd 58 5a 40 01",
+        "len=7 evex pp=1 l=2 v=0 w=1 k=0 z=0 b=1 map=5 op=5A modrm=40 reg=0 rm=0 disp8=01 N=8",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f6 7d 48 13 40 01",
+        "len=7 evex pp=1 l=2 v=0 w=0 k=0 z=0 b=0 map=6 op=13 modrm=40 reg=0 rm=0 disp8=01 N=32",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f6 74 08 13 40 01",
+        "len=7 evex pp=0 l=0 v=1 w=0 k=0 z=0 b=0 map=6 op=13 modrm=40 reg=0 rm=0 disp8=01 N=2",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f5 74 08 1d 40 01",
+        "len=7 evex pp=0 l=0 v=1 w=0 k=0 z=0 b=0 map=5 op=1D modrm=40 reg=0 rm=0 disp8=01 N=4",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f5 7d 48 7b 40 01",
+        "len=7 evex pp=1 l=2 v=0 w=0 k=0 z=0 b=0 map=5 op=7B modrm=40 reg=0 rm=0 disp8=01 N=16",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f5 7c 58 5b 40 01",
+        "len=7 evex pp=0 l=2 v=0 w=0 k=0 z=0 b=1 map=5 op=5B modrm=40 reg=0 rm=0 disp8=01 N=4",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f5 76 08 7b 40 01",
+        "len=7 evex pp=2 l=0 v=1 w=0 k=0 z=0 b=0 map=5 op=7B modrm=40 reg=0 rm=0 disp8=01 N=4",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f6 76 58 56 40 01",
+        "len=7 evex pp=2 l=2 v=1 w=0 k=0 z=0 b=1 map=6 op=56 modrm=40 reg=0 rm=0 disp8=01 N=4",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f6 76 08 57 40 01",
+        "len=7 evex pp=2 l=0 v=1 w=0 k=0 z=0 b=0 map=6 op=57 modrm=40 reg=0 rm=0 disp8=01 N=4",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f6 75 08 2d 40 01",
+        "len=7 evex pp=1 l=0 v=1 w=0 k=0 z=0 b=0 map=6 op=2D modrm=40 reg=0 rm=0 disp8=01 N=2",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f3 7c 08 67 48 01 01",
+        "len=8 evex pp=0 l=0 v=0 w=0 k=0 z=0 b=0 map=3 op=67 modrm=48 reg=1 rm=0 disp8=01 N=2 imm8=01",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f3 7d 08 67 48 01 01",
+        "len=8 evex pp=1 l=0 v=0 w=0 k=0 z=0 b=0 map=3 op=67 modrm=48 reg=1 rm=0 disp8=01 N=4 imm8=01",
+        NULL, NULL },
+    { DISASM_MODE_64, "62 f3 74 58 c2 48 01 01",
+        "len=8 evex pp=0 l=2 v=1 w=0 k=0 z=0 b=1 map=3 op=C2 modrm=48 reg=1 rm=0 disp8=01 N=2 imm8=01",
+        NULL, NULL },
+
+    // 32-bit mode: no REX, LES/BOUND, 16-bit branch targets, far pointers
+    { DISASM_MODE_32, "b8 78 56 34 12", "len=5 map=0 op=B8 imm32=12345678",
+        "mov eax, 0x12345678", "mov $0x12345678,%eax" },
+    { DISASM_MODE_32, "66 b8 34 12", "len=4 66 map=0 op=B8 imm16=1234",
+        "mov ax, 0x1234", "mov $0x1234,%ax" },
+    { DISASM_MODE_32, "40", "len=1 map=0 op=40",
+        "inc eax", "inc %eax" },
+    { DISASM_MODE_32, "8b 05 00 10 00 00", "len=6 map=0 op=8B modrm=05 reg=0 rm=5 disp32=00001000",
+        "mov eax, dword ptr [0x1000]", "mov 0x1000,%eax" },
+    { DISASM_MODE_32, "c4 06", "len=2 map=0 op=C4 modrm=06 reg=0 rm=6",
+        "les eax, fword ptr [esi]", "les (%esi),%eax" },
+    { DISASM_MODE_32, "62 06", "len=2 map=0 op=62 modrm=06 reg=0 rm=6",
+        NULL, NULL },
+    { DISASM_MODE_32, "c5 f9 6f c1", "len=4 vex pp=1 l=0 v=0 w=0 map=1 op=6F modrm=C1 reg=0 rm=1",
+        "vmovdqa xmm0, xmm1", "vmovdqa %xmm1,%xmm0" },
+    { DISASM_MODE_32, "e8 fb ff ff ff", "len=5 map=0 op=E8 imm32=FFFFFFFB rel target=401000",
+        "call 0x401000", "call 0x401000" },
+    { DISASM_MODE_32, "66 e9 fc ff", "len=4 66 map=0 op=E9 imm16=FFFC rel target=1000",
+        "jmp 0x1000", "jmp 0x1000" },
+    { DISASM_MODE_32, "a1 44 33 22 11", "len=5 map=0 op=A1 moffs imm32=11223344",
+        "mov eax, dword ptr [0x11223344]", "mov 0x11223344,%eax" },
+    { DISASM_MODE_32, "67 a1 34 12", "len=4 67 map=0 op=A1 moffs imm16=1234",
+        "mov eax, dword ptr [0x1234]", "mov 0x1234,%eax" },
+    { DISASM_MODE_32, "9a 78 56 34 12 cd ab", "len=7 map=0 op=9A far imm32=12345678",
+        "call 0xabcd:0x12345678", "lcall $0xabcd,$0x12345678" },
+    { DISASM_MODE_32, "66 9a 34 12 cd ab", "len=6 66 map=0 op=9A far imm16=1234",
+        "call 0xabcd:0x1234", "lcall $0xabcd,$0x1234" },
+
+    // 16-bit mode
+    { DISASM_MODE_16, "b8 34 12", "len=3 map=0 op=B8 imm16=1234",
+        "mov ax, 0x1234", "mov $0x1234,%ax" },
+    { DISASM_MODE_16, "66 b8 78 56 34 12", "len=6 66 map=0 op=B8 imm32=12345678",
+        "mov eax, 0x12345678", "mov $0x12345678,%eax" },
+    { DISASM_MODE_16, "8b 46 02", "len=3 map=0 op=8B modrm=46 reg=0 rm=6 disp8=02",
+        "mov ax, word ptr [bp+0x2]", "mov 0x2(%bp),%ax" },
+    { DISASM_MODE_16, "8b 87 00 10", "len=4 map=0 op=8B modrm=87 reg=0 rm=7 disp16=1000",
+        "mov ax, word ptr [bx+0x1000]", "mov 0x1000(%bx),%ax" },
+    { DISASM_MODE_16, "67 8b 44 24 08", "len=5 67 map=0 op=8B modrm=44 reg=0 rm=4 sib=24 base=4 index=4 disp8=08",
+        "mov ax, word ptr [esp+0x8]", "mov 0x8(%esp),%ax" },
+    { DISASM_MODE_16, "e8 fd ff", "len=3 map=0 op=E8 imm16=FFFD rel target=1000",
+        "call 0x1000", "call 0x1000" },
+    { DISASM_MODE_16, "ea 00 00 00 f0", "len=5 map=0 op=EA far imm16=0000",
+        "jmp 0xf000:0x0", "ljmp $0xf000,$0x0" },
+    { DISASM_MODE_16, "a1 34 12", "len=3 map=0 op=A1 moffs imm16=1234",
+        "mov ax, word ptr [0x1234]", "mov 0x1234,%ax" },
+};
+
+static size_t parse_hex(const char* text, uint8_t* bytes, size_t size) {
+    size_t count = 0;
+
+    while (*text && count < size) {
+        unsigned int value;
+
+        if (*text == ' ') {
+            text++;
+            continue;
+        }
+        if (sscanf(text, "%2x", &value) != 1) {
+            break;
+        }
+        bytes[count++] = (uint8_t)value;
+        text += 2;
+    }
+    return count;
+}
+
+// Fields of a decoded instruction as text, only those that are present
+static std::string describe_decoded(const DecodedInstruction* insn) {
+    const InstructionInfo* info = &insn->info;
+    uint32_t flags = info->flags;
+    std::string text;
+    char field[48];
+
+#define DESCRIBE(...) (snprintf(field, sizeof(field), __VA_ARGS__), text += text.empty() ? "" : " ", text += field)
+
+    DESCRIBE("len=%u", info->length);
+    if (info->prefix_lock) DESCRIBE("lock");
+    if (info->prefix_rep) DESCRIBE("rep=%02X", info->prefix_rep);
+    if (info->prefix_seg) DESCRIBE("seg=%02X", info->prefix_seg);
+    if (info->prefix_66) DESCRIBE("66");
+    if (info->prefix_67) DESCRIBE("67");
+    if (flags & FLAG_PREFIX_REX) DESCRIBE("rex=%02X", info->rex);
+    if (flags & FLAG_MASK_ANY_VECTOR) {
+        DESCRIBE("%s pp=%u l=%u v=%u w=%u", flags & FLAG_EVEX ? "evex" : flags & FLAG_XOP ? "xop" : "vex", info->vex_pp,
+            info->vex_l, info->vex_vvvv, info->rex_w);
+    }
+    if (flags & FLAG_EVEX) DESCRIBE("k=%u z=%u b=%u", info->evex_aaa, info->evex_z, info->evex_b);
+    DESCRIBE("map=%u op=%02X", info->map, info->map ? info->opcode2 : info->opcode);
+    if (flags & FLAG_MODRM) DESCRIBE("modrm=%02X reg=%u rm=%u", info->modrm, info->modrm_reg, info->modrm_rm);
+    if (flags & FLAG_SIB) DESCRIBE("sib=%02X base=%u index=%u", info->sib, info->sib_base, info->sib_index);
+    if (flags & FLAG_DISP8) DESCRIBE("disp8=%02X", info->displacement.disp8);
+    if (flags & FLAG_DISP16) DESCRIBE("disp16=%04X", info->displacement.disp16);
+    if (flags & FLAG_DISP32) DESCRIBE("disp32=%08X", info->displacement.disp32);
+    if (info->disp_scale) DESCRIBE("N=%u", info->disp_scale);
+    if (flags & FLAG_FAR_POINTER) DESCRIBE("far");
+    if (flags & FLAG_MOFFS) DESCRIBE("moffs");
+    if (flags & FLAG_IMM64) {
+        DESCRIBE("imm64=%016llX", (unsigned long long)info->immediate.imm64);
+    }
+    else if (flags & FLAG_IMM32) {
+        DESCRIBE("imm32=%08X", info->immediate.imm32);
+    }
+    else if (flags & FLAG_IMM16) {
+        DESCRIBE("imm16=%04X", info->immediate.imm16);
+    }
+    if ((flags & FLAG_IMM8) && !(flags & FLAG_IMM16)) DESCRIBE("imm8=%02X", info->immediate.imm8);
+    if ((flags & FLAG_IMM8) && (flags & FLAG_IMM16)) DESCRIBE("imm8");
+    if (flags & FLAG_RELATIVE) DESCRIBE("rel");
+    if (flags & FLAG_RIP_RELATIVE) DESCRIBE("rip");
+    if (insn->target) DESCRIBE("target=%llX", (unsigned long long)insn->target);
+    if (flags & FLAG_MASK_ANY_ERROR) DESCRIBE("error=%X", (flags & FLAG_MASK_ANY_ERROR) >> 12);
+
+#undef DESCRIBE
+    return text;
+}
+
+static int command_check_decode(const char* filter) {
+    const uint64_t address = 0x401000;
+    size_t count = sizeof(g_decode_vectors) / sizeof(g_decode_vectors[0]);
+    size_t checked = 0;
+    int failures = 0;
+
+    printf("golden decodes\n");
+    for (size_t v = 0; v < count; v++) {
+        const DecodeVector* vector = &g_decode_vectors[v];
+        uint8_t code[32] = { 0 };
+        size_t size = parse_hex(vector->bytes, code, sizeof(code));
+        DecodedInstruction insn;
+        DecodedInstruction batch[2];
+        DisasmBatchResult result;
+        uint8_t length = 0;
+        char intel[X86_FORMAT_BUFFER_SIZE];
+        char att[X86_FORMAT_BUFFER_SIZE];
+        std::vector<std::string> problems;
+
+        if (filter && !strstr(vector->bytes, filter)) {
+            continue;
+        }
+        checked++;
+
+        // The single decoder reads a full window; the buffer is zero-padded
+        insn.address = address;
+        x86_disasm_batch_mode(vector->mode, code, sizeof(code), address, &insn, 1, NULL);
+        std::string fields = describe_decoded(&insn);
+        x86_format_mode(vector->mode, &insn.info, address, DISASM_FORMAT_INTEL, intel, sizeof(intel));
+        x86_format_mode(vector->mode, &insn.info, address, DISASM_FORMAT_ATT, att, sizeof(att));
+
+        if (fields != vector->fields) {
+            problems.push_back("fields '" + fields + "'");
+        }
+        if (vector->intel && strcmp(intel, vector->intel) != 0) {
+            problems.push_back(std::string("intel '") + intel + "'");
+        }
+        if (vector->att && strcmp(att, vector->att) != 0) {
+            problems.push_back(std::string("att '") + att + "'");
+        }
+        if (insn.info.length != size) {
+            problems.push_back("length differs from the vector");
+        }
+        if (x86_insn_length_mode(vector->mode, code) != insn.info.length) {
+            problems.push_back("x86_insn_length_mode differs");
+        }
+        if (x86_insn_length_batch_mode(vector->mode, code, size, &length, 1, &result) != 1 || length != size) {
+            problems.push_back("x86_insn_length_batch_mode differs");
+        }
+
+        // Exactly the instruction's bytes, then one byte short
+        if (x86_disasm_batch_mode(vector->mode, code, size, address, batch, 2, &result) != 1 ||
+            result.reason != DISASM_STOP_END || describe_decoded(&batch[0]) != fields) {
+            problems.push_back("batch decode of the exact bytes differs");
+        }
+        if (size > 1 && (x86_disasm_batch_mode(vector->mode, code, size - 1, address, batch, 2, &result) != 0 ||
+            result.reason != DISASM_STOP_TRUNCATED || result.offset != 0)) {
+            problems.push_back("batch decode does not stop on the truncated instruction");
+        }
+
+        for (size_t p = 0; p < problems.size(); p++) {
+            printf("  %d-bit %-32s %s, MISMATCH\n", (int)vector->mode, vector->bytes, problems[p].c_str());
+        }
+        failures += !problems.empty();
+    }
+    printf("  %zu vectors, %d failed\n", checked, failures);
+    return failures ? 1 : 0;
+}
+
+/*
+ * Self-check: x86_descent against a single-threaded worklist traversal
+ *
+ * The worklist follows the same rules one path at a time: seeds and
+ * in-buffer relative targets are queued, a path ends at a jump, return,
+ * stop, invalid instruction or code already decoded. Whatever order the
+ * threads take the paths in, the starts, targets and calls maps must be
+ * the same.
+ */
+struct NaiveCodeMap {
+    std::vector<uint64_t> starts;
+    std::vector<uint64_t> targets;
+    std::vector<uint64_t> calls;
+};
+
+static void naive_descent(DisasmMode mode, const uint8_t* code, size_t length, uint64_t address,
+    const std::vector<uint64_t>& seeds, NaiveCodeMap* map) {
+    std::vector<size_t> worklist;
+    size_t words = (length + 63) / 64;
+
+    map->starts.assign(words, 0);
+    map->targets.assign(words, 0);
+    map->calls.assign(words, 0);
+    for (size_t i = 0; i < seeds.size(); i++) {
+        size_t offset = (size_t)(seeds[i] - address);
+
+        if (seeds[i] - address < length) {
+            map->targets[offset / 64] |= (uint64_t)1 << (offset % 64);
+            map->calls[offset / 64] |= (uint64_t)1 << (offset % 64);
+            worklist.push_back(offset);
+        }
+    }
+
+    while (!worklist.empty()) {
+        size_t offset = worklist.back();
+
+        worklist.pop_back();
+        while (offset < length && !((map->starts[offset / 64] >> (offset % 64)) & 1)) {
+            DecodedInstruction insn;
+
+            if (x86_disasm_batch_mode(mode, code + offset, length - offset, address + offset, &insn, 1, NULL) == 0 ||
+                (insn.info.flags & FLAG_MASK_ANY_ERROR)) {
+                break;
+            }
+            map->starts[offset / 64] |= (uint64_t)1 << (offset % 64);
+
+            DisasmFlow flow = x86_control_flow(&insn.info);
+            if ((flow == DISASM_FLOW_BRANCH || flow == DISASM_FLOW_JUMP || flow == DISASM_FLOW_CALL) &&
+                insn.target - address < length) {
+                size_t target = (size_t)(insn.target - address);
+
+                map->targets[target / 64] |= (uint64_t)1 << (target % 64);
+                if (flow == DISASM_FLOW_CALL) {
+                    map->calls[target / 64] |= (uint64_t)1 << (target % 64);
+                }
+                worklist.push_back(target);
+            }
+            if (flow == DISASM_FLOW_JUMP || flow == DISASM_FLOW_INDIRECT_JUMP ||
+                flow == DISASM_FLOW_RETURN || flow == DISASM_FLOW_STOP) {
+                break;
+            }
+            offset += insn.info.length;
+        }
+    }
+}
+
+static int check_descent(const char* name, DisasmMode mode, const uint8_t* code, size_t length, uint64_t address,
+    const std::vector<uint64_t>& seeds) {
+    static const unsigned int thread_counts[] = { 1, 2, 3, 4, 8 };
+    NaiveCodeMap expected;
+    size_t words = (length + 63) / 64;
+    size_t count = 0;
+    int failed = 0;
+
+    naive_descent(mode, code, length, address, seeds, &expected);
+    for (size_t w = 0; w < words; w++) {
+        count += std::bitset<64>(expected.starts[w]).count();
+    }
+
+    printf("  %-24s %8zu bytes, %4zu seeds, %7zu instructions", name, length, seeds.size(), count);
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        // Thread interleavings vary between runs: repeat the parallel ones
+        for (int run = 0; run < (thread_counts[t] == 1 ? 1 : 3); run++) {
+            CodeMap map;
+
+            if (!x86_descent(mode, code, length, address, seeds.data(), seeds.size(), thread_counts[t], &map)) {
+                printf("\nerror: out of memory\n");
+                x86_code_map_free(&map);
+                return 1;
+            }
+            if (map.instruction_count != count ||
+                memcmp(map.starts, expected.starts.data(), words * sizeof(uint64_t)) != 0 ||
+                memcmp(map.targets, expected.targets.data(), words * sizeof(uint64_t)) != 0 ||
+                memcmp(map.calls, expected.calls.data(), words * sizeof(uint64_t)) != 0) {
+                if (!failed) {
+                    printf(", MISMATCH with %u threads", thread_counts[t]);
+                }
+                failed = 1;
+            }
+            x86_code_map_free(&map);
+        }
+    }
+    printf("\n");
+    return failed;
+}
+
+// Seeds spread over a buffer, with a duplicate and two outside it
+static std::vector<uint64_t> descent_seeds(size_t length, uint64_t address, size_t count, uint32_t seed) {
+    std::vector<uint64_t> seeds;
+
+    for (size_t i = 0; i < count; i++) {
+        seed = seed * 1103515245 + 12345;
+        seeds.push_back(address + ((size_t)(seed >> 8) * 257) % length);
+    }
+    seeds.push_back(seeds[0]);
+    seeds.push_back(address - 1);
+    seeds.push_back(address + length);
+    return seeds;
+}
+
+static int command_check_descent(const char* path) {
+    struct Buffer {
+        const char* name;
+        DisasmMode mode;
+        std::vector<uint8_t> code;
+    };
+    std::vector<Buffer> buffers;
+    int mismatches = 0;
+
+    buffers.push_back({ "common encodings", DISASM_MODE_64, build_corpus(1 << 20, g_corpus_mix) });
+    buffers.push_back({ "random bytes", DISASM_MODE_64, random_bytes(512 * 1024 + 3, 37) });
+    buffers.push_back({ "random bytes, 32-bit", DISASM_MODE_32, random_bytes(256 * 1024 + 1, 41) });
+
+    // Branch and call targets one past the end are outside the buffer
+    Buffer edge = { "targets at the end", DISASM_MODE_64, std::vector<uint8_t>(64, 0x90) };
+    static const uint8_t tail[] = { 0x74, 0x07, 0xEB, 0x05, 0xE8, 0x00, 0x00, 0x00, 0x00 };
+    edge.code.insert(edge.code.end(), tail, tail + sizeof(tail));
+    buffers.push_back(edge);
+
+    printf("recursive descent against a single-threaded worklist\n");
+    for (size_t b = 0; b < buffers.size(); b++) {
+        const Buffer* buffer = &buffers[b];
+        std::vector<uint64_t> seeds = descent_seeds(buffer->code.size(), 0x10000,
+            buffer->code.size() / 256 + 1, 0xDE5C + (uint32_t)b);
+
+        mismatches += check_descent(buffer->name, buffer->mode, buffer->code.data(), buffer->code.size(),
+            0x10000, seeds);
+    }
+
+    if (path) {
+        LoadedImage image;
+        std::vector<uint64_t> seeds;
+
+        DisasmImageStatus status = x86_image_load(path, DISASM_MAP_DEFAULT, &image);
+        if (status != DISASM_IMAGE_OK) {
+            printf("error: cannot load %s (status %d)\n", path, (int)status);
+            x86_image_free(&image);
+            return 1;
+        }
+        if (image.entry) {
+            seeds.push_back(image.entry);
+        }
+        for (size_t i = 0; i < image.function_count; i++) {
+            seeds.push_back(image.functions[i].start);
+        }
+        for (size_t r = 0; r < image.region_count; r++) {
+            const CodeRegion* region = &image.regions[r];
+
+            mismatches += check_descent(path, image.mode, region->code, region->size, region->address, seeds);
+        }
+        x86_image_free(&image);
+    }
+
+    return mismatches ? 1 : 0;
+}
+
+/*
+ * Self-check: x86_cfg_build against a naive builder
+ *
+ * The naive builder keeps instructions, leaders and blocks in std::maps
+ * keyed by address and follows the documented rules directly. Blocks,
+ * edges in their order, predecessor lists and x86_cfg_block lookups must
+ * match, on dense sweeps (bitmap index), on sweeps with gaps and on sparse
+ * records (binary searches).
+ */
+struct NaiveBlock {
+    uint64_t end;
+    size_t first;
+    uint32_t instruction_count;
+    DisasmFlow flow;
+};
+
+struct NaiveEdge {
+    uint64_t from;
+    uint64_t to;
+    DisasmEdgeType type;
+};
+
+static int check_cfg(const char* name, const std::vector<DecodedInstruction>& insns) {
+    std::map<uint64_t, size_t> instructions;
+    std::map<uint64_t, NaiveBlock> blocks;
+    std::map<uint64_t, std::vector<size_t> > predecessors;
+    std::vector<NaiveEdge> edges;
+    std::vector<bool> leaders(insns.size());
+    DisasmArena arena;
+    ControlFlowGraph cfg;
+    int failed = 0;
+
+    for (size_t i = 0; i < insns.size(); i++) {
+        instructions[insns[i].address] = i;
+    }
+
+    // Leaders: the first instruction, decoded targets, and whatever follows a block end or a gap
+    for (size_t i = 0; i < insns.size(); i++) {
+        DisasmFlow flow = x86_control_flow(&insns[i].info);
+
+        if (i == 0) {
+            leaders[i] = true;
+        }
+        if (flow == DISASM_FLOW_BRANCH || flow == DISASM_FLOW_JUMP || flow == DISASM_FLOW_CALL) {
+            std::map<uint64_t, size_t>::const_iterator target = instructions.find(insns[i].target);
+            if (target != instructions.end()) {
+                leaders[target->second] = true;
+            }
+        }
+        if (i + 1 < insns.size() && (flow == DISASM_FLOW_BRANCH || flow == DISASM_FLOW_JUMP ||
+            flow == DISASM_FLOW_INDIRECT_JUMP || flow == DISASM_FLOW_RETURN || flow == DISASM_FLOW_STOP ||
+            insns[i + 1].address != insns[i].address + insns[i].info.length)) {
+            leaders[i + 1] = true;
+        }
+    }
+
+    uint64_t current = 0;
+    for (size_t i = 0; i < insns.size(); i++) {
+        if (leaders[i]) {
+            current = insns[i].address;
+            blocks[current] = { 0, i, 0, DISASM_FLOW_NONE };
+        }
+        NaiveBlock* block = &blocks[current];
+        block->end = insns[i].address + insns[i].info.length;
+        block->instruction_count++;
+        block->flow = x86_control_flow(&insns[i].info);
+    }
+
+    for (std::map<uint64_t, NaiveBlock>::const_iterator it = blocks.begin(); it != blocks.end(); ++it) {
+        const NaiveBlock* block = &it->second;
+        const DecodedInstruction* last = &insns[block->first + block->instruction_count - 1];
+        std::map<uint64_t, NaiveBlock>::const_iterator next = it;
+
+        ++next;
+        if ((block->flow == DISASM_FLOW_BRANCH || block->flow == DISASM_FLOW_JUMP) && blocks.count(last->target)) {
+            edges.push_back({ it->first, last->target,
+                block->flow == DISASM_FLOW_JUMP ? DISASM_EDGE_JUMP : DISASM_EDGE_BRANCH });
+        }
+        if ((block->flow == DISASM_FLOW_NONE || block->flow == DISASM_FLOW_BRANCH ||
+            block->flow == DISASM_FLOW_CALL || block->flow == DISASM_FLOW_INDIRECT_CALL) &&
+            next != blocks.end() && next->first == block->end) {
+            edges.push_back({ it->first, next->first, DISASM_EDGE_FALLTHROUGH });
+        }
+    }
+    for (size_t e = 0; e < edges.size(); e++) {
+        predecessors[edges[e].to].push_back(e);
+    }
+
+    x86_arena_init(&arena, 0);
+    if (!x86_cfg_build(insns.data(), insns.size(), &arena, &cfg)) {
+        printf("error: out of memory\n");
+        x86_arena_free(&arena);
+        return 1;
+    }
+
+    failed |= cfg.block_count != blocks.size() || cfg.edge_count != edges.size();
+    size_t b = 0;
+    for (std::map<uint64_t, NaiveBlock>::const_iterator it = blocks.begin(); !failed && it != blocks.end(); ++it, b++) {
+        const BasicBlock* block = &cfg.blocks[b];
+        const std::vector<size_t>& in = predecessors[it->first];
+
+        failed |= block->start != it->first || block->end != it->second.end || block->first != it->second.first ||
+            block->instruction_count != it->second.instruction_count || block->flow != it->second.flow ||
+            block->predecessor_count != in.size();
+        for (size_t p = 0; !failed && p < in.size(); p++) {
+            failed |= block->predecessors[p] != &cfg.edges[in[p]];
+        }
+
+        // Lookups at the first and last byte, and just past the end when that is a gap
+        failed |= x86_cfg_block(&cfg, block->start) != block || x86_cfg_block(&cfg, block->end - 1) != block;
+        if (!blocks.count(block->end)) {
+            failed |= x86_cfg_block(&cfg, block->end) != NULL;
+        }
+    }
+    for (size_t e = 0; !failed && e < edges.size(); e++) {
+        const BlockEdge* edge = &cfg.edges[e];
+
+        failed |= edge->from->start != edges[e].from || edge->to->start != edges[e].to || edge->type != edges[e].type ||
+            edge < edge->from->successors || edge >= edge->from->successors + edge->from->successor_count;
+    }
+    if (!failed && !insns.empty()) {
+        failed |= x86_cfg_block(&cfg, insns[0].address - 1) != NULL;
+    }
+
+    printf("  %-28s %8zu instructions, %7zu blocks, %7zu edges%s\n", name, insns.size(), blocks.size(), edges.size(),
+        failed ? ", MISMATCH" : "");
+    x86_arena_free(&arena);
+    return failed;
+}
+
+static int command_check_cfg(const char* path) {
+    struct Input {
+        const char* name;
+        DisasmMode mode;
+        std::vector<uint8_t> code;
+    };
+    std::vector<Input> inputs;
+    int mismatches = 0;
+
+    inputs.push_back({ "common encodings", DISASM_MODE_64, build_corpus(256 * 1024, g_corpus_mix) });
+    inputs.push_back({ "random bytes", DISASM_MODE_64, random_bytes(256 * 1024 + 3, 43) });
+    inputs.push_back({ "random bytes, 32-bit", DISASM_MODE_32, random_bytes(128 * 1024 + 1, 47) });
+    if (path) {
+        std::vector<uint8_t> code = read_code(path);
+        if (code.empty()) {
+            printf("error: cannot read %s\n", path);
+            return 1;
+        }
+        inputs.push_back({ path, DISASM_MODE_64, code });
+    }
+
+    printf("control flow graph against a naive builder\n");
+    for (size_t n = 0; n < inputs.size(); n++) {
+        std::vector<DecodedInstruction> sweep(inputs[n].code.size());
+        std::vector<DecodedInstruction> gaps;
+        std::vector<DecodedInstruction> sparse;
+        std::string name;
+
+        sweep.resize(x86_disasm_batch_mode(inputs[n].mode, inputs[n].code.data(), inputs[n].code.size(), 0x1000,
+            sweep.data(), sweep.size(), NULL));
+        for (size_t i = 0; i < sweep.size(); i++) {
+            if (i % 7 != 3) {
+                gaps.push_back(sweep[i]);
+            }
+            // Runs of 16 records far apart, too few for the bitmaps
+            if ((i / 16) % 64 == 0) {
+                sparse.push_back(sweep[i]);
+            }
+        }
+
+        mismatches += check_cfg(inputs[n].name, sweep);
+        name = std::string(inputs[n].name) + ", gaps";
+        mismatches += check_cfg(name.c_str(), gaps);
+        name = std::string(inputs[n].name) + ", sparse";
+        mismatches += check_cfg(name.c_str(), sparse);
+    }
+
+    return mismatches ? 1 : 0;
+}
+
+/*
+ * Self-check: function discovery on stripped fixtures
+ *
+ * fixtures/elf64.bin and fixtures/elf32.bin are built from
+ * fixtures/functions.c (the command line is in that file) and keep their
+ * symbols; the PE32+ fixtures list their functions in .pdata. Discovery
+ * runs with that list hidden, as on a stripped image, and is scored
+ * against it: it must find FUNCTIONS_MIN_RECALL percent of the listed
+ * starts, and FUNCTIONS_MIN_PRECISION percent of what it reports must be
+ * listed. Jump table cases after a ret are the usual false starts.
+ */
+#define FUNCTIONS_MIN_RECALL     90
+#define FUNCTIONS_MIN_PRECISION  80
+
+struct FunctionFixture {
+    const char* file;
+    unsigned int map_flags;
+};
+
+static const FunctionFixture g_function_fixtures[] = {
+    { "elf64.bin", DISASM_MAP_DEFAULT },
+    { "elf32.bin", DISASM_MAP_DEFAULT },
+    { "pe64.exe", DISASM_MAP_DEFAULT },
+    { "pe64_mapped.bin", DISASM_MAP_MEMORY_LAYOUT },
+};
+
+static int command_check_functions(const char* directory) {
+    int failures = 0;
+
+    printf("function discovery on stripped fixtures in %s: at least %d%% found, %d%% of those reported listed\n",
+        directory, FUNCTIONS_MIN_RECALL, FUNCTIONS_MIN_PRECISION);
+    for (size_t i = 0; i < sizeof(g_function_fixtures) / sizeof(g_function_fixtures[0]); i++) {
+        const FunctionFixture* fixture = &g_function_fixtures[i];
+        FunctionRange* functions;
+        size_t count;
+        char path[1024];
+        LoadedImage image;
+
+        snprintf(path, sizeof(path), "%s/%s", directory, fixture->file);
+        DisasmImageStatus status = x86_image_load(path, fixture->map_flags, &image);
+        if (status != DISASM_IMAGE_OK) {
+            printf("  %-20s cannot load (status %d), MISMATCH\n", fixture->file, (int)status);
+            x86_image_free(&image);
+            failures++;
+            continue;
+        }
+
+        LoadedImage stripped = image;
+        stripped.functions = NULL;
+        stripped.function_count = 0;
+        if (!x86_find_functions(&stripped, 0, &functions, &count)) {
+            printf("error: out of memory\n");
+            x86_image_free(&image);
+            return 1;
+        }
+
+        FunctionScore score = score_functions(&image, functions, count);
+        int passed = score.known > 0 &&
+            score.found * 100 >= score.known * FUNCTIONS_MIN_RECALL &&
+            score.found * 100 >= count * FUNCTIONS_MIN_PRECISION;
+        printf("  %-20s %4zu listed, %4zu found (%3zu%%), %4zu reported (%3zu%% listed)%s\n", fixture->file,
+            score.known, score.found, score.known ? score.found * 100 / score.known : 0, count,
+            count ? score.found * 100 / count : 0, passed ? "" : ", BELOW THRESHOLD");
+        failures += !passed;
+
+        x86_functions_free(functions);
+        x86_image_free(&image);
+    }
+    return failures ? 1 : 0;
+}
+
+static void usage() {
+    printf("usage: DisassemblerTester bench [file]\n");
+    printf("       DisassemblerTester disasm <image> [att]\n");
+    printf("       DisassemblerTester sweep <image>\n");
+    printf("       DisassemblerTester descent <image>\n");
+    printf("       DisassemblerTester functions <image>\n");
+    printf("       DisassemblerTester xrefs <image> [index file]\n");
+    printf("       DisassemblerTester patch <image>\n");
+    printf("       DisassemblerTester stream <file | ->\n");
+    printf("       DisassemblerTester store <image> <store file>\n");
+    printf("       DisassemblerTester index <image>\n");
+    printf("       DisassemblerTester signatures <image> [pattern...]\n");
+    printf("       DisassemblerTester check-pe [fixtures directory]\n");
+    printf("       DisassemblerTester check-sweep [file]\n");
+    printf("       DisassemblerTester check-xrefs [file] [index file]\n");
+    printf("       DisassemblerTester check-cache [file]\n");
+    printf("       DisassemblerTester check-listing [file]\n");
+    printf("       DisassemblerTester check-stream [file]\n");
+    printf("       DisassemblerTester check-signatures [file]\n");
+    printf("       DisassemblerTester check-decode [bytes]\n");
+    printf("       DisassemblerTester check-descent [image]\n");
+    printf("       DisassemblerTester check-cfg [file]\n");
+    printf("       DisassemblerTester check-functions [fixtures directory]\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+
+    if (strcmp(argv[1], "bench") == 0) {
+        std::vector<uint8_t> code = argc > 2 ? read_code(argv[2]) : build_corpus(16 << 20, g_corpus_mix);
+        if (code.empty()) {
+            printf("error: cannot read %s\n", argv[2]);
+            return 1;
+        }
+        int status = bench_length(code, 4);
+        bench_scan(code, 4);
+        bench_packed(code, 4);
+        bench_modes(code, 4);
+        bench_corpora(code, 4);
+        bench_format(code, 4);
+        bench_operands(code, 4);
+        bench_sweep(code, 4);
+        bench_cfg(code, 4);
+        bench_cache(code, 4);
+        bench_stream(code, 4);
+        return status;
+    }
+
+    if (strcmp(argv[1], "disasm") == 0 && argc > 2) {
+        return command_disasm(argv[2], argc > 3 && strcmp(argv[3], "att") == 0 ? DISASM_FORMAT_ATT : DISASM_FORMAT_INTEL);
+    }
+
+    if (strcmp(argv[1], "sweep") == 0 && argc > 2) {
+        return command_sweep(argv[2]);
+    }
+
+    if (strcmp(argv[1], "descent") == 0 && argc > 2) {
+        return command_descent(argv[2]);
+    }
+
+    if (strcmp(argv[1], "functions") == 0 && argc > 2) {
+        return command_functions(argv[2]);
+    }
+
+    if (strcmp(argv[1], "xrefs") == 0 && argc > 2) {
+        return command_xrefs(argv[2], argc > 3 ? argv[3] : NULL);
+    }
+
+    if (strcmp(argv[1], "patch") == 0 && argc > 2) {
+        return command_patch(argv[2]);
+    }
+
+    if (strcmp(argv[1], "stream") == 0 && argc > 2) {
+        return command_stream(argv[2]);
+    }
+
+    if (strcmp(argv[1], "store") == 0 && argc > 3) {
+        return command_store(argv[2], argv[3]);
+    }
+
+    if (strcmp(argv[1], "index") == 0 && argc > 2) {
+        return command_index(argv[2]);
+    }
+
+    if (strcmp(argv[1], "signatures") == 0 && argc > 2) {
+        return command_signatures(argv[2], argc - 3, argv + 3);
+    }
+
+    if (strcmp(argv[1], "check-pe") == 0) {
+        return command_check_pe(argc > 2 ? argv[2] : "fixtures");
+    }
+
+    if (strcmp(argv[1], "check-sweep") == 0) {
+        return command_check_sweep(argc > 2 ? argv[2] : NULL);
+    }
+
+    if (strcmp(argv[1], "check-xrefs") == 0) {
+        return command_check_xrefs(argc > 2 ? argv[2] : NULL, argc > 3 ? argv[3] : NULL);
+    }
+
+    if (strcmp(argv[1], "check-cache") == 0) {
+        return command_check_cache(argc > 2 ? argv[2] : NULL);
+    }
+
+    if (strcmp(argv[1], "check-listing") == 0) {
+        return command_check_listing(argc > 2 ? argv[2] : NULL);
+    }
+
+    if (strcmp(argv[1], "check-stream") == 0) {
+        return command_check_stream(argc > 2 ? argv[2] : NULL);
+    }
+
+    if (strcmp(argv[1], "check-signatures") == 0) {
+        return command_check_signatures(argc > 2 ? argv[2] : NULL);
+    }
+
+    if (strcmp(argv[1], "check-decode") == 0) {
+        return command_check_decode(argc > 2 ? argv[2] : NULL);
+    }
+
+    if (strcmp(argv[1], "check-descent") == 0) {
+        return command_check_descent(argc > 2 ? argv[2] : NULL);
+    }
+
+    if (strcmp(argv[1], "check-cfg") == 0) {
+        return command_check_cfg(argc > 2 ? argv[2] : NULL);
+    }
+
+    if (strcmp(argv[1], "check-functions") == 0) {
+        return command_check_functions(argc > 2 ? argv[2] : "fixtures");
+    }
+
+    usage();
+    return 1;
+}
@@ -1,522 +1,1291 @@
-﻿#include <stdint.h>
-#include <stdlib.h>
-#include "Windows.h"
-#include "disassm.h"
-#include "disassm_table_op1.h"
-#include "disassm_table_op2.h"
-#include "disassm_table_groups.h"
-#include "disassm_inst_bytes.h"
-#include <string>
-
-
-
-
-/*
- * Helper functions
- */
-
- // Check if an opcode is valid for the given prefixes
-static int is_prefix_valid(uint8_t opcode, uint8_t prefix_flags) {
-    if (opcode >= OPCODE_TABLE_SIZE) {
-        return 0;
-    }
-
-    uint8_t allowed_prefixes = g_prefix_table[opcode];
-    return (allowed_prefixes & prefix_flags) != 0;
-}
-
-// Check if a lock prefix is valid for this instruction
-static int is_lock_valid(uint8_t opcode, uint8_t modrm, uint8_t opcode2, uint8_t mod) {
-    // Lock prefix is only valid for memory operands
-    if (mod == MODRM_MOD_REGISTER) {
-        return 0;
-    }
-
-    // Check if the opcode allows lock prefix
-    const uint8_t* table;
-    size_t table_size;
-
-    if (opcode2) {
-        // 2-byte opcode
-        table = g_lock_valid_2byte;
-        table_size = sizeof(g_lock_valid_2byte) / sizeof(g_lock_valid_2byte[0]);
-    }
-    else {
-        // 1-byte opcode
-        table = g_lock_valid_1byte;
-        table_size = sizeof(g_lock_valid_1byte) / sizeof(g_lock_valid_1byte[0]);
-    }
-
-    for (size_t i = 0; i < table_size; i++) {
-        if (table[i] == opcode) {
-            return 1;
-        }
-    }
-
-    return 0;
-}
-
-// Check if the operand is valid for this instruction
-static int is_operand_valid(uint8_t opcode, uint8_t opcode2, uint8_t modrm_reg, uint8_t mod) {
-    // Special cases for certain opcodes
-    if (!opcode2) {
-        // 1-byte opcodes
-        switch (opcode) {
-        case 0x8C: // MOV Sreg, r/m
-            return modrm_reg <= 5;
-        case 0x8E: // MOV r/m, Sreg
-            return modrm_reg != 1 && modrm_reg <= 5;
-        }
-    }
-    else {
-        // 2-byte opcodes
-        switch (opcode) {
-        case 0x20: // MOV r32, CRn
-        case 0x22: // MOV CRn, r32
-            return mod == MODRM_MOD_REGISTER && modrm_reg <= 4 && modrm_reg != 1;
-        case 0x21: // MOV r32, DRn
-        case 0x23: // MOV DRn, r32
-            return mod == MODRM_MOD_REGISTER && modrm_reg != 4 && modrm_reg != 5;
-        }
-    }
-
-    return 1;
-}
-
-// Check if the instruction requires ModR/M operand to be memory
-static int requires_memory_operand(uint8_t opcode, uint8_t opcode2) {
-    const uint8_t* table;
-    size_t table_size;
-
-    if (opcode2) {
-        // 2-byte opcode
-        table = g_memory_only_2byte;
-        table_size = sizeof(g_memory_only_2byte) / sizeof(g_memory_only_2byte[0]);
-    }
-    else {
-        // 1-byte opcode
-        table = g_memory_only_1byte;
-        table_size = sizeof(g_memory_only_1byte) / sizeof(g_memory_only_1byte[0]);
-    }
-
-    for (size_t i = 0; i < table_size; i++) {
-        if (table[i] == opcode) {
-            return 1;
-        }
-    }
-
-    return 0;
-}
-
-/*
- * Main disassembler function
- */
-unsigned int x86_disasm(const void* code, InstructionInfo* info) {
-    uint8_t* p = (uint8_t*)code;
-    uint8_t* start = p;
-    uint8_t c, prefix_flags = 0;
-    uint8_t opattr = 0;
-    uint8_t disp_size = 0;
-    // Clear the output structure
-    memset(info, 0, sizeof(InstructionInfo));
-
-    // Step 1: Parse prefixes
-    for (int i = 0; i < 16 && p - start < 15; i++) {
-        c = *p;
-        switch (c) {
-        case 0xF0: // LOCK
-            info->prefix_lock = c;
-            prefix_flags |= PREFIX_LOCK;
-            break;
-        case 0xF2: // REPNZ/REPNE
-            info->prefix_rep = c;
-            prefix_flags |= PREFIX_REPNZ;
-            break;
-        case 0xF3: // REP/REPE/REPZ
-            info->prefix_rep = c;
-            prefix_flags |= PREFIX_REP;
-            break;
-        case 0x26: // ES segment
-            info->prefix_seg = c;
-            prefix_flags |= PREFIX_SEG_ES;
-            break;
-        case 0x2E: // CS segment
-            info->prefix_seg = c;
-            prefix_flags |= PREFIX_SEG_CS;
-            break;
-        case 0x36: // SS segment
-            info->prefix_seg = c;
-            prefix_flags |= PREFIX_SEG_SS;
-            break;
-        case 0x3E: // DS segment
-            info->prefix_seg = c;
-            prefix_flags |= PREFIX_SEG_DS;
-            break;
-        case 0x64: // FS segment
-            info->prefix_seg = c;
-            prefix_flags |= PREFIX_SEG_FS;
-            break;
-        case 0x65: // GS segment
-            info->prefix_seg = c;
-            prefix_flags |= PREFIX_SEG_GS;
-            break;
-        case 0x66: // Operand size override
-            info->prefix_66 = c;
-            prefix_flags |= PREFIX_OP_SIZE;
-            break;
-        case 0x67: // Address size override
-            info->prefix_67 = c;
-            prefix_flags |= PREFIX_ADDR_SIZE;
-            break;
-        default:
-            // Not a prefix, move to next step
-            goto prefix_end;
-        }
-        p++;
-    }
-
-prefix_end:
-    // Update flags with prefix information
-    if (prefix_flags & PREFIX_REPNZ) {
-        info->flags |= FLAG_PREFIX_REPNZ;
-    }
-    if (prefix_flags & PREFIX_REP) {
-        info->flags |= FLAG_PREFIX_REP;
-    }
-    if (prefix_flags & PREFIX_OP_SIZE) {
-        info->flags |= FLAG_PREFIX_OP_SIZE;
-    }
-    if (prefix_flags & PREFIX_ADDR_SIZE) {
-        info->flags |= FLAG_PREFIX_ADDR_SIZE;
-    }
-    if (prefix_flags & PREFIX_LOCK) {
-        info->flags |= FLAG_PREFIX_LOCK;
-    }
-    if (prefix_flags & (PREFIX_SEG_CS | PREFIX_SEG_SS | PREFIX_SEG_DS |
-        PREFIX_SEG_ES | PREFIX_SEG_FS | PREFIX_SEG_GS)) {
-        info->flags |= FLAG_PREFIX_SEG;
-    }
-
-    // If no prefixes were found, set the NONE flag
-    if (!prefix_flags) {
-        prefix_flags = PREFIX_NONE;
-    }
-
-    // Step 2: Parse REX prefix (64-bit mode only)
-    int has_rex = 0;
-    int op64 = 0;
-
-    if (REX_IS_REX(c)) {
-        has_rex = 1;
-        SET_FLAG(info->flags, FLAG_PREFIX_REX);
-        info->rex = c;
-        info->rex_w = REX_W(c) ? 1 : 0;
-        info->rex_r = REX_R(c) ? 1 : 0;
-        info->rex_x = REX_X(c) ? 1 : 0;
-        info->rex_b = REX_B(c) ? 1 : 0;
-
-        // Check for 64-bit operand
-        if (info->rex_w && (*p & 0xF8) == 0xB8) {
-            op64 = 1;
-        }
-
-        p++;
-        c = *p;
-
-        // Invalid: two REX prefixes
-        if (REX_IS_REX(c)) {
-            SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_OPCODE);
-            info->opcode = c;
-            p++;
-            goto done;
-        }
-    }
-
-    // Step 3: Get opcode
-    info->opcode = c;
-    p++;
-
-    // Check for 2-byte opcodes (0F xx)
-    if (c == 0x0F) {
-        if (p - start >= 15) {
-            info->flags |= FLAG_ERROR | FLAG_ERROR_LENGTH;
-            goto done;
-        }
-
-        info->opcode2 = *p;
-        p++;
-    }
-    else if (c >= 0xA0 && c <= 0xA3) {
-        // Special cases for MOV instructions
-        op64 = 1;
-
-        // Adjust prefixes for memory addressing
-        if (prefix_flags & PREFIX_ADDR_SIZE) {
-            prefix_flags |= PREFIX_OP_SIZE;
-        }
-        else {
-            prefix_flags &= ~PREFIX_OP_SIZE;
-        }
-    }
-
-    // Step 4: Get opcode attributes
-    opattr = 0;
-    if (info->opcode2) {
-        opattr = g_opcode2_table[info->opcode2];
-    }
-    else {
-        opattr = g_opcode_table[info->opcode];
-    }
-
-    // Check for invalid opcode
-    if (opattr == OPATTR_ERROR) {
-        info->flags |= FLAG_ERROR | FLAG_ERROR_OPCODE;
-
-        // Special case for INT3, INTO, etc.
-        if ((info->opcode & ~0x03) == 0xCC) {
-            opattr = OPATTR_NONE;
-        }
-        else {
-            goto done;
-        }
-    }
-
-    // Check for opcode groups (like Grp1, Grp2, etc.)
-    if (HAS_ATTR(opattr, OPATTR_GROUP)) {
-        uint8_t group_index = g_group_index_table[info->opcode];
-        uint8_t group_opattr = g_group_opattr_table[group_index][info->modrm_reg];
-        opattr = group_opattr;
-    }
-
-    // Step 5: Parse ModR/M byte if present
-    disp_size = 0;
-
-    if (HAS_ATTR(opattr, OPATTR_MODRM)) {
-        if (p - start >= 15) {
-            SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_LENGTH);
-            goto done;
-        }
-
-        SET_FLAG(info->flags, FLAG_MODRM);
-        info->modrm = *p++;
-        info->modrm_mod = MODRM_MOD(info->modrm);
-        info->modrm_reg = MODRM_REG(info->modrm);
-        info->modrm_rm = MODRM_RM(info->modrm);
-
-        // Apply REX extensions
-        if (has_rex) {
-            if (info->rex_r) {
-                info->modrm_reg |= 0x08;  // Apply REX.R extension
-            }
-            if (info->rex_b) {
-                info->modrm_rm |= 0x08;   // Apply REX.B extension
-            }
-        }
-
-        // Validate operands
-        if (!is_operand_valid(info->opcode, info->opcode2, info->modrm_reg, info->modrm_mod)) {
-            info->flags |= FLAG_ERROR | FLAG_ERROR_OPERAND;
-        }
-
-        // Check if lock prefix is valid
-        if ((prefix_flags & PREFIX_LOCK) &&
-            !is_lock_valid(info->opcode, info->modrm, info->opcode2, info->modrm_mod)) {
-            info->flags |= FLAG_ERROR | FLAG_ERROR_LOCK;
-        }
-
-        // Check for memory-only instructions
-        if (info->modrm_mod == 3 && requires_memory_operand(info->opcode, info->opcode2)) {
-            info->flags |= FLAG_ERROR | FLAG_ERROR_OPERAND;
-        }
-
-        // Handle FPU instructions (D8-DF)
-        if (!info->opcode2 && info->opcode >= 0xD8 && info->opcode <= 0xDF) {
-            uint8_t fpu_index = info->opcode - 0xD8;
-            uint8_t fpu_opattr;
-
-            if (info->modrm_mod == 3) {
-                fpu_opattr = g_fpu_mod3_table[fpu_index][info->modrm_reg];
-            }
-            else {
-                fpu_opattr = g_fpu_mod01_table[fpu_index];
-            }
-
-            if (fpu_opattr == OPATTR_ERROR) {
-                info->flags |= FLAG_ERROR | FLAG_ERROR_OPCODE;
-            }
-        }
-
-        // Process SIB byte if needed
-        if (info->modrm_mod != MODRM_MOD_REGISTER && info->modrm_rm == MODRM_RM_SIB) {
-            if (p - start >= 15) {
-                SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_LENGTH);
-                goto done;
-            }
-
-            SET_FLAG(info->flags, FLAG_SIB);
-            info->sib = *p++;
-            info->sib_scale = SIB_SCALE(info->sib);
-            info->sib_index = SIB_INDEX(info->sib);
-            info->sib_base = SIB_BASE(info->sib);
-
-            // Apply REX extensions
-            if (has_rex) {
-                if (info->rex_x) {
-                    info->sib_index |= 0x08;  // Apply REX.X extension
-                }
-                if (info->rex_b) {
-                    info->sib_base |= 0x08;   // Apply REX.B extension
-                }
-            }
-
-            // No base or base is EBP/RBP/R13: needs displacement
-            if (info->sib_base == SIB_BASE_DISP && info->modrm_mod == MODRM_MOD_INDIRECT) {
-                disp_size = 4;
-            }
-        }
-
-        // Calculate displacement size
-        switch (info->modrm_mod) {
-        case MODRM_MOD_INDIRECT:
-            // No displacement except for special cases
-            if (info->modrm_rm == MODRM_RM_DISP32) {
-                // [EBP/RBP/R13] or RIP-relative
-                disp_size = HAS_PREFIX(prefix_flags, PREFIX_ADDR_SIZE) ? 2 : 4;
-            }
-            break;
-
-        case MODRM_MOD_DISP8:
-            // 8-bit displacement
-            disp_size = 1;
-            break;
-
-        case MODRM_MOD_DISP32:
-            // 16/32-bit displacement
-            disp_size = HAS_PREFIX(prefix_flags, PREFIX_ADDR_SIZE) ? 2 : 4;
-            break;
-        }
-
-        // Process displacement
-        if (disp_size > 0) {
-            if (p - start + disp_size > 15) {
-                SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_LENGTH);
-                goto done;
-            }
-
-            switch (disp_size) {
-            case 1:
-                SET_FLAG(info->flags, FLAG_DISP8);
-                info->displacement.disp8 = *p;
-                break;
-
-            case 2:
-                SET_FLAG(info->flags, FLAG_DISP16);
-                info->displacement.disp16 = *(uint16_t*)p;
-                break;
-
-            case 4:
-                SET_FLAG(info->flags, FLAG_DISP32);
-                info->displacement.disp32 = *(uint32_t*)p;
-                break;
-            }
-
-            p += disp_size;
-        }
-    }
-    else if (HAS_PREFIX(prefix_flags, PREFIX_LOCK)) {
-        // Lock prefix without ModR/M is invalid
-        SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_LOCK);
-    }
-
-    // Step 6: Process immediate values
-    if (opattr & OPATTR_IMM_P66) {
-        // Size depends on prefixes and mode
-        if (opattr & OPATTR_REL32) {
-            // Relative jump/call
-            if (prefix_flags & PREFIX_OP_SIZE) {
-                // 16-bit offset
-                info->flags |= FLAG_IMM16 | FLAG_RELATIVE;
-                info->immediate.imm16 = *(uint16_t*)p;
-                p += 2;
-            }
-            else {
-                // 32-bit offset
-                info->flags |= FLAG_IMM32 | FLAG_RELATIVE;
-                info->immediate.imm32 = *(uint32_t*)p;
-                p += 4;
-            }
-        }
-        else {
-            // Regular immediate
-            if (op64) {
-                // 64-bit immediate
-                info->flags |= FLAG_IMM64;
-                info->immediate.imm64 = *(uint64_t*)p;
-                p += 8;
-            }
-            else if (!(prefix_flags & PREFIX_OP_SIZE)) {
-                // 32-bit immediate
-                info->flags |= FLAG_IMM32;
-                info->immediate.imm32 = *(uint32_t*)p;
-                p += 4;
-            }
-            else {
-                // 16-bit immediate
-                info->flags |= FLAG_IMM16;
-                info->immediate.imm16 = *(uint16_t*)p;
-                p += 2;
-            }
-        }
-    }
-    else if (opattr & OPATTR_IMM16) {
-        // 16-bit immediate
-        info->flags |= FLAG_IMM16;
-        info->immediate.imm16 = *(uint16_t*)p;
-        p += 2;
-    }
-    else if (opattr & OPATTR_IMM8) {
-        // 8-bit immediate
-        info->flags |= FLAG_IMM8;
-        info->immediate.imm8 = *p++;
-    }
-    else if (opattr & OPATTR_REL32) {
-        // 32-bit relative offset
-        info->flags |= FLAG_IMM32 | FLAG_RELATIVE;
-        info->immediate.imm32 = *(uint32_t*)p;
-        p += 4;
-    }
-    else if (opattr & OPATTR_REL8) {
-        // 8-bit relative offset
-        info->flags |= FLAG_IMM8 | FLAG_RELATIVE;
-        info->immediate.imm8 = *p++;
-    }
-
-done:
-    info->length = (uint8_t)(p - start);
-
-    // Check for oversized instructions
-    if (info->length > 15) {
-        SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_LENGTH);
-        info->length = 15;
-    }
-
-    // Copy the instruction bytes
-    memcpy(info->bytes, start, info->length);
-
-    return info->length;
-
-done:
-    // Calculate instruction length
-    info->length = (uint8_t)(p - start);
-
-    // Check for oversized instructions
-    if (info->length > 15) {
-        SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_LENGTH);
-        info->length = 15;
-    }
-
-    // Copy the instruction bytes
-    memcpy(info->bytes, start, info->length);
-
-    return info->length;
-}
\ No newline at end of file
+﻿#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "disassm.h"
+#include "disassm_table_op1.h"
+#include "disassm_table_op2.h"
+#include "disassm_table_groups.h"
+#include "disassm_table_decode.h"
+#include "disassm_table_modes.h"
+#include "disassm_table_vex.h"
+#include "disassm_inst_bytes.h"
+
+#if defined(_MSC_VER)
+#define DISASM_FORCEINLINE __forceinline
+#define DISASM_NOINLINE __declspec(noinline)
+#else
+#define DISASM_FORCEINLINE inline __attribute__((always_inline))
+#define DISASM_NOINLINE __attribute__((noinline))
+#endif
+
+/*
+ * Helper functions
+ */
+
+ // Check if an opcode is valid for the given prefixes
+static int is_prefix_valid(uint8_t opcode, uint8_t prefix_flags) {
+    if (opcode >= OPCODE_TABLE_SIZE) {
+        return 0;
+    }
+
+    uint8_t allowed_prefixes = g_prefix_table[opcode];
+    return (allowed_prefixes & prefix_flags) != 0;
+}
+
+// Check if the operand is valid for this instruction
+static int is_operand_valid(uint8_t map, uint8_t opcode, uint8_t modrm_reg, uint8_t mod) {
+    // Special cases for certain opcodes
+    if (map == 0) {
+        // 1-byte opcodes
+        switch (opcode) {
+        case 0x8C: // MOV Sreg, r/m
+            return modrm_reg <= 5;
+        case 0x8E: // MOV r/m, Sreg
+            return modrm_reg != 1 && modrm_reg <= 5;
+        }
+    }
+    else {
+        // 2-byte opcodes
+        switch (opcode) {
+        case 0x20: // MOV r32, CRn
+        case 0x22: // MOV CRn, r32
+            return mod == MODRM_MOD_REGISTER && modrm_reg <= 4 && modrm_reg != 1;
+        case 0x21: // MOV r32, DRn
+        case 0x23: // MOV DRn, r32
+            return mod == MODRM_MOD_REGISTER && modrm_reg != 4 && modrm_reg != 5;
+        }
+    }
+
+    return 1;
+}
+
+/*
+ * Immediate size in bytes
+ *
+ * Combined with conditional moves rather than an if/else chain. IMM16
+ * together with IMM8 is ENTER (imm16, imm8); IMM_P66 together with IMM16
+ * is a far pointer (offset, then a 16-bit selector). REX.W takes
+ * precedence over 66: an imm16/32 operand is then 4 bytes.
+ */
+template <DisasmMode Mode>
+static DISASM_FORCEINLINE unsigned int immediate_size(uint8_t opattr, uint8_t decode_state,
+    unsigned int op64, unsigned int rex_w, unsigned int prefix_66, unsigned int prefix_67) {
+    unsigned int operand_size = (ModeTraits<Mode>::operand16 ^ prefix_66) && !rex_w ? 2 : 4;
+    unsigned int rel_size = ModeTraits<Mode>::rel_operand_size ? operand_size : 4;
+    unsigned int size = (opattr & OPATTR_REL8) ? 1 : 0;
+    size = (opattr & OPATTR_REL32) ? rel_size : size;
+    size = (opattr & OPATTR_IMM8) ? 1 : size;
+    size = (opattr & OPATTR_IMM16) ? 2 + (opattr & OPATTR_IMM8 ? 1 : 0) : size;
+    if (opattr & OPATTR_IMM_P66) {
+        // REX.W B8-BF take a full 64-bit immediate
+        size = op64 ? 8 : operand_size + ((opattr & OPATTR_IMM16) ? 2 : 0);
+    }
+    if (decode_state & DECODE_MOFFS) {
+        size = prefix_67 ? ModeTraits<Mode>::address_size_67 : ModeTraits<Mode>::address_size;
+    }
+    return size;
+}
+
+// Immediate flags by immediate size
+static const uint32_t g_imm_size_flags[9] = {
+    0, FLAG_IMM8, FLAG_IMM16, FLAG_IMM16 | FLAG_IMM8, FLAG_IMM32, 0, 0, 0, FLAG_IMM64
+};
+
+static DISASM_FORCEINLINE uint32_t immediate_flags(uint8_t opattr, uint8_t decode_state, unsigned int imm_size) {
+    if (HAS_ATTR(opattr, OPATTR_IMM_P66) && HAS_ATTR(opattr, OPATTR_IMM16)) {
+        return FLAG_FAR_POINTER | (imm_size == 4 ? FLAG_IMM16 : FLAG_IMM32);
+    }
+    return g_imm_size_flags[imm_size] | (HAS_ATTR(decode_state, DECODE_MOFFS) ? FLAG_MOFFS : 0);
+}
+
+/*
+ * VEX/EVEX/XOP prefix detection
+ *
+ * C4, C5 and 62 start a vector prefix in 64-bit mode, where LES, LDS and
+ * BOUND do not exist; elsewhere only when the next byte would be a
+ * register-form ModR/M, which those instructions do not accept. 8F starts
+ * an XOP prefix when the map field is 8 or above, which POP r/m (reg field
+ * 000) cannot encode.
+ */
+template <DisasmMode Mode>
+static DISASM_FORCEINLINE int is_vector_prefix(uint8_t lead, uint8_t next) {
+    if (lead == XOP_PREFIX) {
+        return VEX_MAP(next) >= XOP_MAP_MIN;
+    }
+    return Mode == DISASM_MODE_64 || MODRM_MOD(next) == MODRM_MOD_REGISTER;
+}
+
+// Prefix kind and payload size (bytes after the lead byte) of a vector prefix
+#define VECTOR_KIND(lead) \
+    ((lead) == EVEX_PREFIX ? VECTOR_EVEX : (lead) == XOP_PREFIX ? VECTOR_XOP : VECTOR_VEX)
+#define VECTOR_PAYLOAD(lead) \
+    ((lead) == VEX_PREFIX_2BYTE ? 1U : (lead) == EVEX_PREFIX ? 3U : 2U)
+
+/*
+ * EVEX compressed displacement scale (disp8*N)
+ */
+static uint8_t evex_disp_scale(uint8_t map, uint8_t opcode, uint8_t modrm,
+    unsigned int pp, unsigned int vl, unsigned int w, unsigned int bcst) {
+    unsigned int tuple = g_evex_tuple_table.tuple[map & 7][pp][opcode];
+    unsigned int vector = 16U << (vl < 2 ? vl : 2);
+    unsigned int element = w ? 8 : 4;
+
+    // VPSRLDQ/VPSLLDQ (0F 73 /3, /7) shift the whole vector
+    if (map == OPCODE_MAP_0F && opcode == 0x73 && (MODRM_REG(modrm) & 3) == 3) {
+        tuple = TUPLE_FVM;
+    }
+
+    switch (tuple) {
+    case TUPLE_FV:
+        return (uint8_t)(bcst ? element : vector);
+
+    case TUPLE_FV16:
+        return (uint8_t)(bcst ? 2 : vector);
+
+    case TUPLE_HV16:
+        return (uint8_t)(bcst ? 2 : vector / 2);
+
+    case TUPLE_QV16:
+        return (uint8_t)(bcst ? 2 : vector / 4);
+
+    case TUPLE_HV:
+        return (uint8_t)(bcst ? element : w ? vector : vector / 2);
+
+    case TUPLE_FVM:
+        return (uint8_t)vector;
+
+    case TUPLE_HVM:
+        return (uint8_t)(vector / 2);
+
+    case TUPLE_QVM:
+        return (uint8_t)(vector / 4);
+
+    case TUPLE_OVM:
+        return (uint8_t)(vector / 8);
+
+    case TUPLE_T1S:
+        return (uint8_t)element;
+
+    case TUPLE_T1S_BW:
+        return (uint8_t)(w ? 2 : 1);
+
+    case TUPLE_T1F:
+        return (uint8_t)((pp & 1) ? 8 : 4);
+
+    case TUPLE_DUP:
+        return (uint8_t)(vl == 0 ? 8 : vector);
+
+    default:
+        return (uint8_t)(1U << (tuple - TUPLE_N1));
+    }
+}
+
+/*
+ * Decoder core
+ *
+ * Decodes a single instruction starting at code. The core never reads more
+ * than X86_MAX_INSTRUCTION_LENGTH bytes past code, so callers only need to
+ * guarantee a 15-byte readable window. It is force-inlined into both the
+ * single-instruction entry points and the batch loop, and instantiated once
+ * per CPU mode.
+ */
+template <DisasmMode Mode>
+static DISASM_FORCEINLINE unsigned int decode_instruction(const uint8_t* code, InstructionInfo* info) {
+    const uint8_t* p = code;
+    const uint8_t* start = p;
+    uint8_t c = 0;
+    uint32_t prefix_flags = 0;
+    uint8_t opattr = 0;
+    uint8_t decode_state = 0;
+    uint8_t map = 0;
+    uint8_t map_opcode = 0;
+    uint8_t disp_size = 0;
+    uint8_t imm_size = 0;
+    unsigned int address16 = 0;
+    int has_rex = 0;
+    int op64 = 0;
+    int evex = 0;
+    uint8_t evex_p0 = 0;
+    // Clear the output structure
+    memset(info, 0, sizeof(InstructionInfo));
+
+    // Step 1: Parse prefixes
+    while (p - start < X86_MAX_INSTRUCTION_LENGTH) {
+        c = *p;
+        uint32_t prefix_class = g_prefix_class_table[c];
+        if (!prefix_class) {
+            goto prefix_end;
+        }
+
+        // Record the byte in its prefix field and accumulate the masks
+        ((uint8_t*)info)[PREFIX_CLASS_FIELD(prefix_class)] = c;
+        prefix_flags |= prefix_class;
+        p++;
+    }
+
+    // Only prefixes in the 15-byte window
+    SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_LENGTH);
+    goto done;
+
+prefix_end:
+    // Update flags with prefix information
+    info->flags |= prefix_flags & FLAG_MASK_ANY_PREFIX;
+
+    // 16-bit addressing: 16-bit mode, or 32-bit mode with 67
+    address16 = (ModeTraits<Mode>::address_size == 2) != HAS_PREFIX(prefix_flags, PREFIX_ADDR_SIZE) &&
+        Mode != DISASM_MODE_64;
+
+    // Step 2: Parse REX prefix (64-bit mode only)
+    if (ModeTraits<Mode>::rex && REX_IS_REX(c)) {
+        has_rex = 1;
+        SET_FLAG(info->flags, FLAG_PREFIX_REX);
+        info->rex = c;
+        info->rex_w = REX_W(c) ? 1 : 0;
+        info->rex_r = REX_R(c) ? 1 : 0;
+        info->rex_x = REX_X(c) ? 1 : 0;
+        info->rex_b = REX_B(c) ? 1 : 0;
+
+        p++;
+        if (p - start >= X86_MAX_INSTRUCTION_LENGTH) {
+            SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_LENGTH);
+            goto done;
+        }
+        c = *p;
+
+        // Invalid: two REX prefixes
+        if (REX_IS_REX(c)) {
+            SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_OPCODE);
+            info->opcode = c;
+            p++;
+            goto done;
+        }
+
+        // Check for 64-bit operand (MOV r64, imm64)
+        if (info->rex_w && (c & 0xF8) == 0xB8) {
+            op64 = 1;
+        }
+    }
+
+    // Step 3: Get opcode
+    info->opcode = c;
+    map_opcode = c;
+    p++;
+
+    // Check for 2-byte opcodes (0F xx)
+    if (c == 0x0F) {
+        if (p - start >= X86_MAX_INSTRUCTION_LENGTH) {
+            info->flags |= FLAG_ERROR | FLAG_ERROR_LENGTH;
+            goto done;
+        }
+
+        map = OPCODE_MAP_0F;
+        map_opcode = *p;
+        p++;
+
+        // Check for 3-byte opcodes (0F 38 xx, 0F 3A xx)
+        if (map_opcode == 0x38 || map_opcode == 0x3A) {
+            if (p - start >= X86_MAX_INSTRUCTION_LENGTH) {
+                info->flags |= FLAG_ERROR | FLAG_ERROR_LENGTH;
+                goto done;
+            }
+
+            map = map_opcode == 0x38 ? OPCODE_MAP_0F38 : OPCODE_MAP_0F3A;
+            map_opcode = *p;
+            p++;
+        }
+        info->opcode2 = map_opcode;
+    }
+
+    // Step 4: Get opcode attributes and decode state
+    opattr = ModeTables<Mode>::maps[map][map_opcode];
+    decode_state = g_opcode_decode_table[map][map_opcode];
+
+    // VEX/EVEX/XOP: the lead byte was read as a 1-byte opcode
+    if (HAS_ATTR(decode_state, DECODE_VECTOR)) {
+        if (p - start >= X86_MAX_INSTRUCTION_LENGTH) {
+            SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_LENGTH);
+            goto done;
+        }
+
+        if (is_vector_prefix<Mode>(c, *p)) {
+            unsigned int payload = VECTOR_PAYLOAD(c);
+            uint8_t fields;
+
+            // Payload and opcode byte
+            if (p - start + payload + 1 > X86_MAX_INSTRUCTION_LENGTH) {
+                SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_LENGTH);
+                goto done;
+            }
+
+            // REX, 66, F2, F3 and LOCK may not precede a vector prefix
+            if (has_rex || HAS_PREFIX(prefix_flags, PREFIX_LOCK | PREFIX_REP | PREFIX_REPNZ | PREFIX_OP_SIZE)) {
+                info->flags |= FLAG_ERROR | FLAG_ERROR_OPCODE;
+            }
+
+            switch (c) {
+            case VEX_PREFIX_2BYTE:
+                SET_FLAG(info->flags, FLAG_VEX);
+                info->rex_r = VEX_R(p[0]);
+                fields = p[0];
+                map = OPCODE_MAP_0F;
+                break;
+
+            case EVEX_PREFIX:
+                SET_FLAG(info->flags, FLAG_EVEX);
+                evex = 1;
+                evex_p0 = p[0];
+                info->rex_r = VEX_R(p[0]);
+                info->rex_x = VEX_X(p[0]);
+                info->rex_b = VEX_B(p[0]);
+                info->rex_w = VEX_W(p[1]);
+                fields = p[1];
+                map = EVEX_MAP(p[0]);
+                info->evex_z = EVEX_Z(p[2]);
+                info->evex_b = EVEX_BCST(p[2]);
+                info->evex_aaa = EVEX_AAA(p[2]);
+                if (!(p[1] & EVEX_P1_FIXED)) {
+                    info->flags |= FLAG_ERROR | FLAG_ERROR_OPCODE;
+                }
+                break;
+
+            default:
+                SET_FLAG(info->flags, c == XOP_PREFIX ? FLAG_XOP : FLAG_VEX);
+                info->rex_r = VEX_R(p[0]);
+                info->rex_x = VEX_X(p[0]);
+                info->rex_b = VEX_B(p[0]);
+                info->rex_w = VEX_W(p[1]);
+                fields = p[1];
+                map = VEX_MAP(p[0]);
+                break;
+            }
+
+            info->vex_vvvv = (uint8_t)VEX_VVVV(fields);
+            info->vex_l = (uint8_t)VEX_L(fields);
+            info->vex_pp = (uint8_t)VEX_PP(fields);
+            if (evex) {
+                info->vex_vvvv |= (uint8_t)(EVEX_V2(p[2]) << 4);
+                info->vex_l = (uint8_t)EVEX_LL(p[2]);
+            }
+
+            p += payload;
+            map_opcode = *p++;
+            info->opcode2 = map_opcode;
+            opattr = g_vector_opcode_table.attr[g_vector_map_row[VECTOR_KIND(c)][map]][map_opcode];
+            decode_state = DECODE_NONE;
+
+            // The R/X/B bits extend the ModR/M and SIB fields like REX
+            has_rex = 1;
+
+            // 66 does not override the operand size here; the only
+            // prefix-sized immediate (XOP map 0A) is always 32 bits
+            prefix_flags = (prefix_flags & ~PREFIX_OP_SIZE) | (ModeTraits<Mode>::operand16 ? PREFIX_OP_SIZE : 0);
+        }
+    }
+    info->map = map;
+
+    // Check for invalid opcode
+    if (opattr == OPATTR_ERROR) {
+        info->flags |= FLAG_ERROR | FLAG_ERROR_OPCODE;
+        goto done;
+    }
+
+    // Step 5: Parse ModR/M byte if present
+    disp_size = 0;
+
+    if (HAS_ATTR(opattr, OPATTR_MODRM)) {
+        if (p - start >= X86_MAX_INSTRUCTION_LENGTH) {
+            SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_LENGTH);
+            goto done;
+        }
+
+        SET_FLAG(info->flags, FLAG_MODRM);
+        info->modrm = *p++;
+        info->modrm_mod = MODRM_MOD(info->modrm);
+        info->modrm_reg = MODRM_REG(info->modrm);
+        info->modrm_rm = MODRM_RM(info->modrm);
+
+        // Groups: the ModR/M reg field selects the instruction and its immediate
+        if (HAS_ATTR(opattr, OPATTR_GROUP)) {
+            opattr = GROUP_OPATTR(map, map_opcode, info->modrm);
+            if (opattr == OPATTR_ERROR) {
+                info->flags |= FLAG_ERROR | FLAG_ERROR_OPCODE;
+                opattr = OPATTR_MODRM;
+            }
+        }
+
+        // Apply REX extensions
+        if (has_rex) {
+            if (info->rex_r) {
+                info->modrm_reg |= 0x08;  // Apply REX.R extension
+            }
+            if (info->rex_b) {
+                info->modrm_rm |= 0x08;   // Apply REX.B extension
+            }
+
+            // EVEX.R' and, for register operands, EVEX.X select registers 16-31
+            if (evex) {
+                info->modrm_reg |= (uint8_t)(EVEX_R2(evex_p0) << 4);
+                if (info->modrm_mod == MODRM_MOD_REGISTER) {
+                    info->modrm_rm |= (uint8_t)(info->rex_x << 4);
+                }
+            }
+        }
+
+        // Validate operands
+        if (HAS_ATTR(decode_state, DECODE_CHECK_OPERAND) &&
+            !is_operand_valid(map, map_opcode, info->modrm_reg, info->modrm_mod)) {
+            info->flags |= FLAG_ERROR | FLAG_ERROR_OPERAND;
+        }
+
+        // Check if lock prefix is valid (lockable opcode with a memory operand)
+        if ((prefix_flags & PREFIX_LOCK) &&
+            (!HAS_ATTR(decode_state, DECODE_LOCK) || info->modrm_mod == MODRM_MOD_REGISTER)) {
+            info->flags |= FLAG_ERROR | FLAG_ERROR_LOCK;
+        }
+
+        // Check for memory-only instructions
+        if (info->modrm_mod == MODRM_MOD_REGISTER && HAS_ATTR(decode_state, DECODE_MEMORY_ONLY)) {
+            info->flags |= FLAG_ERROR | FLAG_ERROR_OPERAND;
+        }
+
+        // Handle FPU instructions (D8-DF)
+        if (HAS_ATTR(decode_state, DECODE_FPU)) {
+            uint8_t fpu_index = info->opcode - 0xD8;
+            uint8_t fpu_opattr;
+
+            if (info->modrm_mod == 3) {
+                fpu_opattr = g_fpu_mod3_table[fpu_index][MODRM_REG(info->modrm)];
+            }
+            else {
+                fpu_opattr = g_fpu_mod01_table[fpu_index];
+            }
+
+            if (fpu_opattr == OPATTR_ERROR) {
+                info->flags |= FLAG_ERROR | FLAG_ERROR_OPCODE;
+            }
+        }
+
+        if (address16) {
+            // 16-bit addressing: no SIB byte, [disp16] replaces [BP]
+            switch (info->modrm_mod) {
+            case MODRM_MOD_INDIRECT:
+                disp_size = MODRM_RM(info->modrm) == MODRM_RM_DISP16 ? 2 : 0;
+                break;
+
+            case MODRM_MOD_DISP8:
+                disp_size = 1;
+                break;
+
+            case MODRM_MOD_DISP32:
+                disp_size = 2;
+                break;
+            }
+        }
+        else {
+            // Process SIB byte if needed
+            if (info->modrm_mod != MODRM_MOD_REGISTER && MODRM_RM(info->modrm) == MODRM_RM_SIB) {
+                if (p - start >= X86_MAX_INSTRUCTION_LENGTH) {
+                    SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_LENGTH);
+                    goto done;
+                }
+
+                SET_FLAG(info->flags, FLAG_SIB);
+                info->sib = *p++;
+                info->sib_scale = SIB_SCALE(info->sib);
+                info->sib_index = SIB_INDEX(info->sib);
+                info->sib_base = SIB_BASE(info->sib);
+
+                // Apply REX extensions
+                if (has_rex) {
+                    if (info->rex_x) {
+                        info->sib_index |= 0x08;  // Apply REX.X extension
+                    }
+                    if (info->rex_b) {
+                        info->sib_base |= 0x08;   // Apply REX.B extension
+                    }
+                }
+
+                // No base or base is EBP/RBP/R13: needs displacement
+                if (SIB_BASE(info->sib) == SIB_BASE_DISP && info->modrm_mod == MODRM_MOD_INDIRECT) {
+                    disp_size = 4;
+                }
+            }
+
+            // Calculate displacement size
+            switch (info->modrm_mod) {
+            case MODRM_MOD_INDIRECT:
+                // No displacement except for special cases
+                if (MODRM_RM(info->modrm) == MODRM_RM_DISP32) {
+                    // RIP-relative in 64-bit mode, [disp32] otherwise
+                    disp_size = 4;
+                    if (Mode == DISASM_MODE_64) {
+                        info->flags |= FLAG_RIP_RELATIVE;
+                    }
+                }
+                break;
+
+            case MODRM_MOD_DISP8:
+                // 8-bit displacement
+                disp_size = 1;
+                break;
+
+            case MODRM_MOD_DISP32:
+                // 32-bit displacement
+                disp_size = 4;
+                break;
+            }
+        }
+
+        // Process displacement
+        if (disp_size > 0) {
+            if (p - start + disp_size > X86_MAX_INSTRUCTION_LENGTH) {
+                SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_LENGTH);
+                goto done;
+            }
+
+            switch (disp_size) {
+            case 1:
+                SET_FLAG(info->flags, FLAG_DISP8);
+                info->displacement.disp8 = *p;
+                break;
+
+            case 2:
+                SET_FLAG(info->flags, FLAG_DISP16);
+                info->displacement.disp16 = *(uint16_t*)p;
+                break;
+
+            case 4:
+                SET_FLAG(info->flags, FLAG_DISP32);
+                info->displacement.disp32 = *(uint32_t*)p;
+                break;
+            }
+
+            p += disp_size;
+        }
+
+        // EVEX memory operands: disp8 is scaled by the access size
+        if (evex && info->modrm_mod != MODRM_MOD_REGISTER) {
+            info->disp_scale = evex_disp_scale(map, map_opcode, info->modrm, info->vex_pp,
+                info->vex_l, info->rex_w, info->evex_b);
+        }
+    }
+    else if (HAS_PREFIX(prefix_flags, PREFIX_LOCK)) {
+        // Lock prefix without ModR/M is invalid
+        SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_LOCK);
+    }
+
+    // Step 6: Process immediate values
+    imm_size = (uint8_t)immediate_size<Mode>(opattr, decode_state, op64, info->rex_w,
+        HAS_PREFIX(prefix_flags, PREFIX_OP_SIZE), HAS_PREFIX(prefix_flags, PREFIX_ADDR_SIZE));
+
+    if (opattr & (OPATTR_REL8 | OPATTR_REL32)) {
+        info->flags |= FLAG_RELATIVE;
+    }
+
+    if (imm_size > 0) {
+        if (p - start + imm_size > X86_MAX_INSTRUCTION_LENGTH) {
+            SET_FLAG(info->flags, FLAG_ERROR | FLAG_ERROR_LENGTH);
+            goto done;
+        }
+
+        // Values are stored little-endian from the start of the union;
+        // far pointers and ENTER keep their second operand above the first
+        memcpy(&info->immediate, p, imm_size);
+        info->flags |= immediate_flags(opattr, decode_state, imm_size);
+
+        p += imm_size;
+    }
+
+done:
+    // Calculate instruction length
+    info->length = (uint8_t)(p - start);
+
+    // Copy the instruction bytes
+    memcpy(info->bytes, start, info->length);
+
+    return info->length;
+}
+
+/*
+ * Main disassembler function
+ */
+unsigned int x86_disasm(const void* code, InstructionInfo* info) {
+    return decode_instruction<DISASM_MODE_64>((const uint8_t*)code, info);
+}
+
+/*
+ * Per-mode disassembler functions
+ */
+unsigned int x86_disasm64(const void* code, InstructionInfo* info) {
+    return decode_instruction<DISASM_MODE_64>((const uint8_t*)code, info);
+}
+
+unsigned int x86_disasm32(const void* code, InstructionInfo* info) {
+    return decode_instruction<DISASM_MODE_32>((const uint8_t*)code, info);
+}
+
+unsigned int x86_disasm16(const void* code, InstructionInfo* info) {
+    return decode_instruction<DISASM_MODE_16>((const uint8_t*)code, info);
+}
+
+/*
+ * Function to resolve the absolute target of an instruction
+ *
+ * Relative branches target the next instruction plus the sign-extended
+ * immediate, truncated to the operand size outside 64-bit mode.
+ * RIP-relative operands address the next instruction plus disp32 (EIP with
+ * the 67 prefix). Returns 0 for other instructions.
+ */
+template <DisasmMode Mode>
+static DISASM_FORCEINLINE uint64_t resolve_target(const InstructionInfo* info, uint64_t address) {
+    uint64_t next = address + info->length;
+    uint32_t flags = info->flags;
+
+    if (flags & FLAG_RELATIVE) {
+        int64_t rel = (flags & FLAG_IMM8) ? (int8_t)info->immediate.imm8 :
+            (flags & FLAG_IMM16) ? (int16_t)info->immediate.imm16 : (int32_t)info->immediate.imm32;
+        uint64_t target = next + (uint64_t)rel;
+
+        if (Mode != DISASM_MODE_64) {
+            target &= (ModeTraits<Mode>::operand16 != 0) != (info->prefix_66 != 0) ? 0xFFFF : 0xFFFFFFFF;
+        }
+        return target;
+    }
+
+    if (flags & FLAG_RIP_RELATIVE) {
+        uint64_t target = next + (uint64_t)(int64_t)(int32_t)info->displacement.disp32;
+        return info->prefix_67 ? target & 0xFFFFFFFF : target;
+    }
+
+    return 0;
+}
+
+/*
+ * Batch disassembler function
+ *
+ * Instructions are decoded straight from the buffer while at least
+ * X86_MAX_INSTRUCTION_LENGTH bytes remain. The last few instructions are
+ * decoded from a zero-padded copy of the remaining bytes, so the decoder
+ * never reads past the end of the buffer.
+ */
+template <DisasmMode Mode>
+static size_t disasm_batch(const void* code, size_t length, uint64_t address,
+    DecodedInstruction* out, size_t max_count, DisasmBatchResult* result) {
+    const uint8_t* base = (const uint8_t*)code;
+    size_t offset = 0;
+    size_t count = 0;
+    DisasmStopReason reason = DISASM_STOP_END;
+
+    // Fast path: a full instruction window is always available
+    while (length - offset >= X86_MAX_INSTRUCTION_LENGTH) {
+        if (count == max_count) {
+            reason = DISASM_STOP_FULL;
+            goto stop;
+        }
+
+        DecodedInstruction* insn = &out[count++];
+        insn->address = address + offset;
+        offset += decode_instruction<Mode>(base + offset, &insn->info);
+        insn->target = resolve_target<Mode>(&insn->info, insn->address);
+    }
+
+    // Checked tail path: decode from a padded copy of the remaining bytes
+    while (offset < length) {
+        uint8_t window[X86_MAX_INSTRUCTION_LENGTH] = { 0 };
+        size_t remaining = length - offset;
+
+        if (count == max_count) {
+            reason = DISASM_STOP_FULL;
+            goto stop;
+        }
+
+        memcpy(window, base + offset, remaining);
+
+        DecodedInstruction* insn = &out[count];
+        unsigned int insn_length = decode_instruction<Mode>(window, &insn->info);
+        if (insn_length > remaining) {
+            // The instruction continues past the end of the buffer
+            reason = DISASM_STOP_TRUNCATED;
+            goto stop;
+        }
+
+        insn->address = address + offset;
+        insn->target = resolve_target<Mode>(&insn->info, insn->address);
+        offset += insn_length;
+        count++;
+    }
+
+stop:
+    if (result) {
+        result->count = count;
+        result->offset = offset;
+        result->address = address + offset;
+        result->reason = reason;
+    }
+
+    return count;
+}
+
+size_t x86_disasm_batch(const void* code, size_t length, uint64_t address,
+    DecodedInstruction* out, size_t max_count, DisasmBatchResult* result) {
+    return disasm_batch<DISASM_MODE_64>(code, length, address, out, max_count, result);
+}
+
+size_t x86_disasm_batch_mode(DisasmMode mode, const void* code, size_t length, uint64_t address,
+    DecodedInstruction* out, size_t max_count, DisasmBatchResult* result) {
+    switch (mode) {
+    case DISASM_MODE_16:
+        return disasm_batch<DISASM_MODE_16>(code, length, address, out, max_count, result);
+
+    case DISASM_MODE_32:
+        return disasm_batch<DISASM_MODE_32>(code, length, address, out, max_count, result);
+
+    default:
+        return disasm_batch<DISASM_MODE_64>(code, length, address, out, max_count, result);
+    }
+}
+
+/*
+ * Packed record conversion
+ */
+
+// Operand sizes by FLAG_IMM8..FLAG_IMM64 >> 2 and FLAG_DISP8..FLAG_DISP32 >> 6
+static const uint8_t g_flag_imm_size[16] = { 0, 1, 2, 3, 4, 0, 0, 0, 8, 0, 0, 0, 0, 0, 0, 0 };
+static const uint8_t g_flag_disp_size[8] = { 0, 1, 2, 0, 4, 0, 0, 0 };
+
+static DISASM_FORCEINLINE void pack_instruction(const InstructionInfo* info, uint32_t offset,
+    PackedInstruction* out) {
+    uint32_t flags = info->flags;
+    unsigned int imm_size = g_flag_imm_size[(flags & FLAG_MASK_ANY_IMM) >> 2] + ((flags & FLAG_FAR_POINTER) ? 2 : 0);
+    unsigned int disp_size = g_flag_disp_size[(flags & FLAG_MASK_ANY_DISP) >> 6];
+    unsigned int imm_offset = info->length - imm_size;
+    unsigned int disp_offset = imm_offset - disp_size;
+    unsigned int vector = (flags & FLAG_MASK_ANY_VECTOR) != 0;
+
+    out->offset = offset;
+    out->length = info->length;
+    out->map = info->map;
+    out->opcode = info->map ? info->opcode2 : info->opcode;
+    out->modrm = info->modrm;
+    out->sib = info->sib;
+    out->rex = vector ? (uint8_t)(REX_PREFIX_VALUE | info->rex_w << 3 | info->rex_r << 2 |
+        info->rex_x << 1 | info->rex_b) : info->rex;
+
+    // Each recorded prefix byte maps back to its PrefixMask bit; absent
+    // prefixes are recorded as 0, which is not a prefix
+    out->prefixes = (uint16_t)(((g_prefix_class_table[info->prefix_lock] |
+        g_prefix_class_table[info->prefix_rep] |
+        g_prefix_class_table[info->prefix_seg] |
+        g_prefix_class_table[info->prefix_66] |
+        g_prefix_class_table[info->prefix_67]) & PREFIX_ANY) |
+        (info->rex ? PREFIX_REX : 0));
+
+    out->disp = (uint8_t)(disp_size ? (disp_size << 4) | disp_offset : 0);
+    out->imm = (uint8_t)(imm_size ? (imm_size << 4) | imm_offset : 0);
+    out->flags = (uint16_t)((flags & (FLAG_MODRM | FLAG_SIB)) |
+        ((flags & FLAG_RELATIVE) ? PACKED_RELATIVE : 0) |
+        ((flags & FLAG_RIP_RELATIVE) ? PACKED_RIP_RELATIVE : 0) |
+        (vector ? PACKED_VECTOR : 0) |
+        ((flags & FLAG_MASK_ANY_ERROR) >> 4));
+}
+
+/*
+ * Packed batch disassembler function
+ *
+ * Same structure as x86_disasm_batch(); each instruction is decoded into a
+ * scratch InstructionInfo that stays in L1 and is packed from there.
+ */
+size_t x86_disasm_packed(const void* code, size_t length, PackedInstruction* out,
+    size_t max_count, DisasmBatchResult* result) {
+    const uint8_t* base = (const uint8_t*)code;
+    size_t offset = 0;
+    size_t count = 0;
+    DisasmStopReason reason = DISASM_STOP_END;
+    InstructionInfo info;
+
+    // Fast path: a full instruction window is always available
+    while (length - offset >= X86_MAX_INSTRUCTION_LENGTH) {
+        if (count == max_count) {
+            reason = DISASM_STOP_FULL;
+            goto stop;
+        }
+
+        unsigned int insn_length = decode_instruction<DISASM_MODE_64>(base + offset, &info);
+        pack_instruction(&info, (uint32_t)offset, &out[count++]);
+        offset += insn_length;
+    }
+
+    // Checked tail path: decode from a padded copy of the remaining bytes
+    while (offset < length) {
+        uint8_t window[X86_MAX_INSTRUCTION_LENGTH] = { 0 };
+        size_t remaining = length - offset;
+
+        if (count == max_count) {
+            reason = DISASM_STOP_FULL;
+            goto stop;
+        }
+
+        memcpy(window, base + offset, remaining);
+
+        unsigned int insn_length = decode_instruction<DISASM_MODE_64>(window, &info);
+        if (insn_length > remaining) {
+            reason = DISASM_STOP_TRUNCATED;
+            goto stop;
+        }
+
+        pack_instruction(&info, (uint32_t)offset, &out[count++]);
+        offset += insn_length;
+    }
+
+stop:
+    if (result) {
+        result->count = count;
+        result->offset = offset;
+        result->address = offset;
+        result->reason = reason;
+    }
+
+    return count;
+}
+
+void x86_pack_instruction(const InstructionInfo* info, uint32_t offset, PackedInstruction* out) {
+    pack_instruction(info, offset, out);
+}
+
+/*
+ * Packed record accessors
+ */
+int64_t x86_packed_displacement(const PackedInstruction* insn, const void* code) {
+    const uint8_t* p = (const uint8_t*)code + insn->offset + PACKED_DISP_OFFSET(insn);
+
+    switch (PACKED_DISP_SIZE(insn)) {
+    case 1:
+        return (int8_t)*p;
+
+    case 2: {
+        int16_t disp16;
+        memcpy(&disp16, p, sizeof(disp16));
+        return disp16;
+    }
+
+    case 4: {
+        int32_t disp32;
+        memcpy(&disp32, p, sizeof(disp32));
+        return disp32;
+    }
+    }
+
+    return 0;
+}
+
+uint64_t x86_packed_immediate(const PackedInstruction* insn, const void* code) {
+    uint64_t imm = 0;
+
+    // Little-endian: copying the low bytes zero-extends
+    memcpy(&imm, (const uint8_t*)code + insn->offset + PACKED_IMM_OFFSET(insn), PACKED_IMM_SIZE(insn));
+    return imm;
+}
+
+unsigned int x86_unpack_instruction(const PackedInstruction* insn, const void* code, InstructionInfo* info) {
+    uint8_t window[X86_MAX_INSTRUCTION_LENGTH] = { 0 };
+
+    // The record knows its length, so only those bytes are read
+    memcpy(window, (const uint8_t*)code + insn->offset, insn->length);
+    return decode_instruction<DISASM_MODE_64>(window, info);
+}
+
+// Index of a ModR/M byte in the ModR/M layout table (mod << 3 | r/m)
+#define LENGTH_MODRM_INDEX(modrm) ((((modrm) >> 3) & 0x18) | MODRM_RM(modrm))
+
+// ModR/M layout table entries
+#define LENGTH_DISP_MASK    0x07    // Displacement size in bytes
+#define LENGTH_SIB          0x10    // SIB byte follows
+#define LENGTH_SIB_DISP32   0x20    // SIB base 101 adds a disp32
+
+/*
+ * ModR/M layout by address size and ModR/M (mod << 3 | r/m)
+ */
+static const uint8_t g_length_modrm_table[2][32] = {
+    {
+        0, 0, 0, 0, LENGTH_SIB | LENGTH_SIB_DISP32, 4, 0, 0,    // mod 00: disp32 for r/m 101
+        1, 1, 1, 1, LENGTH_SIB | 1, 1, 1, 1,                    // mod 01: disp8
+        4, 4, 4, 4, LENGTH_SIB | 4, 4, 4, 4,                    // mod 10: disp32
+        0, 0, 0, 0, 0, 0, 0, 0                                  // mod 11: register
+    },
+    {
+        0, 0, 0, 0, 0, 0, 2, 0,                                 // mod 00: disp16 for r/m 110
+        1, 1, 1, 1, 1, 1, 1, 1,                                 // mod 01: disp8
+        2, 2, 2, 2, 2, 2, 2, 2,                                 // mod 10: disp16
+        0, 0, 0, 0, 0, 0, 0, 0                                  // mod 11: register
+    }
+};
+
+// Row of g_length_modrm_table: 16-bit addressing in 16-bit mode, or in
+// 32-bit mode with 67 (64-bit mode with 67 still uses the 32-bit layout)
+#define LENGTH_MODRM_ROW(Mode, prefix_67) \
+    ((Mode) != DISASM_MODE_64 && ((Mode) == DISASM_MODE_16) != ((prefix_67) != 0))
+
+/*
+ * Length-only decoder core (checked path)
+ *
+ * Walks the same prefix/opcode/ModR/M/SIB/displacement/immediate steps as
+ * decode_instruction() and returns the same length, checking every fetch
+ * against the 15-byte window.
+ */
+template <DisasmMode Mode>
+static DISASM_NOINLINE unsigned int decode_length_checked(const uint8_t* code) {
+    const uint8_t* p = code;
+    uint8_t c = 0;
+    uint8_t map = 0;
+    uint8_t modrm = 0;
+    uint8_t opattr;
+    uint8_t decode_state;
+    unsigned int layout;
+    unsigned int disp_size = 0;
+    unsigned int imm_size = 0;
+    int prefix_66 = 0;
+    int prefix_67 = 0;
+    int op64 = 0;
+    int rex_w = 0;
+
+    // Step 1: Skip prefixes, remembering only the size overrides
+    for (;;) {
+        if (p - code >= X86_MAX_INSTRUCTION_LENGTH) {
+            return X86_MAX_INSTRUCTION_LENGTH;
+        }
+        c = *p;
+        uint32_t prefix_class = g_prefix_class_table[c];
+        if (!prefix_class) {
+            break;
+        }
+        prefix_66 |= (prefix_class & PREFIX_OP_SIZE) != 0;
+        prefix_67 |= (prefix_class & PREFIX_ADDR_SIZE) != 0;
+        p++;
+    }
+
+    // Step 2: REX prefix (64-bit mode only)
+    if (ModeTraits<Mode>::rex && REX_IS_REX(c)) {
+        rex_w = REX_W(c) != 0;
+        p++;
+        if (p - code >= X86_MAX_INSTRUCTION_LENGTH) {
+            return (unsigned int)(p - code);
+        }
+        c = *p;
+        if (REX_IS_REX(c)) {
+            return (unsigned int)(p - code) + 1;
+        }
+        op64 = rex_w && (c & 0xF8) == 0xB8;
+    }
+
+    // Step 3: Opcode and attributes
+    p++;
+    if (c == 0x0F) {
+        if (p - code >= X86_MAX_INSTRUCTION_LENGTH) {
+            return (unsigned int)(p - code);
+        }
+        map = OPCODE_MAP_0F;
+        c = *p++;
+
+        if (c == 0x38 || c == 0x3A) {
+            if (p - code >= X86_MAX_INSTRUCTION_LENGTH) {
+                return (unsigned int)(p - code);
+            }
+            map = c == 0x38 ? OPCODE_MAP_0F38 : OPCODE_MAP_0F3A;
+            c = *p++;
+        }
+    }
+    opattr = ModeTables<Mode>::maps[map][c];
+    decode_state = g_opcode_decode_table[map][c];
+
+    // VEX/EVEX/XOP prefix
+    if (HAS_ATTR(decode_state, DECODE_VECTOR)) {
+        if (p - code >= X86_MAX_INSTRUCTION_LENGTH) {
+            return (unsigned int)(p - code);
+        }
+        if (is_vector_prefix<Mode>(c, *p)) {
+            unsigned int payload = VECTOR_PAYLOAD(c);
+            if (p - code + payload + 1 > X86_MAX_INSTRUCTION_LENGTH) {
+                return (unsigned int)(p - code);
+            }
+
+            map = c == VEX_PREFIX_2BYTE ? OPCODE_MAP_0F : c == EVEX_PREFIX ? EVEX_MAP(*p) : VEX_MAP(*p);
+            opattr = g_vector_opcode_table.attr[g_vector_map_row[VECTOR_KIND(c)][map]][p[payload]];
+            decode_state = DECODE_NONE;
+            prefix_66 = ModeTraits<Mode>::operand16;
+            p += payload + 1;
+        }
+    }
+
+    if (opattr == OPATTR_ERROR) {
+        return (unsigned int)(p - code);
+    }
+
+    // Step 4: ModR/M, SIB and displacement
+    if (HAS_ATTR(opattr, OPATTR_MODRM)) {
+        if (p - code >= X86_MAX_INSTRUCTION_LENGTH) {
+            return (unsigned int)(p - code);
+        }
+        modrm = *p++;
+
+        // Groups: the ModR/M reg field selects the instruction
+        if (HAS_ATTR(opattr, OPATTR_GROUP)) {
+            opattr = GROUP_OPATTR(map, c, modrm);
+            if (opattr == OPATTR_ERROR) {
+                opattr = OPATTR_MODRM;
+            }
+        }
+
+        layout = g_length_modrm_table[LENGTH_MODRM_ROW(Mode, prefix_67)][LENGTH_MODRM_INDEX(modrm)];
+        disp_size = layout & LENGTH_DISP_MASK;
+
+        if (layout & LENGTH_SIB) {
+            if (p - code >= X86_MAX_INSTRUCTION_LENGTH) {
+                return (unsigned int)(p - code);
+            }
+            if ((layout & LENGTH_SIB_DISP32) && SIB_BASE(*p) == SIB_BASE_DISP) {
+                disp_size = 4;
+            }
+            p++;
+        }
+
+        if (p - code + disp_size > X86_MAX_INSTRUCTION_LENGTH) {
+            return (unsigned int)(p - code);
+        }
+        p += disp_size;
+    }
+
+    // Step 5: Immediate
+    imm_size = immediate_size<Mode>(opattr, decode_state, op64, rex_w, prefix_66, prefix_67);
+    if (p - code + imm_size > X86_MAX_INSTRUCTION_LENGTH) {
+        return (unsigned int)(p - code);
+    }
+    return (unsigned int)(p - code) + imm_size;
+}
+
+/*
+ * Length-only decoder core
+ *
+ * Fast path for instructions with at most LENGTH_FAST_PREFIXES prefix
+ * bytes: every byte that can influence the length then lies within the
+ * first 12 bytes, so they are fetched unconditionally and combined with
+ * conditional moves instead of branches. Group opcodes resolve through the
+ * flat group table in the same way. VEX/EVEX/XOP instructions branch off
+ * to a second table-driven path. Everything else (long prefix runs, invalid
+ * opcodes, moffs forms, oversized results) takes the checked path.
+ */
+#define LENGTH_FAST_PREFIXES 4
+
+// Steps 4 and 5 of the fast path: p points at the ModR/M byte position
+template <DisasmMode Mode>
+static DISASM_FORCEINLINE unsigned int decode_length_operands(const uint8_t* code, const uint8_t* p,
+    uint8_t opattr, uint8_t modrm, uint8_t sib, unsigned int op64, unsigned int rex_w, unsigned int prefix_66,
+    unsigned int prefix_67) {
+    // Step 4: ModR/M, SIB and displacement
+    unsigned int has_modrm = opattr & OPATTR_MODRM;
+    unsigned int layout = g_length_modrm_table[LENGTH_MODRM_ROW(Mode, prefix_67)][LENGTH_MODRM_INDEX(modrm)] &
+        (0U - has_modrm);
+    unsigned int has_sib = (layout & LENGTH_SIB) >> 4;
+    unsigned int disp_size = layout & LENGTH_DISP_MASK;
+    if ((layout & LENGTH_SIB_DISP32) && SIB_BASE(sib) == SIB_BASE_DISP) {
+        disp_size = 4;
+    }
+    p += has_modrm + has_sib + disp_size;
+
+    // Step 5: Immediate (moffs forms take the checked path)
+    unsigned int length = (unsigned int)(p - code) + immediate_size<Mode>(opattr, 0, op64, rex_w, prefix_66,
+        prefix_67);
+    if (length > X86_MAX_INSTRUCTION_LENGTH) {
+        return decode_length_checked<Mode>(code);
+    }
+    return length;
+}
+
+// VEX/EVEX/XOP instructions: lead points at the C4/C5/62/8F byte, at most
+// LENGTH_FAST_PREFIXES + 1 bytes into the window
+template <DisasmMode Mode>
+static DISASM_FORCEINLINE unsigned int decode_length_vector(const uint8_t* code, const uint8_t* lead,
+    unsigned int prefix_67) {
+    uint8_t c = lead[0];
+    if (!is_vector_prefix<Mode>(c, lead[1])) {
+        return decode_length_checked<Mode>(code);
+    }
+
+    unsigned int map = c == VEX_PREFIX_2BYTE ? OPCODE_MAP_0F : c == EVEX_PREFIX ? EVEX_MAP(lead[1]) : VEX_MAP(lead[1]);
+    const uint8_t* p = lead + 1 + VECTOR_PAYLOAD(c);
+    uint8_t opattr = g_vector_opcode_table.attr[g_vector_map_row[VECTOR_KIND(c)][map]][*p++];
+    if (opattr == OPATTR_ERROR) {
+        return (unsigned int)(p - code);
+    }
+
+    // 66 does not size the immediate of a vector instruction
+    return decode_length_operands<Mode>(code, p, opattr, p[0], p[1], 0, 0, ModeTraits<Mode>::operand16, prefix_67);
+}
+
+template <DisasmMode Mode>
+static DISASM_FORCEINLINE unsigned int decode_length_body(const uint8_t* code, const uint8_t* p,
+    unsigned int prefix_66, unsigned int prefix_67) {
+    // Fetch the REX/opcode/ModR/M/SIB bytes with one load and pick them
+    // apart with shifts, keeping loads off the critical path
+    uint64_t window;
+    memcpy(&window, p, sizeof(window));
+
+    // Step 2: REX prefix (64-bit mode only)
+    unsigned int rex = ModeTraits<Mode>::rex && REX_IS_REX((uint8_t)window);
+    unsigned int rex_w = rex & ((uint8_t)window >> 3);
+    window >>= rex * 8;
+    p += rex;
+
+    // Step 3: Opcode and attributes. The map number is computed from the
+    // escape bytes (0F -> 1, 0F 38 -> 2, 0F 3A -> 3) rather than branched on
+    uint8_t c = (uint8_t)window;
+    unsigned int escape = c == 0x0F;
+    uint8_t escape2 = (uint8_t)(window >> 8);
+    unsigned int escape3 = escape & ((escape2 & 0xFD) == 0x38);
+    unsigned int map = escape + escape3 + (escape3 & (escape2 >> 1));
+    unsigned int opcode_bytes = 1 + escape + escape3;
+    uint8_t opcode = (uint8_t)(window >> ((opcode_bytes - 1) * 8));
+    uint8_t opattr = ModeTables<Mode>::maps[map][opcode];
+    uint8_t decode_state = g_opcode_decode_table[map][opcode];
+    unsigned int op64 = rex_w & ((c & 0xF8) == 0xB8);
+    window >>= opcode_bytes * 8;
+    p += opcode_bytes;
+
+    // Groups: select the row entry by ModR/M reg (the ModR/M byte is the
+    // next window byte; non-group opcodes read the GRP_NONE row and discard it).
+    // OPATTR_ERROR has the group bit set too, and 82 has a group row that
+    // only applies outside 64-bit mode, so errors must not resolve. The
+    // 3-byte maps have no groups and read the 0F row, which is discarded.
+    uint8_t group_opattr = GROUP_OPATTR(escape, opcode, (uint8_t)window);
+    opattr = HAS_ATTR(opattr, OPATTR_GROUP) && opattr != OPATTR_ERROR ? group_opattr : opattr;
+
+    if (opattr == OPATTR_ERROR || (ModeTraits<Mode>::rex && REX_IS_REX(c)) ||
+        HAS_ATTR(decode_state, DECODE_MOFFS | DECODE_VECTOR)) {
+        if (HAS_ATTR(decode_state, DECODE_VECTOR)) {
+            return decode_length_vector<Mode>(code, p - 1, prefix_67);
+        }
+        return decode_length_checked<Mode>(code);
+    }
+
+    return decode_length_operands<Mode>(code, p, opattr, (uint8_t)window, (uint8_t)(window >> 8),
+        op64, rex_w, prefix_66, prefix_67);
+}
+
+template <DisasmMode Mode>
+static DISASM_FORCEINLINE unsigned int decode_length(const uint8_t* code) {
+    const uint8_t* p = code;
+    unsigned int prefix_66 = 0;
+    unsigned int prefix_67 = 0;
+
+    // Step 1: Prefixes
+    uint32_t prefix_class;
+    while ((prefix_class = g_prefix_class_table[*p]) != 0) {
+        prefix_66 |= (prefix_class & PREFIX_OP_SIZE) != 0;
+        prefix_67 |= (prefix_class & PREFIX_ADDR_SIZE) != 0;
+        if (++p - code > LENGTH_FAST_PREFIXES) {
+            return decode_length_checked<Mode>(code);
+        }
+    }
+
+    return decode_length_body<Mode>(code, p, prefix_66, prefix_67);
+}
+
+/*
+ * Length-only disassembler function
+ */
+unsigned int x86_insn_length(const void* code) {
+    return decode_length<DISASM_MODE_64>((const uint8_t*)code);
+}
+
+unsigned int x86_insn_length_mode(DisasmMode mode, const void* code) {
+    switch (mode) {
+    case DISASM_MODE_16:
+        return decode_length<DISASM_MODE_16>((const uint8_t*)code);
+
+    case DISASM_MODE_32:
+        return decode_length<DISASM_MODE_32>((const uint8_t*)code);
+
+    default:
+        return decode_length<DISASM_MODE_64>((const uint8_t*)code);
+    }
+}
+
+/*
+ * Batch length-only disassembler function
+ *
+ * Same buffer handling as x86_disasm_batch(): lengths are computed in place
+ * while a full instruction window remains, then from a zero-padded copy.
+ */
+template <DisasmMode Mode>
+static size_t insn_length_batch(const void* code, size_t length, uint8_t* lengths,
+    size_t max_count, DisasmBatchResult* result) {
+    const uint8_t* base = (const uint8_t*)code;
+    size_t offset = 0;
+    size_t count = 0;
+    DisasmStopReason reason = DISASM_STOP_END;
+
+    // Fast path: a full instruction window is always available. The
+    // byte classifier masks are not used here: the walk from one
+    // instruction to the next is latency-bound, and taking the prefix run
+    // from the masks measured slower than the per-byte prefix loop.
+    while (length - offset >= X86_MAX_INSTRUCTION_LENGTH) {
+        if (count == max_count) {
+            reason = DISASM_STOP_FULL;
+            goto stop;
+        }
+
+        unsigned int insn_length = decode_length<Mode>(base + offset);
+        lengths[count++] = (uint8_t)insn_length;
+        offset += insn_length;
+    }
+
+    // Checked tail path: decode from a padded copy of the remaining bytes
+    while (offset < length) {
+        uint8_t window[X86_MAX_INSTRUCTION_LENGTH] = { 0 };
+        size_t remaining = length - offset;
+
+        if (count == max_count) {
+            reason = DISASM_STOP_FULL;
+            goto stop;
+        }
+
+        memcpy(window, base + offset, remaining);
+
+        unsigned int insn_length = decode_length<Mode>(window);
+        if (insn_length > remaining) {
+            reason = DISASM_STOP_TRUNCATED;
+            goto stop;
+        }
+
+        lengths[count++] = (uint8_t)insn_length;
+        offset += insn_length;
+    }
+
+stop:
+    if (result) {
+        result->count = count;
+        result->offset = offset;
+        result->address = offset;
+        result->reason = reason;
+    }
+
+    return count;
+}
+
+size_t x86_insn_length_batch(const void* code, size_t length, uint8_t* lengths,
+    size_t max_count, DisasmBatchResult* result) {
+    return insn_length_batch<DISASM_MODE_64>(code, length, lengths, max_count, result);
+}
+
+size_t x86_insn_length_batch_mode(DisasmMode mode, const void* code, size_t length, uint8_t* lengths,
+    size_t max_count, DisasmBatchResult* result) {
+    switch (mode) {
+    case DISASM_MODE_16:
+        return insn_length_batch<DISASM_MODE_16>(code, length, lengths, max_count, result);
+
+    case DISASM_MODE_32:
+        return insn_length_batch<DISASM_MODE_32>(code, length, lengths, max_count, result);
+
+    default:
+        return insn_length_batch<DISASM_MODE_64>(code, length, lengths, max_count, result);
+    }
+}
@@ -1,174 +1,1315 @@
-#pragma once
-#include <stdint.h>
-/*
- * Instruction Prefix Masks
- * These are used to check for the presence of specific prefixes
- */
-typedef enum {
-    PREFIX_NONE = 0x00,
-    PREFIX_LOCK = 0x01,  // F0: Lock prefix
-    PREFIX_REPNZ = 0x02,  // F2: REPNZ/REPNE prefix
-    PREFIX_REP = 0x04,  // F3: REP/REPE/REPZ prefix
-    PREFIX_OP_SIZE = 0x08,  // 66: Operand size override
-    PREFIX_ADDR_SIZE = 0x10,  // 67: Address size override
-    PREFIX_SEG_CS = 0x20,  // 2E: CS segment override
-    PREFIX_SEG_SS = 0x40,  // 36: SS segment override
-    PREFIX_SEG_DS = 0x80,  // 3E: DS segment override
-    PREFIX_SEG_ES = 0x100, // 26: ES segment override
-    PREFIX_SEG_FS = 0x200, // 64: FS segment override
-    PREFIX_SEG_GS = 0x400, // 65: GS segment override
-    PREFIX_REX = 0x800, // 40-4F: REX prefix
-
-    // Combinations
-    PREFIX_ANY_SEG = 0x7E0, // Any segment override
-    PREFIX_ANY = 0xFFF  // Any prefix
-} PrefixMask;
-
-// Macros for checking prefixes - makes code more readable
-#define HAS_PREFIX(flags, mask) (((flags) & (mask)) != 0)
-#define HAS_ANY_PREFIX(flags, mask) (((flags) & (mask)) != 0)
-#define HAS_ALL_PREFIX(flags, mask) (((flags) & (mask)) == (mask))
-
-/*
- * Instruction Flag Masks
- * These are used to check for various instruction properties
- */
-typedef enum {
-    FLAG_NONE = 0x00000000,
-    FLAG_MODRM = 0x00000001, // Has ModR/M byte
-    FLAG_SIB = 0x00000002, // Has SIB byte
-    FLAG_IMM8 = 0x00000004, // Has 8-bit immediate
-    FLAG_IMM16 = 0x00000008, // Has 16-bit immediate
-    FLAG_IMM32 = 0x00000010, // Has 32-bit immediate
-    FLAG_IMM64 = 0x00000020, // Has 64-bit immediate
-    FLAG_DISP8 = 0x00000040, // Has 8-bit displacement
-    FLAG_DISP16 = 0x00000080, // Has 16-bit displacement
-    FLAG_DISP32 = 0x00000100, // Has 32-bit displacement
-    FLAG_RELATIVE = 0x00000200, // Relative addressing
-
-    // Error flags
-    FLAG_ERROR = 0x00001000, // General error
-    FLAG_ERROR_OPCODE = 0x00002000, // Invalid opcode
-    FLAG_ERROR_LENGTH = 0x00004000, // Instruction too long
-    FLAG_ERROR_LOCK = 0x00008000, // Invalid lock prefix usage
-    FLAG_ERROR_OPERAND = 0x00010000, // Invalid operand
-
-    // Prefix flags (these will be set in the flags field)
-    FLAG_PREFIX_REPNZ = 0x01000000,
-    FLAG_PREFIX_REP = 0x02000000,
-    FLAG_PREFIX_OP_SIZE = 0x04000000,
-    FLAG_PREFIX_ADDR_SIZE = 0x08000000,
-    FLAG_PREFIX_LOCK = 0x10000000,
-    FLAG_PREFIX_SEG = 0x20000000,
-    FLAG_PREFIX_REX = 0x40000000,
-
-    // Common masks for checking multiple flags
-    FLAG_MASK_ANY_IMM = 0x0000003C, // Any immediate value
-    FLAG_MASK_ANY_DISP = 0x000001C0, // Any displacement
-    FLAG_MASK_ANY_ERROR = 0x0001F000, // Any error
-    FLAG_MASK_ANY_PREFIX = 0x7F000000 // Any prefix
-} FlagMask;
-
-// Macros for checking flags - makes code more readable
-#define HAS_FLAG(flags, mask) (((flags) & (mask)) != 0)
-#define HAS_ANY_FLAG(flags, mask) (((flags) & (mask)) != 0)
-#define HAS_ALL_FLAGS(flags, mask) (((flags) & (mask)) == (mask))
-#define SET_FLAG(flags, mask) ((flags) |= (mask))
-#define CLEAR_FLAG(flags, mask) ((flags) &= ~(mask))
-
-/*
- * Opcode Attributes
- * Define the characteristics and components of each instruction
- */
-typedef enum {
-    OPATTR_NONE = 0x00,
-    OPATTR_MODRM = 0x01, // Instruction has ModR/M byte
-    OPATTR_IMM8 = 0x02, // 8-bit immediate
-    OPATTR_IMM16 = 0x04, // 16-bit immediate
-
-    /* OPATTR_IMM_P66: Variable-size immediate value that depends on prefixes
-     *
-     * This attribute indicates that the immediate value size depends on:
-     * 1. Whether the 0x66 (operand size override) prefix is present
-     * 2. Whether REX.W (64-bit operand size) is present in 64-bit mode
-     * 3. The default operand size (16/32-bit) of the current mode
-     *
-     * Size determination logic:
-     * - 64-bit mode with REX.W set: 64-bit immediate (e.g., MOV RAX, imm64)
-     * - 66 prefix present: 16-bit immediate (e.g., MOV AX, imm16)
-     * - Otherwise: 32-bit immediate (e.g., MOV EAX, imm32)
-     */
-    OPATTR_IMM_P66 = 0x10,
-
-    OPATTR_REL8 = 0x20, // 8-bit relative offset
-    OPATTR_REL32 = 0x40, // 32-bit relative offset
-    OPATTR_GROUP = 0x80, // Instruction is part of a group
-    OPATTR_ERROR = 0xFF  // Invalid opcode
-} OpcodeAttribute;
-
-// Macros for checking opcode attributes
-#define HAS_ATTR(attr, mask) (((attr) & (mask)) != 0)
-
-/*
- * Instruction result structure
- */
-typedef struct {
-    // Length and raw bytes
-    uint8_t length;         // Total instruction length in bytes
-
-    // Prefix bytes
-    uint8_t prefix_lock;    // F0: Lock prefix
-    uint8_t prefix_rep;     // F2/F3: REP/REPNZ prefix
-    uint8_t prefix_seg;     // Segment override
-    uint8_t prefix_66;      // 66: Operand size override
-    uint8_t prefix_67;      // 67: Address size override
-
-    // REX prefix
-    uint8_t rex;            // REX prefix byte
-    uint8_t rex_w;          // REX.W field (64-bit operand)
-    uint8_t rex_r;          // REX.R field (ModR/M reg extension)
-    uint8_t rex_x;          // REX.X field (SIB index extension)
-    uint8_t rex_b;          // REX.B field (ModR/M rm extension or SIB base extension)
-
-    // Opcode
-    uint8_t opcode;         // Primary opcode
-    uint8_t opcode2;        // Secondary opcode (for 2-byte opcodes)
-
-    // ModR/M
-    uint8_t modrm;          // ModR/M byte
-    uint8_t modrm_mod;      // ModR/M mod field
-    uint8_t modrm_reg;      // ModR/M reg field
-    uint8_t modrm_rm;       // ModR/M r/m field
-
-    // SIB
-    uint8_t sib;            // SIB byte
-    uint8_t sib_scale;      // SIB scale field
-    uint8_t sib_index;      // SIB index field
-    uint8_t sib_base;       // SIB base field
-
-    // Immediate value
-    union {
-        uint8_t  imm8;
-        uint16_t imm16;
-        uint32_t imm32;
-        uint64_t imm64;
-    } immediate;
-
-    // Displacement
-    union {
-        uint8_t  disp8;
-        uint16_t disp16;
-        uint32_t disp32;
-    } displacement;
-
-    // Flags for instruction properties
-    uint32_t flags;
-
-    // For convenience, the full instruction bytes
-    uint8_t bytes[16];
-} InstructionInfo;
-
-/*
- * Function to disassemble an instruction
- */
-unsigned int x86_disasm(const void* code, InstructionInfo* info);
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Maximum length of a single instruction in bytes
+#define X86_MAX_INSTRUCTION_LENGTH 15
+
+/*
+ * CPU modes
+ * The value is the default address size in bits.
+ */
+typedef enum {
+    DISASM_MODE_16 = 16,    // Real mode and 16-bit protected mode
+    DISASM_MODE_32 = 32,    // 32-bit protected mode and compatibility mode
+    DISASM_MODE_64 = 64     // 64-bit long mode
+} DisasmMode;
+
+/*
+ * Instruction Prefix Masks
+ * These are used to check for the presence of specific prefixes
+ */
+typedef enum {
+    PREFIX_NONE = 0x00,
+    PREFIX_LOCK = 0x01,  // F0: Lock prefix
+    PREFIX_REPNZ = 0x02,  // F2: REPNZ/REPNE prefix
+    PREFIX_REP = 0x04,  // F3: REP/REPE/REPZ prefix
+    PREFIX_OP_SIZE = 0x08,  // 66: Operand size override
+    PREFIX_ADDR_SIZE = 0x10,  // 67: Address size override
+    PREFIX_SEG_CS = 0x20,  // 2E: CS segment override
+    PREFIX_SEG_SS = 0x40,  // 36: SS segment override
+    PREFIX_SEG_DS = 0x80,  // 3E: DS segment override
+    PREFIX_SEG_ES = 0x100, // 26: ES segment override
+    PREFIX_SEG_FS = 0x200, // 64: FS segment override
+    PREFIX_SEG_GS = 0x400, // 65: GS segment override
+    PREFIX_REX = 0x800, // 40-4F: REX prefix
+
+    // Combinations
+    PREFIX_ANY_SEG = 0x7E0, // Any segment override
+    PREFIX_ANY = 0xFFF  // Any prefix
+} PrefixMask;
+
+// Macros for checking prefixes - makes code more readable
+#define HAS_PREFIX(flags, mask) (((flags) & (mask)) != 0)
+#define HAS_ANY_PREFIX(flags, mask) (((flags) & (mask)) != 0)
+#define HAS_ALL_PREFIX(flags, mask) (((flags) & (mask)) == (mask))
+
+/*
+ * Instruction Flag Masks
+ * These are used to check for various instruction properties
+ */
+typedef enum {
+    FLAG_NONE = 0x00000000,
+    FLAG_MODRM = 0x00000001, // Has ModR/M byte
+    FLAG_SIB = 0x00000002, // Has SIB byte
+    FLAG_IMM8 = 0x00000004, // Has 8-bit immediate
+    FLAG_IMM16 = 0x00000008, // Has 16-bit immediate
+    FLAG_IMM32 = 0x00000010, // Has 32-bit immediate
+    FLAG_IMM64 = 0x00000020, // Has 64-bit immediate
+    FLAG_DISP8 = 0x00000040, // Has 8-bit displacement
+    FLAG_DISP16 = 0x00000080, // Has 16-bit displacement
+    FLAG_DISP32 = 0x00000100, // Has 32-bit displacement
+    FLAG_RELATIVE = 0x00000200, // Relative addressing
+    FLAG_FAR_POINTER = 0x00000400, // Immediate is a far pointer (offset, then 16-bit selector)
+    FLAG_MOFFS = 0x00000800, // Immediate is a memory offset (MOV A0-A3)
+
+    // Error flags
+    FLAG_ERROR = 0x00001000, // General error
+    FLAG_ERROR_OPCODE = 0x00002000, // Invalid opcode
+    FLAG_ERROR_LENGTH = 0x00004000, // Instruction too long
+    FLAG_ERROR_LOCK = 0x00008000, // Invalid lock prefix usage
+    FLAG_ERROR_OPERAND = 0x00010000, // Invalid operand
+
+    // Addressing flags
+    FLAG_RIP_RELATIVE = 0x00020000, // RIP-relative memory operand (64-bit mode, mod 00, r/m 101)
+
+    // Encoding flags
+    FLAG_VEX = 0x00100000, // VEX encoded (C4/C5)
+    FLAG_EVEX = 0x00200000, // EVEX encoded (62)
+    FLAG_XOP = 0x00400000, // XOP encoded (8F)
+
+    // Prefix flags (these will be set in the flags field)
+    FLAG_PREFIX_REPNZ = 0x01000000,
+    FLAG_PREFIX_REP = 0x02000000,
+    FLAG_PREFIX_OP_SIZE = 0x04000000,
+    FLAG_PREFIX_ADDR_SIZE = 0x08000000,
+    FLAG_PREFIX_LOCK = 0x10000000,
+    FLAG_PREFIX_SEG = 0x20000000,
+    FLAG_PREFIX_REX = 0x40000000,
+
+    // Common masks for checking multiple flags
+    FLAG_MASK_ANY_IMM = 0x0000003C, // Any immediate value
+    FLAG_MASK_ANY_DISP = 0x000001C0, // Any displacement
+    FLAG_MASK_ANY_ERROR = 0x0001F000, // Any error
+    FLAG_MASK_ANY_VECTOR = 0x00700000, // Any VEX/EVEX/XOP encoding
+    FLAG_MASK_ANY_PREFIX = 0x7F000000 // Any prefix
+} FlagMask;
+
+// Macros for checking flags - makes code more readable
+#define HAS_FLAG(flags, mask) (((flags) & (mask)) != 0)
+#define HAS_ANY_FLAG(flags, mask) (((flags) & (mask)) != 0)
+#define HAS_ALL_FLAGS(flags, mask) (((flags) & (mask)) == (mask))
+#define SET_FLAG(flags, mask) ((flags) |= (mask))
+#define CLEAR_FLAG(flags, mask) ((flags) &= ~(mask))
+
+/*
+ * Opcode Attributes
+ * Define the characteristics and components of each instruction
+ */
+typedef enum {
+    OPATTR_NONE = 0x00,
+    OPATTR_MODRM = 0x01, // Instruction has ModR/M byte
+    OPATTR_IMM8 = 0x02, // 8-bit immediate
+    OPATTR_IMM16 = 0x04, // 16-bit immediate
+
+    /* OPATTR_IMM_P66: Variable-size immediate value that depends on prefixes
+     *
+     * This attribute indicates that the immediate value size depends on:
+     * 1. Whether the 0x66 (operand size override) prefix is present
+     * 2. Whether REX.W (64-bit operand size) is present in 64-bit mode
+     * 3. The default operand size (16/32-bit) of the current mode
+     *
+     * Size determination logic:
+     * - 64-bit mode with REX.W set: 64-bit immediate (e.g., MOV RAX, imm64)
+     * - 66 prefix present: 16-bit immediate (e.g., MOV AX, imm16)
+     * - Otherwise: 32-bit immediate (e.g., MOV EAX, imm32)
+     */
+    OPATTR_IMM_P66 = 0x10,
+
+    OPATTR_REL8 = 0x20, // 8-bit relative offset
+    OPATTR_REL32 = 0x40, // 32-bit relative offset
+    OPATTR_GROUP = 0x80, // Instruction is part of a group
+    OPATTR_ERROR = 0xFF  // Invalid opcode
+} OpcodeAttribute;
+
+// Macros for checking opcode attributes
+#define HAS_ATTR(attr, mask) (((attr) & (mask)) != 0)
+
+/*
+ * Instruction result structure
+ */
+typedef struct {
+    // Length and raw bytes
+    uint8_t length;         // Total instruction length in bytes
+
+    // Prefix bytes
+    uint8_t prefix_lock;    // F0: Lock prefix
+    uint8_t prefix_rep;     // F2/F3: REP/REPNZ prefix
+    uint8_t prefix_seg;     // Segment override
+    uint8_t prefix_66;      // 66: Operand size override
+    uint8_t prefix_67;      // 67: Address size override
+
+    // REX prefix
+    uint8_t rex;            // REX prefix byte
+    uint8_t rex_w;          // REX.W field (64-bit operand)
+    uint8_t rex_r;          // REX.R field (ModR/M reg extension)
+    uint8_t rex_x;          // REX.X field (SIB index extension)
+    uint8_t rex_b;          // REX.B field (ModR/M rm extension or SIB base extension)
+
+    // Opcode
+    uint8_t opcode;         // Primary opcode (0F, or the VEX/EVEX/XOP lead byte)
+    uint8_t opcode2;        // Secondary opcode (opcode within the map when map != 0)
+    uint8_t map;            // OpcodeMap
+
+    // VEX/EVEX/XOP prefix (FLAG_MASK_ANY_VECTOR); W/R/X/B are in the REX fields
+    uint8_t vex_vvvv;       // Extra register operand (with EVEX.V', 0-31)
+    uint8_t vex_l;          // Vector length (0 = 128, 1 = 256, 2 = 512 bits)
+    uint8_t vex_pp;         // Implied prefix (0 = none, 1 = 66, 2 = F3, 3 = F2)
+    uint8_t evex_aaa;       // EVEX opmask register
+    uint8_t evex_z;         // EVEX zeroing-masking
+    uint8_t evex_b;         // EVEX broadcast / rounding control / SAE
+    uint8_t disp_scale;     // EVEX memory operands: disp8 is scaled by this (disp8*N), else 0
+
+    // ModR/M
+    uint8_t modrm;          // ModR/M byte
+    uint8_t modrm_mod;      // ModR/M mod field
+    uint8_t modrm_reg;      // ModR/M reg field
+    uint8_t modrm_rm;       // ModR/M r/m field
+
+    // SIB
+    uint8_t sib;            // SIB byte
+    uint8_t sib_scale;      // SIB scale field
+    uint8_t sib_index;      // SIB index field
+    uint8_t sib_base;       // SIB base field
+
+    // Immediate value
+    union {
+        uint8_t  imm8;
+        uint16_t imm16;
+        uint32_t imm32;
+        uint64_t imm64;
+    } immediate;
+
+    // Displacement
+    union {
+        uint8_t  disp8;
+        uint16_t disp16;
+        uint32_t disp32;
+    } displacement;
+
+    // Flags for instruction properties
+    uint32_t flags;
+
+    // For convenience, the full instruction bytes
+    uint8_t bytes[16];
+} InstructionInfo;
+
+/*
+ * Opcode maps
+ */
+typedef enum {
+    OPCODE_MAP_1BYTE = 0,       // xx
+    OPCODE_MAP_0F = 1,          // 0F xx
+    OPCODE_MAP_0F38 = 2,        // 0F 38 xx
+    OPCODE_MAP_0F3A = 3,        // 0F 3A xx
+    OPCODE_MAP_5 = 5,           // EVEX map 5 (FP16)
+    OPCODE_MAP_6 = 6,           // EVEX map 6 (FP16)
+    OPCODE_MAP_XOP8 = 8,        // XOP map 8
+    OPCODE_MAP_XOP9 = 9,        // XOP map 9
+    OPCODE_MAP_XOPA = 10        // XOP map 0A
+} OpcodeMap;
+
+/*
+ * Packed instruction flags
+ */
+typedef enum {
+    PACKED_NONE = 0x0000,
+    PACKED_MODRM = 0x0001,          // Has ModR/M byte
+    PACKED_SIB = 0x0002,            // Has SIB byte
+    PACKED_RELATIVE = 0x0004,       // Immediate is a relative branch offset
+    PACKED_VECTOR = 0x0008,         // VEX/EVEX/XOP encoded, rex holds its W/R/X/B bits
+    PACKED_RIP_RELATIVE = 0x0010,   // Displacement is relative to the next instruction
+
+    // Error flags (FLAG_ERROR_* >> 4)
+    PACKED_ERROR = 0x0100,          // General error
+    PACKED_ERROR_OPCODE = 0x0200,   // Invalid opcode
+    PACKED_ERROR_LENGTH = 0x0400,   // Instruction too long
+    PACKED_ERROR_LOCK = 0x0800,     // Invalid lock prefix usage
+    PACKED_ERROR_OPERAND = 0x1000   // Invalid operand
+} PackedFlag;
+
+/*
+ * Packed instruction record (16 bytes)
+ *
+ * Keeps what InstructionInfo derives from the instruction bytes only once,
+ * and refers to the displacement and immediate by position in the source
+ * buffer instead of copying them. Offsets are relative to the start of the
+ * decoded buffer, so a single buffer must be smaller than 4 GB.
+ */
+typedef struct {
+    uint32_t offset;        // Offset of the instruction in the source buffer
+    uint8_t length;         // Total instruction length in bytes
+    uint8_t map;            // OpcodeMap
+    uint8_t opcode;         // Opcode byte within the map
+    uint8_t modrm;          // ModR/M byte (PACKED_MODRM)
+    uint8_t sib;            // SIB byte (PACKED_SIB)
+    uint8_t rex;            // REX prefix byte (or the W/R/X/B bits of a vector prefix), 0 if none
+    uint16_t prefixes;      // PrefixMask bits
+    uint8_t disp;           // Displacement: offset in the instruction (bits 0-3), size (bits 4-7)
+    uint8_t imm;            // Immediate: offset in the instruction (bits 0-3), size (bits 4-7)
+    uint16_t flags;         // PackedFlag bits
+} PackedInstruction;
+
+// Accessors for the packed displacement and immediate fields
+#define PACKED_DISP_OFFSET(insn) ((insn)->disp & 0x0F)
+#define PACKED_DISP_SIZE(insn) ((insn)->disp >> 4)
+#define PACKED_IMM_OFFSET(insn) ((insn)->imm & 0x0F)
+#define PACKED_IMM_SIZE(insn) ((insn)->imm >> 4)
+
+// Accessors for the ModR/M and SIB fields, with REX extensions applied
+#define PACKED_MODRM_MOD(insn) ((insn)->modrm >> 6)
+#define PACKED_MODRM_REG(insn) ((((insn)->modrm >> 3) & 7) | (((insn)->rex & 0x04) << 1))
+#define PACKED_MODRM_RM(insn) (((insn)->modrm & 7) | (((insn)->rex & 0x01) << 3))
+#define PACKED_SIB_SCALE(insn) ((insn)->sib >> 6)
+#define PACKED_SIB_INDEX(insn) ((((insn)->sib >> 3) & 7) | (((insn)->rex & 0x02) << 2))
+#define PACKED_SIB_BASE(insn) (((insn)->sib & 7) | (((insn)->rex & 0x01) << 3))
+#define PACKED_REX_W(insn) (((insn)->rex >> 3) & 1)
+
+/*
+ * Structure-of-arrays batch container
+ *
+ * One column per PackedInstruction field, so scans over a single field
+ * touch only that field's memory. All columns live in one allocation.
+ */
+typedef struct {
+    size_t capacity;        // Number of rows allocated
+    size_t count;           // Number of rows in use
+    uint32_t* offset;
+    uint8_t* length;
+    uint8_t* map;
+    uint8_t* opcode;
+    uint8_t* modrm;
+    uint8_t* sib;
+    uint8_t* rex;
+    uint16_t* prefixes;
+    uint8_t* disp;
+    uint8_t* imm;
+    uint16_t* flags;
+} InstructionColumns;
+
+/*
+ * Batch decoding record
+ */
+typedef struct {
+    uint64_t address;       // Virtual address of the instruction
+    uint64_t target;        // Branch target (FLAG_RELATIVE) or RIP-relative address (FLAG_RIP_RELATIVE), else 0
+    InstructionInfo info;   // Decoded instruction
+} DecodedInstruction;
+
+/*
+ * Reasons for the batch decoder to stop
+ */
+typedef enum {
+    DISASM_STOP_END = 0,        // The whole buffer was decoded
+    DISASM_STOP_FULL = 1,       // The output array is full
+    DISASM_STOP_TRUNCATED = 2   // The next instruction runs past the end of the buffer
+} DisasmStopReason;
+
+/*
+ * Batch decoding result
+ */
+typedef struct {
+    size_t count;               // Number of records written
+    size_t offset;              // Offset of the first byte that was not decoded
+    uint64_t address;           // Virtual address of the first byte that was not decoded
+    DisasmStopReason reason;    // Why decoding stopped
+} DisasmBatchResult;
+
+/*
+ * Byte classification masks for one 64-byte block
+ * Bit i describes byte i of the block.
+ */
+typedef struct {
+    uint64_t prefix;            // Legacy prefix bytes (segment, 66, 67, F0, F2, F3)
+    uint64_t rex;               // REX bytes (40-4F)
+    uint64_t escape;            // 0F escape bytes
+    uint64_t modrm;             // 1-byte opcodes that take a ModR/M byte
+    uint64_t op_size;           // 66 bytes
+    uint64_t addr_size;         // 67 bytes
+} ByteClassBlock;
+
+/*
+ * Byte classifier implementations
+ */
+typedef enum {
+    DISASM_SCAN_SCALAR = 0,     // Table lookup per byte
+    DISASM_SCAN_AVX2 = 1        // 32 bytes per step with nibble shuffles
+} DisasmScanLevel;
+
+/*
+ * Text formats
+ * One syntax, optionally combined with the batch line prefixes.
+ */
+typedef enum {
+    DISASM_FORMAT_INTEL = 0x00,     // Intel syntax
+    DISASM_FORMAT_ATT = 0x01,       // AT&T syntax
+    DISASM_FORMAT_ADDRESS = 0x10,   // Batch: start each line with the address
+    DISASM_FORMAT_BYTES = 0x20      // Batch: start each line with the instruction bytes
+} DisasmFormat;
+
+// Buffer size that always holds the text of one instruction
+#define X86_FORMAT_BUFFER_SIZE 256
+
+/*
+ * Operand types
+ */
+typedef enum {
+    OPERAND_NONE = 0,
+    OPERAND_REGISTER = 1,       // reg
+    OPERAND_MEMORY = 2,         // segment, base, index, scale, disp
+    OPERAND_IMMEDIATE = 3,      // imm, sign-extended to the operand size
+    OPERAND_RELATIVE = 4,       // imm: branch displacement from the next instruction
+    OPERAND_FAR_POINTER = 5     // imm: offset, selector
+} OperandType;
+
+/*
+ * Register classes
+ * Registers are numbered by their encoding within the class.
+ */
+typedef enum {
+    REGCLASS_NONE = 0,
+    REGCLASS_GPR8 = 1,          // AL-BL, SPL-DIL (with REX), R8B-R15B
+    REGCLASS_GPR8_HIGH = 2,     // AH, CH, DH, BH (4-7, without REX)
+    REGCLASS_GPR16 = 3,
+    REGCLASS_GPR32 = 4,
+    REGCLASS_GPR64 = 5,
+    REGCLASS_SEGMENT = 6,       // ES, CS, SS, DS, FS, GS
+    REGCLASS_CONTROL = 7,
+    REGCLASS_DEBUG = 8,
+    REGCLASS_MMX = 9,
+    REGCLASS_XMM = 10,
+    REGCLASS_YMM = 11,
+    REGCLASS_ZMM = 12,
+    REGCLASS_OPMASK = 13,       // K0-K7
+    REGCLASS_X87 = 14,          // ST(0)-ST(7)
+    REGCLASS_IP = 15            // RIP/EIP (RIP-relative memory base)
+} RegisterClass;
+
+/*
+ * Operand access
+ */
+typedef enum {
+    OPERAND_ACCESS_READ = 0x01,
+    OPERAND_ACCESS_WRITE = 0x02,
+    OPERAND_ACCESS_READ_WRITE = 0x03
+} OperandAccess;
+
+typedef struct {
+    uint8_t reg_class;      // RegisterClass
+    uint8_t index;          // Register number within the class
+} OperandRegister;
+
+/*
+ * Operand of a decoded instruction
+ */
+typedef struct {
+    uint8_t type;           // OperandType
+    uint8_t access;         // OperandAccess
+    uint16_t size;          // Size in bytes (memory: bytes accessed; 0 = unsized, e.g. LEA)
+    OperandRegister reg;    // OPERAND_REGISTER
+
+    // OPERAND_MEMORY
+    OperandRegister segment;    // Effective segment (the override or the default)
+    OperandRegister base;       // REGCLASS_NONE without a base
+    OperandRegister index;      // REGCLASS_NONE without an index (XMM/YMM/ZMM for VSIB)
+    uint8_t scale;              // 1, 2, 4 or 8
+    uint8_t broadcast;          // EVEX embedded broadcast: size is one element
+    uint16_t selector;          // OPERAND_FAR_POINTER
+    int64_t disp;               // Sign-extended displacement (disp8*N scaled)
+
+    uint64_t imm;           // OPERAND_IMMEDIATE, OPERAND_RELATIVE, OPERAND_FAR_POINTER
+} InstructionOperand;
+
+#define X86_MAX_OPERANDS 4
+
+/*
+ * Lazily decoded operands of one instruction
+ *
+ * x86_operands_init only records the instruction; the operands are decoded
+ * by the first x86_operand_count/x86_operand call on it and cached. info
+ * must stay valid until then.
+ */
+typedef struct {
+    const InstructionInfo* info;
+    uint8_t mode;           // DisasmMode
+    uint8_t decoded;        // Operands have been decoded
+    uint8_t count;          // Number of operands
+    InstructionOperand operands[X86_MAX_OPERANDS];
+} InstructionOperands;
+
+/*
+ * File mapping options
+ */
+typedef enum {
+    DISASM_MAP_DEFAULT = 0x00,
+    DISASM_MAP_POPULATE = 0x01,     // Fault the whole file in up front (MAP_POPULATE)
+    DISASM_MAP_SEQUENTIAL = 0x02,   // Tell the kernel the file is read front to back (MADV_SEQUENTIAL)
+    DISASM_MAP_MEMORY_LAYOUT = 0x04 // PE: the file is a loaded image (sections at their RVAs), e.g. a dump
+} DisasmMapFlags;
+
+/*
+ * Read-only memory-mapped file
+ */
+typedef struct {
+    const uint8_t* data;    // File contents
+    size_t size;            // File size in bytes
+    void* file_handle;      // Windows: file and mapping handles; unused elsewhere
+    void* map_handle;
+} MappedFile;
+
+/*
+ * Executable file formats
+ */
+typedef enum {
+    DISASM_IMAGE_UNKNOWN = 0,
+    DISASM_IMAGE_ELF = 1,
+    DISASM_IMAGE_PE = 2
+} DisasmImageFormat;
+
+/*
+ * Image loading status
+ */
+typedef enum {
+    DISASM_IMAGE_OK = 0,
+    DISASM_IMAGE_ERROR_IO = 1,          // The file cannot be opened or mapped
+    DISASM_IMAGE_ERROR_FORMAT = 2,      // Not a recognized executable format
+    DISASM_IMAGE_ERROR_CORRUPT = 3,     // Headers point outside the file
+    DISASM_IMAGE_ERROR_MACHINE = 4,     // Not an x86 or x86-64 image
+    DISASM_IMAGE_ERROR_MEMORY = 5       // Out of memory
+} DisasmImageStatus;
+
+/*
+ * Executable region of a loaded image
+ *
+ * code points into the mapped file; nothing is copied.
+ */
+typedef struct {
+    const uint8_t* code;    // First byte of the region
+    size_t size;            // Size in bytes
+    uint64_t address;       // Virtual address of code[0]
+    uint64_t file_offset;   // Offset of code[0] in the file
+    char name[16];          // Section name, NUL-terminated (truncated), "" for a segment
+} CodeRegion;
+
+/*
+ * Function address range known from the image metadata
+ */
+typedef struct {
+    uint64_t start;         // Virtual address of the first instruction
+    uint64_t end;           // Virtual address past the last byte
+} FunctionRange;
+
+/*
+ * Loaded executable image
+ */
+typedef struct {
+    MappedFile file;
+    DisasmImageFormat format;
+    DisasmMode mode;            // CPU mode of the code
+    uint64_t base;              // Preferred load address (PE ImageBase), 0 for ELF
+    uint64_t entry;             // Entry point virtual address, 0 if none
+    CodeRegion* regions;        // Executable regions, in file order
+    size_t region_count;
+    FunctionRange* functions;   // Decode seeds: ELF function symbols or PE exception directory (.pdata) entries, sorted
+    size_t function_count;
+} LoadedImage;
+
+/*
+ * Control flow classes
+ */
+typedef enum {
+    DISASM_FLOW_NONE = 0,           // Falls through to the next instruction
+    DISASM_FLOW_BRANCH = 1,         // Conditional relative branch: target and next instruction
+    DISASM_FLOW_JUMP = 2,           // Unconditional relative jump: target only
+    DISASM_FLOW_CALL = 3,           // Relative call: target, then next instruction
+    DISASM_FLOW_INDIRECT_JUMP = 4,  // Register, memory or far jump: no known successor
+    DISASM_FLOW_INDIRECT_CALL = 5,  // Register, memory or far call: next instruction
+    DISASM_FLOW_RETURN = 6,         // Return: no successor
+    DISASM_FLOW_STOP = 7            // hlt, int3, ud0/1/2 or invalid: no successor
+} DisasmFlow;
+
+/*
+ * Instruction starts and branch targets of a code buffer, one bit per byte
+ */
+typedef struct {
+    uint64_t address;           // Virtual address of the first byte
+    size_t length;              // Number of bytes covered
+    uint64_t* starts;           // Bit i: a valid instruction starts at offset i
+    uint64_t* targets;          // Bit i: offset i is a seed or a relative branch or call target
+    uint64_t* calls;            // Bit i: offset i is a seed or a relative call target
+    size_t instruction_count;   // Number of bits set in starts
+} CodeMap;
+
+/*
+ * Bump allocator
+ *
+ * Hands out memory from large chunks and frees everything at once.
+ */
+typedef struct {
+    void* chunks;               // Most recent chunk; each starts with a link to the previous one
+    uint8_t* cursor;            // Next free byte of the current chunk
+    uint8_t* limit;             // End of the current chunk
+    size_t chunk_size;          // Size of regular chunks
+    size_t allocated;           // Bytes handed out
+} DisasmArena;
+
+/*
+ * Control flow graph edge kinds
+ */
+typedef enum {
+    DISASM_EDGE_FALLTHROUGH = 0,    // To the next block in address order
+    DISASM_EDGE_BRANCH = 1,         // Taken conditional branch
+    DISASM_EDGE_JUMP = 2            // Unconditional jump
+} DisasmEdgeType;
+
+struct BasicBlock;
+
+typedef struct {
+    struct BasicBlock* from;
+    struct BasicBlock* to;
+    DisasmEdgeType type;
+} BlockEdge;
+
+/*
+ * Basic block: a run of instructions entered only at the first and left
+ * only after the last
+ */
+typedef struct BasicBlock {
+    uint64_t start;             // Address of the first instruction
+    uint64_t end;               // Address past the last instruction
+    size_t first;               // Index of the first instruction in the decoded records
+    uint32_t instruction_count;
+    DisasmFlow flow;            // Control flow of the last instruction
+    BlockEdge* successors;      // successor_count edges leaving this block
+    BlockEdge** predecessors;   // predecessor_count edges entering this block
+    uint32_t successor_count;
+    uint32_t predecessor_count;
+} BasicBlock;
+
+/*
+ * Control flow graph, allocated from an arena
+ */
+typedef struct {
+    BasicBlock* blocks;         // Sorted by start address
+    size_t block_count;
+    BlockEdge* edges;           // Grouped by source block
+    size_t edge_count;
+} ControlFlowGraph;
+
+/*
+ * Cross-reference kinds
+ */
+typedef enum {
+    DISASM_XREF_BRANCH = 0,         // Conditional relative branch (jcc, loop, jcxz, xbegin)
+    DISASM_XREF_JUMP = 1,           // Unconditional relative jump
+    DISASM_XREF_CALL = 2,           // Relative call
+    DISASM_XREF_DATA = 3            // RIP-relative memory operand
+} DisasmXrefType;
+
+/*
+ * Cross-reference index
+ *
+ * Parallel arrays sorted by target, then by source. A loaded index points
+ * into the mapped file until references are committed to it.
+ */
+typedef struct {
+    uint64_t* targets;          // Referenced addresses, sorted
+    uint64_t* sources;          // Address of the referencing instruction
+    uint8_t* types;             // DisasmXrefType
+    size_t count;               // Committed references
+    size_t capacity;            // Allocated references, 0 when empty or mapped
+    void* pending;              // References added since the last commit
+    size_t pending_count;
+    size_t pending_capacity;
+    MappedFile file;            // Saved index the arrays point into
+} XrefIndex;
+
+/*
+ * Decoded instruction cache, shared by any number of threads
+ */
+typedef struct {
+    void* shards;               // Internal: shard_count locked tables
+    unsigned int shard_count;   // Power of two
+    unsigned int set_count;     // Sets per shard, power of two
+    DisasmMode mode;
+} DecodeCache;
+
+/*
+ * Decoded instruction cache counters
+ */
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;            // Lookups that decoded, stale ones included
+    uint64_t stale;             // Lookups that found the address with different bytes
+    size_t entries;             // Entries in use
+} DecodeCacheStats;
+
+/*
+ * Address range
+ */
+typedef struct {
+    uint64_t start;             // First byte
+    uint64_t end;               // Past the last byte
+} AddressRange;
+
+/*
+ * Records of a decoded listing starting in one chunk of its code
+ */
+typedef struct {
+    DecodedInstruction* insns;  // In address order
+    size_t count;
+    size_t capacity;
+} ListingChunk;
+
+/*
+ * Linear sweep of a code buffer that can be patched
+ *
+ * The records are kept in chunks by address so a patch only rewrites the
+ * chunks it touches.
+ */
+typedef struct {
+    DisasmMode mode;
+    const uint8_t* code;        // The bytes decoded; patches are made to them in place
+    size_t length;
+    uint64_t address;           // Virtual address of code[0]
+    size_t end;                 // Offset where the sweep stopped: length, or a truncated instruction
+    ListingChunk* chunks;       // Chunk i: records starting at offsets [i * 4 KB, (i + 1) * 4 KB)
+    size_t chunk_count;
+    size_t instruction_count;
+} DecodedListing;
+
+/*
+ * Streaming decoder state
+ *
+ * Holds no more of the input than the start of one instruction split by
+ * the end of a chunk.
+ */
+typedef struct {
+    DisasmMode mode;
+    uint64_t address;           // Virtual address of the next byte to decode
+    const uint8_t* input;       // Rest of the chunk being decoded
+    size_t input_length;
+    uint8_t carry[X86_MAX_INSTRUCTION_LENGTH - 1];  // Bytes carried over from earlier chunks
+    unsigned int carry_length;
+    int finished;               // No chunk follows the current one
+} DisasmStream;
+
+/*
+ * Decoded instructions of a code buffer, mapped from a store file
+ *
+ * Rows are kept in blocks of block_rows rows. A block holds the columns of
+ * InstructionColumns for its rows, with offsets relative to the first
+ * instruction of the block, and a column of resolved targets.
+ */
+typedef struct {
+    DisasmMode mode;
+    uint64_t hash;              // x86_content_hash of the decoded bytes
+    uint64_t length;            // Bytes decoded
+    uint64_t address;           // Virtual address of the first byte
+    uint64_t end;               // Offset where decoding stopped: length, or a truncated instruction
+    size_t instruction_count;
+    size_t block_rows;
+    size_t block_count;
+    const uint64_t* block_offsets;  // Offset in the code of the first instruction of each block
+    const uint8_t* blocks;
+    MappedFile file;
+} DecodedStore;
+
+/*
+ * Kinds of instruction index terms, and their values
+ */
+typedef enum {
+    DISASM_TERM_OPCODE = 0,         // map << 8 | opcode, e.g. 0x105 for 0F 05 (syscall)
+    DISASM_TERM_MODRM_REG = 1,      // ModR/M reg field with REX.R and EVEX.R', 0-31
+    DISASM_TERM_READ = 2,           // Register read, reg_class << 8 | index; memory operand bases and indexes are read
+    DISASM_TERM_WRITE = 3,          // Register written, reg_class << 8 | index
+    DISASM_TERM_IMMEDIATE = 4       // Immediate as encoded, zero-extended (not relative branch offsets)
+} DisasmTermKind;
+
+typedef struct {
+    DisasmTermKind kind;
+    uint64_t value;
+} IndexTerm;
+
+/*
+ * Inverted index of the instructions of a code buffer
+ *
+ * One list of instruction offsets per term, bit-packed deltas in blocks with
+ * skip entries.
+ */
+typedef struct {
+    void* terms;                // Internal: sorted by kind, then value
+    size_t term_count;
+    void* skips;                // Internal: first posting and data offset of each block
+    uint8_t* data;              // Bit-packed deltas
+    size_t data_size;
+    size_t instruction_count;
+    size_t posting_count;
+} InstructionIndex;
+
+/*
+ * Compiled set of byte signatures
+ */
+typedef struct {
+    void* data;                 // Internal: patterns, buckets and prefilter tables
+    size_t pattern_count;
+} SignatureSet;
+
+typedef struct {
+    uint64_t address;           // Virtual address of the first byte of the match
+    uint32_t pattern;           // Index of the pattern in the compiled set
+} SignatureMatch;
+
+/*
+ * Offsets where signature matches may start
+ */
+typedef enum {
+    DISASM_SIGNATURE_SWEEP = 0,     // Instruction starts of a linear sweep, decoded in the same pass
+    DISASM_SIGNATURE_STARTS = 1,    // Bits set in a caller's bitmap, e.g. CodeMap.starts
+    DISASM_SIGNATURE_ANY = 2        // Every offset
+} DisasmSignatureAlign;
+
+/*
+ * Function to disassemble an instruction (64-bit mode)
+ */
+unsigned int x86_disasm(const void* code, InstructionInfo* info);
+
+/*
+ * Functions to disassemble an instruction in a specific CPU mode
+ *
+ * Each mode has its own compiled decoder; x86_disasm64 is x86_disasm.
+ */
+unsigned int x86_disasm64(const void* code, InstructionInfo* info);
+unsigned int x86_disasm32(const void* code, InstructionInfo* info);
+unsigned int x86_disasm16(const void* code, InstructionInfo* info);
+
+/*
+ * Function to disassemble a whole code buffer
+ *
+ * Decodes instructions from code[0..length) into out[0..max_count), where the
+ * first byte of code is located at the virtual address 'address'. Never reads
+ * past the end of the buffer. Relative branches and RIP-relative operands
+ * get their absolute target in the record. Returns the number of records
+ * written; result (optional) receives where and why decoding stopped.
+ */
+size_t x86_disasm_batch(const void* code, size_t length, uint64_t address,
+    DecodedInstruction* out, size_t max_count, DisasmBatchResult* result);
+
+/*
+ * Function to disassemble a whole code buffer in a specific CPU mode
+ *
+ * Same as x86_disasm_batch; the mode is dispatched once per call.
+ */
+size_t x86_disasm_batch_mode(DisasmMode mode, const void* code, size_t length, uint64_t address,
+    DecodedInstruction* out, size_t max_count, DisasmBatchResult* result);
+
+/*
+ * Function to disassemble a whole code buffer into packed records
+ *
+ * Same buffer handling as x86_disasm_batch; offsets in the records and in
+ * result are relative to the start of code.
+ */
+size_t x86_disasm_packed(const void* code, size_t length, PackedInstruction* out,
+    size_t max_count, DisasmBatchResult* result);
+
+/*
+ * Function to pack a decoded instruction, in any CPU mode
+ *
+ * offset is the offset of the instruction in the buffer it was decoded
+ * from, as in the records of x86_disasm_packed.
+ */
+void x86_pack_instruction(const InstructionInfo* info, uint32_t offset, PackedInstruction* out);
+
+/*
+ * Functions to read the displacement and immediate of a packed record
+ *
+ * code is the buffer the record was decoded from. The displacement is
+ * sign-extended; the immediate is returned zero-extended as stored.
+ */
+int64_t x86_packed_displacement(const PackedInstruction* insn, const void* code);
+uint64_t x86_packed_immediate(const PackedInstruction* insn, const void* code);
+
+/*
+ * Function to expand a packed record back into an InstructionInfo
+ */
+unsigned int x86_unpack_instruction(const PackedInstruction* insn, const void* code, InstructionInfo* info);
+
+/*
+ * Functions to manage a structure-of-arrays batch container
+ *
+ * x86_columns_init returns 0 when the allocation fails.
+ */
+int x86_columns_init(InstructionColumns* columns, size_t capacity);
+void x86_columns_free(InstructionColumns* columns);
+void x86_columns_get(const InstructionColumns* columns, size_t index, PackedInstruction* out);
+
+/*
+ * Function to disassemble a whole code buffer into columns
+ *
+ * Replaces the contents of columns with up to columns->capacity rows.
+ * Buffer handling and result reporting match x86_disasm_packed.
+ */
+size_t x86_disasm_columns(const void* code, size_t length, InstructionColumns* columns,
+    DisasmBatchResult* result);
+
+/*
+ * Function to compute the length of an instruction
+ *
+ * Returns the same length as x86_disasm without filling an InstructionInfo.
+ * Reads at most X86_MAX_INSTRUCTION_LENGTH bytes. The saving is the record
+ * stores and the validators, not the decode itself: walking a buffer is
+ * still one dependent step per instruction, and `DisassemblerTester bench`
+ * measures about 1.5-2x over x86_disasm.
+ */
+unsigned int x86_insn_length(const void* code);
+
+/*
+ * Function to compute the length of an instruction in a specific CPU mode
+ */
+unsigned int x86_insn_length_mode(DisasmMode mode, const void* code);
+
+/*
+ * Function to compute the lengths of all instructions in a code buffer
+ *
+ * Stores the length of each instruction in code[0..length) into
+ * lengths[0..max_count). Buffer handling and result reporting match
+ * x86_disasm_batch; result->address is relative to the start of code.
+ */
+size_t x86_insn_length_batch(const void* code, size_t length, uint8_t* lengths,
+    size_t max_count, DisasmBatchResult* result);
+
+/*
+ * Function to compute the lengths of all instructions in a specific CPU mode
+ */
+size_t x86_insn_length_batch_mode(DisasmMode mode, const void* code, size_t length, uint8_t* lengths,
+    size_t max_count, DisasmBatchResult* result);
+
+/*
+ * Function to classify the bytes of a code buffer
+ *
+ * Fills blocks[i] with the masks for code[64*i .. 64*i+64); bits past the
+ * end of the buffer are zero. Returns the number of blocks written, which
+ * is (length + 63) / 64.
+ *
+ * The decoders do not call it. Walking from one instruction to the next
+ * is latency-bound, and taking the prefix run from these masks measured
+ * slower than the per-byte loop of x86_insn_length_batch. It is meant for
+ * callers that want the prefix and escape bytes of a whole buffer at once.
+ */
+size_t x86_classify_bytes(const void* code, size_t length, ByteClassBlock* blocks);
+
+/*
+ * Functions to query and limit the byte classifier implementation
+ *
+ * The best level supported by the CPU is selected on first use;
+ * x86_scan_set_level() can lower it (e.g. for benchmarking) but never
+ * raises it past what the CPU supports. The level also selects the
+ * signature scanner's prefilter. Returns the level now in use.
+ */
+DisasmScanLevel x86_scan_level(void);
+DisasmScanLevel x86_scan_set_level(DisasmScanLevel level);
+
+/*
+ * Function to format a decoded instruction as text (64-bit mode)
+ *
+ * Writes Intel or AT&T syntax (DisasmFormat) into buffer without allocating.
+ * address is the instruction's virtual address, used for branch targets.
+ * Like snprintf, the text is truncated to size - 1 characters and
+ * NUL-terminated, and the return value is the full text length; a buffer of
+ * X86_FORMAT_BUFFER_SIZE bytes never truncates.
+ */
+size_t x86_format(const InstructionInfo* info, uint64_t address, unsigned int format,
+    char* buffer, size_t size);
+
+/*
+ * Function to format a decoded instruction in a specific CPU mode
+ */
+size_t x86_format_mode(DisasmMode mode, const InstructionInfo* info, uint64_t address, unsigned int format,
+    char* buffer, size_t size);
+
+/*
+ * Function to format a batch of decoded instructions (64-bit mode)
+ *
+ * Writes one line per instruction, ending in '\n', back to back into
+ * buffer; DISASM_FORMAT_ADDRESS and DISASM_FORMAT_BYTES add the address and
+ * the instruction bytes in front of the text. Stops before an instruction
+ * whose worst-case line would not fit. Returns the number of instructions
+ * formatted; written (optional) receives the number of characters. The text
+ * is NUL-terminated when there is room.
+ */
+size_t x86_format_batch(const DecodedInstruction* insns, size_t count, unsigned int format,
+    char* buffer, size_t size, size_t* written);
+
+/*
+ * Function to format a batch of decoded instructions in a specific CPU mode
+ */
+size_t x86_format_batch_mode(DisasmMode mode, const DecodedInstruction* insns, size_t count, unsigned int format,
+    char* buffer, size_t size, size_t* written);
+
+/*
+ * Function to decode the explicit operands of an instruction
+ *
+ * Fills operands[0..X86_MAX_OPERANDS) in Intel order (destination first)
+ * and returns the count. Implicit operands (the rAX of MUL, the flags) are
+ * not listed. Returns 0 for invalid instructions and for encodings the
+ * formatter prints as "(bad)".
+ */
+unsigned int x86_decode_operands(DisasmMode mode, const InstructionInfo* info, InstructionOperand* operands);
+
+/*
+ * Functions to access operands on demand
+ */
+void x86_operands_init(InstructionOperands* operands, DisasmMode mode, const InstructionInfo* info);
+unsigned int x86_operand_count(InstructionOperands* operands);
+const InstructionOperand* x86_operand(InstructionOperands* operands, unsigned int index);
+
+/*
+ * Functions to map a file read-only
+ *
+ * flags is a combination of DisasmMapFlags. x86_map_file returns 0 when the
+ * file cannot be opened or mapped. An empty file maps to data == NULL.
+ */
+int x86_map_file(const char* path, unsigned int flags, MappedFile* file);
+void x86_unmap_file(MappedFile* file);
+
+/*
+ * Function to load an executable image
+ *
+ * Maps the file and lists its executable regions with their virtual
+ * addresses, ready to be passed to x86_disasm_batch_mode as they are.
+ * Supports ELF32 (x86) and ELF64 (x86-64): executable SHT_PROGBITS
+ * sections, or executable PT_LOAD segments when the section headers are
+ * missing; defined function symbols become functions. Supports PE32 (x86)
+ * and PE32+ (x64): executable sections at ImageBase + RVA, in the on-disk
+ * layout or, with DISASM_MAP_MEMORY_LAYOUT, the loaded layout; PE32+
+ * exception directory entries become functions.
+ * The image must be released with x86_image_free, also on error.
+ */
+DisasmImageStatus x86_image_load(const char* path, unsigned int map_flags, LoadedImage* image);
+void x86_image_free(LoadedImage* image);
+
+/*
+ * Function to find the code at a virtual address
+ *
+ * Returns a pointer into the executable region containing address and the
+ * number of bytes from there to the end of the region, or NULL when address
+ * is not in an executable region.
+ */
+const uint8_t* x86_image_code(const LoadedImage* image, uint64_t address, size_t* available);
+
+/*
+ * Function to disassemble a whole code buffer on several threads
+ *
+ * Same arguments, records and result as x86_disasm_batch_mode; the output
+ * is identical to the serial sweep. Chunks of the buffer are decoded
+ * speculatively in parallel and stitched at the true instruction
+ * boundaries. threads = 0 uses one thread per hardware thread; small
+ * buffers are decoded serially.
+ */
+size_t x86_sweep_parallel(DisasmMode mode, const void* code, size_t length, uint64_t address,
+    DecodedInstruction* out, size_t max_count, unsigned int threads, DisasmBatchResult* result);
+
+/*
+ * Function to classify the control flow of a decoded instruction
+ */
+DisasmFlow x86_control_flow(const InstructionInfo* info);
+
+/*
+ * Function to disassemble a code buffer by recursive descent
+ *
+ * Follows fall-through and relative branch and call targets from the seed
+ * addresses, decoding every reachable offset once. Targets outside the
+ * buffer are not followed. Threads share the work through per-thread
+ * work-stealing queues; threads = 0 uses one per hardware thread. Returns
+ * 0 when an allocation fails. The map must be released with
+ * x86_code_map_free, also on error.
+ */
+int x86_descent(DisasmMode mode, const void* code, size_t length, uint64_t address,
+    const uint64_t* seeds, size_t seed_count, unsigned int threads, CodeMap* map);
+void x86_code_map_free(CodeMap* map);
+
+/*
+ * Functions to manage a bump allocator
+ *
+ * chunk_size = 0 selects the default (1 MB). Allocations are 16-byte
+ * aligned; larger ones than a chunk get a chunk of their own.
+ * x86_arena_alloc returns NULL when the allocation fails.
+ */
+void x86_arena_init(DisasmArena* arena, size_t chunk_size);
+void* x86_arena_alloc(DisasmArena* arena, size_t size);
+void x86_arena_free(DisasmArena* arena);
+
+/*
+ * Function to build the control flow graph of decoded instructions
+ *
+ * insns must be in address order, as x86_disasm_batch writes them; gaps
+ * are allowed. Blocks start at the first instruction, at relative branch,
+ * jump and call targets, after gaps and after instructions that end a
+ * block (branches, jumps, returns, stops); calls do not end a block.
+ * Branch targets that are not the start of a decoded instruction get no
+ * edge. All blocks and edges come from the arena and live until it is
+ * freed. Returns 0 when an allocation fails.
+ */
+int x86_cfg_build(const DecodedInstruction* insns, size_t count, DisasmArena* arena, ControlFlowGraph* cfg);
+
+/*
+ * Function to find the block containing an address
+ */
+BasicBlock* x86_cfg_block(const ControlFlowGraph* cfg, uint64_t address);
+
+/*
+ * Function to find the function boundaries of an image
+ *
+ * Combines the image's entry point and functions (symbols, exception
+ * directory) with what a linear sweep of the executable regions shows:
+ * relative call targets, and prologues or aligned starts after a block
+ * end and its padding. The sweep and the analysis run on 'threads'
+ * threads (0 = one per hardware thread). Known extents are kept; other
+ * functions end at the next one, less the padding in between. On success
+ * *functions receives count sorted, non-overlapping ranges, to be
+ * released with x86_functions_free. Returns 0 when an allocation fails.
+ */
+int x86_find_functions(const LoadedImage* image, unsigned int threads, FunctionRange** functions, size_t* count);
+void x86_functions_free(FunctionRange* functions);
+
+/*
+ * Functions to build a cross-reference index
+ *
+ * x86_xref_add collects the relative branch, jump and call targets and the
+ * RIP-relative addresses of decoded records; x86_xref_add_code decodes a
+ * code buffer in batches and does the same, without keeping the records.
+ * References become visible to lookups once committed. Committing after
+ * each section keeps the index usable while more sections are added; the
+ * same code must not be added twice. Records added in address order, as
+ * the batch functions write them, sort fastest. All return 0 when an
+ * allocation fails.
+ */
+void x86_xref_init(XrefIndex* index);
+int x86_xref_add(XrefIndex* index, const DecodedInstruction* insns, size_t count);
+int x86_xref_add_code(XrefIndex* index, DisasmMode mode, const void* code, size_t length, uint64_t address);
+int x86_xref_commit(XrefIndex* index);
+void x86_xref_free(XrefIndex* index);
+
+/*
+ * Functions to look up cross-references
+ *
+ * Return the number of committed references to target, or to targets in
+ * [start, end); *first receives the index of the first one in the arrays.
+ * Binary searches: O(log n).
+ */
+size_t x86_xref_find(const XrefIndex* index, uint64_t target, size_t* first);
+size_t x86_xref_range(const XrefIndex* index, uint64_t start, uint64_t end, size_t* first);
+
+/*
+ * Function to update a cross-reference index after re-decoding
+ *
+ * Removes the committed references of the removed records and adds those
+ * of the added ones. Only the part of the arrays between the first and
+ * the last reference touched is rewritten; the rest moves by the change
+ * in count, and not at all when it is zero. Returns 0 when an allocation
+ * fails.
+ */
+int x86_xref_replace(XrefIndex* index, const DecodedInstruction* removed, size_t removed_count,
+    const DecodedInstruction* added, size_t added_count);
+
+/*
+ * Functions to save and load a cross-reference index
+ *
+ * The file is the committed arrays behind a small header, in host byte
+ * order; x86_xref_load maps it and uses it in place. Committing to a
+ * loaded index copies it to memory first. Both return 0 on I/O errors,
+ * x86_xref_load also on a file that is not a saved index. A loaded index
+ * must be released with x86_xref_free.
+ */
+int x86_xref_save(const XrefIndex* index, const char* path);
+int x86_xref_load(const char* path, unsigned int map_flags, XrefIndex* index);
+
+/*
+ * Functions to manage a decoded instruction cache
+ *
+ * capacity is the number of records kept (0 = 64K), rounded up to fill the
+ * shards. x86_cache_init returns 0 when an allocation fails; the cache must
+ * be released with x86_cache_free.
+ */
+int x86_cache_init(DecodeCache* cache, DisasmMode mode, size_t capacity);
+void x86_cache_clear(DecodeCache* cache);
+void x86_cache_free(DecodeCache* cache);
+
+/*
+ * Function to decode an instruction through the cache
+ *
+ * code points to the current bytes at address, with 'available' bytes
+ * readable. Returns the instruction length and the record, as
+ * x86_disasm_batch_mode would decode it, or 0 when the instruction runs
+ * past 'available'. A cached record is only returned when the bytes it was
+ * decoded from still match code, so patched bytes are decoded again. Safe
+ * to call from several threads at once.
+ */
+unsigned int x86_cache_decode(DecodeCache* cache, const void* code, size_t available, uint64_t address,
+    DecodedInstruction* out);
+
+/*
+ * Function to read the counters of a decoded instruction cache
+ */
+void x86_cache_stats(DecodeCache* cache, DecodeCacheStats* stats);
+
+/*
+ * Functions to manage a decoded listing
+ *
+ * x86_listing_build sweeps code linearly on 'threads' threads (0 = one per
+ * hardware thread), as x86_sweep_parallel does. code must stay valid, and
+ * is where patches are applied. Returns 0 when an allocation fails; the
+ * listing must be released with x86_listing_free, also on error.
+ */
+int x86_listing_build(DecodedListing* listing, DisasmMode mode, const void* code, size_t length, uint64_t address,
+    unsigned int threads);
+void x86_listing_free(DecodedListing* listing);
+
+/*
+ * Functions to read a decoded listing
+ *
+ * x86_listing_find returns the record holding address, or NULL past the
+ * end of the sweep. x86_listing_copy copies the records starting in
+ * [start, end), in address order, e.g. to build the control flow graph of
+ * a function, and returns their number.
+ */
+const DecodedInstruction* x86_listing_find(const DecodedListing* listing, uint64_t address);
+size_t x86_listing_copy(const DecodedListing* listing, uint64_t start, uint64_t end,
+    DecodedInstruction* out, size_t max_count);
+
+/*
+ * Function to re-decode patched bytes of a listing
+ *
+ * Call after changing the bytes in patches (any order, may overlap) in
+ * place. Each span is re-decoded from the instruction holding its first
+ * byte until the new instructions fall back in step with the old ones,
+ * past its last byte; the records of the span are replaced and, with
+ * xrefs, so are their references (see x86_xref_replace). The re-decoded
+ * spans are written to redecoded, which has room for patch_count ranges,
+ * if not NULL; blocks overlapping them are the ones to rebuild. Returns 0
+ * when an allocation fails.
+ */
+int x86_listing_patch(DecodedListing* listing, const AddressRange* patches, size_t patch_count,
+    XrefIndex* xrefs, AddressRange* redecoded, size_t* redecoded_count);
+
+/*
+ * Functions to decode a stream of code
+ *
+ * x86_stream_init starts a stream at the virtual address 'address'. Each
+ * chunk of input, of any size, is passed to x86_stream_feed and decoded by
+ * calling x86_stream_decode until it returns 0; the chunk must stay valid
+ * until then, and is not copied beyond the last 14 bytes. x86_stream_finish
+ * marks the current chunk (possibly empty) as the last one, so the bytes
+ * carried over are decoded too. The records are the same, split in any
+ * way, as those of x86_disasm_batch_mode over the whole input; the bytes
+ * of an instruction truncated by the end of the input are left in carry.
+ */
+void x86_stream_init(DisasmStream* stream, DisasmMode mode, uint64_t address);
+void x86_stream_feed(DisasmStream* stream, const void* data, size_t length);
+void x86_stream_finish(DisasmStream* stream);
+size_t x86_stream_decode(DisasmStream* stream, DecodedInstruction* out, size_t max_count);
+
+/*
+ * Function to hash the contents of a buffer
+ *
+ * XXH64 with seed 0; identifies the code a store file was written for.
+ */
+uint64_t x86_content_hash(const void* data, size_t length);
+
+/*
+ * Functions to save and map decoded instructions
+ *
+ * x86_store_write decodes code linearly and writes the records to path
+ * one block at a time, in a versioned column format keyed by the content
+ * hash of code; it returns 0 (and leaves no file) on failure.
+ * x86_store_load maps a store file and only checks its header, so it
+ * takes the same time for any size; the caller compares store->hash,
+ * mode and address with its own input. Returns 0 when the file cannot be
+ * mapped or is not a store; the store must be released with
+ * x86_store_free.
+ */
+int x86_store_write(const char* path, DisasmMode mode, const void* code, size_t length, uint64_t address);
+int x86_store_load(const char* path, unsigned int map_flags, DecodedStore* store);
+void x86_store_free(DecodedStore* store);
+
+/*
+ * Function to read a block of a store
+ *
+ * Points columns (read-only) and targets into the mapping and returns the
+ * number of rows of the block. Offsets in the columns are relative to
+ * store->block_offsets[block]: pass code + that offset to the packed
+ * record accessors.
+ */
+size_t x86_store_block(const DecodedStore* store, size_t block, InstructionColumns* columns, const uint64_t** targets);
+
+/*
+ * Functions to manage an instruction index
+ *
+ * x86_index_build decodes code (smaller than 4 GB) linearly and indexes
+ * the terms of every valid instruction under its offset in code. Returns
+ * 0 when an allocation fails.
+ */
+int x86_index_build(InstructionIndex* index, DisasmMode mode, const void* code, size_t length);
+void x86_index_free(InstructionIndex* index);
+
+/*
+ * Functions to query an instruction index
+ *
+ * x86_index_count returns the number of instructions with a term.
+ * x86_index_and and x86_index_or find the instructions with all, or any,
+ * of the terms: match_count receives their number and out the first
+ * max_count of their offsets, in increasing order. Both return 0 when an
+ * allocation fails.
+ */
+size_t x86_index_count(const InstructionIndex* index, IndexTerm term);
+int x86_index_and(const InstructionIndex* index, const IndexTerm* terms, size_t term_count, uint32_t* out,
+    size_t max_count, size_t* match_count);
+int x86_index_or(const InstructionIndex* index, const IndexTerm* terms, size_t term_count, uint32_t* out,
+    size_t max_count, size_t* match_count);
+
+/*
+ * Functions to combine sorted lists of offsets
+ *
+ * For nested queries over the results of x86_index_and/x86_index_or.
+ * Both return the number of offsets written to out; the intersection may
+ * be written over a, the union needs room for a_count + b_count.
+ */
+size_t x86_postings_intersect(const uint32_t* a, size_t a_count, const uint32_t* b, size_t b_count, uint32_t* out);
+size_t x86_postings_union(const uint32_t* a, size_t a_count, const uint32_t* b, size_t b_count, uint32_t* out);
+
+/*
+ * Functions to manage a signature set
+ *
+ * Patterns are hex bytes such as "48 8B 05 ?? ?? ?? ?? 48 85 C0"; "??"
+ * matches any byte and a "?" nibble any nibble. Spaces are optional. A
+ * pattern is at most 256 bytes with at least one fixed nibble. Returns 0
+ * when a pattern is invalid, with its index in bad_pattern, or when an
+ * allocation fails, with count in bad_pattern.
+ */
+int x86_signature_compile(SignatureSet* set, const char* const* patterns, size_t count, size_t* bad_pattern);
+void x86_signature_free(SignatureSet* set);
+
+/*
+ * Function to find all signatures of a set in a code buffer
+ *
+ * One pass over code: an anchor of each pattern is looked for with nibble
+ * tables, 32 offsets per step at DISASM_SCAN_AVX2, and only candidates at
+ * allowed offsets are compared in full. starts (bit i for offset i) is
+ * only read with DISASM_SIGNATURE_STARTS; known starts avoid the cost of
+ * the sweep.
+ * match_count receives the number of matches and out the first max_count,
+ * by address, then pattern; out may be NULL to only count them. Returns 0
+ * when an allocation fails.
+ */
+int x86_signature_scan(const SignatureSet* set, DisasmMode mode, const void* code, size_t length, uint64_t address,
+    DisasmSignatureAlign align, const uint64_t* starts, SignatureMatch* out, size_t max_count, size_t* match_count);
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/*
+ * Bitmaps over code offsets
+ *
+ * One bit per byte, bit i of a map is bit (i % 64) of word i / 64. The
+ * atomic helpers let several threads mark the same map; plain reads are
+ * only used once the writers are done.
+ */
+#define BITMAP_WORDS(bits)      (((bits) + 63) / 64)
+
+static inline unsigned int popcount64(uint64_t value) {
+#ifdef _MSC_VER
+    return (unsigned int)__popcnt64(value);
+#else
+    return (unsigned int)__builtin_popcountll(value);
+#endif
+}
+
+static inline unsigned int count_trailing_zeros64(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (unsigned int)index;
+#else
+    return (unsigned int)__builtin_ctzll(value);
+#endif
+}
+
+static inline int bitmap_test(const uint64_t* bitmap, size_t bit) {
+    return (bitmap[bit / 64] >> (bit % 64)) & 1;
+}
+
+static inline void bitmap_set(uint64_t* bitmap, size_t bit) {
+    bitmap[bit / 64] |= (uint64_t)1 << (bit % 64);
+}
+
+// Reads a bit that other threads may be setting
+static inline int bitmap_atomic_test(const uint64_t* bitmap, size_t bit) {
+#ifdef _MSC_VER
+    return (int)((*(const volatile uint64_t*)&bitmap[bit / 64] >> (bit % 64)) & 1);
+#else
+    return (int)((__atomic_load_n(&bitmap[bit / 64], __ATOMIC_RELAXED) >> (bit % 64)) & 1);
+#endif
+}
+
+// Sets a bit and returns its previous value
+static inline int bitmap_atomic_set(uint64_t* bitmap, size_t bit) {
+    uint64_t mask = (uint64_t)1 << (bit % 64);
+#ifdef _MSC_VER
+    return (_InterlockedOr64((volatile __int64*)&bitmap[bit / 64], (__int64)mask) & mask) != 0;
+#else
+    return (__atomic_fetch_or(&bitmap[bit / 64], mask, __ATOMIC_RELAXED) & mask) != 0;
+#endif
+}
+
+static inline void bitmap_atomic_clear(uint64_t* bitmap, size_t bit) {
+    uint64_t mask = (uint64_t)1 << (bit % 64);
+#ifdef _MSC_VER
+    _InterlockedAnd64((volatile __int64*)&bitmap[bit / 64], (__int64)~mask);
+#else
+    __atomic_fetch_and(&bitmap[bit / 64], ~mask, __ATOMIC_RELAXED);
+#endif
+}
+
+// Sets the bits [from, to)
+static inline void bitmap_atomic_set_range(uint64_t* bitmap, size_t from, size_t to) {
+    while (from < to) {
+        size_t end = (from | 63) + 1 < to ? (from | 63) + 1 : to;
+        uint64_t mask = (end - from == 64 ? ~(uint64_t)0 : (((uint64_t)1 << (end - from)) - 1)) << (from % 64);
+#ifdef _MSC_VER
+        _InterlockedOr64((volatile __int64*)&bitmap[from / 64], (__int64)mask);
+#else
+        __atomic_fetch_or(&bitmap[from / 64], mask, __ATOMIC_RELAXED);
+#endif
+        from = end;
+    }
+}
+
+// Number of set bits in [from, to)
+static inline size_t bitmap_count(const uint64_t* bitmap, size_t from, size_t to) {
+    size_t count = 0;
+
+    while (from < to && from % 64) {
+        count += bitmap_test(bitmap, from++);
+    }
+    for (; from + 64 <= to; from += 64) {
+        count += popcount64(bitmap[from / 64]);
+    }
+    while (from < to) {
+        count += bitmap_test(bitmap, from++);
+    }
+
+    return count;
+}
+
+// First set bit in [from, to), or to when there is none
+static inline size_t bitmap_next(const uint64_t* bitmap, size_t from, size_t to) {
+    while (from < to) {
+        uint64_t word = bitmap[from / 64] >> (from % 64);
+
+        if (word) {
+            from += count_trailing_zeros64(word);
+            return from < to ? from : to;
+        }
+        from = (from | 63) + 1;
+    }
+
+    return to;
+}
@@ -0,0 +1,245 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <thread>
+#include "disassm.h"
+
+/*
+ * Decoded instruction cache
+ *
+ * The table is split into shards of set-associative entries. Lookups take
+ * no lock: each entry carries a sequence number that is odd while the
+ * entry is written, and a reader copies the entry and keeps the copy only
+ * if the number was even and unchanged around it. Inserts take the lock of
+ * their shard, so writers only meet on the same shard.
+ *
+ * An entry keeps the bytes it was decoded from and is only returned when
+ * the bytes at the address still match them: the decode of an instruction
+ * depends on nothing else, so a match is exactly as good as decoding
+ * again, and patched code is always decoded afresh.
+ */
+#define CACHE_WAYS              4
+#define CACHE_DEFAULT_ENTRIES   65536
+#define CACHE_MIN_SHARDS        16
+#define CACHE_LINE              64
+
+typedef struct {
+    std::atomic<uint32_t> sequence;     // Odd while the entry is written
+    uint8_t checked;                    // Bytes to compare; 0 for an empty entry
+    uint8_t bytes[16];                  // The checked bytes, zero after them
+    uint64_t address;
+    DecodedInstruction record;
+} CacheEntry;
+
+typedef struct {
+    std::mutex lock;                    // Held by writers
+    CacheEntry* entries;                // set_count sets of CACHE_WAYS entries
+    uint8_t* victims;                   // Next way to replace in each set
+    size_t used;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> stale;
+    uint8_t padding[CACHE_LINE];        // Keeps the counters of neighbouring shards apart
+} CacheShard;
+
+static inline uint64_t hash_address(uint64_t address) {
+    return address * 0x9E3779B97F4A7C15ull;
+}
+
+static inline unsigned int round_up_pow2(size_t value) {
+    unsigned int result = 1;
+    while (result < value) {
+        result *= 2;
+    }
+    return result;
+}
+
+// Compares the first 'checked' bytes of code with an entry's bytes
+static inline int same_bytes(const uint8_t* bytes, unsigned int checked, const uint8_t* code, size_t available) {
+    if (available >= 16) {
+        uint64_t code_low, code_high, low, high;
+        uint64_t mask_low = checked >= 8 ? ~(uint64_t)0 : ((uint64_t)1 << (checked * 8)) - 1;
+        uint64_t mask_high = checked <= 8 ? 0 : ((uint64_t)1 << ((checked - 8) * 8)) - 1;
+
+        memcpy(&code_low, code, 8);
+        memcpy(&code_high, code + 8, 8);
+        memcpy(&low, bytes, 8);
+        memcpy(&high, bytes + 8, 8);
+        return ((code_low & mask_low) == low) & ((code_high & mask_high) == high);
+    }
+
+    return checked <= available && memcmp(bytes, code, checked) == 0;
+}
+
+int x86_cache_init(DecodeCache* cache, DisasmMode mode, size_t capacity) {
+    CacheShard* shards;
+    unsigned int threads = std::thread::hardware_concurrency();
+
+    memset(cache, 0, sizeof(*cache));
+    cache->mode = mode;
+    cache->shard_count = round_up_pow2(threads * 4 > CACHE_MIN_SHARDS ? threads * 4 : CACHE_MIN_SHARDS);
+    cache->set_count = round_up_pow2(((capacity ? capacity : CACHE_DEFAULT_ENTRIES) / CACHE_WAYS +
+        cache->shard_count - 1) / cache->shard_count);
+
+    shards = new CacheShard[cache->shard_count]();
+    cache->shards = shards;
+    for (unsigned int s = 0; s < cache->shard_count; s++) {
+        shards[s].entries = new (std::nothrow) CacheEntry[(size_t)cache->set_count * CACHE_WAYS]();
+        shards[s].victims = (uint8_t*)calloc(cache->set_count, 1);
+        if (!shards[s].entries || !shards[s].victims) {
+            x86_cache_free(cache);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+void x86_cache_free(DecodeCache* cache) {
+    CacheShard* shards = (CacheShard*)cache->shards;
+
+    if (shards) {
+        for (unsigned int s = 0; s < cache->shard_count; s++) {
+            delete[] shards[s].entries;
+            free(shards[s].victims);
+        }
+        delete[] shards;
+    }
+    memset(cache, 0, sizeof(*cache));
+}
+
+// Writes an entry under the shard lock
+static void write_entry(CacheEntry* entry, uint64_t address, const uint8_t* code, unsigned int checked,
+    const DecodedInstruction* record) {
+    uint32_t sequence = entry->sequence.load(std::memory_order_relaxed);
+
+    entry->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    memset(entry->bytes, 0, sizeof(entry->bytes));
+    memcpy(entry->bytes, code, checked);
+    entry->checked = (uint8_t)checked;
+    entry->address = address;
+    entry->record = *record;
+
+    entry->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+unsigned int x86_cache_decode(DecodeCache* cache, const void* code, size_t available, uint64_t address,
+    DecodedInstruction* out) {
+    const uint8_t* p = (const uint8_t*)code;
+    uint64_t hash = hash_address(address);
+    CacheShard* shard = &((CacheShard*)cache->shards)[hash >> 32 & (cache->shard_count - 1)];
+    CacheEntry* set = &shard->entries[(size_t)(hash >> 40 & (cache->set_count - 1)) * CACHE_WAYS];
+    DecodedInstruction record;
+    unsigned int checked;
+
+    for (unsigned int way = 0; way < CACHE_WAYS; way++) {
+        CacheEntry* entry = &set[way];
+        uint32_t sequence = entry->sequence.load(std::memory_order_acquire);
+        uint8_t bytes[16];
+
+        if ((sequence & 1) || entry->address != address || !entry->checked) {
+            continue;
+        }
+
+        // Copied straight out; a torn copy is overwritten by the decode below
+        checked = entry->checked;
+        memcpy(bytes, entry->bytes, sizeof(bytes));
+        *out = entry->record;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (entry->sequence.load(std::memory_order_relaxed) != sequence || checked > 15) {
+            continue;
+        }
+
+        if (same_bytes(bytes, checked, p, available)) {
+            shard->hits.fetch_add(1, std::memory_order_relaxed);
+            return out->info.length;
+        }
+        if (checked <= available) {
+            // The bytes changed since the entry was made
+            shard->stale.fetch_add(1, std::memory_order_relaxed);
+        }
+        break;
+    }
+    shard->misses.fetch_add(1, std::memory_order_relaxed);
+
+    if (x86_disasm_batch_mode(cache->mode, code, available, address, &record, 1, NULL) == 0) {
+        return 0;
+    }
+
+    // A valid decode depends on its own bytes only; an invalid one may
+    // have looked at the whole window
+    checked = record.info.length;
+    if (record.info.flags & FLAG_MASK_ANY_ERROR) {
+        checked = available < X86_MAX_INSTRUCTION_LENGTH ? (unsigned int)available : X86_MAX_INSTRUCTION_LENGTH;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(shard->lock);
+        CacheEntry* entry = NULL;
+        unsigned int way;
+
+        // The address itself (stale, or inserted by another thread
+        // meanwhile), a free way, or the next victim
+        for (way = 0; way < CACHE_WAYS && !entry; way++) {
+            if (set[way].checked && set[way].address == address) {
+                entry = &set[way];
+            }
+        }
+        for (way = 0; way < CACHE_WAYS && !entry; way++) {
+            if (!set[way].checked) {
+                entry = &set[way];
+                shard->used++;
+            }
+        }
+        if (!entry) {
+            uint8_t* victim = &shard->victims[(set - shard->entries) / CACHE_WAYS];
+            entry = &set[*victim];
+            *victim = (uint8_t)((*victim + 1) % CACHE_WAYS);
+        }
+
+        write_entry(entry, address, p, checked, &record);
+    }
+
+    *out = record;
+    return record.info.length;
+}
+
+void x86_cache_clear(DecodeCache* cache) {
+    CacheShard* shards = (CacheShard*)cache->shards;
+
+    for (unsigned int s = 0; s < cache->shard_count; s++) {
+        std::lock_guard<std::mutex> guard(shards[s].lock);
+        size_t count = (size_t)cache->set_count * CACHE_WAYS;
+
+        for (size_t i = 0; i < count; i++) {
+            CacheEntry* entry = &shards[s].entries[i];
+            uint32_t sequence = entry->sequence.load(std::memory_order_relaxed);
+
+            entry->sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            entry->checked = 0;
+            entry->sequence.store(sequence + 2, std::memory_order_release);
+        }
+        memset(shards[s].victims, 0, cache->set_count);
+        shards[s].used = 0;
+    }
+}
+
+void x86_cache_stats(DecodeCache* cache, DecodeCacheStats* stats) {
+    CacheShard* shards = (CacheShard*)cache->shards;
+
+    memset(stats, 0, sizeof(*stats));
+    for (unsigned int s = 0; s < cache->shard_count; s++) {
+        std::lock_guard<std::mutex> guard(shards[s].lock);
+
+        stats->hits += shards[s].hits.load(std::memory_order_relaxed);
+        stats->misses += shards[s].misses.load(std::memory_order_relaxed);
+        stats->stale += shards[s].stale.load(std::memory_order_relaxed);
+        stats->entries += shards[s].used;
+    }
+}
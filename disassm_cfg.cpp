@@ -0,0 +1,328 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "disassm.h"
+#include "disassm_bitmap.h"
+
+/*
+ * Bump allocator
+ */
+#define ARENA_DEFAULT_CHUNK     (1024 * 1024)
+#define ARENA_HEADER            16      // Link to the previous chunk, padded to the alignment
+#define ARENA_ALIGN(size)       (((size) + 15) & ~(size_t)15)
+
+void x86_arena_init(DisasmArena* arena, size_t chunk_size) {
+    memset(arena, 0, sizeof(*arena));
+    arena->chunk_size = chunk_size ? chunk_size : ARENA_DEFAULT_CHUNK;
+}
+
+void* x86_arena_alloc(DisasmArena* arena, size_t size) {
+    uint8_t* chunk;
+    void* p;
+
+    size = ARENA_ALIGN(size ? size : 1);
+    if (size > (size_t)(arena->limit - arena->cursor)) {
+        if (size > arena->chunk_size / 4) {
+            // Large allocation: a chunk of its own, linked behind the current
+            // chunk so the rest of that chunk stays in use
+            chunk = (uint8_t*)malloc(ARENA_HEADER + size);
+            if (!chunk) {
+                return NULL;
+            }
+            if (arena->chunks) {
+                *(void**)chunk = *(void**)arena->chunks;
+                *(void**)arena->chunks = chunk;
+            }
+            else {
+                *(void**)chunk = NULL;
+                arena->chunks = chunk;
+            }
+            arena->allocated += size;
+            return chunk + ARENA_HEADER;
+        }
+
+        chunk = (uint8_t*)malloc(arena->chunk_size);
+        if (!chunk) {
+            return NULL;
+        }
+        *(void**)chunk = arena->chunks;
+        arena->chunks = chunk;
+        arena->cursor = chunk + ARENA_HEADER;
+        arena->limit = chunk + arena->chunk_size;
+    }
+
+    p = arena->cursor;
+    arena->cursor += size;
+    arena->allocated += size;
+    return p;
+}
+
+void x86_arena_free(DisasmArena* arena) {
+    void* chunk = arena->chunks;
+
+    while (chunk) {
+        void* previous = *(void**)chunk;
+        free(chunk);
+        chunk = previous;
+    }
+
+    x86_arena_init(arena, arena->chunk_size);
+}
+
+/*
+ * Control flow graph
+ *
+ * Built in passes over flat arrays: one pass marks block leaders, one lays
+ * out the blocks, and two over the blocks count then fill the edges.
+ * Predecessor lists are slices of one array, laid out by in-degree.
+ *
+ * When the records cover their address range densely, branch targets are
+ * resolved through bitmaps over that range: a target bitmap for the
+ * leaders, and a block start bitmap with a per-word rank for the edges.
+ * Sparse input falls back to binary searches.
+ */
+#define CFG_FLOW_MASK   0x07
+#define CFG_LEADER      0x08
+#define CFG_DENSE_BYTES 64      // Largest address range per record for the bitmaps
+
+typedef struct {
+    uint64_t base;          // Address of the first record
+    size_t range;           // Bytes from base to the end of the last record
+    uint64_t* targets;      // Dense: bit per byte, branch and call targets
+    uint64_t* starts;       // Dense: bit per byte, block starts
+    uint32_t* rank;         // Dense: number of block starts before each word
+} CfgIndex;
+
+static inline int ends_block(DisasmFlow flow) {
+    return flow == DISASM_FLOW_BRANCH || flow == DISASM_FLOW_JUMP || flow == DISASM_FLOW_INDIRECT_JUMP ||
+        flow == DISASM_FLOW_RETURN || flow == DISASM_FLOW_STOP;
+}
+
+static inline int falls_through(DisasmFlow flow) {
+    return flow == DISASM_FLOW_NONE || flow == DISASM_FLOW_BRANCH || flow == DISASM_FLOW_CALL ||
+        flow == DISASM_FLOW_INDIRECT_CALL;
+}
+
+// Index of the record at address, or count when there is none
+static size_t find_instruction(const DecodedInstruction* insns, size_t count, uint64_t address) {
+    size_t low = 0;
+    size_t high = count;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (insns[middle].address < address) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    return low < count && insns[low].address == address ? low : count;
+}
+
+// Block starting exactly at address, or NULL
+static BasicBlock* find_block_start(const ControlFlowGraph* cfg, const CfgIndex* index, uint64_t address) {
+    if (index->starts) {
+        size_t offset = (size_t)(address - index->base);
+
+        if (address - index->base >= index->range || !bitmap_test(index->starts, offset)) {
+            return NULL;
+        }
+        return &cfg->blocks[index->rank[offset / 64] +
+            popcount64(index->starts[offset / 64] & (((uint64_t)1 << (offset % 64)) - 1))];
+    }
+
+    BasicBlock* block = x86_cfg_block(cfg, address);
+    return block && block->start == address ? block : NULL;
+}
+
+BasicBlock* x86_cfg_block(const ControlFlowGraph* cfg, uint64_t address) {
+    size_t low = 0;
+    size_t high = cfg->block_count;
+
+    // Last block starting at or before address
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (cfg->blocks[middle].start <= address) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    if (low == 0 || address >= cfg->blocks[low - 1].end) {
+        return NULL;
+    }
+    return &cfg->blocks[low - 1];
+}
+
+int x86_cfg_build(const DecodedInstruction* insns, size_t count, DisasmArena* arena, ControlFlowGraph* cfg) {
+    uint8_t* marks;
+    BlockEdge** predecessors;
+    CfgIndex index;
+    size_t block_count = 0;
+    size_t edge_count = 0;
+    int status = 0;
+
+    memset(cfg, 0, sizeof(*cfg));
+    memset(&index, 0, sizeof(index));
+    if (count == 0) {
+        return 1;
+    }
+
+    marks = (uint8_t*)calloc(count, 1);
+    if (!marks) {
+        return 0;
+    }
+
+    index.base = insns[0].address;
+    index.range = (size_t)(insns[count - 1].address + insns[count - 1].info.length - index.base);
+    if (index.range / CFG_DENSE_BYTES <= count) {
+        size_t words = BITMAP_WORDS(index.range);
+
+        index.targets = (uint64_t*)calloc(words, sizeof(uint64_t));
+        index.starts = (uint64_t*)calloc(words, sizeof(uint64_t));
+        index.rank = (uint32_t*)malloc(words * sizeof(uint32_t));
+        if (!index.targets || !index.starts || !index.rank) {
+            goto done;
+        }
+    }
+
+    // Pass 1: control flow of every instruction, and block leaders
+    marks[0] |= CFG_LEADER;
+    for (size_t i = 0; i < count; i++) {
+        const DecodedInstruction* insn = &insns[i];
+        DisasmFlow flow = x86_control_flow(&insn->info);
+
+        marks[i] |= (uint8_t)flow;
+        if (flow == DISASM_FLOW_BRANCH || flow == DISASM_FLOW_JUMP || flow == DISASM_FLOW_CALL) {
+            if (index.targets) {
+                if (insn->target - index.base < index.range) {
+                    bitmap_set(index.targets, (size_t)(insn->target - index.base));
+                }
+            }
+            else {
+                size_t target = find_instruction(insns, count, insn->target);
+                if (target < count) {
+                    marks[target] |= CFG_LEADER;
+                }
+            }
+        }
+
+        if (i + 1 < count && (ends_block(flow) || insns[i + 1].address != insn->address + insn->info.length)) {
+            marks[i + 1] |= CFG_LEADER;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (index.targets && bitmap_test(index.targets, (size_t)(insns[i].address - index.base))) {
+            marks[i] |= CFG_LEADER;
+        }
+        block_count += (marks[i] & CFG_LEADER) != 0;
+    }
+
+    // Pass 2: blocks
+    cfg->blocks = (BasicBlock*)x86_arena_alloc(arena, block_count * sizeof(BasicBlock));
+    if (!cfg->blocks) {
+        goto done;
+    }
+
+    for (size_t i = 0, b = 0; i < count; i++) {
+        BasicBlock* block;
+
+        if (marks[i] & CFG_LEADER) {
+            block = &cfg->blocks[b++];
+            memset(block, 0, sizeof(*block));
+            block->start = insns[i].address;
+            block->first = i;
+            if (index.starts) {
+                bitmap_set(index.starts, (size_t)(block->start - index.base));
+            }
+        }
+        else {
+            block = &cfg->blocks[b - 1];
+        }
+
+        block->instruction_count++;
+        block->end = insns[i].address + insns[i].info.length;
+        block->flow = (DisasmFlow)(marks[i] & CFG_FLOW_MASK);
+    }
+    cfg->block_count = block_count;
+
+    if (index.starts) {
+        uint32_t rank = 0;
+        for (size_t w = 0; w < BITMAP_WORDS(index.range); w++) {
+            index.rank[w] = rank;
+            rank += popcount64(index.starts[w]);
+        }
+    }
+
+    // Pass 3: count the edges, then fill them grouped by source block
+    for (int fill = 0; fill < 2; fill++) {
+        edge_count = 0;
+
+        for (size_t b = 0; b < block_count; b++) {
+            BasicBlock* block = &cfg->blocks[b];
+            const DecodedInstruction* last = &insns[block->first + block->instruction_count - 1];
+            BasicBlock* targets[2];
+            DisasmEdgeType types[2];
+            unsigned int n = 0;
+
+            if ((block->flow == DISASM_FLOW_BRANCH || block->flow == DISASM_FLOW_JUMP) &&
+                (targets[n] = find_block_start(cfg, &index, last->target)) != NULL) {
+                types[n++] = block->flow == DISASM_FLOW_JUMP ? DISASM_EDGE_JUMP : DISASM_EDGE_BRANCH;
+            }
+            if (falls_through(block->flow) && b + 1 < block_count && cfg->blocks[b + 1].start == block->end) {
+                targets[n] = &cfg->blocks[b + 1];
+                types[n++] = DISASM_EDGE_FALLTHROUGH;
+            }
+
+            if (fill) {
+                block->successors = &cfg->edges[edge_count];
+                block->successor_count = n;
+                for (unsigned int k = 0; k < n; k++) {
+                    BlockEdge* edge = &cfg->edges[edge_count + k];
+                    edge->from = block;
+                    edge->to = targets[k];
+                    edge->type = types[k];
+                    targets[k]->predecessor_count++;
+                }
+            }
+            edge_count += n;
+        }
+
+        if (!fill) {
+            cfg->edges = (BlockEdge*)x86_arena_alloc(arena, edge_count * sizeof(BlockEdge));
+            if (!cfg->edges) {
+                goto done;
+            }
+        }
+    }
+    cfg->edge_count = edge_count;
+
+    // Predecessors: one slice per block, sized by in-degree
+    predecessors = (BlockEdge**)x86_arena_alloc(arena, edge_count * sizeof(BlockEdge*));
+    if (!predecessors) {
+        goto done;
+    }
+    for (size_t b = 0; b < block_count; b++) {
+        cfg->blocks[b].predecessors = predecessors;
+        predecessors += cfg->blocks[b].predecessor_count;
+        cfg->blocks[b].predecessor_count = 0;
+    }
+    for (size_t e = 0; e < edge_count; e++) {
+        BasicBlock* to = cfg->edges[e].to;
+        to->predecessors[to->predecessor_count++] = &cfg->edges[e];
+    }
+
+    status = 1;
+
+done:
+    free(marks);
+    free(index.targets);
+    free(index.starts);
+    free(index.rank);
+    return status;
+}
@@ -0,0 +1,140 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "disassm.h"
+
+// Records decoded per step before they are scattered into the columns
+#define COLUMNS_CHUNK 256
+
+// Round a column size up so every column starts 8-byte aligned
+#define COLUMN_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+/*
+ * Column container functions
+ */
+int x86_columns_init(InstructionColumns* columns, size_t capacity) {
+    size_t wide32 = COLUMN_ALIGN(capacity * sizeof(uint32_t));
+    size_t wide16 = COLUMN_ALIGN(capacity * sizeof(uint16_t));
+    size_t narrow = COLUMN_ALIGN(capacity);
+    uint8_t* block;
+
+    memset(columns, 0, sizeof(*columns));
+
+    block = (uint8_t*)malloc(wide32 + 2 * wide16 + 8 * narrow + 1);
+    if (!block) {
+        return 0;
+    }
+
+    columns->capacity = capacity;
+    columns->offset = (uint32_t*)block;
+    block += wide32;
+    columns->prefixes = (uint16_t*)block;
+    block += wide16;
+    columns->flags = (uint16_t*)block;
+    block += wide16;
+    columns->length = block;
+    block += narrow;
+    columns->map = block;
+    block += narrow;
+    columns->opcode = block;
+    block += narrow;
+    columns->modrm = block;
+    block += narrow;
+    columns->sib = block;
+    block += narrow;
+    columns->rex = block;
+    block += narrow;
+    columns->disp = block;
+    block += narrow;
+    columns->imm = block;
+
+    return 1;
+}
+
+void x86_columns_free(InstructionColumns* columns) {
+    // The offset column is the start of the single allocation
+    free(columns->offset);
+    memset(columns, 0, sizeof(*columns));
+}
+
+void x86_columns_get(const InstructionColumns* columns, size_t index, PackedInstruction* out) {
+    out->offset = columns->offset[index];
+    out->length = columns->length[index];
+    out->map = columns->map[index];
+    out->opcode = columns->opcode[index];
+    out->modrm = columns->modrm[index];
+    out->sib = columns->sib[index];
+    out->rex = columns->rex[index];
+    out->prefixes = columns->prefixes[index];
+    out->disp = columns->disp[index];
+    out->imm = columns->imm[index];
+    out->flags = columns->flags[index];
+}
+
+/*
+ * Column disassembler function
+ *
+ * Decodes COLUMNS_CHUNK packed records at a time into a small buffer that
+ * stays in L1, then scatters them into the columns.
+ */
+size_t x86_disasm_columns(const void* code, size_t length, InstructionColumns* columns,
+    DisasmBatchResult* result) {
+    const uint8_t* base = (const uint8_t*)code;
+    PackedInstruction chunk[COLUMNS_CHUNK];
+    DisasmBatchResult chunk_result;
+    size_t offset = 0;
+    size_t count = 0;
+
+    chunk_result.reason = DISASM_STOP_END;
+
+    while (offset < length && count < columns->capacity) {
+        size_t max_count = columns->capacity - count;
+        if (max_count > COLUMNS_CHUNK) {
+            max_count = COLUMNS_CHUNK;
+        }
+
+        size_t n = x86_disasm_packed(base + offset, length - offset, chunk, max_count, &chunk_result);
+
+        for (size_t i = 0; i < n; i++) {
+            size_t row = count + i;
+            columns->offset[row] = chunk[i].offset + (uint32_t)offset;
+            columns->length[row] = chunk[i].length;
+            columns->map[row] = chunk[i].map;
+            columns->opcode[row] = chunk[i].opcode;
+            columns->modrm[row] = chunk[i].modrm;
+            columns->sib[row] = chunk[i].sib;
+            columns->rex[row] = chunk[i].rex;
+            columns->prefixes[row] = chunk[i].prefixes;
+            columns->disp[row] = chunk[i].disp;
+            columns->imm[row] = chunk[i].imm;
+            columns->flags[row] = chunk[i].flags;
+        }
+
+        count += n;
+        offset += chunk_result.offset;
+
+        if (chunk_result.reason == DISASM_STOP_TRUNCATED) {
+            break;
+        }
+    }
+
+    columns->count = count;
+
+    if (result) {
+        result->count = count;
+        result->offset = offset;
+        result->address = offset;
+
+        if (offset == length) {
+            result->reason = DISASM_STOP_END;
+        }
+        else if (chunk_result.reason == DISASM_STOP_TRUNCATED) {
+            result->reason = DISASM_STOP_TRUNCATED;
+        }
+        else {
+            result->reason = DISASM_STOP_FULL;
+        }
+    }
+
+    return count;
+}
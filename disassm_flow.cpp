@@ -0,0 +1,328 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "disassm.h"
+#include "disassm_bitmap.h"
+
+/*
+ * Control flow classification
+ *
+ * Most instructions do not change the flow; a bitmap of the one-byte
+ * opcodes that may lets them through without the switch, whose indirect
+ * jump mispredicts on mixed code.
+ */
+static const uint64_t g_flow_opcodes[4] = {
+    0x0000000000000000,     // 00-3F
+    0xFFFF000000000000,     // 40-7F: jcc rel8
+    0x0000000004000000,     // 80-BF: call far
+    0x80100F0F00009C8C,     // C0-FF: ret, xbegin, int3, iret, loop, jcxz, call, jmp, hlt, group 5
+};
+
+DisasmFlow x86_control_flow(const InstructionInfo* info) {
+    if (info->flags & FLAG_MASK_ANY_ERROR) {
+        return DISASM_FLOW_STOP;
+    }
+    if (info->flags & FLAG_MASK_ANY_VECTOR) {
+        return DISASM_FLOW_NONE;
+    }
+
+    if (info->map == OPCODE_MAP_1BYTE) {
+        if (!bitmap_test(g_flow_opcodes, info->opcode)) {
+            return DISASM_FLOW_NONE;
+        }
+
+        switch (info->opcode) {
+        case 0x70: case 0x71: case 0x72: case 0x73: case 0x74: case 0x75: case 0x76: case 0x77:
+        case 0x78: case 0x79: case 0x7A: case 0x7B: case 0x7C: case 0x7D: case 0x7E: case 0x7F:
+        case 0xE0: case 0xE1: case 0xE2: case 0xE3:     // loopnz, loopz, loop, jcxz
+            return DISASM_FLOW_BRANCH;
+
+        case 0xC7:
+            // xbegin: the target is the abort handler
+            return (info->flags & FLAG_RELATIVE) ? DISASM_FLOW_BRANCH : DISASM_FLOW_NONE;
+
+        case 0xE8:
+            return DISASM_FLOW_CALL;
+
+        case 0xE9: case 0xEB:
+            return DISASM_FLOW_JUMP;
+
+        case 0x9A:
+            return DISASM_FLOW_INDIRECT_CALL;
+
+        case 0xEA:
+            return DISASM_FLOW_INDIRECT_JUMP;
+
+        case 0xFF:
+            if (info->modrm_reg == 2 || info->modrm_reg == 3) {
+                return DISASM_FLOW_INDIRECT_CALL;
+            }
+            if (info->modrm_reg == 4 || info->modrm_reg == 5) {
+                return DISASM_FLOW_INDIRECT_JUMP;
+            }
+            return DISASM_FLOW_NONE;
+
+        case 0xC2: case 0xC3: case 0xCA: case 0xCB: case 0xCF:    // ret, retf, iret
+            return DISASM_FLOW_RETURN;
+
+        case 0xCC: case 0xF4:   // int3 (padding or breakpoint), hlt
+            return DISASM_FLOW_STOP;
+        }
+    }
+    else if (info->map == OPCODE_MAP_0F) {
+        if ((info->opcode2 & 0xF0) == 0x80) {
+            return DISASM_FLOW_BRANCH;
+        }
+
+        switch (info->opcode2) {
+        case 0x07: case 0x35:   // sysret, sysexit
+            return DISASM_FLOW_RETURN;
+
+        case 0x0B: case 0xB9: case 0xFF:    // ud2, ud1, ud0
+            return DISASM_FLOW_STOP;
+        }
+    }
+
+    return DISASM_FLOW_NONE;
+}
+
+/*
+ * Recursive descent
+ *
+ * Each thread owns a deque of pending offsets: it pushes the targets it
+ * finds and pops from the same end, so it mostly follows its own paths
+ * depth first, while idle threads steal from the other end. An offset is
+ * claimed by atomically setting its bit in the starts map before it is
+ * decoded, so no offset is decoded twice and a path stops as soon as it
+ * runs into code another path has already taken.
+ */
+#define DESCENT_DEQUE_CAPACITY  256
+
+typedef struct {
+    std::mutex lock;
+    size_t* items;
+    size_t head;            // Thieves take from here
+    size_t tail;            // The owner pushes and pops here
+    size_t capacity;
+} TargetDeque;
+
+typedef struct {
+    DisasmMode mode;
+    const uint8_t* code;
+    size_t length;
+    CodeMap* map;
+    TargetDeque* deques;
+    unsigned int threads;
+    std::atomic<size_t> pending;    // Offsets pushed and not yet fully followed
+    std::atomic<int> failed;
+} DescentState;
+
+static int deque_push(TargetDeque* deque, size_t offset) {
+    std::lock_guard<std::mutex> guard(deque->lock);
+
+    if (deque->tail == deque->capacity) {
+        if (deque->head > deque->capacity / 2) {
+            memmove(deque->items, deque->items + deque->head, (deque->tail - deque->head) * sizeof(size_t));
+            deque->tail -= deque->head;
+            deque->head = 0;
+        }
+        else {
+            size_t capacity = deque->capacity ? deque->capacity * 2 : DESCENT_DEQUE_CAPACITY;
+            size_t* items = (size_t*)realloc(deque->items, capacity * sizeof(size_t));
+            if (!items) {
+                return 0;
+            }
+            deque->items = items;
+            deque->capacity = capacity;
+        }
+    }
+
+    deque->items[deque->tail++] = offset;
+    return 1;
+}
+
+static int deque_pop(TargetDeque* deque, size_t* offset) {
+    std::lock_guard<std::mutex> guard(deque->lock);
+
+    if (deque->head == deque->tail) {
+        deque->head = deque->tail = 0;
+        return 0;
+    }
+
+    *offset = deque->items[--deque->tail];
+    return 1;
+}
+
+static int deque_steal(TargetDeque* deque, size_t* offset) {
+    std::lock_guard<std::mutex> guard(deque->lock);
+
+    if (deque->head == deque->tail) {
+        return 0;
+    }
+
+    *offset = deque->items[deque->head++];
+    return 1;
+}
+
+static void add_target(DescentState* state, unsigned int self, uint64_t target, int call) {
+    CodeMap* map = state->map;
+    size_t offset = (size_t)(target - map->address);
+
+    if (target - map->address >= map->length) {
+        return;
+    }
+    if (call) {
+        bitmap_atomic_set(map->calls, offset);
+    }
+
+    // Queue each target once, and only if no path has decoded it yet
+    if (bitmap_atomic_set(map->targets, offset) || bitmap_atomic_test(map->starts, offset)) {
+        return;
+    }
+
+    state->pending.fetch_add(1);
+    if (!deque_push(&state->deques[self], offset)) {
+        state->pending.fetch_sub(1);
+        state->failed = 1;
+    }
+}
+
+// Decodes from offset until the path ends or joins code already decoded
+static void follow_path(DescentState* state, unsigned int self, size_t offset) {
+    CodeMap* map = state->map;
+
+    while (offset < state->length && !bitmap_atomic_set(map->starts, offset)) {
+        DecodedInstruction insn;
+
+        if (x86_disasm_batch_mode(state->mode, state->code + offset, state->length - offset,
+            map->address + offset, &insn, 1, NULL) == 0 || (insn.info.flags & FLAG_MASK_ANY_ERROR)) {
+            bitmap_atomic_clear(map->starts, offset);
+            return;
+        }
+
+        DisasmFlow flow = x86_control_flow(&insn.info);
+        switch (flow) {
+        case DISASM_FLOW_BRANCH:
+        case DISASM_FLOW_JUMP:
+        case DISASM_FLOW_CALL:
+            add_target(state, self, insn.target, flow == DISASM_FLOW_CALL);
+            break;
+
+        default:
+            break;
+        }
+
+        if (flow == DISASM_FLOW_JUMP || flow == DISASM_FLOW_INDIRECT_JUMP ||
+            flow == DISASM_FLOW_RETURN || flow == DISASM_FLOW_STOP) {
+            return;
+        }
+        offset += insn.info.length;
+    }
+}
+
+static void descent_worker(DescentState* state, unsigned int self) {
+    size_t offset;
+
+    for (;;) {
+        int found = deque_pop(&state->deques[self], &offset);
+
+        for (unsigned int i = 1; !found && i < state->threads; i++) {
+            found = deque_steal(&state->deques[(self + i) % state->threads], &offset);
+        }
+
+        if (found) {
+            follow_path(state, self, offset);
+            state->pending.fetch_sub(1);
+        }
+        else if (state->pending.load() == 0) {
+            break;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+int x86_descent(DisasmMode mode, const void* code, size_t length, uint64_t address,
+    const uint64_t* seeds, size_t seed_count, unsigned int threads, CodeMap* map) {
+    DescentState state;
+    size_t words = BITMAP_WORDS(length);
+
+    memset(map, 0, sizeof(*map));
+    map->address = address;
+    map->length = length;
+    map->starts = (uint64_t*)calloc(words, sizeof(uint64_t));
+    map->targets = (uint64_t*)calloc(words, sizeof(uint64_t));
+    map->calls = (uint64_t*)calloc(words, sizeof(uint64_t));
+    if (!map->starts || !map->targets || !map->calls) {
+        return 0;
+    }
+
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    state.mode = mode;
+    state.code = (const uint8_t*)code;
+    state.length = length;
+    state.map = map;
+    state.deques = new TargetDeque[threads]();
+    state.threads = threads;
+    state.pending = 0;
+    state.failed = 0;
+
+    // Seeds are function entries: deal them out round-robin
+    for (size_t i = 0; i < seed_count; i++) {
+        size_t offset = (size_t)(seeds[i] - address);
+
+        if (seeds[i] - address >= length) {
+            continue;
+        }
+        bitmap_set(map->calls, offset);
+        if (!bitmap_test(map->targets, offset)) {
+            bitmap_set(map->targets, offset);
+            state.pending.fetch_add(1);
+            if (!deque_push(&state.deques[i % threads], offset)) {
+                state.pending.fetch_sub(1);
+                state.failed = 1;
+            }
+        }
+    }
+
+    if (threads == 1) {
+        descent_worker(&state, 0);
+    }
+    else {
+        std::thread* workers = new std::thread[threads - 1];
+
+        for (unsigned int i = 1; i < threads; i++) {
+            workers[i - 1] = std::thread(descent_worker, &state, i);
+        }
+        descent_worker(&state, 0);
+        for (unsigned int i = 1; i < threads; i++) {
+            workers[i - 1].join();
+        }
+        delete[] workers;
+    }
+
+    for (unsigned int i = 0; i < threads; i++) {
+        free(state.deques[i].items);
+    }
+    delete[] state.deques;
+
+    map->instruction_count = bitmap_count(map->starts, 0, length);
+    return !state.failed;
+}
+
+void x86_code_map_free(CodeMap* map) {
+    free(map->starts);
+    free(map->targets);
+    free(map->calls);
+    memset(map, 0, sizeof(*map));
+}
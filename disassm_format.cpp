@@ -0,0 +1,858 @@
+#include <stdint.h>
+#include <string.h>
+#include "disassm.h"
+#include "disassm_inst_bytes.h"
+#include "disassm_table_format.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define DISASM_FORCEINLINE __forceinline
+#else
+#define DISASM_FORCEINLINE inline __attribute__((always_inline))
+#endif
+
+// Room for one formatted operand, including the 8-byte register copies
+#define FORMAT_OPERAND_SIZE 96
+
+// Room for one batch line: address, bytes, text and newline
+#define FORMAT_LINE_SIZE (16 + 2 + X86_MAX_INSTRUCTION_LENGTH * 3 + X86_FORMAT_BUFFER_SIZE + 1)
+
+// Width of the bytes column in batch output
+#define FORMAT_BYTES_COLUMN 10
+
+/*
+ * Formatter state for one instruction
+ */
+typedef struct {
+    const InstructionInfo* info;
+    uint64_t address;
+    unsigned int att;           // AT&T syntax
+    unsigned int mode64;        // 64-bit mode
+    unsigned int vector;        // VEX/EVEX encoded
+    unsigned int evex;          // EVEX encoded
+    unsigned int opcode;        // Opcode byte within the map
+    unsigned int operand_size;  // General purpose operand size in bytes
+    unsigned int address_size;  // Address size in bytes
+    unsigned int vector_size;   // Vector register size in bytes
+    unsigned int suffix_size;   // Size of an integer memory operand (AT&T suffix)
+    unsigned int has_register;  // A register operand fixes the size (AT&T suffix)
+    const char* fpu_suffix;     // AT&T suffix of an x87 memory operand
+} FormatState;
+
+/*
+ * Number emitters
+ */
+
+// Two hex digits per byte value
+typedef struct {
+    char digits[256][2];
+} HexPairTable;
+
+constexpr HexPairTable build_hex_pair_table() {
+    HexPairTable table = {};
+    const char hex[] = "0123456789abcdef";
+
+    for (unsigned int i = 0; i < 256; i++) {
+        table.digits[i][0] = hex[i >> 4];
+        table.digits[i][1] = hex[i & 15];
+    }
+    return table;
+}
+
+static constexpr HexPairTable g_hex_pairs = build_hex_pair_table();
+
+static DISASM_FORCEINLINE unsigned int count_leading_zeros64(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - (unsigned int)index;
+#else
+    return (unsigned int)__builtin_clzll(value);
+#endif
+}
+
+// Hex digits of value, exactly 'digits' of them
+static DISASM_FORCEINLINE char* emit_hex_digits(char* p, uint64_t value, unsigned int digits) {
+    char* end = p + digits;
+    char* q = end;
+
+    while (q - p >= 2) {
+        q -= 2;
+        memcpy(q, g_hex_pairs.digits[value & 0xFF], 2);
+        value >>= 8;
+    }
+    if (q != p) {
+        *p = g_hex_pairs.digits[value & 0x0F][1];
+    }
+    return end;
+}
+
+// "0x" and the significant hex digits of value
+static DISASM_FORCEINLINE char* emit_hex(char* p, uint64_t value) {
+    unsigned int digits = (64 - count_leading_zeros64(value | 1) + 3) >> 2;
+    p[0] = '0';
+    p[1] = 'x';
+    return emit_hex_digits(p + 2, value, digits);
+}
+
+static DISASM_FORCEINLINE char* emit_signed_hex(char* p, int64_t value) {
+    if (value < 0) {
+        *p++ = '-';
+        return emit_hex(p, 0 - (uint64_t)value);
+    }
+    return emit_hex(p, (uint64_t)value);
+}
+
+static DISASM_FORCEINLINE char* emit_decimal(char* p, unsigned int value) {
+    char digits[10];
+    unsigned int count = 0;
+
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    while (count) {
+        *p++ = digits[--count];
+    }
+    return p;
+}
+
+/*
+ * Register and size emitters
+ */
+
+// Register name class by general purpose register size
+static const uint8_t g_gpr_class[9] = {
+    0, FREG_GPR8, FREG_GPR16, 0, FREG_GPR32, 0, 0, 0, FREG_GPR64
+};
+
+static DISASM_FORCEINLINE char* emit_register(const FormatState* s, char* p, unsigned int reg_class, unsigned int index) {
+    const FormatRegister* name = &g_format_registers[reg_class][index];
+
+    *p = '%';
+    p += s->att;
+    memcpy(p, name, sizeof(FormatRegister));
+    return p + name->length;
+}
+
+static DISASM_FORCEINLINE char* emit_gpr(FormatState* s, char* p, unsigned int size, unsigned int index) {
+    unsigned int reg_class = g_gpr_class[size];
+
+    if (size == 1 && s->info->rex) {
+        reg_class = FREG_GPR8_REX;
+    }
+    s->has_register = 1;
+    return emit_register(s, p, reg_class, index & 0x0F);
+}
+
+static DISASM_FORCEINLINE char* emit_vector_register(FormatState* s, char* p, unsigned int size, unsigned int index) {
+    s->has_register = 1;
+    return emit_register(s, p, FREG_XMM + (size >> 5), index & 0x1F);
+}
+
+static DISASM_FORCEINLINE char* emit_text(char* p, const char* text, size_t length) {
+    memcpy(p, text, length);
+    return p + length;
+}
+
+// Intel memory size keyword, by operand size in bytes
+static DISASM_FORCEINLINE char* emit_size_keyword(char* p, unsigned int size) {
+    switch (size) {
+    case 1: return emit_text(p, "byte ptr ", 9);
+    case 2: return emit_text(p, "word ptr ", 9);
+    case 4: return emit_text(p, "dword ptr ", 10);
+    case 6: return emit_text(p, "fword ptr ", 10);
+    case 8: return emit_text(p, "qword ptr ", 10);
+    case 10: return emit_text(p, "tbyte ptr ", 10);
+    case 16: return emit_text(p, "xmmword ptr ", 12);
+    case 32: return emit_text(p, "ymmword ptr ", 12);
+    case 64: return emit_text(p, "zmmword ptr ", 12);
+    default: return p;
+    }
+}
+
+/*
+ * Function to print a memory operand
+ *
+ * size is the access size for the Intel size keyword (0 = none). An EVEX
+ * broadcast replaces it with one element and appends {1toN}.
+ */
+static char* emit_memory(FormatState* s, char* p, unsigned int size, int vsib_class = -1) {
+    const InstructionInfo* info = s->info;
+    MemoryOperand m;
+    unsigned int broadcast = 0;
+
+    decode_memory_operand(info, s->address_size, s->mode64, &m, vsib_class);
+
+    if (s->evex && info->evex_b && size >= 16) {
+        unsigned int element = info->rex_w ? 8 : 4;
+        broadcast = size / element;
+        size = element;
+    }
+
+    if (s->att) {
+        if (m.segment >= 0) {
+            p = emit_register(s, p, FREG_SEG, m.segment);
+            *p++ = ':';
+        }
+        if (m.has_disp) {
+            p = emit_signed_hex(p, m.disp);
+        }
+        if (m.base >= 0 || m.index >= 0 || m.rip) {
+            *p++ = '(';
+            if (m.rip) {
+                p = emit_text(p, s->address_size == 8 ? "%rip" : "%eip", 4);
+            }
+            else if (m.base >= 0) {
+                p = emit_register(s, p, m.base_class, m.base);
+            }
+            if (m.index >= 0) {
+                *p++ = ',';
+                p = emit_register(s, p, m.index_class, m.index);
+                *p++ = ',';
+                *p++ = (char)('0' + m.scale);
+            }
+            *p++ = ')';
+        }
+    }
+    else {
+        p = emit_size_keyword(p, size);
+        if (m.segment >= 0) {
+            p = emit_register(s, p, FREG_SEG, m.segment);
+            *p++ = ':';
+        }
+        *p++ = '[';
+        if (m.rip) {
+            p = emit_text(p, s->address_size == 8 ? "rip" : "eip", 3);
+        }
+        else if (m.base >= 0) {
+            p = emit_register(s, p, m.base_class, m.base);
+        }
+        if (m.index >= 0) {
+            if (m.base >= 0) {
+                *p++ = '+';
+            }
+            p = emit_register(s, p, m.index_class, m.index);
+            *p++ = '*';
+            *p++ = (char)('0' + m.scale);
+        }
+        if (m.has_disp) {
+            if (m.base >= 0 || m.index >= 0 || m.rip) {
+                if (m.disp < 0) {
+                    *p++ = '-';
+                    p = emit_hex(p, 0 - (uint64_t)m.disp);
+                }
+                else {
+                    *p++ = '+';
+                    p = emit_hex(p, (uint64_t)m.disp);
+                }
+            }
+            else {
+                p = emit_hex(p, (uint64_t)m.disp);
+            }
+        }
+        *p++ = ']';
+    }
+
+    if (broadcast) {
+        p = emit_text(p, "{1to", 4);
+        p = emit_decimal(p, broadcast);
+        *p++ = '}';
+    }
+    return p;
+}
+
+// Memory operand with a general purpose access size (sets the AT&T suffix)
+static DISASM_FORCEINLINE char* emit_integer_memory(FormatState* s, char* p, unsigned int size) {
+    s->suffix_size = size;
+    return emit_memory(s, p, size);
+}
+
+// String operand at seg:rSI or es:rDI
+static char* emit_string(FormatState* s, char* p, unsigned int size, unsigned int destination) {
+    int segment = destination ? REG_ES : segment_override(s->info);
+    unsigned int reg_class = s->address_size == 8 ? FREG_GPR64 : s->address_size == 4 ? FREG_GPR32 : FREG_GPR16;
+
+    s->suffix_size = size;
+    if (!s->att) {
+        p = emit_size_keyword(p, size);
+    }
+    p = emit_register(s, p, FREG_SEG, segment >= 0 ? segment : REG_DS);
+    *p++ = ':';
+    *p++ = s->att ? '(' : '[';
+    p = emit_register(s, p, reg_class, destination ? REG_DI : REG_SI);
+    *p++ = s->att ? ')' : ']';
+    return p;
+}
+
+// ModR/M r/m general purpose register or memory
+static DISASM_FORCEINLINE char* emit_rm(FormatState* s, char* p, unsigned int register_size, unsigned int memory_size) {
+    if (s->info->modrm_mod == MODRM_MOD_REGISTER) {
+        return emit_gpr(s, p, register_size, s->info->modrm_rm);
+    }
+    return emit_integer_memory(s, p, memory_size);
+}
+
+// ModR/M r/m vector register or memory
+static DISASM_FORCEINLINE char* emit_vector_rm(FormatState* s, char* p, unsigned int size) {
+    if (s->info->modrm_mod == MODRM_MOD_REGISTER) {
+        return emit_vector_register(s, p, size < 16 ? 16 : size, s->info->modrm_rm);
+    }
+    return emit_memory(s, p, size);
+}
+
+static DISASM_FORCEINLINE char* emit_immediate(const FormatState* s, char* p, uint64_t value) {
+    *p = '$';
+    p += s->att;
+    return emit_hex(p, value);
+}
+
+/*
+ * Function to print one operand
+ *
+ * Returns p unchanged for operands that are not shown in this encoding.
+ */
+static char* emit_operand(FormatState* s, char* p, unsigned int operand) {
+    const InstructionInfo* info = s->info;
+    unsigned int y_size = s->operand_size == 8 ? 8 : 4;
+    unsigned int mm = !s->vector && !info->prefix_66;
+
+    switch (operand) {
+    case OPND_Eb: return emit_rm(s, p, 1, 1);
+    case OPND_Ew: return emit_rm(s, p, 2, 2);
+    case OPND_Ed: return emit_rm(s, p, 4, 4);
+    case OPND_Ev: return emit_rm(s, p, s->operand_size, s->operand_size);
+    case OPND_Ey: return emit_rm(s, p, y_size, y_size);
+    case OPND_Edb: return emit_rm(s, p, 4, 1);
+    case OPND_Edw: return emit_rm(s, p, 4, 2);
+    case OPND_Gb: return emit_gpr(s, p, 1, info->modrm_reg);
+    case OPND_Gw: return emit_gpr(s, p, 2, info->modrm_reg);
+    case OPND_Gd: return emit_gpr(s, p, 4, info->modrm_reg);
+    case OPND_Gv: return emit_gpr(s, p, s->operand_size, info->modrm_reg);
+    case OPND_Gy: return emit_gpr(s, p, y_size, info->modrm_reg);
+    case OPND_Gq64: return emit_gpr(s, p, s->mode64 ? 8 : 4, info->modrm_reg);
+    case OPND_Rd: return emit_gpr(s, p, 4, info->modrm_rm);
+    case OPND_Rv: return emit_gpr(s, p, s->operand_size, info->modrm_rm);
+    case OPND_Ry: return emit_gpr(s, p, y_size, info->modrm_rm);
+    case OPND_Rq64: return emit_gpr(s, p, s->mode64 ? 8 : 4, info->modrm_rm);
+    case OPND_By: return emit_gpr(s, p, y_size, info->vex_vvvv);
+
+    case OPND_M: return emit_memory(s, p, 0);
+    case OPND_Mb: return emit_memory(s, p, 1);
+    case OPND_Mw: return emit_memory(s, p, 2);
+    case OPND_Md: return emit_memory(s, p, 4);
+    case OPND_Mdq: return emit_memory(s, p, 16);
+    case OPND_Mp: return emit_memory(s, p, s->operand_size + 2);
+    case OPND_Mq: return emit_memory(s, p, 8);
+    case OPND_Mv: return emit_integer_memory(s, p, s->operand_size);
+    case OPND_Mx: return emit_memory(s, p, s->vector_size);
+    case OPND_My: return emit_integer_memory(s, p, y_size);
+
+    case OPND_Mfs: s->fpu_suffix = "s"; return emit_memory(s, p, 4);
+    case OPND_Mfd: s->fpu_suffix = "l"; return emit_memory(s, p, 8);
+    case OPND_Mft: s->fpu_suffix = "t"; return emit_memory(s, p, 10);
+    case OPND_Miw: s->fpu_suffix = "s"; return emit_memory(s, p, 2);
+    case OPND_Mid: s->fpu_suffix = "l"; return emit_memory(s, p, 4);
+    case OPND_Miq: s->fpu_suffix = "ll"; return emit_memory(s, p, 8);
+    case OPND_Mbcd: return emit_memory(s, p, 10);
+
+    case OPND_Ib: return emit_immediate(s, p, info->immediate.imm8);
+    case OPND_Ibs: return emit_immediate(s, p, sized_immediate(info->immediate.imm8, 8, s->operand_size));
+    case OPND_Ib2: return emit_immediate(s, p, (info->immediate.imm64 >> 16) & 0xFF);
+    case OPND_Iw: return emit_immediate(s, p, info->immediate.imm16);
+    case OPND_Iz:
+    case OPND_Iv:
+        if (HAS_FLAG(info->flags, FLAG_IMM64)) {
+            return emit_immediate(s, p, info->immediate.imm64);
+        }
+        if (HAS_FLAG(info->flags, FLAG_IMM32)) {
+            return emit_immediate(s, p, sized_immediate(info->immediate.imm32, 32, s->operand_size));
+        }
+        return emit_immediate(s, p, info->immediate.imm16);
+
+    case OPND_1:
+        // AT&T leaves the count of shift-by-one implicit
+        return s->att ? p : emit_text(p, "1", 1);
+
+    case OPND_Jb:
+    case OPND_Jz: {
+        int64_t rel = HAS_FLAG(info->flags, FLAG_IMM8) ? (int8_t)info->immediate.imm8 :
+            HAS_FLAG(info->flags, FLAG_IMM16) ? (int16_t)info->immediate.imm16 : (int32_t)info->immediate.imm32;
+        uint64_t target = s->address + info->length + (uint64_t)rel;
+        if (!s->mode64) {
+            target &= s->operand_size == 2 ? 0xFFFF : 0xFFFFFFFF;
+        }
+        return emit_hex(p, target);
+    }
+
+    case OPND_Ap: {
+        unsigned int offset_size = HAS_FLAG(info->flags, FLAG_IMM16) ? 2 : 4;
+        uint64_t offset = info->immediate.imm64 & (offset_size == 2 ? 0xFFFF : 0xFFFFFFFF);
+        uint64_t selector = (info->immediate.imm64 >> (offset_size * 8)) & 0xFFFF;
+        p = emit_immediate(s, p, selector);
+        *p++ = s->att ? ',' : ':';
+        return emit_immediate(s, p, offset);
+    }
+
+    case OPND_Ob:
+    case OPND_Ov: {
+        unsigned int size = operand == OPND_Ob ? 1 : s->operand_size;
+        int segment = segment_override(info);
+        uint64_t offset = HAS_FLAG(info->flags, FLAG_IMM64) ? info->immediate.imm64 :
+            HAS_FLAG(info->flags, FLAG_IMM32) ? info->immediate.imm32 : info->immediate.imm16;
+        if (!s->att) {
+            p = emit_size_keyword(p, size);
+        }
+        if (segment >= 0) {
+            p = emit_register(s, p, FREG_SEG, segment);
+            *p++ = ':';
+        }
+        if (s->att) {
+            return emit_hex(p, offset);
+        }
+        *p++ = '[';
+        p = emit_hex(p, offset);
+        *p++ = ']';
+        return p;
+    }
+
+    case OPND_Zb: return emit_gpr(s, p, 1, (s->opcode & 7) | (info->rex_b << 3));
+    case OPND_Zv: return emit_gpr(s, p, s->operand_size, (s->opcode & 7) | (info->rex_b << 3));
+    case OPND_Zy: return emit_gpr(s, p, y_size, (s->opcode & 7) | (info->rex_b << 3));
+
+    case OPND_AL: return emit_gpr(s, p, 1, REG_AL);
+    case OPND_CL:
+        // A shift count does not fix the operand size
+        p = emit_register(s, p, FREG_GPR8, REG_CL);
+        return p;
+    case OPND_AX: return emit_gpr(s, p, 2, REG_AX);
+    case OPND_DX:
+        // I/O port: does not fix the operand size either
+        if (s->att) {
+            return emit_text(p, "(%dx)", 5);
+        }
+        return emit_text(p, "dx", 2);
+    case OPND_eAX: return emit_gpr(s, p, s->operand_size == 2 ? 2 : 4, REG_EAX);
+    case OPND_rAX: return emit_gpr(s, p, s->operand_size, REG_RAX);
+    case OPND_ES:
+    case OPND_CS:
+    case OPND_SS:
+    case OPND_DS:
+    case OPND_FS:
+    case OPND_GS:
+        s->has_register = 1;
+        return emit_register(s, p, FREG_SEG, operand - OPND_ES);
+    case OPND_ST0: return s->att ? emit_text(p, "%st", 3) : emit_text(p, "st", 2);
+    case OPND_STi: return emit_register(s, p, FREG_ST, info->modrm & 7);
+
+    case OPND_Sw:
+        s->has_register = 1;
+        return emit_register(s, p, FREG_SEG, info->modrm_reg & 7);
+    case OPND_Cd: return emit_register(s, p, FREG_CR, info->modrm_reg & 0x0F);
+    case OPND_Dd: return emit_register(s, p, FREG_DR, info->modrm_reg & 0x0F);
+
+    case OPND_Xb: return emit_string(s, p, 1, 0);
+    case OPND_Xv: return emit_string(s, p, s->operand_size, 0);
+    case OPND_Xz: return emit_string(s, p, s->operand_size == 2 ? 2 : 4, 0);
+    case OPND_Yb: return emit_string(s, p, 1, 1);
+    case OPND_Yv: return emit_string(s, p, s->operand_size, 1);
+    case OPND_Yz: return emit_string(s, p, s->operand_size == 2 ? 2 : 4, 1);
+
+    case OPND_Pq:
+        s->has_register = 1;
+        return emit_register(s, p, FREG_MMX, info->modrm_reg & 7);
+    case OPND_Qq:
+    case OPND_Nq:
+        if (info->modrm_mod == MODRM_MOD_REGISTER) {
+            s->has_register = 1;
+            return emit_register(s, p, FREG_MMX, info->modrm_rm & 7);
+        }
+        return emit_memory(s, p, 8);
+
+    case OPND_PK:
+        if (s->evex) {
+            return emit_register(s, p, FREG_K, info->modrm_reg & 7);
+        }
+        // Fall through
+    case OPND_Pxm:
+        if (mm) {
+            s->has_register = 1;
+            return emit_register(s, p, FREG_MMX, info->modrm_reg & 7);
+        }
+        return emit_vector_register(s, p, s->vector_size, info->modrm_reg);
+    case OPND_Qxm:
+    case OPND_Nxm:
+        if (mm) {
+            if (info->modrm_mod == MODRM_MOD_REGISTER) {
+                s->has_register = 1;
+                return emit_register(s, p, FREG_MMX, info->modrm_rm & 7);
+            }
+            return emit_memory(s, p, 8);
+        }
+        return emit_vector_rm(s, p, s->vector_size);
+
+    case OPND_VK:
+        if (s->evex) {
+            return emit_register(s, p, FREG_K, info->modrm_reg & 7);
+        }
+        // Fall through
+    case OPND_Vx: return emit_vector_register(s, p, s->vector_size, info->modrm_reg);
+    case OPND_Vdq: return emit_vector_register(s, p, 16, info->modrm_reg);
+    case OPND_Vh: return emit_vector_register(s, p, s->vector_size > 16 ? s->vector_size / 2 : 16, info->modrm_reg);
+    case OPND_Wx:
+    case OPND_Ux: return emit_vector_rm(s, p, s->vector_size);
+    case OPND_Wdq:
+    case OPND_Udq: return emit_vector_rm(s, p, 16);
+    case OPND_Wh: return emit_vector_rm(s, p, s->vector_size / 2);
+    case OPND_Wqt: return emit_vector_rm(s, p, s->vector_size / 4);
+    case OPND_Wo: return emit_vector_rm(s, p, s->vector_size / 8);
+    case OPND_Wq: return emit_vector_rm(s, p, 8);
+    case OPND_Wd: return emit_vector_rm(s, p, 4);
+    case OPND_Ww: return emit_vector_rm(s, p, 2);
+    case OPND_Wb: return emit_vector_rm(s, p, 1);
+    case OPND_Wsx: return emit_vector_rm(s, p, info->rex_w ? 8 : 4);
+
+    case OPND_Hx:
+        return s->vector ? emit_vector_register(s, p, s->vector_size, info->vex_vvvv) : p;
+    case OPND_Hdq:
+        return s->vector ? emit_vector_register(s, p, 16, info->vex_vvvv) : p;
+    case OPND_Hr:
+        return s->vector && info->modrm_mod == MODRM_MOD_REGISTER ? emit_vector_register(s, p, 16, info->vex_vvvv) : p;
+    case OPND_Lx:
+        return emit_vector_register(s, p, s->vector_size, (info->immediate.imm8 >> 4) & (s->mode64 ? 0x0F : 0x07));
+    case OPND_XMM0:
+        return emit_vector_register(s, p, 16, 0);
+
+    case OPND_KG:
+        s->has_register = 1;
+        return emit_register(s, p, FREG_K, info->modrm_reg & 7);
+    case OPND_KE:
+        if (info->modrm_mod == MODRM_MOD_REGISTER) {
+            s->has_register = 1;
+            return emit_register(s, p, FREG_K, info->modrm_rm & 7);
+        }
+        return emit_memory(s, p, opmask_size(info));
+    case OPND_KH:
+        s->has_register = 1;
+        return emit_register(s, p, FREG_K, info->vex_vvvv & 7);
+
+    case OPND_MVsib: {
+        // Dword indices cover half the vector length when the elements are qwords
+        unsigned int index_size = s->vector_size;
+        if ((s->opcode & 1) == 0 && info->rex_w && index_size > 16) {
+            index_size /= 2;
+        }
+        return emit_memory(s, p, info->rex_w ? 8 : 4, FREG_XMM + (index_size >> 5));
+    }
+
+    default:
+        return p;
+    }
+}
+
+/*
+ * Function to format one instruction into out
+ *
+ * out must have X86_FORMAT_BUFFER_SIZE bytes. Returns the text length; the
+ * text is not NUL-terminated.
+ */
+template <DisasmMode Mode>
+static size_t format_instruction(const InstructionInfo* info, uint64_t address, unsigned int att, char* out) {
+    FormatState s;
+    const FormatEntry* entry;
+    char operands[5][FORMAT_OPERAND_SIZE];
+    size_t lengths[5];
+    unsigned int count = 0;
+    unsigned int suffix;
+    char* p = out;
+
+    if (HAS_ANY_FLAG(info->flags, FLAG_ERROR_OPCODE | FLAG_ERROR_LENGTH)) {
+        goto bad;
+    }
+
+    s.info = info;
+    s.address = address;
+    s.att = att;
+    s.mode64 = Mode == DISASM_MODE_64;
+    s.vector = HAS_ANY_FLAG(info->flags, FLAG_VEX | FLAG_EVEX);
+    s.evex = HAS_FLAG(info->flags, FLAG_EVEX);
+    s.opcode = format_opcode(info);
+    s.address_size = format_address_size<Mode>(info);
+    s.suffix_size = 0;
+    s.has_register = 0;
+    s.fpu_suffix = NULL;
+
+    entry = resolve_format_entry<Mode>(info, att);
+    if (!entry) {
+        goto bad;
+    }
+
+    // Vector encodings are only defined for vector instructions and the VEX GPR group
+    if (s.vector && !(entry->flags & (FMT_SSE | FMT_NO_V))) {
+        goto bad;
+    }
+
+    s.operand_size = format_operand_size<Mode>(info, entry->flags);
+    s.vector_size = format_vector_size(info);
+
+    // Operands
+    for (unsigned int i = 0; i < 4 && entry->operands[i] != OPND_NONE; i++) {
+        char* operand = operands[count];
+        char* end = emit_operand(&s, operand, entry->operands[i]);
+
+        if (end == operand) {
+            continue;
+        }
+
+        // Opmask and zeroing follow the destination
+        if (count == 0 && s.evex && (info->evex_aaa || info->evex_z)) {
+            if (info->evex_aaa) {
+                *end++ = '{';
+                end = emit_register(&s, end, FREG_K, info->evex_aaa);
+                *end++ = '}';
+            }
+            if (info->evex_z) {
+                end = emit_text(end, "{z}", 3);
+            }
+        }
+        lengths[count++] = (size_t)(end - operand);
+    }
+
+    // Embedded rounding
+    if (s.evex && info->evex_b && info->modrm_mod == MODRM_MOD_REGISTER && HAS_FLAG(info->flags, FLAG_MODRM)) {
+        static const char rounding[4][9] = { "{rn-sae}", "{rd-sae}", "{ru-sae}", "{rz-sae}" };
+        memcpy(operands[count], rounding[info->vex_l & 3], 8);
+        lengths[count++] = 8;
+    }
+
+    // Prefixes
+    if (info->prefix_lock) {
+        p = emit_text(p, "lock ", 5);
+    }
+    if (info->prefix_rep == 0xF3 && (entry->flags & (FMT_REP | FMT_REPZ))) {
+        p = (entry->flags & FMT_REP) ? emit_text(p, "rep ", 4) : emit_text(p, "repe ", 5);
+    }
+    else if (info->prefix_rep == 0xF2 && (entry->flags & FMT_REPZ)) {
+        p = emit_text(p, "repne ", 6);
+    }
+
+    // Mnemonic
+    if (att && (entry->flags & FMT_FAR)) {
+        *p++ = 'l';
+    }
+    if (s.vector && !(entry->flags & FMT_NO_V)) {
+        *p++ = 'v';
+    }
+    memcpy(p, entry->mnemonic, sizeof(entry->mnemonic));
+
+    if (att && (entry->flags & FMT_ATT_MOVX)) {
+        // movzx/movsx/movsxd: movz/movs, then the source and destination sizes
+        static const char size_letters[9] = { 0, 'b', 'w', 0, 'l', 0, 0, 0, 'q' };
+        unsigned int source = entry->operands[1] == OPND_Eb ? 1 : entry->operands[1] == OPND_Ew ? 2 : 4;
+        p += 4;
+        *p++ = size_letters[source];
+        *p++ = size_letters[s.operand_size];
+    }
+    else {
+        p += entry->length;
+    }
+
+    suffix = FMT_SUFFIX(entry);
+    if (suffix) {
+        switch (suffix) {
+        case FMT_SUFFIX_DQ >> FMT_SUFFIX_SHIFT:
+            *p++ = info->rex_w ? 'q' : 'd';
+            break;
+
+        case FMT_SUFFIX_SD >> FMT_SUFFIX_SHIFT:
+            *p++ = info->rex_w ? 'd' : 's';
+            break;
+
+        case FMT_SUFFIX_BW >> FMT_SUFFIX_SHIFT:
+            *p++ = info->rex_w ? 'w' : 'b';
+            break;
+
+        case FMT_SUFFIX_EVEX_3264 >> FMT_SUFFIX_SHIFT:
+            if (s.evex) {
+                p = info->rex_w ? emit_text(p, "64", 2) : emit_text(p, "32", 2);
+            }
+            break;
+
+        case FMT_SUFFIX_EVEX_816 >> FMT_SUFFIX_SHIFT:
+            if (s.evex) {
+                p = info->rex_w ? emit_text(p, "16", 2) : emit_text(p, "8", 1);
+            }
+            break;
+
+        case FMT_SUFFIX_EVEX_DQ >> FMT_SUFFIX_SHIFT:
+            if (s.evex) {
+                *p++ = info->rex_w ? 'q' : 'd';
+            }
+            break;
+
+        case FMT_SUFFIX_K >> FMT_SUFFIX_SHIFT:
+            if (!g_opmask_letters[info->vex_pp][info->rex_w]) {
+                goto bad;
+            }
+            *p++ = g_opmask_letters[info->vex_pp][info->rex_w];
+            break;
+        }
+    }
+
+    // AT&T operand size suffix when no register operand gives the size
+    if (att && !(entry->flags & (FMT_ATT_MOVX | FMT_D64 | FMT_NO_SUFFIX))) {
+        if (s.fpu_suffix) {
+            p = emit_text(p, s.fpu_suffix, s.fpu_suffix[1] ? 2 : 1);
+        }
+        else if (s.suffix_size && !s.has_register) {
+            static const char size_letters[9] = { 0, 'b', 'w', 0, 'l', 0, 0, 0, 'q' };
+            *p++ = size_letters[s.suffix_size];
+        }
+    }
+
+    // Operands: Intel order, or reversed for AT&T
+    for (unsigned int i = 0; i < count; i++) {
+        unsigned int index = att ? count - 1 - i : i;
+
+        if (i == 0) {
+            *p++ = ' ';
+        }
+        else {
+            *p++ = ',';
+            if (!att) {
+                *p++ = ' ';
+            }
+        }
+        if (att && (entry->flags & FMT_INDIRECT)) {
+            *p++ = '*';
+        }
+        memcpy(p, operands[index], lengths[index]);
+        p += lengths[index];
+    }
+
+    return (size_t)(p - out);
+
+bad:
+    memcpy(out, "(bad)", 5);
+    return 5;
+}
+
+/*
+ * Single instruction formatting
+ */
+template <DisasmMode Mode>
+static size_t format_to_buffer(const InstructionInfo* info, uint64_t address, unsigned int format,
+    char* buffer, size_t size) {
+    unsigned int att = (format & DISASM_FORMAT_ATT) != 0;
+    char text[X86_FORMAT_BUFFER_SIZE];
+    size_t length;
+
+    if (size >= X86_FORMAT_BUFFER_SIZE) {
+        length = format_instruction<Mode>(info, address, att, buffer);
+        buffer[length] = '\0';
+        return length;
+    }
+
+    // Short buffer: format on the stack and truncate like snprintf
+    length = format_instruction<Mode>(info, address, att, text);
+    if (size > 0) {
+        size_t copy = length < size - 1 ? length : size - 1;
+        memcpy(buffer, text, copy);
+        buffer[copy] = '\0';
+    }
+    return length;
+}
+
+size_t x86_format(const InstructionInfo* info, uint64_t address, unsigned int format,
+    char* buffer, size_t size) {
+    return format_to_buffer<DISASM_MODE_64>(info, address, format, buffer, size);
+}
+
+size_t x86_format_mode(DisasmMode mode, const InstructionInfo* info, uint64_t address, unsigned int format,
+    char* buffer, size_t size) {
+    switch (mode) {
+    case DISASM_MODE_16:
+        return format_to_buffer<DISASM_MODE_16>(info, address, format, buffer, size);
+
+    case DISASM_MODE_32:
+        return format_to_buffer<DISASM_MODE_32>(info, address, format, buffer, size);
+
+    default:
+        return format_to_buffer<DISASM_MODE_64>(info, address, format, buffer, size);
+    }
+}
+
+/*
+ * Batch formatting
+ *
+ * Lines are written back to back while a worst-case line still fits, so
+ * the inner loop never checks the remaining space.
+ */
+template <DisasmMode Mode>
+static size_t format_batch(const DecodedInstruction* insns, size_t count, unsigned int format,
+    char* buffer, size_t size, size_t* written) {
+    unsigned int att = (format & DISASM_FORMAT_ATT) != 0;
+    unsigned int address_digits = Mode == DISASM_MODE_64 ? 16 : 8;
+    char* p = buffer;
+    char* end = buffer + size;
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        const DecodedInstruction* insn = &insns[i];
+
+        if ((size_t)(end - p) < FORMAT_LINE_SIZE + 1) {
+            break;
+        }
+
+        if (format & DISASM_FORMAT_ADDRESS) {
+            p = emit_hex_digits(p, insn->address, address_digits);
+            *p++ = ':';
+            *p++ = ' ';
+        }
+
+        if (format & DISASM_FORMAT_BYTES) {
+            unsigned int length = insn->info.length;
+
+            for (unsigned int j = 0; j < length; j++) {
+                memcpy(p, g_hex_pairs.digits[insn->info.bytes[j]], 2);
+                p[2] = ' ';
+                p += 3;
+            }
+            for (unsigned int j = length; j < FORMAT_BYTES_COLUMN; j++) {
+                memcpy(p, "   ", 3);
+                p += 3;
+            }
+        }
+
+        p += format_instruction<Mode>(&insn->info, insn->address, att, p);
+        *p++ = '\n';
+    }
+
+    if (p < end) {
+        *p = '\0';
+    }
+    if (written) {
+        *written = (size_t)(p - buffer);
+    }
+    return i;
+}
+
+size_t x86_format_batch(const DecodedInstruction* insns, size_t count, unsigned int format,
+    char* buffer, size_t size, size_t* written) {
+    return format_batch<DISASM_MODE_64>(insns, count, format, buffer, size, written);
+}
+
+size_t x86_format_batch_mode(DisasmMode mode, const DecodedInstruction* insns, size_t count, unsigned int format,
+    char* buffer, size_t size, size_t* written) {
+    switch (mode) {
+    case DISASM_MODE_16:
+        return format_batch<DISASM_MODE_16>(insns, count, format, buffer, size, written);
+
+    case DISASM_MODE_32:
+        return format_batch<DISASM_MODE_32>(insns, count, format, buffer, size, written);
+
+    default:
+        return format_batch<DISASM_MODE_64>(insns, count, format, buffer, size, written);
+    }
+}
@@ -0,0 +1,462 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include "disassm.h"
+#include "disassm_bitmap.h"
+
+/*
+ * Function boundary detection
+ *
+ * Every executable region is swept linearly in windows with
+ * x86_sweep_parallel, and the records of each window are analyzed in
+ * parallel slices that mark per-byte bitmaps of the region:
+ *
+ *   starts     instruction starts of the sweep
+ *   entries    relative call targets, and prologues after a block end
+ *   aligned    aligned instructions after a block end and padding
+ *   branches   conditional branch targets
+ *   padding    bytes of int3, nop and multi-byte nop padding
+ *
+ * Slices are split on 64-byte boundaries so the per-instruction maps are
+ * written by one thread per word; targets and padding may land anywhere
+ * and are set atomically. A final pass per region keeps the entries that
+ * are instruction starts and the aligned starts that no conditional
+ * branch targets (those are loop heads), adds the image's own functions,
+ * and ends each function at the next one, less the padding in between.
+ */
+// Bytes swept per window and thread: two sweep chunks each, with records
+// few enough to still be in cache when they are analyzed
+#define FUNCTION_WINDOW         (128 * 1024)
+#define FUNCTION_WINDOW_RECORDS (FUNCTION_WINDOW / 2)
+#define FUNCTION_SLICES_PER_THREAD 4
+#define FUNCTION_MIN_SLICE      4096                // Records
+#define FUNCTION_ALIGNMENT      16
+
+// Prologue byte patterns, matched against the first four bytes of an
+// instruction read as a little-endian word
+#define PROLOGUE_32 0x01
+#define PROLOGUE_64 0x02
+
+typedef struct {
+    uint8_t modes;
+    uint32_t mask;
+    uint32_t value;
+} ProloguePattern;
+
+static const ProloguePattern g_prologues[] = {
+    { PROLOGUE_64, 0xFFFFFFFF, 0xFA1E0FF3 },        // endbr64
+    { PROLOGUE_32, 0xFFFFFFFF, 0xFB1E0FF3 },        // endbr32
+    { PROLOGUE_64, 0xFFFFFFFF, 0xE5894855 },        // push rbp; mov rbp, rsp
+    { PROLOGUE_64, 0xFFFFFFFF, 0xEC8B4855 },        // push rbp; mov rbp, rsp
+    { PROLOGUE_32, 0x00FFFFFF, 0x00E58955 },        // push ebp; mov ebp, esp
+    { PROLOGUE_32, 0x00FFFFFF, 0x00EC8B55 },        // push ebp; mov ebp, esp
+    { PROLOGUE_32, 0x00FFFFFF, 0x0055FF8B },        // mov edi, edi; push ebp (hot-patch)
+    { PROLOGUE_64, 0x00FFFFFF, 0x00EC8348 },        // sub rsp, imm8
+    { PROLOGUE_64, 0x00FFFFFF, 0x00EC8148 },        // sub rsp, imm32
+    { PROLOGUE_64, 0x00FFFFFF, 0x00C48B48 },        // mov rax, rsp
+    { PROLOGUE_64, 0xFFFFFFFF, 0x245C8948 },        // mov [rsp+disp8], rbx
+    { PROLOGUE_64, 0xFFFFFFFF, 0x244C8948 },        // mov [rsp+disp8], rcx
+    { PROLOGUE_64, 0xFFFFFFFF, 0x2444894C },        // mov [rsp+disp8], r8
+    { PROLOGUE_64, 0x0000FFFF, 0x00005741 },        // push r15
+    { PROLOGUE_64, 0x0000FFFF, 0x00005641 },        // push r14
+    { PROLOGUE_64, 0x0000FFFF, 0x00005541 },        // push r13
+    { PROLOGUE_64, 0x0000FFFF, 0x00005441 },        // push r12
+    { PROLOGUE_64, 0x0000FFFF, 0x00005340 },        // push rbx (REX form)
+};
+
+typedef struct {
+    const CodeRegion* region;
+    uint64_t* starts;
+    uint64_t* entries;
+    uint64_t* aligned;
+    uint64_t* branches;
+    uint64_t* padding;
+} RegionMaps;
+
+typedef struct {
+    int ended;              // The last instruction that is not padding does not fall through
+    int padded;             // Padding follows it
+} FlowState;
+
+typedef struct {
+    DisasmMode mode;
+    RegionMaps* maps;
+    size_t map_count;
+    RegionMaps* current;
+    const DecodedInstruction* records;
+    size_t* splits;         // Slice k is records [splits[k], splits[k + 1])
+    size_t slice_count;
+    FlowState carry;        // State at the start of the window
+    std::atomic<size_t> next;
+} FunctionScan;
+
+static int is_padding(DisasmMode mode, const InstructionInfo* info) {
+    if (info->flags & (FLAG_MASK_ANY_ERROR | FLAG_MASK_ANY_VECTOR)) {
+        return 0;
+    }
+
+    if (info->map == OPCODE_MAP_0F) {
+        return info->opcode2 == 0x1F;       // nop r/m
+    }
+    if (info->map != OPCODE_MAP_1BYTE) {
+        return 0;
+    }
+
+    switch (info->opcode) {
+    case 0xCC:
+        return 1;
+
+    case 0x90:
+        // nop and xchg ax, ax, but not pause or xchg r8, rax
+        return !info->prefix_rep && !info->rex_b;
+
+    case 0x8D:
+        // 32-bit compilers pad with lea esi, [esi + 0] and similar
+        if (mode == DISASM_MODE_32 && (info->modrm_mod == 1 || info->modrm_mod == 2) &&
+            (info->modrm_mod == 1 ? info->displacement.disp8 : info->displacement.disp32) == 0) {
+            if (info->flags & FLAG_SIB) {
+                return info->sib_index == 4 && info->sib_base == info->modrm_reg;
+            }
+            return info->modrm_rm == info->modrm_reg;
+        }
+        return 0;
+    }
+
+    return 0;
+}
+
+static int has_prologue(DisasmMode mode, const CodeRegion* region, size_t offset) {
+    unsigned int modes = mode == DISASM_MODE_64 ? PROLOGUE_64 : PROLOGUE_32;
+    size_t available = region->size - offset < 4 ? region->size - offset : 4;
+    uint32_t word = 0;
+    uint32_t present = 0;
+
+    // Bytes past the end of the region never match a pattern byte
+    for (size_t i = 0; i < available; i++) {
+        word |= (uint32_t)region->code[offset + i] << (i * 8);
+        present |= (uint32_t)0xFF << (i * 8);
+    }
+
+    for (size_t i = 0; i < sizeof(g_prologues) / sizeof(g_prologues[0]); i++) {
+        const ProloguePattern* pattern = &g_prologues[i];
+
+        if ((pattern->modes & modes) && (pattern->mask & ~present) == 0 && (word & pattern->mask) == pattern->value) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static inline int ends_flow(DisasmFlow flow) {
+    return flow == DISASM_FLOW_JUMP || flow == DISASM_FLOW_INDIRECT_JUMP ||
+        flow == DISASM_FLOW_RETURN || flow == DISASM_FLOW_STOP;
+}
+
+// Marks a call target in the entries map, or a branch target in the
+// branches map, of the region containing it
+static void mark_target(FunctionScan* scan, uint64_t target, int call) {
+    for (size_t r = 0; r < scan->map_count; r++) {
+        RegionMaps* maps = &scan->maps[r];
+
+        if (target - maps->region->address < maps->region->size) {
+            bitmap_atomic_set(call ? maps->entries : maps->branches, (size_t)(target - maps->region->address));
+            return;
+        }
+    }
+}
+
+// State before records[index], looking back through padding
+static FlowState state_before(const FunctionScan* scan, size_t index) {
+    FlowState state = { 0, 0 };
+
+    while (index > 0) {
+        const InstructionInfo* info = &scan->records[--index].info;
+
+        if (!is_padding(scan->mode, info)) {
+            state.ended = ends_flow(x86_control_flow(info));
+            return state;
+        }
+        state.padded = 1;
+    }
+
+    state.ended = scan->carry.ended;
+    state.padded |= scan->carry.padded;
+    return state;
+}
+
+static void analyze_slice(FunctionScan* scan, size_t slice) {
+    RegionMaps* maps = scan->current;
+    const CodeRegion* region = maps->region;
+    FlowState state = state_before(scan, scan->splits[slice]);
+
+    for (size_t i = scan->splits[slice]; i < scan->splits[slice + 1]; i++) {
+        const DecodedInstruction* insn = &scan->records[i];
+        size_t offset = (size_t)(insn->address - region->address);
+
+        bitmap_set(maps->starts, offset);
+        if (is_padding(scan->mode, &insn->info)) {
+            bitmap_atomic_set_range(maps->padding, offset, offset + insn->info.length);
+            state.padded = 1;
+            continue;
+        }
+
+        DisasmFlow flow = x86_control_flow(&insn->info);
+        if (state.ended) {
+            if (has_prologue(scan->mode, region, offset)) {
+                bitmap_atomic_set(maps->entries, offset);
+            }
+            else if (state.padded && insn->address % FUNCTION_ALIGNMENT == 0) {
+                bitmap_set(maps->aligned, offset);
+            }
+        }
+
+        if (flow == DISASM_FLOW_CALL) {
+            mark_target(scan, insn->target, 1);
+        }
+        else if (flow == DISASM_FLOW_BRANCH) {
+            mark_target(scan, insn->target, 0);
+        }
+
+        state.ended = ends_flow(flow);
+        state.padded = 0;
+    }
+}
+
+static void analyze_worker(FunctionScan* scan) {
+    size_t slice;
+
+    while ((slice = scan->next.fetch_add(1)) < scan->slice_count) {
+        analyze_slice(scan, slice);
+    }
+}
+
+// Sweeps and analyzes one region
+static void scan_region(FunctionScan* scan, RegionMaps* maps, DecodedInstruction* records,
+    size_t* splits, unsigned int threads) {
+    const CodeRegion* region = maps->region;
+    size_t offset = 0;
+
+    scan->current = maps;
+    scan->records = records;
+    scan->splits = splits;
+
+    // The region start counts as a block end followed by padding
+    scan->carry.ended = 1;
+    scan->carry.padded = 1;
+
+    while (offset < region->size) {
+        DisasmBatchResult result;
+        size_t window = region->size - offset < (size_t)threads * FUNCTION_WINDOW ?
+            region->size - offset : (size_t)threads * FUNCTION_WINDOW;
+        size_t count = x86_sweep_parallel(scan->mode, region->code + offset, window, region->address + offset,
+            records, (size_t)threads * FUNCTION_WINDOW_RECORDS, threads, &result);
+
+        // Slices of at least FUNCTION_MIN_SLICE records, starting on 64-byte words
+        scan->slice_count = (size_t)threads * FUNCTION_SLICES_PER_THREAD;
+        if (scan->slice_count > count / FUNCTION_MIN_SLICE) {
+            scan->slice_count = count / FUNCTION_MIN_SLICE ? count / FUNCTION_MIN_SLICE : 1;
+        }
+        splits[0] = 0;
+        for (size_t k = 1; k < scan->slice_count; k++) {
+            size_t split = count / scan->slice_count * k;
+            while (split < count && (records[split].address - region->address) / 64 ==
+                (records[split - 1].address - region->address) / 64) {
+                split++;
+            }
+            splits[k] = split;
+        }
+        splits[scan->slice_count] = count;
+
+        scan->next = 0;
+        if (threads > 1 && scan->slice_count > 1) {
+            std::thread* workers = new std::thread[threads - 1];
+            for (unsigned int i = 0; i < threads - 1; i++) {
+                workers[i] = std::thread(analyze_worker, scan);
+            }
+            analyze_worker(scan);
+            for (unsigned int i = 0; i < threads - 1; i++) {
+                workers[i].join();
+            }
+            delete[] workers;
+        }
+        else {
+            analyze_worker(scan);
+        }
+
+        scan->carry = state_before(scan, count);
+        if (result.reason == DISASM_STOP_TRUNCATED && window == region->size - offset) {
+            break;
+        }
+        offset += result.offset;
+        if (result.offset == 0) {
+            break;
+        }
+    }
+}
+
+/*
+ * Turns the maps of a region into ranges. With out == NULL only counts.
+ * metadata is the image's function list, sorted by start.
+ */
+static size_t emit_functions(const RegionMaps* maps, const FunctionRange* metadata, size_t metadata_count,
+    FunctionRange* out) {
+    const CodeRegion* region = maps->region;
+    size_t count = 0;
+    size_t offset = 0;
+    uint64_t covered = region->address;
+    size_t m = 0;
+
+    while (m < metadata_count && metadata[m].start < region->address) {
+        m++;
+    }
+
+    for (;;) {
+        offset = bitmap_next(maps->entries, offset, region->size);
+        if (offset == region->size) {
+            break;
+        }
+
+        uint64_t start = region->address + offset;
+        size_t next = bitmap_next(maps->entries, offset + 1, region->size);
+        uint64_t end;
+
+        while (m < metadata_count && metadata[m].start < start) {
+            m++;
+        }
+
+        if (start >= covered) {
+            if (m < metadata_count && metadata[m].start == start && metadata[m].end > start) {
+                // Known extent
+                end = metadata[m].end < region->address + region->size ? metadata[m].end : region->address + region->size;
+            }
+            else {
+                // Up to the next function, less the padding in front of it
+                size_t last = next;
+                while (last > offset + 1 && bitmap_test(maps->padding, last - 1)) {
+                    last--;
+                }
+                end = region->address + last;
+            }
+
+            if (out) {
+                out[count].start = start;
+                out[count].end = end;
+            }
+            count++;
+            covered = end;
+        }
+
+        offset = next;
+    }
+
+    return count;
+}
+
+// Combines the maps of a region into its entries map
+static void merge_region(RegionMaps* maps, const LoadedImage* image) {
+    const CodeRegion* region = maps->region;
+
+    for (size_t w = 0; w < BITMAP_WORDS(region->size); w++) {
+        maps->entries[w] = (maps->entries[w] & maps->starts[w]) | (maps->aligned[w] & ~maps->branches[w]);
+    }
+
+    if (image->entry - region->address < region->size) {
+        bitmap_set(maps->entries, (size_t)(image->entry - region->address));
+    }
+    for (size_t i = 0; i < image->function_count; i++) {
+        if (image->functions[i].start - region->address < region->size) {
+            bitmap_set(maps->entries, (size_t)(image->functions[i].start - region->address));
+        }
+    }
+}
+
+static int compare_region_maps(const void* a, const void* b) {
+    uint64_t x = ((const RegionMaps*)a)->region->address;
+    uint64_t y = ((const RegionMaps*)b)->region->address;
+    return x < y ? -1 : x > y;
+}
+
+int x86_find_functions(const LoadedImage* image, unsigned int threads, FunctionRange** functions, size_t* count) {
+    FunctionScan scan;
+    RegionMaps* maps;
+    DecodedInstruction* records;
+    size_t* splits;
+    size_t total = 0;
+    int status = 0;
+
+    *functions = NULL;
+    *count = 0;
+
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    maps = (RegionMaps*)calloc(image->region_count ? image->region_count : 1, sizeof(RegionMaps));
+    records = (DecodedInstruction*)malloc((size_t)threads * FUNCTION_WINDOW_RECORDS * sizeof(DecodedInstruction));
+    splits = (size_t*)malloc(((size_t)threads * FUNCTION_SLICES_PER_THREAD + 1) * sizeof(size_t));
+    if (!maps || !records || !splits) {
+        goto done;
+    }
+
+    for (size_t r = 0; r < image->region_count; r++) {
+        size_t words = BITMAP_WORDS(image->regions[r].size);
+
+        maps[r].region = &image->regions[r];
+        maps[r].starts = (uint64_t*)calloc(words, sizeof(uint64_t));
+        maps[r].entries = (uint64_t*)calloc(words, sizeof(uint64_t));
+        maps[r].aligned = (uint64_t*)calloc(words, sizeof(uint64_t));
+        maps[r].branches = (uint64_t*)calloc(words, sizeof(uint64_t));
+        maps[r].padding = (uint64_t*)calloc(words, sizeof(uint64_t));
+        if (!maps[r].starts || !maps[r].entries || !maps[r].aligned || !maps[r].branches || !maps[r].padding) {
+            goto done;
+        }
+    }
+    qsort(maps, image->region_count, sizeof(RegionMaps), compare_region_maps);
+
+    // Targets may land in any region, so all regions are swept before any is merged
+    scan.mode = image->mode;
+    scan.maps = maps;
+    scan.map_count = image->region_count;
+    for (size_t r = 0; r < image->region_count; r++) {
+        scan_region(&scan, &maps[r], records, splits, threads);
+    }
+
+    for (size_t r = 0; r < image->region_count; r++) {
+        merge_region(&maps[r], image);
+        total += emit_functions(&maps[r], image->functions, image->function_count, NULL);
+    }
+
+    *functions = (FunctionRange*)malloc((total ? total : 1) * sizeof(FunctionRange));
+    if (!*functions) {
+        goto done;
+    }
+    for (size_t r = 0; r < image->region_count; r++) {
+        *count += emit_functions(&maps[r], image->functions, image->function_count, *functions + *count);
+    }
+    status = 1;
+
+done:
+    if (maps) {
+        for (size_t r = 0; r < image->region_count; r++) {
+            free(maps[r].starts);
+            free(maps[r].entries);
+            free(maps[r].aligned);
+            free(maps[r].branches);
+            free(maps[r].padding);
+        }
+    }
+    free(maps);
+    free(records);
+    free(splits);
+    return status;
+}
+
+void x86_functions_free(FunctionRange* functions) {
+    free(functions);
+}
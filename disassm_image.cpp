@@ -0,0 +1,727 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "disassm.h"
+
+#if defined(_WIN32)
+#include "Windows.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ * File mapping
+ */
+#if defined(_WIN32)
+
+int x86_map_file(const char* path, unsigned int flags, MappedFile* file) {
+    LARGE_INTEGER size;
+    HANDLE handle;
+    HANDLE mapping;
+    void* data;
+
+    memset(file, 0, sizeof(*file));
+
+    handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        (flags & DISASM_MAP_SEQUENTIAL) ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+
+    if (!GetFileSizeEx(handle, &size)) {
+        CloseHandle(handle);
+        return 0;
+    }
+
+    if (size.QuadPart == 0) {
+        // Empty files cannot be mapped
+        CloseHandle(handle);
+        return 1;
+    }
+
+    mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(handle);
+        return 0;
+    }
+
+    data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(handle);
+        return 0;
+    }
+
+    if (flags & DISASM_MAP_POPULATE) {
+        WIN32_MEMORY_RANGE_ENTRY range = { data, (SIZE_T)size.QuadPart };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+
+    file->data = (const uint8_t*)data;
+    file->size = (size_t)size.QuadPart;
+    file->file_handle = handle;
+    file->map_handle = mapping;
+    return 1;
+}
+
+void x86_unmap_file(MappedFile* file) {
+    if (file->data) {
+        UnmapViewOfFile(file->data);
+    }
+    if (file->map_handle) {
+        CloseHandle(file->map_handle);
+    }
+    if (file->file_handle) {
+        CloseHandle(file->file_handle);
+    }
+    memset(file, 0, sizeof(*file));
+}
+
+#else
+
+int x86_map_file(const char* path, unsigned int flags, MappedFile* file) {
+    struct stat st;
+    int map_flags = MAP_PRIVATE;
+    void* data;
+    int fd;
+
+    memset(file, 0, sizeof(*file));
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return 0;
+    }
+
+    if (st.st_size == 0) {
+        // Empty files cannot be mapped
+        close(fd);
+        return 1;
+    }
+
+#if defined(MAP_POPULATE)
+    if (flags & DISASM_MAP_POPULATE) {
+        map_flags |= MAP_POPULATE;
+    }
+#endif
+
+    data = mmap(NULL, (size_t)st.st_size, PROT_READ, map_flags, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return 0;
+    }
+
+    if (flags & DISASM_MAP_SEQUENTIAL) {
+        madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+    }
+
+    file->data = (const uint8_t*)data;
+    file->size = (size_t)st.st_size;
+    return 1;
+}
+
+void x86_unmap_file(MappedFile* file) {
+    if (file->data) {
+        munmap((void*)file->data, file->size);
+    }
+    memset(file, 0, sizeof(*file));
+}
+
+#endif
+
+/*
+ * Image helpers
+ */
+
+// Bounds check of a file range that cannot overflow
+static inline int file_range_valid(const MappedFile* file, uint64_t offset, uint64_t size) {
+    return offset <= file->size && size <= file->size - offset;
+}
+
+// Little-endian field readers; the headers are not necessarily aligned
+static inline uint16_t read16(const uint8_t* p) {
+    uint16_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint64_t read64(const uint8_t* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static void set_region(CodeRegion* region, const MappedFile* file, uint64_t offset, uint64_t size,
+    uint64_t address, const char* name, size_t name_length) {
+    if (name_length >= sizeof(region->name)) {
+        name_length = sizeof(region->name) - 1;
+    }
+
+    region->code = file->data + offset;
+    region->size = (size_t)size;
+    region->address = address;
+    region->file_offset = offset;
+    memcpy(region->name, name, name_length);
+    region->name[name_length] = '\0';
+}
+
+/*
+ * ELF
+ */
+#define ELF_MAGIC           0x464C457F  // "\x7F" "ELF"
+#define ELF_CLASS32         1
+#define ELF_CLASS64         2
+#define ELF_DATA_LSB        1
+#define ELF_MACHINE_386     3
+#define ELF_MACHINE_X86_64  62
+#define ELF_SHT_PROGBITS    1
+#define ELF_SHT_SYMTAB      2
+#define ELF_SHT_DYNSYM      11
+#define ELF_SHF_EXECINSTR   0x4
+#define ELF_PT_LOAD         1
+#define ELF_PF_X            0x1
+#define ELF_STT_FUNC        2
+#define ELF_STT_GNU_IFUNC   10
+
+// Header field offsets and sizes by class (ELF32, ELF64)
+typedef struct {
+    uint8_t header_size;
+    uint8_t entry;
+    uint8_t phoff;
+    uint8_t shoff;
+    uint8_t phentsize;
+    uint8_t phnum;
+    uint8_t shentsize;
+    uint8_t shnum;
+    uint8_t shstrndx;
+    uint8_t address_size;       // Size of Elf_Addr/Elf_Off
+
+    // Section header
+    uint8_t section_size;
+    uint8_t sh_type;
+    uint8_t sh_flags;
+    uint8_t sh_addr;
+    uint8_t sh_offset;
+    uint8_t sh_size;
+
+    // Program header
+    uint8_t segment_size;
+    uint8_t p_type;
+    uint8_t p_flags;
+    uint8_t p_offset;
+    uint8_t p_vaddr;
+    uint8_t p_filesz;
+
+    // Symbol
+    uint8_t symbol_size;
+    uint8_t st_value;
+    uint8_t st_size;
+    uint8_t st_info;
+    uint8_t st_shndx;
+} ElfLayout;
+
+static const ElfLayout g_elf_layouts[2] = {
+    // ELF32
+    { 52, 24, 28, 32, 42, 44, 46, 48, 50, 4,
+      40, 4, 8, 12, 16, 20,
+      32, 0, 24, 4, 8, 16,
+      16, 4, 8, 12, 14 },
+    // ELF64
+    { 64, 24, 32, 40, 54, 56, 58, 60, 62, 8,
+      64, 4, 8, 16, 24, 32,
+      56, 0, 4, 8, 16, 32,
+      24, 8, 16, 4, 6 },
+};
+
+// Elf_Addr/Elf_Off/Elf_Xword field of the class
+static inline uint64_t elf_word(const ElfLayout* layout, const uint8_t* p) {
+    return layout->address_size == 8 ? read64(p) : read32(p);
+}
+
+static int compare_functions(const void* a, const void* b) {
+    const FunctionRange* x = (const FunctionRange*)a;
+    const FunctionRange* y = (const FunctionRange*)b;
+
+    if (x->start != y->start) {
+        return x->start < y->start ? -1 : 1;
+    }
+    return x->end < y->end ? 1 : x->end > y->end ? -1 : 0;
+}
+
+/*
+ * Collects the defined function and IFUNC symbols of .symtab and .dynsym as
+ * functions, sorted by start with duplicates removed. A symbol without a
+ * size gets end == start.
+ */
+static DisasmImageStatus load_elf_functions(LoadedImage* image, const ElfLayout* layout,
+    const uint8_t* sections, unsigned int section_count) {
+    const MappedFile* file = &image->file;
+    size_t count = 0;
+
+    for (int pass = 0; pass < 2; pass++) {
+        count = 0;
+
+        for (unsigned int i = 0; i < section_count; i++) {
+            const uint8_t* section = sections + (size_t)i * layout->section_size;
+            uint32_t type = read32(section + layout->sh_type);
+            uint64_t offset = elf_word(layout, section + layout->sh_offset);
+            uint64_t size = elf_word(layout, section + layout->sh_size);
+
+            if ((type != ELF_SHT_SYMTAB && type != ELF_SHT_DYNSYM) || !file_range_valid(file, offset, size)) {
+                continue;
+            }
+
+            for (uint64_t entry = 0; entry + layout->symbol_size <= size; entry += layout->symbol_size) {
+                const uint8_t* symbol = file->data + offset + entry;
+                uint64_t value = elf_word(layout, symbol + layout->st_value);
+                unsigned int symbol_type = symbol[layout->st_info] & 0xF;
+
+                // An IFUNC symbol's value is its resolver function
+                if ((symbol_type != ELF_STT_FUNC && symbol_type != ELF_STT_GNU_IFUNC) || value == 0 ||
+                    read16(symbol + layout->st_shndx) == 0) {
+                    continue;
+                }
+
+                if (pass) {
+                    image->functions[count].start = value;
+                    image->functions[count].end = value + elf_word(layout, symbol + layout->st_size);
+                }
+                count++;
+            }
+        }
+
+        if (pass == 0) {
+            if (count == 0) {
+                return DISASM_IMAGE_OK;
+            }
+            image->functions = (FunctionRange*)malloc(count * sizeof(FunctionRange));
+            if (!image->functions) {
+                return DISASM_IMAGE_ERROR_MEMORY;
+            }
+        }
+    }
+
+    // Sort by start, longest first, and keep one range per start
+    qsort(image->functions, count, sizeof(FunctionRange), compare_functions);
+    image->function_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i == 0 || image->functions[i].start != image->functions[i - 1].start) {
+            image->functions[image->function_count++] = image->functions[i];
+        }
+    }
+
+    return DISASM_IMAGE_OK;
+}
+
+static DisasmImageStatus load_elf_image(LoadedImage* image) {
+    const MappedFile* file = &image->file;
+    const uint8_t* header = file->data;
+    const ElfLayout* layout;
+    const uint8_t* sections = NULL;
+    const uint8_t* names = NULL;
+    uint64_t names_size = 0;
+    unsigned int section_count;
+    unsigned int segment_count;
+    unsigned int machine;
+    size_t count = 0;
+
+    if (!file_range_valid(file, 0, 20) || header[5] != ELF_DATA_LSB ||
+        (header[4] != ELF_CLASS32 && header[4] != ELF_CLASS64)) {
+        return DISASM_IMAGE_ERROR_FORMAT;
+    }
+
+    layout = &g_elf_layouts[header[4] - ELF_CLASS32];
+    if (!file_range_valid(file, 0, layout->header_size)) {
+        return DISASM_IMAGE_ERROR_CORRUPT;
+    }
+
+    machine = read16(header + 18);
+    if (machine == ELF_MACHINE_X86_64) {
+        image->mode = DISASM_MODE_64;
+    }
+    else if (machine == ELF_MACHINE_386) {
+        image->mode = DISASM_MODE_32;
+    }
+    else {
+        return DISASM_IMAGE_ERROR_MACHINE;
+    }
+
+    image->format = DISASM_IMAGE_ELF;
+    image->entry = elf_word(layout, header + layout->entry);
+
+    // Section headers, and the section name string table when there is one
+    section_count = read16(header + layout->shnum);
+    if (section_count) {
+        uint64_t offset = elf_word(layout, header + layout->shoff);
+        unsigned int names_index = read16(header + layout->shstrndx);
+
+        if (read16(header + layout->shentsize) != layout->section_size ||
+            !file_range_valid(file, offset, (uint64_t)section_count * layout->section_size)) {
+            return DISASM_IMAGE_ERROR_CORRUPT;
+        }
+        sections = file->data + offset;
+
+        if (names_index < section_count) {
+            const uint8_t* names_header = sections + (size_t)names_index * layout->section_size;
+            uint64_t names_offset = elf_word(layout, names_header + layout->sh_offset);
+            names_size = elf_word(layout, names_header + layout->sh_size);
+            if (file_range_valid(file, names_offset, names_size)) {
+                names = file->data + names_offset;
+            }
+        }
+    }
+
+    segment_count = read16(header + layout->phnum);
+
+    // Executable sections; fall back to executable segments for images without sections
+    for (int pass = 0; pass < 2; pass++) {
+        count = 0;
+
+        for (unsigned int i = 0; i < section_count; i++) {
+            const uint8_t* section = sections + (size_t)i * layout->section_size;
+            uint64_t offset = elf_word(layout, section + layout->sh_offset);
+            uint64_t size = elf_word(layout, section + layout->sh_size);
+
+            if (read32(section + layout->sh_type) != ELF_SHT_PROGBITS ||
+                !(elf_word(layout, section + layout->sh_flags) & ELF_SHF_EXECINSTR) || size == 0) {
+                continue;
+            }
+            if (!file_range_valid(file, offset, size)) {
+                return DISASM_IMAGE_ERROR_CORRUPT;
+            }
+
+            if (pass) {
+                uint32_t name = read32(section);
+                const char* text = "";
+                size_t length = 0;
+
+                if (names && name < names_size) {
+                    text = (const char*)names + name;
+                    length = strnlen(text, (size_t)(names_size - name));
+                }
+                set_region(&image->regions[count], file, offset, size,
+                    elf_word(layout, section + layout->sh_addr), text, length);
+            }
+            count++;
+        }
+
+        if (section_count == 0 && segment_count) {
+            uint64_t table = elf_word(layout, header + layout->phoff);
+
+            if (read16(header + layout->phentsize) != layout->segment_size ||
+                !file_range_valid(file, table, (uint64_t)segment_count * layout->segment_size)) {
+                return DISASM_IMAGE_ERROR_CORRUPT;
+            }
+
+            for (unsigned int i = 0; i < segment_count; i++) {
+                const uint8_t* segment = file->data + table + (size_t)i * layout->segment_size;
+                uint64_t offset = elf_word(layout, segment + layout->p_offset);
+                uint64_t size = elf_word(layout, segment + layout->p_filesz);
+
+                if (read32(segment + layout->p_type) != ELF_PT_LOAD ||
+                    !(read32(segment + layout->p_flags) & ELF_PF_X) || size == 0) {
+                    continue;
+                }
+                if (!file_range_valid(file, offset, size)) {
+                    return DISASM_IMAGE_ERROR_CORRUPT;
+                }
+
+                if (pass) {
+                    set_region(&image->regions[count], file, offset, size,
+                        elf_word(layout, segment + layout->p_vaddr), "", 0);
+                }
+                count++;
+            }
+        }
+
+        // First pass counts, second pass fills
+        if (pass == 0) {
+            if (count == 0) {
+                break;
+            }
+            image->regions = (CodeRegion*)calloc(count, sizeof(CodeRegion));
+            if (!image->regions) {
+                return DISASM_IMAGE_ERROR_MEMORY;
+            }
+        }
+    }
+
+    image->region_count = count;
+    return load_elf_functions(image, layout, sections, section_count);
+}
+
+/*
+ * PE/COFF
+ */
+#define PE_DOS_MAGIC            0x5A4D      // "MZ"
+#define PE_SIGNATURE            0x00004550  // "PE\0\0"
+#define PE_MACHINE_I386         0x014C
+#define PE_MACHINE_AMD64        0x8664
+#define PE_MAGIC_PE32           0x010B
+#define PE_MAGIC_PE32_PLUS      0x020B
+#define PE_SCN_CNT_CODE         0x00000020
+#define PE_SCN_MEM_EXECUTE      0x20000000
+#define PE_DIRECTORY_EXCEPTION  3
+#define PE_SECTION_SIZE         40
+#define PE_RUNTIME_FUNCTION_SIZE 12
+
+// Optional header field offsets by magic (PE32, PE32+)
+typedef struct {
+    uint16_t magic;
+    uint8_t image_base;
+    uint8_t image_base_size;
+    uint8_t directory_count;    // NumberOfRvaAndSizes
+    uint8_t directories;        // First data directory
+} PeLayout;
+
+static const PeLayout g_pe_layouts[2] = {
+    { PE_MAGIC_PE32, 28, 4, 92, 96 },
+    { PE_MAGIC_PE32_PLUS, 24, 8, 108, 112 },
+};
+
+/*
+ * Function to find the file range of an RVA range
+ *
+ * In the on-disk layout an RVA is translated through the section that
+ * contains it; in the loaded layout the file offset is the RVA. Returns 0
+ * when the range is not backed by file data.
+ */
+static int pe_rva_to_offset(const MappedFile* file, const uint8_t* sections, unsigned int section_count,
+    unsigned int memory_layout, uint64_t rva, uint64_t size, uint64_t* offset) {
+    if (memory_layout) {
+        *offset = rva;
+        return file_range_valid(file, rva, size);
+    }
+
+    for (unsigned int i = 0; i < section_count; i++) {
+        const uint8_t* section = sections + (size_t)i * PE_SECTION_SIZE;
+        uint64_t address = read32(section + 12);
+        uint64_t raw_size = read32(section + 16);
+        uint64_t raw_offset = read32(section + 20);
+
+        if (rva >= address && rva - address < raw_size) {
+            if (size > raw_size - (rva - address)) {
+                return 0;
+            }
+            *offset = raw_offset + (rva - address);
+            return file_range_valid(file, *offset, size);
+        }
+    }
+
+    return 0;
+}
+
+static DisasmImageStatus load_pe_image(LoadedImage* image, unsigned int memory_layout) {
+    const MappedFile* file = &image->file;
+    const uint8_t* data = file->data;
+    const uint8_t* optional;
+    const uint8_t* sections;
+    const PeLayout* layout;
+    uint64_t header;
+    unsigned int machine;
+    unsigned int section_count;
+    unsigned int optional_size;
+    unsigned int directory_count;
+    size_t count = 0;
+
+    if (!file_range_valid(file, 0, 0x40)) {
+        return DISASM_IMAGE_ERROR_FORMAT;
+    }
+
+    header = read32(data + 0x3C);
+    if (!file_range_valid(file, header, 24) || read32(data + header) != PE_SIGNATURE) {
+        return DISASM_IMAGE_ERROR_FORMAT;
+    }
+
+    // COFF file header
+    machine = read16(data + header + 4);
+    section_count = read16(data + header + 6);
+    optional_size = read16(data + header + 20);
+
+    if (machine == PE_MACHINE_AMD64) {
+        image->mode = DISASM_MODE_64;
+    }
+    else if (machine == PE_MACHINE_I386) {
+        image->mode = DISASM_MODE_32;
+    }
+    else {
+        return DISASM_IMAGE_ERROR_MACHINE;
+    }
+
+    // Optional header
+    if (optional_size < 2 || !file_range_valid(file, header + 24, optional_size)) {
+        return DISASM_IMAGE_ERROR_CORRUPT;
+    }
+    optional = data + header + 24;
+
+    if (read16(optional) == PE_MAGIC_PE32) {
+        layout = &g_pe_layouts[0];
+    }
+    else if (read16(optional) == PE_MAGIC_PE32_PLUS) {
+        layout = &g_pe_layouts[1];
+    }
+    else {
+        return DISASM_IMAGE_ERROR_FORMAT;
+    }
+
+    if (optional_size < layout->directories) {
+        return DISASM_IMAGE_ERROR_CORRUPT;
+    }
+
+    image->format = DISASM_IMAGE_PE;
+    image->base = layout->image_base_size == 8 ? read64(optional + layout->image_base) : read32(optional + layout->image_base);
+    if (read32(optional + 16)) {
+        image->entry = image->base + read32(optional + 16);
+    }
+
+    directory_count = read32(optional + layout->directory_count);
+    if (directory_count > (optional_size - layout->directories) / 8) {
+        directory_count = (optional_size - layout->directories) / 8;
+    }
+
+    // Section table
+    if (!file_range_valid(file, header + 24 + optional_size, (uint64_t)section_count * PE_SECTION_SIZE)) {
+        return DISASM_IMAGE_ERROR_CORRUPT;
+    }
+    sections = data + header + 24 + optional_size;
+
+    // Executable sections: first pass counts, second pass fills
+    for (int pass = 0; pass < 2; pass++) {
+        count = 0;
+
+        for (unsigned int i = 0; i < section_count; i++) {
+            const uint8_t* section = sections + (size_t)i * PE_SECTION_SIZE;
+            uint64_t virtual_size = read32(section + 8);
+            uint64_t address = read32(section + 12);
+            uint64_t raw_size = read32(section + 16);
+            uint64_t offset = read32(section + 20);
+            uint64_t size;
+
+            if (!(read32(section + 36) & (PE_SCN_CNT_CODE | PE_SCN_MEM_EXECUTE))) {
+                continue;
+            }
+
+            if (memory_layout) {
+                // Loaded: the whole virtual size is present at the RVA
+                offset = address;
+                size = virtual_size ? virtual_size : raw_size;
+            }
+            else {
+                // On disk: only the raw data; the rest of the virtual size is zero fill
+                size = virtual_size && virtual_size < raw_size ? virtual_size : raw_size;
+            }
+
+            if (size == 0) {
+                continue;
+            }
+            if (!file_range_valid(file, offset, size)) {
+                return DISASM_IMAGE_ERROR_CORRUPT;
+            }
+
+            if (pass) {
+                set_region(&image->regions[count], file, offset, size, image->base + address,
+                    (const char*)section, strnlen((const char*)section, 8));
+            }
+            count++;
+        }
+
+        if (pass == 0) {
+            if (count == 0) {
+                break;
+            }
+            image->regions = (CodeRegion*)calloc(count, sizeof(CodeRegion));
+            if (!image->regions) {
+                return DISASM_IMAGE_ERROR_MEMORY;
+            }
+        }
+    }
+    image->region_count = count;
+
+    // Exception directory: one RUNTIME_FUNCTION per function (or chained fragment) on x64
+    if (machine == PE_MACHINE_AMD64 && directory_count > PE_DIRECTORY_EXCEPTION) {
+        const uint8_t* directory = optional + layout->directories + PE_DIRECTORY_EXCEPTION * 8;
+        uint64_t rva = read32(directory);
+        uint64_t size = read32(directory + 4);
+        uint64_t offset;
+        size_t entries = (size_t)(size / PE_RUNTIME_FUNCTION_SIZE);
+
+        if (entries && pe_rva_to_offset(file, sections, section_count, memory_layout,
+            rva, (uint64_t)entries * PE_RUNTIME_FUNCTION_SIZE, &offset)) {
+            image->functions = (FunctionRange*)malloc(entries * sizeof(FunctionRange));
+            if (!image->functions) {
+                return DISASM_IMAGE_ERROR_MEMORY;
+            }
+
+            for (size_t i = 0; i < entries; i++) {
+                const uint8_t* entry = data + offset + i * PE_RUNTIME_FUNCTION_SIZE;
+                uint32_t begin = read32(entry);
+                uint32_t end = read32(entry + 4);
+
+                if (begin < end) {
+                    FunctionRange* function = &image->functions[image->function_count++];
+                    function->start = image->base + begin;
+                    function->end = image->base + end;
+                }
+            }
+        }
+    }
+
+    return DISASM_IMAGE_OK;
+}
+
+/*
+ * Image loading functions
+ */
+DisasmImageStatus x86_image_load(const char* path, unsigned int map_flags, LoadedImage* image) {
+    memset(image, 0, sizeof(*image));
+    image->mode = DISASM_MODE_64;
+
+    if (!x86_map_file(path, map_flags, &image->file)) {
+        return DISASM_IMAGE_ERROR_IO;
+    }
+
+    if (file_range_valid(&image->file, 0, 4) && read32(image->file.data) == ELF_MAGIC) {
+        return load_elf_image(image);
+    }
+
+    if (file_range_valid(&image->file, 0, 2) && read16(image->file.data) == PE_DOS_MAGIC) {
+        return load_pe_image(image, (map_flags & DISASM_MAP_MEMORY_LAYOUT) != 0);
+    }
+
+    return DISASM_IMAGE_ERROR_FORMAT;
+}
+
+void x86_image_free(LoadedImage* image) {
+    free(image->regions);
+    free(image->functions);
+    x86_unmap_file(&image->file);
+    memset(image, 0, sizeof(*image));
+}
+
+const uint8_t* x86_image_code(const LoadedImage* image, uint64_t address, size_t* available) {
+    for (size_t i = 0; i < image->region_count; i++) {
+        const CodeRegion* region = &image->regions[i];
+
+        if (address >= region->address && address - region->address < region->size) {
+            if (available) {
+                *available = region->size - (size_t)(address - region->address);
+            }
+            return region->code + (address - region->address);
+        }
+    }
+
+    return NULL;
+}
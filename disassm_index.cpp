@@ -0,0 +1,694 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "disassm.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DISASM_INDEX_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/*
+ * Inverted instruction index
+ *
+ * Every instruction of a linear sweep adds its offset to the posting list
+ * of each of its terms. A list is split into blocks of INDEX_BLOCK
+ * postings; a skip entry holds the first posting of each block and where
+ * the deltas of the rest start, bit-packed at the width of the largest
+ * one. A block decodes on its own without branches, and an intersection
+ * only decodes the blocks that can match.
+ *
+ * Opcode, ModR/M and register terms have small values and are found
+ * through direct tables while building; immediates go through a hash
+ * table. The lists are finally packed into flat arrays sorted by term.
+ */
+#define INDEX_BLOCK         128
+#define INDEX_DIRECT        4096            // Values of the terms with direct tables
+#define INDEX_DIRECT_KINDS  4
+#define INDEX_BATCH         1024            // Records decoded per batch
+#define INDEX_HASH_MIN      4096
+
+typedef struct {
+    uint32_t first;         // First posting of the block
+    uint32_t offset;        // Width of the deltas of the rest (one byte), then the deltas, from the list's data
+} IndexSkip;
+
+typedef struct {
+    uint64_t value;
+    uint32_t kind;
+    uint32_t count;
+    size_t skip;            // First skip entry
+    size_t data;            // First byte of the deltas
+} IndexTermInfo;
+
+typedef struct {
+    uint64_t value;
+    uint32_t kind;
+    uint32_t count;
+    uint32_t last;
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    uint32_t* deltas;       // Deltas of the block being filled
+    size_t delta_capacity;
+    IndexSkip* skips;
+    size_t skip_count;
+    size_t skip_capacity;
+} TermBuilder;
+
+typedef struct {
+    TermBuilder* terms;
+    size_t term_count;
+    size_t term_capacity;
+    int32_t* direct;        // INDEX_DIRECT_KINDS * INDEX_DIRECT term numbers, -1 when absent
+    int32_t* hash;          // Immediate terms by value, -1 for a free slot
+    size_t hash_size;       // Power of two
+    size_t hash_used;
+    int failed;
+} IndexBuilder;
+
+static inline uint64_t hash_value(uint64_t value) {
+    return value * 0x9E3779B97F4A7C15ull;
+}
+
+static int32_t add_term(IndexBuilder* builder, DisasmTermKind kind, uint64_t value) {
+    TermBuilder* term;
+
+    if (builder->term_count == builder->term_capacity) {
+        size_t capacity = builder->term_capacity ? builder->term_capacity * 2 : 1024;
+        TermBuilder* grown = (TermBuilder*)realloc(builder->terms, capacity * sizeof(TermBuilder));
+        if (!grown) {
+            builder->failed = 1;
+            return -1;
+        }
+        builder->terms = grown;
+        builder->term_capacity = capacity;
+    }
+
+    term = &builder->terms[builder->term_count];
+    memset(term, 0, sizeof(*term));
+    term->value = value;
+    term->kind = (uint32_t)kind;
+    return (int32_t)builder->term_count++;
+}
+
+static int grow_hash(IndexBuilder* builder) {
+    size_t size = builder->hash_size ? builder->hash_size * 2 : INDEX_HASH_MIN;
+    int32_t* hash = (int32_t*)malloc(size * sizeof(int32_t));
+
+    if (!hash) {
+        return 0;
+    }
+    memset(hash, 0xFF, size * sizeof(int32_t));
+
+    for (size_t i = 0; i < builder->hash_size; i++) {
+        if (builder->hash[i] >= 0) {
+            size_t slot = (size_t)(hash_value(builder->terms[builder->hash[i]].value) >> 32) & (size - 1);
+            while (hash[slot] >= 0) {
+                slot = (slot + 1) & (size - 1);
+            }
+            hash[slot] = builder->hash[i];
+        }
+    }
+
+    free(builder->hash);
+    builder->hash = hash;
+    builder->hash_size = size;
+    return 1;
+}
+
+static int32_t find_term(IndexBuilder* builder, DisasmTermKind kind, uint64_t value) {
+    size_t slot;
+
+    if (kind != DISASM_TERM_IMMEDIATE) {
+        int32_t* entry = &builder->direct[(size_t)kind * INDEX_DIRECT + (size_t)value];
+        if (*entry < 0) {
+            *entry = add_term(builder, kind, value);
+        }
+        return *entry;
+    }
+
+    if ((builder->hash_used + 1) * 2 > builder->hash_size && !grow_hash(builder)) {
+        builder->failed = 1;
+        return -1;
+    }
+    slot = (size_t)(hash_value(value) >> 32) & (builder->hash_size - 1);
+    while (builder->hash[slot] >= 0) {
+        if (builder->terms[builder->hash[slot]].value == value) {
+            return builder->hash[slot];
+        }
+        slot = (slot + 1) & (builder->hash_size - 1);
+    }
+
+    builder->hash[slot] = add_term(builder, kind, value);
+    builder->hash_used++;
+    return builder->hash[slot];
+}
+
+// Bit-packs the deltas of the block being filled
+static int pack_block(TermBuilder* term) {
+    size_t count = (term->count - 1) % INDEX_BLOCK;
+    uint32_t largest = 0;
+    unsigned int bits = 0;
+    uint64_t buffer = 0;
+    unsigned int buffered = 0;
+    size_t bytes;
+
+    for (size_t i = 0; i < count; i++) {
+        largest |= term->deltas[i];
+    }
+    while (bits < 32 && largest >> bits) {
+        bits++;
+    }
+
+    bytes = 1 + (count * bits + 7) / 8;
+    if (term->size + bytes > term->capacity) {
+        size_t capacity = term->capacity * 2 > term->size + bytes ? term->capacity * 2 : term->size + bytes + 16;
+        uint8_t* grown = (uint8_t*)realloc(term->data, capacity);
+        if (!grown) {
+            return 0;
+        }
+        term->data = grown;
+        term->capacity = capacity;
+    }
+
+    term->data[term->size++] = (uint8_t)bits;
+    for (size_t i = 0; i < count; i++) {
+        buffer |= (uint64_t)term->deltas[i] << buffered;
+        buffered += bits;
+        while (buffered >= 8) {
+            term->data[term->size++] = (uint8_t)buffer;
+            buffer >>= 8;
+            buffered -= 8;
+        }
+    }
+    if (buffered) {
+        term->data[term->size++] = (uint8_t)buffer;
+    }
+
+    return 1;
+}
+
+static void add_posting(IndexBuilder* builder, DisasmTermKind kind, uint64_t value, uint32_t offset) {
+    int32_t number = find_term(builder, kind, value);
+    TermBuilder* term;
+
+    if (number < 0) {
+        return;
+    }
+    term = &builder->terms[number];
+
+    // An instruction counts once per term, e.g. for xor eax, eax
+    if (term->count && term->last == offset) {
+        return;
+    }
+
+    if (term->count % INDEX_BLOCK == 0) {
+        if (term->count && !pack_block(term)) {
+            builder->failed = 1;
+            return;
+        }
+        if (term->skip_count == term->skip_capacity) {
+            size_t capacity = term->skip_capacity ? term->skip_capacity * 2 : 1;
+            IndexSkip* grown = (IndexSkip*)realloc(term->skips, capacity * sizeof(IndexSkip));
+            if (!grown) {
+                builder->failed = 1;
+                return;
+            }
+            term->skips = grown;
+            term->skip_capacity = capacity;
+        }
+        term->skips[term->skip_count].first = offset;
+        term->skips[term->skip_count++].offset = (uint32_t)term->size;
+    }
+    else {
+        size_t position = term->count % INDEX_BLOCK - 1;
+
+        if (position == term->delta_capacity) {
+            size_t capacity = term->delta_capacity ? term->delta_capacity * 4 : 4;
+            uint32_t* grown = (uint32_t*)realloc(term->deltas,
+                (capacity < INDEX_BLOCK ? capacity : INDEX_BLOCK) * sizeof(uint32_t));
+            if (!grown) {
+                builder->failed = 1;
+                return;
+            }
+            term->deltas = grown;
+            term->delta_capacity = capacity < INDEX_BLOCK ? capacity : INDEX_BLOCK;
+        }
+        term->deltas[position] = offset - term->last;
+    }
+
+    term->last = offset;
+    term->count++;
+}
+
+static void add_register(IndexBuilder* builder, DisasmTermKind kind, OperandRegister reg, uint32_t offset) {
+    if (reg.reg_class != REGCLASS_NONE) {
+        add_posting(builder, kind, (uint64_t)reg.reg_class << 8 | reg.index, offset);
+    }
+}
+
+// Terms of one valid instruction
+static void add_instruction(IndexBuilder* builder, DisasmMode mode, const uint8_t* code, const DecodedInstruction* insn,
+    uint32_t offset) {
+    InstructionOperand operands[X86_MAX_OPERANDS];
+    PackedInstruction packed;
+    unsigned int count;
+
+    x86_pack_instruction(&insn->info, offset, &packed);
+    add_posting(builder, DISASM_TERM_OPCODE, (uint64_t)packed.map << 8 | packed.opcode, offset);
+    if (packed.flags & PACKED_MODRM) {
+        // From the decoded record: the packed REX bits have no room for EVEX.R'
+        add_posting(builder, DISASM_TERM_MODRM_REG, insn->info.modrm_reg, offset);
+    }
+    if (PACKED_IMM_SIZE(&packed) && !(packed.flags & PACKED_RELATIVE)) {
+        add_posting(builder, DISASM_TERM_IMMEDIATE, x86_packed_immediate(&packed, code), offset);
+    }
+
+    count = x86_decode_operands(mode, &insn->info, operands);
+    for (unsigned int i = 0; i < count; i++) {
+        const InstructionOperand* operand = &operands[i];
+
+        if (operand->type == OPERAND_REGISTER) {
+            if (operand->access & OPERAND_ACCESS_READ) {
+                add_register(builder, DISASM_TERM_READ, operand->reg, offset);
+            }
+            if (operand->access & OPERAND_ACCESS_WRITE) {
+                add_register(builder, DISASM_TERM_WRITE, operand->reg, offset);
+            }
+        }
+        else if (operand->type == OPERAND_MEMORY) {
+            add_register(builder, DISASM_TERM_READ, operand->base, offset);
+            add_register(builder, DISASM_TERM_READ, operand->index, offset);
+        }
+    }
+}
+
+static int compare_terms(const void* a, const void* b) {
+    const TermBuilder* x = (const TermBuilder*)a;
+    const TermBuilder* y = (const TermBuilder*)b;
+
+    if (x->kind != y->kind) {
+        return x->kind < y->kind ? -1 : 1;
+    }
+    return x->value < y->value ? -1 : x->value > y->value;
+}
+
+// Packs the lists into the flat arrays of the index
+static int pack_terms(IndexBuilder* builder, InstructionIndex* index) {
+    IndexTermInfo* terms;
+    IndexSkip* skips;
+    size_t skip_count = 0;
+    size_t data_size = 0;
+
+    qsort(builder->terms, builder->term_count, sizeof(TermBuilder), compare_terms);
+    for (size_t t = 0; t < builder->term_count; t++) {
+        if (!pack_block(&builder->terms[t])) {
+            return 0;
+        }
+        skip_count += builder->terms[t].skip_count;
+        data_size += builder->terms[t].size;
+    }
+
+    terms = (IndexTermInfo*)malloc((builder->term_count ? builder->term_count : 1) * sizeof(IndexTermInfo));
+    skips = (IndexSkip*)malloc((skip_count ? skip_count : 1) * sizeof(IndexSkip));
+    // Blocks are unpacked with 8-byte reads that may run past the last one
+    index->data = (uint8_t*)calloc(data_size + 8, 1);
+    index->terms = terms;
+    index->skips = skips;
+    if (!terms || !skips || !index->data) {
+        return 0;
+    }
+
+    skip_count = 0;
+    data_size = 0;
+    for (size_t t = 0; t < builder->term_count; t++) {
+        const TermBuilder* term = &builder->terms[t];
+
+        terms[t].value = term->value;
+        terms[t].kind = term->kind;
+        terms[t].count = term->count;
+        terms[t].skip = skip_count;
+        terms[t].data = data_size;
+        memcpy(skips + skip_count, term->skips, term->skip_count * sizeof(IndexSkip));
+        memcpy(index->data + data_size, term->data, term->size);
+        skip_count += term->skip_count;
+        data_size += term->size;
+        index->posting_count += term->count;
+    }
+
+    index->term_count = builder->term_count;
+    index->data_size = data_size;
+    return 1;
+}
+
+static void free_builder(IndexBuilder* builder) {
+    for (size_t t = 0; t < builder->term_count; t++) {
+        free(builder->terms[t].data);
+        free(builder->terms[t].deltas);
+        free(builder->terms[t].skips);
+    }
+    free(builder->terms);
+    free(builder->direct);
+    free(builder->hash);
+}
+
+int x86_index_build(InstructionIndex* index, DisasmMode mode, const void* code, size_t length) {
+    const uint8_t* base = (const uint8_t*)code;
+    DecodedInstruction* records = (DecodedInstruction*)malloc(INDEX_BATCH * sizeof(DecodedInstruction));
+    IndexBuilder builder;
+    size_t offset = 0;
+    int status = 0;
+
+    memset(index, 0, sizeof(*index));
+    memset(&builder, 0, sizeof(builder));
+    builder.direct = (int32_t*)malloc(INDEX_DIRECT_KINDS * INDEX_DIRECT * sizeof(int32_t));
+    if (!records || !builder.direct || length > UINT32_MAX) {
+        goto done;
+    }
+    memset(builder.direct, 0xFF, INDEX_DIRECT_KINDS * INDEX_DIRECT * sizeof(int32_t));
+
+    while (offset < length && !builder.failed) {
+        DisasmBatchResult result;
+        size_t count = x86_disasm_batch_mode(mode, base + offset, length - offset, offset, records, INDEX_BATCH,
+            &result);
+
+        for (size_t i = 0; i < count; i++) {
+            if (!(records[i].info.flags & FLAG_MASK_ANY_ERROR)) {
+                add_instruction(&builder, mode, base, &records[i], (uint32_t)records[i].address);
+            }
+        }
+        index->instruction_count += count;
+        offset += result.offset;
+        if (result.reason != DISASM_STOP_FULL) {
+            break;
+        }
+    }
+
+    status = !builder.failed && pack_terms(&builder, index);
+
+done:
+    free_builder(&builder);
+    free(records);
+    if (!status) {
+        x86_index_free(index);
+    }
+    return status;
+}
+
+void x86_index_free(InstructionIndex* index) {
+    free(index->terms);
+    free(index->skips);
+    free(index->data);
+    memset(index, 0, sizeof(*index));
+}
+
+static const IndexTermInfo* lookup_term(const InstructionIndex* index, IndexTerm term) {
+    const IndexTermInfo* terms = (const IndexTermInfo*)index->terms;
+    size_t low = 0;
+    size_t high = index->term_count;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (terms[middle].kind < (uint32_t)term.kind ||
+            (terms[middle].kind == (uint32_t)term.kind && terms[middle].value < term.value)) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    return low < index->term_count && terms[low].kind == (uint32_t)term.kind && terms[low].value == term.value ?
+        &terms[low] : NULL;
+}
+
+size_t x86_index_count(const InstructionIndex* index, IndexTerm term) {
+    const IndexTermInfo* info = lookup_term(index, term);
+    return info ? info->count : 0;
+}
+
+// Decodes block b of a list into out; returns its number of postings
+static size_t decode_block(const InstructionIndex* index, const IndexTermInfo* info, size_t b, uint32_t* out) {
+    const IndexSkip* skip = &((const IndexSkip*)index->skips)[info->skip + b];
+    const uint8_t* p = index->data + info->data + skip->offset;
+    size_t count = info->count - b * INDEX_BLOCK < INDEX_BLOCK ? info->count - b * INDEX_BLOCK : INDEX_BLOCK;
+    unsigned int bits = *p++;
+    uint32_t mask = bits < 32 ? ((uint32_t)1 << bits) - 1 : ~(uint32_t)0;
+    uint32_t value = skip->first;
+
+    out[0] = value;
+    for (size_t i = 1; i < count; i++) {
+        size_t position = (i - 1) * bits;
+        uint64_t word;
+
+        memcpy(&word, p + position / 8, sizeof(word));
+        value += (uint32_t)(word >> (position % 8)) & mask;
+        out[i] = value;
+    }
+
+    return count;
+}
+
+static size_t decode_list(const InstructionIndex* index, const IndexTermInfo* info, uint32_t* out) {
+    size_t count = 0;
+
+    for (size_t b = 0; b * INDEX_BLOCK < info->count; b++) {
+        count += decode_block(index, info, b, out + count);
+    }
+    return count;
+}
+
+size_t x86_postings_intersect(const uint32_t* a, size_t a_count, const uint32_t* b, size_t b_count, uint32_t* out) {
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+
+#ifdef DISASM_INDEX_SSE2
+    // Four by four: each value of a against the four rotations of b
+    while (i + 4 <= a_count && j + 4 <= b_count) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + j));
+        __m128i equal = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+        unsigned int mask = (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(equal));
+        uint32_t a_last = a[i + 3];
+        uint32_t b_last = b[j + 3];
+
+        while (mask) {
+            unsigned int lane = mask & 1 ? 0 : mask & 2 ? 1 : mask & 4 ? 2 : 3;
+            out[count++] = a[i + lane];
+            mask &= mask - 1;
+        }
+        i += a_last <= b_last ? 4 : 0;
+        j += b_last <= a_last ? 4 : 0;
+    }
+#endif
+
+    while (i < a_count && j < b_count) {
+        if (a[i] < b[j]) {
+            i++;
+        }
+        else if (b[j] < a[i]) {
+            j++;
+        }
+        else {
+            out[count++] = a[i];
+            i++;
+            j++;
+        }
+    }
+
+    return count;
+}
+
+size_t x86_postings_union(const uint32_t* a, size_t a_count, const uint32_t* b, size_t b_count, uint32_t* out) {
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+
+    while (i < a_count && j < b_count) {
+        uint32_t x = a[i];
+        uint32_t y = b[j];
+
+        out[count++] = x < y ? x : y;
+        i += x <= y;
+        j += y <= x;
+    }
+    memcpy(out + count, a + i, (a_count - i) * sizeof(uint32_t));
+    count += a_count - i;
+    memcpy(out + count, b + j, (b_count - j) * sizeof(uint32_t));
+    count += b_count - j;
+
+    return count;
+}
+
+// Keeps the candidates that are in a list, decoding only the blocks that can hold them
+static size_t intersect_list(const InstructionIndex* index, const IndexTermInfo* info, uint32_t* candidates,
+    size_t count) {
+    const IndexSkip* skips = &((const IndexSkip*)index->skips)[info->skip];
+    size_t block_count = (info->count + INDEX_BLOCK - 1) / INDEX_BLOCK;
+    uint32_t block[INDEX_BLOCK];
+    size_t kept = 0;
+    size_t c = 0;
+    size_t b = 0;
+
+    while (c < count && b < block_count) {
+        size_t low = b;
+        size_t high = block_count;
+        size_t size;
+        size_t end;
+
+        // Last block starting at or before the candidate
+        while (high - low > 1) {
+            size_t middle = low + (high - low) / 2;
+            if (skips[middle].first <= candidates[c]) {
+                low = middle;
+            }
+            else {
+                high = middle;
+            }
+        }
+        b = low;
+
+        // Candidates up to the start of the next block
+        end = c + 1;
+        if (b + 1 < block_count) {
+            while (end < count && candidates[end] < skips[b + 1].first) {
+                end++;
+            }
+        }
+        else {
+            end = count;
+        }
+
+        size = decode_block(index, info, b, block);
+        if ((end - c) * 8 < size) {
+            // A few candidates: searched for, not merged with the block
+            size_t from = 0;
+
+            for (; c < end; c++) {
+                size_t step = size - from;
+
+                while (step > 1) {
+                    size_t half = step / 2;
+                    from = block[from + half] <= candidates[c] ? from + half : from;
+                    step -= half;
+                }
+                if (block[from] == candidates[c]) {
+                    candidates[kept++] = candidates[c];
+                }
+            }
+        }
+        else {
+            kept += x86_postings_intersect(candidates + c, end - c, block, size, candidates + kept);
+        }
+        c = end;
+        b++;
+    }
+
+    return kept;
+}
+
+static int compare_infos(const void* a, const void* b) {
+    uint32_t x = (*(const IndexTermInfo* const*)a)->count;
+    uint32_t y = (*(const IndexTermInfo* const*)b)->count;
+    return x < y ? -1 : x > y;
+}
+
+int x86_index_and(const InstructionIndex* index, const IndexTerm* terms, size_t term_count, uint32_t* out,
+    size_t max_count, size_t* match_count) {
+    const IndexTermInfo** infos;
+    uint32_t* candidates;
+    size_t count = 0;
+
+    *match_count = 0;
+    if (term_count == 0) {
+        return 1;
+    }
+
+    infos = (const IndexTermInfo**)malloc(term_count * sizeof(IndexTermInfo*));
+    if (!infos) {
+        return 0;
+    }
+    for (size_t t = 0; t < term_count; t++) {
+        infos[t] = lookup_term(index, terms[t]);
+        if (!infos[t]) {
+            free(infos);
+            return 1;
+        }
+    }
+
+    // Rarest list first: it bounds the result, the others are only probed
+    qsort(infos, term_count, sizeof(IndexTermInfo*), compare_infos);
+    candidates = max_count >= infos[0]->count ? out : (uint32_t*)malloc(infos[0]->count * sizeof(uint32_t));
+    if (!candidates) {
+        free(infos);
+        return 0;
+    }
+
+    count = decode_list(index, infos[0], candidates);
+    for (size_t t = 1; t < term_count && count; t++) {
+        count = intersect_list(index, infos[t], candidates, count);
+    }
+
+    if (candidates != out) {
+        memcpy(out, candidates, (count < max_count ? count : max_count) * sizeof(uint32_t));
+        free(candidates);
+    }
+    *match_count = count;
+    free(infos);
+    return 1;
+}
+
+int x86_index_or(const InstructionIndex* index, const IndexTerm* terms, size_t term_count, uint32_t* out,
+    size_t max_count, size_t* match_count) {
+    const IndexTermInfo** infos;
+    uint32_t* merged;
+    uint32_t* list;
+    uint32_t* scratch;
+    size_t total = 0;
+    size_t largest = 0;
+    size_t count = 0;
+    int status = 0;
+
+    *match_count = 0;
+    infos = (const IndexTermInfo**)malloc((term_count ? term_count : 1) * sizeof(IndexTermInfo*));
+    if (!infos) {
+        return 0;
+    }
+    for (size_t t = 0; t < term_count; t++) {
+        infos[t] = lookup_term(index, terms[t]);
+        if (infos[t]) {
+            total += infos[t]->count;
+            largest = infos[t]->count > largest ? infos[t]->count : largest;
+        }
+    }
+
+    merged = (uint32_t*)malloc((total ? total : 1) * sizeof(uint32_t));
+    scratch = (uint32_t*)malloc((total ? total : 1) * sizeof(uint32_t));
+    list = (uint32_t*)malloc((largest ? largest : 1) * sizeof(uint32_t));
+    if (merged && scratch && list) {
+        for (size_t t = 0; t < term_count; t++) {
+            if (infos[t]) {
+                size_t size = decode_list(index, infos[t], list);
+                uint32_t* swap = merged;
+
+                count = x86_postings_union(merged, count, list, size, scratch);
+                merged = scratch;
+                scratch = swap;
+            }
+        }
+        memcpy(out, merged, (count < max_count ? count : max_count) * sizeof(uint32_t));
+        *match_count = count;
+        status = 1;
+    }
+
+    free(merged);
+    free(scratch);
+    free(list);
+    free(infos);
+    return status;
+}
@@ -0,0 +1,383 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include "disassm.h"
+
+/*
+ * Decoded listing
+ *
+ * The records of a linear sweep, split by address into chunks of
+ * LISTING_CHUNK code bytes, each with its own array. A patch re-decodes
+ * from the start of the instruction holding its first byte until the new
+ * stream lands on an old instruction start past its last byte: from there
+ * on the bytes, and therefore the instructions, are the old ones. Only the
+ * chunks the re-decoded span touches are rewritten, so the cost of a patch
+ * does not grow with the size of the code.
+ */
+#define LISTING_CHUNK           (4 * 1024)
+#define LISTING_WINDOW          (256 * 1024)        // Bytes swept per window and thread
+#define LISTING_WINDOW_RECORDS  (LISTING_WINDOW / 2)
+#define LISTING_BATCH           256                 // Records re-decoded per batch
+
+static inline size_t chunk_of(const DecodedListing* listing, uint64_t address) {
+    return (size_t)((address - listing->address) / LISTING_CHUNK);
+}
+
+// First record of a chunk at or after address
+static size_t chunk_lower_bound(const ListingChunk* chunk, uint64_t address) {
+    size_t low = 0;
+    size_t high = chunk->count;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (chunk->insns[middle].address < address) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+// Replaces records [from, to) of a chunk with count new ones
+static int chunk_replace(ListingChunk* chunk, size_t from, size_t to, const DecodedInstruction* insns, size_t count) {
+    size_t total = chunk->count - (to - from) + count;
+
+    if (total > chunk->capacity) {
+        size_t capacity = total + total / 8 + 16;
+        DecodedInstruction* grown = (DecodedInstruction*)realloc(chunk->insns, capacity * sizeof(DecodedInstruction));
+        if (!grown) {
+            return 0;
+        }
+        chunk->insns = grown;
+        chunk->capacity = capacity;
+    }
+
+    // An empty chunk may have no array yet, and insns may be NULL when count is 0
+    if (to < chunk->count && from + count != to) {
+        memmove(chunk->insns + from + count, chunk->insns + to, (chunk->count - to) * sizeof(DecodedInstruction));
+    }
+    if (count) {
+        memcpy(chunk->insns + from, insns, count * sizeof(DecodedInstruction));
+    }
+    chunk->count = total;
+    return 1;
+}
+
+// Appends records in address order, each to its chunk
+static int listing_append(DecodedListing* listing, const DecodedInstruction* insns, size_t count) {
+    size_t i = 0;
+
+    while (i < count) {
+        size_t c = chunk_of(listing, insns[i].address);
+        uint64_t end = listing->address + (uint64_t)(c + 1) * LISTING_CHUNK;
+        size_t run = i + 1;
+
+        while (run < count && insns[run].address < end) {
+            run++;
+        }
+        if (!chunk_replace(&listing->chunks[c], listing->chunks[c].count, listing->chunks[c].count,
+            insns + i, run - i)) {
+            return 0;
+        }
+        i = run;
+    }
+
+    listing->instruction_count += count;
+    return 1;
+}
+
+int x86_listing_build(DecodedListing* listing, DisasmMode mode, const void* code, size_t length, uint64_t address,
+    unsigned int threads) {
+    DecodedInstruction* records;
+    size_t window;
+    size_t offset = 0;
+    int status = 1;
+
+    memset(listing, 0, sizeof(*listing));
+    listing->mode = mode;
+    listing->code = (const uint8_t*)code;
+    listing->length = length;
+    listing->address = address;
+    listing->chunk_count = (length + LISTING_CHUNK - 1) / LISTING_CHUNK;
+    listing->chunks = (ListingChunk*)calloc(listing->chunk_count ? listing->chunk_count : 1, sizeof(ListingChunk));
+    if (!listing->chunks) {
+        return 0;
+    }
+
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    window = (size_t)threads * LISTING_WINDOW;
+    records = (DecodedInstruction*)malloc((size_t)threads * LISTING_WINDOW_RECORDS * sizeof(DecodedInstruction));
+    if (!records) {
+        x86_listing_free(listing);
+        return 0;
+    }
+
+    while (offset < length) {
+        DisasmBatchResult result;
+        size_t size = length - offset < window ? length - offset : window;
+        size_t count = x86_sweep_parallel(mode, listing->code + offset, size, address + offset,
+            records, (size_t)threads * LISTING_WINDOW_RECORDS, threads, &result);
+
+        if (!listing_append(listing, records, count)) {
+            status = 0;
+            break;
+        }
+        offset += result.offset;
+        if (result.reason == DISASM_STOP_TRUNCATED && size == length - (offset - result.offset)) {
+            break;
+        }
+        if (result.offset == 0) {
+            break;
+        }
+    }
+    listing->end = offset;
+
+    free(records);
+    return status;
+}
+
+void x86_listing_free(DecodedListing* listing) {
+    for (size_t c = 0; c < listing->chunk_count; c++) {
+        free(listing->chunks[c].insns);
+    }
+    free(listing->chunks);
+    memset(listing, 0, sizeof(*listing));
+}
+
+const DecodedInstruction* x86_listing_find(const DecodedListing* listing, uint64_t address) {
+    size_t c;
+
+    if (address - listing->address >= listing->end) {
+        return NULL;
+    }
+
+    // The record holding address starts in its chunk or in an earlier one
+    for (c = chunk_of(listing, address); ; c--) {
+        const ListingChunk* chunk = &listing->chunks[c];
+        size_t index = chunk_lower_bound(chunk, address + 1);
+
+        if (index > 0) {
+            const DecodedInstruction* insn = &chunk->insns[index - 1];
+            return address < insn->address + insn->info.length ? insn : NULL;
+        }
+        if (c == 0) {
+            return NULL;
+        }
+    }
+}
+
+size_t x86_listing_copy(const DecodedListing* listing, uint64_t start, uint64_t end,
+    DecodedInstruction* out, size_t max_count) {
+    size_t count = 0;
+
+    if (start - listing->address >= listing->length || end <= start) {
+        return 0;
+    }
+    if (end - listing->address > listing->length) {
+        end = listing->address + listing->length;
+    }
+
+    for (size_t c = chunk_of(listing, start); c <= chunk_of(listing, end - 1) && count < max_count; c++) {
+        const ListingChunk* chunk = &listing->chunks[c];
+        size_t from = chunk_lower_bound(chunk, start);
+        size_t to = chunk_lower_bound(chunk, end);
+
+        if (to - from > max_count - count) {
+            to = from + (max_count - count);
+        }
+        if (to > from) {
+            memcpy(out + count, chunk->insns + from, (to - from) * sizeof(DecodedInstruction));
+            count += to - from;
+        }
+    }
+
+    return count;
+}
+
+// Is there an old record starting exactly at address
+static int is_old_start(const DecodedListing* listing, uint64_t address) {
+    const ListingChunk* chunk = &listing->chunks[chunk_of(listing, address)];
+    size_t index = chunk_lower_bound(chunk, address);
+
+    return index < chunk->count && chunk->insns[index].address == address;
+}
+
+static int compare_ranges(const void* a, const void* b) {
+    uint64_t x = ((const AddressRange*)a)->start;
+    uint64_t y = ((const AddressRange*)b)->start;
+    return x < y ? -1 : x > y;
+}
+
+int x86_listing_patch(DecodedListing* listing, const AddressRange* patches, size_t patch_count,
+    XrefIndex* xrefs, AddressRange* redecoded, size_t* redecoded_count) {
+    uint64_t limit = listing->address + listing->length;
+    AddressRange* sorted;
+    DecodedInstruction* added = NULL;
+    DecodedInstruction* removed = NULL;
+    size_t added_capacity = 0;
+    size_t removed_capacity = 0;
+    size_t spans = 0;
+    size_t p = 0;
+    int status = 0;
+
+    if (redecoded_count) {
+        *redecoded_count = 0;
+    }
+
+    sorted = (AddressRange*)malloc((patch_count ? patch_count : 1) * sizeof(AddressRange));
+    if (!sorted) {
+        return 0;
+    }
+    memcpy(sorted, patches, patch_count * sizeof(AddressRange));
+    qsort(sorted, patch_count, sizeof(AddressRange), compare_ranges);
+
+    while (p < patch_count) {
+        uint64_t old_end = listing->address + listing->end;
+        uint64_t start = sorted[p].start < listing->address ? listing->address : sorted[p].start;
+        uint64_t changed = sorted[p].end;
+        uint64_t offset;
+        uint64_t stop;
+        uint64_t span_end;
+        size_t added_count = 0;
+        size_t removed_count = 0;
+        int truncated = 0;
+
+        p++;
+        if (changed <= start || start >= limit) {
+            continue;
+        }
+
+        // Back up to the instruction holding the first changed byte, or
+        // to where the sweep stopped
+        if (start >= old_end) {
+            start = old_end;
+        }
+        else {
+            start = x86_listing_find(listing, start)->address;
+        }
+
+        // Re-decode until an instruction starts on an old instruction
+        // start with every changed byte before it, or the sweep ends
+        offset = start;
+        for (;;) {
+            DisasmBatchResult result;
+            size_t count;
+            size_t i;
+
+            if (added_count + LISTING_BATCH > added_capacity) {
+                size_t capacity = added_capacity ? added_capacity * 2 : LISTING_BATCH * 4;
+                DecodedInstruction* grown = (DecodedInstruction*)realloc(added, capacity * sizeof(DecodedInstruction));
+                if (!grown) {
+                    goto done;
+                }
+                added = grown;
+                added_capacity = capacity;
+            }
+
+            count = x86_disasm_batch_mode(listing->mode, listing->code + (offset - listing->address),
+                (size_t)(limit - offset), offset, added + added_count, LISTING_BATCH, &result);
+
+            for (i = 0; i < count; i++) {
+                const DecodedInstruction* insn = &added[added_count + i];
+
+                if (insn->address >= changed && is_old_start(listing, insn->address)) {
+                    break;
+                }
+
+                // Later patches overlapping this instruction extend the span
+                while (p < patch_count && sorted[p].start < insn->address + insn->info.length) {
+                    changed = sorted[p].end > changed ? sorted[p].end : changed;
+                    p++;
+                }
+            }
+            added_count += i;
+
+            if (i < count) {
+                stop = added[added_count].address;
+                break;
+            }
+            offset = result.address;
+            if (result.reason != DISASM_STOP_FULL) {
+                stop = offset;
+                truncated = 1;
+                break;
+            }
+        }
+
+        // A new end of the sweep drops every old record after the span
+        span_end = truncated && old_end > stop ? old_end : stop;
+        while (p < patch_count && sorted[p].start < span_end) {
+            p++;
+        }
+        if (span_end == start) {
+            continue;
+        }
+
+        // Old records of the span, for the cross-references
+        for (size_t c = chunk_of(listing, start); c <= chunk_of(listing, span_end - 1); c++) {
+            const ListingChunk* chunk = &listing->chunks[c];
+            removed_count += chunk_lower_bound(chunk, span_end) - chunk_lower_bound(chunk, start);
+        }
+        if (xrefs) {
+            if (removed_count > removed_capacity) {
+                DecodedInstruction* grown = (DecodedInstruction*)realloc(removed,
+                    removed_count * sizeof(DecodedInstruction));
+                if (!grown) {
+                    goto done;
+                }
+                removed = grown;
+                removed_capacity = removed_count;
+            }
+            x86_listing_copy(listing, start, span_end, removed, removed_count);
+        }
+
+        // Splice the new records into the chunks of the span
+        for (size_t c = chunk_of(listing, start), n = 0; c <= chunk_of(listing, span_end - 1); c++) {
+            ListingChunk* chunk = &listing->chunks[c];
+            uint64_t chunk_end = listing->address + (uint64_t)(c + 1) * LISTING_CHUNK;
+            size_t first = n;
+
+            while (n < added_count && added[n].address < chunk_end) {
+                n++;
+            }
+            if (!chunk_replace(chunk, chunk_lower_bound(chunk, start), chunk_lower_bound(chunk, span_end),
+                added + first, n - first)) {
+                goto done;
+            }
+        }
+        listing->instruction_count = listing->instruction_count - removed_count + added_count;
+        if (truncated) {
+            listing->end = (size_t)(stop - listing->address);
+        }
+
+        if (xrefs && !x86_xref_replace(xrefs, removed, removed_count, added, added_count)) {
+            goto done;
+        }
+
+        if (redecoded) {
+            redecoded[spans].start = start;
+            redecoded[spans].end = span_end;
+        }
+        spans++;
+    }
+    status = 1;
+
+done:
+    if (redecoded_count) {
+        *redecoded_count = spans;
+    }
+    free(sorted);
+    free(added);
+    free(removed);
+    return status;
+}
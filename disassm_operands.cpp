@@ -0,0 +1,497 @@
+#include <stdint.h>
+#include <string.h>
+#include "disassm.h"
+#include "disassm_inst_bytes.h"
+#include "disassm_table_format.h"
+#include "disassm_table_access.h"
+
+/*
+ * Operand decoder state for one instruction
+ *
+ * The same derived sizes the formatter uses, so the operand model and the
+ * text always agree.
+ */
+typedef struct {
+    const InstructionInfo* info;
+    unsigned int mode64;        // 64-bit mode
+    unsigned int vector;        // VEX/EVEX encoded
+    unsigned int evex;          // EVEX encoded
+    unsigned int opcode;        // Opcode byte within the map
+    unsigned int operand_size;  // General purpose operand size in bytes
+    unsigned int address_size;  // Address size in bytes
+    unsigned int vector_size;   // Vector register size in bytes
+    unsigned int nondestructive;// A VEX.vvvv source operand is present
+} OperandState;
+
+// RegisterClass of a FormatRegisterClass (memory operand base and index)
+static const uint8_t g_register_class_of_format[FREG_CLASS_COUNT] = {
+    REGCLASS_GPR8, REGCLASS_GPR8, REGCLASS_GPR16, REGCLASS_GPR32, REGCLASS_GPR64,
+    REGCLASS_SEGMENT, REGCLASS_CONTROL, REGCLASS_DEBUG, REGCLASS_MMX,
+    REGCLASS_XMM, REGCLASS_YMM, REGCLASS_ZMM, REGCLASS_OPMASK, REGCLASS_X87
+};
+
+/*
+ * Operand builders
+ */
+static inline unsigned int set_register(InstructionOperand* op, unsigned int reg_class, unsigned int index, unsigned int size) {
+    op->type = OPERAND_REGISTER;
+    op->size = (uint16_t)size;
+    op->reg.reg_class = (uint8_t)reg_class;
+    op->reg.index = (uint8_t)index;
+    return 1;
+}
+
+static inline unsigned int set_gpr(const OperandState* s, InstructionOperand* op, unsigned int size, unsigned int index) {
+    static const uint8_t classes[9] = { 0, REGCLASS_GPR8, REGCLASS_GPR16, 0, REGCLASS_GPR32, 0, 0, 0, REGCLASS_GPR64 };
+
+    // Without REX, byte registers 4-7 are AH, CH, DH and BH
+    if (size == 1 && !s->info->rex && index >= 4 && index < 8) {
+        return set_register(op, REGCLASS_GPR8_HIGH, index, 1);
+    }
+    return set_register(op, classes[size], index, size);
+}
+
+static inline unsigned int set_vector_register(InstructionOperand* op, unsigned int size, unsigned int index) {
+    return set_register(op, REGCLASS_XMM + (size >> 5), index, size);
+}
+
+static inline unsigned int set_immediate(InstructionOperand* op, uint64_t value, unsigned int size) {
+    op->type = OPERAND_IMMEDIATE;
+    op->size = (uint16_t)size;
+    op->imm = value;
+    return 1;
+}
+
+/*
+ * Function to fill a memory operand
+ *
+ * size is the access size (0 = no access). An EVEX broadcast reads one
+ * element instead.
+ */
+static unsigned int set_memory(const OperandState* s, InstructionOperand* op, unsigned int size, int vsib_class = -1) {
+    const InstructionInfo* info = s->info;
+    MemoryOperand m;
+
+    decode_memory_operand(info, s->address_size, s->mode64, &m, vsib_class);
+
+    op->type = OPERAND_MEMORY;
+    op->size = (uint16_t)size;
+    op->scale = (uint8_t)m.scale;
+    op->disp = m.disp;
+
+    if (m.rip) {
+        op->base.reg_class = REGCLASS_IP;
+        op->base.index = 0;
+    }
+    else if (m.base >= 0) {
+        op->base.reg_class = g_register_class_of_format[m.base_class];
+        op->base.index = (uint8_t)m.base;
+    }
+    if (m.index >= 0) {
+        op->index.reg_class = g_register_class_of_format[m.index_class];
+        op->index.index = (uint8_t)m.index;
+    }
+
+    // Addressing through rSP/rBP defaults to SS, everything else to DS
+    op->segment.reg_class = REGCLASS_SEGMENT;
+    if (m.segment >= 0) {
+        op->segment.index = (uint8_t)m.segment;
+    }
+    else if (op->base.reg_class != REGCLASS_IP && m.base >= 0 && ((m.base & 7) == REG_SP || (m.base & 7) == REG_BP)) {
+        op->segment.index = REG_SS;
+    }
+    else {
+        op->segment.index = REG_DS;
+    }
+
+    if (s->evex && info->evex_b && size >= 16) {
+        unsigned int element = info->rex_w ? 8 : 4;
+        op->broadcast = (uint8_t)(size / element);
+        op->size = (uint16_t)element;
+    }
+    return 1;
+}
+
+// String operand at seg:rSI or ES:rDI
+static unsigned int set_string(const OperandState* s, InstructionOperand* op, unsigned int size, unsigned int destination) {
+    static const uint8_t classes[9] = { 0, 0, REGCLASS_GPR16, 0, REGCLASS_GPR32, 0, 0, 0, REGCLASS_GPR64 };
+    int segment = destination ? REG_ES : segment_override(s->info);
+
+    op->type = OPERAND_MEMORY;
+    op->size = (uint16_t)size;
+    op->segment.reg_class = REGCLASS_SEGMENT;
+    op->segment.index = (uint8_t)(segment >= 0 ? segment : REG_DS);
+    op->base.reg_class = classes[s->address_size];
+    op->base.index = destination ? REG_DI : REG_SI;
+    op->scale = 1;
+    return 1;
+}
+
+static inline unsigned int set_rm(const OperandState* s, InstructionOperand* op, unsigned int register_size, unsigned int memory_size) {
+    if (s->info->modrm_mod == MODRM_MOD_REGISTER) {
+        return set_gpr(s, op, register_size, s->info->modrm_rm);
+    }
+    return set_memory(s, op, memory_size);
+}
+
+static inline unsigned int set_vector_rm(const OperandState* s, InstructionOperand* op, unsigned int size) {
+    if (s->info->modrm_mod == MODRM_MOD_REGISTER) {
+        return set_vector_register(op, size < 16 ? 16 : size, s->info->modrm_rm);
+    }
+    return set_memory(s, op, size);
+}
+
+/*
+ * Function to decode one operand
+ *
+ * Mirrors emit_operand in disassm_format.cpp. Returns 0 for operands that
+ * are not present in this encoding.
+ */
+static unsigned int decode_operand(OperandState* s, InstructionOperand* op, unsigned int operand) {
+    const InstructionInfo* info = s->info;
+    unsigned int y_size = s->operand_size == 8 ? 8 : 4;
+    unsigned int mm = !s->vector && !info->prefix_66;
+
+    switch (operand) {
+    case OPND_Eb: return set_rm(s, op, 1, 1);
+    case OPND_Ew: return set_rm(s, op, 2, 2);
+    case OPND_Ed: return set_rm(s, op, 4, 4);
+    case OPND_Ev: return set_rm(s, op, s->operand_size, s->operand_size);
+    case OPND_Ey: return set_rm(s, op, y_size, y_size);
+    case OPND_Edb: return set_rm(s, op, 4, 1);
+    case OPND_Edw: return set_rm(s, op, 4, 2);
+    case OPND_Gb: return set_gpr(s, op, 1, info->modrm_reg);
+    case OPND_Gw: return set_gpr(s, op, 2, info->modrm_reg);
+    case OPND_Gd: return set_gpr(s, op, 4, info->modrm_reg);
+    case OPND_Gv: return set_gpr(s, op, s->operand_size, info->modrm_reg);
+    case OPND_Gy: return set_gpr(s, op, y_size, info->modrm_reg);
+    case OPND_Gq64: return set_gpr(s, op, s->mode64 ? 8 : 4, info->modrm_reg);
+    case OPND_Rd: return set_gpr(s, op, 4, info->modrm_rm);
+    case OPND_Rv: return set_gpr(s, op, s->operand_size, info->modrm_rm);
+    case OPND_Ry: return set_gpr(s, op, y_size, info->modrm_rm);
+    case OPND_Rq64: return set_gpr(s, op, s->mode64 ? 8 : 4, info->modrm_rm);
+    case OPND_By:
+        s->nondestructive = 1;
+        return set_gpr(s, op, y_size, info->vex_vvvv);
+
+    case OPND_M: return set_memory(s, op, 0);
+    case OPND_Mb: return set_memory(s, op, 1);
+    case OPND_Mw: return set_memory(s, op, 2);
+    case OPND_Md: return set_memory(s, op, 4);
+    case OPND_Mdq: return set_memory(s, op, 16);
+    case OPND_Mp: return set_memory(s, op, s->operand_size + 2);
+    case OPND_Mq: return set_memory(s, op, 8);
+    case OPND_Mv: return set_memory(s, op, s->operand_size);
+    case OPND_Mx: return set_memory(s, op, s->vector_size);
+    case OPND_My: return set_memory(s, op, y_size);
+
+    case OPND_Mfs: return set_memory(s, op, 4);
+    case OPND_Mfd: return set_memory(s, op, 8);
+    case OPND_Mft: return set_memory(s, op, 10);
+    case OPND_Miw: return set_memory(s, op, 2);
+    case OPND_Mid: return set_memory(s, op, 4);
+    case OPND_Miq: return set_memory(s, op, 8);
+    case OPND_Mbcd: return set_memory(s, op, 10);
+
+    case OPND_Ib: return set_immediate(op, info->immediate.imm8, 1);
+    case OPND_Ibs: return set_immediate(op, sized_immediate(info->immediate.imm8, 8, s->operand_size), s->operand_size);
+    case OPND_Ib2: return set_immediate(op, (info->immediate.imm64 >> 16) & 0xFF, 1);
+    case OPND_Iw: return set_immediate(op, info->immediate.imm16, 2);
+    case OPND_Iz:
+    case OPND_Iv:
+        if (HAS_FLAG(info->flags, FLAG_IMM64)) {
+            return set_immediate(op, info->immediate.imm64, 8);
+        }
+        if (HAS_FLAG(info->flags, FLAG_IMM32)) {
+            return set_immediate(op, sized_immediate(info->immediate.imm32, 32, s->operand_size), s->operand_size);
+        }
+        return set_immediate(op, info->immediate.imm16, 2);
+    case OPND_1: return set_immediate(op, 1, 1);
+
+    case OPND_Jb:
+    case OPND_Jz:
+        op->type = OPERAND_RELATIVE;
+        if (HAS_FLAG(info->flags, FLAG_IMM8)) {
+            op->size = 1;
+            op->imm = (uint64_t)(int64_t)(int8_t)info->immediate.imm8;
+        }
+        else if (HAS_FLAG(info->flags, FLAG_IMM16)) {
+            op->size = 2;
+            op->imm = (uint64_t)(int64_t)(int16_t)info->immediate.imm16;
+        }
+        else {
+            op->size = 4;
+            op->imm = (uint64_t)(int64_t)(int32_t)info->immediate.imm32;
+        }
+        return 1;
+
+    case OPND_Ap: {
+        unsigned int offset_size = HAS_FLAG(info->flags, FLAG_IMM16) ? 2 : 4;
+        op->type = OPERAND_FAR_POINTER;
+        op->size = (uint16_t)(offset_size + 2);
+        op->imm = info->immediate.imm64 & (offset_size == 2 ? 0xFFFF : 0xFFFFFFFF);
+        op->selector = (uint16_t)(info->immediate.imm64 >> (offset_size * 8));
+        return 1;
+    }
+
+    case OPND_Ob:
+    case OPND_Ov: {
+        int segment = segment_override(info);
+        op->type = OPERAND_MEMORY;
+        op->size = (uint16_t)(operand == OPND_Ob ? 1 : s->operand_size);
+        op->segment.reg_class = REGCLASS_SEGMENT;
+        op->segment.index = (uint8_t)(segment >= 0 ? segment : REG_DS);
+        op->scale = 1;
+        op->disp = (int64_t)(HAS_FLAG(info->flags, FLAG_IMM64) ? info->immediate.imm64 :
+            HAS_FLAG(info->flags, FLAG_IMM32) ? info->immediate.imm32 : info->immediate.imm16);
+        return 1;
+    }
+
+    case OPND_Zb: return set_gpr(s, op, 1, (s->opcode & 7) | (info->rex_b << 3));
+    case OPND_Zv: return set_gpr(s, op, s->operand_size, (s->opcode & 7) | (info->rex_b << 3));
+    case OPND_Zy: return set_gpr(s, op, y_size, (s->opcode & 7) | (info->rex_b << 3));
+
+    case OPND_AL: return set_register(op, REGCLASS_GPR8, REG_AL, 1);
+    case OPND_CL: return set_register(op, REGCLASS_GPR8, REG_CL, 1);
+    case OPND_AX: return set_register(op, REGCLASS_GPR16, REG_AX, 2);
+    case OPND_DX: return set_register(op, REGCLASS_GPR16, REG_DX, 2);
+    case OPND_eAX: return set_gpr(s, op, s->operand_size == 2 ? 2 : 4, REG_EAX);
+    case OPND_rAX: return set_gpr(s, op, s->operand_size, REG_RAX);
+    case OPND_ES:
+    case OPND_CS:
+    case OPND_SS:
+    case OPND_DS:
+    case OPND_FS:
+    case OPND_GS:
+        return set_register(op, REGCLASS_SEGMENT, operand - OPND_ES, 2);
+    case OPND_ST0: return set_register(op, REGCLASS_X87, 0, 10);
+    case OPND_STi: return set_register(op, REGCLASS_X87, info->modrm & 7, 10);
+
+    case OPND_Sw: return set_register(op, REGCLASS_SEGMENT, info->modrm_reg & 7, 2);
+    case OPND_Cd: return set_register(op, REGCLASS_CONTROL, info->modrm_reg & 0x0F, s->mode64 ? 8 : 4);
+    case OPND_Dd: return set_register(op, REGCLASS_DEBUG, info->modrm_reg & 0x0F, s->mode64 ? 8 : 4);
+
+    case OPND_Xb: return set_string(s, op, 1, 0);
+    case OPND_Xv: return set_string(s, op, s->operand_size, 0);
+    case OPND_Xz: return set_string(s, op, s->operand_size == 2 ? 2 : 4, 0);
+    case OPND_Yb: return set_string(s, op, 1, 1);
+    case OPND_Yv: return set_string(s, op, s->operand_size, 1);
+    case OPND_Yz: return set_string(s, op, s->operand_size == 2 ? 2 : 4, 1);
+
+    case OPND_Pq: return set_register(op, REGCLASS_MMX, info->modrm_reg & 7, 8);
+    case OPND_Qq:
+    case OPND_Nq:
+        if (info->modrm_mod == MODRM_MOD_REGISTER) {
+            return set_register(op, REGCLASS_MMX, info->modrm_rm & 7, 8);
+        }
+        return set_memory(s, op, 8);
+
+    case OPND_PK:
+        if (s->evex) {
+            return set_register(op, REGCLASS_OPMASK, info->modrm_reg & 7, 8);
+        }
+        // Fall through
+    case OPND_Pxm:
+        if (mm) {
+            return set_register(op, REGCLASS_MMX, info->modrm_reg & 7, 8);
+        }
+        return set_vector_register(op, s->vector_size, info->modrm_reg);
+    case OPND_Qxm:
+    case OPND_Nxm:
+        if (mm) {
+            if (info->modrm_mod == MODRM_MOD_REGISTER) {
+                return set_register(op, REGCLASS_MMX, info->modrm_rm & 7, 8);
+            }
+            return set_memory(s, op, 8);
+        }
+        return set_vector_rm(s, op, s->vector_size);
+
+    case OPND_VK:
+        if (s->evex) {
+            return set_register(op, REGCLASS_OPMASK, info->modrm_reg & 7, 8);
+        }
+        // Fall through
+    case OPND_Vx: return set_vector_register(op, s->vector_size, info->modrm_reg);
+    case OPND_Vdq: return set_vector_register(op, 16, info->modrm_reg);
+    case OPND_Vh: return set_vector_register(op, s->vector_size > 16 ? s->vector_size / 2 : 16, info->modrm_reg);
+    case OPND_Wx:
+    case OPND_Ux: return set_vector_rm(s, op, s->vector_size);
+    case OPND_Wdq:
+    case OPND_Udq: return set_vector_rm(s, op, 16);
+    case OPND_Wh: return set_vector_rm(s, op, s->vector_size / 2);
+    case OPND_Wqt: return set_vector_rm(s, op, s->vector_size / 4);
+    case OPND_Wo: return set_vector_rm(s, op, s->vector_size / 8);
+    case OPND_Wq: return set_vector_rm(s, op, 8);
+    case OPND_Wd: return set_vector_rm(s, op, 4);
+    case OPND_Ww: return set_vector_rm(s, op, 2);
+    case OPND_Wb: return set_vector_rm(s, op, 1);
+    case OPND_Wsx: return set_vector_rm(s, op, info->rex_w ? 8 : 4);
+
+    case OPND_Hx:
+    case OPND_Hdq:
+    case OPND_Hr:
+        if (!s->vector || (operand == OPND_Hr && info->modrm_mod != MODRM_MOD_REGISTER)) {
+            return 0;
+        }
+        s->nondestructive = 1;
+        return set_vector_register(op, operand == OPND_Hx ? s->vector_size : 16, info->vex_vvvv);
+    case OPND_Lx:
+        return set_vector_register(op, s->vector_size, (info->immediate.imm8 >> 4) & (s->mode64 ? 0x0F : 0x07));
+    case OPND_XMM0:
+        return set_vector_register(op, 16, 0);
+
+    case OPND_KG: return set_register(op, REGCLASS_OPMASK, info->modrm_reg & 7, opmask_size(info));
+    case OPND_KE:
+        if (info->modrm_mod == MODRM_MOD_REGISTER) {
+            return set_register(op, REGCLASS_OPMASK, info->modrm_rm & 7, opmask_size(info));
+        }
+        return set_memory(s, op, opmask_size(info));
+    case OPND_KH:
+        s->nondestructive = 1;
+        return set_register(op, REGCLASS_OPMASK, info->vex_vvvv & 7, opmask_size(info));
+
+    case OPND_MVsib: {
+        // Dword indices cover half the vector length when the elements are qwords
+        unsigned int index_size = s->vector_size;
+        if ((s->opcode & 1) == 0 && info->rex_w && index_size > 16) {
+            index_size /= 2;
+        }
+        return set_memory(s, op, info->rex_w ? 8 : 4, FREG_XMM + (index_size >> 5));
+    }
+
+    default:
+        return 0;
+    }
+}
+
+/*
+ * Function to assign operand access from the mnemonic
+ */
+static void assign_access(const OperandState* s, const FormatEntry* entry, InstructionOperand* operands, unsigned int count) {
+    unsigned int first = ACCESS_RW;
+    unsigned int rest = ACCESS_R;
+    unsigned int matched = 0;
+
+    unsigned int letter = (unsigned int)(entry->mnemonic[0] - 'a');
+    unsigned int begin = letter < 26 ? g_access_rule_index.start[letter] : 0;
+    unsigned int end = letter < 26 ? g_access_rule_index.start[letter + 1] : 0;
+
+    for (unsigned int i = begin; i < end; i++) {
+        const AccessRule* rule = &g_access_rules[g_access_rule_index.order[i]];
+
+        if (entry->length < rule->length || memcmp(entry->mnemonic, rule->mnemonic, rule->length) != 0) {
+            continue;
+        }
+        if (rule->match == ACCESS_MATCH_EXACT && entry->length != rule->length) {
+            continue;
+        }
+        if (rule->match == ACCESS_MATCH_LEGACY && (entry->flags & FMT_SSE)) {
+            continue;
+        }
+        first = rule->first;
+        rest = rule->rest;
+        matched = 1;
+        break;
+    }
+
+    if (!matched) {
+        if (entry->length == 4 && memcmp(entry->mnemonic, "imul", 4) == 0) {
+            // IMUL r/m reads; IMUL r, r/m accumulates; IMUL r, r/m, imm overwrites
+            first = count == 1 ? ACCESS_R : count == 3 ? ACCESS_W : ACCESS_RW;
+        }
+        else if (s->nondestructive) {
+            // VEX/EVEX three-operand forms overwrite the destination
+            first = ACCESS_W;
+        }
+    }
+
+    // EVEX merge-masking keeps the masked-off destination elements
+    if (s->evex && s->info->evex_aaa && !s->info->evex_z) {
+        first |= ACCESS_R;
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+        operands[i].access = (uint8_t)(i == 0 ? first : rest);
+    }
+}
+
+/*
+ * Function to decode the operands of an instruction
+ */
+template <DisasmMode Mode>
+static unsigned int decode_operands(const InstructionInfo* info, InstructionOperand* operands) {
+    OperandState s;
+    const FormatEntry* entry;
+    unsigned int count = 0;
+
+    if (HAS_ANY_FLAG(info->flags, FLAG_ERROR_OPCODE | FLAG_ERROR_LENGTH)) {
+        return 0;
+    }
+
+    entry = resolve_format_entry<Mode>(info, 0);
+    if (!entry) {
+        return 0;
+    }
+
+    s.info = info;
+    s.mode64 = Mode == DISASM_MODE_64;
+    s.vector = HAS_ANY_FLAG(info->flags, FLAG_VEX | FLAG_EVEX);
+    s.evex = HAS_FLAG(info->flags, FLAG_EVEX);
+    s.opcode = format_opcode(info);
+    s.operand_size = format_operand_size<Mode>(info, entry->flags);
+    s.address_size = format_address_size<Mode>(info);
+    s.vector_size = format_vector_size(info);
+    s.nondestructive = 0;
+
+    if (s.vector && !(entry->flags & (FMT_SSE | FMT_NO_V))) {
+        return 0;
+    }
+
+    for (unsigned int i = 0; i < 4 && entry->operands[i] != OPND_NONE; i++) {
+        memset(&operands[count], 0, sizeof(operands[count]));
+        count += decode_operand(&s, &operands[count], entry->operands[i]);
+    }
+
+    assign_access(&s, entry, operands, count);
+    return count;
+}
+
+unsigned int x86_decode_operands(DisasmMode mode, const InstructionInfo* info, InstructionOperand* operands) {
+    switch (mode) {
+    case DISASM_MODE_16:
+        return decode_operands<DISASM_MODE_16>(info, operands);
+
+    case DISASM_MODE_32:
+        return decode_operands<DISASM_MODE_32>(info, operands);
+
+    default:
+        return decode_operands<DISASM_MODE_64>(info, operands);
+    }
+}
+
+/*
+ * Lazy operand access
+ */
+void x86_operands_init(InstructionOperands* operands, DisasmMode mode, const InstructionInfo* info) {
+    operands->info = info;
+    operands->mode = (uint8_t)mode;
+    operands->decoded = 0;
+    operands->count = 0;
+}
+
+static inline void ensure_decoded(InstructionOperands* operands) {
+    if (!operands->decoded) {
+        operands->count = (uint8_t)x86_decode_operands((DisasmMode)operands->mode, operands->info, operands->operands);
+        operands->decoded = 1;
+    }
+}
+
+unsigned int x86_operand_count(InstructionOperands* operands) {
+    ensure_decoded(operands);
+    return operands->count;
+}
+
+const InstructionOperand* x86_operand(InstructionOperands* operands, unsigned int index) {
+    ensure_decoded(operands);
+    return index < operands->count ? &operands->operands[index] : NULL;
+}
@@ -0,0 +1,271 @@
+#include <stdint.h>
+#include <string.h>
+#include "disassm.h"
+#include "disassm_table_decode.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DISASM_SCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#define DISASM_TARGET_AVX2
+#else
+#define DISASM_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+/*
+ * Byte class bits used by the scalar table
+ */
+#define BYTE_CLASS_PREFIX       0x01
+#define BYTE_CLASS_REX          0x02
+#define BYTE_CLASS_ESCAPE       0x04
+#define BYTE_CLASS_MODRM        0x08
+#define BYTE_CLASS_OP_SIZE      0x10
+#define BYTE_CLASS_ADDR_SIZE    0x20
+
+/*
+ * Classifier tables, derived once from the decoder tables
+ *
+ * The nibble tables describe a 256-entry byte set for pshufb lookups:
+ * entry [lo] of set_lo has bit h set when byte (h << 4 | lo) is in the set
+ * for h = 0-7, set_hi the same for h = 8-15.
+ */
+typedef struct {
+    uint8_t byte_class[256];
+    uint8_t prefix_lo[16];
+    uint8_t prefix_hi[16];
+    uint8_t modrm_lo[16];
+    uint8_t modrm_hi[16];
+} ScanTables;
+
+static ScanTables build_scan_tables(void) {
+    ScanTables tables;
+    memset(&tables, 0, sizeof(tables));
+
+    for (unsigned int c = 0; c < 256; c++) {
+        uint8_t cls = 0;
+        uint8_t bit = (uint8_t)(1 << ((c >> 4) & 7));
+        unsigned int lo = c & 0x0F;
+
+        if (g_prefix_class_table[c] != 0) {
+            cls |= BYTE_CLASS_PREFIX;
+            if (c < 0x80) tables.prefix_lo[lo] |= bit; else tables.prefix_hi[lo] |= bit;
+        }
+        if (HAS_ATTR(g_opcode_table[c], OPATTR_MODRM) && g_opcode_table[c] != OPATTR_ERROR) {
+            cls |= BYTE_CLASS_MODRM;
+            if (c < 0x80) tables.modrm_lo[lo] |= bit; else tables.modrm_hi[lo] |= bit;
+        }
+        if ((c & 0xF0) == 0x40) cls |= BYTE_CLASS_REX;
+        if (c == 0x0F) cls |= BYTE_CLASS_ESCAPE;
+        if (c == 0x66) cls |= BYTE_CLASS_OP_SIZE;
+        if (c == 0x67) cls |= BYTE_CLASS_ADDR_SIZE;
+
+        tables.byte_class[c] = cls;
+    }
+
+    return tables;
+}
+
+static const ScanTables* scan_tables(void) {
+    static const ScanTables tables = build_scan_tables();
+    return &tables;
+}
+
+/*
+ * Scalar classifier
+ */
+static void classify_block_scalar(const uint8_t* code, size_t length, ByteClassBlock* block) {
+    const uint8_t* byte_class = scan_tables()->byte_class;
+    uint64_t masks[6] = { 0 };
+
+    for (size_t i = 0; i < length; i++) {
+        uint64_t bit = (uint64_t)1 << i;
+        uint8_t cls = byte_class[code[i]];
+
+        masks[0] |= (cls & BYTE_CLASS_PREFIX) ? bit : 0;
+        masks[1] |= (cls & BYTE_CLASS_REX) ? bit : 0;
+        masks[2] |= (cls & BYTE_CLASS_ESCAPE) ? bit : 0;
+        masks[3] |= (cls & BYTE_CLASS_MODRM) ? bit : 0;
+        masks[4] |= (cls & BYTE_CLASS_OP_SIZE) ? bit : 0;
+        masks[5] |= (cls & BYTE_CLASS_ADDR_SIZE) ? bit : 0;
+    }
+
+    block->prefix = masks[0];
+    block->rex = masks[1];
+    block->escape = masks[2];
+    block->modrm = masks[3];
+    block->op_size = masks[4];
+    block->addr_size = masks[5];
+}
+
+static size_t classify_scalar(const uint8_t* code, size_t length, ByteClassBlock* blocks) {
+    size_t count = 0;
+
+    for (size_t offset = 0; offset < length; offset += 64) {
+        size_t n = length - offset < 64 ? length - offset : 64;
+        classify_block_scalar(code + offset, n, &blocks[count++]);
+    }
+
+    return count;
+}
+
+#if DISASM_SCAN_X86
+
+/*
+ * AVX2 classifier
+ *
+ * Set membership for an arbitrary byte set takes two pshufb lookups on the
+ * low nibble (one per half of the high nibble range, selected by the sign
+ * bit), and a third pshufb turns the high nibble into the bit to test.
+ * Single-valued classes are plain compares.
+ */
+static DISASM_TARGET_AVX2 inline uint32_t classify_set_avx2(__m256i bytes, __m256i low_nibble,
+    __m256i high_bit, __m256i set_lo, __m256i set_hi) {
+    __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(set_lo, low_nibble),
+        _mm256_shuffle_epi8(set_hi, low_nibble), bytes);
+    __m256i hit = _mm256_cmpeq_epi8(_mm256_and_si256(row, high_bit), high_bit);
+    return (uint32_t)_mm256_movemask_epi8(hit);
+}
+
+static DISASM_TARGET_AVX2 void classify_32_avx2(const uint8_t* code, const ScanTables* tables,
+    uint32_t masks[6]) {
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+    const __m256i bit_table = _mm256_setr_epi8(
+        1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+        1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    const __m256i prefix_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)tables->prefix_lo));
+    const __m256i prefix_hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)tables->prefix_hi));
+    const __m256i modrm_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)tables->modrm_lo));
+    const __m256i modrm_hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)tables->modrm_hi));
+
+    __m256i bytes = _mm256_loadu_si256((const __m256i*)code);
+    __m256i low_nibble = _mm256_and_si256(bytes, nibble_mask);
+    __m256i high_nibble = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble_mask);
+    __m256i high_bit = _mm256_shuffle_epi8(bit_table, high_nibble);
+
+    masks[0] = classify_set_avx2(bytes, low_nibble, high_bit, prefix_lo, prefix_hi);
+    masks[1] = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high_nibble, _mm256_set1_epi8(0x04)));
+    masks[2] = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(0x0F)));
+    masks[3] = classify_set_avx2(bytes, low_nibble, high_bit, modrm_lo, modrm_hi);
+    masks[4] = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(0x66)));
+    masks[5] = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(0x67)));
+}
+
+static DISASM_TARGET_AVX2 size_t classify_avx2(const uint8_t* code, size_t length, ByteClassBlock* blocks) {
+    const ScanTables* tables = scan_tables();
+    size_t count = 0;
+    size_t offset = 0;
+
+    for (; length - offset >= 64; offset += 64) {
+        uint32_t lo[6];
+        uint32_t hi[6];
+        ByteClassBlock* block = &blocks[count++];
+
+        classify_32_avx2(code + offset, tables, lo);
+        classify_32_avx2(code + offset + 32, tables, hi);
+
+        block->prefix = lo[0] | (uint64_t)hi[0] << 32;
+        block->rex = lo[1] | (uint64_t)hi[1] << 32;
+        block->escape = lo[2] | (uint64_t)hi[2] << 32;
+        block->modrm = lo[3] | (uint64_t)hi[3] << 32;
+        block->op_size = lo[4] | (uint64_t)hi[4] << 32;
+        block->addr_size = lo[5] | (uint64_t)hi[5] << 32;
+    }
+
+    if (offset < length) {
+        classify_block_scalar(code + offset, length - offset, &blocks[count++]);
+    }
+
+    return count;
+}
+
+static int cpu_has_avx2(void) {
+#if defined(_MSC_VER)
+    int regs[4];
+
+    __cpuid(regs, 0);
+    if (regs[0] < 7) {
+        return 0;
+    }
+
+    // AVX and OSXSAVE, then YMM state enabled by the OS
+    __cpuid(regs, 1);
+    if ((regs[2] & 0x18000000) != 0x18000000 || (_xgetbv(0) & 6) != 6) {
+        return 0;
+    }
+
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & 0x20) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    unsigned int xcr0_lo, xcr0_hi;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || (ecx & 0x18000000) != 0x18000000) {
+        return 0;
+    }
+
+    __asm__ volatile ("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    if ((xcr0_lo & 6) != 6) {
+        return 0;
+    }
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    return (ebx & 0x20) != 0;
+#endif
+}
+
+#endif
+
+/*
+ * Runtime dispatch
+ */
+typedef size_t(*ClassifyFunction)(const uint8_t* code, size_t length, ByteClassBlock* blocks);
+
+static DisasmScanLevel detect_scan_level(void) {
+#if DISASM_SCAN_X86
+    if (cpu_has_avx2()) {
+        return DISASM_SCAN_AVX2;
+    }
+#endif
+    return DISASM_SCAN_SCALAR;
+}
+
+static DisasmScanLevel supported_scan_level(void) {
+    static const DisasmScanLevel level = detect_scan_level();
+    return level;
+}
+
+static DisasmScanLevel g_scan_level = supported_scan_level();
+
+static ClassifyFunction classify_function(DisasmScanLevel level) {
+#if DISASM_SCAN_X86
+    if (level == DISASM_SCAN_AVX2) {
+        return classify_avx2;
+    }
+#endif
+    return classify_scalar;
+}
+
+DisasmScanLevel x86_scan_level(void) {
+    return g_scan_level;
+}
+
+DisasmScanLevel x86_scan_set_level(DisasmScanLevel level) {
+    g_scan_level = level < supported_scan_level() ? level : supported_scan_level();
+    return g_scan_level;
+}
+
+/*
+ * Byte classifier function
+ */
+size_t x86_classify_bytes(const void* code, size_t length, ByteClassBlock* blocks) {
+    return classify_function(g_scan_level)((const uint8_t*)code, length, blocks);
+}
@@ -0,0 +1,530 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "disassm.h"
+#include "disassm_bitmap.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DISASM_SIGNATURE_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#define DISASM_TARGET_AVX2
+#else
+#define DISASM_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+/*
+ * Signature scanning
+ *
+ * Every pattern has an anchor: SIGNATURE_ANCHOR consecutive bytes of it,
+ * chosen to be as fixed and as rare as possible. The patterns are spread
+ * over SIGNATURE_BUCKETS buckets, and for each anchor byte two nibble
+ * tables give the buckets that accept a low or a high nibble, as in
+ * Hyperscan's Teddy. The prefilter ANDs the table lookups of the anchor
+ * bytes at every offset, 32 offsets per step with AVX2; only the patterns
+ * of the buckets left are compared in full, and only when they start on an
+ * allowed offset.
+ *
+ * The code is scanned in windows of match starts. With
+ * DISASM_SIGNATURE_SWEEP a window is one batch of instruction lengths, so
+ * the boundaries come from the same pass over the code. The matches of a
+ * window are sorted before they are reported, which keeps the whole output
+ * in address order.
+ */
+#define SIGNATURE_MAX_LENGTH    256
+#define SIGNATURE_ANCHOR        3
+#define SIGNATURE_BUCKETS       8
+#define SIGNATURE_BATCH         4096            // Instruction lengths per sweep window
+#define SIGNATURE_WINDOW        (64 * 1024)     // Bytes per window without a sweep
+
+typedef struct {
+    uint32_t length;
+    uint32_t anchor;        // Offset of the anchor in the pattern
+    uint32_t data;          // First byte in bytes and masks, padded to 8 bytes
+    uint32_t padded;        // Length rounded up to 8
+} SignaturePattern;
+
+typedef struct {
+    uint8_t low[SIGNATURE_ANCHOR][16];      // Buckets accepting each low nibble of anchor byte j
+    uint8_t high[SIGNATURE_ANCHOR][16];     // Buckets accepting each high nibble
+    uint8_t exact[SIGNATURE_ANCHOR][256];   // Both lookups at once, for the scalar loop
+    uint32_t bucket_start[SIGNATURE_BUCKETS + 1];
+    uint32_t* bucket_patterns;              // Pattern numbers, bucket by bucket
+    uint32_t anchor_min;
+    uint32_t anchor_max;
+    SignaturePattern* patterns;
+    uint8_t* bytes;
+    uint8_t* masks;                         // 0xFF, 0xF0, 0x0F or 0 per byte
+} SignatureData;
+
+typedef struct {
+    const SignatureData* data;
+    const uint8_t* code;
+    size_t length;
+    uint64_t address;
+    size_t from;                // Matches may start in [from, to)
+    size_t to;
+    const uint64_t* starts;     // NULL: any offset
+    size_t starts_base;         // Offset of bit 0 of starts
+    SignatureMatch* matches;    // Matches of the window
+    size_t match_count;
+    size_t match_capacity;
+    int failed;
+} SignatureScan;
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return c == '?' ? 16 : -1;
+}
+
+// Parses a pattern; returns its length, or 0 when it is invalid
+static size_t parse_pattern(const char* text, uint8_t* bytes, uint8_t* masks) {
+    size_t length = 0;
+    int fixed = 0;
+
+    for (;;) {
+        int high;
+        int low;
+
+        while (*text == ' ' || *text == '\t') {
+            text++;
+        }
+        if (*text == 0) {
+            break;
+        }
+
+        high = hex_digit(text[0]);
+        if (high == 16 && hex_digit(text[1]) < 0) {
+            // "?" alone is a whole wildcard byte
+            low = 16;
+            text += 1;
+        }
+        else {
+            low = high >= 0 ? hex_digit(text[1]) : -1;
+            text += 2;
+        }
+        if (high < 0 || low < 0 || length == SIGNATURE_MAX_LENGTH) {
+            return 0;
+        }
+
+        bytes[length] = (uint8_t)((high & 15) << 4 | (low & 15));
+        masks[length] = (uint8_t)((high == 16 ? 0 : 0xF0) | (low == 16 ? 0 : 0x0F));
+        bytes[length] &= masks[length];
+        fixed |= masks[length] != 0;
+        length++;
+    }
+
+    return fixed ? length : 0;
+}
+
+// Bytes that start or fill most x86 code, poor anchors
+static int is_common_byte(uint8_t byte) {
+    return byte == 0x00 || byte == 0xFF || byte == 0x48 || byte == 0x0F || byte == 0x89 || byte == 0x8B;
+}
+
+static uint32_t choose_anchor(const uint8_t* bytes, const uint8_t* masks, size_t length) {
+    uint32_t best = 0;
+    int best_score = -1;
+
+    for (size_t a = 0; a < length; a++) {
+        int score = 0;
+
+        for (size_t j = a; j < a + SIGNATURE_ANCHOR && j < length; j++) {
+            score += 4 * (((masks[j] & 0xF0) == 0xF0) + ((masks[j] & 0x0F) == 0x0F));
+            score -= masks[j] == 0xFF && is_common_byte(bytes[j]) ? 3 : 0;
+        }
+        if (score > best_score) {
+            best = (uint32_t)a;
+            best_score = score;
+        }
+    }
+
+    return best;
+}
+
+typedef struct {
+    uint32_t key;           // Anchor bytes, 0x100 past the end of the pattern
+    uint32_t number;
+} AnchorKey;
+
+// Orders patterns by anchor bytes, so similar anchors share a bucket
+static int compare_anchors(const void* a, const void* b) {
+    const AnchorKey* x = (const AnchorKey*)a;
+    const AnchorKey* y = (const AnchorKey*)b;
+
+    if (x->key != y->key) {
+        return x->key < y->key ? -1 : 1;
+    }
+    return x->number < y->number ? -1 : x->number > y->number;
+}
+
+static void add_to_tables(SignatureData* data, const SignaturePattern* pattern, unsigned int bucket) {
+    uint8_t bit = (uint8_t)(1 << bucket);
+
+    for (uint32_t j = 0; j < SIGNATURE_ANCHOR; j++) {
+        uint32_t position = pattern->anchor + j;
+        uint8_t byte = position < pattern->length ? data->bytes[pattern->data + position] : 0;
+        uint8_t mask = position < pattern->length ? data->masks[pattern->data + position] : 0;
+
+        for (unsigned int n = 0; n < 16; n++) {
+            if ((mask & 0x0F) != 0x0F || n == (byte & 0x0Fu)) {
+                data->low[j][n] |= bit;
+            }
+            if ((mask & 0xF0) != 0xF0 || n == (unsigned int)(byte >> 4)) {
+                data->high[j][n] |= bit;
+            }
+        }
+    }
+}
+
+void x86_signature_free(SignatureSet* set) {
+    SignatureData* data = (SignatureData*)set->data;
+
+    if (data) {
+        free(data->bucket_patterns);
+        free(data->patterns);
+        free(data->bytes);
+        free(data->masks);
+        free(data);
+    }
+    memset(set, 0, sizeof(*set));
+}
+
+int x86_signature_compile(SignatureSet* set, const char* const* patterns, size_t count, size_t* bad_pattern) {
+    SignatureData* data;
+    AnchorKey* keys;
+    size_t size = 0;
+
+    memset(set, 0, sizeof(*set));
+    *bad_pattern = count;
+    if (count > UINT32_MAX / SIGNATURE_MAX_LENGTH) {
+        return 0;
+    }
+
+    data = (SignatureData*)calloc(1, sizeof(SignatureData));
+    if (!data) {
+        return 0;
+    }
+    set->data = data;
+    data->patterns = (SignaturePattern*)malloc((count ? count : 1) * sizeof(SignaturePattern));
+    data->bucket_patterns = (uint32_t*)malloc((count ? count : 1) * sizeof(uint32_t));
+    data->bytes = (uint8_t*)malloc(count * SIGNATURE_MAX_LENGTH + 1);
+    data->masks = (uint8_t*)malloc(count * SIGNATURE_MAX_LENGTH + 1);
+    keys = (AnchorKey*)malloc((count ? count : 1) * sizeof(AnchorKey));
+    if (!data->patterns || !data->bucket_patterns || !data->bytes || !data->masks || !keys) {
+        free(keys);
+        x86_signature_free(set);
+        return 0;
+    }
+
+    // Parse each pattern behind the previous one, padded with wildcards
+    data->anchor_min = UINT32_MAX;
+    for (size_t p = 0; p < count; p++) {
+        SignaturePattern* pattern = &data->patterns[p];
+        size_t length = parse_pattern(patterns[p], data->bytes + size, data->masks + size);
+
+        if (length == 0) {
+            free(keys);
+            x86_signature_free(set);
+            *bad_pattern = p;
+            return 0;
+        }
+
+        pattern->length = (uint32_t)length;
+        pattern->padded = (uint32_t)((length + 7) & ~(size_t)7);
+        pattern->data = (uint32_t)size;
+        pattern->anchor = choose_anchor(data->bytes + size, data->masks + size, length);
+        memset(data->bytes + size + length, 0, pattern->padded - length);
+        memset(data->masks + size + length, 0, pattern->padded - length);
+        size += pattern->padded;
+
+        keys[p].key = 0;
+        keys[p].number = (uint32_t)p;
+        for (uint32_t j = 0; j < SIGNATURE_ANCHOR; j++) {
+            uint32_t position = pattern->anchor + j;
+            keys[p].key = keys[p].key << 9 | (position < length ? data->bytes[pattern->data + position] : 0x100);
+        }
+
+        data->anchor_min = pattern->anchor < data->anchor_min ? pattern->anchor : data->anchor_min;
+        data->anchor_max = pattern->anchor > data->anchor_max ? pattern->anchor : data->anchor_max;
+    }
+    if (count == 0) {
+        data->anchor_min = 0;
+    }
+
+    // Up to SIGNATURE_BUCKETS patterns get a bucket each, more are grouped
+    // by anchor in runs of equal size
+    qsort(keys, count, sizeof(AnchorKey), compare_anchors);
+    for (size_t p = 0; p < count; p++) {
+        data->bucket_patterns[p] = keys[p].number;
+    }
+    free(keys);
+
+    for (unsigned int b = 0; b <= SIGNATURE_BUCKETS; b++) {
+        data->bucket_start[b] = (uint32_t)(count * b / SIGNATURE_BUCKETS);
+    }
+    for (unsigned int b = 0; b < SIGNATURE_BUCKETS; b++) {
+        for (uint32_t i = data->bucket_start[b]; i < data->bucket_start[b + 1]; i++) {
+            add_to_tables(data, &data->patterns[data->bucket_patterns[i]], b);
+        }
+    }
+    for (unsigned int j = 0; j < SIGNATURE_ANCHOR; j++) {
+        for (unsigned int c = 0; c < 256; c++) {
+            data->exact[j][c] = data->low[j][c & 15] & data->high[j][c >> 4];
+        }
+    }
+
+    set->pattern_count = count;
+    return 1;
+}
+
+static int pattern_matches(const SignatureData* data, const SignaturePattern* pattern, const uint8_t* code,
+    size_t available) {
+    const uint8_t* bytes = data->bytes + pattern->data;
+    const uint8_t* masks = data->masks + pattern->data;
+
+    if (available >= pattern->padded) {
+        for (uint32_t i = 0; i < pattern->padded; i += 8) {
+            uint64_t value;
+            uint64_t expected;
+            uint64_t mask;
+
+            memcpy(&value, code + i, sizeof(value));
+            memcpy(&expected, bytes + i, sizeof(expected));
+            memcpy(&mask, masks + i, sizeof(mask));
+            if ((value & mask) != expected) {
+                return 0;
+            }
+        }
+        return 1;
+    }
+
+    if (available < pattern->length) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < pattern->length; i++) {
+        if ((code[i] & masks[i]) != bytes[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Compares the patterns of the buckets hit by the anchor at offset q
+static void check_candidate(SignatureScan* scan, size_t q, unsigned int buckets) {
+    const SignatureData* data = scan->data;
+
+    while (buckets) {
+        unsigned int b = count_trailing_zeros64(buckets);
+
+        buckets &= buckets - 1;
+        for (uint32_t i = data->bucket_start[b]; i < data->bucket_start[b + 1]; i++) {
+            uint32_t number = data->bucket_patterns[i];
+            const SignaturePattern* pattern = &data->patterns[number];
+            size_t start = q - pattern->anchor;
+
+            if (q < pattern->anchor || start < scan->from || start >= scan->to ||
+                (scan->starts && !bitmap_test(scan->starts, start - scan->starts_base)) ||
+                !pattern_matches(data, pattern, scan->code + start, scan->length - start)) {
+                continue;
+            }
+
+            if (scan->match_count == scan->match_capacity) {
+                size_t capacity = scan->match_capacity ? scan->match_capacity * 2 : 256;
+                SignatureMatch* grown = (SignatureMatch*)realloc(scan->matches, capacity * sizeof(SignatureMatch));
+                if (!grown) {
+                    scan->failed = 1;
+                    return;
+                }
+                scan->matches = grown;
+                scan->match_capacity = capacity;
+            }
+            scan->matches[scan->match_count].address = scan->address + start;
+            scan->matches[scan->match_count++].pattern = number;
+        }
+    }
+}
+
+static void prefilter_scalar(SignatureScan* scan, size_t from, size_t to) {
+    const SignatureData* data = scan->data;
+    const uint8_t* code = scan->code;
+
+    for (size_t q = from; q < to; q++) {
+        unsigned int buckets = data->exact[0][code[q]];
+
+        // Anchor bytes past the end accept every bucket; the full compare rejects them
+        for (unsigned int j = 1; j < SIGNATURE_ANCHOR && buckets; j++) {
+            if (q + j < scan->length) {
+                buckets &= data->exact[j][code[q + j]];
+            }
+        }
+        if (buckets) {
+            check_candidate(scan, q, buckets);
+        }
+    }
+}
+
+#if DISASM_SIGNATURE_X86
+
+static DISASM_TARGET_AVX2 void prefilter_avx2(SignatureScan* scan, size_t from, size_t to) {
+    const SignatureData* data = scan->data;
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i low[SIGNATURE_ANCHOR];
+    __m256i high[SIGNATURE_ANCHOR];
+    size_t q = from;
+
+    for (unsigned int j = 0; j < SIGNATURE_ANCHOR; j++) {
+        low[j] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)data->low[j]));
+        high[j] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)data->high[j]));
+    }
+
+    for (; q + 32 <= to && q + 32 + SIGNATURE_ANCHOR - 1 <= scan->length; q += 32) {
+        __m256i buckets = _mm256_set1_epi8(-1);
+        uint32_t hits;
+
+        for (unsigned int j = 0; j < SIGNATURE_ANCHOR; j++) {
+            __m256i bytes = _mm256_loadu_si256((const __m256i*)(scan->code + q + j));
+            __m256i low_nibble = _mm256_and_si256(bytes, nibble_mask);
+            __m256i high_nibble = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble_mask);
+
+            buckets = _mm256_and_si256(buckets, _mm256_and_si256(_mm256_shuffle_epi8(low[j], low_nibble),
+                _mm256_shuffle_epi8(high[j], high_nibble)));
+        }
+
+        hits = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(buckets, zero));
+        if (hits) {
+            uint8_t lanes[32];
+
+            _mm256_storeu_si256((__m256i*)lanes, buckets);
+            while (hits) {
+                unsigned int i = count_trailing_zeros64(hits);
+                hits &= hits - 1;
+                check_candidate(scan, q + i, lanes[i]);
+            }
+        }
+    }
+
+    prefilter_scalar(scan, q, to);
+}
+
+#endif
+
+// Anchors of the matches starting in [scan->from, scan->to)
+static void prefilter(SignatureScan* scan) {
+    size_t from = scan->from + scan->data->anchor_min;
+    size_t to = scan->to + scan->data->anchor_max;
+
+    if (to > scan->length) {
+        to = scan->length;
+    }
+    if (from >= to) {
+        return;
+    }
+
+#if DISASM_SIGNATURE_X86
+    if (x86_scan_level() == DISASM_SCAN_AVX2) {
+        prefilter_avx2(scan, from, to);
+        return;
+    }
+#endif
+    prefilter_scalar(scan, from, to);
+}
+
+static int compare_matches(const void* a, const void* b) {
+    const SignatureMatch* x = (const SignatureMatch*)a;
+    const SignatureMatch* y = (const SignatureMatch*)b;
+
+    if (x->address != y->address) {
+        return x->address < y->address ? -1 : 1;
+    }
+    return x->pattern < y->pattern ? -1 : x->pattern > y->pattern;
+}
+
+// Sorts the matches of a window and moves them to the output
+static void flush_matches(SignatureScan* scan, SignatureMatch* out, size_t max_count, size_t* match_count) {
+    qsort(scan->matches, scan->match_count, sizeof(SignatureMatch), compare_matches);
+    if (out && *match_count < max_count && scan->match_count) {
+        size_t room = max_count - *match_count;
+        memcpy(out + *match_count, scan->matches, (scan->match_count < room ? scan->match_count : room) *
+            sizeof(SignatureMatch));
+    }
+    *match_count += scan->match_count;
+    scan->match_count = 0;
+}
+
+int x86_signature_scan(const SignatureSet* set, DisasmMode mode, const void* code, size_t length, uint64_t address,
+    DisasmSignatureAlign align, const uint64_t* starts, SignatureMatch* out, size_t max_count, size_t* match_count) {
+    SignatureScan scan;
+    uint8_t* lengths = NULL;
+    uint64_t* window_starts = NULL;
+    size_t offset = 0;
+
+    *match_count = 0;
+    if (set->pattern_count == 0) {
+        return 1;
+    }
+
+    memset(&scan, 0, sizeof(scan));
+    scan.data = (const SignatureData*)set->data;
+    scan.code = (const uint8_t*)code;
+    scan.length = length;
+    scan.address = address;
+
+    if (align == DISASM_SIGNATURE_SWEEP) {
+        lengths = (uint8_t*)malloc(SIGNATURE_BATCH);
+        window_starts = (uint64_t*)malloc(BITMAP_WORDS(SIGNATURE_BATCH * X86_MAX_INSTRUCTION_LENGTH) * sizeof(uint64_t));
+        if (!lengths || !window_starts) {
+            free(lengths);
+            free(window_starts);
+            return 0;
+        }
+    }
+
+    while (offset < length && !scan.failed) {
+        scan.from = offset;
+
+        if (align == DISASM_SIGNATURE_SWEEP) {
+            DisasmBatchResult result;
+            size_t count = x86_insn_length_batch_mode(mode, scan.code + offset, length - offset, lengths,
+                SIGNATURE_BATCH, &result);
+            size_t position = 0;
+
+            if (count == 0) {
+                break;
+            }
+            memset(window_starts, 0, BITMAP_WORDS(result.offset) * sizeof(uint64_t));
+            for (size_t i = 0; i < count; i++) {
+                bitmap_set(window_starts, position);
+                position += lengths[i];
+            }
+            scan.to = offset + result.offset;
+            scan.starts = window_starts;
+            scan.starts_base = offset;
+        }
+        else {
+            scan.to = length - offset < SIGNATURE_WINDOW ? length : offset + SIGNATURE_WINDOW;
+            scan.starts = align == DISASM_SIGNATURE_STARTS ? starts : NULL;
+            scan.starts_base = 0;
+        }
+
+        prefilter(&scan);
+        flush_matches(&scan, out, max_count, match_count);
+        offset = scan.to;
+    }
+
+    free(scan.matches);
+    free(lengths);
+    free(window_starts);
+    return !scan.failed;
+}
@@ -0,0 +1,328 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "disassm.h"
+
+/*
+ * Decoded instruction store
+ *
+ * File layout: a header, the blocks, then the table of block offsets. A
+ * block holds STORE_BLOCK_ROWS rows column by column: the resolved
+ * targets, then the columns of InstructionColumns in the order
+ * x86_columns_init lays them out. Every block has the same size, the last
+ * one padded with zeroes, so a block and a row are found by arithmetic and
+ * a mapped file is used without any parsing. The blocks are written while
+ * the code is decoded, so writing needs one block of memory whatever the
+ * size of the code.
+ */
+#define STORE_FILE_VERSION  1
+#define STORE_BLOCK_ROWS    65536
+#define STORE_BATCH         1024        // Records decoded per batch while writing
+#define STORE_ROW_BYTES     (sizeof(uint64_t) + sizeof(uint32_t) + 2 * sizeof(uint16_t) + 8)
+
+static const char g_store_magic[8] = { 'x', '8', '6', 'd', 'c', 'o', 'l', 0 };
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;       // Offset of the first block
+    uint64_t hash;              // x86_content_hash of the code
+    uint64_t length;
+    uint64_t address;
+    uint64_t end;
+    uint64_t instruction_count;
+    uint64_t table_offset;      // Offset of the block offsets
+    uint32_t mode;
+    uint32_t block_rows;
+} StoreFileHeader;
+
+/*
+ * Content hash: XXH64 with seed 0
+ */
+#define HASH_PRIME1 0x9E3779B185EBCA87ull
+#define HASH_PRIME2 0xC2B2AE3D27D4EB4Full
+#define HASH_PRIME3 0x165667B19E3779F9ull
+#define HASH_PRIME4 0x85EBCA77C2B2AE63ull
+#define HASH_PRIME5 0x27D4EB2F165667C5ull
+
+static inline uint64_t rotate_left(uint64_t value, unsigned int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint64_t read64(const uint8_t* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint64_t hash_round(uint64_t accumulator, uint64_t input) {
+    return rotate_left(accumulator + input * HASH_PRIME2, 31) * HASH_PRIME1;
+}
+
+static inline uint64_t hash_merge(uint64_t hash, uint64_t accumulator) {
+    return (hash ^ hash_round(0, accumulator)) * HASH_PRIME1 + HASH_PRIME4;
+}
+
+uint64_t x86_content_hash(const void* data, size_t length) {
+    const uint8_t* p = (const uint8_t*)data;
+    const uint8_t* end = p + length;
+    uint64_t hash;
+
+    if (length >= 32) {
+        uint64_t v1 = HASH_PRIME1 + HASH_PRIME2;
+        uint64_t v2 = HASH_PRIME2;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - HASH_PRIME1;
+
+        for (; end - p >= 32; p += 32) {
+            v1 = hash_round(v1, read64(p));
+            v2 = hash_round(v2, read64(p + 8));
+            v3 = hash_round(v3, read64(p + 16));
+            v4 = hash_round(v4, read64(p + 24));
+        }
+        hash = rotate_left(v1, 1) + rotate_left(v2, 7) + rotate_left(v3, 12) + rotate_left(v4, 18);
+        hash = hash_merge(hash, v1);
+        hash = hash_merge(hash, v2);
+        hash = hash_merge(hash, v3);
+        hash = hash_merge(hash, v4);
+    }
+    else {
+        hash = HASH_PRIME5;
+    }
+    hash += length;
+
+    for (; end - p >= 8; p += 8) {
+        hash = rotate_left(hash ^ hash_round(0, read64(p)), 27) * HASH_PRIME1 + HASH_PRIME4;
+    }
+    if (end - p >= 4) {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        hash = rotate_left(hash ^ (uint64_t)value * HASH_PRIME1, 23) * HASH_PRIME2 + HASH_PRIME3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        hash = rotate_left(hash ^ *p * HASH_PRIME5, 11) * HASH_PRIME1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+// Points columns at the columns of a block of 'rows' rows; returns its targets
+static uint64_t* block_columns(uint8_t* block, size_t rows, InstructionColumns* columns) {
+    uint64_t* targets = (uint64_t*)block;
+    uint8_t* p = block + rows * sizeof(uint64_t);
+
+    columns->offset = (uint32_t*)p;
+    p += rows * sizeof(uint32_t);
+    columns->prefixes = (uint16_t*)p;
+    p += rows * sizeof(uint16_t);
+    columns->flags = (uint16_t*)p;
+    p += rows * sizeof(uint16_t);
+    columns->length = p;
+    p += rows;
+    columns->map = p;
+    p += rows;
+    columns->opcode = p;
+    p += rows;
+    columns->modrm = p;
+    p += rows;
+    columns->sib = p;
+    p += rows;
+    columns->rex = p;
+    p += rows;
+    columns->disp = p;
+    p += rows;
+    columns->imm = p;
+    return targets;
+}
+
+int x86_store_write(const char* path, DisasmMode mode, const void* code, size_t length, uint64_t address) {
+    const uint8_t* base = (const uint8_t*)code;
+    size_t block_size = STORE_BLOCK_ROWS * STORE_ROW_BYTES;
+    uint8_t* block = (uint8_t*)malloc(block_size);
+    DecodedInstruction* records = (DecodedInstruction*)malloc(STORE_BATCH * sizeof(DecodedInstruction));
+    uint64_t* offsets = NULL;
+    size_t block_count = 0;
+    size_t offsets_capacity = 0;
+    size_t offset = 0;
+    int truncated = 0;
+    StoreFileHeader header;
+    FILE* file = NULL;
+    int status = 0;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, g_store_magic, sizeof(header.magic));
+    header.version = STORE_FILE_VERSION;
+    header.header_size = sizeof(header);
+    header.hash = x86_content_hash(code, length);
+    header.length = length;
+    header.address = address;
+    header.mode = (uint32_t)mode;
+    header.block_rows = STORE_BLOCK_ROWS;
+
+    if (!block || !records) {
+        goto done;
+    }
+    file = fopen(path, "wb");
+    if (!file || fwrite(&header, sizeof(header), 1, file) != 1) {
+        goto done;
+    }
+
+    while (offset < length && !truncated) {
+        InstructionColumns columns;
+        uint64_t* targets;
+        size_t block_offset = offset;
+        size_t rows = 0;
+
+        memset(block, 0, block_size);
+        targets = block_columns(block, STORE_BLOCK_ROWS, &columns);
+
+        while (rows < STORE_BLOCK_ROWS && offset < length) {
+            DisasmBatchResult result;
+            size_t max_count = STORE_BLOCK_ROWS - rows < STORE_BATCH ? STORE_BLOCK_ROWS - rows : STORE_BATCH;
+            size_t count = x86_disasm_batch_mode(mode, base + offset, length - offset, address + offset, records,
+                max_count, &result);
+
+            for (size_t i = 0; i < count; i++) {
+                PackedInstruction packed;
+                size_t row = rows + i;
+
+                x86_pack_instruction(&records[i].info, (uint32_t)(records[i].address - address - block_offset), &packed);
+                targets[row] = records[i].target;
+                columns.offset[row] = packed.offset;
+                columns.length[row] = packed.length;
+                columns.map[row] = packed.map;
+                columns.opcode[row] = packed.opcode;
+                columns.modrm[row] = packed.modrm;
+                columns.sib[row] = packed.sib;
+                columns.rex[row] = packed.rex;
+                columns.prefixes[row] = packed.prefixes;
+                columns.disp[row] = packed.disp;
+                columns.imm[row] = packed.imm;
+                columns.flags[row] = packed.flags;
+            }
+            rows += count;
+            offset += result.offset;
+
+            if (result.reason == DISASM_STOP_TRUNCATED) {
+                truncated = 1;
+                break;
+            }
+        }
+        if (rows == 0) {
+            break;
+        }
+
+        if (block_count == offsets_capacity) {
+            size_t capacity = offsets_capacity ? offsets_capacity * 2 : 64;
+            uint64_t* grown = (uint64_t*)realloc(offsets, capacity * sizeof(uint64_t));
+            if (!grown) {
+                goto done;
+            }
+            offsets = grown;
+            offsets_capacity = capacity;
+        }
+        offsets[block_count++] = block_offset;
+        header.instruction_count += rows;
+
+        if (fwrite(block, block_size, 1, file) != 1) {
+            goto done;
+        }
+    }
+
+    // The table and the final header go in once the counts are known
+    header.end = offset;
+    header.table_offset = sizeof(header) + (uint64_t)block_count * block_size;
+    if ((block_count && fwrite(offsets, sizeof(uint64_t), block_count, file) != block_count) ||
+        fseek(file, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, file) != 1) {
+        goto done;
+    }
+    status = 1;
+
+done:
+    if (file && fclose(file) != 0) {
+        status = 0;
+    }
+    if (file && !status) {
+        remove(path);
+    }
+    free(block);
+    free(records);
+    free(offsets);
+    return status;
+}
+
+int x86_store_load(const char* path, unsigned int map_flags, DecodedStore* store) {
+    const StoreFileHeader* header;
+    MappedFile file;
+    uint64_t block_size;
+    uint64_t block_count;
+
+    memset(store, 0, sizeof(*store));
+    if (!x86_map_file(path, map_flags, &file)) {
+        return 0;
+    }
+
+    // Only the header is checked, against the size of the file
+    header = (const StoreFileHeader*)file.data;
+    if (file.size < sizeof(StoreFileHeader) || memcmp(header->magic, g_store_magic, sizeof(header->magic)) != 0 ||
+        header->version != STORE_FILE_VERSION || header->header_size < sizeof(StoreFileHeader) ||
+        header->header_size % 8 != 0 || header->block_rows == 0 || header->block_rows % 8 != 0 ||
+        (header->mode != DISASM_MODE_16 && header->mode != DISASM_MODE_32 && header->mode != DISASM_MODE_64) || header->end > header->length) {
+        x86_unmap_file(&file);
+        return 0;
+    }
+
+    block_size = (uint64_t)header->block_rows * STORE_ROW_BYTES;
+    block_count = header->instruction_count / header->block_rows +
+        (header->instruction_count % header->block_rows != 0);
+    if (header->table_offset > file.size || block_count > (file.size - header->table_offset) / sizeof(uint64_t) ||
+        header->table_offset % 8 != 0 || header->table_offset < header->header_size ||
+        block_count > (header->table_offset - header->header_size) / block_size) {
+        x86_unmap_file(&file);
+        return 0;
+    }
+
+    store->mode = (DisasmMode)header->mode;
+    store->hash = header->hash;
+    store->address = header->address;
+    store->length = header->length;
+    store->end = header->end;
+    store->instruction_count = (size_t)header->instruction_count;
+    store->block_rows = header->block_rows;
+    store->block_count = (size_t)block_count;
+    store->block_offsets = (const uint64_t*)(file.data + header->table_offset);
+    store->blocks = file.data + header->header_size;
+    store->file = file;
+    return 1;
+}
+
+void x86_store_free(DecodedStore* store) {
+    x86_unmap_file(&store->file);
+    memset(store, 0, sizeof(*store));
+}
+
+size_t x86_store_block(const DecodedStore* store, size_t block, InstructionColumns* columns, const uint64_t** targets) {
+    size_t rows;
+
+    memset(columns, 0, sizeof(*columns));
+    *targets = NULL;
+    if (block >= store->block_count) {
+        return 0;
+    }
+
+    rows = block + 1 < store->block_count ? store->block_rows :
+        store->instruction_count - (store->block_count - 1) * store->block_rows;
+    // The mapping is read-only: the columns must not be written
+    *targets = block_columns((uint8_t*)store->blocks + block * store->block_rows * STORE_ROW_BYTES, store->block_rows,
+        columns);
+    columns->capacity = rows;
+    columns->count = rows;
+    return rows;
+}
@@ -0,0 +1,121 @@
+#include <stdint.h>
+#include <string.h>
+#include "disassm.h"
+
+/*
+ * Streaming decoder
+ *
+ * Chunks are decoded in place by the batch decoder. Only instructions
+ * starting at least X86_MAX_INSTRUCTION_LENGTH bytes before the end of a
+ * chunk are kept, so every record comes from the full window, exactly as
+ * when the whole input is in one buffer. The last bytes of a chunk (at
+ * most 14) are carried over and decoded once the next chunk has completed
+ * their window, one instruction at a time.
+ */
+
+void x86_stream_init(DisasmStream* stream, DisasmMode mode, uint64_t address) {
+    memset(stream, 0, sizeof(*stream));
+    stream->mode = mode;
+    stream->address = address;
+}
+
+void x86_stream_feed(DisasmStream* stream, const void* data, size_t length) {
+    stream->input = (const uint8_t*)data;
+    stream->input_length = length;
+}
+
+void x86_stream_finish(DisasmStream* stream) {
+    stream->finished = 1;
+}
+
+// Moves what is left of the chunk, less than a window, behind the carried bytes
+static void carry_input(DisasmStream* stream) {
+    // An empty final chunk may be fed as NULL
+    if (stream->input_length == 0) {
+        return;
+    }
+    memcpy(stream->carry + stream->carry_length, stream->input, stream->input_length);
+    stream->carry_length += (unsigned int)stream->input_length;
+    stream->input += stream->input_length;
+    stream->input_length = 0;
+}
+
+size_t x86_stream_decode(DisasmStream* stream, DecodedInstruction* out, size_t max_count) {
+    size_t count = 0;
+
+    // Carried bytes first, completed from the chunk
+    while (stream->carry_length && count < max_count) {
+        uint8_t window[X86_MAX_INSTRUCTION_LENGTH];
+        size_t needed = X86_MAX_INSTRUCTION_LENGTH - stream->carry_length;
+        unsigned int length;
+
+        if (stream->input_length < needed) {
+            if (!stream->finished) {
+                carry_input(stream);
+                return count;
+            }
+
+            // End of the input: the tail is decoded as x86_disasm_batch
+            // decodes the end of a buffer, truncated bytes stay carried
+            {
+                DisasmBatchResult result;
+                size_t decoded;
+
+                carry_input(stream);
+                decoded = x86_disasm_batch_mode(stream->mode, stream->carry, stream->carry_length, stream->address,
+                    out + count, max_count - count, &result);
+                count += decoded;
+                stream->address = result.address;
+                stream->carry_length -= (unsigned int)result.offset;
+                memmove(stream->carry, stream->carry + result.offset, stream->carry_length);
+                return count;
+            }
+        }
+
+        memcpy(window, stream->carry, stream->carry_length);
+        memcpy(window + stream->carry_length, stream->input, needed);
+        x86_disasm_batch_mode(stream->mode, window, X86_MAX_INSTRUCTION_LENGTH, stream->address, &out[count], 1, NULL);
+        length = out[count++].info.length;
+        stream->address += length;
+
+        if (length >= stream->carry_length) {
+            stream->input += length - stream->carry_length;
+            stream->input_length -= length - stream->carry_length;
+            stream->carry_length = 0;
+        }
+        else {
+            stream->carry_length -= length;
+            memmove(stream->carry, stream->carry + length, stream->carry_length);
+        }
+    }
+
+    // Then the chunk in place, up to its last full window
+    while (stream->input_length >= X86_MAX_INSTRUCTION_LENGTH && count < max_count) {
+        DisasmBatchResult result;
+        size_t last = stream->input_length - X86_MAX_INSTRUCTION_LENGTH;
+        size_t decoded = x86_disasm_batch_mode(stream->mode, stream->input, stream->input_length, stream->address,
+            out + count, max_count - count, &result);
+        size_t kept = decoded;
+        size_t consumed = result.offset;
+
+        // Records decoded from a padded window are dropped and done again
+        while (kept && out[count + kept - 1].address - stream->address > last) {
+            kept--;
+            consumed = (size_t)(out[count + kept].address - stream->address);
+        }
+
+        count += kept;
+        stream->input += consumed;
+        stream->input_length -= consumed;
+        stream->address += consumed;
+    }
+
+    if (stream->input_length < X86_MAX_INSTRUCTION_LENGTH && count < max_count) {
+        carry_input(stream);
+        if (stream->finished && stream->carry_length) {
+            count += x86_stream_decode(stream, out + count, max_count - count);
+        }
+    }
+
+    return count;
+}
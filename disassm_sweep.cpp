@@ -0,0 +1,238 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include "disassm.h"
+#include "disassm_bitmap.h"
+
+/*
+ * Parallel linear sweep
+ *
+ * The buffer is split into chunks that are length-decoded speculatively
+ * from their first byte, each on a worker thread, marking every
+ * instruction start in a shared bitmap. A serial pass then walks the chunk
+ * seams from the true end of the previous chunk: it re-decodes one
+ * instruction at a time until it lands on a speculative start, after which
+ * the rest of the chunk is known to match. With the true entry and
+ * instruction count of every chunk, the records are decoded in parallel
+ * straight into their final slots.
+ */
+
+// Smallest chunk worth a thread; chunk starts are 64-byte aligned so each
+// bitmap word is written by one worker only
+#define SWEEP_MIN_CHUNK     (64 * 1024)
+#define SWEEP_CHUNKS_PER_THREAD 8
+#define SWEEP_LENGTH_BLOCK  4096
+
+typedef struct {
+    size_t start;           // First byte of the chunk
+    size_t end;             // First byte of the next chunk
+    size_t exit;            // Speculative: first instruction start at or after end, or the truncation point
+    int truncated;          // Speculative: an instruction runs past the end of the buffer
+    size_t entry;           // First true instruction start in the chunk
+    size_t index;           // Index of the chunk's first record
+    size_t count;           // Number of true instructions starting in the chunk
+    size_t stop;            // Offset where phase 2 decoding stopped
+} SweepChunk;
+
+typedef struct {
+    DisasmMode mode;
+    const uint8_t* code;
+    size_t length;
+    uint64_t address;
+    DecodedInstruction* out;
+    size_t max_count;
+    uint64_t* bitmap;
+    SweepChunk* chunks;
+    size_t chunk_count;
+    std::atomic<size_t> next;
+} SweepState;
+
+// Phase 1: mark the instruction starts of a chunk decoded from its first byte
+static void sweep_speculate(SweepState* state, SweepChunk* chunk) {
+    uint8_t lengths[SWEEP_LENGTH_BLOCK];
+    size_t offset = chunk->start;
+
+    // Every instruction starting before the end fits in this window, so its
+    // length is the one the serial sweep computes
+    size_t window = chunk->end + X86_MAX_INSTRUCTION_LENGTH;
+    if (window > state->length) {
+        window = state->length;
+    }
+
+    chunk->truncated = 0;
+    while (offset < chunk->end) {
+        DisasmBatchResult result;
+        size_t count = x86_insn_length_batch_mode(state->mode, state->code + offset, window - offset,
+            lengths, SWEEP_LENGTH_BLOCK, &result);
+
+        for (size_t i = 0; i < count && offset < chunk->end; i++) {
+            bitmap_set(state->bitmap, offset);
+            offset += lengths[i];
+        }
+
+        if (result.reason != DISASM_STOP_FULL) {
+            chunk->truncated = result.reason == DISASM_STOP_TRUNCATED && offset < chunk->end;
+            break;
+        }
+    }
+
+    chunk->exit = offset;
+}
+
+// Phase 2: decode the true instructions of a chunk into their final slots
+static void sweep_decode(SweepState* state, SweepChunk* chunk) {
+    size_t count = chunk->count;
+    DisasmBatchResult result;
+
+    chunk->stop = chunk->entry;
+    if (chunk->index >= state->max_count || count == 0) {
+        return;
+    }
+    if (count > state->max_count - chunk->index) {
+        count = state->max_count - chunk->index;
+    }
+
+    x86_disasm_batch_mode(state->mode, state->code + chunk->entry, state->length - chunk->entry,
+        state->address + chunk->entry, state->out + chunk->index, count, &result);
+    chunk->stop = chunk->entry + result.offset;
+}
+
+static void sweep_worker(SweepState* state, void (*phase)(SweepState*, SweepChunk*)) {
+    size_t index;
+
+    while ((index = state->next.fetch_add(1)) < state->chunk_count) {
+        phase(state, &state->chunks[index]);
+    }
+}
+
+static void sweep_run(SweepState* state, unsigned int threads, void (*phase)(SweepState*, SweepChunk*)) {
+    std::thread* workers = new std::thread[threads - 1];
+
+    state->next = 0;
+    for (unsigned int i = 0; i < threads - 1; i++) {
+        workers[i] = std::thread(sweep_worker, state, phase);
+    }
+    sweep_worker(state, phase);
+    for (unsigned int i = 0; i < threads - 1; i++) {
+        workers[i].join();
+    }
+
+    delete[] workers;
+}
+
+/*
+ * Walks the chunk seams in order and fills entry, index and count. Returns
+ * the number of instructions; *end receives where the sweep stopped.
+ */
+static size_t sweep_stitch(SweepState* state, size_t* end) {
+    size_t offset = 0;
+    size_t total = 0;
+    int stopped = 0;
+
+    for (size_t c = 0; c < state->chunk_count; c++) {
+        SweepChunk* chunk = &state->chunks[c];
+        size_t count = 0;
+
+        chunk->entry = offset;
+        chunk->index = total;
+
+        // Resynchronize: re-decode until the true stream meets a speculative start
+        while (!stopped && offset < chunk->end && !bitmap_test(state->bitmap, offset)) {
+            uint8_t length;
+            DisasmBatchResult result;
+
+            if (x86_insn_length_batch_mode(state->mode, state->code + offset, state->length - offset,
+                &length, 1, &result) == 0) {
+                stopped = 1;
+                break;
+            }
+            offset += length;
+            count++;
+        }
+
+        // Converged: the rest of the chunk is the speculative stream
+        if (!stopped && offset < chunk->end) {
+            count += bitmap_count(state->bitmap, offset, chunk->end);
+            offset = chunk->exit;
+            stopped = chunk->truncated;
+        }
+
+        chunk->count = count;
+        total += count;
+    }
+
+    *end = offset;
+    return total;
+}
+
+size_t x86_sweep_parallel(DisasmMode mode, const void* code, size_t length, uint64_t address,
+    DecodedInstruction* out, size_t max_count, unsigned int threads, DisasmBatchResult* result) {
+    SweepState state;
+    size_t chunk_count;
+    size_t total;
+    size_t end;
+
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+
+    chunk_count = (size_t)threads * SWEEP_CHUNKS_PER_THREAD;
+    if (chunk_count > length / SWEEP_MIN_CHUNK) {
+        chunk_count = length / SWEEP_MIN_CHUNK;
+    }
+    if (threads <= 1 || chunk_count <= 1) {
+        return x86_disasm_batch_mode(mode, code, length, address, out, max_count, result);
+    }
+    if ((size_t)threads > chunk_count) {
+        threads = (unsigned int)chunk_count;
+    }
+
+    state.mode = mode;
+    state.code = (const uint8_t*)code;
+    state.length = length;
+    state.address = address;
+    state.out = out;
+    state.max_count = max_count;
+    state.chunk_count = chunk_count;
+    state.bitmap = (uint64_t*)calloc(BITMAP_WORDS(length), sizeof(uint64_t));
+    state.chunks = (SweepChunk*)calloc(chunk_count, sizeof(SweepChunk));
+    if (!state.bitmap || !state.chunks) {
+        free(state.bitmap);
+        free(state.chunks);
+        return x86_disasm_batch_mode(mode, code, length, address, out, max_count, result);
+    }
+
+    for (size_t c = 0; c < chunk_count; c++) {
+        state.chunks[c].start = (length / chunk_count * c) & ~(size_t)63;
+        state.chunks[c].end = c + 1 < chunk_count ? (length / chunk_count * (c + 1)) & ~(size_t)63 : length;
+    }
+
+    sweep_run(&state, threads, sweep_speculate);
+    total = sweep_stitch(&state, &end);
+    sweep_run(&state, threads, sweep_decode);
+
+    if (result) {
+        if (total > max_count) {
+            // Stopped at the record limit inside a chunk: the serial sweep stops there too
+            size_t c = 0;
+            while (state.chunks[c].index + state.chunks[c].count <= max_count) {
+                c++;
+            }
+            result->offset = state.chunks[c].stop;
+            result->reason = DISASM_STOP_FULL;
+        }
+        else {
+            result->offset = end;
+            result->reason = end == length ? DISASM_STOP_END :
+                total == max_count ? DISASM_STOP_FULL : DISASM_STOP_TRUNCATED;
+        }
+        result->count = total < max_count ? total : max_count;
+        result->address = address + result->offset;
+    }
+
+    free(state.bitmap);
+    free(state.chunks);
+    return total < max_count ? total : max_count;
+}
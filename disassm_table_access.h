@@ -0,0 +1,204 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "disassm.h"
+
+/*
+ * Operand access rules
+ *
+ * The format tables describe operand layouts but not what an instruction
+ * does with them, so read/write access is derived from the mnemonic. Rules
+ * are tried in order and the first match wins; an instruction without a
+ * match reads and writes its first operand and reads the others, which is
+ * right for the two-operand ALU forms. Mnemonics are the format table names
+ * without the VEX "v".
+ */
+typedef enum {
+    ACCESS_MATCH_PREFIX = 0,    // The mnemonic starts with the rule name
+    ACCESS_MATCH_EXACT = 1,     // The mnemonic is the rule name
+    ACCESS_MATCH_LEGACY = 2     // Prefix, and the entry has no vector operand
+} AccessMatch;
+
+typedef struct {
+    char mnemonic[12];
+    uint8_t length;
+    uint8_t match;          // AccessMatch
+    uint8_t first;          // OperandAccess of the first operand
+    uint8_t rest;           // OperandAccess of the other operands (0 = not accessed)
+} AccessRule;
+
+constexpr uint8_t ACCESS_R = OPERAND_ACCESS_READ;
+constexpr uint8_t ACCESS_W = OPERAND_ACCESS_WRITE;
+constexpr uint8_t ACCESS_RW = OPERAND_ACCESS_READ_WRITE;
+
+template <size_t N>
+constexpr AccessRule access_rule(const char (&name)[N], unsigned int match, uint8_t first, uint8_t rest = ACCESS_R) {
+    static_assert(N <= 13, "rule name longer than 12 characters");
+    AccessRule rule = {};
+
+    for (size_t i = 0; i + 1 < N; i++) {
+        rule.mnemonic[i] = name[i];
+    }
+    rule.length = (uint8_t)(N - 1);
+    rule.match = (uint8_t)match;
+    rule.first = first;
+    rule.rest = rest;
+    return rule;
+}
+
+static constexpr AccessRule g_access_rules[] = {
+    // Exchanges write both operands
+    access_rule("xchg", ACCESS_MATCH_EXACT, ACCESS_RW, ACCESS_RW),
+    access_rule("xadd", ACCESS_MATCH_EXACT, ACCESS_RW, ACCESS_RW),
+    access_rule("cmpxchg", ACCESS_MATCH_PREFIX, ACCESS_RW),
+
+    // Comparisons and tests only read (the vector compares write a mask)
+    access_rule("cmp", ACCESS_MATCH_LEGACY, ACCESS_R),
+    access_rule("test", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("bt", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("comis", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("ucomis", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("ptest", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("testp", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("kortest", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("ktest", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("pcmpestr", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("pcmpistr", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("scas", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("bound", ACCESS_MATCH_EXACT, ACCESS_R),
+
+    // Control transfers, stack pushes and I/O writes
+    access_rule("j", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("call", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("loop", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("ret", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("iret", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("int", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("enter", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("push", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("out", ACCESS_MATCH_PREFIX, ACCESS_R),
+
+    // Single-operand multiply and divide read their explicit operand
+    access_rule("mul", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("div", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("idiv", ACCESS_MATCH_EXACT, ACCESS_R),
+
+    // System register loads and cache hints
+    access_rule("lgdt", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("lidt", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("lldt", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("ltr", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("lmsw", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("verr", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("verw", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("invlpg", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("prefetch", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("clflush", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("nop", ACCESS_MATCH_EXACT, ACCESS_R),
+
+    // Fused multiply-add, two-table permutes and ternary logic accumulate
+    access_rule("fmadd", ACCESS_MATCH_PREFIX, ACCESS_RW),
+    access_rule("fmsub", ACCESS_MATCH_PREFIX, ACCESS_RW),
+    access_rule("fnmadd", ACCESS_MATCH_PREFIX, ACCESS_RW),
+    access_rule("fnmsub", ACCESS_MATCH_PREFIX, ACCESS_RW),
+    access_rule("permi2", ACCESS_MATCH_PREFIX, ACCESS_RW),
+    access_rule("permt2", ACCESS_MATCH_PREFIX, ACCESS_RW),
+    access_rule("pternlog", ACCESS_MATCH_PREFIX, ACCESS_RW),
+    access_rule("pdpb", ACCESS_MATCH_PREFIX, ACCESS_RW),
+    access_rule("pdpw", ACCESS_MATCH_PREFIX, ACCESS_RW),
+
+    // x87 stores write memory; the other one-operand x87 forms read it
+    access_rule("fst", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("fist", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("fbstp", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("fnst", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("fnsave", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("fxsave", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("xsave", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("fxch", ACCESS_MATCH_EXACT, ACCESS_RW, ACCESS_RW),
+    access_rule("fld", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("fild", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("fbld", ACCESS_MATCH_EXACT, ACCESS_R),
+    access_rule("fcom", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("fucom", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("ficom", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("fxrstor", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("xrstor", ACCESS_MATCH_PREFIX, ACCESS_R),
+    access_rule("frstor", ACCESS_MATCH_EXACT, ACCESS_R),
+
+    // Instructions that overwrite their destination without reading it
+    access_rule("mov", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("kmov", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("lea", ACCESS_MATCH_EXACT, ACCESS_W, 0),
+    access_rule("set", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("pop", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("in", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("ins", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("stos", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("lods", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("cvt", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("lds", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("les", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("lfs", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("lgs", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("lss", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("lar", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("lsl", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("sgdt", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("sidt", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("sldt", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("str", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("smsw", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("bsf", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("bsr", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("lzcnt", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("tzcnt", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("popcnt", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("rdrand", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("rdseed", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("rdpid", ACCESS_MATCH_EXACT, ACCESS_W),
+    access_rule("pshuf", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("pextr", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("extract", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("pmovmsk", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("sqrt", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("rcp", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("rsqrt", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("pbroadcast", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("broadcast", ACCESS_MATCH_PREFIX, ACCESS_W),
+    access_rule("gather", ACCESS_MATCH_PREFIX, ACCESS_RW),
+    access_rule("pgather", ACCESS_MATCH_PREFIX, ACCESS_RW),
+    access_rule("knot", ACCESS_MATCH_PREFIX, ACCESS_W),
+};
+
+#define ACCESS_RULE_COUNT (sizeof(g_access_rules) / sizeof(g_access_rules[0]))
+
+/*
+ * Rules grouped by the first letter of the mnemonic, in table order
+ *
+ * Only rules that share the first letter can match, so the lookup scans one
+ * bucket: order[start[c - 'a'] .. start[c - 'a' + 1]).
+ */
+typedef struct {
+    uint8_t start[27];
+    uint8_t order[ACCESS_RULE_COUNT];
+} AccessRuleIndex;
+
+constexpr AccessRuleIndex build_access_rule_index() {
+    AccessRuleIndex index = {};
+    unsigned int next = 0;
+
+    for (unsigned int letter = 0; letter < 26; letter++) {
+        index.start[letter] = (uint8_t)next;
+        for (unsigned int i = 0; i < ACCESS_RULE_COUNT; i++) {
+            if (g_access_rules[i].mnemonic[0] == (char)('a' + letter)) {
+                index.order[next++] = (uint8_t)i;
+            }
+        }
+    }
+    index.start[26] = (uint8_t)next;
+    return index;
+}
+
+static constexpr AccessRuleIndex g_access_rule_index = build_access_rule_index();
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "disassm.h"
+#include "disassm_table_op1.h"
+#include "disassm_table_op2.h"
+#include "disassm_table_op3.h"
+
+/*
+ * Dense per-byte decode-state tables
+ *
+ * Every question the decoder asks about a byte (is it a prefix, may this
+ * opcode take LOCK, must its ModR/M operand be memory, ...) is answered by
+ * a single indexed load from one of these tables instead of a switch or a
+ * linear scan. Together with the opcode and group attribute tables they
+ * take a few KB and stay resident in L1 during bulk decoding.
+ */
+
+/*
+ * Prefix classification table entries
+ *
+ * A non-zero entry marks a legacy prefix byte and combines:
+ * - bits 0-11:  the PrefixMask bit of the prefix
+ * - bits 16-18: offset of the InstructionInfo field that records the byte
+ * - bits 24-30: the FLAG_PREFIX_* bit reported in InstructionInfo.flags
+ */
+#define PREFIX_CLASS_FIELD_SHIFT    16
+#define PREFIX_CLASS_FIELD_MASK     0x7
+#define PREFIX_CLASS_FIELD(entry)   (((entry) >> PREFIX_CLASS_FIELD_SHIFT) & PREFIX_CLASS_FIELD_MASK)
+#define PREFIX_CLASS_ENTRY(mask, field, flag) \
+    ((uint32_t)(mask) | ((uint32_t)offsetof(InstructionInfo, field) << PREFIX_CLASS_FIELD_SHIFT) | (uint32_t)(flag))
+
+#define PC_LOCK     PREFIX_CLASS_ENTRY(PREFIX_LOCK, prefix_lock, FLAG_PREFIX_LOCK)
+#define PC_REPNZ    PREFIX_CLASS_ENTRY(PREFIX_REPNZ, prefix_rep, FLAG_PREFIX_REPNZ)
+#define PC_REP      PREFIX_CLASS_ENTRY(PREFIX_REP, prefix_rep, FLAG_PREFIX_REP)
+#define PC_OPSZ     PREFIX_CLASS_ENTRY(PREFIX_OP_SIZE, prefix_66, FLAG_PREFIX_OP_SIZE)
+#define PC_ADSZ     PREFIX_CLASS_ENTRY(PREFIX_ADDR_SIZE, prefix_67, FLAG_PREFIX_ADDR_SIZE)
+#define PC_ES       PREFIX_CLASS_ENTRY(PREFIX_SEG_ES, prefix_seg, FLAG_PREFIX_SEG)
+#define PC_CS       PREFIX_CLASS_ENTRY(PREFIX_SEG_CS, prefix_seg, FLAG_PREFIX_SEG)
+#define PC_SS       PREFIX_CLASS_ENTRY(PREFIX_SEG_SS, prefix_seg, FLAG_PREFIX_SEG)
+#define PC_DS       PREFIX_CLASS_ENTRY(PREFIX_SEG_DS, prefix_seg, FLAG_PREFIX_SEG)
+#define PC_FS       PREFIX_CLASS_ENTRY(PREFIX_SEG_FS, prefix_seg, FLAG_PREFIX_SEG)
+#define PC_GS       PREFIX_CLASS_ENTRY(PREFIX_SEG_GS, prefix_seg, FLAG_PREFIX_SEG)
+
+/*
+ * Prefix classification table (legacy prefixes only, REX is handled separately)
+ */
+static const uint32_t g_prefix_class_table[OPCODE_TABLE_SIZE] = {
+    /*         0        1        2        3        4        5        6        7        8        9        A        B        C        D        E        F */
+    /* 00 */   0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,
+    /* 10 */   0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,
+    /* 20 */   0,       0,       0,       0,       0,       0,       PC_ES,   0,       0,       0,       0,       0,       0,       0,       PC_CS,   0,
+    /* 30 */   0,       0,       0,       0,       0,       0,       PC_SS,   0,       0,       0,       0,       0,       0,       0,       PC_DS,   0,
+    /* 40 */   0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,
+    /* 50 */   0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,
+    /* 60 */   0,       0,       0,       0,       PC_FS,   PC_GS,   PC_OPSZ, PC_ADSZ, 0,       0,       0,       0,       0,       0,       0,       0,
+    /* 70 */   0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,
+    /* 80 */   0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,
+    /* 90 */   0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,
+    /* A0 */   0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,
+    /* B0 */   0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,
+    /* C0 */   0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,
+    /* D0 */   0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,
+    /* E0 */   0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,
+    /* F0 */   PC_LOCK, 0,       PC_REPNZ,PC_REP,  0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,       0,
+};
+
+/*
+ * Opcode decode-state bits
+ */
+typedef enum {
+    DECODE_NONE = 0x00,
+    DECODE_LOCK = 0x01,             // LOCK allowed (with a memory operand)
+    DECODE_MEMORY_ONLY = 0x02,      // ModR/M operand must be memory
+    DECODE_CHECK_OPERAND = 0x04,    // ModR/M reg field needs is_operand_valid()
+    DECODE_FPU = 0x08,              // x87 escape (D8-DF)
+    DECODE_MOFFS = 0x10,            // Address-sized memory offset follows (MOV A0-A3)
+    DECODE_VECTOR = 0x20            // May start a VEX/EVEX/XOP prefix (C4, C5, 62, 8F)
+} DecodeState;
+
+#define DS_L    DECODE_LOCK
+#define DS_M    DECODE_MEMORY_ONLY
+#define DS_O    DECODE_CHECK_OPERAND
+#define DS_F    DECODE_FPU
+#define DS_A    DECODE_MOFFS
+#define DS_V    DECODE_VECTOR
+#define DS_MV   (DECODE_MEMORY_ONLY | DECODE_VECTOR)
+
+/*
+ * Opcode decode-state table, indexed by [map][opcode]
+ * Map 0 is the 1-byte opcode map, map 1 the 0F xx map, maps 2 and 3 the
+ * 0F 38 xx and 0F 3A xx maps (see OpcodeMap).
+ */
+static const uint8_t g_opcode_decode_table[4][OPCODE_TABLE_SIZE] = {
+    {
+        /*         0     1     2     3     4     5     6     7     8     9     A     B     C     D     E     F */
+        /* 00 */   DS_L, DS_L, DS_L, DS_L, 0,    0,    0,    0,    DS_L, DS_L, DS_L, DS_L, 0,    0,    0,    0,    // ADD, OR
+        /* 10 */   DS_L, DS_L, DS_L, DS_L, 0,    0,    0,    0,    DS_L, DS_L, DS_L, DS_L, 0,    0,    0,    0,    // ADC, SBB
+        /* 20 */   DS_L, DS_L, DS_L, DS_L, 0,    0,    0,    0,    DS_L, DS_L, DS_L, DS_L, 0,    0,    0,    0,    // AND, SUB
+        /* 30 */   DS_L, DS_L, DS_L, DS_L, 0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    // XOR
+        /* 40 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 50 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 60 */   0,    0,    DS_MV,0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    // BOUND / EVEX
+        /* 70 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 80 */   DS_L, DS_L, DS_L, DS_L, 0,    0,    DS_L, DS_L, 0,    0,    0,    0,    DS_O, 0,    DS_O, DS_V, // Group 1, XCHG, MOV Sreg, POP / XOP
+        /* 90 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* A0 */   DS_A, DS_A, DS_A, DS_A, 0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    // MOV moffs
+        /* B0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* C0 */   0,    0,    0,    0,    DS_MV,DS_MV,0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    // LES, LDS / VEX
+        /* D0 */   0,    0,    0,    0,    0,    0,    0,    0,    DS_F, DS_F, DS_F, DS_F, DS_F, DS_F, DS_F, DS_F, // x87
+        /* E0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* F0 */   0,    0,    0,    0,    0,    0,    DS_L, DS_L, 0,    0,    0,    0,    0,    0,    DS_L, DS_L, // Group 3, Group 4/5
+    },
+    {
+        /*         0     1     2     3     4     5     6     7     8     9     A     B     C     D     E     F */
+        /* 00 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 10 */   0,    0,    0,    DS_M, 0,    0,    0,    DS_M, 0,    0,    0,    0,    0,    0,    0,    0,    // MOVLPS/MOVHPS stores
+        /* 20 */   DS_O, DS_O, DS_O, DS_O, 0,    0,    0,    0,    0,    0,    0,    DS_M, 0,    0,    0,    0,    // MOV CRn/DRn, MOVNTPS
+        /* 30 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 40 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 50 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 60 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 70 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 80 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 90 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* A0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    DS_L, 0,    0,    0,    0,    // BTS
+        /* B0 */   DS_L, DS_L, DS_M, DS_L, DS_M, DS_M, 0,    0,    0,    0,    DS_L, DS_L, 0,    0,    0,    0,    // CMPXCHG, LSS, BTR, LFS, LGS, Group 8, BTC
+        /* C0 */   DS_L, DS_L, 0,    DS_M, 0,    0,    0,    DS_L, 0,    0,    0,    0,    0,    0,    0,    0,    // XADD, MOVNTI, Group 9
+        /* D0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* E0 */   0,    0,    0,    0,    0,    0,    0,    DS_M, 0,    0,    0,    0,    0,    0,    0,    0,    // MOVNTQ/MOVNTDQ
+        /* F0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+    },
+    {
+        /*         0     1     2     3     4     5     6     7     8     9     A     B     C     D     E     F */
+        /* 00 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 10 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 20 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    DS_M, 0,    0,    0,    0,    0,    // MOVNTDQA
+        /* 30 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 40 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 50 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 60 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 70 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 80 */   DS_M, DS_M, DS_M, 0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    // INVEPT, INVVPID, INVPCID
+        /* 90 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* A0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* B0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* C0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* D0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* E0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* F0 */   0,    0,    0,    0,    0,    0,    0,    0,    DS_M, DS_M, 0,    0,    DS_M, 0,    0,    0,    // MOVDIR64B/ENQCMD, MOVDIRI, AADD/AAND/AOR/AXOR
+    },
+    {
+        /*         0     1     2     3     4     5     6     7     8     9     A     B     C     D     E     F */
+        /* 00 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 10 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 20 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 30 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 40 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 50 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 60 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 70 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 80 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* 90 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* A0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* B0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* C0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* D0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* E0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        /* F0 */   0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+    }
+};
@@ -0,0 +1,3218 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "disassm.h"
+#include "disassm_inst_bytes.h"
+#include "disassm_table_groups.h"
+#include "disassm_table_modes.h"
+
+/*
+ * Text formatter tables
+ *
+ * Every opcode maps to a FormatEntry. A plain entry holds the mnemonic and
+ * up to four operand codes; the other kinds name a row in one of the side
+ * tables below, which is indexed by a single property of the instruction
+ * (ModR/M.reg, mandatory prefix, operand size, ...). The formatter follows
+ * kinds until it reaches a plain entry, so resolving a mnemonic costs a few
+ * dependent loads and no string handling.
+ */
+
+/*
+ * Operand codes
+ * Named after the SDM opcode map notation: addressing method, then size.
+ */
+typedef enum {
+    OPND_NONE = 0,
+
+    // ModR/M general purpose register or memory
+    OPND_Eb,                // r/m8
+    OPND_Ew,                // r/m16
+    OPND_Ed,                // r/m32
+    OPND_Ev,                // r/m16/32/64 by operand size
+    OPND_Ey,                // r/m32/64 (REX.W/VEX.W)
+    OPND_Edb,               // r32 or m8 (PEXTRB, PINSRB)
+    OPND_Edw,               // r32 or m16 (PEXTRW, PINSRW)
+    OPND_Gb,                // ModR/M.reg r8
+    OPND_Gw,                // ModR/M.reg r16
+    OPND_Gd,                // ModR/M.reg r32
+    OPND_Gv,                // ModR/M.reg r16/32/64
+    OPND_Gy,                // ModR/M.reg r32/64
+    OPND_Gq64,              // ModR/M.reg r64 in 64-bit mode, r32 otherwise
+    OPND_Rd,                // ModR/M.rm r32 (register form only)
+    OPND_Rv,                // ModR/M.rm r16/32/64
+    OPND_Ry,                // ModR/M.rm r32/64
+    OPND_Rq64,              // ModR/M.rm r64 in 64-bit mode, r32 otherwise
+    OPND_By,                // VEX.vvvv r32/64
+
+    // ModR/M memory only
+    OPND_M,                 // No size
+    OPND_Mw,                // m16
+    OPND_Md,                // m32
+    OPND_Mb,                // m8
+    OPND_Mdq,               // m128
+    OPND_Mp,                // Far pointer m16:16/32/64
+    OPND_Mq,                // m64
+    OPND_Mv,                // m16/32/64
+    OPND_Mx,                // m128/256/512 by vector length
+    OPND_My,                // m32/64
+
+    // x87 memory
+    OPND_Mfs,               // m32fp
+    OPND_Mfd,               // m64fp
+    OPND_Mft,               // m80fp
+    OPND_Miw,               // m16int
+    OPND_Mid,               // m32int
+    OPND_Miq,               // m64int
+    OPND_Mbcd,              // m80bcd
+
+    // Immediates and branch targets
+    OPND_Ib,                // imm8
+    OPND_Ibs,               // imm8 sign-extended to the operand size
+    OPND_Ib2,               // imm8 after an imm16 (ENTER)
+    OPND_Iw,                // imm16
+    OPND_Iz,                // imm16/32, sign-extended to 64 bits
+    OPND_Iv,                // imm16/32/64
+    OPND_1,                 // Constant 1 (shift by one)
+    OPND_Jb,                // rel8
+    OPND_Jz,                // rel16/32
+    OPND_Ap,                // ptr16:16/32
+    OPND_Ob,                // moffs8
+    OPND_Ov,                // moffs16/32/64
+
+    // Register in the low three opcode bits
+    OPND_Zb,                // r8
+    OPND_Zv,                // r16/32/64
+    OPND_Zy,                // r32/64
+
+    // Fixed registers
+    OPND_AL,
+    OPND_CL,
+    OPND_AX,
+    OPND_DX,                // I/O port
+    OPND_eAX,               // AX or EAX
+    OPND_rAX,               // AX, EAX or RAX
+    OPND_ES,
+    OPND_CS,
+    OPND_SS,
+    OPND_DS,
+    OPND_FS,
+    OPND_GS,
+    OPND_ST0,               // ST(0), printed as "st"
+    OPND_STi,               // ST(ModR/M.rm)
+
+    // System registers
+    OPND_Sw,                // ModR/M.reg segment register
+    OPND_Cd,                // ModR/M.reg control register
+    OPND_Dd,                // ModR/M.reg debug register
+
+    // String operands
+    OPND_Xb,                // m8 at DS:rSI
+    OPND_Xv,                // m16/32/64 at DS:rSI
+    OPND_Xz,                // m16/32 at DS:rSI
+    OPND_Yb,                // m8 at ES:rDI
+    OPND_Yv,                // m16/32/64 at ES:rDI
+    OPND_Yz,                // m16/32 at ES:rDI
+
+    // MMX
+    OPND_Pq,                // ModR/M.reg mm
+    OPND_Qq,                // ModR/M.rm mm or m64
+    OPND_Nq,                // ModR/M.rm mm (register form only)
+
+    // Vector registers; entries with any of these have FMT_SSE
+    OPND_VECTOR_FIRST,
+    OPND_Pxm = OPND_VECTOR_FIRST,   // mm, or a vector register with 66/VEX/EVEX
+    OPND_Qxm,               // mm/m64, or a vector register/memory with 66/VEX/EVEX
+    OPND_Nxm,               // mm, or a vector register with 66/VEX/EVEX (register form only)
+    OPND_PK,                // Like Pxm, an opmask register under EVEX
+    OPND_VK,                // Like Vx, an opmask register under EVEX
+    OPND_Vx,                // ModR/M.reg vector register by vector length
+    OPND_Vdq,               // ModR/M.reg xmm
+    OPND_Vh,                // ModR/M.reg of half the vector length
+    OPND_Wx,                // ModR/M.rm vector register or memory by vector length
+    OPND_Wdq,               // xmm/m128
+    OPND_Wh,                // Half the vector length
+    OPND_Wqt,               // Quarter of the vector length
+    OPND_Wo,                // Eighth of the vector length
+    OPND_Wq,                // xmm/m64
+    OPND_Wd,                // xmm/m32
+    OPND_Ww,                // xmm/m16
+    OPND_Wb,                // xmm/m8
+    OPND_Wsx,               // xmm/m32/64 by VEX.W (FMA scalar)
+    OPND_Ux,                // ModR/M.rm vector register (register form only)
+    OPND_Udq,               // ModR/M.rm xmm (register form only)
+    OPND_Hx,                // VEX.vvvv vector register (vector encodings only)
+    OPND_Hdq,               // VEX.vvvv xmm (vector encodings only)
+    OPND_Hr,                // VEX.vvvv xmm (vector encodings, register form only)
+    OPND_Lx,                // Vector register in imm8[7:4]
+    OPND_XMM0,              // Implicit XMM0 (legacy encodings only)
+    OPND_KG,                // ModR/M.reg opmask register
+    OPND_KE,                // ModR/M.rm opmask register or memory
+    OPND_KH,                // VEX.vvvv opmask register
+    OPND_MVsib,             // VSIB memory
+    OPND_COUNT
+} FormatOperand;
+
+/*
+ * Entry kinds (FormatEntry flags bits 8-11)
+ */
+typedef enum {
+    FMT_KIND_PLAIN = 0,     // Mnemonic and operands
+    FMT_KIND_BAD,           // Undefined encoding, printed as "(bad)"
+    FMT_KIND_GROUP,         // g_format_group_table[index][ModR/M.reg]
+    FMT_KIND_PREFIX,        // g_format_prefix_table[index][mandatory prefix]
+    FMT_KIND_SIZE,          // g_format_size_table[index][operand size]
+    FMT_KIND_ADDR,          // g_format_size_table[index][address size]
+    FMT_KIND_MOD,           // g_format_mod_table[index][register form]
+    FMT_KIND_MODRM,         // g_format_modrm_table from index, by ModR/M byte
+    FMT_KIND_SYNTAX,        // g_format_syntax_table[index][syntax]
+    FMT_KIND_VEXL,          // g_format_vexl_table[index][encoding and VEX.L]
+    FMT_KIND_MODE,          // g_format_mode_table[index][64-bit mode]
+    FMT_KIND_FPU            // g_format_fpu_table[register form][opcode - D8][ModR/M.reg]
+} FormatKind;
+
+/*
+ * Entry flags
+ */
+typedef enum {
+    FMT_D64 = 0x0001,       // Operand size defaults to 64 bits in 64-bit mode
+    FMT_REP = 0x0002,       // F3 prints as "rep"
+    FMT_REPZ = 0x0004,      // F3/F2 print as "repe"/"repne"
+    FMT_NO_V = 0x0008,      // VEX-encoded general purpose instruction, no "v"
+    FMT_INDIRECT = 0x0010,  // Indirect branch ('*' in AT&T syntax)
+    FMT_FAR = 0x0020,       // Far branch ("l" prefix in AT&T syntax)
+    FMT_ATT_MOVX = 0x0040,  // AT&T names the source and destination sizes (movzbl)
+    FMT_SSE = 0x0080,       // Has a vector operand; valid with VEX/EVEX
+
+    // FormatKind (bits 8-11)
+    FMT_KIND_SHIFT = 8,
+    FMT_KIND_MASK = 0x0F00,
+
+    FMT_NO_SUFFIX = 0x1000, // No AT&T size suffix (the size is implied)
+
+    // Mnemonic suffix selected by VEX.W (bits 13-15)
+    FMT_SUFFIX_SHIFT = 13,
+    FMT_SUFFIX_DQ = 1 << 13,        // d/q
+    FMT_SUFFIX_SD = 2 << 13,        // s/d
+    FMT_SUFFIX_BW = 3 << 13,        // b/w
+    FMT_SUFFIX_EVEX_3264 = 4 << 13, // 32/64, EVEX only
+    FMT_SUFFIX_EVEX_816 = 5 << 13,  // 8/16, EVEX only
+    FMT_SUFFIX_EVEX_DQ = 6 << 13,   // d/q, EVEX only
+    FMT_SUFFIX_K = 7 << 13          // Opmask size by VEX.pp and VEX.W: b/w/d/q
+} FormatFlag;
+
+#define FMT_KIND(entry) (((entry)->flags & FMT_KIND_MASK) >> FMT_KIND_SHIFT)
+#define FMT_SUFFIX(entry) ((entry)->flags >> FMT_SUFFIX_SHIFT)
+
+/*
+ * Format entry (24 bytes)
+ *
+ * The mnemonic is padded to 16 bytes so it is copied with one 16-byte move.
+ */
+typedef struct {
+    char mnemonic[16];      // Not NUL-terminated
+    uint8_t length;         // Mnemonic length
+    uint8_t index;          // Row selected by the kind
+    uint16_t flags;         // FormatFlag bits and FormatKind
+    uint8_t operands[4];    // FormatOperand codes, OPND_NONE after the last one
+} FormatEntry;
+
+/*
+ * Exact ModR/M list row
+ */
+typedef struct {
+    uint8_t modrm;
+    FormatEntry entry;
+} FormatModrmRow;
+
+/*
+ * Entry constructors
+ */
+constexpr unsigned int fmt_vector_flag(unsigned int operand) {
+    return operand >= OPND_VECTOR_FIRST ? FMT_SSE : 0;
+}
+
+template <size_t N>
+constexpr FormatEntry fmt(const char (&name)[N], unsigned int flags, uint8_t op1 = OPND_NONE,
+    uint8_t op2 = OPND_NONE, uint8_t op3 = OPND_NONE, uint8_t op4 = OPND_NONE) {
+    static_assert(N <= 17, "mnemonic longer than 16 characters");
+    FormatEntry entry = {};
+
+    for (size_t i = 0; i + 1 < N; i++) {
+        entry.mnemonic[i] = name[i];
+    }
+    entry.length = (uint8_t)(N - 1);
+    entry.flags = (uint16_t)(flags | fmt_vector_flag(op1) | fmt_vector_flag(op2) |
+        fmt_vector_flag(op3) | fmt_vector_flag(op4));
+    entry.operands[0] = op1;
+    entry.operands[1] = op2;
+    entry.operands[2] = op3;
+    entry.operands[3] = op4;
+    return entry;
+}
+
+constexpr FormatEntry fmt_kind(unsigned int kind, unsigned int index, unsigned int flags = 0) {
+    FormatEntry entry = {};
+    entry.index = (uint8_t)index;
+    entry.flags = (uint16_t)(flags | (kind << FMT_KIND_SHIFT));
+    return entry;
+}
+
+constexpr FormatEntry fmt_bad() {
+    return fmt_kind(FMT_KIND_BAD, 0);
+}
+
+/*
+ * Format group rows beyond the decoder groups (GroupRow)
+ */
+typedef enum {
+    GRP_VEX_0F38F3 = GROUP_ROW_COUNT,
+    FORMAT_GROUP_ROW_COUNT
+} FormatGroupRow;
+
+/*
+ * Mandatory prefix rows (g_format_prefix_table)
+ */
+typedef enum {
+    PFX_90 = 0,
+    PFX_0F10,
+    PFX_0F11,
+    PFX_0F12,
+    PFX_0F13,
+    PFX_0F14,
+    PFX_0F15,
+    PFX_0F16,
+    PFX_0F17,
+    PFX_0F1E,
+    PFX_0F28,
+    PFX_0F29,
+    PFX_0F2A,
+    PFX_0F2B,
+    PFX_0F2C,
+    PFX_0F2D,
+    PFX_0F2E,
+    PFX_0F2F,
+    PFX_0F50,
+    PFX_0F51,
+    PFX_0F52,
+    PFX_0F53,
+    PFX_0F54,
+    PFX_0F55,
+    PFX_0F56,
+    PFX_0F57,
+    PFX_0F58,
+    PFX_0F59,
+    PFX_0F5A,
+    PFX_0F5B,
+    PFX_0F5C,
+    PFX_0F5D,
+    PFX_0F5E,
+    PFX_0F5F,
+    PFX_0F6C,
+    PFX_0F6D,
+    PFX_0F6E,
+    PFX_0F6F,
+    PFX_0F70,
+    PFX_0F7C,
+    PFX_0F7D,
+    PFX_0F7E,
+    PFX_0F7F,
+    PFX_F30FAE_0,
+    PFX_F30FAE_1,
+    PFX_F30FAE_2,
+    PFX_F30FAE_3,
+    PFX_0FB8,
+    PFX_0FBC,
+    PFX_0FBD,
+    PFX_0FC2,
+    PFX_0FC4,
+    PFX_0FC5,
+    PFX_0FC6,
+    PFX_0FC7_7,
+    PFX_0FD0,
+    PFX_0FD6,
+    PFX_0FE6,
+    PFX_0FE7,
+    PFX_0FF0,
+    PFX_0FF7,
+    PFX_0F3826,
+    PFX_0F3827,
+    PFX_0F38F0,
+    PFX_0F38F1,
+    PFX_0F38F5,
+    PFX_0F38F6,
+    PFX_0F38F7,
+    PFX_0F38F8,
+    FORMAT_PREFIX_ROW_COUNT
+} FormatPrefixRow;
+
+/*
+ * Operand/address size rows (g_format_size_table)
+ */
+typedef enum {
+    SIZE_60 = 0,
+    SIZE_61,
+    SIZE_98,
+    SIZE_99,
+    SIZE_9C,
+    SIZE_9D,
+    SIZE_CF,
+    SIZE_E3,
+    SIZE_0FC7_1,
+    FORMAT_SIZE_ROW_COUNT
+} FormatSizeRow;
+
+/*
+ * Memory/register form rows (g_format_mod_table)
+ */
+typedef enum {
+    MOD_C6_7 = 0,
+    MOD_C7_7,
+    MOD_0F01_0,
+    MOD_0F01_1,
+    MOD_0F01_2,
+    MOD_0F01_3,
+    MOD_0F01_5,
+    MOD_0F01_7,
+    MOD_0F12,
+    MOD_0F16,
+    MOD_0FAE_0,
+    MOD_0FAE_1,
+    MOD_0FAE_2,
+    MOD_0FAE_3,
+    MOD_0FAE_4,
+    MOD_0FAE_5,
+    MOD_0FAE_6,
+    MOD_0FAE_7,
+    MOD_0FC7_1,
+    MOD_0FC7_3,
+    MOD_0FC7_4,
+    MOD_0FC7_5,
+    MOD_0FC7_6,
+    MOD_0FC7_7,
+    FORMAT_MOD_ROW_COUNT
+} FormatModRow;
+
+/*
+ * Syntax-specific mnemonic rows (g_format_syntax_table)
+ */
+typedef enum {
+    SYN_CBW = 0,
+    SYN_CWDE,
+    SYN_CDQE,
+    SYN_CWD,
+    SYN_CDQ,
+    SYN_CQO,
+    SYN_CA,
+    SYN_CB,
+    SYN_DC_4,
+    SYN_DC_5,
+    SYN_DC_6,
+    SYN_DC_7,
+    SYN_DE_4,
+    SYN_DE_5,
+    SYN_DE_6,
+    SYN_DE_7,
+    FORMAT_SYNTAX_ROW_COUNT
+} FormatSyntaxRow;
+
+/*
+ * Vector length rows (g_format_vexl_table)
+ */
+typedef enum {
+    VEXL_0F41 = 0,
+    VEXL_0F42,
+    VEXL_0F44,
+    VEXL_0F45,
+    VEXL_0F46,
+    VEXL_0F47,
+    VEXL_0F4A,
+    VEXL_0F90,
+    VEXL_0F91,
+    VEXL_0F92,
+    VEXL_0F93,
+    VEXL_0F98,
+    VEXL_0F99,
+    VEXL_0F77,
+    FORMAT_VEXL_ROW_COUNT
+} FormatVexlRow;
+
+/*
+ * CPU mode rows (g_format_mode_table)
+ */
+typedef enum {
+    MODE_63 = 0,
+    FORMAT_MODE_ROW_COUNT
+} FormatModeRow;
+
+/*
+ * Exact ModR/M lists (g_format_modrm_table), by first row
+ */
+typedef enum {
+    MRM_C6F8 = 0,
+    MRM_C7F8 = 2,
+    MRM_0F01 = 4,
+    MRM_F30F1E = 38,
+    MRM_D9_2 = 41,
+    MRM_D9_4 = 43,
+    MRM_D9_5 = 48,
+    MRM_D9_6 = 56,
+    MRM_D9_7 = 65,
+    MRM_DA_5 = 74,
+    MRM_DB_4 = 76,
+    MRM_DE_3 = 79,
+    MRM_DF_4 = 81,
+    FORMAT_MODRM_ROW_COUNT = 83
+} FormatModrmList;
+
+/*
+ * 1-byte opcodes
+ */
+static constexpr FormatEntry g_format_map_1byte[OPCODE_TABLE_SIZE] = {
+    /* 00 */ fmt("add", 0, OPND_Eb, OPND_Gb),
+    /* 01 */ fmt("add", 0, OPND_Ev, OPND_Gv),
+    /* 02 */ fmt("add", 0, OPND_Gb, OPND_Eb),
+    /* 03 */ fmt("add", 0, OPND_Gv, OPND_Ev),
+    /* 04 */ fmt("add", 0, OPND_AL, OPND_Ib),
+    /* 05 */ fmt("add", 0, OPND_rAX, OPND_Iz),
+    /* 06 */ fmt("push", 0, OPND_ES),
+    /* 07 */ fmt("pop", 0, OPND_ES),
+    /* 08 */ fmt("or", 0, OPND_Eb, OPND_Gb),
+    /* 09 */ fmt("or", 0, OPND_Ev, OPND_Gv),
+    /* 0A */ fmt("or", 0, OPND_Gb, OPND_Eb),
+    /* 0B */ fmt("or", 0, OPND_Gv, OPND_Ev),
+    /* 0C */ fmt("or", 0, OPND_AL, OPND_Ib),
+    /* 0D */ fmt("or", 0, OPND_rAX, OPND_Iz),
+    /* 0E */ fmt("push", 0, OPND_CS),
+    /* 0F */ fmt_bad(),
+
+    /* 10 */ fmt("adc", 0, OPND_Eb, OPND_Gb),
+    /* 11 */ fmt("adc", 0, OPND_Ev, OPND_Gv),
+    /* 12 */ fmt("adc", 0, OPND_Gb, OPND_Eb),
+    /* 13 */ fmt("adc", 0, OPND_Gv, OPND_Ev),
+    /* 14 */ fmt("adc", 0, OPND_AL, OPND_Ib),
+    /* 15 */ fmt("adc", 0, OPND_rAX, OPND_Iz),
+    /* 16 */ fmt("push", 0, OPND_SS),
+    /* 17 */ fmt("pop", 0, OPND_SS),
+    /* 18 */ fmt("sbb", 0, OPND_Eb, OPND_Gb),
+    /* 19 */ fmt("sbb", 0, OPND_Ev, OPND_Gv),
+    /* 1A */ fmt("sbb", 0, OPND_Gb, OPND_Eb),
+    /* 1B */ fmt("sbb", 0, OPND_Gv, OPND_Ev),
+    /* 1C */ fmt("sbb", 0, OPND_AL, OPND_Ib),
+    /* 1D */ fmt("sbb", 0, OPND_rAX, OPND_Iz),
+    /* 1E */ fmt("push", 0, OPND_DS),
+    /* 1F */ fmt("pop", 0, OPND_DS),
+
+    /* 20 */ fmt("and", 0, OPND_Eb, OPND_Gb),
+    /* 21 */ fmt("and", 0, OPND_Ev, OPND_Gv),
+    /* 22 */ fmt("and", 0, OPND_Gb, OPND_Eb),
+    /* 23 */ fmt("and", 0, OPND_Gv, OPND_Ev),
+    /* 24 */ fmt("and", 0, OPND_AL, OPND_Ib),
+    /* 25 */ fmt("and", 0, OPND_rAX, OPND_Iz),
+    /* 26 */ fmt_bad(),
+    /* 27 */ fmt("daa", 0),
+    /* 28 */ fmt("sub", 0, OPND_Eb, OPND_Gb),
+    /* 29 */ fmt("sub", 0, OPND_Ev, OPND_Gv),
+    /* 2A */ fmt("sub", 0, OPND_Gb, OPND_Eb),
+    /* 2B */ fmt("sub", 0, OPND_Gv, OPND_Ev),
+    /* 2C */ fmt("sub", 0, OPND_AL, OPND_Ib),
+    /* 2D */ fmt("sub", 0, OPND_rAX, OPND_Iz),
+    /* 2E */ fmt_bad(),
+    /* 2F */ fmt("das", 0),
+
+    /* 30 */ fmt("xor", 0, OPND_Eb, OPND_Gb),
+    /* 31 */ fmt("xor", 0, OPND_Ev, OPND_Gv),
+    /* 32 */ fmt("xor", 0, OPND_Gb, OPND_Eb),
+    /* 33 */ fmt("xor", 0, OPND_Gv, OPND_Ev),
+    /* 34 */ fmt("xor", 0, OPND_AL, OPND_Ib),
+    /* 35 */ fmt("xor", 0, OPND_rAX, OPND_Iz),
+    /* 36 */ fmt_bad(),
+    /* 37 */ fmt("aaa", 0),
+    /* 38 */ fmt("cmp", 0, OPND_Eb, OPND_Gb),
+    /* 39 */ fmt("cmp", 0, OPND_Ev, OPND_Gv),
+    /* 3A */ fmt("cmp", 0, OPND_Gb, OPND_Eb),
+    /* 3B */ fmt("cmp", 0, OPND_Gv, OPND_Ev),
+    /* 3C */ fmt("cmp", 0, OPND_AL, OPND_Ib),
+    /* 3D */ fmt("cmp", 0, OPND_rAX, OPND_Iz),
+    /* 3E */ fmt_bad(),
+    /* 3F */ fmt("aas", 0),
+
+    /* 40 */ fmt("inc", 0, OPND_Zv),
+    /* 41 */ fmt("inc", 0, OPND_Zv),
+    /* 42 */ fmt("inc", 0, OPND_Zv),
+    /* 43 */ fmt("inc", 0, OPND_Zv),
+    /* 44 */ fmt("inc", 0, OPND_Zv),
+    /* 45 */ fmt("inc", 0, OPND_Zv),
+    /* 46 */ fmt("inc", 0, OPND_Zv),
+    /* 47 */ fmt("inc", 0, OPND_Zv),
+    /* 48 */ fmt("dec", 0, OPND_Zv),
+    /* 49 */ fmt("dec", 0, OPND_Zv),
+    /* 4A */ fmt("dec", 0, OPND_Zv),
+    /* 4B */ fmt("dec", 0, OPND_Zv),
+    /* 4C */ fmt("dec", 0, OPND_Zv),
+    /* 4D */ fmt("dec", 0, OPND_Zv),
+    /* 4E */ fmt("dec", 0, OPND_Zv),
+    /* 4F */ fmt("dec", 0, OPND_Zv),
+
+    /* 50 */ fmt("push", FMT_D64, OPND_Zv),
+    /* 51 */ fmt("push", FMT_D64, OPND_Zv),
+    /* 52 */ fmt("push", FMT_D64, OPND_Zv),
+    /* 53 */ fmt("push", FMT_D64, OPND_Zv),
+    /* 54 */ fmt("push", FMT_D64, OPND_Zv),
+    /* 55 */ fmt("push", FMT_D64, OPND_Zv),
+    /* 56 */ fmt("push", FMT_D64, OPND_Zv),
+    /* 57 */ fmt("push", FMT_D64, OPND_Zv),
+    /* 58 */ fmt("pop", FMT_D64, OPND_Zv),
+    /* 59 */ fmt("pop", FMT_D64, OPND_Zv),
+    /* 5A */ fmt("pop", FMT_D64, OPND_Zv),
+    /* 5B */ fmt("pop", FMT_D64, OPND_Zv),
+    /* 5C */ fmt("pop", FMT_D64, OPND_Zv),
+    /* 5D */ fmt("pop", FMT_D64, OPND_Zv),
+    /* 5E */ fmt("pop", FMT_D64, OPND_Zv),
+    /* 5F */ fmt("pop", FMT_D64, OPND_Zv),
+
+    /* 60 */ fmt_kind(FMT_KIND_SIZE, SIZE_60),
+    /* 61 */ fmt_kind(FMT_KIND_SIZE, SIZE_61),
+    /* 62 */ fmt("bound", 0, OPND_Gv, OPND_M),
+    /* 63 */ fmt_kind(FMT_KIND_MODE, MODE_63),
+    /* 64 */ fmt_bad(),
+    /* 65 */ fmt_bad(),
+    /* 66 */ fmt_bad(),
+    /* 67 */ fmt_bad(),
+    /* 68 */ fmt("push", FMT_D64, OPND_Iz),
+    /* 69 */ fmt("imul", 0, OPND_Gv, OPND_Ev, OPND_Iz),
+    /* 6A */ fmt("push", FMT_D64, OPND_Ibs),
+    /* 6B */ fmt("imul", 0, OPND_Gv, OPND_Ev, OPND_Ibs),
+    /* 6C */ fmt("ins", FMT_REP, OPND_Yb, OPND_DX),
+    /* 6D */ fmt("ins", FMT_REP, OPND_Yz, OPND_DX),
+    /* 6E */ fmt("outs", FMT_REP, OPND_DX, OPND_Xb),
+    /* 6F */ fmt("outs", FMT_REP, OPND_DX, OPND_Xz),
+
+    /* 70 */ fmt("jo", 0, OPND_Jb),
+    /* 71 */ fmt("jno", 0, OPND_Jb),
+    /* 72 */ fmt("jb", 0, OPND_Jb),
+    /* 73 */ fmt("jae", 0, OPND_Jb),
+    /* 74 */ fmt("je", 0, OPND_Jb),
+    /* 75 */ fmt("jne", 0, OPND_Jb),
+    /* 76 */ fmt("jbe", 0, OPND_Jb),
+    /* 77 */ fmt("ja", 0, OPND_Jb),
+    /* 78 */ fmt("js", 0, OPND_Jb),
+    /* 79 */ fmt("jns", 0, OPND_Jb),
+    /* 7A */ fmt("jp", 0, OPND_Jb),
+    /* 7B */ fmt("jnp", 0, OPND_Jb),
+    /* 7C */ fmt("jl", 0, OPND_Jb),
+    /* 7D */ fmt("jge", 0, OPND_Jb),
+    /* 7E */ fmt("jle", 0, OPND_Jb),
+    /* 7F */ fmt("jg", 0, OPND_Jb),
+
+    /* 80 */ fmt_kind(FMT_KIND_GROUP, GRP_80),
+    /* 81 */ fmt_kind(FMT_KIND_GROUP, GRP_81),
+    /* 82 */ fmt_kind(FMT_KIND_GROUP, GRP_80),
+    /* 83 */ fmt_kind(FMT_KIND_GROUP, GRP_83),
+    /* 84 */ fmt("test", 0, OPND_Eb, OPND_Gb),
+    /* 85 */ fmt("test", 0, OPND_Ev, OPND_Gv),
+    /* 86 */ fmt("xchg", 0, OPND_Eb, OPND_Gb),
+    /* 87 */ fmt("xchg", 0, OPND_Ev, OPND_Gv),
+    /* 88 */ fmt("mov", 0, OPND_Eb, OPND_Gb),
+    /* 89 */ fmt("mov", 0, OPND_Ev, OPND_Gv),
+    /* 8A */ fmt("mov", 0, OPND_Gb, OPND_Eb),
+    /* 8B */ fmt("mov", 0, OPND_Gv, OPND_Ev),
+    /* 8C */ fmt("mov", 0, OPND_Ew, OPND_Sw),
+    /* 8D */ fmt("lea", 0, OPND_Gv, OPND_M),
+    /* 8E */ fmt("mov", 0, OPND_Sw, OPND_Ew),
+    /* 8F */ fmt_kind(FMT_KIND_GROUP, GRP_8F),
+
+    /* 90 */ fmt_kind(FMT_KIND_PREFIX, PFX_90),
+    /* 91 */ fmt("xchg", 0, OPND_Zv, OPND_rAX),
+    /* 92 */ fmt("xchg", 0, OPND_Zv, OPND_rAX),
+    /* 93 */ fmt("xchg", 0, OPND_Zv, OPND_rAX),
+    /* 94 */ fmt("xchg", 0, OPND_Zv, OPND_rAX),
+    /* 95 */ fmt("xchg", 0, OPND_Zv, OPND_rAX),
+    /* 96 */ fmt("xchg", 0, OPND_Zv, OPND_rAX),
+    /* 97 */ fmt("xchg", 0, OPND_Zv, OPND_rAX),
+    /* 98 */ fmt_kind(FMT_KIND_SIZE, SIZE_98),
+    /* 99 */ fmt_kind(FMT_KIND_SIZE, SIZE_99),
+    /* 9A */ fmt("call", FMT_FAR, OPND_Ap),
+    /* 9B */ fmt("fwait", 0),
+    /* 9C */ fmt_kind(FMT_KIND_SIZE, SIZE_9C, FMT_D64),
+    /* 9D */ fmt_kind(FMT_KIND_SIZE, SIZE_9D, FMT_D64),
+    /* 9E */ fmt("sahf", 0),
+    /* 9F */ fmt("lahf", 0),
+
+    /* A0 */ fmt("mov", 0, OPND_AL, OPND_Ob),
+    /* A1 */ fmt("mov", 0, OPND_rAX, OPND_Ov),
+    /* A2 */ fmt("mov", 0, OPND_Ob, OPND_AL),
+    /* A3 */ fmt("mov", 0, OPND_Ov, OPND_rAX),
+    /* A4 */ fmt("movs", FMT_REP, OPND_Yb, OPND_Xb),
+    /* A5 */ fmt("movs", FMT_REP, OPND_Yv, OPND_Xv),
+    /* A6 */ fmt("cmps", FMT_REPZ, OPND_Xb, OPND_Yb),
+    /* A7 */ fmt("cmps", FMT_REPZ, OPND_Xv, OPND_Yv),
+    /* A8 */ fmt("test", 0, OPND_AL, OPND_Ib),
+    /* A9 */ fmt("test", 0, OPND_rAX, OPND_Iz),
+    /* AA */ fmt("stos", FMT_REP, OPND_Yb, OPND_AL),
+    /* AB */ fmt("stos", FMT_REP, OPND_Yv, OPND_rAX),
+    /* AC */ fmt("lods", FMT_REP, OPND_AL, OPND_Xb),
+    /* AD */ fmt("lods", FMT_REP, OPND_rAX, OPND_Xv),
+    /* AE */ fmt("scas", FMT_REPZ, OPND_AL, OPND_Yb),
+    /* AF */ fmt("scas", FMT_REPZ, OPND_rAX, OPND_Yv),
+
+    /* B0 */ fmt("mov", 0, OPND_Zb, OPND_Ib),
+    /* B1 */ fmt("mov", 0, OPND_Zb, OPND_Ib),
+    /* B2 */ fmt("mov", 0, OPND_Zb, OPND_Ib),
+    /* B3 */ fmt("mov", 0, OPND_Zb, OPND_Ib),
+    /* B4 */ fmt("mov", 0, OPND_Zb, OPND_Ib),
+    /* B5 */ fmt("mov", 0, OPND_Zb, OPND_Ib),
+    /* B6 */ fmt("mov", 0, OPND_Zb, OPND_Ib),
+    /* B7 */ fmt("mov", 0, OPND_Zb, OPND_Ib),
+    /* B8 */ fmt("mov", 0, OPND_Zv, OPND_Iv),
+    /* B9 */ fmt("mov", 0, OPND_Zv, OPND_Iv),
+    /* BA */ fmt("mov", 0, OPND_Zv, OPND_Iv),
+    /* BB */ fmt("mov", 0, OPND_Zv, OPND_Iv),
+    /* BC */ fmt("mov", 0, OPND_Zv, OPND_Iv),
+    /* BD */ fmt("mov", 0, OPND_Zv, OPND_Iv),
+    /* BE */ fmt("mov", 0, OPND_Zv, OPND_Iv),
+    /* BF */ fmt("mov", 0, OPND_Zv, OPND_Iv),
+
+    /* C0 */ fmt_kind(FMT_KIND_GROUP, GRP_C0),
+    /* C1 */ fmt_kind(FMT_KIND_GROUP, GRP_C1),
+    /* C2 */ fmt("ret", FMT_D64, OPND_Iw),
+    /* C3 */ fmt("ret", FMT_D64),
+    /* C4 */ fmt("les", 0, OPND_Gv, OPND_Mp),
+    /* C5 */ fmt("lds", 0, OPND_Gv, OPND_Mp),
+    /* C6 */ fmt_kind(FMT_KIND_GROUP, GRP_C6),
+    /* C7 */ fmt_kind(FMT_KIND_GROUP, GRP_C7),
+    /* C8 */ fmt("enter", 0, OPND_Iw, OPND_Ib2),
+    /* C9 */ fmt("leave", FMT_D64),
+    /* CA */ fmt_kind(FMT_KIND_SYNTAX, SYN_CA),
+    /* CB */ fmt_kind(FMT_KIND_SYNTAX, SYN_CB),
+    /* CC */ fmt("int3", 0),
+    /* CD */ fmt("int", 0, OPND_Ib),
+    /* CE */ fmt("into", 0),
+    /* CF */ fmt_kind(FMT_KIND_SIZE, SIZE_CF),
+
+    /* D0 */ fmt_kind(FMT_KIND_GROUP, GRP_D0),
+    /* D1 */ fmt_kind(FMT_KIND_GROUP, GRP_D1),
+    /* D2 */ fmt_kind(FMT_KIND_GROUP, GRP_D2),
+    /* D3 */ fmt_kind(FMT_KIND_GROUP, GRP_D3),
+    /* D4 */ fmt("aam", 0, OPND_Ib),
+    /* D5 */ fmt("aad", 0, OPND_Ib),
+    /* D6 */ fmt("salc", 0),
+    /* D7 */ fmt("xlatb", 0),
+    /* D8 */ fmt_kind(FMT_KIND_FPU, 0),
+    /* D9 */ fmt_kind(FMT_KIND_FPU, 0),
+    /* DA */ fmt_kind(FMT_KIND_FPU, 0),
+    /* DB */ fmt_kind(FMT_KIND_FPU, 0),
+    /* DC */ fmt_kind(FMT_KIND_FPU, 0),
+    /* DD */ fmt_kind(FMT_KIND_FPU, 0),
+    /* DE */ fmt_kind(FMT_KIND_FPU, 0),
+    /* DF */ fmt_kind(FMT_KIND_FPU, 0),
+
+    /* E0 */ fmt("loopne", 0, OPND_Jb),
+    /* E1 */ fmt("loope", 0, OPND_Jb),
+    /* E2 */ fmt("loop", 0, OPND_Jb),
+    /* E3 */ fmt_kind(FMT_KIND_ADDR, SIZE_E3),
+    /* E4 */ fmt("in", 0, OPND_AL, OPND_Ib),
+    /* E5 */ fmt("in", 0, OPND_eAX, OPND_Ib),
+    /* E6 */ fmt("out", 0, OPND_Ib, OPND_AL),
+    /* E7 */ fmt("out", 0, OPND_Ib, OPND_eAX),
+    /* E8 */ fmt("call", FMT_D64, OPND_Jz),
+    /* E9 */ fmt("jmp", FMT_D64, OPND_Jz),
+    /* EA */ fmt("jmp", FMT_FAR, OPND_Ap),
+    /* EB */ fmt("jmp", 0, OPND_Jb),
+    /* EC */ fmt("in", 0, OPND_AL, OPND_DX),
+    /* ED */ fmt("in", 0, OPND_eAX, OPND_DX),
+    /* EE */ fmt("out", 0, OPND_DX, OPND_AL),
+    /* EF */ fmt("out", 0, OPND_DX, OPND_eAX),
+
+    /* F0 */ fmt_bad(),
+    /* F1 */ fmt("int1", 0),
+    /* F2 */ fmt_bad(),
+    /* F3 */ fmt_bad(),
+    /* F4 */ fmt("hlt", 0),
+    /* F5 */ fmt("cmc", 0),
+    /* F6 */ fmt_kind(FMT_KIND_GROUP, GRP_F6),
+    /* F7 */ fmt_kind(FMT_KIND_GROUP, GRP_F7),
+    /* F8 */ fmt("clc", 0),
+    /* F9 */ fmt("stc", 0),
+    /* FA */ fmt("cli", 0),
+    /* FB */ fmt("sti", 0),
+    /* FC */ fmt("cld", 0),
+    /* FD */ fmt("std", 0),
+    /* FE */ fmt_kind(FMT_KIND_GROUP, GRP_FE),
+    /* FF */ fmt_kind(FMT_KIND_GROUP, GRP_FF),
+};
+
+/*
+ * 2-byte opcodes (0F xx)
+ */
+static constexpr FormatEntry g_format_map_0f[OPCODE_TABLE_SIZE] = {
+    /* 00 */ fmt_kind(FMT_KIND_GROUP, GRP_0F00),
+    /* 01 */ fmt_kind(FMT_KIND_GROUP, GRP_0F01),
+    /* 02 */ fmt("lar", 0, OPND_Gv, OPND_Ew),
+    /* 03 */ fmt("lsl", 0, OPND_Gv, OPND_Ew),
+    /* 04 */ fmt_bad(),
+    /* 05 */ fmt("syscall", 0),
+    /* 06 */ fmt("clts", 0),
+    /* 07 */ fmt("sysret", 0),
+    /* 08 */ fmt("invd", 0),
+    /* 09 */ fmt("wbinvd", 0),
+    /* 0A */ fmt_bad(),
+    /* 0B */ fmt("ud2", 0),
+    /* 0C */ fmt_bad(),
+    /* 0D */ fmt("prefetchw", 0, OPND_Mb),
+    /* 0E */ fmt("femms", 0),
+    /* 0F */ fmt_bad(),
+
+    /* 10 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F10),
+    /* 11 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F11),
+    /* 12 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F12),
+    /* 13 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F13),
+    /* 14 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F14),
+    /* 15 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F15),
+    /* 16 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F16),
+    /* 17 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F17),
+    /* 18 */ fmt_kind(FMT_KIND_GROUP, GRP_0F18),
+    /* 19 */ fmt("nop", 0, OPND_Ev),
+    /* 1A */ fmt("nop", 0, OPND_Ev),
+    /* 1B */ fmt("nop", 0, OPND_Ev),
+    /* 1C */ fmt("nop", 0, OPND_Ev),
+    /* 1D */ fmt("nop", 0, OPND_Ev),
+    /* 1E */ fmt_kind(FMT_KIND_PREFIX, PFX_0F1E),
+    /* 1F */ fmt("nop", 0, OPND_Ev),
+
+    /* 20 */ fmt("mov", 0, OPND_Rq64, OPND_Cd),
+    /* 21 */ fmt("mov", 0, OPND_Rq64, OPND_Dd),
+    /* 22 */ fmt("mov", 0, OPND_Cd, OPND_Rq64),
+    /* 23 */ fmt("mov", 0, OPND_Dd, OPND_Rq64),
+    /* 24 */ fmt_bad(),
+    /* 25 */ fmt_bad(),
+    /* 26 */ fmt_bad(),
+    /* 27 */ fmt_bad(),
+    /* 28 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F28),
+    /* 29 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F29),
+    /* 2A */ fmt_kind(FMT_KIND_PREFIX, PFX_0F2A),
+    /* 2B */ fmt_kind(FMT_KIND_PREFIX, PFX_0F2B),
+    /* 2C */ fmt_kind(FMT_KIND_PREFIX, PFX_0F2C),
+    /* 2D */ fmt_kind(FMT_KIND_PREFIX, PFX_0F2D),
+    /* 2E */ fmt_kind(FMT_KIND_PREFIX, PFX_0F2E),
+    /* 2F */ fmt_kind(FMT_KIND_PREFIX, PFX_0F2F),
+
+    /* 30 */ fmt("wrmsr", 0),
+    /* 31 */ fmt("rdtsc", 0),
+    /* 32 */ fmt("rdmsr", 0),
+    /* 33 */ fmt("rdpmc", 0),
+    /* 34 */ fmt("sysenter", 0),
+    /* 35 */ fmt("sysexit", 0),
+    /* 36 */ fmt_bad(),
+    /* 37 */ fmt("getsec", 0),
+    /* 38 */ fmt_bad(),
+    /* 39 */ fmt_bad(),
+    /* 3A */ fmt_bad(),
+    /* 3B */ fmt_bad(),
+    /* 3C */ fmt_bad(),
+    /* 3D */ fmt_bad(),
+    /* 3E */ fmt_bad(),
+    /* 3F */ fmt_bad(),
+
+    /* 40 */ fmt("cmovo", 0, OPND_Gv, OPND_Ev),
+    /* 41 */ fmt_kind(FMT_KIND_VEXL, VEXL_0F41),
+    /* 42 */ fmt_kind(FMT_KIND_VEXL, VEXL_0F42),
+    /* 43 */ fmt("cmovae", 0, OPND_Gv, OPND_Ev),
+    /* 44 */ fmt_kind(FMT_KIND_VEXL, VEXL_0F44),
+    /* 45 */ fmt_kind(FMT_KIND_VEXL, VEXL_0F45),
+    /* 46 */ fmt_kind(FMT_KIND_VEXL, VEXL_0F46),
+    /* 47 */ fmt_kind(FMT_KIND_VEXL, VEXL_0F47),
+    /* 48 */ fmt("cmovs", 0, OPND_Gv, OPND_Ev),
+    /* 49 */ fmt("cmovns", 0, OPND_Gv, OPND_Ev),
+    /* 4A */ fmt_kind(FMT_KIND_VEXL, VEXL_0F4A),
+    /* 4B */ fmt("cmovnp", 0, OPND_Gv, OPND_Ev),
+    /* 4C */ fmt("cmovl", 0, OPND_Gv, OPND_Ev),
+    /* 4D */ fmt("cmovge", 0, OPND_Gv, OPND_Ev),
+    /* 4E */ fmt("cmovle", 0, OPND_Gv, OPND_Ev),
+    /* 4F */ fmt("cmovg", 0, OPND_Gv, OPND_Ev),
+
+    /* 50 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F50),
+    /* 51 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F51),
+    /* 52 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F52),
+    /* 53 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F53),
+    /* 54 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F54),
+    /* 55 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F55),
+    /* 56 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F56),
+    /* 57 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F57),
+    /* 58 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F58),
+    /* 59 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F59),
+    /* 5A */ fmt_kind(FMT_KIND_PREFIX, PFX_0F5A),
+    /* 5B */ fmt_kind(FMT_KIND_PREFIX, PFX_0F5B),
+    /* 5C */ fmt_kind(FMT_KIND_PREFIX, PFX_0F5C),
+    /* 5D */ fmt_kind(FMT_KIND_PREFIX, PFX_0F5D),
+    /* 5E */ fmt_kind(FMT_KIND_PREFIX, PFX_0F5E),
+    /* 5F */ fmt_kind(FMT_KIND_PREFIX, PFX_0F5F),
+
+    /* 60 */ fmt("punpcklbw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 61 */ fmt("punpcklwd", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 62 */ fmt("punpckldq", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 63 */ fmt("packsswb", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 64 */ fmt("pcmpgtb", 0, OPND_PK, OPND_Hx, OPND_Qxm),
+    /* 65 */ fmt("pcmpgtw", 0, OPND_PK, OPND_Hx, OPND_Qxm),
+    /* 66 */ fmt("pcmpgtd", 0, OPND_PK, OPND_Hx, OPND_Qxm),
+    /* 67 */ fmt("packuswb", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 68 */ fmt("punpckhbw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 69 */ fmt("punpckhwd", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 6A */ fmt("punpckhdq", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 6B */ fmt("packssdw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 6C */ fmt_kind(FMT_KIND_PREFIX, PFX_0F6C),
+    /* 6D */ fmt_kind(FMT_KIND_PREFIX, PFX_0F6D),
+    /* 6E */ fmt_kind(FMT_KIND_PREFIX, PFX_0F6E),
+    /* 6F */ fmt_kind(FMT_KIND_PREFIX, PFX_0F6F),
+
+    /* 70 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F70),
+    /* 71 */ fmt_kind(FMT_KIND_GROUP, GRP_0F71),
+    /* 72 */ fmt_kind(FMT_KIND_GROUP, GRP_0F72),
+    /* 73 */ fmt_kind(FMT_KIND_GROUP, GRP_0F73),
+    /* 74 */ fmt("pcmpeqb", 0, OPND_PK, OPND_Hx, OPND_Qxm),
+    /* 75 */ fmt("pcmpeqw", 0, OPND_PK, OPND_Hx, OPND_Qxm),
+    /* 76 */ fmt("pcmpeqd", 0, OPND_PK, OPND_Hx, OPND_Qxm),
+    /* 77 */ fmt_kind(FMT_KIND_VEXL, VEXL_0F77),
+    /* 78 */ fmt("vmread", FMT_D64, OPND_Ey, OPND_Gy),
+    /* 79 */ fmt("vmwrite", FMT_D64, OPND_Gy, OPND_Ey),
+    /* 7A */ fmt_bad(),
+    /* 7B */ fmt_bad(),
+    /* 7C */ fmt_kind(FMT_KIND_PREFIX, PFX_0F7C),
+    /* 7D */ fmt_kind(FMT_KIND_PREFIX, PFX_0F7D),
+    /* 7E */ fmt_kind(FMT_KIND_PREFIX, PFX_0F7E),
+    /* 7F */ fmt_kind(FMT_KIND_PREFIX, PFX_0F7F),
+
+    /* 80 */ fmt("jo", FMT_D64, OPND_Jz),
+    /* 81 */ fmt("jno", FMT_D64, OPND_Jz),
+    /* 82 */ fmt("jb", FMT_D64, OPND_Jz),
+    /* 83 */ fmt("jae", FMT_D64, OPND_Jz),
+    /* 84 */ fmt("je", FMT_D64, OPND_Jz),
+    /* 85 */ fmt("jne", FMT_D64, OPND_Jz),
+    /* 86 */ fmt("jbe", FMT_D64, OPND_Jz),
+    /* 87 */ fmt("ja", FMT_D64, OPND_Jz),
+    /* 88 */ fmt("js", FMT_D64, OPND_Jz),
+    /* 89 */ fmt("jns", FMT_D64, OPND_Jz),
+    /* 8A */ fmt("jp", FMT_D64, OPND_Jz),
+    /* 8B */ fmt("jnp", FMT_D64, OPND_Jz),
+    /* 8C */ fmt("jl", FMT_D64, OPND_Jz),
+    /* 8D */ fmt("jge", FMT_D64, OPND_Jz),
+    /* 8E */ fmt("jle", FMT_D64, OPND_Jz),
+    /* 8F */ fmt("jg", FMT_D64, OPND_Jz),
+
+    /* 90 */ fmt_kind(FMT_KIND_VEXL, VEXL_0F90),
+    /* 91 */ fmt_kind(FMT_KIND_VEXL, VEXL_0F91),
+    /* 92 */ fmt_kind(FMT_KIND_VEXL, VEXL_0F92),
+    /* 93 */ fmt_kind(FMT_KIND_VEXL, VEXL_0F93),
+    /* 94 */ fmt("sete", FMT_NO_SUFFIX, OPND_Eb),
+    /* 95 */ fmt("setne", FMT_NO_SUFFIX, OPND_Eb),
+    /* 96 */ fmt("setbe", FMT_NO_SUFFIX, OPND_Eb),
+    /* 97 */ fmt("seta", FMT_NO_SUFFIX, OPND_Eb),
+    /* 98 */ fmt_kind(FMT_KIND_VEXL, VEXL_0F98),
+    /* 99 */ fmt_kind(FMT_KIND_VEXL, VEXL_0F99),
+    /* 9A */ fmt("setp", FMT_NO_SUFFIX, OPND_Eb),
+    /* 9B */ fmt("setnp", FMT_NO_SUFFIX, OPND_Eb),
+    /* 9C */ fmt("setl", FMT_NO_SUFFIX, OPND_Eb),
+    /* 9D */ fmt("setge", FMT_NO_SUFFIX, OPND_Eb),
+    /* 9E */ fmt("setle", FMT_NO_SUFFIX, OPND_Eb),
+    /* 9F */ fmt("setg", FMT_NO_SUFFIX, OPND_Eb),
+
+    /* A0 */ fmt("push", 0, OPND_FS),
+    /* A1 */ fmt("pop", 0, OPND_FS),
+    /* A2 */ fmt("cpuid", 0),
+    /* A3 */ fmt("bt", 0, OPND_Ev, OPND_Gv),
+    /* A4 */ fmt("shld", 0, OPND_Ev, OPND_Gv, OPND_Ib),
+    /* A5 */ fmt("shld", 0, OPND_Ev, OPND_Gv, OPND_CL),
+    /* A6 */ fmt_bad(),
+    /* A7 */ fmt_bad(),
+    /* A8 */ fmt("push", 0, OPND_GS),
+    /* A9 */ fmt("pop", 0, OPND_GS),
+    /* AA */ fmt("rsm", 0),
+    /* AB */ fmt("bts", 0, OPND_Ev, OPND_Gv),
+    /* AC */ fmt("shrd", 0, OPND_Ev, OPND_Gv, OPND_Ib),
+    /* AD */ fmt("shrd", 0, OPND_Ev, OPND_Gv, OPND_CL),
+    /* AE */ fmt_kind(FMT_KIND_GROUP, GRP_0FAE),
+    /* AF */ fmt("imul", 0, OPND_Gv, OPND_Ev),
+
+    /* B0 */ fmt("cmpxchg", 0, OPND_Eb, OPND_Gb),
+    /* B1 */ fmt("cmpxchg", 0, OPND_Ev, OPND_Gv),
+    /* B2 */ fmt("lss", 0, OPND_Gv, OPND_Mp),
+    /* B3 */ fmt("btr", 0, OPND_Ev, OPND_Gv),
+    /* B4 */ fmt("lfs", 0, OPND_Gv, OPND_Mp),
+    /* B5 */ fmt("lgs", 0, OPND_Gv, OPND_Mp),
+    /* B6 */ fmt("movzx", FMT_ATT_MOVX, OPND_Gv, OPND_Eb),
+    /* B7 */ fmt("movzx", FMT_ATT_MOVX, OPND_Gv, OPND_Ew),
+    /* B8 */ fmt_kind(FMT_KIND_PREFIX, PFX_0FB8),
+    /* B9 */ fmt_kind(FMT_KIND_GROUP, GRP_0FB9),
+    /* BA */ fmt_kind(FMT_KIND_GROUP, GRP_0FBA),
+    /* BB */ fmt("btc", 0, OPND_Ev, OPND_Gv),
+    /* BC */ fmt_kind(FMT_KIND_PREFIX, PFX_0FBC),
+    /* BD */ fmt_kind(FMT_KIND_PREFIX, PFX_0FBD),
+    /* BE */ fmt("movsx", FMT_ATT_MOVX, OPND_Gv, OPND_Eb),
+    /* BF */ fmt("movsx", FMT_ATT_MOVX, OPND_Gv, OPND_Ew),
+
+    /* C0 */ fmt("xadd", 0, OPND_Eb, OPND_Gb),
+    /* C1 */ fmt("xadd", 0, OPND_Ev, OPND_Gv),
+    /* C2 */ fmt_kind(FMT_KIND_PREFIX, PFX_0FC2),
+    /* C3 */ fmt("movnti", 0, OPND_My, OPND_Gy),
+    /* C4 */ fmt_kind(FMT_KIND_PREFIX, PFX_0FC4),
+    /* C5 */ fmt_kind(FMT_KIND_PREFIX, PFX_0FC5),
+    /* C6 */ fmt_kind(FMT_KIND_PREFIX, PFX_0FC6),
+    /* C7 */ fmt_kind(FMT_KIND_GROUP, GRP_0FC7),
+    /* C8 */ fmt("bswap", 0, OPND_Zy),
+    /* C9 */ fmt("bswap", 0, OPND_Zy),
+    /* CA */ fmt("bswap", 0, OPND_Zy),
+    /* CB */ fmt("bswap", 0, OPND_Zy),
+    /* CC */ fmt("bswap", 0, OPND_Zy),
+    /* CD */ fmt("bswap", 0, OPND_Zy),
+    /* CE */ fmt("bswap", 0, OPND_Zy),
+    /* CF */ fmt("bswap", 0, OPND_Zy),
+
+    /* D0 */ fmt_kind(FMT_KIND_PREFIX, PFX_0FD0),
+    /* D1 */ fmt("psrlw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* D2 */ fmt("psrld", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* D3 */ fmt("psrlq", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* D4 */ fmt("paddq", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* D5 */ fmt("pmullw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* D6 */ fmt_kind(FMT_KIND_PREFIX, PFX_0FD6),
+    /* D7 */ fmt("pmovmskb", 0, OPND_Gd, OPND_Nxm),
+    /* D8 */ fmt("psubusb", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* D9 */ fmt("psubusw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* DA */ fmt("pminub", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* DB */ fmt("pand", FMT_SUFFIX_EVEX_DQ, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* DC */ fmt("paddusb", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* DD */ fmt("paddusw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* DE */ fmt("pmaxub", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* DF */ fmt("pandn", FMT_SUFFIX_EVEX_DQ, OPND_Pxm, OPND_Hx, OPND_Qxm),
+
+    /* E0 */ fmt("pavgb", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* E1 */ fmt("psraw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* E2 */ fmt("psrad", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* E3 */ fmt("pavgw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* E4 */ fmt("pmulhuw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* E5 */ fmt("pmulhw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* E6 */ fmt_kind(FMT_KIND_PREFIX, PFX_0FE6),
+    /* E7 */ fmt_kind(FMT_KIND_PREFIX, PFX_0FE7),
+    /* E8 */ fmt("psubsb", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* E9 */ fmt("psubsw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* EA */ fmt("pminsw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* EB */ fmt("por", FMT_SUFFIX_EVEX_DQ, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* EC */ fmt("paddsb", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* ED */ fmt("paddsw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* EE */ fmt("pmaxsw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* EF */ fmt("pxor", FMT_SUFFIX_EVEX_DQ, OPND_Pxm, OPND_Hx, OPND_Qxm),
+
+    /* F0 */ fmt_kind(FMT_KIND_PREFIX, PFX_0FF0),
+    /* F1 */ fmt("psllw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* F2 */ fmt("pslld", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* F3 */ fmt("psllq", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* F4 */ fmt("pmuludq", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* F5 */ fmt("pmaddwd", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* F6 */ fmt("psadbw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* F7 */ fmt_kind(FMT_KIND_PREFIX, PFX_0FF7),
+    /* F8 */ fmt("psubb", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* F9 */ fmt("psubw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* FA */ fmt("psubd", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* FB */ fmt("psubq", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* FC */ fmt("paddb", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* FD */ fmt("paddw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* FE */ fmt("paddd", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* FF */ fmt("ud0", 0, OPND_Gv, OPND_Ev),
+};
+
+/*
+ * 3-byte opcodes (0F 38 xx)
+ */
+static constexpr FormatEntry g_format_map_0f38[OPCODE_TABLE_SIZE] = {
+    /* 00 */ fmt("pshufb", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 01 */ fmt("phaddw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 02 */ fmt("phaddd", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 03 */ fmt("phaddsw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 04 */ fmt("pmaddubsw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 05 */ fmt("phsubw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 06 */ fmt("phsubd", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 07 */ fmt("phsubsw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 08 */ fmt("psignb", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 09 */ fmt("psignw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 0A */ fmt("psignd", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 0B */ fmt("pmulhrsw", 0, OPND_Pxm, OPND_Hx, OPND_Qxm),
+    /* 0C */ fmt("permilps", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 0D */ fmt("permilpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 0E */ fmt("testps", 0, OPND_Vx, OPND_Wx),
+    /* 0F */ fmt("testpd", 0, OPND_Vx, OPND_Wx),
+
+    /* 10 */ fmt("pblendvb", 0, OPND_Vdq, OPND_Wdq, OPND_XMM0),
+    /* 11 */ fmt_bad(),
+    /* 12 */ fmt_bad(),
+    /* 13 */ fmt("cvtph2ps", 0, OPND_Vx, OPND_Wh),
+    /* 14 */ fmt("blendvps", 0, OPND_Vdq, OPND_Wdq, OPND_XMM0),
+    /* 15 */ fmt("blendvpd", 0, OPND_Vdq, OPND_Wdq, OPND_XMM0),
+    /* 16 */ fmt("permps", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 17 */ fmt("ptest", 0, OPND_Vx, OPND_Wx),
+    /* 18 */ fmt("broadcastss", 0, OPND_Vx, OPND_Wd),
+    /* 19 */ fmt("broadcastsd", 0, OPND_Vx, OPND_Wq),
+    /* 1A */ fmt("broadcastf128", 0, OPND_Vx, OPND_Mdq),
+    /* 1B */ fmt_bad(),
+    /* 1C */ fmt("pabsb", 0, OPND_Pxm, OPND_Qxm),
+    /* 1D */ fmt("pabsw", 0, OPND_Pxm, OPND_Qxm),
+    /* 1E */ fmt("pabsd", 0, OPND_Pxm, OPND_Qxm),
+    /* 1F */ fmt_bad(),
+
+    /* 20 */ fmt("pmovsxbw", 0, OPND_Vx, OPND_Wh),
+    /* 21 */ fmt("pmovsxbd", 0, OPND_Vx, OPND_Wqt),
+    /* 22 */ fmt("pmovsxbq", 0, OPND_Vx, OPND_Wo),
+    /* 23 */ fmt("pmovsxwd", 0, OPND_Vx, OPND_Wh),
+    /* 24 */ fmt("pmovsxwq", 0, OPND_Vx, OPND_Wqt),
+    /* 25 */ fmt("pmovsxdq", 0, OPND_Vx, OPND_Wh),
+    /* 26 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F3826),
+    /* 27 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F3827),
+    /* 28 */ fmt("pmuldq", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 29 */ fmt("pcmpeqq", 0, OPND_PK, OPND_Hx, OPND_Wx),
+    /* 2A */ fmt("movntdqa", 0, OPND_Vx, OPND_Mx),
+    /* 2B */ fmt("packusdw", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 2C */ fmt("maskmovps", 0, OPND_Vx, OPND_Hx, OPND_Mx),
+    /* 2D */ fmt("maskmovpd", 0, OPND_Vx, OPND_Hx, OPND_Mx),
+    /* 2E */ fmt("maskmovps", 0, OPND_Mx, OPND_Hx, OPND_Vx),
+    /* 2F */ fmt("maskmovpd", 0, OPND_Mx, OPND_Hx, OPND_Vx),
+
+    /* 30 */ fmt("pmovzxbw", 0, OPND_Vx, OPND_Wh),
+    /* 31 */ fmt("pmovzxbd", 0, OPND_Vx, OPND_Wqt),
+    /* 32 */ fmt("pmovzxbq", 0, OPND_Vx, OPND_Wo),
+    /* 33 */ fmt("pmovzxwd", 0, OPND_Vx, OPND_Wh),
+    /* 34 */ fmt("pmovzxwq", 0, OPND_Vx, OPND_Wqt),
+    /* 35 */ fmt("pmovzxdq", 0, OPND_Vx, OPND_Wh),
+    /* 36 */ fmt("permd", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 37 */ fmt("pcmpgtq", 0, OPND_PK, OPND_Hx, OPND_Wx),
+    /* 38 */ fmt("pminsb", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 39 */ fmt("pminsd", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 3A */ fmt("pminuw", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 3B */ fmt("pminud", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 3C */ fmt("pmaxsb", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 3D */ fmt("pmaxsd", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 3E */ fmt("pmaxuw", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 3F */ fmt("pmaxud", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+
+    /* 40 */ fmt("pmulld", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 41 */ fmt("phminposuw", 0, OPND_Vdq, OPND_Wdq),
+    /* 42 */ fmt_bad(),
+    /* 43 */ fmt_bad(),
+    /* 44 */ fmt_bad(),
+    /* 45 */ fmt("psrlv", FMT_SUFFIX_DQ, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 46 */ fmt("psrav", FMT_SUFFIX_DQ, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 47 */ fmt("psllv", FMT_SUFFIX_DQ, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 48 */ fmt_bad(),
+    /* 49 */ fmt_bad(),
+    /* 4A */ fmt_bad(),
+    /* 4B */ fmt_bad(),
+    /* 4C */ fmt_bad(),
+    /* 4D */ fmt_bad(),
+    /* 4E */ fmt_bad(),
+    /* 4F */ fmt_bad(),
+
+    /* 50 */ fmt_bad(),
+    /* 51 */ fmt_bad(),
+    /* 52 */ fmt_bad(),
+    /* 53 */ fmt_bad(),
+    /* 54 */ fmt_bad(),
+    /* 55 */ fmt_bad(),
+    /* 56 */ fmt_bad(),
+    /* 57 */ fmt_bad(),
+    /* 58 */ fmt("pbroadcastd", 0, OPND_Vx, OPND_Wd),
+    /* 59 */ fmt("pbroadcastq", 0, OPND_Vx, OPND_Wq),
+    /* 5A */ fmt("broadcasti128", 0, OPND_Vx, OPND_Mdq),
+    /* 5B */ fmt_bad(),
+    /* 5C */ fmt_bad(),
+    /* 5D */ fmt_bad(),
+    /* 5E */ fmt_bad(),
+    /* 5F */ fmt_bad(),
+
+    /* 60 */ fmt_bad(),
+    /* 61 */ fmt_bad(),
+    /* 62 */ fmt_bad(),
+    /* 63 */ fmt_bad(),
+    /* 64 */ fmt("pblendm", FMT_SUFFIX_DQ, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 65 */ fmt("blendmp", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 66 */ fmt("pblendm", FMT_SUFFIX_BW, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 67 */ fmt_bad(),
+    /* 68 */ fmt_bad(),
+    /* 69 */ fmt_bad(),
+    /* 6A */ fmt_bad(),
+    /* 6B */ fmt_bad(),
+    /* 6C */ fmt_bad(),
+    /* 6D */ fmt_bad(),
+    /* 6E */ fmt_bad(),
+    /* 6F */ fmt_bad(),
+
+    /* 70 */ fmt_bad(),
+    /* 71 */ fmt_bad(),
+    /* 72 */ fmt_bad(),
+    /* 73 */ fmt_bad(),
+    /* 74 */ fmt_bad(),
+    /* 75 */ fmt("permi2", FMT_SUFFIX_BW, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 76 */ fmt("permi2", FMT_SUFFIX_DQ, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 77 */ fmt("permi2p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 78 */ fmt("pbroadcastb", 0, OPND_Vx, OPND_Wb),
+    /* 79 */ fmt("pbroadcastw", 0, OPND_Vx, OPND_Ww),
+    /* 7A */ fmt("pbroadcastb", 0, OPND_Vx, OPND_Rd),
+    /* 7B */ fmt("pbroadcastw", 0, OPND_Vx, OPND_Rd),
+    /* 7C */ fmt("pbroadcast", FMT_SUFFIX_DQ, OPND_Vx, OPND_Ry),
+    /* 7D */ fmt("permt2", FMT_SUFFIX_BW, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 7E */ fmt("permt2", FMT_SUFFIX_DQ, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 7F */ fmt("permt2p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+
+    /* 80 */ fmt("invept", 0, OPND_Gq64, OPND_Mdq),
+    /* 81 */ fmt("invvpid", 0, OPND_Gq64, OPND_Mdq),
+    /* 82 */ fmt("invpcid", 0, OPND_Gq64, OPND_Mdq),
+    /* 83 */ fmt_bad(),
+    /* 84 */ fmt_bad(),
+    /* 85 */ fmt_bad(),
+    /* 86 */ fmt_bad(),
+    /* 87 */ fmt_bad(),
+    /* 88 */ fmt("expandp", FMT_SUFFIX_SD, OPND_Vx, OPND_Wx),
+    /* 89 */ fmt("pexpand", FMT_SUFFIX_DQ, OPND_Vx, OPND_Wx),
+    /* 8A */ fmt("compressp", FMT_SUFFIX_SD, OPND_Wx, OPND_Vx),
+    /* 8B */ fmt("pcompress", FMT_SUFFIX_DQ, OPND_Wx, OPND_Vx),
+    /* 8C */ fmt("pmaskmov", FMT_SUFFIX_DQ, OPND_Vx, OPND_Hx, OPND_Mx),
+    /* 8D */ fmt_bad(),
+    /* 8E */ fmt("pmaskmov", FMT_SUFFIX_DQ, OPND_Mx, OPND_Hx, OPND_Vx),
+    /* 8F */ fmt_bad(),
+
+    /* 90 */ fmt("pgatherd", FMT_SUFFIX_DQ, OPND_Vx, OPND_MVsib, OPND_Hx),
+    /* 91 */ fmt("pgatherq", FMT_SUFFIX_DQ, OPND_Vx, OPND_MVsib, OPND_Hx),
+    /* 92 */ fmt("gatherdp", FMT_SUFFIX_SD, OPND_Vx, OPND_MVsib, OPND_Hx),
+    /* 93 */ fmt("gatherqp", FMT_SUFFIX_SD, OPND_Vx, OPND_MVsib, OPND_Hx),
+    /* 94 */ fmt_bad(),
+    /* 95 */ fmt_bad(),
+    /* 96 */ fmt("fmaddsub132p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 97 */ fmt("fmsubadd132p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 98 */ fmt("fmadd132p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 99 */ fmt("fmadd132s", FMT_SUFFIX_SD, OPND_Vdq, OPND_Hdq, OPND_Wsx),
+    /* 9A */ fmt("fmsub132p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 9B */ fmt("fmsub132s", FMT_SUFFIX_SD, OPND_Vdq, OPND_Hdq, OPND_Wsx),
+    /* 9C */ fmt("fnmadd132p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 9D */ fmt("fnmadd132s", FMT_SUFFIX_SD, OPND_Vdq, OPND_Hdq, OPND_Wsx),
+    /* 9E */ fmt("fnmsub132p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* 9F */ fmt("fnmsub132s", FMT_SUFFIX_SD, OPND_Vdq, OPND_Hdq, OPND_Wsx),
+
+    /* A0 */ fmt_bad(),
+    /* A1 */ fmt_bad(),
+    /* A2 */ fmt_bad(),
+    /* A3 */ fmt_bad(),
+    /* A4 */ fmt_bad(),
+    /* A5 */ fmt_bad(),
+    /* A6 */ fmt("fmaddsub213p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* A7 */ fmt("fmsubadd213p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* A8 */ fmt("fmadd213p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* A9 */ fmt("fmadd213s", FMT_SUFFIX_SD, OPND_Vdq, OPND_Hdq, OPND_Wsx),
+    /* AA */ fmt("fmsub213p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* AB */ fmt("fmsub213s", FMT_SUFFIX_SD, OPND_Vdq, OPND_Hdq, OPND_Wsx),
+    /* AC */ fmt("fnmadd213p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* AD */ fmt("fnmadd213s", FMT_SUFFIX_SD, OPND_Vdq, OPND_Hdq, OPND_Wsx),
+    /* AE */ fmt("fnmsub213p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* AF */ fmt("fnmsub213s", FMT_SUFFIX_SD, OPND_Vdq, OPND_Hdq, OPND_Wsx),
+
+    /* B0 */ fmt_bad(),
+    /* B1 */ fmt_bad(),
+    /* B2 */ fmt_bad(),
+    /* B3 */ fmt_bad(),
+    /* B4 */ fmt_bad(),
+    /* B5 */ fmt_bad(),
+    /* B6 */ fmt("fmaddsub231p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* B7 */ fmt("fmsubadd231p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* B8 */ fmt("fmadd231p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* B9 */ fmt("fmadd231s", FMT_SUFFIX_SD, OPND_Vdq, OPND_Hdq, OPND_Wsx),
+    /* BA */ fmt("fmsub231p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* BB */ fmt("fmsub231s", FMT_SUFFIX_SD, OPND_Vdq, OPND_Hdq, OPND_Wsx),
+    /* BC */ fmt("fnmadd231p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* BD */ fmt("fnmadd231s", FMT_SUFFIX_SD, OPND_Vdq, OPND_Hdq, OPND_Wsx),
+    /* BE */ fmt("fnmsub231p", FMT_SUFFIX_SD, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* BF */ fmt("fnmsub231s", FMT_SUFFIX_SD, OPND_Vdq, OPND_Hdq, OPND_Wsx),
+
+    /* C0 */ fmt_bad(),
+    /* C1 */ fmt_bad(),
+    /* C2 */ fmt_bad(),
+    /* C3 */ fmt_bad(),
+    /* C4 */ fmt("pconflict", FMT_SUFFIX_DQ, OPND_Vx, OPND_Wx),
+    /* C5 */ fmt_bad(),
+    /* C6 */ fmt_bad(),
+    /* C7 */ fmt_bad(),
+    /* C8 */ fmt("sha1nexte", 0, OPND_Vdq, OPND_Wdq),
+    /* C9 */ fmt("sha1msg1", 0, OPND_Vdq, OPND_Wdq),
+    /* CA */ fmt("sha1msg2", 0, OPND_Vdq, OPND_Wdq),
+    /* CB */ fmt("sha256rnds2", 0, OPND_Vdq, OPND_Wdq, OPND_XMM0),
+    /* CC */ fmt("sha256msg1", 0, OPND_Vdq, OPND_Wdq),
+    /* CD */ fmt("sha256msg2", 0, OPND_Vdq, OPND_Wdq),
+    /* CE */ fmt_bad(),
+    /* CF */ fmt("gf2p8mulb", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+
+    /* D0 */ fmt_bad(),
+    /* D1 */ fmt_bad(),
+    /* D2 */ fmt_bad(),
+    /* D3 */ fmt_bad(),
+    /* D4 */ fmt_bad(),
+    /* D5 */ fmt_bad(),
+    /* D6 */ fmt_bad(),
+    /* D7 */ fmt_bad(),
+    /* D8 */ fmt_bad(),
+    /* D9 */ fmt_bad(),
+    /* DA */ fmt_bad(),
+    /* DB */ fmt("aesimc", 0, OPND_Vdq, OPND_Wdq),
+    /* DC */ fmt("aesenc", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* DD */ fmt("aesenclast", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* DE */ fmt("aesdec", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+    /* DF */ fmt("aesdeclast", 0, OPND_Vx, OPND_Hx, OPND_Wx),
+
+    /* E0 */ fmt_bad(),
+    /* E1 */ fmt_bad(),
+    /* E2 */ fmt_bad(),
+    /* E3 */ fmt_bad(),
+    /* E4 */ fmt_bad(),
+    /* E5 */ fmt_bad(),
+    /* E6 */ fmt_bad(),
+    /* E7 */ fmt_bad(),
+    /* E8 */ fmt_bad(),
+    /* E9 */ fmt_bad(),
+    /* EA */ fmt_bad(),
+    /* EB */ fmt_bad(),
+    /* EC */ fmt_bad(),
+    /* ED */ fmt_bad(),
+    /* EE */ fmt_bad(),
+    /* EF */ fmt_bad(),
+
+    /* F0 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F38F0),
+    /* F1 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F38F1),
+    /* F2 */ fmt("andn", FMT_NO_V, OPND_Gy, OPND_By, OPND_Ey),
+    /* F3 */ fmt_kind(FMT_KIND_GROUP, GRP_VEX_0F38F3),
+    /* F4 */ fmt_bad(),
+    /* F5 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F38F5),
+    /* F6 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F38F6),
+    /* F7 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F38F7),
+    /* F8 */ fmt_kind(FMT_KIND_PREFIX, PFX_0F38F8),
+    /* F9 */ fmt("movdiri", 0, OPND_My, OPND_Gy),
+    /* FA */ fmt_bad(),
+    /* FB */ fmt_bad(),
+    /* FC */ fmt_bad(),
+    /* FD */ fmt_bad(),
+    /* FE */ fmt_bad(),
+    /* FF */ fmt_bad(),
+};
+
+/*
+ * 3-byte opcodes (0F 3A xx)
+ */
+static constexpr FormatEntry g_format_map_0f3a[OPCODE_TABLE_SIZE] = {
+    /* 00 */ fmt("permq", 0, OPND_Vx, OPND_Wx, OPND_Ib),
+    /* 01 */ fmt("permpd", 0, OPND_Vx, OPND_Wx, OPND_Ib),
+    /* 02 */ fmt("pblendd", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Ib),
+    /* 03 */ fmt("align", FMT_SUFFIX_DQ, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Ib),
+    /* 04 */ fmt("permilps", 0, OPND_Vx, OPND_Wx, OPND_Ib),
+    /* 05 */ fmt("permilpd", 0, OPND_Vx, OPND_Wx, OPND_Ib),
+    /* 06 */ fmt("perm2f128", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Ib),
+    /* 07 */ fmt_bad(),
+    /* 08 */ fmt("roundps", 0, OPND_Vx, OPND_Wx, OPND_Ib),
+    /* 09 */ fmt("roundpd", 0, OPND_Vx, OPND_Wx, OPND_Ib),
+    /* 0A */ fmt("roundss", 0, OPND_Vdq, OPND_Hdq, OPND_Wd, OPND_Ib),
+    /* 0B */ fmt("roundsd", 0, OPND_Vdq, OPND_Hdq, OPND_Wq, OPND_Ib),
+    /* 0C */ fmt("blendps", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Ib),
+    /* 0D */ fmt("blendpd", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Ib),
+    /* 0E */ fmt("pblendw", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Ib),
+    /* 0F */ fmt("palignr", 0, OPND_Pxm, OPND_Hx, OPND_Qxm, OPND_Ib),
+
+    /* 10 */ fmt_bad(),
+    /* 11 */ fmt_bad(),
+    /* 12 */ fmt_bad(),
+    /* 13 */ fmt_bad(),
+    /* 14 */ fmt("pextrb", 0, OPND_Edb, OPND_Vdq, OPND_Ib),
+    /* 15 */ fmt("pextrw", 0, OPND_Edw, OPND_Vdq, OPND_Ib),
+    /* 16 */ fmt("pextr", FMT_SUFFIX_DQ, OPND_Ey, OPND_Vdq, OPND_Ib),
+    /* 17 */ fmt("extractps", 0, OPND_Ed, OPND_Vdq, OPND_Ib),
+    /* 18 */ fmt("insertf128", 0, OPND_Vx, OPND_Hx, OPND_Wdq, OPND_Ib),
+    /* 19 */ fmt("extractf128", 0, OPND_Wdq, OPND_Vx, OPND_Ib),
+    /* 1A */ fmt_bad(),
+    /* 1B */ fmt_bad(),
+    /* 1C */ fmt_bad(),
+    /* 1D */ fmt("cvtps2ph", 0, OPND_Wh, OPND_Vx, OPND_Ib),
+    /* 1E */ fmt("pcmpu", FMT_SUFFIX_DQ, OPND_PK, OPND_Hx, OPND_Wx, OPND_Ib),
+    /* 1F */ fmt("pcmp", FMT_SUFFIX_DQ, OPND_PK, OPND_Hx, OPND_Wx, OPND_Ib),
+
+    /* 20 */ fmt("pinsrb", 0, OPND_Vdq, OPND_Hdq, OPND_Edb, OPND_Ib),
+    /* 21 */ fmt("insertps", 0, OPND_Vdq, OPND_Hdq, OPND_Wd, OPND_Ib),
+    /* 22 */ fmt("pinsr", FMT_SUFFIX_DQ, OPND_Vdq, OPND_Hdq, OPND_Ey, OPND_Ib),
+    /* 23 */ fmt_bad(),
+    /* 24 */ fmt_bad(),
+    /* 25 */ fmt("pternlog", FMT_SUFFIX_DQ, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Ib),
+    /* 26 */ fmt_bad(),
+    /* 27 */ fmt_bad(),
+    /* 28 */ fmt_bad(),
+    /* 29 */ fmt_bad(),
+    /* 2A */ fmt_bad(),
+    /* 2B */ fmt_bad(),
+    /* 2C */ fmt_bad(),
+    /* 2D */ fmt_bad(),
+    /* 2E */ fmt_bad(),
+    /* 2F */ fmt_bad(),
+
+    /* 30 */ fmt_bad(),
+    /* 31 */ fmt_bad(),
+    /* 32 */ fmt_bad(),
+    /* 33 */ fmt_bad(),
+    /* 34 */ fmt_bad(),
+    /* 35 */ fmt_bad(),
+    /* 36 */ fmt_bad(),
+    /* 37 */ fmt_bad(),
+    /* 38 */ fmt("inserti128", 0, OPND_Vx, OPND_Hx, OPND_Wdq, OPND_Ib),
+    /* 39 */ fmt("extracti128", 0, OPND_Wdq, OPND_Vx, OPND_Ib),
+    /* 3A */ fmt_bad(),
+    /* 3B */ fmt_bad(),
+    /* 3C */ fmt_bad(),
+    /* 3D */ fmt_bad(),
+    /* 3E */ fmt("pcmpu", FMT_SUFFIX_BW, OPND_PK, OPND_Hx, OPND_Wx, OPND_Ib),
+    /* 3F */ fmt("pcmp", FMT_SUFFIX_BW, OPND_PK, OPND_Hx, OPND_Wx, OPND_Ib),
+
+    /* 40 */ fmt("dpps", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Ib),
+    /* 41 */ fmt("dppd", 0, OPND_Vdq, OPND_Hdq, OPND_Wdq, OPND_Ib),
+    /* 42 */ fmt("mpsadbw", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Ib),
+    /* 43 */ fmt_bad(),
+    /* 44 */ fmt("pclmulqdq", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Ib),
+    /* 45 */ fmt_bad(),
+    /* 46 */ fmt("perm2i128", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Ib),
+    /* 47 */ fmt_bad(),
+    /* 48 */ fmt_bad(),
+    /* 49 */ fmt_bad(),
+    /* 4A */ fmt("blendvps", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Lx),
+    /* 4B */ fmt("blendvpd", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Lx),
+    /* 4C */ fmt("pblendvb", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Lx),
+    /* 4D */ fmt_bad(),
+    /* 4E */ fmt_bad(),
+    /* 4F */ fmt_bad(),
+
+    /* 50 */ fmt_bad(),
+    /* 51 */ fmt_bad(),
+    /* 52 */ fmt_bad(),
+    /* 53 */ fmt_bad(),
+    /* 54 */ fmt_bad(),
+    /* 55 */ fmt_bad(),
+    /* 56 */ fmt_bad(),
+    /* 57 */ fmt_bad(),
+    /* 58 */ fmt_bad(),
+    /* 59 */ fmt_bad(),
+    /* 5A */ fmt_bad(),
+    /* 5B */ fmt_bad(),
+    /* 5C */ fmt_bad(),
+    /* 5D */ fmt_bad(),
+    /* 5E */ fmt_bad(),
+    /* 5F */ fmt_bad(),
+
+    /* 60 */ fmt("pcmpestrm", 0, OPND_Vdq, OPND_Wdq, OPND_Ib),
+    /* 61 */ fmt("pcmpestri", 0, OPND_Vdq, OPND_Wdq, OPND_Ib),
+    /* 62 */ fmt("pcmpistrm", 0, OPND_Vdq, OPND_Wdq, OPND_Ib),
+    /* 63 */ fmt("pcmpistri", 0, OPND_Vdq, OPND_Wdq, OPND_Ib),
+    /* 64 */ fmt_bad(),
+    /* 65 */ fmt_bad(),
+    /* 66 */ fmt_bad(),
+    /* 67 */ fmt_bad(),
+    /* 68 */ fmt_bad(),
+    /* 69 */ fmt_bad(),
+    /* 6A */ fmt_bad(),
+    /* 6B */ fmt_bad(),
+    /* 6C */ fmt_bad(),
+    /* 6D */ fmt_bad(),
+    /* 6E */ fmt_bad(),
+    /* 6F */ fmt_bad(),
+
+    /* 70 */ fmt_bad(),
+    /* 71 */ fmt_bad(),
+    /* 72 */ fmt_bad(),
+    /* 73 */ fmt_bad(),
+    /* 74 */ fmt_bad(),
+    /* 75 */ fmt_bad(),
+    /* 76 */ fmt_bad(),
+    /* 77 */ fmt_bad(),
+    /* 78 */ fmt_bad(),
+    /* 79 */ fmt_bad(),
+    /* 7A */ fmt_bad(),
+    /* 7B */ fmt_bad(),
+    /* 7C */ fmt_bad(),
+    /* 7D */ fmt_bad(),
+    /* 7E */ fmt_bad(),
+    /* 7F */ fmt_bad(),
+
+    /* 80 */ fmt_bad(),
+    /* 81 */ fmt_bad(),
+    /* 82 */ fmt_bad(),
+    /* 83 */ fmt_bad(),
+    /* 84 */ fmt_bad(),
+    /* 85 */ fmt_bad(),
+    /* 86 */ fmt_bad(),
+    /* 87 */ fmt_bad(),
+    /* 88 */ fmt_bad(),
+    /* 89 */ fmt_bad(),
+    /* 8A */ fmt_bad(),
+    /* 8B */ fmt_bad(),
+    /* 8C */ fmt_bad(),
+    /* 8D */ fmt_bad(),
+    /* 8E */ fmt_bad(),
+    /* 8F */ fmt_bad(),
+
+    /* 90 */ fmt_bad(),
+    /* 91 */ fmt_bad(),
+    /* 92 */ fmt_bad(),
+    /* 93 */ fmt_bad(),
+    /* 94 */ fmt_bad(),
+    /* 95 */ fmt_bad(),
+    /* 96 */ fmt_bad(),
+    /* 97 */ fmt_bad(),
+    /* 98 */ fmt_bad(),
+    /* 99 */ fmt_bad(),
+    /* 9A */ fmt_bad(),
+    /* 9B */ fmt_bad(),
+    /* 9C */ fmt_bad(),
+    /* 9D */ fmt_bad(),
+    /* 9E */ fmt_bad(),
+    /* 9F */ fmt_bad(),
+
+    /* A0 */ fmt_bad(),
+    /* A1 */ fmt_bad(),
+    /* A2 */ fmt_bad(),
+    /* A3 */ fmt_bad(),
+    /* A4 */ fmt_bad(),
+    /* A5 */ fmt_bad(),
+    /* A6 */ fmt_bad(),
+    /* A7 */ fmt_bad(),
+    /* A8 */ fmt_bad(),
+    /* A9 */ fmt_bad(),
+    /* AA */ fmt_bad(),
+    /* AB */ fmt_bad(),
+    /* AC */ fmt_bad(),
+    /* AD */ fmt_bad(),
+    /* AE */ fmt_bad(),
+    /* AF */ fmt_bad(),
+
+    /* B0 */ fmt_bad(),
+    /* B1 */ fmt_bad(),
+    /* B2 */ fmt_bad(),
+    /* B3 */ fmt_bad(),
+    /* B4 */ fmt_bad(),
+    /* B5 */ fmt_bad(),
+    /* B6 */ fmt_bad(),
+    /* B7 */ fmt_bad(),
+    /* B8 */ fmt_bad(),
+    /* B9 */ fmt_bad(),
+    /* BA */ fmt_bad(),
+    /* BB */ fmt_bad(),
+    /* BC */ fmt_bad(),
+    /* BD */ fmt_bad(),
+    /* BE */ fmt_bad(),
+    /* BF */ fmt_bad(),
+
+    /* C0 */ fmt_bad(),
+    /* C1 */ fmt_bad(),
+    /* C2 */ fmt_bad(),
+    /* C3 */ fmt_bad(),
+    /* C4 */ fmt_bad(),
+    /* C5 */ fmt_bad(),
+    /* C6 */ fmt_bad(),
+    /* C7 */ fmt_bad(),
+    /* C8 */ fmt_bad(),
+    /* C9 */ fmt_bad(),
+    /* CA */ fmt_bad(),
+    /* CB */ fmt_bad(),
+    /* CC */ fmt("sha1rnds4", 0, OPND_Vdq, OPND_Wdq, OPND_Ib),
+    /* CD */ fmt_bad(),
+    /* CE */ fmt("gf2p8affineqb", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Ib),
+    /* CF */ fmt("gf2p8affineinvqb", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Ib),
+
+    /* D0 */ fmt_bad(),
+    /* D1 */ fmt_bad(),
+    /* D2 */ fmt_bad(),
+    /* D3 */ fmt_bad(),
+    /* D4 */ fmt_bad(),
+    /* D5 */ fmt_bad(),
+    /* D6 */ fmt_bad(),
+    /* D7 */ fmt_bad(),
+    /* D8 */ fmt_bad(),
+    /* D9 */ fmt_bad(),
+    /* DA */ fmt_bad(),
+    /* DB */ fmt_bad(),
+    /* DC */ fmt_bad(),
+    /* DD */ fmt_bad(),
+    /* DE */ fmt_bad(),
+    /* DF */ fmt("aeskeygenassist", 0, OPND_Vdq, OPND_Wdq, OPND_Ib),
+
+    /* E0 */ fmt_bad(),
+    /* E1 */ fmt_bad(),
+    /* E2 */ fmt_bad(),
+    /* E3 */ fmt_bad(),
+    /* E4 */ fmt_bad(),
+    /* E5 */ fmt_bad(),
+    /* E6 */ fmt_bad(),
+    /* E7 */ fmt_bad(),
+    /* E8 */ fmt_bad(),
+    /* E9 */ fmt_bad(),
+    /* EA */ fmt_bad(),
+    /* EB */ fmt_bad(),
+    /* EC */ fmt_bad(),
+    /* ED */ fmt_bad(),
+    /* EE */ fmt_bad(),
+    /* EF */ fmt_bad(),
+
+    /* F0 */ fmt("rorx", FMT_NO_V, OPND_Gy, OPND_Ey, OPND_Ib),
+    /* F1 */ fmt_bad(),
+    /* F2 */ fmt_bad(),
+    /* F3 */ fmt_bad(),
+    /* F4 */ fmt_bad(),
+    /* F5 */ fmt_bad(),
+    /* F6 */ fmt_bad(),
+    /* F7 */ fmt_bad(),
+    /* F8 */ fmt_bad(),
+    /* F9 */ fmt_bad(),
+    /* FA */ fmt_bad(),
+    /* FB */ fmt_bad(),
+    /* FC */ fmt_bad(),
+    /* FD */ fmt_bad(),
+    /* FE */ fmt_bad(),
+    /* FF */ fmt_bad(),
+};
+
+/*
+ * Opcode tables by OpcodeMap (maps 0-3)
+ */
+static const FormatEntry* const g_format_maps[4] = {
+    g_format_map_1byte, g_format_map_0f, g_format_map_0f38, g_format_map_0f3a
+};
+
+/*
+ * Group entries, indexed by [group row][ModR/M.reg]
+ * Rows up to GROUP_ROW_COUNT follow GroupRow; GRP_82 decodes like GRP_80.
+ */
+static constexpr FormatEntry g_format_group_table[FORMAT_GROUP_ROW_COUNT][8] = {
+    /* GRP_NONE */ {
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+    },
+    /* 80 - Group 1 r/m8, imm8 */ {
+        fmt("add", 0, OPND_Eb, OPND_Ib),
+        fmt("or", 0, OPND_Eb, OPND_Ib),
+        fmt("adc", 0, OPND_Eb, OPND_Ib),
+        fmt("sbb", 0, OPND_Eb, OPND_Ib),
+        fmt("and", 0, OPND_Eb, OPND_Ib),
+        fmt("sub", 0, OPND_Eb, OPND_Ib),
+        fmt("xor", 0, OPND_Eb, OPND_Ib),
+        fmt("cmp", 0, OPND_Eb, OPND_Ib),
+    },
+    /* 81 - Group 1 r/m, imm */ {
+        fmt("add", 0, OPND_Ev, OPND_Iz),
+        fmt("or", 0, OPND_Ev, OPND_Iz),
+        fmt("adc", 0, OPND_Ev, OPND_Iz),
+        fmt("sbb", 0, OPND_Ev, OPND_Iz),
+        fmt("and", 0, OPND_Ev, OPND_Iz),
+        fmt("sub", 0, OPND_Ev, OPND_Iz),
+        fmt("xor", 0, OPND_Ev, OPND_Iz),
+        fmt("cmp", 0, OPND_Ev, OPND_Iz),
+    },
+    /* 83 - Group 1 r/m, imm8 */ {
+        fmt("add", 0, OPND_Ev, OPND_Ibs),
+        fmt("or", 0, OPND_Ev, OPND_Ibs),
+        fmt("adc", 0, OPND_Ev, OPND_Ibs),
+        fmt("sbb", 0, OPND_Ev, OPND_Ibs),
+        fmt("and", 0, OPND_Ev, OPND_Ibs),
+        fmt("sub", 0, OPND_Ev, OPND_Ibs),
+        fmt("xor", 0, OPND_Ev, OPND_Ibs),
+        fmt("cmp", 0, OPND_Ev, OPND_Ibs),
+    },
+    /* 8F - Group 1A */ {
+        fmt("pop", FMT_D64, OPND_Ev),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+    },
+    /* C0 - Group 2 r/m8, imm8 */ {
+        fmt("rol", 0, OPND_Eb, OPND_Ib),
+        fmt("ror", 0, OPND_Eb, OPND_Ib),
+        fmt("rcl", 0, OPND_Eb, OPND_Ib),
+        fmt("rcr", 0, OPND_Eb, OPND_Ib),
+        fmt("shl", 0, OPND_Eb, OPND_Ib),
+        fmt("shr", 0, OPND_Eb, OPND_Ib),
+        fmt("sal", 0, OPND_Eb, OPND_Ib),
+        fmt("sar", 0, OPND_Eb, OPND_Ib),
+    },
+    /* C1 - Group 2 r/m, imm8 */ {
+        fmt("rol", 0, OPND_Ev, OPND_Ib),
+        fmt("ror", 0, OPND_Ev, OPND_Ib),
+        fmt("rcl", 0, OPND_Ev, OPND_Ib),
+        fmt("rcr", 0, OPND_Ev, OPND_Ib),
+        fmt("shl", 0, OPND_Ev, OPND_Ib),
+        fmt("shr", 0, OPND_Ev, OPND_Ib),
+        fmt("sal", 0, OPND_Ev, OPND_Ib),
+        fmt("sar", 0, OPND_Ev, OPND_Ib),
+    },
+    /* C6 - Group 11 r/m8, imm8 */ {
+        fmt("mov", 0, OPND_Eb, OPND_Ib),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_kind(FMT_KIND_MOD, MOD_C6_7),
+    },
+    /* C7 - Group 11 r/m, imm */ {
+        fmt("mov", 0, OPND_Ev, OPND_Iz),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_kind(FMT_KIND_MOD, MOD_C7_7),
+    },
+    /* D0 - Group 2 r/m8, 1 */ {
+        fmt("rol", 0, OPND_Eb, OPND_1),
+        fmt("ror", 0, OPND_Eb, OPND_1),
+        fmt("rcl", 0, OPND_Eb, OPND_1),
+        fmt("rcr", 0, OPND_Eb, OPND_1),
+        fmt("shl", 0, OPND_Eb, OPND_1),
+        fmt("shr", 0, OPND_Eb, OPND_1),
+        fmt("sal", 0, OPND_Eb, OPND_1),
+        fmt("sar", 0, OPND_Eb, OPND_1),
+    },
+    /* D1 - Group 2 r/m, 1 */ {
+        fmt("rol", 0, OPND_Ev, OPND_1),
+        fmt("ror", 0, OPND_Ev, OPND_1),
+        fmt("rcl", 0, OPND_Ev, OPND_1),
+        fmt("rcr", 0, OPND_Ev, OPND_1),
+        fmt("shl", 0, OPND_Ev, OPND_1),
+        fmt("shr", 0, OPND_Ev, OPND_1),
+        fmt("sal", 0, OPND_Ev, OPND_1),
+        fmt("sar", 0, OPND_Ev, OPND_1),
+    },
+    /* D2 - Group 2 r/m8, CL */ {
+        fmt("rol", 0, OPND_Eb, OPND_CL),
+        fmt("ror", 0, OPND_Eb, OPND_CL),
+        fmt("rcl", 0, OPND_Eb, OPND_CL),
+        fmt("rcr", 0, OPND_Eb, OPND_CL),
+        fmt("shl", 0, OPND_Eb, OPND_CL),
+        fmt("shr", 0, OPND_Eb, OPND_CL),
+        fmt("sal", 0, OPND_Eb, OPND_CL),
+        fmt("sar", 0, OPND_Eb, OPND_CL),
+    },
+    /* D3 - Group 2 r/m, CL */ {
+        fmt("rol", 0, OPND_Ev, OPND_CL),
+        fmt("ror", 0, OPND_Ev, OPND_CL),
+        fmt("rcl", 0, OPND_Ev, OPND_CL),
+        fmt("rcr", 0, OPND_Ev, OPND_CL),
+        fmt("shl", 0, OPND_Ev, OPND_CL),
+        fmt("shr", 0, OPND_Ev, OPND_CL),
+        fmt("sal", 0, OPND_Ev, OPND_CL),
+        fmt("sar", 0, OPND_Ev, OPND_CL),
+    },
+    /* F6 - Group 3 r/m8 */ {
+        fmt("test", 0, OPND_Eb, OPND_Ib),
+        fmt("test", 0, OPND_Eb, OPND_Ib),
+        fmt("not", 0, OPND_Eb),
+        fmt("neg", 0, OPND_Eb),
+        fmt("mul", 0, OPND_Eb),
+        fmt("imul", 0, OPND_Eb),
+        fmt("div", 0, OPND_Eb),
+        fmt("idiv", 0, OPND_Eb),
+    },
+    /* F7 - Group 3 r/m */ {
+        fmt("test", 0, OPND_Ev, OPND_Iz),
+        fmt("test", 0, OPND_Ev, OPND_Iz),
+        fmt("not", 0, OPND_Ev),
+        fmt("neg", 0, OPND_Ev),
+        fmt("mul", 0, OPND_Ev),
+        fmt("imul", 0, OPND_Ev),
+        fmt("div", 0, OPND_Ev),
+        fmt("idiv", 0, OPND_Ev),
+    },
+    /* FE - Group 4 */ {
+        fmt("inc", 0, OPND_Eb),
+        fmt("dec", 0, OPND_Eb),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+    },
+    /* FF - Group 5 */ {
+        fmt("inc", 0, OPND_Ev),
+        fmt("dec", 0, OPND_Ev),
+        fmt("call", FMT_D64 | FMT_INDIRECT, OPND_Ev),
+        fmt("call", FMT_FAR | FMT_INDIRECT, OPND_Mp),
+        fmt("jmp", FMT_D64 | FMT_INDIRECT, OPND_Ev),
+        fmt("jmp", FMT_FAR | FMT_INDIRECT, OPND_Mp),
+        fmt("push", FMT_D64, OPND_Ev),
+        fmt_bad(),
+    },
+    /* 0F 00 - Group 6 */ {
+        fmt("sldt", 0, OPND_Ew),
+        fmt("str", 0, OPND_Ew),
+        fmt("lldt", 0, OPND_Ew),
+        fmt("ltr", 0, OPND_Ew),
+        fmt("verr", 0, OPND_Ew),
+        fmt("verw", 0, OPND_Ew),
+        fmt_bad(),
+        fmt_bad(),
+    },
+    /* 0F 01 - Group 7 */ {
+        fmt_kind(FMT_KIND_MOD, MOD_0F01_0),
+        fmt_kind(FMT_KIND_MOD, MOD_0F01_1),
+        fmt_kind(FMT_KIND_MOD, MOD_0F01_2),
+        fmt_kind(FMT_KIND_MOD, MOD_0F01_3),
+        fmt("smsw", 0, OPND_Ew),
+        fmt_kind(FMT_KIND_MOD, MOD_0F01_5),
+        fmt("lmsw", 0, OPND_Ew),
+        fmt_kind(FMT_KIND_MOD, MOD_0F01_7),
+    },
+    /* 0F 18 - Group 16 */ {
+        fmt("prefetchnta", 0, OPND_Mb),
+        fmt("prefetcht0", 0, OPND_Mb),
+        fmt("prefetcht1", 0, OPND_Mb),
+        fmt("prefetcht2", 0, OPND_Mb),
+        fmt("nop", 0, OPND_Ev),
+        fmt("nop", 0, OPND_Ev),
+        fmt("nop", 0, OPND_Ev),
+        fmt("nop", 0, OPND_Ev),
+    },
+    /* 0F 71 - Group 12 */ {
+        fmt_bad(),
+        fmt_bad(),
+        fmt("psrlw", 0, OPND_Hx, OPND_Nxm, OPND_Ib),
+        fmt_bad(),
+        fmt("psraw", 0, OPND_Hx, OPND_Nxm, OPND_Ib),
+        fmt_bad(),
+        fmt("psllw", 0, OPND_Hx, OPND_Nxm, OPND_Ib),
+        fmt_bad(),
+    },
+    /* 0F 72 - Group 13 */ {
+        fmt_bad(),
+        fmt_bad(),
+        fmt("psrld", 0, OPND_Hx, OPND_Nxm, OPND_Ib),
+        fmt_bad(),
+        fmt("psrad", 0, OPND_Hx, OPND_Nxm, OPND_Ib),
+        fmt_bad(),
+        fmt("pslld", 0, OPND_Hx, OPND_Nxm, OPND_Ib),
+        fmt_bad(),
+    },
+    /* 0F 73 - Group 14 */ {
+        fmt_bad(),
+        fmt_bad(),
+        fmt("psrlq", 0, OPND_Hx, OPND_Nxm, OPND_Ib),
+        fmt("psrldq", 0, OPND_Hx, OPND_Ux, OPND_Ib),
+        fmt_bad(),
+        fmt_bad(),
+        fmt("psllq", 0, OPND_Hx, OPND_Nxm, OPND_Ib),
+        fmt("pslldq", 0, OPND_Hx, OPND_Ux, OPND_Ib),
+    },
+    /* 0F AE - Group 15 */ {
+        fmt_kind(FMT_KIND_MOD, MOD_0FAE_0),
+        fmt_kind(FMT_KIND_MOD, MOD_0FAE_1),
+        fmt_kind(FMT_KIND_MOD, MOD_0FAE_2),
+        fmt_kind(FMT_KIND_MOD, MOD_0FAE_3),
+        fmt_kind(FMT_KIND_MOD, MOD_0FAE_4),
+        fmt_kind(FMT_KIND_MOD, MOD_0FAE_5),
+        fmt_kind(FMT_KIND_MOD, MOD_0FAE_6),
+        fmt_kind(FMT_KIND_MOD, MOD_0FAE_7),
+    },
+    /* 0F B9 - Group 10 */ {
+        fmt("ud1", 0, OPND_Gv, OPND_Ev),
+        fmt("ud1", 0, OPND_Gv, OPND_Ev),
+        fmt("ud1", 0, OPND_Gv, OPND_Ev),
+        fmt("ud1", 0, OPND_Gv, OPND_Ev),
+        fmt("ud1", 0, OPND_Gv, OPND_Ev),
+        fmt("ud1", 0, OPND_Gv, OPND_Ev),
+        fmt("ud1", 0, OPND_Gv, OPND_Ev),
+        fmt("ud1", 0, OPND_Gv, OPND_Ev),
+    },
+    /* 0F BA - Group 8 */ {
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt("bt", 0, OPND_Ev, OPND_Ib),
+        fmt("bts", 0, OPND_Ev, OPND_Ib),
+        fmt("btr", 0, OPND_Ev, OPND_Ib),
+        fmt("btc", 0, OPND_Ev, OPND_Ib),
+    },
+    /* 0F C7 - Group 9 */ {
+        fmt_bad(),
+        fmt_kind(FMT_KIND_MOD, MOD_0FC7_1),
+        fmt_bad(),
+        fmt_kind(FMT_KIND_MOD, MOD_0FC7_3),
+        fmt_kind(FMT_KIND_MOD, MOD_0FC7_4),
+        fmt_kind(FMT_KIND_MOD, MOD_0FC7_5),
+        fmt_kind(FMT_KIND_MOD, MOD_0FC7_6),
+        fmt_kind(FMT_KIND_MOD, MOD_0FC7_7),
+    },
+    /* VEX 0F 38 F3 - Group 17 */ {
+        fmt_bad(),
+        fmt("blsr", FMT_NO_V, OPND_By, OPND_Ey),
+        fmt("blsmsk", FMT_NO_V, OPND_By, OPND_Ey),
+        fmt("blsi", FMT_NO_V, OPND_By, OPND_Ey),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+        fmt_bad(),
+    },
+};
+
+/*
+ * Mandatory prefix entries, indexed by [row][none/66/F3/F2] (the VEX pp encoding)
+ */
+static constexpr FormatEntry g_format_prefix_table[FORMAT_PREFIX_ROW_COUNT][4] = {
+    /* PFX_90 */ {
+        fmt("nop", 0),    // none
+        fmt("nop", 0),    // 66
+        fmt("pause", 0),    // F3
+        fmt("nop", 0),    // F2
+    },
+    /* PFX_0F10 */ {
+        fmt("movups", 0, OPND_Vx, OPND_Wx),    // none
+        fmt("movupd", 0, OPND_Vx, OPND_Wx),    // 66
+        fmt("movss", 0, OPND_Vdq, OPND_Hr, OPND_Wd),    // F3
+        fmt("movsd", 0, OPND_Vdq, OPND_Hr, OPND_Wq),    // F2
+    },
+    /* PFX_0F11 */ {
+        fmt("movups", 0, OPND_Wx, OPND_Vx),    // none
+        fmt("movupd", 0, OPND_Wx, OPND_Vx),    // 66
+        fmt("movss", 0, OPND_Wd, OPND_Hr, OPND_Vdq),    // F3
+        fmt("movsd", 0, OPND_Wq, OPND_Hr, OPND_Vdq),    // F2
+    },
+    /* PFX_0F12 */ {
+        fmt_kind(FMT_KIND_MOD, MOD_0F12),    // none
+        fmt("movlpd", 0, OPND_Vdq, OPND_Hdq, OPND_Mq),    // 66
+        fmt("movsldup", 0, OPND_Vx, OPND_Wx),    // F3
+        fmt("movddup", 0, OPND_Vx, OPND_Wx),    // F2
+    },
+    /* PFX_0F13 */ {
+        fmt("movlps", 0, OPND_Mq, OPND_Vdq),    // none
+        fmt("movlpd", 0, OPND_Mq, OPND_Vdq),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F14 */ {
+        fmt("unpcklps", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // none
+        fmt("unpcklpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F15 */ {
+        fmt("unpckhps", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // none
+        fmt("unpckhpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F16 */ {
+        fmt_kind(FMT_KIND_MOD, MOD_0F16),    // none
+        fmt("movhpd", 0, OPND_Vdq, OPND_Hdq, OPND_Mq),    // 66
+        fmt("movshdup", 0, OPND_Vx, OPND_Wx),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F17 */ {
+        fmt("movhps", 0, OPND_Mq, OPND_Vdq),    // none
+        fmt("movhpd", 0, OPND_Mq, OPND_Vdq),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F1E */ {
+        fmt("nop", 0, OPND_Ev),    // none
+        fmt("nop", 0, OPND_Ev),    // 66
+        fmt_kind(FMT_KIND_MODRM, MRM_F30F1E),    // F3
+        fmt("nop", 0, OPND_Ev),    // F2
+    },
+    /* PFX_0F28 */ {
+        fmt("movaps", 0, OPND_Vx, OPND_Wx),    // none
+        fmt("movapd", 0, OPND_Vx, OPND_Wx),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F29 */ {
+        fmt("movaps", 0, OPND_Wx, OPND_Vx),    // none
+        fmt("movapd", 0, OPND_Wx, OPND_Vx),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F2A */ {
+        fmt("cvtpi2ps", 0, OPND_Vdq, OPND_Qq),    // none
+        fmt("cvtpi2pd", 0, OPND_Vdq, OPND_Qq),    // 66
+        fmt("cvtsi2ss", 0, OPND_Vdq, OPND_Hdq, OPND_Ey),    // F3
+        fmt("cvtsi2sd", 0, OPND_Vdq, OPND_Hdq, OPND_Ey),    // F2
+    },
+    /* PFX_0F2B */ {
+        fmt("movntps", 0, OPND_Mx, OPND_Vx),    // none
+        fmt("movntpd", 0, OPND_Mx, OPND_Vx),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F2C */ {
+        fmt("cvttps2pi", 0, OPND_Pq, OPND_Wq),    // none
+        fmt("cvttpd2pi", 0, OPND_Pq, OPND_Wdq),    // 66
+        fmt("cvttss2si", 0, OPND_Gy, OPND_Wd),    // F3
+        fmt("cvttsd2si", 0, OPND_Gy, OPND_Wq),    // F2
+    },
+    /* PFX_0F2D */ {
+        fmt("cvtps2pi", 0, OPND_Pq, OPND_Wq),    // none
+        fmt("cvtpd2pi", 0, OPND_Pq, OPND_Wdq),    // 66
+        fmt("cvtss2si", 0, OPND_Gy, OPND_Wd),    // F3
+        fmt("cvtsd2si", 0, OPND_Gy, OPND_Wq),    // F2
+    },
+    /* PFX_0F2E */ {
+        fmt("ucomiss", 0, OPND_Vdq, OPND_Wd),    // none
+        fmt("ucomisd", 0, OPND_Vdq, OPND_Wq),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F2F */ {
+        fmt("comiss", 0, OPND_Vdq, OPND_Wd),    // none
+        fmt("comisd", 0, OPND_Vdq, OPND_Wq),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F50 */ {
+        fmt("movmskps", 0, OPND_Gd, OPND_Ux),    // none
+        fmt("movmskpd", 0, OPND_Gd, OPND_Ux),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F51 */ {
+        fmt("sqrtps", 0, OPND_Vx, OPND_Wx),    // none
+        fmt("sqrtpd", 0, OPND_Vx, OPND_Wx),    // 66
+        fmt("sqrtss", 0, OPND_Vdq, OPND_Hdq, OPND_Wd),    // F3
+        fmt("sqrtsd", 0, OPND_Vdq, OPND_Hdq, OPND_Wq),    // F2
+    },
+    /* PFX_0F52 */ {
+        fmt("rsqrtps", 0, OPND_Vx, OPND_Wx),    // none
+        fmt_bad(),    // 66
+        fmt("rsqrtss", 0, OPND_Vdq, OPND_Hdq, OPND_Wd),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F53 */ {
+        fmt("rcpps", 0, OPND_Vx, OPND_Wx),    // none
+        fmt_bad(),    // 66
+        fmt("rcpss", 0, OPND_Vdq, OPND_Hdq, OPND_Wd),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F54 */ {
+        fmt("andps", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // none
+        fmt("andpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F55 */ {
+        fmt("andnps", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // none
+        fmt("andnpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F56 */ {
+        fmt("orps", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // none
+        fmt("orpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F57 */ {
+        fmt("xorps", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // none
+        fmt("xorpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F58 */ {
+        fmt("addps", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // none
+        fmt("addpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt("addss", 0, OPND_Vdq, OPND_Hdq, OPND_Wd),    // F3
+        fmt("addsd", 0, OPND_Vdq, OPND_Hdq, OPND_Wq),    // F2
+    },
+    /* PFX_0F59 */ {
+        fmt("mulps", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // none
+        fmt("mulpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt("mulss", 0, OPND_Vdq, OPND_Hdq, OPND_Wd),    // F3
+        fmt("mulsd", 0, OPND_Vdq, OPND_Hdq, OPND_Wq),    // F2
+    },
+    /* PFX_0F5A */ {
+        fmt("cvtps2pd", 0, OPND_Vx, OPND_Wh),    // none
+        fmt("cvtpd2ps", 0, OPND_Vh, OPND_Wx),    // 66
+        fmt("cvtss2sd", 0, OPND_Vdq, OPND_Hdq, OPND_Wd),    // F3
+        fmt("cvtsd2ss", 0, OPND_Vdq, OPND_Hdq, OPND_Wq),    // F2
+    },
+    /* PFX_0F5B */ {
+        fmt("cvtdq2ps", 0, OPND_Vx, OPND_Wx),    // none
+        fmt("cvtps2dq", 0, OPND_Vx, OPND_Wx),    // 66
+        fmt("cvttps2dq", 0, OPND_Vx, OPND_Wx),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F5C */ {
+        fmt("subps", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // none
+        fmt("subpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt("subss", 0, OPND_Vdq, OPND_Hdq, OPND_Wd),    // F3
+        fmt("subsd", 0, OPND_Vdq, OPND_Hdq, OPND_Wq),    // F2
+    },
+    /* PFX_0F5D */ {
+        fmt("minps", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // none
+        fmt("minpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt("minss", 0, OPND_Vdq, OPND_Hdq, OPND_Wd),    // F3
+        fmt("minsd", 0, OPND_Vdq, OPND_Hdq, OPND_Wq),    // F2
+    },
+    /* PFX_0F5E */ {
+        fmt("divps", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // none
+        fmt("divpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt("divss", 0, OPND_Vdq, OPND_Hdq, OPND_Wd),    // F3
+        fmt("divsd", 0, OPND_Vdq, OPND_Hdq, OPND_Wq),    // F2
+    },
+    /* PFX_0F5F */ {
+        fmt("maxps", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // none
+        fmt("maxpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt("maxss", 0, OPND_Vdq, OPND_Hdq, OPND_Wd),    // F3
+        fmt("maxsd", 0, OPND_Vdq, OPND_Hdq, OPND_Wq),    // F2
+    },
+    /* PFX_0F6C */ {
+        fmt_bad(),    // none
+        fmt("punpcklqdq", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F6D */ {
+        fmt_bad(),    // none
+        fmt("punpckhqdq", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F6E */ {
+        fmt("mov", FMT_SUFFIX_DQ, OPND_Pq, OPND_Ey),    // none
+        fmt("mov", FMT_SUFFIX_DQ, OPND_Vdq, OPND_Ey),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F6F */ {
+        fmt("movq", 0, OPND_Pq, OPND_Qq),    // none
+        fmt("movdqa", FMT_SUFFIX_EVEX_3264, OPND_Vx, OPND_Wx),    // 66
+        fmt("movdqu", FMT_SUFFIX_EVEX_3264, OPND_Vx, OPND_Wx),    // F3
+        fmt("movdqu", FMT_SUFFIX_EVEX_816, OPND_Vx, OPND_Wx),    // F2
+    },
+    /* PFX_0F70 */ {
+        fmt("pshufw", 0, OPND_Pq, OPND_Qq, OPND_Ib),    // none
+        fmt("pshufd", 0, OPND_Vx, OPND_Wx, OPND_Ib),    // 66
+        fmt("pshufhw", 0, OPND_Vx, OPND_Wx, OPND_Ib),    // F3
+        fmt("pshuflw", 0, OPND_Vx, OPND_Wx, OPND_Ib),    // F2
+    },
+    /* PFX_0F7C */ {
+        fmt_bad(),    // none
+        fmt("haddpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt_bad(),    // F3
+        fmt("haddps", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // F2
+    },
+    /* PFX_0F7D */ {
+        fmt_bad(),    // none
+        fmt("hsubpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt_bad(),    // F3
+        fmt("hsubps", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // F2
+    },
+    /* PFX_0F7E */ {
+        fmt("mov", FMT_SUFFIX_DQ, OPND_Ey, OPND_Pq),    // none
+        fmt("mov", FMT_SUFFIX_DQ, OPND_Ey, OPND_Vdq),    // 66
+        fmt("movq", 0, OPND_Vdq, OPND_Wq),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F7F */ {
+        fmt("movq", 0, OPND_Qq, OPND_Pq),    // none
+        fmt("movdqa", FMT_SUFFIX_EVEX_3264, OPND_Wx, OPND_Vx),    // 66
+        fmt("movdqu", FMT_SUFFIX_EVEX_3264, OPND_Wx, OPND_Vx),    // F3
+        fmt("movdqu", FMT_SUFFIX_EVEX_816, OPND_Wx, OPND_Vx),    // F2
+    },
+    /* PFX_F30FAE_0 */ {
+        fmt_bad(),    // none
+        fmt_bad(),    // 66
+        fmt("rdfsbase", 0, OPND_Ry),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_F30FAE_1 */ {
+        fmt_bad(),    // none
+        fmt_bad(),    // 66
+        fmt("rdgsbase", 0, OPND_Ry),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_F30FAE_2 */ {
+        fmt_bad(),    // none
+        fmt_bad(),    // 66
+        fmt("wrfsbase", 0, OPND_Ry),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_F30FAE_3 */ {
+        fmt_bad(),    // none
+        fmt_bad(),    // 66
+        fmt("wrgsbase", 0, OPND_Ry),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0FB8 */ {
+        fmt_bad(),    // none
+        fmt_bad(),    // 66
+        fmt("popcnt", 0, OPND_Gv, OPND_Ev),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0FBC */ {
+        fmt("bsf", 0, OPND_Gv, OPND_Ev),    // none
+        fmt("bsf", 0, OPND_Gv, OPND_Ev),    // 66
+        fmt("tzcnt", 0, OPND_Gv, OPND_Ev),    // F3
+        fmt("bsf", 0, OPND_Gv, OPND_Ev),    // F2
+    },
+    /* PFX_0FBD */ {
+        fmt("bsr", 0, OPND_Gv, OPND_Ev),    // none
+        fmt("bsr", 0, OPND_Gv, OPND_Ev),    // 66
+        fmt("lzcnt", 0, OPND_Gv, OPND_Ev),    // F3
+        fmt("bsr", 0, OPND_Gv, OPND_Ev),    // F2
+    },
+    /* PFX_0FC2 */ {
+        fmt("cmpps", 0, OPND_VK, OPND_Hx, OPND_Wx, OPND_Ib),    // none
+        fmt("cmppd", 0, OPND_VK, OPND_Hx, OPND_Wx, OPND_Ib),    // 66
+        fmt("cmpss", 0, OPND_VK, OPND_Hdq, OPND_Wd, OPND_Ib),    // F3
+        fmt("cmpsd", 0, OPND_VK, OPND_Hdq, OPND_Wq, OPND_Ib),    // F2
+    },
+    /* PFX_0FC4 */ {
+        fmt("pinsrw", 0, OPND_Pq, OPND_Edw, OPND_Ib),    // none
+        fmt("pinsrw", 0, OPND_Vdq, OPND_Hdq, OPND_Edw, OPND_Ib),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0FC5 */ {
+        fmt("pextrw", 0, OPND_Gd, OPND_Nq, OPND_Ib),    // none
+        fmt("pextrw", 0, OPND_Gd, OPND_Udq, OPND_Ib),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0FC6 */ {
+        fmt("shufps", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Ib),    // none
+        fmt("shufpd", 0, OPND_Vx, OPND_Hx, OPND_Wx, OPND_Ib),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0FC7_7 */ {
+        fmt("rdseed", 0, OPND_Rv),    // none
+        fmt("rdseed", 0, OPND_Rv),    // 66
+        fmt("rdpid", 0, OPND_Rq64),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0FD0 */ {
+        fmt_bad(),    // none
+        fmt("addsubpd", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // 66
+        fmt_bad(),    // F3
+        fmt("addsubps", 0, OPND_Vx, OPND_Hx, OPND_Wx),    // F2
+    },
+    /* PFX_0FD6 */ {
+        fmt_bad(),    // none
+        fmt("movq", 0, OPND_Wq, OPND_Vdq),    // 66
+        fmt("movq2dq", 0, OPND_Vdq, OPND_Nq),    // F3
+        fmt("movdq2q", 0, OPND_Pq, OPND_Udq),    // F2
+    },
+    /* PFX_0FE6 */ {
+        fmt_bad(),    // none
+        fmt("cvttpd2dq", 0, OPND_Vh, OPND_Wx),    // 66
+        fmt("cvtdq2pd", 0, OPND_Vx, OPND_Wh),    // F3
+        fmt("cvtpd2dq", 0, OPND_Vh, OPND_Wx),    // F2
+    },
+    /* PFX_0FE7 */ {
+        fmt("movntq", 0, OPND_Mq, OPND_Pq),    // none
+        fmt("movntdq", 0, OPND_Mx, OPND_Vx),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0FF0 */ {
+        fmt_bad(),    // none
+        fmt_bad(),    // 66
+        fmt_bad(),    // F3
+        fmt("lddqu", 0, OPND_Vx, OPND_Mx),    // F2
+    },
+    /* PFX_0FF7 */ {
+        fmt("maskmovq", 0, OPND_Pq, OPND_Nq),    // none
+        fmt("maskmovdqu", 0, OPND_Vdq, OPND_Udq),    // 66
+        fmt_bad(),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F3826 */ {
+        fmt_bad(),    // none
+        fmt("ptestm", FMT_SUFFIX_BW, OPND_VK, OPND_Hx, OPND_Wx),    // 66
+        fmt("ptestnm", FMT_SUFFIX_BW, OPND_VK, OPND_Hx, OPND_Wx),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F3827 */ {
+        fmt_bad(),    // none
+        fmt("ptestm", FMT_SUFFIX_DQ, OPND_VK, OPND_Hx, OPND_Wx),    // 66
+        fmt("ptestnm", FMT_SUFFIX_DQ, OPND_VK, OPND_Hx, OPND_Wx),    // F3
+        fmt_bad(),    // F2
+    },
+    /* PFX_0F38F0 */ {
+        fmt("movbe", 0, OPND_Gv, OPND_Mv),    // none
+        fmt("movbe", 0, OPND_Gv, OPND_Mv),    // 66
+        fmt_bad(),    // F3
+        fmt("crc32", 0, OPND_Gy, OPND_Eb),    // F2
+    },
+    /* PFX_0F38F1 */ {
+        fmt("movbe", 0, OPND_Mv, OPND_Gv),    // none
+        fmt("movbe", 0, OPND_Mv, OPND_Gv),    // 66
+        fmt_bad(),    // F3
+        fmt("crc32", 0, OPND_Gy, OPND_Ev),    // F2
+    },
+    /* PFX_0F38F5 */ {
+        fmt("bzhi", FMT_NO_V, OPND_Gy, OPND_Ey, OPND_By),    // none
+        fmt("wruss", FMT_SUFFIX_DQ, OPND_My, OPND_Gy),    // 66
+        fmt("pext", FMT_NO_V, OPND_Gy, OPND_By, OPND_Ey),    // F3
+        fmt("pdep", FMT_NO_V, OPND_Gy, OPND_By, OPND_Ey),    // F2
+    },
+    /* PFX_0F38F6 */ {
+        fmt("wrss", FMT_SUFFIX_DQ, OPND_My, OPND_Gy),    // none
+        fmt("adcx", 0, OPND_Gy, OPND_Ey),    // 66
+        fmt("adox", 0, OPND_Gy, OPND_Ey),    // F3
+        fmt("mulx", FMT_NO_V, OPND_Gy, OPND_By, OPND_Ey),    // F2
+    },
+    /* PFX_0F38F7 */ {
+        fmt("bextr", FMT_NO_V, OPND_Gy, OPND_Ey, OPND_By),    // none
+        fmt("shlx", FMT_NO_V, OPND_Gy, OPND_Ey, OPND_By),    // 66
+        fmt("sarx", FMT_NO_V, OPND_Gy, OPND_Ey, OPND_By),    // F3
+        fmt("shrx", FMT_NO_V, OPND_Gy, OPND_Ey, OPND_By),    // F2
+    },
+    /* PFX_0F38F8 */ {
+        fmt_bad(),    // none
+        fmt("movdir64b", 0, OPND_Gq64, OPND_M),    // 66
+        fmt("enqcmds", 0, OPND_Gq64, OPND_M),    // F3
+        fmt("enqcmd", 0, OPND_Gq64, OPND_M),    // F2
+    },
+};
+
+/*
+ * Size entries, indexed by [row][16/32/64-bit operand or address size]
+ */
+static constexpr FormatEntry g_format_size_table[FORMAT_SIZE_ROW_COUNT][3] = {
+    /* SIZE_60 */ {
+        fmt("pusha", 0),    // 16-bit
+        fmt("pushad", 0),    // 32-bit
+        fmt_bad(),    // 64-bit
+    },
+    /* SIZE_61 */ {
+        fmt("popa", 0),    // 16-bit
+        fmt("popad", 0),    // 32-bit
+        fmt_bad(),    // 64-bit
+    },
+    /* SIZE_98 */ {
+        fmt_kind(FMT_KIND_SYNTAX, SYN_CBW),    // 16-bit
+        fmt_kind(FMT_KIND_SYNTAX, SYN_CWDE),    // 32-bit
+        fmt_kind(FMT_KIND_SYNTAX, SYN_CDQE),    // 64-bit
+    },
+    /* SIZE_99 */ {
+        fmt_kind(FMT_KIND_SYNTAX, SYN_CWD),    // 16-bit
+        fmt_kind(FMT_KIND_SYNTAX, SYN_CDQ),    // 32-bit
+        fmt_kind(FMT_KIND_SYNTAX, SYN_CQO),    // 64-bit
+    },
+    /* SIZE_9C */ {
+        fmt("pushf", 0),    // 16-bit
+        fmt("pushfd", 0),    // 32-bit
+        fmt("pushfq", 0),    // 64-bit
+    },
+    /* SIZE_9D */ {
+        fmt("popf", 0),    // 16-bit
+        fmt("popfd", 0),    // 32-bit
+        fmt("popfq", 0),    // 64-bit
+    },
+    /* SIZE_CF */ {
+        fmt("iret", 0),    // 16-bit
+        fmt("iretd", 0),    // 32-bit
+        fmt("iretq", 0),    // 64-bit
+    },
+    /* SIZE_E3 */ {
+        fmt("jcxz", 0, OPND_Jb),    // 16-bit
+        fmt("jecxz", 0, OPND_Jb),    // 32-bit
+        fmt("jrcxz", 0, OPND_Jb),    // 64-bit
+    },
+    /* SIZE_0FC7_1 */ {
+        fmt("cmpxchg8b", 0, OPND_Mq),    // 16-bit
+        fmt("cmpxchg8b", 0, OPND_Mq),    // 32-bit
+        fmt("cmpxchg16b", 0, OPND_Mdq),    // 64-bit
+    },
+};
+
+/*
+ * Memory/register form entries, indexed by [row][ModR/M.mod == 11]
+ */
+static constexpr FormatEntry g_format_mod_table[FORMAT_MOD_ROW_COUNT][2] = {
+    /* MOD_C6_7 */ {
+        fmt_bad(),    // memory
+        fmt_kind(FMT_KIND_MODRM, MRM_C6F8),    // register
+    },
+    /* MOD_C7_7 */ {
+        fmt_bad(),    // memory
+        fmt_kind(FMT_KIND_MODRM, MRM_C7F8),    // register
+    },
+    /* MOD_0F01_0 */ {
+        fmt("sgdt", 0, OPND_M),    // memory
+        fmt_kind(FMT_KIND_MODRM, MRM_0F01),    // register
+    },
+    /* MOD_0F01_1 */ {
+        fmt("sidt", 0, OPND_M),    // memory
+        fmt_kind(FMT_KIND_MODRM, MRM_0F01),    // register
+    },
+    /* MOD_0F01_2 */ {
+        fmt("lgdt", 0, OPND_M),    // memory
+        fmt_kind(FMT_KIND_MODRM, MRM_0F01),    // register
+    },
+    /* MOD_0F01_3 */ {
+        fmt("lidt", 0, OPND_M),    // memory
+        fmt_kind(FMT_KIND_MODRM, MRM_0F01),    // register
+    },
+    /* MOD_0F01_5 */ {
+        fmt_bad(),    // memory
+        fmt_kind(FMT_KIND_MODRM, MRM_0F01),    // register
+    },
+    /* MOD_0F01_7 */ {
+        fmt("invlpg", 0, OPND_M),    // memory
+        fmt_kind(FMT_KIND_MODRM, MRM_0F01),    // register
+    },
+    /* MOD_0F12 */ {
+        fmt("movlps", 0, OPND_Vdq, OPND_Hdq, OPND_Mq),    // memory
+        fmt("movhlps", 0, OPND_Vdq, OPND_Hdq, OPND_Udq),    // register
+    },
+    /* MOD_0F16 */ {
+        fmt("movhps", 0, OPND_Vdq, OPND_Hdq, OPND_Mq),    // memory
+        fmt("movlhps", 0, OPND_Vdq, OPND_Hdq, OPND_Udq),    // register
+    },
+    /* MOD_0FAE_0 */ {
+        fmt("fxsave", 0, OPND_M),    // memory
+        fmt_kind(FMT_KIND_PREFIX, PFX_F30FAE_0),    // register
+    },
+    /* MOD_0FAE_1 */ {
+        fmt("fxrstor", 0, OPND_M),    // memory
+        fmt_kind(FMT_KIND_PREFIX, PFX_F30FAE_1),    // register
+    },
+    /* MOD_0FAE_2 */ {
+        fmt("ldmxcsr", 0, OPND_Md),    // memory
+        fmt_kind(FMT_KIND_PREFIX, PFX_F30FAE_2),    // register
+    },
+    /* MOD_0FAE_3 */ {
+        fmt("stmxcsr", 0, OPND_Md),    // memory
+        fmt_kind(FMT_KIND_PREFIX, PFX_F30FAE_3),    // register
+    },
+    /* MOD_0FAE_4 */ {
+        fmt("xsave", 0, OPND_M),    // memory
+        fmt_bad(),    // register
+    },
+    /* MOD_0FAE_5 */ {
+        fmt("xrstor", 0, OPND_M),    // memory
+        fmt("lfence", 0),    // register
+    },
+    /* MOD_0FAE_6 */ {
+        fmt("xsaveopt", 0, OPND_M),    // memory
+        fmt("mfence", 0),    // register
+    },
+    /* MOD_0FAE_7 */ {
+        fmt("clflush", 0, OPND_M),    // memory
+        fmt("sfence", 0),    // register
+    },
+    /* MOD_0FC7_1 */ {
+        fmt_kind(FMT_KIND_SIZE, SIZE_0FC7_1),    // memory
+        fmt_bad(),    // register
+    },
+    /* MOD_0FC7_3 */ {
+        fmt("xrstors", 0, OPND_M),    // memory
+        fmt_bad(),    // register
+    },
+    /* MOD_0FC7_4 */ {
+        fmt("xsavec", 0, OPND_M),    // memory
+        fmt_bad(),    // register
+    },
+    /* MOD_0FC7_5 */ {
+        fmt("xsaves", 0, OPND_M),    // memory
+        fmt_bad(),    // register
+    },
+    /* MOD_0FC7_6 */ {
+        fmt("vmptrld", 0, OPND_Mq),    // memory
+        fmt("rdrand", 0, OPND_Rv),    // register
+    },
+    /* MOD_0FC7_7 */ {
+        fmt("vmptrst", 0, OPND_Mq),    // memory
+        fmt_kind(FMT_KIND_PREFIX, PFX_0FC7_7),    // register
+    },
+};
+
+/*
+ * Syntax entries, indexed by [row][DisasmFormat syntax]
+ */
+static constexpr FormatEntry g_format_syntax_table[FORMAT_SYNTAX_ROW_COUNT][2] = {
+    /* SYN_CBW */ {
+        fmt("cbw", 0),    // Intel
+        fmt("cbtw", 0),    // AT&T
+    },
+    /* SYN_CWDE */ {
+        fmt("cwde", 0),    // Intel
+        fmt("cwtl", 0),    // AT&T
+    },
+    /* SYN_CDQE */ {
+        fmt("cdqe", 0),    // Intel
+        fmt("cltq", 0),    // AT&T
+    },
+    /* SYN_CWD */ {
+        fmt("cwd", 0),    // Intel
+        fmt("cwtd", 0),    // AT&T
+    },
+    /* SYN_CDQ */ {
+        fmt("cdq", 0),    // Intel
+        fmt("cltd", 0),    // AT&T
+    },
+    /* SYN_CQO */ {
+        fmt("cqo", 0),    // Intel
+        fmt("cqto", 0),    // AT&T
+    },
+    /* SYN_CA */ {
+        fmt("retf", 0, OPND_Iw),    // Intel
+        fmt("lret", 0, OPND_Iw),    // AT&T
+    },
+    /* SYN_CB */ {
+        fmt("retf", 0),    // Intel
+        fmt("lret", 0),    // AT&T
+    },
+    /* SYN_DC_4 */ {
+        fmt("fsubr", 0, OPND_STi, OPND_ST0),    // Intel
+        fmt("fsub", 0, OPND_STi, OPND_ST0),    // AT&T
+    },
+    /* SYN_DC_5 */ {
+        fmt("fsub", 0, OPND_STi, OPND_ST0),    // Intel
+        fmt("fsubr", 0, OPND_STi, OPND_ST0),    // AT&T
+    },
+    /* SYN_DC_6 */ {
+        fmt("fdivr", 0, OPND_STi, OPND_ST0),    // Intel
+        fmt("fdiv", 0, OPND_STi, OPND_ST0),    // AT&T
+    },
+    /* SYN_DC_7 */ {
+        fmt("fdiv", 0, OPND_STi, OPND_ST0),    // Intel
+        fmt("fdivr", 0, OPND_STi, OPND_ST0),    // AT&T
+    },
+    /* SYN_DE_4 */ {
+        fmt("fsubrp", 0, OPND_STi, OPND_ST0),    // Intel
+        fmt("fsubp", 0, OPND_STi, OPND_ST0),    // AT&T
+    },
+    /* SYN_DE_5 */ {
+        fmt("fsubp", 0, OPND_STi, OPND_ST0),    // Intel
+        fmt("fsubrp", 0, OPND_STi, OPND_ST0),    // AT&T
+    },
+    /* SYN_DE_6 */ {
+        fmt("fdivrp", 0, OPND_STi, OPND_ST0),    // Intel
+        fmt("fdivp", 0, OPND_STi, OPND_ST0),    // AT&T
+    },
+    /* SYN_DE_7 */ {
+        fmt("fdivp", 0, OPND_STi, OPND_ST0),    // Intel
+        fmt("fdivrp", 0, OPND_STi, OPND_ST0),    // AT&T
+    },
+};
+
+/*
+ * Vector length entries, indexed by [row][legacy/VEX.L0/VEX.L1]
+ */
+static constexpr FormatEntry g_format_vexl_table[FORMAT_VEXL_ROW_COUNT][3] = {
+    /* VEXL_0F41 */ {
+        fmt("cmovno", 0, OPND_Gv, OPND_Ev),    // legacy
+        fmt_bad(),    // VEX.L0
+        fmt("kand", FMT_NO_V | FMT_SUFFIX_K, OPND_KG, OPND_KH, OPND_KE),    // VEX.L1
+    },
+    /* VEXL_0F42 */ {
+        fmt("cmovb", 0, OPND_Gv, OPND_Ev),    // legacy
+        fmt_bad(),    // VEX.L0
+        fmt("kandn", FMT_NO_V | FMT_SUFFIX_K, OPND_KG, OPND_KH, OPND_KE),    // VEX.L1
+    },
+    /* VEXL_0F44 */ {
+        fmt("cmove", 0, OPND_Gv, OPND_Ev),    // legacy
+        fmt("knot", FMT_NO_V | FMT_SUFFIX_K, OPND_KG, OPND_KE),    // VEX.L0
+        fmt_bad(),    // VEX.L1
+    },
+    /* VEXL_0F45 */ {
+        fmt("cmovne", 0, OPND_Gv, OPND_Ev),    // legacy
+        fmt_bad(),    // VEX.L0
+        fmt("kor", FMT_NO_V | FMT_SUFFIX_K, OPND_KG, OPND_KH, OPND_KE),    // VEX.L1
+    },
+    /* VEXL_0F46 */ {
+        fmt("cmovbe", 0, OPND_Gv, OPND_Ev),    // legacy
+        fmt_bad(),    // VEX.L0
+        fmt("kxnor", FMT_NO_V | FMT_SUFFIX_K, OPND_KG, OPND_KH, OPND_KE),    // VEX.L1
+    },
+    /* VEXL_0F47 */ {
+        fmt("cmova", 0, OPND_Gv, OPND_Ev),    // legacy
+        fmt_bad(),    // VEX.L0
+        fmt("kxor", FMT_NO_V | FMT_SUFFIX_K, OPND_KG, OPND_KH, OPND_KE),    // VEX.L1
+    },
+    /* VEXL_0F4A */ {
+        fmt("cmovp", 0, OPND_Gv, OPND_Ev),    // legacy
+        fmt_bad(),    // VEX.L0
+        fmt("kadd", FMT_NO_V | FMT_SUFFIX_K, OPND_KG, OPND_KH, OPND_KE),    // VEX.L1
+    },
+    /* VEXL_0F90 */ {
+        fmt("seto", FMT_NO_SUFFIX, OPND_Eb),    // legacy
+        fmt("kmov", FMT_NO_V | FMT_SUFFIX_K, OPND_KG, OPND_KE),    // VEX.L0
+        fmt_bad(),    // VEX.L1
+    },
+    /* VEXL_0F91 */ {
+        fmt("setno", FMT_NO_SUFFIX, OPND_Eb),    // legacy
+        fmt("kmov", FMT_NO_V | FMT_SUFFIX_K, OPND_KE, OPND_KG),    // VEX.L0
+        fmt_bad(),    // VEX.L1
+    },
+    /* VEXL_0F92 */ {
+        fmt("setb", FMT_NO_SUFFIX, OPND_Eb),    // legacy
+        fmt("kmov", FMT_NO_V | FMT_SUFFIX_K, OPND_KG, OPND_Ry),    // VEX.L0
+        fmt_bad(),    // VEX.L1
+    },
+    /* VEXL_0F93 */ {
+        fmt("setae", FMT_NO_SUFFIX, OPND_Eb),    // legacy
+        fmt("kmov", FMT_NO_V | FMT_SUFFIX_K, OPND_Gy, OPND_KE),    // VEX.L0
+        fmt_bad(),    // VEX.L1
+    },
+    /* VEXL_0F98 */ {
+        fmt("sets", FMT_NO_SUFFIX, OPND_Eb),    // legacy
+        fmt("kortest", FMT_NO_V | FMT_SUFFIX_K, OPND_KG, OPND_KE),    // VEX.L0
+        fmt_bad(),    // VEX.L1
+    },
+    /* VEXL_0F99 */ {
+        fmt("setns", FMT_NO_SUFFIX, OPND_Eb),    // legacy
+        fmt("ktest", FMT_NO_V | FMT_SUFFIX_K, OPND_KG, OPND_KE),    // VEX.L0
+        fmt_bad(),    // VEX.L1
+    },
+    /* VEXL_0F77 */ {
+        fmt("emms", 0),    // legacy
+        fmt("zeroupper", FMT_SSE),    // VEX.L0
+        fmt("zeroall", FMT_SSE),    // VEX.L1
+    },
+};
+
+/*
+ * CPU mode entries, indexed by [row][64-bit mode]
+ */
+static constexpr FormatEntry g_format_mode_table[FORMAT_MODE_ROW_COUNT][2] = {
+    /* MODE_63 */ {
+        fmt("arpl", 0, OPND_Ew, OPND_Gw),    // 16/32-bit
+        fmt("movsxd", FMT_ATT_MOVX, OPND_Gv, OPND_Ed),    // 64-bit
+    },
+};
+
+/*
+ * Exact ModR/M lists
+ * Each list ends with a row of ModR/M 00 holding the entry for any other
+ * byte; the listed bytes are all register forms, so 00 never matches.
+ */
+static constexpr FormatModrmRow g_format_modrm_table[FORMAT_MODRM_ROW_COUNT] = {
+    // MRM_C6F8
+    { 0xF8, fmt("xabort", 0, OPND_Ib) },
+    { 0x00, fmt_bad() },
+    // MRM_C7F8
+    { 0xF8, fmt("xbegin", 0, OPND_Jz) },
+    { 0x00, fmt_bad() },
+    // MRM_0F01
+    { 0xC1, fmt("vmcall", 0) },
+    { 0xC2, fmt("vmlaunch", 0) },
+    { 0xC3, fmt("vmresume", 0) },
+    { 0xC4, fmt("vmxoff", 0) },
+    { 0xC5, fmt("pconfig", 0) },
+    { 0xC8, fmt("monitor", 0) },
+    { 0xC9, fmt("mwait", 0) },
+    { 0xCA, fmt("clac", 0) },
+    { 0xCB, fmt("stac", 0) },
+    { 0xCF, fmt("encls", 0) },
+    { 0xD0, fmt("xgetbv", 0) },
+    { 0xD1, fmt("xsetbv", 0) },
+    { 0xD4, fmt("vmfunc", 0) },
+    { 0xD5, fmt("xend", 0) },
+    { 0xD6, fmt("xtest", 0) },
+    { 0xD7, fmt("enclu", 0) },
+    { 0xD8, fmt("vmrun", 0) },
+    { 0xD9, fmt("vmmcall", 0) },
+    { 0xDA, fmt("vmload", 0) },
+    { 0xDB, fmt("vmsave", 0) },
+    { 0xDC, fmt("stgi", 0) },
+    { 0xDD, fmt("clgi", 0) },
+    { 0xDE, fmt("skinit", 0) },
+    { 0xDF, fmt("invlpga", 0) },
+    { 0xE8, fmt("serialize", 0) },
+    { 0xEE, fmt("rdpkru", 0) },
+    { 0xEF, fmt("wrpkru", 0) },
+    { 0xF8, fmt("swapgs", 0) },
+    { 0xF9, fmt("rdtscp", 0) },
+    { 0xFA, fmt("monitorx", 0) },
+    { 0xFB, fmt("mwaitx", 0) },
+    { 0xFC, fmt("clzero", 0) },
+    { 0xFD, fmt("rdpru", 0) },
+    { 0x00, fmt_bad() },
+    // MRM_F30F1E
+    { 0xFA, fmt("endbr64", 0) },
+    { 0xFB, fmt("endbr32", 0) },
+    { 0x00, fmt("nop", 0, OPND_Ev) },
+    // MRM_D9_2
+    { 0xD0, fmt("fnop", 0) },
+    { 0x00, fmt_bad() },
+    // MRM_D9_4
+    { 0xE0, fmt("fchs", 0) },
+    { 0xE1, fmt("fabs", 0) },
+    { 0xE4, fmt("ftst", 0) },
+    { 0xE5, fmt("fxam", 0) },
+    { 0x00, fmt_bad() },
+    // MRM_D9_5
+    { 0xE8, fmt("fld1", 0) },
+    { 0xE9, fmt("fldl2t", 0) },
+    { 0xEA, fmt("fldl2e", 0) },
+    { 0xEB, fmt("fldpi", 0) },
+    { 0xEC, fmt("fldlg2", 0) },
+    { 0xED, fmt("fldln2", 0) },
+    { 0xEE, fmt("fldz", 0) },
+    { 0x00, fmt_bad() },
+    // MRM_D9_6
+    { 0xF0, fmt("f2xm1", 0) },
+    { 0xF1, fmt("fyl2x", 0) },
+    { 0xF2, fmt("fptan", 0) },
+    { 0xF3, fmt("fpatan", 0) },
+    { 0xF4, fmt("fxtract", 0) },
+    { 0xF5, fmt("fprem1", 0) },
+    { 0xF6, fmt("fdecstp", 0) },
+    { 0xF7, fmt("fincstp", 0) },
+    { 0x00, fmt_bad() },
+    // MRM_D9_7
+    { 0xF8, fmt("fprem", 0) },
+    { 0xF9, fmt("fyl2xp1", 0) },
+    { 0xFA, fmt("fsqrt", 0) },
+    { 0xFB, fmt("fsincos", 0) },
+    { 0xFC, fmt("frndint", 0) },
+    { 0xFD, fmt("fscale", 0) },
+    { 0xFE, fmt("fsin", 0) },
+    { 0xFF, fmt("fcos", 0) },
+    { 0x00, fmt_bad() },
+    // MRM_DA_5
+    { 0xE9, fmt("fucompp", 0) },
+    { 0x00, fmt_bad() },
+    // MRM_DB_4
+    { 0xE2, fmt("fnclex", 0) },
+    { 0xE3, fmt("fninit", 0) },
+    { 0x00, fmt_bad() },
+    // MRM_DE_3
+    { 0xD9, fmt("fcompp", 0) },
+    { 0x00, fmt_bad() },
+    // MRM_DF_4
+    { 0xE0, fmt("fnstsw", 0, OPND_AX) },
+    { 0x00, fmt_bad() },
+};
+
+/*
+ * x87 entries, indexed by [opcode - D8][ModR/M.reg]
+ */
+static constexpr FormatEntry g_format_fpu_table[2][8][8] = {
+    {   // memory operand
+        /* D8 */ {
+            fmt("fadd", 0, OPND_Mfs),
+            fmt("fmul", 0, OPND_Mfs),
+            fmt("fcom", 0, OPND_Mfs),
+            fmt("fcomp", 0, OPND_Mfs),
+            fmt("fsub", 0, OPND_Mfs),
+            fmt("fsubr", 0, OPND_Mfs),
+            fmt("fdiv", 0, OPND_Mfs),
+            fmt("fdivr", 0, OPND_Mfs),
+        },
+        /* D9 */ {
+            fmt("fld", 0, OPND_Mfs),
+            fmt_bad(),
+            fmt("fst", 0, OPND_Mfs),
+            fmt("fstp", 0, OPND_Mfs),
+            fmt("fldenv", 0, OPND_M),
+            fmt("fldcw", 0, OPND_Mw),
+            fmt("fnstenv", 0, OPND_M),
+            fmt("fnstcw", 0, OPND_Mw),
+        },
+        /* DA */ {
+            fmt("fiadd", 0, OPND_Mid),
+            fmt("fimul", 0, OPND_Mid),
+            fmt("ficom", 0, OPND_Mid),
+            fmt("ficomp", 0, OPND_Mid),
+            fmt("fisub", 0, OPND_Mid),
+            fmt("fisubr", 0, OPND_Mid),
+            fmt("fidiv", 0, OPND_Mid),
+            fmt("fidivr", 0, OPND_Mid),
+        },
+        /* DB */ {
+            fmt("fild", 0, OPND_Mid),
+            fmt("fisttp", 0, OPND_Mid),
+            fmt("fist", 0, OPND_Mid),
+            fmt("fistp", 0, OPND_Mid),
+            fmt_bad(),
+            fmt("fld", 0, OPND_Mft),
+            fmt_bad(),
+            fmt("fstp", 0, OPND_Mft),
+        },
+        /* DC */ {
+            fmt("fadd", 0, OPND_Mfd),
+            fmt("fmul", 0, OPND_Mfd),
+            fmt("fcom", 0, OPND_Mfd),
+            fmt("fcomp", 0, OPND_Mfd),
+            fmt("fsub", 0, OPND_Mfd),
+            fmt("fsubr", 0, OPND_Mfd),
+            fmt("fdiv", 0, OPND_Mfd),
+            fmt("fdivr", 0, OPND_Mfd),
+        },
+        /* DD */ {
+            fmt("fld", 0, OPND_Mfd),
+            fmt("fisttp", 0, OPND_Miq),
+            fmt("fst", 0, OPND_Mfd),
+            fmt("fstp", 0, OPND_Mfd),
+            fmt("frstor", 0, OPND_M),
+            fmt_bad(),
+            fmt("fnsave", 0, OPND_M),
+            fmt("fnstsw", 0, OPND_Mw),
+        },
+        /* DE */ {
+            fmt("fiadd", 0, OPND_Miw),
+            fmt("fimul", 0, OPND_Miw),
+            fmt("ficom", 0, OPND_Miw),
+            fmt("ficomp", 0, OPND_Miw),
+            fmt("fisub", 0, OPND_Miw),
+            fmt("fisubr", 0, OPND_Miw),
+            fmt("fidiv", 0, OPND_Miw),
+            fmt("fidivr", 0, OPND_Miw),
+        },
+        /* DF */ {
+            fmt("fild", 0, OPND_Miw),
+            fmt("fisttp", 0, OPND_Miw),
+            fmt("fist", 0, OPND_Miw),
+            fmt("fistp", 0, OPND_Miw),
+            fmt("fbld", 0, OPND_Mbcd),
+            fmt("fild", 0, OPND_Miq),
+            fmt("fbstp", 0, OPND_Mbcd),
+            fmt("fistp", 0, OPND_Miq),
+        },
+    },
+    {   // register operand
+        /* D8 */ {
+            fmt("fadd", 0, OPND_ST0, OPND_STi),
+            fmt("fmul", 0, OPND_ST0, OPND_STi),
+            fmt("fcom", 0, OPND_STi),
+            fmt("fcomp", 0, OPND_STi),
+            fmt("fsub", 0, OPND_ST0, OPND_STi),
+            fmt("fsubr", 0, OPND_ST0, OPND_STi),
+            fmt("fdiv", 0, OPND_ST0, OPND_STi),
+            fmt("fdivr", 0, OPND_ST0, OPND_STi),
+        },
+        /* D9 */ {
+            fmt("fld", 0, OPND_STi),
+            fmt("fxch", 0, OPND_STi),
+            fmt_kind(FMT_KIND_MODRM, MRM_D9_2),
+            fmt_bad(),
+            fmt_kind(FMT_KIND_MODRM, MRM_D9_4),
+            fmt_kind(FMT_KIND_MODRM, MRM_D9_5),
+            fmt_kind(FMT_KIND_MODRM, MRM_D9_6),
+            fmt_kind(FMT_KIND_MODRM, MRM_D9_7),
+        },
+        /* DA */ {
+            fmt("fcmovb", 0, OPND_ST0, OPND_STi),
+            fmt("fcmove", 0, OPND_ST0, OPND_STi),
+            fmt("fcmovbe", 0, OPND_ST0, OPND_STi),
+            fmt("fcmovu", 0, OPND_ST0, OPND_STi),
+            fmt_bad(),
+            fmt_kind(FMT_KIND_MODRM, MRM_DA_5),
+            fmt_bad(),
+            fmt_bad(),
+        },
+        /* DB */ {
+            fmt("fcmovnb", 0, OPND_ST0, OPND_STi),
+            fmt("fcmovne", 0, OPND_ST0, OPND_STi),
+            fmt("fcmovnbe", 0, OPND_ST0, OPND_STi),
+            fmt("fcmovnu", 0, OPND_ST0, OPND_STi),
+            fmt_kind(FMT_KIND_MODRM, MRM_DB_4),
+            fmt("fucomi", 0, OPND_ST0, OPND_STi),
+            fmt("fcomi", 0, OPND_ST0, OPND_STi),
+            fmt_bad(),
+        },
+        /* DC */ {
+            fmt("fadd", 0, OPND_STi, OPND_ST0),
+            fmt("fmul", 0, OPND_STi, OPND_ST0),
+            fmt_bad(),
+            fmt_bad(),
+            fmt_kind(FMT_KIND_SYNTAX, SYN_DC_4),
+            fmt_kind(FMT_KIND_SYNTAX, SYN_DC_5),
+            fmt_kind(FMT_KIND_SYNTAX, SYN_DC_6),
+            fmt_kind(FMT_KIND_SYNTAX, SYN_DC_7),
+        },
+        /* DD */ {
+            fmt("ffree", 0, OPND_STi),
+            fmt_bad(),
+            fmt("fst", 0, OPND_STi),
+            fmt("fstp", 0, OPND_STi),
+            fmt("fucom", 0, OPND_STi),
+            fmt("fucomp", 0, OPND_STi),
+            fmt_bad(),
+            fmt_bad(),
+        },
+        /* DE */ {
+            fmt("faddp", 0, OPND_STi, OPND_ST0),
+            fmt("fmulp", 0, OPND_STi, OPND_ST0),
+            fmt_bad(),
+            fmt_kind(FMT_KIND_MODRM, MRM_DE_3),
+            fmt_kind(FMT_KIND_SYNTAX, SYN_DE_4),
+            fmt_kind(FMT_KIND_SYNTAX, SYN_DE_5),
+            fmt_kind(FMT_KIND_SYNTAX, SYN_DE_6),
+            fmt_kind(FMT_KIND_SYNTAX, SYN_DE_7),
+        },
+        /* DF */ {
+            fmt("ffreep", 0, OPND_STi),
+            fmt_bad(),
+            fmt_bad(),
+            fmt_bad(),
+            fmt_kind(FMT_KIND_MODRM, MRM_DF_4),
+            fmt("fucomip", 0, OPND_ST0, OPND_STi),
+            fmt("fcomip", 0, OPND_ST0, OPND_STi),
+            fmt_bad(),
+        },
+    },
+};
+
+/*
+ * Register name classes (g_format_registers)
+ */
+typedef enum {
+    FREG_GPR8 = 0,     // 8-bit registers without REX
+    FREG_GPR8_REX,     // 8-bit registers with REX
+    FREG_GPR16,        // 16-bit registers
+    FREG_GPR32,        // 32-bit registers
+    FREG_GPR64,        // 64-bit registers
+    FREG_SEG,          // Segment registers
+    FREG_CR,           // Control registers
+    FREG_DR,           // Debug registers
+    FREG_MMX,          // MMX registers
+    FREG_XMM,          // XMM registers
+    FREG_YMM,          // YMM registers
+    FREG_ZMM,          // ZMM registers
+    FREG_K,            // Opmask registers
+    FREG_ST,           // x87 registers
+    FREG_CLASS_COUNT
+} FormatRegisterClass;
+
+/*
+ * Register name (8 bytes), copied with one 8-byte move
+ */
+typedef struct {
+    char name[7];
+    uint8_t length;
+} FormatRegister;
+
+template <size_t N>
+constexpr FormatRegister reg(const char (&name)[N]) {
+    static_assert(N <= 8, "register name longer than 7 characters");
+    FormatRegister entry = {};
+
+    for (size_t i = 0; i + 1 < N; i++) {
+        entry.name[i] = name[i];
+    }
+    entry.length = (uint8_t)(N - 1);
+    return entry;
+}
+
+static constexpr FormatRegister g_format_registers[FREG_CLASS_COUNT][32] = {
+    /* FREG_GPR8 */ {
+        reg("al"), reg("cl"), reg("dl"), reg("bl"), reg("ah"), reg("ch"), reg("dh"), reg("bh"),
+    },
+    /* FREG_GPR8_REX */ {
+        reg("al"), reg("cl"), reg("dl"), reg("bl"), reg("spl"), reg("bpl"), reg("sil"), reg("dil"),
+        reg("r8b"), reg("r9b"), reg("r10b"), reg("r11b"), reg("r12b"), reg("r13b"), reg("r14b"), reg("r15b"),
+    },
+    /* FREG_GPR16 */ {
+        reg("ax"), reg("cx"), reg("dx"), reg("bx"), reg("sp"), reg("bp"), reg("si"), reg("di"),
+        reg("r8w"), reg("r9w"), reg("r10w"), reg("r11w"), reg("r12w"), reg("r13w"), reg("r14w"), reg("r15w"),
+    },
+    /* FREG_GPR32 */ {
+        reg("eax"), reg("ecx"), reg("edx"), reg("ebx"), reg("esp"), reg("ebp"), reg("esi"), reg("edi"),
+        reg("r8d"), reg("r9d"), reg("r10d"), reg("r11d"), reg("r12d"), reg("r13d"), reg("r14d"), reg("r15d"),
+    },
+    /* FREG_GPR64 */ {
+        reg("rax"), reg("rcx"), reg("rdx"), reg("rbx"), reg("rsp"), reg("rbp"), reg("rsi"), reg("rdi"),
+        reg("r8"), reg("r9"), reg("r10"), reg("r11"), reg("r12"), reg("r13"), reg("r14"), reg("r15"),
+    },
+    /* FREG_SEG */ {
+        reg("es"), reg("cs"), reg("ss"), reg("ds"), reg("fs"), reg("gs"), reg("sr6"), reg("sr7"),
+    },
+    /* FREG_CR */ {
+        reg("cr0"), reg("cr1"), reg("cr2"), reg("cr3"), reg("cr4"), reg("cr5"), reg("cr6"), reg("cr7"),
+        reg("cr8"), reg("cr9"), reg("cr10"), reg("cr11"), reg("cr12"), reg("cr13"), reg("cr14"), reg("cr15"),
+    },
+    /* FREG_DR */ {
+        reg("dr0"), reg("dr1"), reg("dr2"), reg("dr3"), reg("dr4"), reg("dr5"), reg("dr6"), reg("dr7"),
+        reg("dr8"), reg("dr9"), reg("dr10"), reg("dr11"), reg("dr12"), reg("dr13"), reg("dr14"), reg("dr15"),
+    },
+    /* FREG_MMX */ {
+        reg("mm0"), reg("mm1"), reg("mm2"), reg("mm3"), reg("mm4"), reg("mm5"), reg("mm6"), reg("mm7"),
+    },
+    /* FREG_XMM */ {
+        reg("xmm0"), reg("xmm1"), reg("xmm2"), reg("xmm3"), reg("xmm4"), reg("xmm5"), reg("xmm6"), reg("xmm7"),
+        reg("xmm8"), reg("xmm9"), reg("xmm10"), reg("xmm11"), reg("xmm12"), reg("xmm13"), reg("xmm14"), reg("xmm15"),
+        reg("xmm16"), reg("xmm17"), reg("xmm18"), reg("xmm19"), reg("xmm20"), reg("xmm21"), reg("xmm22"), reg("xmm23"),
+        reg("xmm24"), reg("xmm25"), reg("xmm26"), reg("xmm27"), reg("xmm28"), reg("xmm29"), reg("xmm30"), reg("xmm31"),
+    },
+    /* FREG_YMM */ {
+        reg("ymm0"), reg("ymm1"), reg("ymm2"), reg("ymm3"), reg("ymm4"), reg("ymm5"), reg("ymm6"), reg("ymm7"),
+        reg("ymm8"), reg("ymm9"), reg("ymm10"), reg("ymm11"), reg("ymm12"), reg("ymm13"), reg("ymm14"), reg("ymm15"),
+        reg("ymm16"), reg("ymm17"), reg("ymm18"), reg("ymm19"), reg("ymm20"), reg("ymm21"), reg("ymm22"), reg("ymm23"),
+        reg("ymm24"), reg("ymm25"), reg("ymm26"), reg("ymm27"), reg("ymm28"), reg("ymm29"), reg("ymm30"), reg("ymm31"),
+    },
+    /* FREG_ZMM */ {
+        reg("zmm0"), reg("zmm1"), reg("zmm2"), reg("zmm3"), reg("zmm4"), reg("zmm5"), reg("zmm6"), reg("zmm7"),
+        reg("zmm8"), reg("zmm9"), reg("zmm10"), reg("zmm11"), reg("zmm12"), reg("zmm13"), reg("zmm14"), reg("zmm15"),
+        reg("zmm16"), reg("zmm17"), reg("zmm18"), reg("zmm19"), reg("zmm20"), reg("zmm21"), reg("zmm22"), reg("zmm23"),
+        reg("zmm24"), reg("zmm25"), reg("zmm26"), reg("zmm27"), reg("zmm28"), reg("zmm29"), reg("zmm30"), reg("zmm31"),
+    },
+    /* FREG_K */ {
+        reg("k0"), reg("k1"), reg("k2"), reg("k3"), reg("k4"), reg("k5"), reg("k6"), reg("k7"),
+    },
+    /* FREG_ST */ {
+        reg("st(0)"), reg("st(1)"), reg("st(2)"), reg("st(3)"), reg("st(4)"), reg("st(5)"), reg("st(6)"), reg("st(7)"),
+    },
+};
+
+/*
+ * Entry resolution
+ *
+ * Shared by the formatter and the operand decoder.
+ */
+
+// Operand size in bytes
+template <DisasmMode Mode>
+static inline unsigned int format_operand_size(const InstructionInfo* info, unsigned int flags) {
+    if (Mode == DISASM_MODE_64 && info->rex_w) {
+        return 8;
+    }
+    if ((ModeTraits<Mode>::operand16 != 0) != (info->prefix_66 != 0)) {
+        return 2;
+    }
+    return Mode == DISASM_MODE_64 && (flags & FMT_D64) ? 8 : 4;
+}
+
+// Address size in bytes
+template <DisasmMode Mode>
+static inline unsigned int format_address_size(const InstructionInfo* info) {
+    return info->prefix_67 ? ModeTraits<Mode>::address_size_67 : ModeTraits<Mode>::address_size;
+}
+
+// Vector register size in bytes; EVEX rounding control on register operands implies 512 bits
+static inline unsigned int format_vector_size(const InstructionInfo* info) {
+    if (!HAS_ANY_FLAG(info->flags, FLAG_VEX | FLAG_EVEX)) {
+        return 16;
+    }
+    if (HAS_FLAG(info->flags, FLAG_EVEX) && info->evex_b && info->modrm_mod == MODRM_MOD_REGISTER) {
+        return 64;
+    }
+    return 16U << (info->vex_l > 2 ? 2 : info->vex_l);
+}
+
+// Opcode byte within the map
+static inline unsigned int format_opcode(const InstructionInfo* info) {
+    return info->map == OPCODE_MAP_1BYTE ? info->opcode : info->opcode2;
+}
+
+// Immediate of an operand size, sign-extended from 'bits' and truncated to size bytes
+static inline uint64_t sized_immediate(uint64_t value, unsigned int bits, unsigned int size) {
+    uint64_t extended = (uint64_t)((int64_t)(value << (64 - bits)) >> (64 - bits));
+    return size == 8 ? extended : extended & ((1ULL << (size * 8)) - 1);
+}
+
+// Opmask instruction size letter by VEX.pp and VEX.W: none = w/q, 66 = b/d, F2 = d/q
+static const char g_opmask_letters[4][2] = { { 'w', 'q' }, { 'b', 'd' }, { 0, 0 }, { 'd', 'q' } };
+
+static inline unsigned int opmask_size(const InstructionInfo* info) {
+    switch (g_opmask_letters[info->vex_pp][info->rex_w]) {
+    case 'b': return 1;
+    case 'w': return 2;
+    case 'd': return 4;
+    default: return 8;
+    }
+}
+
+// Mandatory prefix column: none/66/F3/F2
+static inline unsigned int format_prefix_column(const InstructionInfo* info) {
+    if (HAS_ANY_FLAG(info->flags, FLAG_VEX | FLAG_EVEX)) {
+        return info->vex_pp;
+    }
+    if (info->prefix_rep == 0xF3) {
+        return 2;
+    }
+    if (info->prefix_rep == 0xF2) {
+        return 3;
+    }
+    return info->prefix_66 ? 1 : 0;
+}
+
+/*
+ * Function to find the plain entry of an instruction
+ *
+ * att selects the AT&T row of syntax-dependent entries. Returns NULL for
+ * encodings without an entry.
+ */
+template <DisasmMode Mode>
+static const FormatEntry* resolve_format_entry(const InstructionInfo* info, unsigned int att) {
+    unsigned int opcode = format_opcode(info);
+    const FormatEntry* entry;
+
+    if (info->map > OPCODE_MAP_0F3A || HAS_FLAG(info->flags, FLAG_XOP)) {
+        return NULL;
+    }
+
+    entry = &g_format_maps[info->map][opcode];
+
+    // 90 with REX.B is XCHG r8, rAX rather than NOP
+    if (info->map == OPCODE_MAP_1BYTE && opcode == 0x90 && info->rex_b) {
+        entry = &g_format_map_1byte[0x91];
+    }
+
+    for (;;) {
+        switch (FMT_KIND(entry)) {
+        case FMT_KIND_PLAIN:
+            return entry;
+
+        case FMT_KIND_GROUP:
+            entry = &g_format_group_table[entry->index][MODRM_REG(info->modrm)];
+            break;
+
+        case FMT_KIND_PREFIX:
+            entry = &g_format_prefix_table[entry->index][format_prefix_column(info)];
+            break;
+
+        case FMT_KIND_SIZE:
+            // Size rows are indexed by size / 4: 16, 32 and 64 bits
+            entry = &g_format_size_table[entry->index][format_operand_size<Mode>(info, entry->flags) >> 2];
+            break;
+
+        case FMT_KIND_ADDR:
+            entry = &g_format_size_table[entry->index][format_address_size<Mode>(info) >> 2];
+            break;
+
+        case FMT_KIND_MOD:
+            entry = &g_format_mod_table[entry->index][info->modrm_mod == MODRM_MOD_REGISTER];
+            break;
+
+        case FMT_KIND_MODRM: {
+            const FormatModrmRow* row = &g_format_modrm_table[entry->index];
+            while (row->modrm != info->modrm && row->modrm != 0) {
+                row++;
+            }
+            entry = &row->entry;
+            break;
+        }
+
+        case FMT_KIND_SYNTAX:
+            entry = &g_format_syntax_table[entry->index][att];
+            break;
+
+        case FMT_KIND_VEXL:
+            entry = &g_format_vexl_table[entry->index][HAS_ANY_FLAG(info->flags, FLAG_VEX | FLAG_EVEX) ? 1 + (info->vex_l & 1) : 0];
+            break;
+
+        case FMT_KIND_MODE:
+            entry = &g_format_mode_table[entry->index][Mode == DISASM_MODE_64];
+            break;
+
+        case FMT_KIND_FPU:
+            entry = &g_format_fpu_table[info->modrm_mod == MODRM_MOD_REGISTER][(opcode - 0xD8) & 7][MODRM_REG(info->modrm)];
+            break;
+
+        default:
+            return NULL;
+        }
+    }
+}
+
+// Segment register index of a segment override prefix, or -1
+static inline int segment_override(const InstructionInfo* info) {
+    switch (info->prefix_seg) {
+    case 0x26: return REG_ES;
+    case 0x2E: return REG_CS;
+    case 0x36: return REG_SS;
+    case 0x3E: return REG_DS;
+    case 0x64: return REG_FS;
+    case 0x65: return REG_GS;
+    default: return -1;
+    }
+}
+
+/*
+ * Memory operand components
+ */
+typedef struct {
+    int segment;                // Segment register, or -1
+    int base;                   // Base register, or -1
+    int index;                  // Index register, or -1
+    unsigned int base_class;    // Register name class of the base
+    unsigned int index_class;   // Register name class of the index
+    unsigned int scale;         // Index scale factor
+    unsigned int rip;           // RIP/EIP-relative
+    unsigned int has_disp;      // Print the displacement
+    int64_t disp;               // Displacement (absolute address without base and index)
+} MemoryOperand;
+
+// 16-bit addressing base and index registers by ModR/M.rm
+static const int8_t g_base16[8] = { REG_BX, REG_BX, REG_BP, REG_BP, REG_SI, REG_DI, REG_BP, REG_BX };
+static const int8_t g_index16[8] = { REG_SI, REG_DI, REG_SI, REG_DI, -1, -1, -1, -1 };
+
+// vsib_class is the FormatRegisterClass of a VSIB index, or -1
+static inline void decode_memory_operand(const InstructionInfo* info, unsigned int address_size, unsigned int mode64,
+    MemoryOperand* m, int vsib_class) {
+    unsigned int rm = MODRM_RM(info->modrm);
+
+    m->segment = segment_override(info);
+    m->base = -1;
+    m->index = -1;
+    m->scale = 1;
+    m->rip = 0;
+    m->disp = 0;
+
+    if (address_size == 2) {
+        m->base_class = FREG_GPR16;
+        m->index_class = FREG_GPR16;
+        if (info->modrm_mod == MODRM_MOD_INDIRECT && rm == MODRM_RM_DISP16) {
+            m->disp = info->displacement.disp16;
+        }
+        else {
+            m->base = g_base16[rm];
+            m->index = g_index16[rm];
+        }
+    }
+    else {
+        m->base_class = address_size == 8 ? FREG_GPR64 : FREG_GPR32;
+        m->index_class = vsib_class >= 0 ? (unsigned int)vsib_class : m->base_class;
+
+        if (HAS_FLAG(info->flags, FLAG_SIB)) {
+            m->scale = SIB_SCALE_FACTOR(info->sib_scale);
+            if (!(SIB_BASE(info->sib) == SIB_BASE_DISP && info->modrm_mod == MODRM_MOD_INDIRECT)) {
+                m->base = info->sib_base;
+            }
+            if (vsib_class >= 0) {
+                // EVEX.V' extends the VSIB index to registers 16-31
+                m->index = info->sib_index | (HAS_FLAG(info->flags, FLAG_EVEX) ? (info->vex_vvvv & 0x10) : 0);
+            }
+            else if (info->sib_index != SIB_INDEX_NONE) {
+                m->index = info->sib_index;
+            }
+        }
+        else if (info->modrm_mod == MODRM_MOD_INDIRECT && rm == MODRM_RM_DISP32) {
+            // RIP-relative in 64-bit mode, an absolute address otherwise
+            m->rip = mode64;
+        }
+        else {
+            m->base = info->modrm_rm & 0x0F;
+        }
+    }
+
+    if (HAS_FLAG(info->flags, FLAG_DISP8)) {
+        m->disp = (int8_t)info->displacement.disp8 * (int64_t)(info->disp_scale ? info->disp_scale : 1);
+    }
+    else if (HAS_FLAG(info->flags, FLAG_DISP16)) {
+        m->disp = (m->base < 0 && m->index < 0) ? (int64_t)info->displacement.disp16 : (int16_t)info->displacement.disp16;
+    }
+    else if (HAS_FLAG(info->flags, FLAG_DISP32)) {
+        m->disp = (m->base < 0 && m->index < 0 && !m->rip) ? (int64_t)info->displacement.disp32 : (int32_t)info->displacement.disp32;
+    }
+
+    // An encoded displacement is printed even when it is zero
+    m->has_disp = HAS_ANY_FLAG(info->flags, FLAG_MASK_ANY_DISP) || (m->base < 0 && m->index < 0);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdint.h>
+#include "disassm.h"
+#include "disassm_table_op1.h"
+#include "disassm_table_op2.h"
+#include "disassm_table_op3.h"
+
+/*
+ * Per-mode decoder parameters
+ *
+ * Everything the decoder needs to know about the CPU mode is a compile-time
+ * constant of ModeTraits<Mode>, so each decoder instantiation folds the mode
+ * checks away instead of testing a mode variable per instruction.
+ */
+template <DisasmMode Mode>
+struct ModeTraits {
+    // REX prefixes (40-4F) exist only in 64-bit mode; elsewhere they are INC/DEC
+    static constexpr bool rex = Mode == DISASM_MODE_64;
+
+    // Default operand size is 16 bits (toggled by 66)
+    static constexpr unsigned int operand16 = Mode == DISASM_MODE_16;
+
+    // Near branch displacements follow the operand size (fixed rel32 in 64-bit mode)
+    static constexpr bool rel_operand_size = Mode != DISASM_MODE_64;
+
+    // Address size in bytes without and with the 67 prefix
+    static constexpr unsigned int address_size = Mode == DISASM_MODE_64 ? 8 : Mode == DISASM_MODE_32 ? 4 : 2;
+    static constexpr unsigned int address_size_67 = Mode == DISASM_MODE_64 ? 4 : Mode == DISASM_MODE_32 ? 2 : 4;
+};
+
+/*
+ * 1-byte opcodes whose attributes depend on the mode
+ *
+ * g_opcode_table describes the legacy encodings; these entries are patched
+ * in to build the table of each mode.
+ */
+typedef struct {
+    uint8_t opcode;
+    uint8_t attr64;         // 64-bit mode
+    uint8_t attr_legacy;    // 16-bit and 32-bit modes
+} OpcodeModePatch;
+
+static constexpr OpcodeModePatch g_opcode_mode_patches[] = {
+    { 0x06, OPATTR_ERROR, OPATTR_NONE },                        // PUSH ES
+    { 0x07, OPATTR_ERROR, OPATTR_NONE },                        // POP ES
+    { 0x0E, OPATTR_ERROR, OPATTR_NONE },                        // PUSH CS
+    { 0x16, OPATTR_ERROR, OPATTR_NONE },                        // PUSH SS
+    { 0x17, OPATTR_ERROR, OPATTR_NONE },                        // POP SS
+    { 0x1E, OPATTR_ERROR, OPATTR_NONE },                        // PUSH DS
+    { 0x1F, OPATTR_ERROR, OPATTR_NONE },                        // POP DS
+    { 0x27, OPATTR_ERROR, OPATTR_NONE },                        // DAA
+    { 0x2F, OPATTR_ERROR, OPATTR_NONE },                        // DAS
+    { 0x37, OPATTR_ERROR, OPATTR_NONE },                        // AAA
+    { 0x3F, OPATTR_ERROR, OPATTR_NONE },                        // AAS
+    { 0x60, OPATTR_ERROR, OPATTR_NONE },                        // PUSHA/PUSHAD
+    { 0x61, OPATTR_ERROR, OPATTR_NONE },                        // POPA/POPAD
+    { 0x82, OPATTR_ERROR, OPATTR_MODRM | OPATTR_GROUP | OPATTR_IMM8 }, // Group 1 r/m8, imm8 (alias of 80)
+    { 0x9A, OPATTR_ERROR, OPATTR_IMM_P66 | OPATTR_IMM16 },      // CALL ptr16:16/32
+    { 0xCE, OPATTR_ERROR, OPATTR_NONE },                        // INTO
+    { 0xD4, OPATTR_ERROR, OPATTR_IMM8 },                        // AAM imm8
+    { 0xD5, OPATTR_ERROR, OPATTR_IMM8 },                        // AAD imm8
+    { 0xD6, OPATTR_ERROR, OPATTR_NONE },                        // SALC (undocumented)
+    { 0xEA, OPATTR_ERROR, OPATTR_IMM_P66 | OPATTR_IMM16 },      // JMP ptr16:16/32
+};
+
+/*
+ * 1-byte opcode attribute table of a mode, built at compile time
+ */
+typedef struct {
+    uint8_t attr[OPCODE_TABLE_SIZE];
+} OpcodeModeTable;
+
+template <DisasmMode Mode>
+constexpr OpcodeModeTable build_opcode_mode_table() {
+    OpcodeModeTable table = {};
+
+    for (unsigned int i = 0; i < OPCODE_TABLE_SIZE; i++) {
+        table.attr[i] = g_opcode_table[i];
+    }
+
+    for (unsigned int i = 0; i < sizeof(g_opcode_mode_patches) / sizeof(g_opcode_mode_patches[0]); i++) {
+        const OpcodeModePatch& patch = g_opcode_mode_patches[i];
+        table.attr[patch.opcode] = Mode == DISASM_MODE_64 ? patch.attr64 : patch.attr_legacy;
+    }
+
+    return table;
+}
+
+/*
+ * Opcode attribute tables of a mode
+ *
+ * maps[] holds the table of each opcode map, so the map number selects the
+ * table with an indexed load instead of a branch.
+ */
+template <DisasmMode Mode>
+struct ModeTables {
+    static constexpr OpcodeModeTable opcode = build_opcode_mode_table<Mode>();
+    static const uint8_t* const maps[4];
+};
+
+template <DisasmMode Mode>
+constexpr OpcodeModeTable ModeTables<Mode>::opcode;
+
+template <DisasmMode Mode>
+const uint8_t* const ModeTables<Mode>::maps[4] = {
+    ModeTables<Mode>::opcode.attr,  // 1-byte opcodes
+    g_opcode2_table,                // 0F xx
+    g_opcode38_table,               // 0F 38 xx
+    g_opcode3a_table                // 0F 3A xx
+};
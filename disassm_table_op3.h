@@ -0,0 +1,563 @@
+#pragma once
+#include "disassm.h"
+#include "disassm_table_op2.h"
+
+/*
+ * Three-byte opcode attribute table (0F 38 xx)
+ *
+ * SSSE3/SSE4/SHA/AES and system instructions. All of them take a ModR/M
+ * byte and none has an immediate. Opcodes that only exist with a VEX or
+ * EVEX prefix are invalid here; those go through g_vector_opcode_table.
+ */
+static const uint8_t g_opcode38_table[OPCODE_TABLE_SIZE] = {
+    /* 00 */ OPATTR_MODRM,    /* PSHUFB */
+    /* 01 */ OPATTR_MODRM,    /* PHADDW */
+    /* 02 */ OPATTR_MODRM,    /* PHADDD */
+    /* 03 */ OPATTR_MODRM,    /* PHADDSW */
+    /* 04 */ OPATTR_MODRM,    /* PMADDUBSW */
+    /* 05 */ OPATTR_MODRM,    /* PHSUBW */
+    /* 06 */ OPATTR_MODRM,    /* PHSUBD */
+    /* 07 */ OPATTR_MODRM,    /* PHSUBSW */
+    /* 08 */ OPATTR_MODRM,    /* PSIGNB */
+    /* 09 */ OPATTR_MODRM,    /* PSIGNW */
+    /* 0A */ OPATTR_MODRM,    /* PSIGND */
+    /* 0B */ OPATTR_MODRM,    /* PMULHRSW */
+    /* 0C */ OPATTR_ERROR,    /* Invalid */
+    /* 0D */ OPATTR_ERROR,    /* Invalid */
+    /* 0E */ OPATTR_ERROR,    /* Invalid */
+    /* 0F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 10 */ OPATTR_MODRM,    /* PBLENDVB xmm, xmm/m128, <XMM0> */
+    /* 11 */ OPATTR_ERROR,    /* Invalid */
+    /* 12 */ OPATTR_ERROR,    /* Invalid */
+    /* 13 */ OPATTR_ERROR,    /* Invalid */
+    /* 14 */ OPATTR_MODRM,    /* BLENDVPS xmm, xmm/m128, <XMM0> */
+    /* 15 */ OPATTR_MODRM,    /* BLENDVPD xmm, xmm/m128, <XMM0> */
+    /* 16 */ OPATTR_ERROR,    /* Invalid */
+    /* 17 */ OPATTR_MODRM,    /* PTEST */
+    /* 18 */ OPATTR_ERROR,    /* Invalid */
+    /* 19 */ OPATTR_ERROR,    /* Invalid */
+    /* 1A */ OPATTR_ERROR,    /* Invalid */
+    /* 1B */ OPATTR_ERROR,    /* Invalid */
+    /* 1C */ OPATTR_MODRM,    /* PABSB */
+    /* 1D */ OPATTR_MODRM,    /* PABSW */
+    /* 1E */ OPATTR_MODRM,    /* PABSD */
+    /* 1F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 20 */ OPATTR_MODRM,    /* PMOVSXBW */
+    /* 21 */ OPATTR_MODRM,    /* PMOVSXBD */
+    /* 22 */ OPATTR_MODRM,    /* PMOVSXBQ */
+    /* 23 */ OPATTR_MODRM,    /* PMOVSXWD */
+    /* 24 */ OPATTR_MODRM,    /* PMOVSXWQ */
+    /* 25 */ OPATTR_MODRM,    /* PMOVSXDQ */
+    /* 26 */ OPATTR_ERROR,    /* Invalid */
+    /* 27 */ OPATTR_ERROR,    /* Invalid */
+    /* 28 */ OPATTR_MODRM,    /* PMULDQ */
+    /* 29 */ OPATTR_MODRM,    /* PCMPEQQ */
+    /* 2A */ OPATTR_MODRM,    /* MOVNTDQA xmm, m128 */
+    /* 2B */ OPATTR_MODRM,    /* PACKUSDW */
+    /* 2C */ OPATTR_ERROR,    /* Invalid */
+    /* 2D */ OPATTR_ERROR,    /* Invalid */
+    /* 2E */ OPATTR_ERROR,    /* Invalid */
+    /* 2F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 30 */ OPATTR_MODRM,    /* PMOVZXBW */
+    /* 31 */ OPATTR_MODRM,    /* PMOVZXBD */
+    /* 32 */ OPATTR_MODRM,    /* PMOVZXBQ */
+    /* 33 */ OPATTR_MODRM,    /* PMOVZXWD */
+    /* 34 */ OPATTR_MODRM,    /* PMOVZXWQ */
+    /* 35 */ OPATTR_MODRM,    /* PMOVZXDQ */
+    /* 36 */ OPATTR_ERROR,    /* Invalid */
+    /* 37 */ OPATTR_MODRM,    /* PCMPGTQ */
+    /* 38 */ OPATTR_MODRM,    /* PMINSB */
+    /* 39 */ OPATTR_MODRM,    /* PMINSD */
+    /* 3A */ OPATTR_MODRM,    /* PMINUW */
+    /* 3B */ OPATTR_MODRM,    /* PMINUD */
+    /* 3C */ OPATTR_MODRM,    /* PMAXSB */
+    /* 3D */ OPATTR_MODRM,    /* PMAXSD */
+    /* 3E */ OPATTR_MODRM,    /* PMAXUW */
+    /* 3F */ OPATTR_MODRM,    /* PMAXUD */
+
+    /* 40 */ OPATTR_MODRM,    /* PMULLD */
+    /* 41 */ OPATTR_MODRM,    /* PHMINPOSUW */
+    /* 42 */ OPATTR_ERROR,    /* Invalid */
+    /* 43 */ OPATTR_ERROR,    /* Invalid */
+    /* 44 */ OPATTR_ERROR,    /* Invalid */
+    /* 45 */ OPATTR_ERROR,    /* Invalid */
+    /* 46 */ OPATTR_ERROR,    /* Invalid */
+    /* 47 */ OPATTR_ERROR,    /* Invalid */
+    /* 48 */ OPATTR_ERROR,    /* Invalid */
+    /* 49 */ OPATTR_ERROR,    /* Invalid */
+    /* 4A */ OPATTR_ERROR,    /* Invalid */
+    /* 4B */ OPATTR_ERROR,    /* Invalid */
+    /* 4C */ OPATTR_ERROR,    /* Invalid */
+    /* 4D */ OPATTR_ERROR,    /* Invalid */
+    /* 4E */ OPATTR_ERROR,    /* Invalid */
+    /* 4F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 50 */ OPATTR_ERROR,    /* Invalid */
+    /* 51 */ OPATTR_ERROR,    /* Invalid */
+    /* 52 */ OPATTR_ERROR,    /* Invalid */
+    /* 53 */ OPATTR_ERROR,    /* Invalid */
+    /* 54 */ OPATTR_ERROR,    /* Invalid */
+    /* 55 */ OPATTR_ERROR,    /* Invalid */
+    /* 56 */ OPATTR_ERROR,    /* Invalid */
+    /* 57 */ OPATTR_ERROR,    /* Invalid */
+    /* 58 */ OPATTR_ERROR,    /* Invalid */
+    /* 59 */ OPATTR_ERROR,    /* Invalid */
+    /* 5A */ OPATTR_ERROR,    /* Invalid */
+    /* 5B */ OPATTR_ERROR,    /* Invalid */
+    /* 5C */ OPATTR_ERROR,    /* Invalid */
+    /* 5D */ OPATTR_ERROR,    /* Invalid */
+    /* 5E */ OPATTR_ERROR,    /* Invalid */
+    /* 5F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 60 */ OPATTR_ERROR,    /* Invalid */
+    /* 61 */ OPATTR_ERROR,    /* Invalid */
+    /* 62 */ OPATTR_ERROR,    /* Invalid */
+    /* 63 */ OPATTR_ERROR,    /* Invalid */
+    /* 64 */ OPATTR_ERROR,    /* Invalid */
+    /* 65 */ OPATTR_ERROR,    /* Invalid */
+    /* 66 */ OPATTR_ERROR,    /* Invalid */
+    /* 67 */ OPATTR_ERROR,    /* Invalid */
+    /* 68 */ OPATTR_ERROR,    /* Invalid */
+    /* 69 */ OPATTR_ERROR,    /* Invalid */
+    /* 6A */ OPATTR_ERROR,    /* Invalid */
+    /* 6B */ OPATTR_ERROR,    /* Invalid */
+    /* 6C */ OPATTR_ERROR,    /* Invalid */
+    /* 6D */ OPATTR_ERROR,    /* Invalid */
+    /* 6E */ OPATTR_ERROR,    /* Invalid */
+    /* 6F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 70 */ OPATTR_ERROR,    /* Invalid */
+    /* 71 */ OPATTR_ERROR,    /* Invalid */
+    /* 72 */ OPATTR_ERROR,    /* Invalid */
+    /* 73 */ OPATTR_ERROR,    /* Invalid */
+    /* 74 */ OPATTR_ERROR,    /* Invalid */
+    /* 75 */ OPATTR_ERROR,    /* Invalid */
+    /* 76 */ OPATTR_ERROR,    /* Invalid */
+    /* 77 */ OPATTR_ERROR,    /* Invalid */
+    /* 78 */ OPATTR_ERROR,    /* Invalid */
+    /* 79 */ OPATTR_ERROR,    /* Invalid */
+    /* 7A */ OPATTR_ERROR,    /* Invalid */
+    /* 7B */ OPATTR_ERROR,    /* Invalid */
+    /* 7C */ OPATTR_ERROR,    /* Invalid */
+    /* 7D */ OPATTR_ERROR,    /* Invalid */
+    /* 7E */ OPATTR_ERROR,    /* Invalid */
+    /* 7F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 80 */ OPATTR_MODRM,    /* INVEPT r64, m128 */
+    /* 81 */ OPATTR_MODRM,    /* INVVPID r64, m128 */
+    /* 82 */ OPATTR_MODRM,    /* INVPCID r64, m128 */
+    /* 83 */ OPATTR_ERROR,    /* Invalid */
+    /* 84 */ OPATTR_ERROR,    /* Invalid */
+    /* 85 */ OPATTR_ERROR,    /* Invalid */
+    /* 86 */ OPATTR_ERROR,    /* Invalid */
+    /* 87 */ OPATTR_ERROR,    /* Invalid */
+    /* 88 */ OPATTR_ERROR,    /* Invalid */
+    /* 89 */ OPATTR_ERROR,    /* Invalid */
+    /* 8A */ OPATTR_ERROR,    /* Invalid */
+    /* 8B */ OPATTR_ERROR,    /* Invalid */
+    /* 8C */ OPATTR_ERROR,    /* Invalid */
+    /* 8D */ OPATTR_ERROR,    /* Invalid */
+    /* 8E */ OPATTR_ERROR,    /* Invalid */
+    /* 8F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 90 */ OPATTR_ERROR,    /* Invalid */
+    /* 91 */ OPATTR_ERROR,    /* Invalid */
+    /* 92 */ OPATTR_ERROR,    /* Invalid */
+    /* 93 */ OPATTR_ERROR,    /* Invalid */
+    /* 94 */ OPATTR_ERROR,    /* Invalid */
+    /* 95 */ OPATTR_ERROR,    /* Invalid */
+    /* 96 */ OPATTR_ERROR,    /* Invalid */
+    /* 97 */ OPATTR_ERROR,    /* Invalid */
+    /* 98 */ OPATTR_ERROR,    /* Invalid */
+    /* 99 */ OPATTR_ERROR,    /* Invalid */
+    /* 9A */ OPATTR_ERROR,    /* Invalid */
+    /* 9B */ OPATTR_ERROR,    /* Invalid */
+    /* 9C */ OPATTR_ERROR,    /* Invalid */
+    /* 9D */ OPATTR_ERROR,    /* Invalid */
+    /* 9E */ OPATTR_ERROR,    /* Invalid */
+    /* 9F */ OPATTR_ERROR,    /* Invalid */
+
+    /* A0 */ OPATTR_ERROR,    /* Invalid */
+    /* A1 */ OPATTR_ERROR,    /* Invalid */
+    /* A2 */ OPATTR_ERROR,    /* Invalid */
+    /* A3 */ OPATTR_ERROR,    /* Invalid */
+    /* A4 */ OPATTR_ERROR,    /* Invalid */
+    /* A5 */ OPATTR_ERROR,    /* Invalid */
+    /* A6 */ OPATTR_ERROR,    /* Invalid */
+    /* A7 */ OPATTR_ERROR,    /* Invalid */
+    /* A8 */ OPATTR_ERROR,    /* Invalid */
+    /* A9 */ OPATTR_ERROR,    /* Invalid */
+    /* AA */ OPATTR_ERROR,    /* Invalid */
+    /* AB */ OPATTR_ERROR,    /* Invalid */
+    /* AC */ OPATTR_ERROR,    /* Invalid */
+    /* AD */ OPATTR_ERROR,    /* Invalid */
+    /* AE */ OPATTR_ERROR,    /* Invalid */
+    /* AF */ OPATTR_ERROR,    /* Invalid */
+
+    /* B0 */ OPATTR_ERROR,    /* Invalid */
+    /* B1 */ OPATTR_ERROR,    /* Invalid */
+    /* B2 */ OPATTR_ERROR,    /* Invalid */
+    /* B3 */ OPATTR_ERROR,    /* Invalid */
+    /* B4 */ OPATTR_ERROR,    /* Invalid */
+    /* B5 */ OPATTR_ERROR,    /* Invalid */
+    /* B6 */ OPATTR_ERROR,    /* Invalid */
+    /* B7 */ OPATTR_ERROR,    /* Invalid */
+    /* B8 */ OPATTR_ERROR,    /* Invalid */
+    /* B9 */ OPATTR_ERROR,    /* Invalid */
+    /* BA */ OPATTR_ERROR,    /* Invalid */
+    /* BB */ OPATTR_ERROR,    /* Invalid */
+    /* BC */ OPATTR_ERROR,    /* Invalid */
+    /* BD */ OPATTR_ERROR,    /* Invalid */
+    /* BE */ OPATTR_ERROR,    /* Invalid */
+    /* BF */ OPATTR_ERROR,    /* Invalid */
+
+    /* C0 */ OPATTR_ERROR,    /* Invalid */
+    /* C1 */ OPATTR_ERROR,    /* Invalid */
+    /* C2 */ OPATTR_ERROR,    /* Invalid */
+    /* C3 */ OPATTR_ERROR,    /* Invalid */
+    /* C4 */ OPATTR_ERROR,    /* Invalid */
+    /* C5 */ OPATTR_ERROR,    /* Invalid */
+    /* C6 */ OPATTR_ERROR,    /* Invalid */
+    /* C7 */ OPATTR_ERROR,    /* Invalid */
+    /* C8 */ OPATTR_MODRM,    /* SHA1NEXTE */
+    /* C9 */ OPATTR_MODRM,    /* SHA1MSG1 */
+    /* CA */ OPATTR_MODRM,    /* SHA1MSG2 */
+    /* CB */ OPATTR_MODRM,    /* SHA256RNDS2 xmm, xmm/m128, <XMM0> */
+    /* CC */ OPATTR_MODRM,    /* SHA256MSG1 */
+    /* CD */ OPATTR_MODRM,    /* SHA256MSG2 */
+    /* CE */ OPATTR_ERROR,    /* Invalid */
+    /* CF */ OPATTR_MODRM,    /* GF2P8MULB */
+
+    /* D0 */ OPATTR_ERROR,    /* Invalid */
+    /* D1 */ OPATTR_ERROR,    /* Invalid */
+    /* D2 */ OPATTR_ERROR,    /* Invalid */
+    /* D3 */ OPATTR_ERROR,    /* Invalid */
+    /* D4 */ OPATTR_ERROR,    /* Invalid */
+    /* D5 */ OPATTR_ERROR,    /* Invalid */
+    /* D6 */ OPATTR_ERROR,    /* Invalid */
+    /* D7 */ OPATTR_ERROR,    /* Invalid */
+    /* D8 */ OPATTR_MODRM,    /* AESENCWIDE128KL/AESDECWIDE128KL/... */
+    /* D9 */ OPATTR_ERROR,    /* Invalid */
+    /* DA */ OPATTR_ERROR,    /* Invalid */
+    /* DB */ OPATTR_MODRM,    /* AESIMC */
+    /* DC */ OPATTR_MODRM,    /* AESENC/AESENC128KL */
+    /* DD */ OPATTR_MODRM,    /* AESENCLAST/AESDEC128KL */
+    /* DE */ OPATTR_MODRM,    /* AESDEC/AESENC256KL */
+    /* DF */ OPATTR_MODRM,    /* AESDECLAST/AESDEC256KL */
+
+    /* E0 */ OPATTR_ERROR,    /* Invalid */
+    /* E1 */ OPATTR_ERROR,    /* Invalid */
+    /* E2 */ OPATTR_ERROR,    /* Invalid */
+    /* E3 */ OPATTR_ERROR,    /* Invalid */
+    /* E4 */ OPATTR_ERROR,    /* Invalid */
+    /* E5 */ OPATTR_ERROR,    /* Invalid */
+    /* E6 */ OPATTR_ERROR,    /* Invalid */
+    /* E7 */ OPATTR_ERROR,    /* Invalid */
+    /* E8 */ OPATTR_ERROR,    /* Invalid */
+    /* E9 */ OPATTR_ERROR,    /* Invalid */
+    /* EA */ OPATTR_ERROR,    /* Invalid */
+    /* EB */ OPATTR_ERROR,    /* Invalid */
+    /* EC */ OPATTR_ERROR,    /* Invalid */
+    /* ED */ OPATTR_ERROR,    /* Invalid */
+    /* EE */ OPATTR_ERROR,    /* Invalid */
+    /* EF */ OPATTR_ERROR,    /* Invalid */
+
+    /* F0 */ OPATTR_MODRM,    /* MOVBE r, m / CRC32 r, r/m8 */
+    /* F1 */ OPATTR_MODRM,    /* MOVBE m, r / CRC32 r, r/m */
+    /* F2 */ OPATTR_ERROR,    /* Invalid */
+    /* F3 */ OPATTR_ERROR,    /* Invalid */
+    /* F4 */ OPATTR_ERROR,    /* Invalid */
+    /* F5 */ OPATTR_MODRM,    /* WRUSSD/WRUSSQ */
+    /* F6 */ OPATTR_MODRM,    /* ADCX/ADOX/WRSSD/WRSSQ */
+    /* F7 */ OPATTR_ERROR,    /* Invalid */
+    /* F8 */ OPATTR_MODRM,    /* MOVDIR64B/ENQCMD/ENQCMDS */
+    /* F9 */ OPATTR_MODRM,    /* MOVDIRI m, r */
+    /* FA */ OPATTR_MODRM,    /* ENCODEKEY128 */
+    /* FB */ OPATTR_MODRM,    /* ENCODEKEY256 */
+    /* FC */ OPATTR_MODRM,    /* AADD/AAND/AOR/AXOR */
+    /* FD */ OPATTR_ERROR,    /* Invalid */
+    /* FE */ OPATTR_ERROR,    /* Invalid */
+    /* FF */ OPATTR_ERROR,    /* Invalid */
+};
+
+/*
+ * Three-byte opcode attribute table (0F 3A xx)
+ *
+ * Every instruction in this map takes a ModR/M byte and an imm8.
+ */
+static const uint8_t g_opcode3a_table[OPCODE_TABLE_SIZE] = {
+    /* 00 */ OPATTR_ERROR,    /* Invalid */
+    /* 01 */ OPATTR_ERROR,    /* Invalid */
+    /* 02 */ OPATTR_ERROR,    /* Invalid */
+    /* 03 */ OPATTR_ERROR,    /* Invalid */
+    /* 04 */ OPATTR_ERROR,    /* Invalid */
+    /* 05 */ OPATTR_ERROR,    /* Invalid */
+    /* 06 */ OPATTR_ERROR,    /* Invalid */
+    /* 07 */ OPATTR_ERROR,    /* Invalid */
+    /* 08 */ OPATTR_MODRM | OPATTR_IMM8, /* ROUNDPS */
+    /* 09 */ OPATTR_MODRM | OPATTR_IMM8, /* ROUNDPD */
+    /* 0A */ OPATTR_MODRM | OPATTR_IMM8, /* ROUNDSS */
+    /* 0B */ OPATTR_MODRM | OPATTR_IMM8, /* ROUNDSD */
+    /* 0C */ OPATTR_MODRM | OPATTR_IMM8, /* BLENDPS */
+    /* 0D */ OPATTR_MODRM | OPATTR_IMM8, /* BLENDPD */
+    /* 0E */ OPATTR_MODRM | OPATTR_IMM8, /* PBLENDW */
+    /* 0F */ OPATTR_MODRM | OPATTR_IMM8, /* PALIGNR */
+
+    /* 10 */ OPATTR_ERROR,    /* Invalid */
+    /* 11 */ OPATTR_ERROR,    /* Invalid */
+    /* 12 */ OPATTR_ERROR,    /* Invalid */
+    /* 13 */ OPATTR_ERROR,    /* Invalid */
+    /* 14 */ OPATTR_MODRM | OPATTR_IMM8, /* PEXTRB r/m8, xmm, imm8 */
+    /* 15 */ OPATTR_MODRM | OPATTR_IMM8, /* PEXTRW r/m16, xmm, imm8 */
+    /* 16 */ OPATTR_MODRM | OPATTR_IMM8, /* PEXTRD/PEXTRQ */
+    /* 17 */ OPATTR_MODRM | OPATTR_IMM8, /* EXTRACTPS */
+    /* 18 */ OPATTR_ERROR,    /* Invalid */
+    /* 19 */ OPATTR_ERROR,    /* Invalid */
+    /* 1A */ OPATTR_ERROR,    /* Invalid */
+    /* 1B */ OPATTR_ERROR,    /* Invalid */
+    /* 1C */ OPATTR_ERROR,    /* Invalid */
+    /* 1D */ OPATTR_ERROR,    /* Invalid */
+    /* 1E */ OPATTR_ERROR,    /* Invalid */
+    /* 1F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 20 */ OPATTR_MODRM | OPATTR_IMM8, /* PINSRB xmm, r/m8, imm8 */
+    /* 21 */ OPATTR_MODRM | OPATTR_IMM8, /* INSERTPS */
+    /* 22 */ OPATTR_MODRM | OPATTR_IMM8, /* PINSRD/PINSRQ */
+    /* 23 */ OPATTR_ERROR,    /* Invalid */
+    /* 24 */ OPATTR_ERROR,    /* Invalid */
+    /* 25 */ OPATTR_ERROR,    /* Invalid */
+    /* 26 */ OPATTR_ERROR,    /* Invalid */
+    /* 27 */ OPATTR_ERROR,    /* Invalid */
+    /* 28 */ OPATTR_ERROR,    /* Invalid */
+    /* 29 */ OPATTR_ERROR,    /* Invalid */
+    /* 2A */ OPATTR_ERROR,    /* Invalid */
+    /* 2B */ OPATTR_ERROR,    /* Invalid */
+    /* 2C */ OPATTR_ERROR,    /* Invalid */
+    /* 2D */ OPATTR_ERROR,    /* Invalid */
+    /* 2E */ OPATTR_ERROR,    /* Invalid */
+    /* 2F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 30 */ OPATTR_ERROR,    /* Invalid */
+    /* 31 */ OPATTR_ERROR,    /* Invalid */
+    /* 32 */ OPATTR_ERROR,    /* Invalid */
+    /* 33 */ OPATTR_ERROR,    /* Invalid */
+    /* 34 */ OPATTR_ERROR,    /* Invalid */
+    /* 35 */ OPATTR_ERROR,    /* Invalid */
+    /* 36 */ OPATTR_ERROR,    /* Invalid */
+    /* 37 */ OPATTR_ERROR,    /* Invalid */
+    /* 38 */ OPATTR_ERROR,    /* Invalid */
+    /* 39 */ OPATTR_ERROR,    /* Invalid */
+    /* 3A */ OPATTR_ERROR,    /* Invalid */
+    /* 3B */ OPATTR_ERROR,    /* Invalid */
+    /* 3C */ OPATTR_ERROR,    /* Invalid */
+    /* 3D */ OPATTR_ERROR,    /* Invalid */
+    /* 3E */ OPATTR_ERROR,    /* Invalid */
+    /* 3F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 40 */ OPATTR_MODRM | OPATTR_IMM8, /* DPPS */
+    /* 41 */ OPATTR_MODRM | OPATTR_IMM8, /* DPPD */
+    /* 42 */ OPATTR_MODRM | OPATTR_IMM8, /* MPSADBW */
+    /* 43 */ OPATTR_ERROR,    /* Invalid */
+    /* 44 */ OPATTR_MODRM | OPATTR_IMM8, /* PCLMULQDQ */
+    /* 45 */ OPATTR_ERROR,    /* Invalid */
+    /* 46 */ OPATTR_ERROR,    /* Invalid */
+    /* 47 */ OPATTR_ERROR,    /* Invalid */
+    /* 48 */ OPATTR_ERROR,    /* Invalid */
+    /* 49 */ OPATTR_ERROR,    /* Invalid */
+    /* 4A */ OPATTR_ERROR,    /* Invalid */
+    /* 4B */ OPATTR_ERROR,    /* Invalid */
+    /* 4C */ OPATTR_ERROR,    /* Invalid */
+    /* 4D */ OPATTR_ERROR,    /* Invalid */
+    /* 4E */ OPATTR_ERROR,    /* Invalid */
+    /* 4F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 50 */ OPATTR_ERROR,    /* Invalid */
+    /* 51 */ OPATTR_ERROR,    /* Invalid */
+    /* 52 */ OPATTR_ERROR,    /* Invalid */
+    /* 53 */ OPATTR_ERROR,    /* Invalid */
+    /* 54 */ OPATTR_ERROR,    /* Invalid */
+    /* 55 */ OPATTR_ERROR,    /* Invalid */
+    /* 56 */ OPATTR_ERROR,    /* Invalid */
+    /* 57 */ OPATTR_ERROR,    /* Invalid */
+    /* 58 */ OPATTR_ERROR,    /* Invalid */
+    /* 59 */ OPATTR_ERROR,    /* Invalid */
+    /* 5A */ OPATTR_ERROR,    /* Invalid */
+    /* 5B */ OPATTR_ERROR,    /* Invalid */
+    /* 5C */ OPATTR_ERROR,    /* Invalid */
+    /* 5D */ OPATTR_ERROR,    /* Invalid */
+    /* 5E */ OPATTR_ERROR,    /* Invalid */
+    /* 5F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 60 */ OPATTR_MODRM | OPATTR_IMM8, /* PCMPESTRM */
+    /* 61 */ OPATTR_MODRM | OPATTR_IMM8, /* PCMPESTRI */
+    /* 62 */ OPATTR_MODRM | OPATTR_IMM8, /* PCMPISTRM */
+    /* 63 */ OPATTR_MODRM | OPATTR_IMM8, /* PCMPISTRI */
+    /* 64 */ OPATTR_ERROR,    /* Invalid */
+    /* 65 */ OPATTR_ERROR,    /* Invalid */
+    /* 66 */ OPATTR_ERROR,    /* Invalid */
+    /* 67 */ OPATTR_ERROR,    /* Invalid */
+    /* 68 */ OPATTR_ERROR,    /* Invalid */
+    /* 69 */ OPATTR_ERROR,    /* Invalid */
+    /* 6A */ OPATTR_ERROR,    /* Invalid */
+    /* 6B */ OPATTR_ERROR,    /* Invalid */
+    /* 6C */ OPATTR_ERROR,    /* Invalid */
+    /* 6D */ OPATTR_ERROR,    /* Invalid */
+    /* 6E */ OPATTR_ERROR,    /* Invalid */
+    /* 6F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 70 */ OPATTR_ERROR,    /* Invalid */
+    /* 71 */ OPATTR_ERROR,    /* Invalid */
+    /* 72 */ OPATTR_ERROR,    /* Invalid */
+    /* 73 */ OPATTR_ERROR,    /* Invalid */
+    /* 74 */ OPATTR_ERROR,    /* Invalid */
+    /* 75 */ OPATTR_ERROR,    /* Invalid */
+    /* 76 */ OPATTR_ERROR,    /* Invalid */
+    /* 77 */ OPATTR_ERROR,    /* Invalid */
+    /* 78 */ OPATTR_ERROR,    /* Invalid */
+    /* 79 */ OPATTR_ERROR,    /* Invalid */
+    /* 7A */ OPATTR_ERROR,    /* Invalid */
+    /* 7B */ OPATTR_ERROR,    /* Invalid */
+    /* 7C */ OPATTR_ERROR,    /* Invalid */
+    /* 7D */ OPATTR_ERROR,    /* Invalid */
+    /* 7E */ OPATTR_ERROR,    /* Invalid */
+    /* 7F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 80 */ OPATTR_ERROR,    /* Invalid */
+    /* 81 */ OPATTR_ERROR,    /* Invalid */
+    /* 82 */ OPATTR_ERROR,    /* Invalid */
+    /* 83 */ OPATTR_ERROR,    /* Invalid */
+    /* 84 */ OPATTR_ERROR,    /* Invalid */
+    /* 85 */ OPATTR_ERROR,    /* Invalid */
+    /* 86 */ OPATTR_ERROR,    /* Invalid */
+    /* 87 */ OPATTR_ERROR,    /* Invalid */
+    /* 88 */ OPATTR_ERROR,    /* Invalid */
+    /* 89 */ OPATTR_ERROR,    /* Invalid */
+    /* 8A */ OPATTR_ERROR,    /* Invalid */
+    /* 8B */ OPATTR_ERROR,    /* Invalid */
+    /* 8C */ OPATTR_ERROR,    /* Invalid */
+    /* 8D */ OPATTR_ERROR,    /* Invalid */
+    /* 8E */ OPATTR_ERROR,    /* Invalid */
+    /* 8F */ OPATTR_ERROR,    /* Invalid */
+
+    /* 90 */ OPATTR_ERROR,    /* Invalid */
+    /* 91 */ OPATTR_ERROR,    /* Invalid */
+    /* 92 */ OPATTR_ERROR,    /* Invalid */
+    /* 93 */ OPATTR_ERROR,    /* Invalid */
+    /* 94 */ OPATTR_ERROR,    /* Invalid */
+    /* 95 */ OPATTR_ERROR,    /* Invalid */
+    /* 96 */ OPATTR_ERROR,    /* Invalid */
+    /* 97 */ OPATTR_ERROR,    /* Invalid */
+    /* 98 */ OPATTR_ERROR,    /* Invalid */
+    /* 99 */ OPATTR_ERROR,    /* Invalid */
+    /* 9A */ OPATTR_ERROR,    /* Invalid */
+    /* 9B */ OPATTR_ERROR,    /* Invalid */
+    /* 9C */ OPATTR_ERROR,    /* Invalid */
+    /* 9D */ OPATTR_ERROR,    /* Invalid */
+    /* 9E */ OPATTR_ERROR,    /* Invalid */
+    /* 9F */ OPATTR_ERROR,    /* Invalid */
+
+    /* A0 */ OPATTR_ERROR,    /* Invalid */
+    /* A1 */ OPATTR_ERROR,    /* Invalid */
+    /* A2 */ OPATTR_ERROR,    /* Invalid */
+    /* A3 */ OPATTR_ERROR,    /* Invalid */
+    /* A4 */ OPATTR_ERROR,    /* Invalid */
+    /* A5 */ OPATTR_ERROR,    /* Invalid */
+    /* A6 */ OPATTR_ERROR,    /* Invalid */
+    /* A7 */ OPATTR_ERROR,    /* Invalid */
+    /* A8 */ OPATTR_ERROR,    /* Invalid */
+    /* A9 */ OPATTR_ERROR,    /* Invalid */
+    /* AA */ OPATTR_ERROR,    /* Invalid */
+    /* AB */ OPATTR_ERROR,    /* Invalid */
+    /* AC */ OPATTR_ERROR,    /* Invalid */
+    /* AD */ OPATTR_ERROR,    /* Invalid */
+    /* AE */ OPATTR_ERROR,    /* Invalid */
+    /* AF */ OPATTR_ERROR,    /* Invalid */
+
+    /* B0 */ OPATTR_ERROR,    /* Invalid */
+    /* B1 */ OPATTR_ERROR,    /* Invalid */
+    /* B2 */ OPATTR_ERROR,    /* Invalid */
+    /* B3 */ OPATTR_ERROR,    /* Invalid */
+    /* B4 */ OPATTR_ERROR,    /* Invalid */
+    /* B5 */ OPATTR_ERROR,    /* Invalid */
+    /* B6 */ OPATTR_ERROR,    /* Invalid */
+    /* B7 */ OPATTR_ERROR,    /* Invalid */
+    /* B8 */ OPATTR_ERROR,    /* Invalid */
+    /* B9 */ OPATTR_ERROR,    /* Invalid */
+    /* BA */ OPATTR_ERROR,    /* Invalid */
+    /* BB */ OPATTR_ERROR,    /* Invalid */
+    /* BC */ OPATTR_ERROR,    /* Invalid */
+    /* BD */ OPATTR_ERROR,    /* Invalid */
+    /* BE */ OPATTR_ERROR,    /* Invalid */
+    /* BF */ OPATTR_ERROR,    /* Invalid */
+
+    /* C0 */ OPATTR_ERROR,    /* Invalid */
+    /* C1 */ OPATTR_ERROR,    /* Invalid */
+    /* C2 */ OPATTR_ERROR,    /* Invalid */
+    /* C3 */ OPATTR_ERROR,    /* Invalid */
+    /* C4 */ OPATTR_ERROR,    /* Invalid */
+    /* C5 */ OPATTR_ERROR,    /* Invalid */
+    /* C6 */ OPATTR_ERROR,    /* Invalid */
+    /* C7 */ OPATTR_ERROR,    /* Invalid */
+    /* C8 */ OPATTR_ERROR,    /* Invalid */
+    /* C9 */ OPATTR_ERROR,    /* Invalid */
+    /* CA */ OPATTR_ERROR,    /* Invalid */
+    /* CB */ OPATTR_ERROR,    /* Invalid */
+    /* CC */ OPATTR_MODRM | OPATTR_IMM8, /* SHA1RNDS4 */
+    /* CD */ OPATTR_ERROR,    /* Invalid */
+    /* CE */ OPATTR_MODRM | OPATTR_IMM8, /* GF2P8AFFINEQB */
+    /* CF */ OPATTR_MODRM | OPATTR_IMM8, /* GF2P8AFFINEINVQB */
+
+    /* D0 */ OPATTR_ERROR,    /* Invalid */
+    /* D1 */ OPATTR_ERROR,    /* Invalid */
+    /* D2 */ OPATTR_ERROR,    /* Invalid */
+    /* D3 */ OPATTR_ERROR,    /* Invalid */
+    /* D4 */ OPATTR_ERROR,    /* Invalid */
+    /* D5 */ OPATTR_ERROR,    /* Invalid */
+    /* D6 */ OPATTR_ERROR,    /* Invalid */
+    /* D7 */ OPATTR_ERROR,    /* Invalid */
+    /* D8 */ OPATTR_ERROR,    /* Invalid */
+    /* D9 */ OPATTR_ERROR,    /* Invalid */
+    /* DA */ OPATTR_ERROR,    /* Invalid */
+    /* DB */ OPATTR_ERROR,    /* Invalid */
+    /* DC */ OPATTR_ERROR,    /* Invalid */
+    /* DD */ OPATTR_ERROR,    /* Invalid */
+    /* DE */ OPATTR_ERROR,    /* Invalid */
+    /* DF */ OPATTR_MODRM | OPATTR_IMM8, /* AESKEYGENASSIST */
+
+    /* E0 */ OPATTR_ERROR,    /* Invalid */
+    /* E1 */ OPATTR_ERROR,    /* Invalid */
+    /* E2 */ OPATTR_ERROR,    /* Invalid */
+    /* E3 */ OPATTR_ERROR,    /* Invalid */
+    /* E4 */ OPATTR_ERROR,    /* Invalid */
+    /* E5 */ OPATTR_ERROR,    /* Invalid */
+    /* E6 */ OPATTR_ERROR,    /* Invalid */
+    /* E7 */ OPATTR_ERROR,    /* Invalid */
+    /* E8 */ OPATTR_ERROR,    /* Invalid */
+    /* E9 */ OPATTR_ERROR,    /* Invalid */
+    /* EA */ OPATTR_ERROR,    /* Invalid */
+    /* EB */ OPATTR_ERROR,    /* Invalid */
+    /* EC */ OPATTR_ERROR,    /* Invalid */
+    /* ED */ OPATTR_ERROR,    /* Invalid */
+    /* EE */ OPATTR_ERROR,    /* Invalid */
+    /* EF */ OPATTR_ERROR,    /* Invalid */
+
+    /* F0 */ OPATTR_ERROR,    /* Invalid */
+    /* F1 */ OPATTR_ERROR,    /* Invalid */
+    /* F2 */ OPATTR_ERROR,    /* Invalid */
+    /* F3 */ OPATTR_ERROR,    /* Invalid */
+    /* F4 */ OPATTR_ERROR,    /* Invalid */
+    /* F5 */ OPATTR_ERROR,    /* Invalid */
+    /* F6 */ OPATTR_ERROR,    /* Invalid */
+    /* F7 */ OPATTR_ERROR,    /* Invalid */
+    /* F8 */ OPATTR_ERROR,    /* Invalid */
+    /* F9 */ OPATTR_ERROR,    /* Invalid */
+    /* FA */ OPATTR_ERROR,    /* Invalid */
+    /* FB */ OPATTR_ERROR,    /* Invalid */
+    /* FC */ OPATTR_ERROR,    /* Invalid */
+    /* FD */ OPATTR_ERROR,    /* Invalid */
+    /* FE */ OPATTR_ERROR,    /* Invalid */
+    /* FF */ OPATTR_ERROR,    /* Invalid */
+};
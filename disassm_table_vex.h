@@ -0,0 +1,390 @@
+#pragma once
+
+#include <stdint.h>
+#include "disassm.h"
+#include "disassm_inst_bytes.h"
+#include "disassm_table_op1.h"
+
+/*
+ * VEX/EVEX/XOP opcode tables
+ *
+ * Vector-encoded instructions always take a ModR/M byte; what varies is the
+ * immediate. The opcode map selects one of a few attribute rows, so the
+ * length of a vector instruction is two table lookups like a legacy one.
+ */
+
+/*
+ * Vector prefix kinds, by lead byte
+ */
+typedef enum {
+    VECTOR_VEX = 0,         // C4, C5
+    VECTOR_EVEX = 1,        // 62
+    VECTOR_XOP = 2,         // 8F
+    VECTOR_KIND_COUNT
+} VectorKind;
+
+/*
+ * Attribute rows
+ */
+typedef enum {
+    VROW_ERROR = 0,         // Undefined map
+    VROW_0F,                // VEX/EVEX map 0F
+    VROW_MODRM,             // ModR/M only (0F 38, EVEX maps 5/6, XOP map 9)
+    VROW_MODRM_IMM8,        // ModR/M and imm8 (0F 3A, XOP map 8)
+    VROW_MODRM_IMM32,       // ModR/M and imm32 (XOP map 0A)
+    VROW_COUNT
+} VectorRow;
+
+/*
+ * Attribute row by prefix kind and map field
+ */
+static const uint8_t g_vector_map_row[VECTOR_KIND_COUNT][32] = {
+    // VEX: maps 1-3
+    { VROW_ERROR, VROW_0F, VROW_MODRM, VROW_MODRM_IMM8 },
+    // EVEX: maps 1-3, 5 and 6
+    { VROW_ERROR, VROW_0F, VROW_MODRM, VROW_MODRM_IMM8, VROW_ERROR, VROW_MODRM, VROW_MODRM },
+    // XOP: maps 8, 9 and 0A
+    { VROW_ERROR, VROW_ERROR, VROW_ERROR, VROW_ERROR, VROW_ERROR, VROW_ERROR, VROW_ERROR, VROW_ERROR,
+      VROW_MODRM_IMM8, VROW_MODRM, VROW_MODRM_IMM32 }
+};
+
+/*
+ * Opcodes of the vector 0F map that differ from ModR/M only
+ */
+typedef struct {
+    uint8_t opcode;
+    uint8_t attr;
+} VectorOpcodePatch;
+
+static constexpr VectorOpcodePatch g_vector_0f_patches[] = {
+    { 0x70, OPATTR_MODRM | OPATTR_IMM8 },   // VPSHUFD/VPSHUFHW/VPSHUFLW
+    { 0x71, OPATTR_MODRM | OPATTR_IMM8 },   // VPSRLW/VPSRAW/VPSLLW imm8
+    { 0x72, OPATTR_MODRM | OPATTR_IMM8 },   // VPSRLD/VPSRAD/VPSLLD/VPROLD/VPRORD imm8
+    { 0x73, OPATTR_MODRM | OPATTR_IMM8 },   // VPSRLQ/VPSRLDQ/VPSLLQ/VPSLLDQ imm8
+    { 0x77, OPATTR_NONE },                  // VZEROUPPER/VZEROALL
+    { 0xC2, OPATTR_MODRM | OPATTR_IMM8 },   // VCMPPS/PD/SS/SD
+    { 0xC4, OPATTR_MODRM | OPATTR_IMM8 },   // VPINSRW
+    { 0xC5, OPATTR_MODRM | OPATTR_IMM8 },   // VPEXTRW
+    { 0xC6, OPATTR_MODRM | OPATTR_IMM8 },   // VSHUFPS/PD
+};
+
+typedef struct {
+    uint8_t attr[VROW_COUNT][OPCODE_TABLE_SIZE];
+} VectorOpcodeTable;
+
+constexpr VectorOpcodeTable build_vector_opcode_table() {
+    VectorOpcodeTable table = {};
+
+    for (unsigned int i = 0; i < OPCODE_TABLE_SIZE; i++) {
+        table.attr[VROW_ERROR][i] = OPATTR_ERROR;
+        table.attr[VROW_0F][i] = OPATTR_MODRM;
+        table.attr[VROW_MODRM][i] = OPATTR_MODRM;
+        table.attr[VROW_MODRM_IMM8][i] = OPATTR_MODRM | OPATTR_IMM8;
+        table.attr[VROW_MODRM_IMM32][i] = OPATTR_MODRM | OPATTR_IMM_P66;
+    }
+
+    for (unsigned int i = 0; i < sizeof(g_vector_0f_patches) / sizeof(g_vector_0f_patches[0]); i++) {
+        table.attr[VROW_0F][g_vector_0f_patches[i].opcode] = g_vector_0f_patches[i].attr;
+    }
+
+    return table;
+}
+
+static constexpr VectorOpcodeTable g_vector_opcode_table = build_vector_opcode_table();
+
+/*
+ * EVEX tuple types
+ *
+ * With EVEX, a disp8 is scaled by N, the size of the memory access that the
+ * instruction's tuple type implies (SDM Vol. 2, 2.7.5). VL is the vector
+ * length in bytes, and an element is 4 bytes with W0 or 8 bytes with W1.
+ */
+typedef enum {
+    TUPLE_FV = 0,           // Full vector: VL, one element with broadcast
+    TUPLE_FV16,             // FP16 full vector: VL, 2 with broadcast
+    TUPLE_HV16,             // FP16 half vector: VL/2, 2 with broadcast
+    TUPLE_QV16,             // FP16 quarter vector: VL/4, 2 with broadcast
+    TUPLE_HV,               // Half vector: VL/2 (VL with W1), one element with broadcast
+    TUPLE_FVM,              // Full vector memory: VL
+    TUPLE_HVM,              // Half vector memory: VL/2
+    TUPLE_QVM,              // Quarter vector memory: VL/4
+    TUPLE_OVM,              // Eighth vector memory: VL/8
+    TUPLE_T1S,              // One element: 4 with W0, 8 with W1
+    TUPLE_T1S_BW,           // One byte/word element: 1 with W0, 2 with W1
+    TUPLE_T1F,              // One element sized by pp: 4 (none, F3) or 8 (66, F2)
+    TUPLE_DUP,              // MOVDDUP: 8 for 128 bits, VL otherwise
+    TUPLE_N1,               // Fixed sizes
+    TUPLE_N2,
+    TUPLE_N4,
+    TUPLE_N8,
+    TUPLE_N16,
+    TUPLE_N32
+} EvexTuple;
+
+// pp masks of a tuple range
+#define TP_NP   0x01    // No implied prefix
+#define TP_66   0x02
+#define TP_F3   0x04
+#define TP_F2   0x08
+#define TP_ALL  0x0F
+#define TP_SS   (TP_F3 | TP_F2)     // Scalar forms of packed arithmetic
+
+/*
+ * Tuple type ranges, applied in order over a FV default (FV16 for maps 5/6)
+ */
+typedef struct {
+    uint8_t map;
+    uint8_t first;
+    uint8_t last;
+    uint8_t pp_mask;
+    uint8_t tuple;
+} EvexTupleRange;
+
+static constexpr EvexTupleRange g_evex_tuple_ranges[] = {
+    // 0F map
+    { 1, 0x10, 0x11, TP_NP | TP_66, TUPLE_FVM },    // VMOVUPS/PD
+    { 1, 0x10, 0x11, TP_SS, TUPLE_T1S },            // VMOVSS/SD
+    { 1, 0x12, 0x13, TP_NP | TP_66, TUPLE_N8 },     // VMOVLPS/PD
+    { 1, 0x12, 0x12, TP_F3, TUPLE_FVM },            // VMOVSLDUP
+    { 1, 0x12, 0x12, TP_F2, TUPLE_DUP },            // VMOVDDUP
+    { 1, 0x16, 0x17, TP_NP | TP_66, TUPLE_N8 },     // VMOVHPS/PD
+    { 1, 0x16, 0x16, TP_F3, TUPLE_FVM },            // VMOVSHDUP
+    { 1, 0x28, 0x29, TP_ALL, TUPLE_FVM },           // VMOVAPS/PD
+    { 1, 0x2A, 0x2A, TP_ALL, TUPLE_T1S },           // VCVTSI2SS/SD
+    { 1, 0x2B, 0x2B, TP_ALL, TUPLE_FVM },           // VMOVNTPS/PD
+    { 1, 0x2C, 0x2F, TP_ALL, TUPLE_T1F },           // VCVT(T)SS/SD2SI, V(U)COMISS/SD
+    { 1, 0x51, 0x51, TP_SS, TUPLE_T1S },            // VSQRTSS/SD
+    { 1, 0x58, 0x59, TP_SS, TUPLE_T1S },            // VADDSS/SD, VMULSS/SD
+    { 1, 0x5A, 0x5A, TP_NP, TUPLE_HV },             // VCVTPS2PD
+    { 1, 0x5A, 0x5A, TP_SS, TUPLE_T1S },            // VCVTSS2SD, VCVTSD2SS
+    { 1, 0x5C, 0x5F, TP_SS, TUPLE_T1S },            // VSUB/MIN/DIV/MAXSS/SD
+    { 1, 0x60, 0x61, TP_ALL, TUPLE_FVM },           // VPUNPCKLBW/WD
+    { 1, 0x63, 0x65, TP_ALL, TUPLE_FVM },           // VPACKSSWB, VPCMPGTB/W
+    { 1, 0x67, 0x69, TP_ALL, TUPLE_FVM },           // VPACKUSWB, VPUNPCKHBW/WD
+    { 1, 0x6E, 0x6E, TP_ALL, TUPLE_T1S },           // VMOVD/Q
+    { 1, 0x6F, 0x6F, TP_ALL, TUPLE_FVM },           // VMOVDQA/U
+    { 1, 0x70, 0x70, TP_SS, TUPLE_FVM },            // VPSHUFHW/LW
+    { 1, 0x71, 0x71, TP_ALL, TUPLE_FVM },           // VPSRLW/VPSRAW/VPSLLW imm8
+    { 1, 0x74, 0x75, TP_ALL, TUPLE_FVM },           // VPCMPEQB/W
+    { 1, 0x78, 0x79, TP_66, TUPLE_HV },             // VCVT(T)PS2UQQ, VCVT(T)PD2UQQ
+    { 1, 0x78, 0x79, TP_SS, TUPLE_T1F },            // VCVT(T)SS/SD2USI
+    { 1, 0x7A, 0x7B, TP_66, TUPLE_HV },             // VCVT(T)PS2QQ, VCVT(T)PD2QQ
+    { 1, 0x7A, 0x7A, TP_F3, TUPLE_HV },             // VCVTUDQ2PD, VCVTUQQ2PD
+    { 1, 0x7B, 0x7B, TP_SS, TUPLE_T1S },            // VCVTUSI2SS/SD
+    { 1, 0x7E, 0x7E, TP_66, TUPLE_T1S },            // VMOVD/Q r/m, xmm
+    { 1, 0x7E, 0x7E, TP_F3, TUPLE_N8 },             // VMOVQ xmm, m64
+    { 1, 0x7F, 0x7F, TP_ALL, TUPLE_FVM },           // VMOVDQA/U
+    { 1, 0xC2, 0xC2, TP_SS, TUPLE_T1S },            // VCMPSS/SD
+    { 1, 0xC4, 0xC4, TP_ALL, TUPLE_N2 },            // VPINSRW
+    { 1, 0xD1, 0xD3, TP_ALL, TUPLE_N16 },           // VPSRLW/D/Q xmm count
+    { 1, 0xD5, 0xD5, TP_ALL, TUPLE_FVM },           // VPMULLW
+    { 1, 0xD6, 0xD6, TP_ALL, TUPLE_N8 },            // VMOVQ m64, xmm
+    { 1, 0xD8, 0xDA, TP_ALL, TUPLE_FVM },           // VPSUBUSB/W, VPMINUB
+    { 1, 0xDC, 0xDE, TP_ALL, TUPLE_FVM },           // VPADDUSB/W, VPMAXUB
+    { 1, 0xE0, 0xE0, TP_ALL, TUPLE_FVM },           // VPAVGB
+    { 1, 0xE1, 0xE2, TP_ALL, TUPLE_N16 },           // VPSRAW/D xmm count
+    { 1, 0xE3, 0xE5, TP_ALL, TUPLE_FVM },           // VPAVGW, VPMULHUW/HW
+    { 1, 0xE6, 0xE6, TP_F3, TUPLE_HV },             // VCVTDQ2PD, VCVTQQ2PD
+    { 1, 0xE7, 0xEA, TP_ALL, TUPLE_FVM },           // VMOVNTDQ, VPSUBSB/W, VPMINSW
+    { 1, 0xEC, 0xEE, TP_ALL, TUPLE_FVM },           // VPADDSB/W, VPMAXSW
+    { 1, 0xF1, 0xF3, TP_ALL, TUPLE_N16 },           // VPSLLW/D/Q xmm count
+    { 1, 0xF5, 0xF6, TP_ALL, TUPLE_FVM },           // VPMADDWD, VPSADBW
+    { 1, 0xF8, 0xF9, TP_ALL, TUPLE_FVM },           // VPSUBB/W
+    { 1, 0xFC, 0xFD, TP_ALL, TUPLE_FVM },           // VPADDB/W
+
+    // 0F 38 map
+    { 2, 0x00, 0x00, TP_ALL, TUPLE_FVM },           // VPSHUFB
+    { 2, 0x04, 0x04, TP_ALL, TUPLE_FVM },           // VPMADDUBSW
+    { 2, 0x0B, 0x0B, TP_ALL, TUPLE_FVM },           // VPMULHRSW
+    { 2, 0x10, 0x12, TP_66, TUPLE_FVM },            // VPSRLVW, VPSRAVW, VPSLLVW
+    { 2, 0x13, 0x13, TP_66, TUPLE_HVM },            // VCVTPH2PS
+    { 2, 0x10, 0x10, TP_F3, TUPLE_HVM },            // VPMOVUSWB
+    { 2, 0x11, 0x11, TP_F3, TUPLE_QVM },            // VPMOVUSDB
+    { 2, 0x12, 0x12, TP_F3, TUPLE_OVM },            // VPMOVUSQB
+    { 2, 0x13, 0x13, TP_F3, TUPLE_HVM },            // VPMOVUSDW
+    { 2, 0x14, 0x14, TP_F3, TUPLE_QVM },            // VPMOVUSQW
+    { 2, 0x15, 0x15, TP_F3, TUPLE_HVM },            // VPMOVUSQD
+    { 2, 0x18, 0x18, TP_ALL, TUPLE_N4 },            // VBROADCASTSS
+    { 2, 0x19, 0x19, TP_ALL, TUPLE_N8 },            // VBROADCASTSD, VBROADCASTF32X2
+    { 2, 0x1A, 0x1A, TP_ALL, TUPLE_N16 },           // VBROADCASTF32X4/F64X2
+    { 2, 0x1B, 0x1B, TP_ALL, TUPLE_N32 },           // VBROADCASTF32X8/F64X4
+    { 2, 0x1C, 0x1D, TP_ALL, TUPLE_FVM },           // VPABSB/W
+    { 2, 0x20, 0x20, TP_ALL, TUPLE_HVM },           // VPMOVSXBW, VPMOVSWB
+    { 2, 0x21, 0x21, TP_ALL, TUPLE_QVM },           // VPMOVSXBD, VPMOVSDB
+    { 2, 0x22, 0x22, TP_ALL, TUPLE_OVM },           // VPMOVSXBQ, VPMOVSQB
+    { 2, 0x23, 0x23, TP_ALL, TUPLE_HVM },           // VPMOVSXWD, VPMOVSDW
+    { 2, 0x24, 0x24, TP_ALL, TUPLE_QVM },           // VPMOVSXWQ, VPMOVSQW
+    { 2, 0x25, 0x25, TP_ALL, TUPLE_HVM },           // VPMOVSXDQ, VPMOVSQD
+    { 2, 0x26, 0x26, TP_ALL, TUPLE_FVM },           // VPTESTMB/W, VPTESTNMB/W
+    { 2, 0x2A, 0x2A, TP_ALL, TUPLE_FVM },           // VMOVNTDQA
+    { 2, 0x2D, 0x2D, TP_ALL, TUPLE_T1S },           // VSCALEFSS/SD
+    { 2, 0x30, 0x30, TP_ALL, TUPLE_HVM },           // VPMOVZXBW, VPMOVWB
+    { 2, 0x31, 0x31, TP_ALL, TUPLE_QVM },           // VPMOVZXBD, VPMOVDB
+    { 2, 0x32, 0x32, TP_ALL, TUPLE_OVM },           // VPMOVZXBQ, VPMOVQB
+    { 2, 0x33, 0x33, TP_ALL, TUPLE_HVM },           // VPMOVZXWD, VPMOVDW
+    { 2, 0x34, 0x34, TP_ALL, TUPLE_QVM },           // VPMOVZXWQ, VPMOVQW
+    { 2, 0x35, 0x35, TP_ALL, TUPLE_HVM },           // VPMOVZXDQ, VPMOVQD
+    { 2, 0x38, 0x38, TP_ALL, TUPLE_FVM },           // VPMINSB
+    { 2, 0x3A, 0x3A, TP_ALL, TUPLE_FVM },           // VPMINUW
+    { 2, 0x3C, 0x3C, TP_ALL, TUPLE_FVM },           // VPMAXSB
+    { 2, 0x3E, 0x3E, TP_ALL, TUPLE_FVM },           // VPMAXUW
+    { 2, 0x43, 0x43, TP_ALL, TUPLE_T1S },           // VGETEXPSS/SD
+    { 2, 0x4D, 0x4D, TP_ALL, TUPLE_T1S },           // VRCP14SS/SD
+    { 2, 0x4F, 0x4F, TP_ALL, TUPLE_T1S },           // VRSQRT14SS/SD
+    { 2, 0x54, 0x54, TP_ALL, TUPLE_FVM },           // VPOPCNTB/W
+    { 2, 0x58, 0x58, TP_ALL, TUPLE_N4 },            // VPBROADCASTD
+    { 2, 0x59, 0x59, TP_ALL, TUPLE_N8 },            // VPBROADCASTQ, VBROADCASTI32X2
+    { 2, 0x5A, 0x5A, TP_ALL, TUPLE_N16 },           // VBROADCASTI32X4/I64X2
+    { 2, 0x5B, 0x5B, TP_ALL, TUPLE_N32 },           // VBROADCASTI32X8/I64X4
+    { 2, 0x62, 0x63, TP_ALL, TUPLE_T1S_BW },        // VPEXPANDB/W, VPCOMPRESSB/W
+    { 2, 0x66, 0x66, TP_ALL, TUPLE_FVM },           // VPBLENDMB/W
+    { 2, 0x70, 0x70, TP_ALL, TUPLE_FVM },           // VPSHLDVW
+    { 2, 0x72, 0x72, TP_66, TUPLE_FVM },            // VPSHRDVW
+    { 2, 0x75, 0x75, TP_ALL, TUPLE_FVM },           // VPERMI2B/W
+    { 2, 0x78, 0x78, TP_ALL, TUPLE_N1 },            // VPBROADCASTB
+    { 2, 0x79, 0x79, TP_ALL, TUPLE_N2 },            // VPBROADCASTW
+    { 2, 0x7D, 0x7D, TP_ALL, TUPLE_FVM },           // VPERMT2B/W
+    { 2, 0x88, 0x8B, TP_ALL, TUPLE_T1S },           // VEXPANDPS/PD, VPEXPANDD/Q, VCOMPRESS*
+    { 2, 0x8D, 0x8D, TP_ALL, TUPLE_FVM },           // VPERMB/W
+    { 2, 0x8F, 0x8F, TP_ALL, TUPLE_FVM },           // VPSHUFBITQMB
+    { 2, 0x90, 0x93, TP_ALL, TUPLE_T1S },           // VPGATHER*, VGATHER*
+    { 2, 0x99, 0x99, TP_ALL, TUPLE_T1S },           // VFMADD132SS/SD
+    { 2, 0x9B, 0x9B, TP_ALL, TUPLE_T1S },           // VFMSUB132SS/SD
+    { 2, 0x9D, 0x9D, TP_ALL, TUPLE_T1S },           // VFNMADD132SS/SD
+    { 2, 0x9F, 0x9F, TP_ALL, TUPLE_T1S },           // VFNMSUB132SS/SD
+    { 2, 0xA0, 0xA3, TP_ALL, TUPLE_T1S },           // VPSCATTER*, VSCATTER*
+    { 2, 0xA9, 0xA9, TP_ALL, TUPLE_T1S },           // VFMADD213SS/SD
+    { 2, 0xAB, 0xAB, TP_ALL, TUPLE_T1S },           // VFMSUB213SS/SD
+    { 2, 0xAD, 0xAD, TP_ALL, TUPLE_T1S },           // VFNMADD213SS/SD
+    { 2, 0xAF, 0xAF, TP_ALL, TUPLE_T1S },           // VFNMSUB213SS/SD
+    { 2, 0xB9, 0xB9, TP_ALL, TUPLE_T1S },           // VFMADD231SS/SD
+    { 2, 0xBB, 0xBB, TP_ALL, TUPLE_T1S },           // VFMSUB231SS/SD
+    { 2, 0xBD, 0xBD, TP_ALL, TUPLE_T1S },           // VFNMADD231SS/SD
+    { 2, 0xBF, 0xBF, TP_ALL, TUPLE_T1S },           // VFNMSUB231SS/SD
+    { 2, 0xC6, 0xC7, TP_ALL, TUPLE_T1S },           // VGATHERPF*, VSCATTERPF*
+    { 2, 0xCB, 0xCB, TP_ALL, TUPLE_T1S },           // VRCP28SS/SD
+    { 2, 0xCD, 0xCD, TP_ALL, TUPLE_T1S },           // VRSQRT28SS/SD
+    { 2, 0xCF, 0xCF, TP_ALL, TUPLE_FVM },           // VGF2P8MULB
+    { 2, 0xDC, 0xDF, TP_ALL, TUPLE_FVM },           // VAESENC/ENCLAST/DEC/DECLAST
+
+    // 0F 3A map
+    { 3, 0x08, 0x08, TP_NP, TUPLE_FV16 },           // VRNDSCALEPH
+    { 3, 0x0A, 0x0B, TP_ALL, TUPLE_T1S },           // VRNDSCALESS/SD
+    { 3, 0x0A, 0x0A, TP_NP, TUPLE_N2 },             // VRNDSCALESH
+    { 3, 0x0F, 0x0F, TP_ALL, TUPLE_FVM },           // VPALIGNR
+    { 3, 0x14, 0x14, TP_ALL, TUPLE_N1 },            // VPEXTRB
+    { 3, 0x15, 0x15, TP_ALL, TUPLE_N2 },            // VPEXTRW
+    { 3, 0x16, 0x16, TP_ALL, TUPLE_T1S },           // VPEXTRD/Q
+    { 3, 0x17, 0x17, TP_ALL, TUPLE_N4 },            // VEXTRACTPS
+    { 3, 0x18, 0x19, TP_ALL, TUPLE_N16 },           // VINSERTF32X4/F64X2, VEXTRACTF32X4/F64X2
+    { 3, 0x1A, 0x1B, TP_ALL, TUPLE_N32 },           // VINSERTF32X8/F64X4, VEXTRACTF32X8/F64X4
+    { 3, 0x1D, 0x1D, TP_ALL, TUPLE_HVM },           // VCVTPS2PH
+    { 3, 0x20, 0x20, TP_ALL, TUPLE_N1 },            // VPINSRB
+    { 3, 0x21, 0x21, TP_ALL, TUPLE_N4 },            // VINSERTPS
+    { 3, 0x22, 0x22, TP_ALL, TUPLE_T1S },           // VPINSRD/Q
+    { 3, 0x26, 0x26, TP_NP, TUPLE_FV16 },           // VGETMANTPH
+    { 3, 0x27, 0x27, TP_ALL, TUPLE_T1S },           // VGETMANTSS/SD
+    { 3, 0x27, 0x27, TP_NP, TUPLE_N2 },             // VGETMANTSH
+    { 3, 0x38, 0x39, TP_ALL, TUPLE_N16 },           // VINSERTI32X4/I64X2, VEXTRACTI32X4/I64X2
+    { 3, 0x3A, 0x3B, TP_ALL, TUPLE_N32 },           // VINSERTI32X8/I64X4, VEXTRACTI32X8/I64X4
+    { 3, 0x3E, 0x3F, TP_ALL, TUPLE_FVM },           // VPCMPUB/UW, VPCMPB/W
+    { 3, 0x42, 0x42, TP_ALL, TUPLE_FVM },           // VDBPSADBW
+    { 3, 0x44, 0x44, TP_ALL, TUPLE_FVM },           // VPCLMULQDQ
+    { 3, 0x51, 0x51, TP_ALL, TUPLE_T1S },           // VRANGESS/SD
+    { 3, 0x55, 0x55, TP_ALL, TUPLE_T1S },           // VFIXUPIMMSS/SD
+    { 3, 0x56, 0x56, TP_NP, TUPLE_FV16 },           // VREDUCEPH
+    { 3, 0x57, 0x57, TP_ALL, TUPLE_T1S },           // VREDUCESS/SD
+    { 3, 0x57, 0x57, TP_NP, TUPLE_N2 },             // VREDUCESH
+    { 3, 0x66, 0x66, TP_NP, TUPLE_FV16 },           // VFPCLASSPH
+    { 3, 0x67, 0x67, TP_ALL, TUPLE_T1S },           // VFPCLASSSS/SD
+    { 3, 0x67, 0x67, TP_NP, TUPLE_N2 },             // VFPCLASSSH
+    { 3, 0x70, 0x70, TP_ALL, TUPLE_FVM },           // VPSHLDW
+    { 3, 0x72, 0x72, TP_ALL, TUPLE_FVM },           // VPSHRDW
+    { 3, 0xC2, 0xC2, TP_NP, TUPLE_FV16 },           // VCMPPH
+    { 3, 0xC2, 0xC2, TP_F3, TUPLE_N2 },             // VCMPSH
+
+    // Map 5 (FP16): conversions to and from wider elements
+    { 5, 0x1D, 0x1D, TP_66, TUPLE_FV },             // VCVTPS2PHX
+    { 5, 0x5A, 0x5A, TP_NP, TUPLE_QV16 },           // VCVTPH2PD
+    { 5, 0x5A, 0x5A, TP_66, TUPLE_FV },             // VCVTPD2PH
+    { 5, 0x5B, 0x5B, TP_NP, TUPLE_FV },             // VCVTDQ2PH, VCVTQQ2PH
+    { 5, 0x5B, 0x5B, TP_66 | TP_F3, TUPLE_HV16 },   // VCVT(T)PH2DQ
+    { 5, 0x78, 0x79, TP_NP, TUPLE_HV16 },           // VCVT(T)PH2UDQ
+    { 5, 0x78, 0x7B, TP_66, TUPLE_QV16 },           // VCVT(T)PH2UQQ, VCVT(T)PH2QQ
+    { 5, 0x7A, 0x7A, TP_F2, TUPLE_FV },             // VCVTUDQ2PH, VCVTUQQ2PH
+
+    // Map 5 (FP16): scalar forms
+    { 5, 0x10, 0x11, TP_F3, TUPLE_N2 },             // VMOVSH
+    { 5, 0x1D, 0x1D, TP_NP, TUPLE_N4 },             // VCVTSS2SH
+    { 5, 0x2A, 0x2A, TP_F3, TUPLE_T1S },            // VCVTSI2SH
+    { 5, 0x2C, 0x2D, TP_F3, TUPLE_N2 },             // VCVT(T)SH2SI
+    { 5, 0x2E, 0x2F, TP_NP, TUPLE_N2 },             // V(U)COMISH
+    { 5, 0x51, 0x51, TP_F3, TUPLE_N2 },             // VSQRTSH
+    { 5, 0x58, 0x59, TP_F3, TUPLE_N2 },             // VADDSH, VMULSH
+    { 5, 0x5A, 0x5A, TP_F3, TUPLE_N2 },             // VCVTSH2SD
+    { 5, 0x5A, 0x5A, TP_F2, TUPLE_N8 },             // VCVTSD2SH
+    { 5, 0x5C, 0x5F, TP_F3, TUPLE_N2 },             // VSUB/MIN/DIV/MAXSH
+    { 5, 0x6E, 0x6E, TP_66, TUPLE_N2 },             // VMOVW
+    { 5, 0x78, 0x79, TP_F3, TUPLE_N2 },             // VCVT(T)SH2USI
+    { 5, 0x7B, 0x7B, TP_F3, TUPLE_T1S },            // VCVTUSI2SH
+    { 5, 0x7E, 0x7E, TP_66, TUPLE_N2 },             // VMOVW
+
+    // Map 6 (FP16): conversions and complex arithmetic on 32-bit pairs
+    { 6, 0x13, 0x13, TP_66, TUPLE_HV16 },           // VCVTPH2PSX
+    { 6, 0x56, 0x56, TP_SS, TUPLE_FV },             // VF(C)MADDCPH
+    { 6, 0xD6, 0xD6, TP_SS, TUPLE_FV },             // VF(C)MULCPH
+
+    // Map 6 (FP16): scalar forms
+    { 6, 0x13, 0x13, TP_NP, TUPLE_N2 },             // VCVTSH2SS
+    { 6, 0x2D, 0x2D, TP_66, TUPLE_N2 },             // VSCALEFSH
+    { 6, 0x43, 0x43, TP_ALL, TUPLE_N2 },            // VGETEXPSH
+    { 6, 0x4D, 0x4D, TP_ALL, TUPLE_N2 },            // VRCPSH
+    { 6, 0x4F, 0x4F, TP_ALL, TUPLE_N2 },            // VRSQRTSH
+    { 6, 0x57, 0x57, TP_SS, TUPLE_N4 },             // VF(C)MADDCSH
+    { 6, 0x99, 0x99, TP_ALL, TUPLE_N2 },            // VFMADD132SH
+    { 6, 0x9B, 0x9B, TP_ALL, TUPLE_N2 },            // VFMSUB132SH
+    { 6, 0x9D, 0x9D, TP_ALL, TUPLE_N2 },            // VFNMADD132SH
+    { 6, 0x9F, 0x9F, TP_ALL, TUPLE_N2 },            // VFNMSUB132SH
+    { 6, 0xA9, 0xA9, TP_ALL, TUPLE_N2 },            // VFMADD213SH
+    { 6, 0xAB, 0xAB, TP_ALL, TUPLE_N2 },            // VFMSUB213SH
+    { 6, 0xAD, 0xAD, TP_ALL, TUPLE_N2 },            // VFNMADD213SH
+    { 6, 0xAF, 0xAF, TP_ALL, TUPLE_N2 },            // VFNMSUB213SH
+    { 6, 0xB9, 0xB9, TP_ALL, TUPLE_N2 },            // VFMADD231SH
+    { 6, 0xBB, 0xBB, TP_ALL, TUPLE_N2 },            // VFMSUB231SH
+    { 6, 0xBD, 0xBD, TP_ALL, TUPLE_N2 },            // VFNMADD231SH
+    { 6, 0xBF, 0xBF, TP_ALL, TUPLE_N2 },            // VFNMSUB231SH
+    { 6, 0xD7, 0xD7, TP_SS, TUPLE_N4 },             // VF(C)MULCSH
+};
+
+/*
+ * Tuple type table by EVEX map (1-7), pp and opcode, built at compile time
+ */
+typedef struct {
+    uint8_t tuple[8][4][OPCODE_TABLE_SIZE];
+} EvexTupleTable;
+
+constexpr EvexTupleTable build_evex_tuple_table() {
+    EvexTupleTable table = {};
+
+    for (unsigned int pp = 0; pp < 4; pp++) {
+        for (unsigned int i = 0; i < OPCODE_TABLE_SIZE; i++) {
+            table.tuple[OPCODE_MAP_5][pp][i] = TUPLE_FV16;
+            table.tuple[OPCODE_MAP_6][pp][i] = TUPLE_FV16;
+        }
+    }
+
+    for (unsigned int r = 0; r < sizeof(g_evex_tuple_ranges) / sizeof(g_evex_tuple_ranges[0]); r++) {
+        const EvexTupleRange& range = g_evex_tuple_ranges[r];
+        for (unsigned int pp = 0; pp < 4; pp++) {
+            if (range.pp_mask & (1 << pp)) {
+                for (unsigned int i = range.first; i <= range.last; i++) {
+                    table.tuple[range.map][pp][i] = range.tuple;
+                }
+            }
+        }
+    }
+
+    return table;
+}
+
+static constexpr EvexTupleTable g_evex_tuple_table = build_evex_tuple_table();
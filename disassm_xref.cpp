@@ -0,0 +1,581 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "disassm.h"
+
+/*
+ * Cross-reference index
+ *
+ * References are collected in source order into a pending list while a
+ * section is decoded. x86_xref_commit sorts the list by target with a
+ * stable radix sort, so the sources of one target stay in address order,
+ * and merges it into the committed arrays from the back, in place. The
+ * committed arrays are the file format: a header, then the targets, the
+ * sources and the types, so a saved index is used straight from the
+ * mapping.
+ */
+#define XREF_BATCH          4096            // Records decoded per batch by x86_xref_add_code
+#define XREF_PENDING_MIN    4096
+#define XREF_FILE_VERSION   1
+
+static const char g_xref_magic[8] = { 'x', '8', '6', 'x', 'r', 'e', 'f', 0 };
+
+typedef struct {
+    uint64_t target;
+    uint64_t source;
+    uint32_t type;
+} XrefEntry;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;   // Offset of the targets
+    uint64_t count;
+    uint64_t reserved;
+} XrefFileHeader;
+
+void x86_xref_init(XrefIndex* index) {
+    memset(index, 0, sizeof(*index));
+}
+
+void x86_xref_free(XrefIndex* index) {
+    if (index->capacity) {
+        free(index->targets);
+        free(index->sources);
+        free(index->types);
+    }
+    free(index->pending);
+    x86_unmap_file(&index->file);
+    memset(index, 0, sizeof(*index));
+}
+
+static int reserve_pending(XrefIndex* index, size_t count) {
+    XrefEntry* pending;
+    size_t capacity;
+
+    if (index->pending_count + count <= index->pending_capacity) {
+        return 1;
+    }
+
+    capacity = index->pending_capacity ? index->pending_capacity * 2 : XREF_PENDING_MIN;
+    while (capacity < index->pending_count + count) {
+        capacity *= 2;
+    }
+    pending = (XrefEntry*)realloc(index->pending, capacity * sizeof(XrefEntry));
+    if (!pending) {
+        return 0;
+    }
+
+    index->pending = pending;
+    index->pending_capacity = capacity;
+    return 1;
+}
+
+// Reference made by an instruction, if any
+static inline int get_reference(const DecodedInstruction* insn, XrefEntry* entry) {
+    if (insn->info.flags & FLAG_RIP_RELATIVE) {
+        entry->type = DISASM_XREF_DATA;
+    }
+    else if (insn->info.flags & FLAG_RELATIVE) {
+        DisasmFlow flow = x86_control_flow(&insn->info);
+        entry->type = flow == DISASM_FLOW_CALL ? DISASM_XREF_CALL :
+            flow == DISASM_FLOW_JUMP ? DISASM_XREF_JUMP : DISASM_XREF_BRANCH;
+    }
+    else {
+        return 0;
+    }
+
+    entry->target = insn->target;
+    entry->source = insn->address;
+    return 1;
+}
+
+int x86_xref_add(XrefIndex* index, const DecodedInstruction* insns, size_t count) {
+    XrefEntry* pending;
+
+    // At most one reference per instruction
+    if (!reserve_pending(index, count)) {
+        return 0;
+    }
+
+    pending = (XrefEntry*)index->pending + index->pending_count;
+    for (size_t i = 0; i < count; i++) {
+        pending += get_reference(&insns[i], pending);
+    }
+
+    index->pending_count = pending - (XrefEntry*)index->pending;
+    return 1;
+}
+
+int x86_xref_add_code(XrefIndex* index, DisasmMode mode, const void* code, size_t length, uint64_t address) {
+    DecodedInstruction* records = (DecodedInstruction*)malloc(XREF_BATCH * sizeof(DecodedInstruction));
+    const uint8_t* p = (const uint8_t*)code;
+    size_t offset = 0;
+    int status = 1;
+
+    if (!records) {
+        return 0;
+    }
+
+    while (offset < length) {
+        DisasmBatchResult result;
+        size_t count = x86_disasm_batch_mode(mode, p + offset, length - offset, address + offset,
+            records, XREF_BATCH, &result);
+
+        if (!x86_xref_add(index, records, count)) {
+            status = 0;
+            break;
+        }
+        if (result.reason != DISASM_STOP_FULL) {
+            break;
+        }
+        offset += result.offset;
+    }
+
+    free(records);
+    return status;
+}
+
+/*
+ * Stable LSD radix sort of entries on the 64-bit field at key_offset,
+ * skipping the byte positions all keys share. temp holds count entries.
+ * Returns the buffer holding the sorted entries.
+ */
+static XrefEntry* radix_sort(XrefEntry* entries, XrefEntry* temp, size_t count, size_t key_offset) {
+    size_t histogram[8][256];
+    uint64_t first;
+
+    memset(histogram, 0, sizeof(histogram));
+    memcpy(&first, (const uint8_t*)&entries[0] + key_offset, sizeof(first));
+    for (size_t i = 0; i < count; i++) {
+        uint64_t key;
+        memcpy(&key, (const uint8_t*)&entries[i] + key_offset, sizeof(key));
+        for (unsigned int b = 0; b < 8; b++) {
+            histogram[b][(key >> (b * 8)) & 0xFF]++;
+        }
+    }
+
+    for (unsigned int b = 0; b < 8; b++) {
+        size_t position = 0;
+
+        if (histogram[b][(first >> (b * 8)) & 0xFF] == count) {
+            continue;
+        }
+
+        for (unsigned int v = 0; v < 256; v++) {
+            size_t n = histogram[b][v];
+            histogram[b][v] = position;
+            position += n;
+        }
+        for (size_t i = 0; i < count; i++) {
+            uint64_t key;
+            memcpy(&key, (const uint8_t*)&entries[i] + key_offset, sizeof(key));
+            temp[histogram[b][(key >> (b * 8)) & 0xFF]++] = entries[i];
+        }
+
+        XrefEntry* swap = entries;
+        entries = temp;
+        temp = swap;
+    }
+
+    return entries;
+}
+
+// Makes room for count committed references, copying a mapped index
+static int reserve_committed(XrefIndex* index, size_t count) {
+    uint64_t* targets;
+    uint64_t* sources;
+    uint8_t* types;
+    size_t capacity;
+
+    if (count <= index->capacity) {
+        return 1;
+    }
+
+    capacity = index->capacity ? index->capacity * 2 : count;
+    if (capacity < count) {
+        capacity = count;
+    }
+
+    if (index->capacity == 0) {
+        // Empty, or still pointing into a saved file
+        targets = (uint64_t*)malloc(capacity * sizeof(uint64_t));
+        sources = (uint64_t*)malloc(capacity * sizeof(uint64_t));
+        types = (uint8_t*)malloc(capacity);
+        if (!targets || !sources || !types) {
+            free(targets);
+            free(sources);
+            free(types);
+            return 0;
+        }
+        if (index->count) {
+            memcpy(targets, index->targets, index->count * sizeof(uint64_t));
+            memcpy(sources, index->sources, index->count * sizeof(uint64_t));
+            memcpy(types, index->types, index->count);
+        }
+        x86_unmap_file(&index->file);
+    }
+    else {
+        targets = (uint64_t*)realloc(index->targets, capacity * sizeof(uint64_t));
+        if (!targets) {
+            return 0;
+        }
+        index->targets = targets;
+        sources = (uint64_t*)realloc(index->sources, capacity * sizeof(uint64_t));
+        if (!sources) {
+            return 0;
+        }
+        index->sources = sources;
+        types = (uint8_t*)realloc(index->types, capacity);
+        if (!types) {
+            return 0;
+        }
+    }
+
+    index->targets = targets;
+    index->sources = sources;
+    index->types = types;
+    index->capacity = capacity;
+    return 1;
+}
+
+// (target, source) sorts before (other_target, other_source)
+static inline int key_before(uint64_t target, uint64_t source, uint64_t other_target, uint64_t other_source) {
+    return target < other_target || (target == other_target && source < other_source);
+}
+
+int x86_xref_commit(XrefIndex* index) {
+    XrefEntry* entries = (XrefEntry*)index->pending;
+    size_t count = index->pending_count;
+    XrefEntry* scratch;
+    int sorted = 1;
+
+    if (count == 0) {
+        return 1;
+    }
+    if (!reserve_committed(index, index->count + count)) {
+        return 0;
+    }
+
+    scratch = (XrefEntry*)malloc(count * sizeof(XrefEntry));
+    if (!scratch) {
+        return 0;
+    }
+
+    // One pass over a section adds the sources in order; otherwise sort
+    // by source first so the sort by target keeps them in order
+    for (size_t i = 1; i < count && sorted; i++) {
+        sorted = entries[i - 1].source <= entries[i].source;
+    }
+    if (!sorted) {
+        entries = radix_sort(entries, entries == scratch ? (XrefEntry*)index->pending : scratch, count,
+            offsetof(XrefEntry, source));
+    }
+    entries = radix_sort(entries, entries == scratch ? (XrefEntry*)index->pending : scratch, count,
+        offsetof(XrefEntry, target));
+
+    // Merge from the back so the committed references move at most once
+    size_t i = index->count;
+    size_t j = count;
+    size_t k = index->count + count;
+    while (j > 0) {
+        const XrefEntry* entry = &entries[j - 1];
+
+        if (i > 0 && !key_before(index->targets[i - 1], index->sources[i - 1], entry->target, entry->source)) {
+            i--;
+            k--;
+            index->targets[k] = index->targets[i];
+            index->sources[k] = index->sources[i];
+            index->types[k] = index->types[i];
+        }
+        else {
+            j--;
+            k--;
+            index->targets[k] = entry->target;
+            index->sources[k] = entry->source;
+            index->types[k] = (uint8_t)entry->type;
+        }
+    }
+    index->count += count;
+    index->pending_count = 0;
+
+    free(scratch);
+    return 1;
+}
+
+// First committed reference with a target after address (upper) or at or after it
+static size_t find_bound(const XrefIndex* index, uint64_t address, int upper) {
+    size_t low = 0;
+    size_t high = index->count;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (index->targets[middle] < address || (upper && index->targets[middle] == address)) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+size_t x86_xref_find(const XrefIndex* index, uint64_t target, size_t* first) {
+    *first = find_bound(index, target, 0);
+    return find_bound(index, target, 1) - *first;
+}
+
+size_t x86_xref_range(const XrefIndex* index, uint64_t start, uint64_t end, size_t* first) {
+    *first = find_bound(index, start, 0);
+    return end > start ? find_bound(index, end, 0) - *first : 0;
+}
+
+// First committed reference at or after (target, source)
+static size_t find_entry(const XrefIndex* index, uint64_t target, uint64_t source) {
+    size_t low = 0;
+    size_t high = index->count;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (key_before(index->targets[middle], index->sources[middle], target, source)) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+// References of records, sorted by target then source; NULL when there are none or on failure
+static XrefEntry* sorted_references(const DecodedInstruction* insns, size_t count, size_t* found, int* failed) {
+    XrefEntry* entries = (XrefEntry*)malloc((count ? count : 1) * sizeof(XrefEntry));
+    XrefEntry* scratch = (XrefEntry*)malloc((count ? count : 1) * sizeof(XrefEntry));
+    XrefEntry* sorted;
+    size_t n = 0;
+
+    *found = 0;
+    if (!entries || !scratch) {
+        free(entries);
+        free(scratch);
+        *failed = 1;
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        n += get_reference(&insns[i], &entries[n]);
+    }
+    if (n == 0) {
+        free(entries);
+        free(scratch);
+        return NULL;
+    }
+
+    sorted = radix_sort(entries, scratch, n, offsetof(XrefEntry, source));
+    sorted = radix_sort(sorted, sorted == entries ? scratch : entries, n, offsetof(XrefEntry, target));
+    free(sorted == entries ? scratch : entries);
+
+    *found = n;
+    return sorted;
+}
+
+// Drops the references found in both sorted lists: they stay as they are
+static void cancel_unchanged(XrefEntry* deletions, size_t* deletion_count, XrefEntry* insertions,
+    size_t* insertion_count) {
+    size_t d = 0, n = 0, kept_deletions = 0, kept_insertions = 0;
+
+    while (d < *deletion_count || n < *insertion_count) {
+        if (n == *insertion_count || (d < *deletion_count && key_before(deletions[d].target, deletions[d].source,
+            insertions[n].target, insertions[n].source))) {
+            deletions[kept_deletions++] = deletions[d++];
+        }
+        else if (d == *deletion_count || key_before(insertions[n].target, insertions[n].source,
+            deletions[d].target, deletions[d].source) || insertions[n].type != deletions[d].type) {
+            insertions[kept_insertions++] = insertions[n++];
+        }
+        else {
+            d++;
+            n++;
+        }
+    }
+
+    *deletion_count = kept_deletions;
+    *insertion_count = kept_insertions;
+}
+
+int x86_xref_replace(XrefIndex* index, const DecodedInstruction* removed, size_t removed_count,
+    const DecodedInstruction* added, size_t added_count) {
+    XrefEntry* deletions;
+    XrefEntry* insertions;
+    size_t* positions = NULL;
+    size_t deletion_count;
+    size_t insertion_count;
+    size_t deleted = 0;
+    size_t first;
+    size_t last;
+    int failed = 0;
+    int status = 0;
+
+    deletions = sorted_references(removed, removed_count, &deletion_count, &failed);
+    insertions = sorted_references(added, added_count, &insertion_count, &failed);
+    if (failed) {
+        goto done;
+    }
+    cancel_unchanged(deletions, &deletion_count, insertions, &insertion_count);
+
+    // Positions of the references to delete; those that are not in the
+    // index are dropped
+    positions = (size_t*)malloc((deletion_count ? deletion_count : 1) * sizeof(size_t));
+    if (!positions) {
+        goto done;
+    }
+    for (size_t d = 0; d < deletion_count; d++) {
+        size_t position = find_entry(index, deletions[d].target, deletions[d].source);
+
+        // The same reference twice takes the next copy
+        if (deleted && positions[deleted - 1] >= position) {
+            position = positions[deleted - 1] + 1;
+        }
+        if (position < index->count && index->targets[position] == deletions[d].target &&
+            index->sources[position] == deletions[d].source) {
+            positions[deleted++] = position;
+        }
+    }
+    if (deleted == 0 && insertion_count == 0) {
+        status = 1;
+        goto done;
+    }
+
+    // Only [first, last) is rewritten; the references after it shift by
+    // the difference in count, and do not move at all when it is zero
+    first = index->count;
+    last = 0;
+    if (deleted) {
+        first = positions[0];
+        last = positions[deleted - 1] + 1;
+    }
+    if (insertion_count) {
+        size_t low = find_entry(index, insertions[0].target, insertions[0].source);
+        size_t high = find_entry(index, insertions[insertion_count - 1].target, insertions[insertion_count - 1].source);
+        first = low < first ? low : first;
+        last = high > last ? high : last;
+    }
+
+    {
+        size_t middle = last - first - deleted + insertion_count;
+        size_t tail = index->count - last;
+        size_t count = index->count - deleted + insertion_count;
+        uint64_t* targets = (uint64_t*)malloc((middle ? middle : 1) * sizeof(uint64_t));
+        uint64_t* sources = (uint64_t*)malloc((middle ? middle : 1) * sizeof(uint64_t));
+        uint8_t* types = (uint8_t*)malloc(middle ? middle : 1);
+        size_t i = first;
+        size_t d = 0;
+        size_t n = 0;
+        size_t k = 0;
+
+        // Also copies a loaded index to memory before it is modified
+        if (!targets || !sources || !types || !reserve_committed(index, count > index->count ? count : index->count)) {
+            free(targets);
+            free(sources);
+            free(types);
+            goto done;
+        }
+
+        while (i < last || n < insertion_count) {
+            if (d < deleted && positions[d] == i) {
+                d++;
+                i++;
+            }
+            else if (n < insertion_count && (i == last ||
+                !key_before(index->targets[i], index->sources[i], insertions[n].target, insertions[n].source))) {
+                targets[k] = insertions[n].target;
+                sources[k] = insertions[n].source;
+                types[k++] = (uint8_t)insertions[n++].type;
+            }
+            else {
+                targets[k] = index->targets[i];
+                sources[k] = index->sources[i];
+                types[k++] = index->types[i++];
+            }
+        }
+
+        memmove(index->targets + first + middle, index->targets + last, tail * sizeof(uint64_t));
+        memmove(index->sources + first + middle, index->sources + last, tail * sizeof(uint64_t));
+        memmove(index->types + first + middle, index->types + last, tail);
+        memcpy(index->targets + first, targets, middle * sizeof(uint64_t));
+        memcpy(index->sources + first, sources, middle * sizeof(uint64_t));
+        memcpy(index->types + first, types, middle);
+        index->count = count;
+
+        free(targets);
+        free(sources);
+        free(types);
+    }
+    status = 1;
+
+done:
+    free(deletions);
+    free(insertions);
+    free(positions);
+    return status;
+}
+
+int x86_xref_save(const XrefIndex* index, const char* path) {
+    XrefFileHeader header;
+    FILE* file;
+    int status;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, g_xref_magic, sizeof(header.magic));
+    header.version = XREF_FILE_VERSION;
+    header.header_size = sizeof(header);
+    header.count = index->count;
+
+    file = fopen(path, "wb");
+    if (!file) {
+        return 0;
+    }
+
+    status = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(index->targets, sizeof(uint64_t), index->count, file) == index->count &&
+        fwrite(index->sources, sizeof(uint64_t), index->count, file) == index->count &&
+        fwrite(index->types, 1, index->count, file) == index->count;
+
+    return fclose(file) == 0 && status;
+}
+
+int x86_xref_load(const char* path, unsigned int map_flags, XrefIndex* index) {
+    const XrefFileHeader* header;
+    MappedFile file;
+    uint64_t count;
+
+    x86_xref_init(index);
+    if (!x86_map_file(path, map_flags, &file)) {
+        return 0;
+    }
+
+    header = (const XrefFileHeader*)file.data;
+    if (file.size < sizeof(XrefFileHeader) || memcmp(header->magic, g_xref_magic, sizeof(header->magic)) != 0 ||
+        header->version != XREF_FILE_VERSION || header->header_size < sizeof(XrefFileHeader) ||
+        header->header_size % 8 != 0 || header->header_size > file.size) {
+        x86_unmap_file(&file);
+        return 0;
+    }
+
+    count = header->count;
+    if (count > (file.size - header->header_size) / 17) {
+        x86_unmap_file(&file);
+        return 0;
+    }
+
+    index->targets = (uint64_t*)(file.data + header->header_size);
+    index->sources = index->targets + count;
+    index->types = (uint8_t*)(index->sources + count);
+    index->count = (size_t)count;
+    index->file = file;
+    return 1;
+}
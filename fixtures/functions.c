@@ -0,0 +1,155 @@
+/*
+ * Source of the ELF function detection fixtures (elf64.bin, elf32.bin)
+ *
+ * A freestanding program with the usual shapes of compiler output: leaf
+ * and frame-pointer functions, direct, tail and indirect calls, a switch
+ * with a jump table, recursion and a noreturn exit.
+ *
+ *   gcc -O2 -ffreestanding -fno-pie -no-pie -nostdlib -static -fno-stack-protector \
+ *       -fcf-protection=none -fno-asynchronous-unwind-tables -Wl,--build-id=none \
+ *       -Wl,-z,noseparate-code functions.c -o elf64.bin
+ *
+ * elf32.bin is the same with -m32 and -Os instead of -O2: functions are
+ * packed without alignment padding.
+ */
+typedef unsigned long word;
+
+static volatile word g_sink;
+static word g_table[64];
+
+#define NOINLINE __attribute__((noinline))
+#define FRAME __attribute__((noinline, optimize("O0")))
+
+NOINLINE word add(word a, word b) { return a + b; }
+NOINLINE word sub(word a, word b) { return a - b; }
+NOINLINE word mul(word a, word b) { return a * b; }
+NOINLINE word divide(word a, word b) { return b ? a / b : 0; }
+NOINLINE word rotate(word a, word b) { return (a << (b & 7)) | (a >> (8 * sizeof(word) - (b & 7))); }
+NOINLINE word min_of(word a, word b) { return a < b ? a : b; }
+NOINLINE word max_of(word a, word b) { return a > b ? a : b; }
+
+typedef word (*binary_op)(word, word);
+static const binary_op g_ops[] = { add, sub, mul, divide, rotate, min_of, max_of };
+
+NOINLINE word apply(unsigned int op, word a, word b) {
+    return g_ops[op % (sizeof(g_ops) / sizeof(g_ops[0]))](a, b);
+}
+
+NOINLINE word classify(word value) {
+    switch (value & 15) {
+    case 0: return value * 3;
+    case 1: return value + 17;
+    case 2: return value ^ 0x55;
+    case 3: return value >> 2;
+    case 4: return value << 3;
+    case 5: return ~value;
+    case 6: return value - 99;
+    case 7: return value * value;
+    case 9: return value | 0x100;
+    case 11: return value & 0xFF;
+    default: return 0;
+    }
+}
+
+NOINLINE word fibonacci(word n) { return n < 2 ? n : fibonacci(n - 1) + fibonacci(n - 2); }
+
+NOINLINE word gcd(word a, word b) {
+    while (b) {
+        word t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+NOINLINE word checksum(const unsigned char* data, word size) {
+    word sum = 0;
+    for (word i = 0; i < size; i++) {
+        sum = (sum << 5) + sum + data[i];
+    }
+    return sum;
+}
+
+NOINLINE void fill_table(word seed) {
+    for (unsigned int i = 0; i < 64; i++) {
+        seed = seed * 1103515245 + 12345;
+        g_table[i] = seed >> 8;
+    }
+}
+
+NOINLINE word sum_table(void) {
+    word sum = 0;
+    for (unsigned int i = 0; i < 64; i++) {
+        sum += g_table[i];
+    }
+    return sum;
+}
+
+NOINLINE void sort_table(void) {
+    for (unsigned int i = 1; i < 64; i++) {
+        word key = g_table[i];
+        unsigned int j = i;
+        while (j > 0 && g_table[j - 1] > key) {
+            g_table[j] = g_table[j - 1];
+            j--;
+        }
+        g_table[j] = key;
+    }
+}
+
+NOINLINE word search_table(word key) {
+    unsigned int low = 0, high = 64;
+    while (low < high) {
+        unsigned int middle = (low + high) / 2;
+        if (g_table[middle] < key) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+NOINLINE word tail_caller(word a) { return classify(a + 1); }
+NOINLINE word tail_twice(word a) { return tail_caller(a * 2); }
+
+FRAME word frame_add(word a, word b) { word c = a + b; return c; }
+FRAME word frame_loop(word n) { word s = 0; for (word i = 0; i < n; i++) s += frame_add(i, s); return s; }
+FRAME void frame_store(word v) { g_sink = v; }
+FRAME word frame_select(word a, word b, int which) { return which ? a : b; }
+
+static NOINLINE word static_helper(word a) { return a * 7 + 1; }
+static NOINLINE word static_indirect(word a) { return a ^ 0xABCD; }
+static word (*volatile g_hook)(word) = static_indirect;
+
+__attribute__((noreturn, noinline)) void terminate(word code) {
+#ifdef __x86_64__
+    __asm__ volatile("syscall" : : "a"(60), "D"(code));
+#else
+    __asm__ volatile("int $0x80" : : "a"(1), "b"(code));
+#endif
+    for (;;) {
+    }
+}
+
+NOINLINE word run(void) {
+    word total = 0;
+
+    fill_table(42);
+    sort_table();
+    total += sum_table() + search_table(1000);
+    for (unsigned int op = 0; op < 14; op++) {
+        total += apply(op, total, op + 1);
+    }
+    total += classify(total) + fibonacci(10) + gcd(total, 1234);
+    total += checksum((const unsigned char*)g_table, sizeof(g_table));
+    total += tail_twice(total) + static_helper(total) + g_hook(total);
+    total += frame_loop(5) + frame_select(total, 3, (int)(total & 1));
+    frame_store(total);
+    return total;
+}
+
+void _start(void) {
+    terminate(run() & 0x7F);
+}